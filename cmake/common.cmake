@@ -51,11 +51,6 @@ mark_as_advanced(FLAMEGPU_VERBOSE_PTXAS)
 # Option to promote compilation warnings to error, useful for strict CI
 option(FLAMEGPU_WARNINGS_AS_ERRORS "Promote compilation warnings to errors" OFF)
 
-# Option to change curand engine used for CUDA random generation
-set(FLAMEGPU_CURAND_ENGINE "PHILOX" CACHE STRING "The curand engine to use. Suitable options: \"PHILOX\", \"XORWOW\", \"MRG\"")
-set_property(CACHE FLAMEGPU_CURAND_ENGINE PROPERTY STRINGS PHILOX XORWOW MRG)
-mark_as_advanced(FLAMEGPU_CURAND_ENGINE)
-
 # If CUDA >= 11.2, add an option to control the use of NVCC_THREADS
 set(DEFAULT_FLAMEGPU_NVCC_THREADS 2)
 if(CMAKE_CUDA_COMPILER_VERSION VERSION_GREATER_EQUAL 11.2)
@@ -0,0 +1,46 @@
+###################
+# GOOGLEBENCHMARK #
+###################
+
+set(CMAKE_MODULE_PATH ${CMAKE_CURRENT_LIST_DIR}/modules/ ${CMAKE_MODULE_PATH})
+include(FetchContent)
+cmake_policy(SET CMP0079 NEW)
+# Temporary CMake >= 3.30 fix https://github.com/FLAMEGPU/FLAMEGPU2/issues/1223
+if(POLICY CMP0169)
+    cmake_policy(SET CMP0169 OLD)
+endif()
+
+FetchContent_Declare(
+  googlebenchmark
+  GIT_REPOSITORY https://github.com/google/benchmark.git
+  GIT_TAG        v1.8.3
+)
+
+FetchContent_GetProperties(googlebenchmark)
+if(NOT googlebenchmark_POPULATED)
+    FetchContent_Populate(googlebenchmark)
+    # Do not build google benchmark's own tests, which would also require googletest to be fetched by benchmark
+    set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+    mark_as_advanced(FORCE BENCHMARK_ENABLE_TESTING)
+    set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+    mark_as_advanced(FORCE BENCHMARK_ENABLE_GTEST_TESTS)
+    # Suppress installation target, as this makes a warning
+    set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+    mark_as_advanced(FORCE BENCHMARK_ENABLE_INSTALL)
+    set(BENCHMARK_INSTALL_DOCS OFF CACHE BOOL "" FORCE)
+    mark_as_advanced(FORCE BENCHMARK_INSTALL_DOCS)
+    # Warnings as errors within benchmark is not controlled by us
+    set(BENCHMARK_ENABLE_WERROR OFF CACHE BOOL "" FORCE)
+    mark_as_advanced(FORCE BENCHMARK_ENABLE_WERROR)
+    add_subdirectory(${googlebenchmark_SOURCE_DIR} ${googlebenchmark_BINARY_DIR} EXCLUDE_FROM_ALL)
+    flamegpu_set_target_folder("benchmark" "Benchmarks/Dependencies")
+    # Suppress warnigns from this target.
+    include(${CMAKE_CURRENT_LIST_DIR}/../warnings.cmake)
+    if(TARGET benchmark)
+        flamegpu_disable_compiler_warnings(TARGET benchmark)
+    endif()
+endif()
+
+# Mark some CACHE vars advanced for a cleaner GUI
+mark_as_advanced(FETCHCONTENT_SOURCE_DIR_GOOGLEBENCHMARK)
+mark_as_advanced(FETCHCONTENT_UPDATES_DISCONNECTED_GOOGLEBENCHMARK)
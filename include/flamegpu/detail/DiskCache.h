@@ -0,0 +1,107 @@
+#ifndef INCLUDE_FLAMEGPU_DETAIL_DISKCACHE_H_
+#define INCLUDE_FLAMEGPU_DETAIL_DISKCACHE_H_
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace flamegpu {
+namespace detail {
+
+/**
+ * Size capped key-value store held within a single file, which may be shared by many processes
+ *
+ * The store file begins with a fixed size open addressing hash table, which maps the hash of each key to a record within the
+ * append only data region that follows it. So a lookup reads a handful of table slots and a single record, regardless of the number of entries.
+ * Each record holds its key, a reference and a value. A lookup only succeeds if the key and the reference both match exactly,
+ * and the value's checksum is valid, so a torn or colliding record is treated as a miss rather than returned.
+ *
+ * Every table slot also records when its entry was last used. If storing a value would exceed the size limit, or the table
+ * becomes too full, the store is compacted: the most recently used entries are copied to a new file, until it holds 3/4 of the
+ * size limit, and the new file is renamed over the old. As rename is atomic, other processes only ever observe a complete store.
+ *
+ * Accesses are serialised across processes by a lock on a separate lock file, and across threads by a mutex. Lookups take both
+ * shared, so may proceed concurrently. Marking a found entry as most recently used requires exclusive access, so is skipped
+ * rather than waited for if another access is in progress.
+ * Failures to read or write the store (e.g. due to permissions or a full disk) are not fatal, they behave as a miss.
+ */
+class DiskCache {
+ public:
+    /**
+     * Default size limit of the store, 1 GiB
+     */
+    static constexpr uint64_t DEFAULT_SIZE_LIMIT = 1ull << 30;
+    /**
+     * @param directory Directory which will hold the store and its lock file, this must already exist
+     * @param size_limit The maximum size of the store's records in bytes
+     */
+    explicit DiskCache(const std::string &directory, uint64_t size_limit = DEFAULT_SIZE_LIMIT);
+    /**
+     * Loads the value stored with the provided key and reference
+     * @param key Key which the value was stored with
+     * @param reference Must exactly match the reference the value was stored with
+     * @param value Set to the stored value on success
+     * @return true if a matching value was found
+     */
+    bool load(const std::string &key, const std::string &reference, std::string &value);
+    /**
+     * Stores a value, replacing any previous value stored with the same key
+     * The least recently used values are evicted if the store would exceed its size limit
+     * Values larger than the size limit are not stored
+     * @param key Key to store the value with
+     * @param reference Reference to store the value with, this must be matched to load the value
+     * @param value The value to store
+     */
+    void store(const std::string &key, const std::string &reference, const std::string &value);
+    /**
+     * Removes all values from the store
+     */
+    void clear();
+    /**
+     * Set the maximum size of the store's records in bytes
+     * The store will be compacted to within the new limit the next time a value is stored
+     */
+    void setSizeLimit(uint64_t size_limit);
+    /**
+     * Returns the maximum size of the store's records in bytes
+     */
+    uint64_t getSizeLimit() const;
+    /**
+     * Returns the total size of the records currently held by the store in bytes
+     */
+    uint64_t getSize();
+    /**
+     * Returns the number of values currently held by the store
+     */
+    uint64_t getEntryCount();
+    /**
+     * Name of the store file within the directory
+     */
+    static constexpr const char *STORE_FILE = "rtc.store";
+    /**
+     * Name of the lock file within the directory
+     */
+    static constexpr const char *LOCK_FILE = "rtc.store.lock";
+
+ private:
+    /**
+     * Compacts the store, keeping the most recently used records which fit within target bytes
+     * The caller must hold the lock
+     * @param target The maximum size of the retained records
+     * @param exclude_hash Key hash of a record which is about to be replaced, so should not be retained
+     */
+    void compact(uint64_t target, uint64_t exclude_hash);
+    const std::string store_path;
+    const std::string lock_path;
+    uint64_t size_limit;
+    /**
+     * Serialises accesses from threads within this process, lookups lock it shared
+     */
+    mutable std::shared_mutex mutex;
+};
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_DETAIL_DISKCACHE_H_
@@ -1,9 +1,13 @@
 #ifndef INCLUDE_FLAMEGPU_DETAIL_JITIFYCACHE_H_
 #define INCLUDE_FLAMEGPU_DETAIL_JITIFYCACHE_H_
 
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <map>
 #include <mutex>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -17,6 +21,8 @@
 
 namespace flamegpu {
 namespace detail {
+class ThreadPool;
+class DiskCache;
 
 /**
  * Load RTC kernels from in-memory or on-disk cache if an appropriate copy already exists
@@ -36,8 +42,25 @@ class JitifyCache {
         std::string long_reference;
         std::string serialised_kernelinst;
     };
+    /**
+     * A kernel which is currently being loaded from disk or compiled by the compile pool
+     * Further requests for the same kernel share the result, rather than compiling it again
+     */
+    struct InFlightProgram {
+        std::string long_reference;
+        std::shared_future<std::string> serialised_kernelinst;
+    };
 
  public:
+    /**
+     * The inputs from which an RTC kernel is built, as passed to loadKernel()
+     */
+    struct KernelSource {
+        std::string func_name;
+        std::vector<std::string> template_args;
+        std::string kernel_src;
+        std::string dynamic_header;
+    };
     /**
      * Returns a unique instance of the passed kernel
      * If this is not found in the in-memory or disk cache it will be compiled which is much slower
@@ -47,12 +70,43 @@ class JitifyCache {
      * @param kernel_src Source code for the user defined agent function/condition
      * @param dynamic_header Dynamic header source generated by curve rtc
      * @return A jitify RTC kernel instance of the provided kernel sources
+     * @see loadKernelAsync()
      */
     std::unique_ptr<jitify::experimental::KernelInstantiation> loadKernel(
         const std::string &func_name,
         const std::vector<std::string> &template_args,
         const std::string &kernel_src,
         const std::string &dynamic_header);
+    /**
+     * Asynchronous version of loadKernel()
+     * Kernels found in the in-memory cache are available immediately, otherwise loading from the on-disk cache and compilation
+     * are performed by a bounded pool of worker threads, so that many kernels can be compiled concurrently.
+     * Concurrent requests for an identical kernel are coalesced, so that the kernel is only compiled once.
+     * @param func_name The name of the function (This is only used for error reporting)
+     * @param template_args A vector of template arguments for instantiating the kernel.
+     * In the case of FLAME GPU 2, these args are likely to be the user defined function_impl and the message i/o types.
+     * @param kernel_src Source code for the user defined agent function/condition
+     * @param dynamic_header Dynamic header source generated by curve rtc
+     * @return A future to a jitify RTC kernel instance of the provided kernel sources
+     * @note Exceptions raised during compilation (e.g. exception::InvalidAgentFunc) are rethrown by the future's get()
+     */
+    std::future<std::unique_ptr<jitify::experimental::KernelInstantiation>> loadKernelAsync(
+        const std::string &func_name,
+        const std::vector<std::string> &template_args,
+        const std::string &kernel_src,
+        const std::string &dynamic_header);
+    /**
+     * Set the maximum number of kernels which may be compiled concurrently
+     * Defaults to 0, which uses std::thread::hardware_concurrency()
+     * @param count The number of compilation threads
+     * @note Kernels already queued for compilation are unaffected
+     */
+    void setCompileThreadCount(unsigned int count);
+    /**
+     * Returns the maximum number of kernels which may be compiled concurrently
+     * 0 denotes std::thread::hardware_concurrency()
+     */
+    unsigned int getCompileThreadCount() const;
     /**
      * Used to configure whether the in-memory cache is used
      * Defaults to true
@@ -79,11 +133,52 @@ class JitifyCache {
      */
     bool useDiskCache() const;
     /**
-     * Clears the in-memory cache
-     * All kernels loaded after this will need to come from the on-disk cache or be compiled
+     * Set the maximum size of the on-disk cache in bytes
+     * When exceeded, the least recently used kernels are evicted from the on-disk cache
+     * Defaults to DiskCache::DEFAULT_SIZE_LIMIT (1 GiB)
+     * @param bytes The maximum size of the on-disk cache
+     * @note The on-disk cache is shared by all processes, each enforces its own limit when it adds a kernel
+     */
+    void setDiskCacheSizeLimit(uint64_t bytes);
+    /**
+     * Returns the maximum size of the on-disk cache in bytes
+     */
+    uint64_t getDiskCacheSizeLimit() const;
+    /**
+     * Clears the on-disk cache
+     * All kernels loaded after this will need to come from the in-memory cache or be compiled
      * @note Will only clear the cache files used by the current build (debug or release)
      */
     static void clearDiskCache();
+    /**
+     * Loads (or compiles) the listed kernels, and writes them to a single bundle file
+     * The bundle can later be preloaded with loadBundle(), so that the kernels need not be compiled or loaded from the on-disk cache
+     * @param filepath Path of the bundle to write
+     * @param kernels The kernels to include within the bundle, duplicates are only written once
+     * @throws exception::InvalidFilePath If the bundle cannot be written
+     * @throws exception::InvalidAgentFunc If a kernel fails to compile
+     * @note Kernels are specialised to the current device's compute capability and the CUDA and FLAMEGPU versions,
+     *       they will only be used by processes where these match
+     */
+    void exportBundle(const std::string &filepath, const std::vector<KernelSource> &kernels);
+    /**
+     * Preloads the kernels within a bundle written by exportBundle()
+     * Preloaded kernels are used in preference to the in-memory and on-disk caches, regardless of whether they are enabled
+     * Loading a bundle a second time has no effect, unless clearBundles() has been called
+     * @param filepath Path of the bundle to load
+     * @return The number of kernels loaded from the bundle
+     * @throws exception::InvalidFilePath If the bundle cannot be opened
+     * @throws exception::InvalidInputFile If the file is not a valid bundle, or was created by a different version of FLAMEGPU
+     */
+    unsigned int loadBundle(const std::string &filepath);
+    /**
+     * Discards all kernels preloaded by loadBundle()
+     */
+    void clearBundles();
+    /**
+     * Returns the number of kernels which have been compiled, kernels found in a cache or bundle are not counted
+     */
+    uint64_t getCompileCount() const;
 
  private:
     /**
@@ -93,13 +188,15 @@ class JitifyCache {
      * In the case of FLAME GPU 2, these args are likely to be the user defined function_impl and the message i/o types.
      * @param kernel_src Source code for the user defined agent function/condition
      * @param dynamic_header Dynamic header source generated by curve rtc
+     * @param device_arch Compute capability of the device the kernel will be executed on, 0 if unknown
      * @return A jitify RTC kernel instance of the provided kernel sources
      */
     static std::unique_ptr<jitify::experimental::KernelInstantiation> compileKernel(
     const std::string &func_name,
     const std::vector<std::string> &template_args,
     const std::string &kernel_src,
-    const std::string &dynamic_header);
+    const std::string &dynamic_header,
+    int device_arch);
     /**
      * Fill the provided vector with the list of headers we expect to be loaded
      * This enables Jitify to find all the required headers with less NVRTC calls
@@ -111,6 +208,30 @@ class JitifyCache {
      * @note Libraries such as GLM, which use relative includes internally cannot easily be optimised in this way
      */
     static void getKnownHeaders(std::vector<std::string> &headers);
+    /**
+     * Common implementation of loadKernelAsync() and exportBundle()
+     * Parameters match loadKernelAsync()
+     * @param short_reference Set to the key which identifies the kernel within the caches
+     * @param long_reference Set to the reference which must exactly match a cached copy of the kernel
+     * @return A future to the serialised kernel instance
+     */
+    std::shared_future<std::string> loadSerialisedKernelAsync(
+        const std::string &func_name,
+        const std::vector<std::string> &template_args,
+        const std::string &kernel_src,
+        const std::string &dynamic_header,
+        std::string &short_reference,
+        std::string &long_reference);
+    /**
+     * Returns the pool used to compile kernels, creating it if required
+     * @note cache_mutex must be held by the caller
+     */
+    ThreadPool &getCompilePool();
+    /**
+     * Returns the on-disk cache, creating it if required
+     * @note cache_mutex must be held by the caller
+     */
+    DiskCache &getDiskCache();
 
     /**
      * In-memory map of cached RTC kernels
@@ -118,17 +239,52 @@ class JitifyCache {
      */
     std::map<std::string, CachedProgram> cache{};
     /**
-     * Mutex protecting multi-threaded accesses to cache
+     * Map of RTC kernels currently being loaded or compiled
+     * map<short_reference, program>
+     */
+    std::map<std::string, InFlightProgram> in_flight{};
+    /**
+     * Kernels preloaded by loadBundle()
+     * map<short_reference, program>
+     */
+    std::map<std::string, CachedProgram> bundle{};
+    /**
+     * Paths of the bundles which have been loaded into bundle
+     */
+    std::set<std::string> loaded_bundles{};
+    /**
+     * Mutex protecting multi-threaded accesses to cache, in_flight, bundle and loaded_bundles
      */
     mutable std::mutex cache_mutex;
 
     bool use_memory_cache;
     bool use_disk_cache;
+    /**
+     * Thread count used when creating compile_pool
+     */
+    unsigned int compile_thread_count;
+    /**
+     * Worker threads which load and compile kernels, created on first use
+     */
+    std::unique_ptr<ThreadPool> compile_pool;
+    /**
+     * Size limit used when creating disk_cache_store
+     */
+    uint64_t disk_cache_size_limit;
+    /**
+     * Index of kernels within the on-disk cache, created on first use
+     */
+    std::unique_ptr<DiskCache> disk_cache_store;
+    /**
+     * Number of kernels successfully compiled, reported by getCompileCount()
+     */
+    std::atomic<uint64_t> compile_count{0};
 
     /**
      * Remainder of class is singleton pattern
      */
     JitifyCache();
+    ~JitifyCache();
     static std::mutex instance_mutex;
 
  public:
@@ -0,0 +1,145 @@
+#ifndef INCLUDE_FLAMEGPU_DETAIL_THREADPOOL_H_
+#define INCLUDE_FLAMEGPU_DETAIL_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flamegpu {
+namespace detail {
+
+/**
+ * Host thread pool with per-worker task queues and work stealing
+ *
+ * Tasks are pushed to the back of a queue. Each worker owns a queue, which it pops the most recently queued task from the back of,
+ * so nested work is executed depth first. When a worker's own queue is empty it steals the oldest task from the front of the other workers' queues.
+ * Threads which block waiting on work submitted to the pool (e.g. the caller of parallelFor()) execute pending tasks whilst they wait,
+ * so nested use of the pool from within a task does not deadlock.
+ *
+ * The pool is reentrant: submit(), parallelFor() and runPendingTask() may be called from within a task executing on one of the pool's workers,
+ * including tasks executed by a thread waiting within parallelFor(). As a waiting thread may execute any pending task, not only those it is waiting on,
+ * a task must not call parallelFor() whilst holding a lock which another task may require.
+ */
+class ThreadPool {
+ public:
+    /**
+     * Unit of work executed by the pool
+     */
+    typedef std::function<void()> Task;
+    /**
+     * Creates the pool and launches its worker threads
+     * @param thread_count The number of worker threads to create, if 0 std::thread::hardware_concurrency() is used
+     */
+    explicit ThreadPool(unsigned int thread_count = 0);
+    /**
+     * Completes all outstanding tasks and joins the worker threads
+     */
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    /**
+     * Returns the number of worker threads owned by the pool
+     */
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(workers.size()); }
+    /**
+     * Queue a task for asynchronous execution
+     * @param f Callable to be executed by a worker thread
+     * @return A future which will hold the result of f(), or the exception it threw
+     * @note If called from one of the pool's worker threads, the task is placed on that worker's queue (it may be stolen by other workers)
+     */
+    template<typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F &&f);
+    /**
+     * Execute body over the index range [begin, end), split into chunks of at most grain indices
+     * Chunks are distributed across the workers' queues, and the calling thread also executes chunks until all have completed
+     * @param begin First index of the range
+     * @param end Index after the last index of the range
+     * @param grain Maximum number of indices passed to a single invocation of body, if 0 a value is chosen which gives each thread several chunks
+     * @param body Callable of the form void(size_t chunk_begin, size_t chunk_end)
+     * @throws Rethrows the first exception thrown by body, after all chunks have completed
+     * @note This may be called from within a task, the calling worker executes pending tasks (which may be unrelated to body) until all chunks have completed
+     */
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &body);
+    /**
+     * Executes a single pending task on the calling thread, if one is available
+     * This allows threads which are waiting on the result of submitted work to contribute to it
+     * @return True if a task was executed
+     */
+    bool runPendingTask();
+
+ private:
+    /**
+     * Task queue owned by a single worker
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    /**
+     * Place a task on a queue and wake a sleeping worker
+     * @param task The task to enqueue
+     */
+    void enqueue(Task &&task);
+    /**
+     * Attempt to fetch a task, first from the back of the queue at index home, then from the front of the others
+     * @param home Index of the queue to be checked first
+     * @param out Output location for the task
+     * @return True if a task was found
+     */
+    bool dequeue(unsigned int home, Task &out);
+    /**
+     * Main loop of each worker thread
+     * @param index Index of the worker, and of the queue it owns
+     */
+    void workerLoop(unsigned int index);
+    /**
+     * Returns the index of the calling worker, or UINT_MAX if the calling thread is not a worker of this pool
+     */
+    unsigned int currentWorkerIndex() const;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    /**
+     * Number of tasks enqueued which have not yet been dequeued
+     */
+    std::atomic<size_t> pending_tasks;
+    /**
+     * Round robin counter used to distribute tasks submitted from non-worker threads
+     */
+    std::atomic<unsigned int> next_queue;
+    /**
+     * Protects stopping and pairs with sleep_cv, to allow idle workers to sleep
+     */
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    bool stopping;
+};
+
+template<typename F>
+std::future<std::invoke_result_t<std::decay_t<F>>> ThreadPool::submit(F &&f) {
+    typedef std::invoke_result_t<std::decay_t<F>> R;
+    // std::function requires copyable callables, so the packaged_task must be held by shared_ptr
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> rtn = task->get_future();
+    if (workers.empty()) {
+        // No workers, execute immediately
+        (*task)();
+    } else {
+        enqueue([task]() { (*task)(); });
+    }
+    return rtn;
+}
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_DETAIL_THREADPOOL_H_
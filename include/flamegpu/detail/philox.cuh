@@ -0,0 +1,202 @@
+#ifndef INCLUDE_FLAMEGPU_DETAIL_PHILOX_CUH_
+#define INCLUDE_FLAMEGPU_DETAIL_PHILOX_CUH_
+
+#include <cstdint>
+#include <cmath>
+
+// The generator is shared by device code and the host reference implementation, so must compile without a CUDA compiler
+#if defined(__CUDACC__)
+#define FLAMEGPU_PHILOX_QUALIFIER __host__ __device__ __forceinline__
+#else
+#define FLAMEGPU_PHILOX_QUALIFIER inline
+#endif
+
+namespace flamegpu {
+namespace detail {
+
+/**
+ * Identifies the random stream of a single agent function (or condition) launch
+ * Combined with an agent's ID, this uniquely keys the random numbers drawn by that agent
+ */
+struct PhiloxKey {
+    /**
+     * The simulation's random seed
+     */
+    uint64_t seed;
+    /**
+     * The step counter at the time of the launch
+     */
+    uint32_t step;
+    /**
+     * Identifies the agent function within the model
+     * @see RandomManager::agentFunctionKey()
+     */
+    uint32_t stream;
+};
+
+/**
+ * Stateless counter-based random number generator, Philox4x32-10
+ * J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw, "Parallel random numbers: As easy as 1, 2, 3", SC11
+ *
+ * The output is a pure function of the 64 bit key (the seed) and 128 bit counter, so no state needs to be stored between kernels.
+ * The counter is formed of (draw, subject, step, stream), where subject is the agent's ID, so an agent draws the same numbers
+ * regardless of its index within the population, the launch configuration or which other functions execute concurrently.
+ */
+class Philox {
+ public:
+    /**
+     * Identifies the sequence of numbers generated for a given key
+     * This must be incremented if a change to this class alters the numbers drawn, so that cached RTC agent functions are recompiled
+     */
+    static constexpr unsigned int VERSION = 1;
+    /**
+     * A 128 bit counter, or the 128 bits of output generated from it
+     */
+    struct Block {
+        uint32_t v[4];
+    };
+    /**
+     * @param key The key of the agent function launch
+     * @param subject The ID of the agent drawing numbers
+     */
+    FLAMEGPU_PHILOX_QUALIFIER Philox(const PhiloxKey &key, const uint32_t subject)
+        : seed(key.seed)
+        , counter{{0, subject, key.step, key.stream}}
+        , output{{0, 0, 0, 0}}
+        , next_output(4) { }
+    /**
+     * Replaces the subject of the counter, this must be called prior to drawing any numbers
+     * @param subject The ID of the agent drawing numbers
+     */
+    FLAMEGPU_PHILOX_QUALIFIER void setSubject(const uint32_t subject) {
+        counter.v[1] = subject;
+    }
+    /**
+     * Applies the 10 round Philox4x32 bijection to ctr
+     * @param ctr The counter to be encrypted
+     * @param key The key, the low word is used as the first key word
+     */
+    static FLAMEGPU_PHILOX_QUALIFIER Block generate(Block ctr, const uint64_t key) {
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+        for (int i = 0; i < 10; ++i) {
+            if (i) {
+                k0 += W0;
+                k1 += W1;
+            }
+            const uint64_t p0 = static_cast<uint64_t>(M0) * ctr.v[0];
+            const uint64_t p1 = static_cast<uint64_t>(M1) * ctr.v[2];
+            ctr = Block{{static_cast<uint32_t>(p1 >> 32) ^ ctr.v[1] ^ k0, static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ ctr.v[3] ^ k1, static_cast<uint32_t>(p0)}};
+        }
+        return ctr;
+    }
+    /**
+     * Returns 32 random bits, each call to generate() produces four values
+     */
+    FLAMEGPU_PHILOX_QUALIFIER uint32_t next() {
+        if (next_output == 4) {
+            output = generate(counter, seed);
+            ++counter.v[0];
+            next_output = 0;
+        }
+        return output.v[next_output++];
+    }
+    /**
+     * Returns a float uniformly distributed in the range [0, 1)
+     */
+    FLAMEGPU_PHILOX_QUALIFIER float uniformFloat() {
+        // Only the 24 bits representable by the mantissa are used, so that 1.0 cannot be returned by rounding
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+    /**
+     * Returns a double uniformly distributed in the range [0, 1)
+     */
+    FLAMEGPU_PHILOX_QUALIFIER double uniformDouble() {
+        const uint64_t hi = next() >> 5;
+        const uint64_t lo = next() >> 6;
+        return static_cast<double>((hi << 26) | lo) * (1.0 / 9007199254740992.0);
+    }
+    /**
+     * Returns a normally distributed float with mean 0.0 and standard deviation 1.0, using the Box-Muller transform
+     */
+    FLAMEGPU_PHILOX_QUALIFIER float normalFloat() {
+        // 1 - uniform is in the range (0, 1], so the log is finite
+        const float r = sqrtf(-2.0f * logf(1.0f - uniformFloat()));
+        return r * cosf(6.28318530717958647692f * uniformFloat());
+    }
+    /**
+     * Returns a normally distributed double with mean 0.0 and standard deviation 1.0, using the Box-Muller transform
+     */
+    FLAMEGPU_PHILOX_QUALIFIER double normalDouble() {
+        const double r = sqrt(-2.0 * log(1.0 - uniformDouble()));
+        return r * cos(6.28318530717958647692 * uniformDouble());
+    }
+    /**
+     * Returns a poisson distributed unsigned int with the provided mean
+     * Small means use Knuth's multiplication method, larger means use Hörmann's transformed rejection (PTRS)
+     * W. Hörmann, "The transformed rejection method for generating Poisson random variables", 1993
+     */
+    FLAMEGPU_PHILOX_QUALIFIER unsigned int poisson(const double mean) {
+        if (mean <= 0) {
+            return 0;
+        }
+        if (mean < 10) {
+            const double limit = exp(-mean);
+            unsigned int k = 0;
+            double p = uniformDouble();
+            while (p > limit) {
+                ++k;
+                p *= uniformDouble();
+            }
+            return k;
+        }
+        const double slam = sqrt(mean);
+        const double loglam = log(mean);
+        const double b = 0.931 + 2.53 * slam;
+        const double a = -0.059 + 0.02483 * b;
+        const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+        const double vr = 0.9277 - 3.6224 / (b - 2);
+        while (true) {
+            const double U = uniformDouble() - 0.5;
+            const double V = uniformDouble();
+            const double us = 0.5 - fabs(U);
+            const double k = floor((2 * a / us + b) * U + mean + 0.43);
+            if (us >= 0.07 && V <= vr) {
+                return static_cast<unsigned int>(k);
+            }
+            if (k < 0 || (us < 0.013 && V > us)) {
+                continue;
+            }
+            if (log(V) + log(invalpha) - log(a / (us * us) + b) <= -mean + k * loglam - lgamma(k + 1)) {
+                return static_cast<unsigned int>(k);
+            }
+        }
+    }
+
+ private:
+    /**
+     * Philox4x32 round multipliers and Weyl sequence key increments
+     */
+    static constexpr uint32_t M0 = 0xD2511F53;
+    static constexpr uint32_t M1 = 0xCD9E8D57;
+    static constexpr uint32_t W0 = 0x9E3779B9;
+    static constexpr uint32_t W1 = 0xBB67AE85;
+    uint64_t seed;
+    /**
+     * The counter of the next block to generate, the first word counts blocks drawn
+     */
+    Block counter;
+    /**
+     * The most recently generated block, and the index of its next unused word
+     */
+    Block output;
+    unsigned int next_output;
+};
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#undef FLAMEGPU_PHILOX_QUALIFIER
+
+#endif  // INCLUDE_FLAMEGPU_DETAIL_PHILOX_CUH_
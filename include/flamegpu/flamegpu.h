@@ -37,6 +37,7 @@
 #include "flamegpu/simulation/AgentVector.h"
 #include "flamegpu/runtime/agent/AgentInstance.h"
 #include "flamegpu/simulation/CUDASimulation.h"
+#include "flamegpu/simulation/CPUSimulation.h"
 #include "flamegpu/runtime/messaging.h"
 #include "flamegpu/runtime/AgentFunction_shim.cuh"
 #include "flamegpu/runtime/AgentFunctionCondition_shim.cuh"
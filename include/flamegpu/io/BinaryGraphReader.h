@@ -0,0 +1,52 @@
+#ifndef INCLUDE_FLAMEGPU_IO_BINARYGRAPHREADER_H_
+#define INCLUDE_FLAMEGPU_IO_BINARYGRAPHREADER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "flamegpu/detail/cuda.cuh"
+
+namespace flamegpu {
+namespace detail {
+class CUDAEnvironmentDirectedGraphBuffers;
+}  // namespace detail
+namespace io {
+
+/**
+ * Reader for the binary CSR graph format
+ *
+ * Each property column is copied directly into the graph's host buffer, without intermediate parsing.
+ * Properties within the file which are not part of the graph's description are skipped, properties of the graph which are not within the file retain their default value.
+ * @see BinaryGraphWriter for a description of the file format
+ */
+class BinaryGraphReader {
+ public:
+    /**
+     * Imports the provided graph from the binary CSR format
+     *
+     * @param filepath The path to load the graph from
+     * @param directed_graph The graph buffers to import into
+     * @param stream CUDA stream (required by directed_graph for synchronising device buffers)
+     *
+     * @throws exception::InvalidFilePath If the file cannot be opened for reading
+     * @throws exception::InvalidInputFile If the file is not a valid binary graph, or its properties do not match the graph's description
+     */
+    static void loadCSR(const std::string &filepath, const std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream);
+    /**
+     * Imports the provided graph from a buffer containing the binary CSR format (e.g. a memory mapped file)
+     *
+     * @param data Pointer to the start of the buffer
+     * @param length Length of the buffer in bytes
+     * @param directed_graph The graph buffers to import into
+     * @param stream CUDA stream (required by directed_graph for synchronising device buffers)
+     *
+     * @throws exception::InvalidInputFile If the buffer is not a valid binary graph, or its properties do not match the graph's description
+     */
+    static void loadCSR(const void *data, size_t length, const std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream);
+};
+
+}  // namespace io
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_IO_BINARYGRAPHREADER_H_
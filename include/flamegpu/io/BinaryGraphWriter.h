@@ -0,0 +1,64 @@
+#ifndef INCLUDE_FLAMEGPU_IO_BINARYGRAPHWRITER_H_
+#define INCLUDE_FLAMEGPU_IO_BINARYGRAPHWRITER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "flamegpu/detail/cuda.cuh"
+
+namespace flamegpu {
+namespace detail {
+class CUDAEnvironmentDirectedGraphBuffers;
+}  // namespace detail
+namespace io {
+
+/**
+ * Writer for the binary CSR graph format
+ *
+ * The graph's structure is stored in compressed sparse row form, with each vertex and edge property stored as a contiguous column,
+ * so a graph can be saved and loaded with a single bulk copy per property.
+ * All values are stored in the host's native byte order.
+ * - File header (48 bytes): char[8] MAGIC, uint32 VERSION, uint32 BYTE_ORDER_MARK, uint32 vertex count, uint32 edge count,
+ *   uint32 vertex property count, uint32 edge property count, uint64 offset of the row offsets column, uint64 offset of the column indices column
+ * - Property table, vertex properties followed by edge properties: string name, uint8 type (BinaryLogger::ColumnType), uint32 elements, uint64 offset of the column data
+ * - Row offsets (uint32 x (vertex count + 1)), the edges leaving vertex i are stored at [row_offsets[i], row_offsets[i+1])
+ * - Column indices (uint32 x edge count), the index of each edge's destination vertex
+ * - Property columns (count x elements values), edge property columns are stored in the same order as the column indices
+ * - Strings are stored as uint32 length followed by the (non null terminated) characters
+ *
+ * Vertex IDs are stored as the vertex property ID_VARIABLE_NAME, edge source and destination IDs are not stored as they are implied by the CSR.
+ * All offsets are relative to the start of the file, and all columns are aligned to 8 bytes so a memory mapped file can be read in place.
+ * @see BinaryGraphReader
+ */
+class BinaryGraphWriter {
+ public:
+    /**
+     * Identifies binary graph files
+     */
+    static constexpr char MAGIC[8] = { 'F', 'G', 'P', 'U', 'G', 'R', 'P', 'H' };
+    /**
+     * Format version, incremented whenever the layout changes
+     */
+    static constexpr uint32_t VERSION = 1;
+    /**
+     * Written in native byte order, allowing readers to detect files written on a host of differing endianness
+     */
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    /**
+     * Exports the provided graph in the binary CSR format
+     *
+     * @param filepath The path to save the graph to
+     * @param directed_graph The graph buffers to export
+     * @param stream CUDA stream (required by directed_graph for synchronising device buffers)
+     *
+     * @throws exception::InvalidFilePath If the file cannot be opened for writing
+     * @throws exception::IDNotSet If any vertices or edges have not been fully defined
+     */
+    static void saveCSR(const std::string &filepath, const std::shared_ptr<const detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream);
+};
+
+}  // namespace io
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_IO_BINARYGRAPHWRITER_H_
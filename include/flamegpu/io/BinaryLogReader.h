@@ -0,0 +1,190 @@
+#ifndef INCLUDE_FLAMEGPU_IO_BINARYLOGREADER_H_
+#define INCLUDE_FLAMEGPU_IO_BINARYLOGREADER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include "flamegpu/io/BinaryLogger.h"
+#include "flamegpu/simulation/LogFrame.h"
+#include "flamegpu/detail/Any.h"
+#include "flamegpu/exception/FLAMEGPUException.h"
+
+namespace flamegpu {
+namespace io {
+
+/**
+ * Reader for log files produced by BinaryLogger
+ *
+ * Column data is not copied out of the file's buffer, instead typed pointers into the buffer are returned.
+ * The buffer can either be loaded from file, or provided by the user (e.g. a memory mapped file), in which case it must outlive the reader.
+ * @see BinaryLogger for a description of the file format
+ */
+class BinaryLogReader {
+ public:
+    /**
+     * A table of logged frames, where each logged property/reduction is a column with one value (or array of values) per frame
+     */
+    class Table {
+        friend class BinaryLogReader;
+
+     public:
+        /**
+         * Returns the number of frames within the table
+         */
+        unsigned int getRowCount() const { return rows; }
+        /**
+         * Returns true if a column of the provided name exists within the table
+         */
+        bool hasColumn(const std::string &name) const { return columns.find(name) != columns.end(); }
+        /**
+         * Returns the names of all columns within the table
+         */
+        std::vector<std::string> getColumnNames() const;
+        /**
+         * Returns the type of the named column
+         * @throws exception::InvalidArgument If the column does not exist
+         */
+        BinaryLogger::ColumnType getColumnType(const std::string &name) const;
+        /**
+         * Returns the number of elements stored per row of the named column (1 unless the column represents an array property)
+         * @throws exception::InvalidArgument If the column does not exist
+         */
+        unsigned int getColumnElements(const std::string &name) const;
+        /**
+         * Returns a pointer to the named column's data, which contains getRowCount() x getColumnElements() values
+         * @param name Name of the column
+         * @tparam T Type of the column's values
+         * @throws exception::InvalidArgument If the column does not exist
+         * @throws exception::InvalidVarType If the column does not have type T
+         * @see BinaryLogger::environmentColumn(), BinaryLogger::agentCountColumn(), BinaryLogger::agentColumn()
+         */
+        template<typename T>
+        const T *getColumn(const std::string &name) const;
+
+     private:
+        struct ColumnData {
+            BinaryLogger::ColumnType type;
+            unsigned int elements;
+            const char *data;
+        };
+        const ColumnData &getColumnData(const std::string &name, const char *caller) const;
+        std::map<std::string, ColumnData> columns;
+        unsigned int rows = 0;
+    };
+    /**
+     * The contents of a single call to BinaryLogger::log()
+     */
+    class Run {
+        friend class BinaryLogReader;
+
+     public:
+        /**
+         * Returns true if the run's config (random seed, and steps if logged from a RunPlan) was logged
+         */
+        bool hasConfig() const { return flags & BinaryLogger::Config; }
+        uint64_t getRandomSeed() const { return random_seed; }
+        /**
+         * Returns the steps of the RunPlan which the run was logged with, 0 if a RunPlan was not provided
+         */
+        unsigned int getSteps() const { return steps; }
+        /**
+         * Returns the environment property overrides of the RunPlan which the run was logged with
+         */
+        const std::map<std::string, detail::Any> &getPropertyOverrides() const { return property_overrides; }
+        /**
+         * Returns true if performance specs were logged, this occurs when timing is logged
+         */
+        bool hasPerformanceSpecs() const { return flags & BinaryLogger::PerformanceSpecs; }
+        const RunLog::PerformanceSpecs &getPerformanceSpecs() const { return performance_specs; }
+        /**
+         * Returns true if step frames were logged
+         */
+        bool hasStepLog() const { return flags & BinaryLogger::Steps; }
+        /**
+         * Returns the table of step frames, which contains "step_time" if step timing was logged
+         */
+        const Table &getStepLog() const { return step_log; }
+        /**
+         * Returns true if the exit frame was logged
+         */
+        bool hasExitLog() const { return flags & BinaryLogger::Exit; }
+        /**
+         * Returns the single row table containing the exit frame, which contains "rtc_time", "init_time", "exit_time" and "total_time" if exit timing was logged
+         */
+        const Table &getExitLog() const { return exit_log; }
+
+     private:
+        uint32_t flags = 0;
+        uint64_t random_seed = 0;
+        unsigned int steps = 0;
+        std::map<std::string, detail::Any> property_overrides;
+        RunLog::PerformanceSpecs performance_specs = {};
+        Table step_log;
+        Table exit_log;
+    };
+    /**
+     * Load a binary log from file
+     * @param path Path to the log file
+     * @throws exception::InvalidFilePath If the file cannot be read
+     * @throws exception::InvalidInputFile If the file is not a valid binary log
+     */
+    explicit BinaryLogReader(const std::string &path);
+    /**
+     * Read a binary log from an existing buffer (e.g. a memory mapped file), the buffer is not copied so must outlive the reader
+     * @param data Pointer to the start of the log, must be aligned to 8 bytes
+     * @param length Length of the buffer in bytes
+     * @throws exception::InvalidArgument If the buffer is not aligned to 8 bytes
+     * @throws exception::InvalidInputFile If the buffer does not contain a valid binary log
+     */
+    BinaryLogReader(const void *data, size_t length);
+    /**
+     * Tables point into the buffer, so the reader may be moved but not copied
+     */
+    BinaryLogReader(const BinaryLogReader &) = delete;
+    BinaryLogReader &operator=(const BinaryLogReader &) = delete;
+    BinaryLogReader(BinaryLogReader &&) = default;
+    BinaryLogReader &operator=(BinaryLogReader &&) = default;
+    /**
+     * Returns the number of runs within the log
+     */
+    unsigned int getRunCount() const { return static_cast<unsigned int>(runs.size()); }
+    /**
+     * Returns the run at the specified index, runs are stored in the order they were logged
+     * @throws exception::OutOfBoundsException If index is not less than getRunCount()
+     */
+    const Run &getRun(unsigned int index) const;
+    /**
+     * Returns the C++ type represented by a ColumnType
+     */
+    static std::type_index toTypeIndex(BinaryLogger::ColumnType type);
+
+ private:
+    /**
+     * Parses the file header and all run blocks
+     */
+    void parse(const char *data, size_t length);
+    /**
+     * Owned copy of the log, only used when loaded from file
+     */
+    std::vector<char> buffer;
+    std::vector<Run> runs;
+};
+
+template<typename T>
+const T *BinaryLogReader::Table::getColumn(const std::string &name) const {
+    const ColumnData &column = getColumnData(name, "getColumn");
+    if (toTypeIndex(column.type) != std::type_index(typeid(T))) {
+        THROW exception::InvalidVarType("Column '%s' has type %s, but requested type %s, "
+            "in BinaryLogReader::Table::getColumn()\n",
+            name.c_str(), toTypeIndex(column.type).name(), std::type_index(typeid(T)).name());
+    }
+    return reinterpret_cast<const T*>(column.data);
+}
+
+}  // namespace io
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_IO_BINARYLOGREADER_H_
@@ -0,0 +1,108 @@
+#ifndef INCLUDE_FLAMEGPU_IO_BINARYLOGGER_H_
+#define INCLUDE_FLAMEGPU_IO_BINARYLOGGER_H_
+
+#include <cstdint>
+#include <string>
+#include <typeindex>
+
+#include "flamegpu/io/Logger.h"
+#include "flamegpu/simulation/LoggingConfig.h"
+
+namespace flamegpu {
+struct RunLog;
+class RunPlan;
+
+namespace io {
+
+/**
+ * Binary columnar format Logger
+ *
+ * Rather than writing each value individually, every logged property/reduction becomes a typed column,
+ * the values of all step frames are then copied into their column in a single pass and written with a single call.
+ *
+ * Each call to log() appends a self contained run block to the file (a file header is written first if the file is empty),
+ * so the exit logs of many runs can share a single file, as with the other loggers.
+ * Files are appended to per run, not per step. As with the other loggers, log() receives a completed RunLog, so the step frames
+ * of a run are written together once the run has finished, rather than streamed to disk whilst it executes.
+ * All values are stored in the host's native byte order.
+ * - File header (16 bytes): char[8] MAGIC, uint32 VERSION, uint32 BYTE_ORDER_MARK
+ * - Run block: uint64 block length (including this field), uint32 flags (BlockFlags), uint32 steps (0 if a RunPlan was not provided), uint64 random seed
+ *   - If PerformanceSpecs: string device name, int32 cc major, int32 cc minor, int32 cuda version, uint32 seatbelts, string version
+ *   - If PlanOverrides: uint32 count, then per property: string name, uint8 type (ColumnType), uint32 elements, raw data
+ *   - If Steps: table of step frames
+ *   - If Exit: table containing the exit frame
+ * - Table: uint32 rows, uint32 columns, then per column: string name, uint8 type (ColumnType), uint32 elements, uint64 offset of the column data from the start of the run block
+ * - Strings are stored as uint32 length followed by the (non null terminated) characters
+ *
+ * Column data is stored contiguously (rows x elements values), aligned to 8 bytes and run blocks are a multiple of 8 bytes,
+ * so a memory mapped log file can be read in place.
+ * @see BinaryLogReader
+ */
+class BinaryLogger : public Logger {
+ public:
+    /**
+     * Identifies the type of values stored within a column
+     */
+    enum ColumnType : uint8_t { Float = 0, Double, Int64, UInt64, Int32, UInt32, Int16, UInt16, Int8, UInt8, Char };
+    /**
+     * Flags denoting which sections are present within a run block
+     */
+    enum BlockFlags : uint32_t { Config = 1 << 0, PlanOverrides = 1 << 1, PerformanceSpecs = 1 << 2, Steps = 1 << 3, Exit = 1 << 4, StepTime = 1 << 5, ExitTime = 1 << 6 };
+    /**
+     * Identifies binary log files
+     */
+    static constexpr char MAGIC[8] = { 'F', 'G', 'P', 'U', 'L', 'O', 'G', '\0' };
+    /**
+     * Format version, incremented whenever the layout changes
+     */
+    static constexpr uint32_t VERSION = 1;
+    /**
+     * Written in native byte order, allowing readers to detect files written on a host of differing endianness
+     */
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    /**
+     * @param outPath File for the log to be output to
+     * @param prettyPrint Ignored, binary output cannot be pretty printed
+     * @param truncateFile If true and output file already exists, it will be truncated
+     */
+    BinaryLogger(const std::string &outPath, bool prettyPrint, bool truncateFile);
+    /**
+     * Log a runlog to file, using a RunPlan in place of config
+     * @throws May throw exceptions if logging to file failed for any reason
+     */
+    void log(const RunLog &log, const RunPlan &plan, bool logSteps = true, bool logExit = true, bool logStepTime = false, bool logExitTime = false) const override;
+    /**
+     * Log a runlog to file, uses config data (random seed) from the RunLog
+     * @throws May throw exceptions if logging to file failed for any reason
+     */
+    void log(const RunLog &log, bool logConfig = true, bool logSteps = true, bool logExit = true, bool logStepTime = false, bool logExitTime = false) const override;
+    /**
+     * Returns the ColumnType which represents the provided type
+     * @throws exception::UnsupportedVarType If the type cannot be stored in a binary log
+     */
+    static ColumnType toColumnType(const std::type_index &type);
+    /**
+     * Returns the size in bytes of a single value of the provided ColumnType
+     */
+    static size_t columnTypeSize(ColumnType type);
+    /**
+     * Column names used within binary logs
+     * Timing columns are named after the matching JSON keys, e.g. "step_index", "step_time" and "total_time"
+     */
+    static std::string environmentColumn(const std::string &property_name);
+    static std::string agentCountColumn(const std::string &agent_name, const std::string &state_name);
+    static std::string agentColumn(const std::string &agent_name, const std::string &state_name, const std::string &variable_name, LoggingConfig::Reduction reduction);
+
+ private:
+    /**
+     * Internal logging method, allows Plan to be passed as null
+     */
+    void logCommon(const RunLog &log, const RunPlan *plan, bool logConfig, bool logSteps, bool logExit, bool logStepTime, bool logExitTime) const;
+
+    std::string out_path;
+    bool truncateFile;
+};
+}  // namespace io
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_IO_BINARYLOGGER_H_
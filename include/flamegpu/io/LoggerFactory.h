@@ -7,10 +7,12 @@
 #include <utility>
 #include <algorithm>
 #include <filesystem>
+#include <locale>
 
 #include "flamegpu/io/Logger.h"
 #include "flamegpu/io/JSONLogger.h"
 #include "flamegpu/io/XMLLogger.h"
+#include "flamegpu/io/BinaryLogger.h"
 
 namespace flamegpu {
 namespace io {
@@ -31,6 +33,8 @@ class LoggerFactory {
             return std::make_unique<XMLLogger>(output_path, prettyPrint, truncateFile);
         } else if (extension == ".json") {
             return std::make_unique<JSONLogger>(output_path, prettyPrint, truncateFile);
+        } else if (extension == ".bin") {
+            return std::make_unique<BinaryLogger>(output_path, prettyPrint, truncateFile);
         } else if (extension.empty()) {
             THROW exception::InvalidFilePath("Filepath '%s' contains unsuitable characters or lacks a file extension, "
                 "in LoggerFactory::createLogger().", output_path.c_str());
@@ -39,6 +43,25 @@ class LoggerFactory {
             "by LoggerFactory::createLogger().",
             output_path.c_str());
     }
+    /**
+     * Return a clean file extension from the provided string
+     * If the file extension is not supported by createLogger() empty string is returned instead
+     */
+    static std::string detectSupportedFileExt(const std::string &user_file_ext) {
+        std::string rtn = user_file_ext;
+        // Move entire string to lower case
+        std::transform(rtn.begin(), rtn.end(), rtn.begin(), [](unsigned char c) { return std::use_facet< std::ctype<char>>(std::locale()).tolower(c); });
+        // Strip first character if it is '.'
+        if (rtn[0] == '.')
+          rtn = rtn.substr(1);
+        // Compare against supported formats
+        if (rtn == "xml" ||
+            rtn == "json" ||
+            rtn == "bin") {
+            return rtn;
+        }
+        return "";
+    }
 };
 }  // namespace io
 }  // namespace flamegpu
@@ -1,9 +1,13 @@
 #ifndef INCLUDE_FLAMEGPU_IO_STATEREADER_H_
 #define INCLUDE_FLAMEGPU_IO_STATEREADER_H_
 
+#include <cstdint>
+#include <cstdio>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <any>
 
@@ -36,6 +40,12 @@ class StateReader {
      * @param verbosity Verbosity level to use during load
      */
     virtual void parse(const std::string &input_file, const std::shared_ptr<const ModelData> &model, Verbosity verbosity) = 0;
+    /**
+     * Set the number of threads used to parse agent populations
+     * Agent records are split into chunks, which are parsed in parallel into their final location within each population
+     * @param thread_count The number of threads (including the calling thread), if 0 std::thread::hardware_concurrency() is used
+     */
+    void setThreadCount(unsigned int thread_count);
 
     // -----------------------------------------------------------------------
     //  The Easy Interface
@@ -70,7 +80,54 @@ class StateReader {
     void getAgents(util::StringPairUnorderedMap<std::shared_ptr<AgentVector>> &agents_init);
 
  protected:
+    /**
+     * The maximum number of agent records within a single chunk
+     */
+    static constexpr unsigned int AGENTS_PER_CHUNK = 4096;
+    /**
+     * A contiguous run of agent records within the input file, which can be parsed independently of the rest of the file
+     */
+    struct AgentChunk {
+        /**
+         * Offset of the chunk's first agent record within the input file
+         */
+        uint64_t file_offset;
+        /**
+         * Total number of agent records within the chunk
+         */
+        unsigned int agent_count;
+        /**
+         * The populations which the chunk's agents belong to, and the number of the chunk's agents within each
+         * parseChunks() replaces each count with the index of the chunk's first agent within the population
+         */
+        std::vector<std::pair<AgentVector*, unsigned int>> populations;
+    };
+    /**
+     * Records an agent, encountered during the first pass over the input file, to the chunk index
+     * @param chunks The chunk index
+     * @param file_offset Offset of the agent's record within the input file
+     * @param population The population which the agent belongs to
+     * @param new_run True if the agent's record does not directly follow the previous agent's record, so must begin a new chunk
+     */
+    static void addAgentToChunks(std::vector<AgentChunk> &chunks, uint64_t file_offset, AgentVector *population, bool new_run);
+    /**
+     * Resizes each population to hold the agents of all chunks, and assigns each chunk a range of indices within them
+     * Then parses each chunk, in parallel
+     * @param chunks The chunk index
+     * @param parse_chunk Callable which parses the agent records of a chunk into its assigned indices
+     * @throws Rethrows the first exception thrown by parse_chunk
+     */
+    void parseChunks(std::vector<AgentChunk> &chunks, const std::function<void(const AgentChunk&)> &parse_chunk);
+    /**
+     * Opens the input file for binary reading, positioned at the specified offset
+     * @param input_file Path to the file to be opened
+     * @param offset Offset to seek to
+     * @throws exception::InvalidInputFile If the file cannot be opened, or the offset cannot be reached
+     */
+    static std::unique_ptr<FILE, int(*)(FILE*)> openFile(const std::string &input_file, uint64_t offset = 0);
+
     std::string input_filepath;
+    unsigned int thread_count = 0;
 
     void resetCache();
 
@@ -10,6 +10,7 @@ namespace flamegpu {
 namespace io {
 /**
  * XML format StateReader
+ * The file is streamed through a fixed size buffer and parsed in a single pass, so memory use is bounded by the size of the loaded populations rather than the file
  */
 class XMLStateReader : public StateReader {
  public:
@@ -20,13 +21,6 @@ class XMLStateReader : public StateReader {
      * @param verbosity Verbosity level to use during load
      */
     void parse(const std::string &input_file, const std::shared_ptr<const ModelData> &model, Verbosity verbosity) override;
-
- private:
-    /**
-     * Flamegpu1 xml input files are allowed to omit state
-     * This function extracts the initial state for the named agent from model_state;
-     */
-    static std::string getInitialState(const std::shared_ptr<const ModelData> &model, const std::string& agent_name);
 };
 }  // namespace io
 }  // namespace flamegpu
@@ -10,6 +10,7 @@
 #include "flamegpu/model/AgentFunctionDescription.h"
 #include "flamegpu/model/HostFunctionDescription.h"
 #include "flamegpu/model/SubModelDescription.h"
+#include "flamegpu/util/StringPair.h"
 
 namespace flamegpu {
 
@@ -44,7 +45,10 @@ class DependencyGraph {
      */
     void addRoot(DependencyNode& root);
     /**
-     * Generates optimal layers based on the dependencies specified and adds them to the model
+     * Generates layers based on the dependencies specified and adds them to the model
+     * Ready nodes are placed by list scheduling, prioritising those which begin the longest remaining chain of dependents.
+     * Each layer is filled with as many non-conflicting agent functions as are ready, host functions and submodels are placed in their own layer.
+     * The dependencies of each node are recorded within the generated layers (LayerData::dependencies).
      * @param model The model the layers should be added to
      * @throws exception::InvalidDependencyGraph if the model already has layers attached
      */
@@ -71,20 +75,27 @@ class DependencyGraph {
      */
     std::vector<DependencyNode*> roots;
     /**
-     * Used internally for cycle checking
+     * Validates the graph and returns all nodes reachable from the roots in topological order (each node follows all of its dependencies)
+     * This visits each node and dependency once
+     * @throws exception::InvalidDependencyGraph If the graph is empty, a root has dependencies or the graph contains a cycle
      */
-    bool doesFunctionExistInStack(DependencyNode* function, std::vector<DependencyNode*>& functionStack) const;
+    std::vector<DependencyNode*> topologicalSort() const;
     /**
-     * Check the subtree from a node is valid
-     * @param node the root of the subtree
-     * @param functionStack functions are already present in the tree
-     * @returns True if the subtree is valid
+     * Issues a warning if the graph is missing agent functions which are present in the model this dependency graph is attached to
+     * @param nodes All nodes within the graph
      */
-    bool validateSubTree(DependencyNode* node, std::vector<DependencyNode*>& functionStack) const;
+    void checkForUnattachedFunctions(const std::vector<DependencyNode*>& nodes);
     /**
-     * Issues a warning if the graph is missing agent functions which are present in the model this dependency graph is attached to
+     * Adds the node to the layer based on its concrete type
+     * @param layer The layer to add the node to
+     * @param node The agent function, host function or submodel to add
+     */
+    static void addNodeToLayer(LayerDescription& layer, DependencyNode* node);
+    /**
+     * Returns true if the two agent functions cannot execute within the same layer
+     * This mirrors the checks performed by LayerDescription::addAgentFunction()
      */
-    void checkForUnattachedFunctions();
+    static bool agentFunctionsConflict(const AgentFunctionData& a, const AgentFunctionData& b);
     /**
      * Generates a new layer in the model the dependency graph is associated with
      */
@@ -95,6 +106,12 @@ class DependencyGraph {
      * @returns std::string The name of the node
      */
     static std::string getNodeName(DependencyNode* node);
+    /**
+     * Returns the key which identifies the node within the layer it is placed in
+     * @param node The node to get the key of
+     * @see LayerData::dependencies
+     */
+    static util::StringPair getNodeMemberName(DependencyNode* node);
     /**
      * Structured representation of the layers added to the model
      */
@@ -5,9 +5,12 @@
 #include <set>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "flamegpu/runtime/HostAPI_macros.h"  // Todo replace with std/cub style fns (see AgentFunction.cuh)
 #include "flamegpu/model/ModelData.h"
+#include "flamegpu/util/StringPair.h"
 
 namespace flamegpu {
 
@@ -56,6 +59,17 @@ struct LayerData {
      * (Eventually this will be replaced when we move to a more durable mode of layers, e.g. dependency analysis)
      */
     flamegpu::size_type index;
+    /**
+     * Identifies a member of a layer, by the index of the layer and the (agent name, function name) of the member agent function
+     * Host functions and submodels are identified by a pair of empty names, as they are the only member of their layer
+     */
+    typedef std::pair<flamegpu::size_type, util::StringPair> MemberID;
+    /**
+     * Dependencies of each member of the layer, as specified via DependencyNode::dependsOn()
+     * Keys are the names of member agent functions (or empty names for a host function or submodel), values identify the members of earlier layers they depend upon
+     * This is only populated for layers generated by DependencyGraph::generateLayers(), it is empty for layers created manually
+     */
+    util::StringPairMap<std::vector<MemberID>> dependencies;
     /**
      * Equality operator, checks whether LayerData hierarchies are functionally the same
      * @returns True when layers are the same
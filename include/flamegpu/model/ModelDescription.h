@@ -33,6 +33,7 @@ class ModelDescription {
      * Simulation accesses the classes internals to convert it to a constant ModelData
      */
     friend class CUDASimulation;
+    friend class CPUSimulation;
     friend class CUDAEnsemble;
     friend class RunPlanVector;
     friend class RunPlan;
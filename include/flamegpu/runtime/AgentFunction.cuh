@@ -4,7 +4,7 @@
 #include <cuda_runtime.h>
 #include <device_launch_parameters.h>
 
-#include "flamegpu/detail/curand.cuh"
+#include "flamegpu/detail/philox.cuh"
 #include "flamegpu/runtime/detail/SharedBlock.h"
 #include "flamegpu/defines.h"
 #include "flamegpu/exception/FLAMEGPUDeviceException.cuh"
@@ -32,7 +32,7 @@ typedef void(AgentFunctionWrapper)(
     const unsigned int popNo,
     const void *in_messagelist_metadata,
     const void *out_messagelist_metadata,
-    detail::curandState *d_rng,
+    detail::PhiloxKey rng_key,
     unsigned int *scanFlag_agentDeath,
     unsigned int *scanFlag_messageOutput,
     unsigned int *scanFlag_agentOutput);  // Can't put __global__ in a typedef
@@ -49,7 +49,7 @@ typedef void(AgentFunctionWrapper)(
  * @param popNo Total number of agents executing the function (number of threads launched)
  * @param in_messagelist_metadata Pointer to the MessageIn metadata struct, it is interpreted by MessageIn
  * @param out_messagelist_metadata Pointer to the MessageOut metadata struct, it is interpreted by MessageOut
- * @param d_rng Array of curand states for this kernel
+ * @param rng_key Key of the random stream for this kernel, agents draw from it by their ID
  * @param scanFlag_agentDeath Scanflag array for agent death
  * @param scanFlag_messageOutput Scanflag array for optional message output
  * @param scanFlag_agentOutput Scanflag array for optional agent output
@@ -72,7 +72,7 @@ __global__ void agent_function_wrapper(
     const unsigned int popNo,
     const void *in_messagelist_metadata,
     const void *out_messagelist_metadata,
-    detail::curandState *d_rng,
+    detail::PhiloxKey rng_key,
     unsigned int *scanFlag_agentDeath,
     unsigned int *scanFlag_messageOutput,
     unsigned int *scanFlag_agentOutput) {
@@ -96,13 +96,13 @@ __global__ void agent_function_wrapper(
     // Sync the block after Thread 0 has written to shared.
     __syncthreads();
     #endif  // __CUDACC__
-    // Must be terminated here, else AgentRandom has bounds issues inside DeviceAPI constructor
+    // Must be terminated here, else AgentRandom reads the ID of an agent out of bounds inside DeviceAPI constructor
     if (DeviceAPI<MessageIn, MessageOut>::getIndex() >= popNo)
         return;
     // create a new device FLAME_GPU instance
     DeviceAPI<MessageIn, MessageOut> api = DeviceAPI<MessageIn, MessageOut>(
         d_agent_output_nextID,
-        d_rng,
+        rng_key,
         scanFlag_agentOutput,
         MessageIn::In(in_messagelist_metadata),
         MessageOut::Out(out_messagelist_metadata, scanFlag_messageOutput));
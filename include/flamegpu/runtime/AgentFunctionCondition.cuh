@@ -24,7 +24,7 @@ typedef void(AgentFunctionConditionWrapper)(
     const char* d_env_buffer,
 #endif
     const unsigned int popNo,
-    detail::curandState *d_rng,
+    detail::PhiloxKey rng_key,
     unsigned int *scanFlag_conditionResult);  // Can't put __global__ in a typedef
 
 /**
@@ -36,7 +36,7 @@ typedef void(AgentFunctionConditionWrapper)(
  * @param d_state_name Pointer to agent state string
  * @param d_env_buffer Pointer to env buffer in device memory
  * @param popNo Total number of agents exeucting the function (number of threads launched)
- * @param d_rng Array of curand states for this kernel
+ * @param rng_key Key of the random stream for this kernel, agents draw from it by their ID
  * @param scanFlag_conditionResult Scanflag array for condition result (this uses same buffer as agent death)
  * @tparam AgentFunctionCondition The modeller defined agent function condition (defined as FLAMEGPU_AGENT_FUNCTION_CONDITION in model code)
  * @note This is basically a cutdown version of agent_function_wrapper
@@ -53,7 +53,7 @@ __global__ void agent_function_condition_wrapper(
     const char* d_env_buffer,
 #endif
     const unsigned int popNo,
-    detail::curandState *d_rng,
+    detail::PhiloxKey rng_key,
     unsigned int *scanFlag_conditionResult) {
     // We place these at the start of shared memory, so we can locate it anywhere in device code without a reference
     using detail::sm;
@@ -75,11 +75,11 @@ __global__ void agent_function_condition_wrapper(
     // Sync the block after Thread 0 has written to shared.
     __syncthreads();
 #endif  // __CUDACC__
-    // Must be terminated here, else AgentRandom has bounds issues inside DeviceAPI constructor
+    // Must be terminated here, else AgentRandom reads the ID of an agent out of bounds inside DeviceAPI constructor
     if (ReadOnlyDeviceAPI::getIndex() >= popNo)
         return;
     // create a new device FLAME_GPU instance
-    ReadOnlyDeviceAPI api = ReadOnlyDeviceAPI(d_rng);
+    ReadOnlyDeviceAPI api = ReadOnlyDeviceAPI(rng_key);
 
     // call the user specified device function
     {
@@ -0,0 +1,371 @@
+#ifndef INCLUDE_FLAMEGPU_RUNTIME_CPUAGENTAPI_H_
+#define INCLUDE_FLAMEGPU_RUNTIME_CPUAGENTAPI_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "flamegpu/defines.h"
+#include "flamegpu/exception/FLAMEGPUException.h"
+#include "flamegpu/simulation/detail/EnvironmentManager.cuh"
+#include "flamegpu/simulation/detail/HostSoABuffer.h"
+
+namespace flamegpu {
+class CPUSimulation;
+
+/**
+ * Host equivalent of DeviceAPI, passed to agent functions executed by CPUSimulation
+ *
+ * An instance represents a single executing agent, the interface mirrors the subset of DeviceAPI which can be provided by the host backend.
+ * Instances are only constructed by CPUSimulation.
+ */
+class CPUAgentAPI {
+    friend class CPUSimulation;
+
+ public:
+    /**
+     * Read-only access to environment properties
+     */
+    class Environment {
+        friend class CPUAgentAPI;
+        explicit Environment(detail::EnvironmentManager &_env) : env(_env) { }
+        detail::EnvironmentManager &env;
+
+     public:
+        /**
+         * Gets an environment property
+         * @param name name used for accessing the property
+         * @tparam T Type of the environment property
+         * @throws exception::InvalidEnvProperty If a property of the name does not exist
+         */
+        template<typename T>
+        T getProperty(const std::string &name) const { return env.getProperty<T>(name); }
+        /**
+         * Gets an element of an environment property array
+         * @param name name used for accessing the property array
+         * @param index Index of the element within the array
+         * @tparam T Type of the value to be returned
+         * @tparam N (Optional) The length of the array property, checked if provided
+         * @throws exception::InvalidEnvProperty If a property of the name does not exist
+         */
+        template<typename T, flamegpu::size_type N = 0>
+        T getProperty(const std::string &name, const flamegpu::size_type index) const { return env.getProperty<T, N>(name, index); }
+    };
+    /**
+     * Per agent random number generation
+     *
+     * Each executing agent receives an independent stream, derived from the simulation seed, step, agent function and agent index.
+     * Results are therefore reproducible for a given seed, regardless of the number of threads used.
+     */
+    class Random {
+        friend class CPUAgentAPI;
+        explicit Random(const uint64_t seed) : state(seed) { }
+        /**
+         * splitmix64, advances the generator's state and returns 64 random bits
+         */
+        uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+        uint64_t state;
+
+     public:
+        /**
+         * Returns a uniformly distributed floating point value in the range [0, 1)
+         * @tparam T Floating point return type
+         */
+        template<typename T>
+        T uniform() {
+            static_assert(std::is_floating_point<T>::value, "Invalid template argument for CPUAgentAPI::Random::uniform()");
+            constexpr int DIGITS = std::numeric_limits<T>::digits;
+            return static_cast<T>(next() >> (64 - DIGITS)) * (static_cast<T>(1) / static_cast<T>(static_cast<uint64_t>(1) << DIGITS));
+        }
+        /**
+         * Returns a value uniformly distributed within the range [min, max] (integer types) or [min, max) (floating point types)
+         * @param min Lower bound of the range
+         * @param max Upper bound of the range
+         * @throws exception::InvalidArgument If min > max
+         */
+        template<typename T>
+        T uniform(T min, T max) {
+            static_assert(std::is_arithmetic<T>::value, "Invalid template argument for CPUAgentAPI::Random::uniform(T min, T max)");
+            if (min > max) {
+                THROW exception::InvalidArgument("Invalid arguments passed to CPUAgentAPI::Random::uniform(), min > max.");
+            }
+            if constexpr (std::is_floating_point<T>::value) {
+                return min + (max - min) * uniform<T>();
+            } else {
+                return static_cast<T>(min + static_cast<T>((static_cast<double>(max) - static_cast<double>(min) + 1) * uniform<double>()));
+            }
+        }
+        /**
+         * Returns a normally distributed floating point value, with mean 0 and standard deviation 1
+         * @tparam T Floating point return type
+         */
+        template<typename T>
+        T normal() {
+            static_assert(std::is_floating_point<T>::value, "Invalid template argument for CPUAgentAPI::Random::normal()");
+            // Box-Muller transform, 1 - uniform() is within (0, 1] so log() is finite
+            const double u1 = 1.0 - uniform<double>();
+            const double u2 = uniform<double>();
+            return static_cast<T>(std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * 3.14159265358979323846 * u2));
+        }
+        /**
+         * Returns a log-normally distributed floating point value
+         * @param mean Mean of the underlying normal distribution
+         * @param stddev Standard deviation of the underlying normal distribution
+         */
+        template<typename T>
+        T logNormal(const T mean, const T stddev) {
+            return static_cast<T>(std::exp(mean + stddev * normal<T>()));
+        }
+    };
+    /**
+     * Brute force message input, iterates all messages in the input list
+     */
+    class MessageIn {
+        friend class CPUAgentAPI;
+        explicit MessageIn(const detail::HostSoABuffer *_buffer) : buffer(_buffer) { }
+        const detail::HostSoABuffer *buffer;
+
+     public:
+        /**
+         * A single message within the list
+         */
+        class Message {
+            friend class MessageIn;
+            Message(const detail::HostSoABuffer *_buffer, const unsigned int _index) : buffer(_buffer), index(_index) { }
+            const detail::HostSoABuffer *buffer;
+            unsigned int index;
+
+         public:
+            /**
+             * Returns the specified message variable
+             * @param name Name of the variable
+             * @tparam T Type of the variable
+             */
+            template<typename T>
+            T getVariable(const std::string &name) const { return *buffer->getElement<T>(name, index); }
+            /**
+             * Returns an element of the specified message array variable
+             * @param name Name of the variable
+             * @param array_index Index of the element within the array
+             * @tparam T Type of the variable
+             * @tparam N Length of the array variable
+             */
+            template<typename T, flamegpu::size_type N>
+            T getVariable(const std::string &name, const unsigned int array_index) const { return *buffer->getElement<T, N>(name, index, array_index); }
+            /**
+             * Returns the index of the message within the list
+             */
+            unsigned int getIndex() const { return index; }
+            bool operator==(const Message &other) const { return index == other.index; }
+            bool operator!=(const Message &other) const { return index != other.index; }
+            Message &operator++() { ++index; return *this; }
+            const Message &operator*() const { return *this; }
+        };
+        typedef Message iterator;
+        /**
+         * Returns the number of messages in the input list
+         */
+        unsigned int size() const { return buffer ? buffer->size() : 0; }
+        Message at(const unsigned int index) const {
+            if (index >= size()) {
+                THROW exception::OutOfBoundsException("Message index %u is out of bounds of message list with %u messages, "
+                    "in CPUAgentAPI::MessageIn::at().", index, size());
+            }
+            return Message(buffer, index);
+        }
+        iterator begin() const { return Message(buffer, 0); }
+        iterator end() const { return Message(buffer, size()); }
+    };
+    /**
+     * Message output, each agent may output a single message
+     */
+    class MessageOut {
+        friend class CPUAgentAPI;
+        MessageOut(detail::HostSoABuffer *_buffer, std::vector<char> *_flags, const unsigned int _index) : buffer(_buffer), flags(_flags), index(_index) { }
+        detail::HostSoABuffer *buffer;
+        std::vector<char> *flags;
+        unsigned int index;
+        void check() const {
+            if (!buffer) {
+                THROW exception::InvalidMessage("Agent function does not have message output, "
+                    "in CPUAgentAPI::MessageOut::setVariable().");
+            }
+        }
+
+     public:
+        /**
+         * Sets a variable of the message output by the executing agent
+         * @param name Name of the variable
+         * @param value Value to set
+         * @tparam T Type of the variable
+         */
+        template<typename T>
+        void setVariable(const std::string &name, const T value) {
+            check();
+            *buffer->getElement<T>(name, index) = value;
+            (*flags)[index] = 1;
+        }
+        /**
+         * Sets an element of an array variable of the message output by the executing agent
+         * @param name Name of the variable
+         * @param array_index Index of the element within the array
+         * @param value Value to set
+         * @tparam T Type of the variable
+         * @tparam N Length of the array variable
+         */
+        template<typename T, flamegpu::size_type N>
+        void setVariable(const std::string &name, const unsigned int array_index, const T value) {
+            check();
+            *buffer->getElement<T, N>(name, index, array_index) = value;
+            (*flags)[index] = 1;
+        }
+    };
+    /**
+     * Agent output, each agent may output a single new agent
+     */
+    class AgentOut {
+        friend class CPUAgentAPI;
+        AgentOut(detail::HostSoABuffer *_buffer, std::vector<char> *_flags, const unsigned int _index) : buffer(_buffer), flags(_flags), index(_index) { }
+        detail::HostSoABuffer *buffer;
+        std::vector<char> *flags;
+        unsigned int index;
+        void check(const std::string &name) const {
+            if (!buffer) {
+                THROW exception::InvalidOperation("Agent function does not have agent output, "
+                    "in CPUAgentAPI::AgentOut::setVariable().");
+            }
+            if (!name.empty() && name[0] == '_') {
+                THROW exception::ReservedName("Variable names cannot begin with '_', this is reserved for internal usage, "
+                    "in CPUAgentAPI::AgentOut::setVariable().");
+            }
+        }
+
+     public:
+        /**
+         * Sets a variable of the new agent, the agent is created once the agent function has completed
+         * @param name Name of the variable
+         * @param value Value to set
+         * @tparam T Type of the variable
+         */
+        template<typename T>
+        void setVariable(const std::string &name, const T value) {
+            check(name);
+            *buffer->getElement<T>(name, index) = value;
+            (*flags)[index] = 1;
+        }
+        /**
+         * Sets an element of an array variable of the new agent
+         * @param name Name of the variable
+         * @param array_index Index of the element within the array
+         * @param value Value to set
+         * @tparam T Type of the variable
+         * @tparam N Length of the array variable
+         */
+        template<typename T, flamegpu::size_type N>
+        void setVariable(const std::string &name, const unsigned int array_index, const T value) {
+            check(name);
+            *buffer->getElement<T, N>(name, index, array_index) = value;
+            (*flags)[index] = 1;
+        }
+    };
+    /**
+     * Returns the specified variable from the executing agent
+     * @param name Name of the variable
+     * @tparam T Type of the variable
+     */
+    template<typename T>
+    T getVariable(const std::string &name) const { return *agent.getElement<T>(name, index); }
+    /**
+     * Returns an element of the specified array variable from the executing agent
+     * @param name Name of the variable
+     * @param array_index Index of the element within the array
+     * @tparam T Type of the variable
+     * @tparam N Length of the array variable
+     */
+    template<typename T, flamegpu::size_type N>
+    T getVariable(const std::string &name, const unsigned int array_index) const { return *agent.getElement<T, N>(name, index, array_index); }
+    /**
+     * Sets a variable of the executing agent
+     * @param name Name of the variable
+     * @param value Value to set
+     * @tparam T Type of the variable
+     */
+    template<typename T>
+    void setVariable(const std::string &name, const T value) {
+        if (!name.empty() && name[0] == '_') {
+            THROW exception::ReservedName("Variable names cannot begin with '_', this is reserved for internal usage, "
+                "in CPUAgentAPI::setVariable().");
+        }
+        *agent.getElement<T>(name, index) = value;
+    }
+    /**
+     * Sets an element of an array variable of the executing agent
+     * @param name Name of the variable
+     * @param array_index Index of the element within the array
+     * @param value Value to set
+     * @tparam T Type of the variable
+     * @tparam N Length of the array variable
+     */
+    template<typename T, flamegpu::size_type N>
+    void setVariable(const std::string &name, const unsigned int array_index, const T value) {
+        if (!name.empty() && name[0] == '_') {
+            THROW exception::ReservedName("Variable names cannot begin with '_', this is reserved for internal usage, "
+                "in CPUAgentAPI::setVariable().");
+        }
+        *agent.getElement<T, N>(name, index, array_index) = value;
+    }
+    /**
+     * Returns the executing agent's unique identifier
+     */
+    id_t getID() const { return *agent.getElement<id_t>(ID_VARIABLE_NAME, index); }
+    /**
+     * Returns the current step index, the first step has index 0
+     */
+    unsigned int getStepCounter() const { return step; }
+
+    const Environment environment;
+    Random random;
+    const MessageIn message_in;
+    MessageOut message_out;
+    AgentOut agent_out;
+
+ private:
+    /**
+     * Constructs the API for the agent at index within the agent buffer
+     * @param _agent Buffer holding the executing agents
+     * @param _index Index of the executing agent within _agent
+     * @param _step The current step index
+     * @param env Environment of the executing simulation
+     * @param seed Seed for the agent's random stream
+     * @param _message_in Input message list, nullptr if the function has no message input
+     * @param _message_out Output message buffer and flags, nullptr if the function has no message output
+     * @param _agent_out Output agent buffer and flags, nullptr if the function has no agent output
+     */
+    CPUAgentAPI(detail::HostSoABuffer &_agent, const unsigned int _index, const unsigned int _step, detail::EnvironmentManager &env, const uint64_t seed,
+        const detail::HostSoABuffer *_message_in,
+        detail::HostSoABuffer *_message_out, std::vector<char> *message_out_flags,
+        detail::HostSoABuffer *_agent_out, std::vector<char> *agent_out_flags)
+        : environment(env)
+        , random(seed)
+        , message_in(_message_in)
+        , message_out(_message_out, message_out_flags, _index)
+        , agent_out(_agent_out, agent_out_flags, _index)
+        , agent(_agent)
+        , index(_index)
+        , step(_step) { }
+    detail::HostSoABuffer &agent;
+    unsigned int index;
+    unsigned int step;
+};
+
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_RUNTIME_CPUAGENTAPI_H_
@@ -47,15 +47,15 @@ class ReadOnlyDeviceAPI {
         const detail::curve::CurveTable *,
 #endif
         const unsigned int,
-        detail::curandState *,
+        detail::PhiloxKey,
         unsigned int *);
 
  public:
     /**
-     * @param d_rng Pointer to the device random state buffer to be used
+     * @param rng_key Key of the random stream for the agent function condition being executed
      */
-    __device__ ReadOnlyDeviceAPI(detail::curandState *&d_rng)
-        : random(AgentRandom(&d_rng[getIndex()]))
+    __device__ ReadOnlyDeviceAPI(const detail::PhiloxKey &rng_key)
+        : random(AgentRandom(rng_key))
         , environment(DeviceEnvironment()) { }
     /**
      * Returns the specified variable from the currently executing agent
@@ -97,7 +97,7 @@ class ReadOnlyDeviceAPI {
 
     /**
      * Provides access to random functionality inside agent functions
-     * @note random state isn't stored within the object, so it can be const
+     * @note only the generator's draw counter is stored within the object (as mutable), so it can be const
      */
     const AgentRandom random;
     /**
@@ -175,7 +175,7 @@ class DeviceAPI {
         const unsigned int,
         const void *,
         const void *,
-        detail::curandState *,
+        detail::PhiloxKey,
         unsigned int *,
         unsigned int *,
         unsigned int *);
@@ -252,21 +252,21 @@ class DeviceAPI {
     /**
      * Constructs the device-only API class instance.
      * @param d_agent_output_nextID If agent birth is enabled, a pointer to the next available ID in global memory. Device agent birth will atomically increment this value to allocate IDs.
-     * @param d_rng Device pointer to curand state for this kernel, index 0 should for TID()==0
+     * @param rng_key Key of the random stream for the agent function being executed
      * @param scanFlag_agentOutput Array for agent output scan flag
      * @param message_in Input message handler
      * @param message_out Output message handler
      */
     __device__ DeviceAPI(
         id_t *&d_agent_output_nextID,
-        detail::curandState *&d_rng,
+        const detail::PhiloxKey &rng_key,
         unsigned int *&scanFlag_agentOutput,
         typename MessageIn::In &&message_in,
         typename MessageOut::Out &&message_out)
         : message_in(message_in)
         , message_out(message_out)
         , agent_out(AgentOut(d_agent_output_nextID, scanFlag_agentOutput))
-        , random(AgentRandom(&d_rng[getIndex()]))
+        , random(AgentRandom(rng_key))
         , environment(DeviceEnvironment())
     { }
         /**
@@ -391,7 +391,7 @@ class DeviceAPI {
     const AgentOut agent_out;
     /**
      * Provides access to random functionality inside agent functions
-     * @note random state isn't stored within the object, so it can be const
+     * @note only the generator's draw counter is stored within the object (as mutable), so it can be const
      */
     const AgentRandom random;
     /**
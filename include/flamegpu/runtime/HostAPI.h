@@ -46,6 +46,8 @@ class HostAPI {
     typedef std::unordered_map<std::string, AgentDataBuffer> AgentDataBufferStateMap;
     typedef std::unordered_map<std::string, VarOffsetStruct> AgentOffsetMap;
     typedef std::unordered_map<std::string, AgentDataBufferStateMap> AgentDataMap;
+    typedef std::unordered_map<std::string, NewAgentBatchBuffer> AgentBatchBufferStateMap;
+    typedef std::unordered_map<std::string, AgentBatchBufferStateMap> AgentBatchMap;
     typedef std::unordered_map<std::string, std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers>> CUDADirectedGraphMap;
 
     /**
@@ -57,6 +59,7 @@ class HostAPI {
         detail::CUDAScatter &scatter,
         const AgentOffsetMap &agentOffsets,
         AgentDataMap &agentData,
+        AgentBatchMap &agentBatches,
         const std::shared_ptr<detail::EnvironmentManager> &env,
         const std::shared_ptr<detail::CUDAMacroEnvironment> &macro_env,
         CUDADirectedGraphMap &directed_graph_map,
@@ -135,6 +138,12 @@ class HostAPI {
      * when new agents are copied to device.
      */
     AgentDataMap &agentData;
+    /*
+     * Owned by CUDASimulation, this provides storage for batches of new agents
+     * Used for batched host agent creation, the batches are emptied end of each step
+     * when new agents are copied to device.
+     */
+    AgentBatchMap &agentBatches;
     /**
      * Cuda scatter singleton
      */
@@ -87,6 +87,12 @@ class DeviceAgentVector_impl : protected AgentVector {
      */
     using AgentVector::back;
     // using AgentVector::data; // Would need to assume whole vector changed
+    /**
+     * Returns a typed handle to the underlying storage of the named variable, for bulk access to the variable of every agent
+     * @note Mutable access assumes the variable of every agent has changed, so the whole variable is copied back to device
+     * @see AgentVector::column()
+     */
+    using AgentVector::column;
     /**
      * Forward iterator access to the start of the vector
      */
@@ -133,13 +133,15 @@ class HostAgentAPI {
     * @param _stateName Name of the agent state to be represented
     * @param _agentOffsets Layout of memory within the Host Agent Birth data structure (_newAgentData)
     * @param _newAgentData Structure containing agents birthed via Host Agent Birth
+    * @param _newAgentBatches Structure containing batches of agents birthed via Host Agent Birth
     */
-    HostAgentAPI(HostAPI &_api, detail::AgentInterface &_agent, const std::string &_stateName, const VarOffsetStruct &_agentOffsets, HostAPI::AgentDataBuffer&_newAgentData)
+    HostAgentAPI(HostAPI &_api, detail::AgentInterface &_agent, const std::string &_stateName, const VarOffsetStruct &_agentOffsets, HostAPI::AgentDataBuffer&_newAgentData, NewAgentBatchBuffer &_newAgentBatches)
         : api(_api)
         , agent(_agent)
         , stateName(_stateName)
         , agentOffsets(_agentOffsets)
-        , newAgentData(_newAgentData) { }
+        , newAgentData(_newAgentData)
+        , newAgentBatches(_newAgentBatches) { }
     /**
      * Copy constructor
      * Not actually sure this is required
@@ -150,6 +152,7 @@ class HostAgentAPI {
         , stateName(other.stateName)
         , agentOffsets(other.agentOffsets)
         , newAgentData(other.newAgentData)
+        , newAgentBatches(other.newAgentBatches)
     { }
     /**
      * Creates a new agent in the current agent and returns an object for configuring it's member variables
@@ -158,6 +161,17 @@ class HostAgentAPI {
      * as it batches agent creation to a single scatter kernel if possible (e.g. no data dependencies).
      */
     HostNewAgentAPI newAgent();
+    /**
+     * Creates count new agents in the current agent state and returns an object for configuring their member variables
+     *
+     * Variables are initialised to their default values, and are accessed as columns holding the value for every agent in the batch.
+     * This avoids a per agent allocation and copy, so is significantly faster than repeatedly calling newAgent() when creating many agents.
+     * As with newAgent(), the agents are copied to the device after the host function's layer has completed,
+     * so they are not visible to getPopulationData() or reductions until then.
+     * @param count The number of agents to create
+     * @note The returned object is valid until the end of the current host layer
+     */
+    HostNewAgentBatch newAgents(unsigned int count);
     /*
      * Returns the number of agents in this state
      */
@@ -503,6 +517,11 @@ class HostAgentAPI {
      * @see newAgent()
      */
     HostAPI::AgentDataBuffer& newAgentData;
+    /**
+     * Columnar data store for efficient batched host agent creation
+     * @see newAgents()
+     */
+    NewAgentBatchBuffer& newAgentBatches;
 };
 
 //
@@ -1,8 +1,12 @@
 #ifndef INCLUDE_FLAMEGPU_RUNTIME_AGENT_HOSTNEWAGENTAPI_H_
 #define INCLUDE_FLAMEGPU_RUNTIME_AGENT_HOSTNEWAGENTAPI_H_
 
+#include <algorithm>
+#include <cstring>
 #include <unordered_map>
 #include <string>
+#include <list>
+#include <utility>
 #include <vector>
 
 #include "flamegpu/model/Variable.h"
@@ -349,6 +353,170 @@ struct NewAgentStorage {
     const VarOffsetStruct &offsets;
 };
 
+/**
+ * This struct provides columnar storage for a batch of agents created together by HostAgentAPI::newAgents()
+ * Each variable is stored contiguously for every agent in the batch, the column of a variable begins at offset * count within data
+ * so that the whole batch requires a single allocation, and each column can be copied directly to the device
+ */
+struct NewAgentBatchStorage {
+    /**
+     * Initialises every agent in the batch to the default values, and assigns consecutive IDs
+     * @param v Layout of the agent's variables
+     * @param _count Number of agents in the batch
+     * @param first_id ID of the first agent in the batch
+     * @param buffer Storage to be reused for data, it is resized as required
+     */
+    NewAgentBatchStorage(const VarOffsetStruct &v, const unsigned int _count, const id_t first_id, std::vector<char> &&buffer)
+        : offsets(v)
+        , count(_count)
+        , data(std::move(buffer)) {
+        data.resize(offsets.totalSize * count);
+        if (!count)
+            return;
+        for (const auto &var : offsets.vars) {
+            char *const column = data.data() + var.second.offset * count;
+            // Fill the first element, then double the filled region until the column is complete
+            memcpy(column, offsets.default_data + var.second.offset, var.second.len);
+            for (size_t filled = 1; filled < count; filled *= 2) {
+                memcpy(column + filled * var.second.len, column, std::min<size_t>(filled, count - filled) * var.second.len);
+            }
+        }
+        const auto &var = offsets.vars.find(ID_VARIABLE_NAME);
+        if (var == offsets.vars.end()) {
+            THROW exception::InvalidOperation("Internal agent ID variable was not found, "
+                "in NewAgentBatchStorage.NewAgentBatchStorage().");
+        }
+        id_t *const ids = reinterpret_cast<id_t*>(data.data() + var->second.offset * count);
+        for (unsigned int i = 0; i < count; ++i) {
+            ids[i] = first_id + i;
+        }
+    }
+    /**
+     * Returns the column of the named variable, validating the type and array length
+     * @param var_name Name of the variable
+     * @param method_name Name of the calling method, for exception messages
+     * @tparam T Type of the variable
+     * @tparam N Array length of the variable, 1 if not an array
+     */
+    template<typename T, unsigned int N>
+    T *getColumn(const std::string &var_name, const char *method_name) {
+        const auto &var = offsets.vars.find(var_name);
+        if (var == offsets.vars.end()) {
+            THROW exception::InvalidAgentVar("Variable '%s' not found, "
+                "in %s.",
+                var_name.c_str(), method_name);
+        }
+        const auto t_type = std::type_index(typeid(typename detail::type_decode<T>::type_t));
+        if (var->second.type != t_type) {
+            THROW exception::InvalidVarType("Variable '%s' has type '%s', incorrect  type '%s' was requested, "
+                "in %s.",
+                var_name.c_str(), var->second.type.name(), t_type.name(), method_name);
+        }
+        if (var->second.len != sizeof(T) * N) {
+            THROW exception::InvalidVarArrayLen("Variable '%s' is an array with %u elements, incorrect array of length %u was specified, "
+                "in %s.",
+                var_name.c_str(), static_cast<unsigned int>(var->second.len / sizeof(T)), N, method_name);
+        }
+        return reinterpret_cast<T*>(data.data() + var->second.offset * count);
+    }
+    /**
+     * Layout of the agent's variables
+     */
+    const VarOffsetStruct &offsets;
+    /**
+     * Number of agents in the batch
+     */
+    const unsigned int count;
+    /**
+     * Columnar variable data
+     */
+    std::vector<char> data;
+};
+/**
+ * Holds the batches of agents created within an agent state by HostAgentAPI::newAgents(), until they are copied to the device
+ */
+struct NewAgentBatchBuffer {
+    /**
+     * Batches awaiting copy to the device
+     * A list is used, so that HostNewAgentBatch instances remain valid as further batches are created
+     */
+    std::list<NewAgentBatchStorage> batches;
+    /**
+     * Storage released by batches which have been copied to the device, reused by later batches to avoid reallocation each step
+     */
+    std::vector<std::vector<char>> released;
+};
+/**
+ * This is the API class used by a user for creating many new agents on the host at once
+ *
+ * Variables are accessed as columns, holding the value of the variable for every agent in the batch.
+ * The batch is valid until the end of the host function (or layer) which created it.
+ */
+class HostNewAgentBatch {
+ public:
+    /**
+     * Assigns the batch its storage
+     */
+    explicit HostNewAgentBatch(NewAgentBatchStorage &_s)
+        : s(&_s) { }
+    /**
+     * Returns the number of agents in the batch
+     */
+    unsigned int size() const { return s->count; }
+#ifndef SWIG
+    /**
+     * Returns a writable view of a variable for every agent in the batch
+     * Element j of agent i's array variable is found at index i * N + j
+     * @param var_name Name of the variable
+     * @tparam T Type of the variable
+     * @tparam N Array length of the variable, 1 if not an array
+     * @throws exception::ReservedName If the variable is internal (begins with '_')
+     * @throws exception::InvalidAgentVar If the variable does not exist
+     * @throws exception::InvalidVarType If the variable's type does not match T
+     * @throws exception::InvalidVarArrayLen If the variable's array length does not match N
+     */
+    template<typename T, unsigned int N = 1>
+    T *getVariableData(const std::string &var_name) {
+        if (!var_name.empty() && var_name[0] == '_') {
+            THROW exception::ReservedName("Agent variable names cannot begin with '_', this is reserved for internal usage, "
+                "in HostNewAgentBatch::getVariableData().");
+        }
+        return s->getColumn<T, N>(var_name, "HostNewAgentBatch::getVariableData()");
+    }
+#endif
+    /**
+     * Sets a variable to the same value for every agent in the batch
+     * @param var_name Name of the variable
+     * @param val Value to set
+     * @tparam T Type of the variable
+     */
+    template<typename T>
+    void setVariable(const std::string &var_name, const T val) {
+        if (!var_name.empty() && var_name[0] == '_') {
+            THROW exception::ReservedName("Agent variable names cannot begin with '_', this is reserved for internal usage, "
+                "in HostNewAgentBatch::setVariable().");
+        }
+        T *const column = s->getColumn<T, 1>(var_name, "HostNewAgentBatch::setVariable()");
+        std::fill(column, column + s->count, val);
+    }
+    /**
+     * Returns the unique ID of an agent within the batch
+     * @param index Index of the agent within the batch
+     * @throws exception::OutOfBoundsException If index is not less than size()
+     */
+    id_t getID(const unsigned int index) const {
+        if (index >= s->count) {
+            THROW exception::OutOfBoundsException("Index %u is out of bounds for a batch of %u agents, "
+                "in HostNewAgentBatch::getID().",
+                index, s->count);
+        }
+        return s->getColumn<id_t, 1>(ID_VARIABLE_NAME, "HostNewAgentBatch::getID()")[index];
+    }
+
+ private:
+    NewAgentBatchStorage *s;
+};
+
 /**
  * This is the main API class used by a user for creating new agents on the host
  */
@@ -0,0 +1,66 @@
+#ifndef INCLUDE_FLAMEGPU_RUNTIME_DETAIL_VERTEXINDEXMAP_CUH_
+#define INCLUDE_FLAMEGPU_RUNTIME_DETAIL_VERTEXINDEXMAP_CUH_
+
+#include "flamegpu/defines.h"
+
+namespace flamegpu {
+namespace detail {
+/**
+ * Layout of a directed graph's vertex ID -> index map
+ *
+ * The map is stored as a single buffer of unsigned int, with a hash mask followed by the minimum vertex ID packed at the end.
+ * If the mask is 0, the map is a direct lookup table covering the vertex ID range [offset, offset + map_length).
+ * Otherwise, vertex IDs are sparse and the map is an open addressing hash table of (ID, index) pairs with linear probing,
+ * so its length is proportional to the number of vertices rather than the range of their IDs.
+ */
+struct VertexIndexMap {
+    /**
+     * Number of trailing elements (mask, offset) packed at the end of the map
+     */
+    static constexpr unsigned int HEADER_LENGTH = 2;
+    /**
+     * Returned by find() if the vertex ID is not in the map
+     */
+    static constexpr unsigned int NOT_FOUND = 0xffffffff;
+    /**
+     * Returns the first hash table slot to probe for the vertex ID
+     * @param vertex_id The ID to hash
+     * @param mask The hash mask, (slot count - 1)
+     */
+    __host__ __device__ __forceinline__ static unsigned int hash(const id_t vertex_id, const unsigned int mask) {
+        const unsigned int h = vertex_id * 2654435761u;  // Knuth's multiplicative hash
+        return (h ^ (h >> 16)) & mask;
+    }
+    /**
+     * Returns the index of the vertex with the provided ID, or NOT_FOUND
+     * @param read Functor which returns the element of the map at the provided index
+     * @param map_length Length of the map, excluding the header
+     * @param mask The hash mask, 0 if the map is a direct lookup table
+     * @param offset The minimum vertex ID
+     * @param vertex_id The ID to lookup
+     */
+    template<typename Read>
+    __device__ __forceinline__ static unsigned int find(const Read &read, const unsigned int map_length, const unsigned int mask, const unsigned int offset, const id_t vertex_id) {
+        if (!mask) {
+            if (vertex_id < offset || vertex_id - offset >= map_length)
+                return NOT_FOUND;
+            return read(vertex_id - offset);
+        }
+        if (vertex_id == ID_NOT_SET)
+            return NOT_FOUND;
+        unsigned int slot = hash(vertex_id, mask);
+        for (unsigned int i = 0; i <= mask; ++i) {
+            const id_t key = read(slot * 2);
+            if (key == vertex_id)
+                return read(slot * 2 + 1);
+            if (key == ID_NOT_SET)
+                return NOT_FOUND;
+            slot = (slot + 1) & mask;
+        }
+        return NOT_FOUND;
+    }
+};
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_RUNTIME_DETAIL_VERTEXINDEXMAP_CUH_
@@ -6,6 +6,7 @@
 #include <cstring>
 #include <string>
 #include <cstdio>
+#include <sstream>
 #include <typeindex>
 #include <map>
 #include <vector>
@@ -388,9 +389,26 @@ class CurveRTCHost {
      */
     void initHeaderEnvironment(size_t env_buffer_len);
     /**
-     * Sub-method for setting up the variable/property set methods
+     * Sub-method for generating the compile time lookups, which map each agent/message variable and environment property name
+     * to its type size, length and offset within the dynamic curve buffer
+     * These back the get/set methods, so their cost is independent of the number of variables
      */
-    void initHeaderSetters();
+    void initHeaderLookups();
+    /**
+     * Writes the lookup function for a namespace of variables, to the provided stream
+     * @param out Stream to write the function to
+     * @param function_name Name of the generated function
+     * @param variables The variables of the namespace
+     * @param data_offset Offset of the namespace's variable pointers within the dynamic curve buffer
+     */
+    static void writeVariableLookup(std::stringstream &out, const char *function_name, const std::map<std::string, RTCVariableProperties> &variables, size_t data_offset);
+    /**
+     * Writes a lookup function, which selects a bucket of name comparisons according to the length of the name
+     * @param out Stream to write the function to
+     * @param function_name Name of the generated function
+     * @param buckets Map of name length to the name comparisons for names of that length
+     */
+    static void writeLookupFunction(std::stringstream &out, const char *function_name, const std::map<size_t, std::stringstream> &buckets);
     /**
      * Sub-method for setting up the variable/property get methods
      */
@@ -3,6 +3,7 @@
 
 #include "flamegpu/defines.h"
 #include "flamegpu/runtime/detail/curve/Curve.cuh"
+#include "flamegpu/runtime/detail/VertexIndexMap.cuh"
 
 namespace flamegpu {
 /**
@@ -537,22 +538,21 @@ __device__ __forceinline__ id_t DeviceEnvironmentDirectedGraph::getVertexID(cons
 }
 
 __device__ __forceinline__ unsigned int DeviceEnvironmentDirectedGraph::getVertexIndex(id_t vertex_id) const {
-    const unsigned int VERTEX_RANGE = detail::curve::DeviceCurve::getVariableCount("_index_map", graph_hash ^ detail::curve::Curve::variableHash("_environment_directed_graph_vertex")) - 1;  // -1 because offset is packed at the end
-    const unsigned int VERTEX_OFFSET = detail::curve::DeviceCurve::getEnvironmentDirectedGraphVertexProperty<unsigned int>(graph_hash, "_index_map", VERTEX_RANGE);
+    const unsigned int MAP_LENGTH = detail::curve::DeviceCurve::getVariableCount("_index_map", graph_hash ^ detail::curve::Curve::variableHash("_environment_directed_graph_vertex")) - detail::VertexIndexMap::HEADER_LENGTH;
+    const unsigned int MAP_MASK = detail::curve::DeviceCurve::getEnvironmentDirectedGraphVertexProperty<unsigned int>(graph_hash, "_index_map", MAP_LENGTH);
+    const unsigned int VERTEX_OFFSET = detail::curve::DeviceCurve::getEnvironmentDirectedGraphVertexProperty<unsigned int>(graph_hash, "_index_map", MAP_LENGTH + 1);
+    const unsigned int index = detail::VertexIndexMap::find([this](const unsigned int i) { return getVertexProperty<unsigned int>("_index_map", i); }, MAP_LENGTH, MAP_MASK, VERTEX_OFFSET, vertex_id);
 #if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
-    if (vertex_id < VERTEX_OFFSET ||  vertex_id - VERTEX_OFFSET >= VERTEX_RANGE) {
-        DTHROW("Vertex ID (%u) exceeds vertex range bounds (%u <= ID <= %u), unable to get vertex index.\n", vertex_id, VERTEX_OFFSET, VERTEX_OFFSET + VERTEX_RANGE - 1);
-        return {};
-    }
-    const unsigned int index = getVertexProperty<unsigned int>("_index_map", vertex_id - VERTEX_OFFSET);
-    if (index == 0xffffffff) {
-        DTHROW("Vertex ID %u is not in use, unable to get vertex index.\n", vertex_id);
+    if (index == detail::VertexIndexMap::NOT_FOUND) {
+        if (!MAP_MASK && (vertex_id < VERTEX_OFFSET || vertex_id - VERTEX_OFFSET >= MAP_LENGTH)) {
+            DTHROW("Vertex ID (%u) exceeds vertex range bounds (%u <= ID <= %u), unable to get vertex index.\n", vertex_id, VERTEX_OFFSET, VERTEX_OFFSET + MAP_LENGTH - 1);
+        } else {
+            DTHROW("Vertex ID %u is not in use, unable to get vertex index.\n", vertex_id);
+        }
         return {};
     }
-    return index;
-#else
-    return getVertexProperty<unsigned int>("_index_map", vertex_id - VERTEX_OFFSET);
 #endif
+    return index;
 }
 template<typename T, unsigned int M>
 __device__ __forceinline__ T DeviceEnvironmentDirectedGraph::getVertexProperty(const char(&property_name)[M], const unsigned int vertex_index) const {
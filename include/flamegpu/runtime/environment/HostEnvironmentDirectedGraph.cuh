@@ -36,6 +36,7 @@ class HostEnvironmentDirectedGraph {
      * Attempts to import edge and vertex data from the specified file
      *
      * This file must be in the appropriate format as documented in the FLAMEGPU documentation
+     * Files with the extension .json are read as JSON "adjacency like" graphs, files with the extension .bin are read as binary CSR graphs
      *
      * @param in_file Path to the file on disk containing the graph
      *
@@ -51,6 +52,8 @@ class HostEnvironmentDirectedGraph {
      *
      * @param out_file Path to the file on disk containing to store the graph
      *
+     * The extension .json exports a JSON "adjacency like" graph, the extension .bin exports a binary CSR graph which is considerably faster to save and load
+     *
      * @throws exception::InvalidFilePath If the file cannot be opened for writing
      * @throws exception::UnsupportedFileType If the specified file type does not correspond to a known format
      * @throws exception::RapidJSONError If conversion to JSON fails for any reason
@@ -74,7 +77,8 @@ class HostEnvironmentDirectedGraph {
     /**
      * Set the number of edges present in the graph
      * This causes the internal data structure to be (re)allocated, and existing edge data is not retained.
-     * Calling this regularly may harm performance
+     * Calling this regularly may harm performance, as the graph must then be fully rebuilt.
+     * Whereas changing the source/destination of a small fraction of existing edges only updates the graph incrementally.
      *
      * @param count The number of edges
      */
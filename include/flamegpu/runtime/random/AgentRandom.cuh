@@ -1,9 +1,13 @@
 #ifndef INCLUDE_FLAMEGPU_RUNTIME_RANDOM_AGENTRANDOM_CUH_
 #define INCLUDE_FLAMEGPU_RUNTIME_RANDOM_AGENTRANDOM_CUH_
 
-#include <limits>
-
-#include "flamegpu/detail/curand.cuh"
+#include "flamegpu/defines.h"
+#include "flamegpu/detail/philox.cuh"
+#ifndef __CUDACC_RTC__
+#include "flamegpu/runtime/detail/curve/DeviceCurve.cuh"
+#else
+#include "dynamic/curve_rtc_dynamic.h"
+#endif  // !_RTC
 #include "flamegpu/detail/StaticAssert.h"
 #include "flamegpu/exception/FLAMEGPUDeviceException.cuh"
 
@@ -12,16 +16,18 @@ namespace flamegpu {
 /**
  * Utility for accessing random generation within agent functions
  * This should only be instantiated by FLAMEGPU_API
- * Wraps curand functions to access an internal curand state * 
+ * Wraps a counter-based generator keyed on the agent function launch and the agent's ID,
+ * so an agent's random numbers do not depend on its position within the population
+ * The agent's ID is only loaded from global memory when the first random number is drawn, so agent functions which do not use random pay nothing
+ * @see detail::Philox
  */
 class AgentRandom {
  public:
     /**
      * Constructs an AgentRandom instance
-     * @param d_rng ThreadSafe device curand state instance
-     *   this is a unique instance for the thread among all concurrently executing kernels
+     * @param key Key identifying the seed, step and agent function being executed
      */
-    __forceinline__ __device__ AgentRandom(detail::curandState *d_rng);
+    __forceinline__ __device__ explicit AgentRandom(const detail::PhiloxKey &key);
     /**
      * Returns a float uniformly distributed between 0.0 and 1.0. 
      * @note It may return from 0.0 to 1.0, where 0.0 is included and 1.0 is excluded.
@@ -45,7 +51,7 @@ class AgentRandom {
     /**
      * Returns a poisson distributed unsigned int according to the provided mean (default 1.0).
      * @param mean The mean of the distribution
-     * @note This implementation uses CURAND's "simple Device API" which is considered the least robust but is more efficient when generating Poisson-distributed random numbers for many different lambdas.
+     * @note Means below 10 use Knuth's multiplication method, larger means use transformed rejection
      */
     __forceinline__ __device__ unsigned int poisson(double mean = 1.0f) const;
     /**
@@ -60,12 +66,31 @@ class AgentRandom {
 
  private:
     /**
-     * Thread-safe index for accessing curand
+     * Returns the generator, first setting its subject to the executing agent's ID if no numbers have yet been drawn
+     */
+    __forceinline__ __device__ detail::Philox &getGenerator() const;
+    /**
+     * The generator holds only the draw counter, so numbers are drawn from a const instance
      */
-    detail::curandState *d_random_state;
+    mutable detail::Philox generator;
+    /**
+     * True once the generator's subject has been set to the agent's ID
+     */
+    mutable bool has_subject;
 };
 
-__forceinline__ __device__ AgentRandom::AgentRandom(detail::curandState *d_rng) : d_random_state(d_rng) { }
+__forceinline__ __device__ AgentRandom::AgentRandom(const detail::PhiloxKey &key)
+    : generator(key, 0)
+    , has_subject(false) { }
+__forceinline__ __device__ detail::Philox &AgentRandom::getGenerator() const {
+    if (!has_subject) {
+        // Agents are mapped linearly to threads, as with DeviceAPI::getVariable()
+        const unsigned int index = (blockDim.x * blockIdx.x) + threadIdx.x;
+        generator.setSubject(detail::curve::DeviceCurve::getAgentVariable<id_t>("_id", index));  // Can't use ID_VARIABLE_NAME inline, as it isn't of char[N] type
+        has_subject = true;
+    }
+    return generator;
+}
 /**
  * All templates are specialised
  */
@@ -75,23 +100,11 @@ __forceinline__ __device__ AgentRandom::AgentRandom(detail::curandState *d_rng)
  */
 template<>
 __forceinline__ __device__ float AgentRandom::uniform() const {
-    // curand naturally generates the range (0, 1], we want [0, 1)
-    // https://github.com/pytorch/pytorch/blob/059aa34b124916dfd761f3cbdb5fa97d7a01fc93/aten/src/ATen/native/cuda/Distributions.cu#L71-L77
-    uint32_t val = curand(d_random_state);  // need just bits
-    constexpr auto MASK = static_cast<uint32_t>((static_cast<uint64_t>(1) << std::numeric_limits<float>::digits) - 1);
-    constexpr auto DIVISOR = static_cast<float>(1) / (static_cast<uint32_t>(1) << std::numeric_limits<float>::digits);
-    return (val & MASK) * DIVISOR;
+    return getGenerator().uniformFloat();
 }
 template<>
 __forceinline__ __device__ double AgentRandom::uniform() const {
-    // curand naturally generates the range (0, 1], we want [0, 1)
-    // Conversion of High-Period Random Numbers to Floating Point - Jurgen A Doornik
-    // Based on: https://www.doornik.com/research/randomdouble.pdf
-    const uint32_t iRan1 = curand(d_random_state);
-    const uint32_t iRan2 = curand(d_random_state);
-    constexpr double M_RAN_INVM32 = 2.32830643653869628906e-010;
-    constexpr double M_RAN_INVM52 = 2.22044604925031308085e-016;
-    return (static_cast<int>(iRan1)*M_RAN_INVM32 + (0.5 + M_RAN_INVM52 / 2) + static_cast<int>((iRan2) & 0x000FFFFF) * M_RAN_INVM52);
+    return getGenerator().uniformDouble();
 }
 
 /**
@@ -99,28 +112,28 @@ __forceinline__ __device__ double AgentRandom::uniform() const {
  */
 template<>
 __forceinline__ __device__ float AgentRandom::normal() const {
-    return curand_normal(d_random_state);
+    return getGenerator().normalFloat();
 }
 template<>
 __forceinline__ __device__ double AgentRandom::normal() const {
-    return curand_normal_double(d_random_state);
+    return getGenerator().normalDouble();
 }
 /**
  * Log Normal floating point
  */
 template<>
 __forceinline__ __device__ float AgentRandom::logNormal(const float mean, const float stddev) const {
-    return curand_log_normal(d_random_state, mean, stddev);
+    return expf(mean + stddev * getGenerator().normalFloat());
 }
 template<>
 __forceinline__ __device__ double AgentRandom::logNormal(const double mean, const double stddev) const {
-    return curand_log_normal_double(d_random_state, mean, stddev);
+    return exp(mean + stddev * getGenerator().normalDouble());
 }
 /**
  * Poisson
  */
 __forceinline__ __device__ unsigned int AgentRandom::poisson(const double mean) const {
-    return curand_poisson(d_random_state, mean);
+    return getGenerator().poisson(mean);
 }
 /**
 * Uniform Range
@@ -18,6 +18,7 @@ class AgentInstance;
 class AgentDescription;
 class AgentVector_CAgent;
 class AgentVector_Agent;
+class CPUSimulation;
 struct AgentData;
 
 /**
@@ -36,6 +37,7 @@ class AgentVector {
      * Can't include CUDAAgentStateList to friend the specific method.
      */
     friend class detail::CUDAAgentStateList;
+    friend class CPUSimulation;
     friend class AgentVector_CAgent;
     friend class AgentVector_Agent;
 
@@ -49,6 +51,74 @@ class AgentVector {
      */
     typedef AgentVector_CAgent CAgent;
     typedef std::map<std::string, std::unique_ptr<detail::GenericMemoryVector>> AgentDataMap;
+    /**
+     * Typed handle to the contiguous storage of a single variable, across all agents within the vector
+     * The variable's name and type are validated once, when the handle is created by AgentVector::column(),
+     * so subsequent element access is plain array indexing without any per access lookups.
+     * @tparam T Type of the variable (or type of its elements, if it is an array variable), const qualified for read-only access
+     * @note The handle is invalidated by any operation which may reallocate or move agents, e.g. push_back(), insert(), erase(), resize(), reserve()
+     */
+    template<typename T>
+    class Column {
+        friend class AgentVector;
+        Column(T *_ptr, size_type _size, unsigned int _elements)
+            : ptr(_ptr), length(_size), elements_per_agent(_elements) { }
+
+     public:
+        typedef T value_type;
+        typedef T *iterator;
+        /**
+         * Returns the number of agents spanned by the column
+         */
+        size_type size() const { return length; }
+        /**
+         * Returns the number of elements stored per agent, this is 1 unless the variable is an array variable
+         */
+        unsigned int elements() const { return elements_per_agent; }
+        /**
+         * Returns true if the column spans no agents
+         */
+        bool empty() const { return length == 0; }
+        /**
+         * Returns a pointer to the first element of the column, or nullptr if the vector has not yet allocated buffers
+         * Agent i's elements are stored at data()[i * elements()] to data()[(i + 1) * elements() - 1]
+         */
+        T *data() const { return ptr; }
+        /**
+         * Iterators over the flat (size() x elements()) storage of the column
+         */
+        iterator begin() const { return ptr; }
+        iterator end() const { return ptr + static_cast<size_t>(length) * elements_per_agent; }
+        /**
+         * Access the element at the specified index of the flat storage, without bounds checking
+         * @param index Flat index (agent_index * elements() + element)
+         */
+        T &operator[](size_t index) const { return ptr[index]; }
+        /**
+         * Access the specified element of the specified agent's variable
+         * @param agent_index Index of the agent within the vector
+         * @param element Index of the element within the variable, this must be 0 unless the variable is an array variable
+         * @throws exception::OutOfBoundsException If agent_index or element are out of bounds
+         */
+        T &at(size_type agent_index, unsigned int element = 0) const {
+            if (agent_index >= length) {
+                THROW exception::OutOfBoundsException("Index %u is out of bounds for column of length %u, "
+                    "in AgentVector::Column::at().",
+                    agent_index, length);
+            }
+            if (element >= elements_per_agent) {
+                THROW exception::OutOfBoundsException("Element %u is out of bounds for variable with %u elements, "
+                    "in AgentVector::Column::at().",
+                    element, elements_per_agent);
+            }
+            return ptr[static_cast<size_t>(agent_index) * elements_per_agent + element];
+        }
+
+     private:
+        T *ptr;
+        size_type length;
+        unsigned int elements_per_agent;
+    };
 
     // They might all be wrong
     class const_iterator;
@@ -273,6 +343,21 @@ class AgentVector {
     const T* data(const std::string &variable_name) const;
     void* data(const std::string& variable_name);
     const void* data(const std::string& variable_name) const;
+    /**
+     * Returns a typed handle to the underlying storage of the named variable, for bulk access to the variable of every agent
+     * Unlike accessing agents via operator[], the variable is only located and type checked once, when the handle is created.
+     * @param variable_name Name of the variable
+     * @tparam T Type of the variable, or type of the variable's elements if it is an array variable
+     * @throws exception::ReservedName variable_name begins with '_' (mutable access only)
+     * @throws exception::InvalidAgentVar Agent does not contain variable variable_name
+     * @throws exception::InvalidVarType Agent variable variable_name is not of type T
+     * @note Creating a mutable column marks the whole variable as changed once, rather than notifying per element written
+     * @note The handle is invalidated by any operation which may reallocate or move agents (e.g. push_back(), insert(), erase(), resize())
+     */
+    template<typename T>
+    Column<T> column(const std::string &variable_name);
+    template<typename T>
+    Column<const T> column(const std::string &variable_name) const;
 
     // Iterators
     /**
@@ -682,6 +767,17 @@ const T* AgentVector::data(const std::string& variable_name) const {
     }
     return nullptr;
 }
+template<typename T>
+AgentVector::Column<T> AgentVector::column(const std::string &variable_name) {
+    // data() validates the variable, syncs it and marks it changed
+    T *ptr = data<T>(variable_name);
+    return Column<T>(ptr, ptr ? _size : 0, agent->variables.at(variable_name).elements);
+}
+template<typename T>
+AgentVector::Column<const T> AgentVector::column(const std::string &variable_name) const {
+    const T *ptr = data<T>(variable_name);
+    return Column<const T>(ptr, ptr ? _size : 0, agent->variables.at(variable_name).elements);
+}
 
 template<class InputIt>
 AgentVector::iterator AgentVector::insert(const_iterator pos, InputIt first, InputIt last) {
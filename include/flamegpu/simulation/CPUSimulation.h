@@ -0,0 +1,271 @@
+#ifndef INCLUDE_FLAMEGPU_SIMULATION_CPUSIMULATION_H_
+#define INCLUDE_FLAMEGPU_SIMULATION_CPUSIMULATION_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flamegpu/simulation/Simulation.h"
+#include "flamegpu/runtime/AgentFunction.cuh"
+#include "flamegpu/runtime/CPUAgentAPI.h"
+#include "flamegpu/simulation/detail/HostSoABuffer.h"
+#include "flamegpu/util/StringPair.h"
+
+namespace flamegpu {
+namespace detail {
+class DataflowGraph;
+class ThreadPool;
+}  // namespace detail
+struct AgentFunctionData;
+
+/**
+ * Host runner for Simulation interface
+ * Executes a FLAMEGPU2 model using the CPU, distributing the agents of each agent function across a pool of worker threads
+ *
+ * Device agent functions cannot be executed on the host, so a host implementation of each agent function (and agent function condition)
+ * must be registered with setAgentFunction() (and setAgentFunctionCondition()), these receive a CPUAgentAPI in place of the DeviceAPI.
+ * Layers are executed in order, with every agent of an agent function being executed before the next agent function begins.
+ * Agent death, message output and agent output are resolved after each agent function in agent order, so results are independent of the thread count.
+ *
+ * Alternatively, if Config::dataflow is enabled, agent functions are scheduled directly from the model's dependency graph rather than by layer.
+ * Each agent function begins as soon as the agent functions it depends upon (and any earlier agent functions which access the same agent states or message lists) have completed,
+ * so independent chains of agent functions execute concurrently. Results match those of layered execution.
+ *
+ * Scope: this backend is intended for developing and testing model logic on machines without a GPU, it does not execute arbitrary models.
+ * - Device agent functions (FLAMEGPU_AGENT_FUNCTION) are only used to describe the model, their bodies are never executed.
+ *   Every agent function (and condition) requires a host implementation, registered with setAgentFunction() (and setAgentFunctionCondition()).
+ * - Only models composed of agent functions using brute force messaging are supported,
+ *   models containing host functions, exit conditions, submodels or other message types are rejected at construction.
+ * - Logging is not supported, getRunLog() only records the random seed.
+ * - Agent and message lists are held as detail::HostSoABuffer rather than AgentVector, as execution requires flag based compaction and
+ *   ordered appends of whole lists, which AgentVector does not provide. Populations are copied in and out via AgentVector as with CUDASimulation.
+ * - No CUDA device (or driver) is required at runtime and this class is compiled as host code,
+ *   however it is part of the FLAMEGPU library, so building it still requires the CUDA toolkit.
+ */
+class CPUSimulation : public Simulation {
+ public:
+    /**
+     * Host implementation of an agent function
+     * @return The agent's status, DEAD is only permitted if the agent function has agent death enabled
+     */
+    typedef std::function<AGENT_STATUS(CPUAgentAPI&)> AgentFunction;
+    /**
+     * Host implementation of an agent function condition
+     * @return True if the agent should execute the agent function
+     */
+    typedef std::function<bool(CPUAgentAPI&)> AgentFunctionCondition;
+    /**
+     * CPU runner specific config
+     */
+    struct Config {
+        /**
+         * Number of worker threads used to execute agent functions
+         * Defaults to 0, which uses std::thread::hardware_concurrency()
+         */
+        unsigned int thread_count = 0;
+        /**
+         * If true, agent functions are executed as soon as their dependencies have completed, rather than layer by layer
+         * This requires the model's layers to have been generated from its dependency graph, via ModelDescription::generateLayers()
+         * Defaults to false
+         */
+        bool dataflow = false;
+    };
+    /**
+     * Initialise cpu runner
+     * If provided, you can pass runtime arguments to this constructor, to automatically call inititialise()
+     * This is not required, you can call initialise() manually later, or not at all.
+     * @param model The model description to initialise the runner to execute
+     * @param argc Runtime argument count
+     * @param argv Runtime argument list ptr
+     * @throws exception::InvalidOperation If the model contains features not supported by the host backend
+     */
+    explicit CPUSimulation(const ModelDescription& model, int argc = 0, const char** argv = nullptr);
+    ~CPUSimulation() override;
+    /**
+     * Registers the host implementation of an agent function
+     * @param agent_name Name of the agent which owns the agent function
+     * @param function_name Name of the agent function
+     * @param func Host implementation of the agent function
+     * @throws exception::InvalidAgentFunc If the named agent function does not exist within the model
+     */
+    void setAgentFunction(const std::string &agent_name, const std::string &function_name, AgentFunction func);
+    /**
+     * Registers the host implementation of an agent function's condition
+     * @param agent_name Name of the agent which owns the agent function
+     * @param function_name Name of the agent function
+     * @param condition Host implementation of the agent function condition
+     * @throws exception::InvalidAgentFunc If the named agent function does not exist within the model, or does not have a condition
+     */
+    void setAgentFunctionCondition(const std::string &agent_name, const std::string &function_name, AgentFunctionCondition condition);
+    /**
+     * Host functions are not supported by CPUSimulation, so this method does nothing
+     */
+    void initFunctions() override { }
+    /**
+     * Steps the simulation once
+     * @return Always true, as exit conditions are not supported by the host backend
+     * @throws exception::InvalidAgentFunc If an agent function (or condition) does not have a host implementation registered
+     * @throws exception::InvalidOperation If dataflow execution is enabled, but the model's layers were not generated from a dependency graph
+     */
+    bool step() override;
+    /**
+     * Host functions are not supported by CPUSimulation, so this method does nothing
+     */
+    void exitFunctions() override { }
+    /**
+     * Execute the simulation until config.steps have been executed
+     * @throws exception::InvalidArgument If config.steps is 0, as the host backend does not support exit conditions
+     */
+    void simulate() override;
+    /**
+     * Replaces the named agent state's population with the one provided
+     * Agents without an ID are assigned one
+     * @param population The agent population to copy into the simulation
+     * @param state_name The name of the agent state to be replaced
+     * @throws exception::InvalidAgent If the population's agent is not part of the model
+     * @throws exception::InvalidCudaAgentDesc If the population's agent description does not match the model's
+     * @throws exception::InvalidAgentState If the state does not exist
+     * @throws exception::AgentIDCollision If the population contains an ID already in use by the agent
+     */
+    void setPopulationData(AgentVector& population, const std::string &state_name = ModelData::DEFAULT_STATE) override;
+    /**
+     * Copies the named agent state's population into the provided AgentVector
+     * @param population The AgentVector to receive the population
+     * @param state_name The name of the agent state to be copied
+     * @throws exception::InvalidAgent If the population's agent is not part of the model
+     * @throws exception::InvalidCudaAgentDesc If the population's agent description does not match the model's
+     * @throws exception::InvalidAgentState If the state does not exist
+     */
+    void getPopulationData(AgentVector& population, const std::string& state_name = ModelData::DEFAULT_STATE) override;
+    /**
+     * Returns the number of steps executed
+     */
+    unsigned int getStepCounter() override;
+    /**
+     * Manually resets the step counter
+     */
+    void resetStepCounter() override;
+    /**
+     * Returns the CPU runner specific config
+     * Changes to thread_count take effect from the next step
+     */
+    Config &CPUConfig();
+    const Config &getCPUConfig() const;
+    /**
+     * Returns the run log, the host backend does not yet support logging so this only records the random seed
+     */
+    const RunLog &getRunLog() override;
+    /**
+     * Get the duration of the last call to simulate() in seconds
+     */
+    double getElapsedTimeSimulation() const;
+    /**
+     * Get the duration of each step, since the last call to simulate() or reset()
+     */
+    std::vector<double> getElapsedTimeSteps() const;
+
+ protected:
+    /**
+     * Resets the step counter, environment properties and culls all agent and message populations
+     * @param submodelReset Unused, the host backend does not support submodels
+     */
+    void reset(bool submodelReset) override;
+    /**
+     * Apply any environment properties loaded from an input file
+     */
+    void applyConfig_derived() override;
+    /**
+     * Parses the host backend's runtime arguments
+     */
+    bool checkArgs_derived(int argc, const char** argv, int &i) override;
+    /**
+     * Prints the host backend's runtime arguments
+     */
+    void printHelp_derived() override;
+    /**
+     * Returns the simulation's environment manager
+     */
+    std::shared_ptr<detail::EnvironmentManager> getEnvironment() const override;
+    /**
+     * Macro properties are not supported by the host backend, this always returns nullptr
+     */
+    std::shared_ptr<const detail::CUDAMacroEnvironment> getMacroEnvironment() const override;
+
+ private:
+    /**
+     * Validates that the model only contains features supported by the host backend
+     * @throws exception::InvalidOperation If the model contains host functions, exit conditions or submodels
+     * @throws exception::InvalidMessageType If the model contains messages other than brute force messages
+     */
+    void validateModel() const;
+    /**
+     * Executes each agent function once its dependencies have completed, using the thread pool
+     * @throws exception::InvalidOperation If the model's layers were not generated from a dependency graph
+     */
+    void stepDataflow();
+    /**
+     * Executes a single agent function over all agents in its initial state
+     * @param func The agent function to execute
+     * @param function_index Index of the agent function within the step, used to decorrelate random streams
+     */
+    void executeAgentFunction(const AgentFunctionData &func, unsigned int function_index);
+    /**
+     * Assigns an ID to any agents of the named agent which do not yet have one
+     * @param agent_name Name of the agent
+     * @param buffer Agent state list to assign IDs within
+     */
+    void assignAgentIDs(const std::string &agent_name, detail::HostSoABuffer &buffer);
+    /**
+     * Execute body over the range [0, count), using the number of threads specified by the CPU config
+     * The thread pool is (re)created if required
+     * @param count Number of indices to execute
+     * @param body Callable of the form void(size_t chunk_begin, size_t chunk_end)
+     */
+    void parallelFor(unsigned int count, const std::function<void(size_t, size_t)> &body);
+    /**
+     * Returns the number of threads specified by the CPU config, (re)creating the thread pool if required
+     * The thread pool is released if only a single thread is required
+     */
+    unsigned int updateThreadPool();
+    /**
+     * Number of steps executed
+     */
+    unsigned int step_count;
+    Config cpu_config;
+    std::shared_ptr<detail::EnvironmentManager> environment;
+    /**
+     * Storage for each agent state list
+     */
+    util::StringPairUnorderedMap<std::unique_ptr<detail::HostSoABuffer>> agent_states;
+    /**
+     * Storage for each message list
+     */
+    std::unordered_map<std::string, std::unique_ptr<detail::HostSoABuffer>> message_lists;
+    /**
+     * Message lists which will be replaced, rather than appended to, by their next output
+     */
+    std::unordered_map<std::string, bool> message_truncate;
+    /**
+     * The next ID to be assigned to a new agent of each type
+     */
+    std::unordered_map<std::string, id_t> next_agent_id;
+    /**
+     * Host implementations of agent functions and agent function conditions
+     */
+    util::StringPairUnorderedMap<AgentFunction> agent_functions;
+    util::StringPairUnorderedMap<AgentFunctionCondition> agent_function_conditions;
+    std::unique_ptr<detail::ThreadPool> thread_pool;
+    /**
+     * Graph of the model's agent functions, built on first use by stepDataflow()
+     */
+    std::unique_ptr<detail::DataflowGraph> dataflow_graph;
+    std::unique_ptr<RunLog> run_log;
+    double elapsedSecondsSimulation;
+    std::vector<double> elapsedSecondsPerStep;
+};
+
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_SIMULATION_CPUSIMULATION_H_
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_FLAMEGPU_SIMULATION_CUDAENSEMBLE_H_
 #define INCLUDE_FLAMEGPU_SIMULATION_CUDAENSEMBLE_H_
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <memory>
@@ -34,7 +35,7 @@ class CUDAEnsemble {
         std::string out_directory = "";
         /**
          * Output format
-         * This must be a supported format e.g.: "json" or "xml"
+         * This must be a supported format e.g.: "json", "xml" or "bin" (binary columnar, see io::BinaryLogger)
          * Defaults to "json"
          */
         std::string out_format = "json";
@@ -78,6 +79,52 @@ class CUDAEnsemble {
          * If false, an exception will be raised when a log file already exists
          */
         bool truncate_log_files = false;
+        /**
+         * If true, each run's logs are released from memory once they have been exported to out_directory
+         * This bounds the memory used by large ensembles, however exported logs will not be returned by getLogs()
+         * Has no effect if out_directory is not set, as logs are not exported
+         * Defaults to false
+         */
+        bool evict_exported_logs = false;
+        /**
+         * The maximum number of completed runs which may be awaiting export to out_directory
+         * When reached, runners wait for the logger to catch up before beginning their next run
+         * Has no effect if out_directory is not set. 0 denotes no limit.
+         * Defaults to 0
+         */
+        unsigned int max_log_export_backlog = 0;
+        /**
+         * The number of threads used to export logs to out_directory
+         * Logs of different runs are exported concurrently, which prevents the logger becoming a bottleneck for many short runs
+         * Defaults to 1
+         */
+        unsigned int log_export_threads = 1;
+        enum Scheduling { Sequential = 0, LongestFirst = 1 };
+        /**
+         * Sequential: Runs are started in the order they appear within the RunPlanVector.
+         * LongestFirst: Runs are started in order of decreasing estimated cost (RunPlan::getCost(), or RunPlan::getSteps() if a cost has not been set),
+         * so that long runs are not left to execute alone whilst other runners sit idle at the end of the ensemble. Runs with 0 steps
+         * and no cost (which only exit via an exit condition) are assumed to be the longest. Runs of equal cost retain their relative order.
+         * In both cases, idle runners claim the next run from a shared queue, and logs are indexed by each run's RunPlanVector index.
+         * @note Runs are always started in sequential order by MPI ensembles
+         * Defaults to Sequential
+         */
+        Scheduling scheduling = Sequential;
+        /**
+         * If true, each runner creates a single CUDASimulation which is reset between runs, rather than creating a new instance per run.
+         * This avoids repeating simulation initialisation (e.g. device allocations and RTC compilation) for every run, which may dominate ensembles of many short runs.
+         * Between runs, agents and messages are cleared, environment properties are returned to their default values with the RunPlan's overrides applied,
+         * macro environment properties are zeroed and random is reseeded.
+         * @note Directed graphs are not cleared between runs, models should (re)build them within an init function
+         * Defaults to true
+         */
+        bool reuse_simulations = true;
+        /**
+         * Path of a RTC kernel bundle to preload before any runs begin, so that runners (and MPI ranks) need not compile the model's RTC agent functions
+         * Defaults to "" (no bundle)
+         * @see CUDASimulation::exportRTCBundle()
+         */
+        std::string rtc_bundle = "";
         /**
          * Prevents the computer from entering standby whilst the ensemble is running
          * @note This feature is currently only supported by Windows builds.
@@ -96,9 +143,73 @@ class CUDAEnsemble {
 #else
         const bool mpi = false;
 #endif
+        /**
+         * The maximum number of runs assigned to an MPI rank (other than rank 0) per request
+         * Ranks request their next chunk of runs whilst executing the current chunk, hiding the latency of communicating with rank 0.
+         * Chunks shrink towards a single run as the remaining runs are depleted, so that all ranks finish close together.
+         * Has no effect unless mpi is enabled. 0 denotes the rank's number of runners (devices x concurrent_runs).
+         * Defaults to 0
+         */
+        unsigned int mpi_chunk_size = 0;
 
         bool telemetry = false;
     };
+    /**
+     * Summary of the logs exported to disk by simulate(), for sizing EnsembleConfig::log_export_threads
+     */
+    struct LogExportMetrics {
+        /**
+         * Number of threads used to export logs
+         */
+        unsigned int export_threads = 0;
+        /**
+         * Number of runs which have had their logs exported
+         */
+        unsigned int exported_logs = 0;
+        /**
+         * Total number of runs awaiting export, sampled each time a run's logs began exporting
+         * Divide by exported_logs to obtain the mean queue depth
+         */
+        uint64_t total_queue_depth = 0;
+        /**
+         * Maximum number of runs awaiting export, sampled each time a run's logs began exporting
+         */
+        unsigned int max_queue_depth = 0;
+        /**
+         * Total time spent exporting logs (summed across all threads) in seconds
+         * Divide by exported_logs to obtain the mean export latency
+         */
+        double total_export_time = 0;
+        /**
+         * Longest time taken to export a single run's logs in seconds
+         */
+        double max_export_time = 0;
+    };
+    /**
+     * Summary of the work performed by a single runner (a thread executing runs on a device) during simulate()
+     */
+    struct RunnerMetrics {
+        /**
+         * The CUDA device the runner executed runs on
+         */
+        int device_id = 0;
+        /**
+         * Index of the runner on it's device
+         */
+        unsigned int runner_id = 0;
+        /**
+         * Number of runs executed by the runner, including those which failed
+         */
+        unsigned int runs = 0;
+        /**
+         * Total time the runner spent executing runs in seconds
+         */
+        double busy_time = 0;
+        /**
+         * Proportion of the ensemble's elapsed time which the runner spent executing runs, in the range [0, 1]
+         */
+        double utilisation = 0;
+    };
     /**
      * Initialise CUDA Ensemble
      * If provided, you can pass runtime arguments to this constructor, to automatically call initialise()
@@ -159,8 +270,22 @@ class CUDAEnsemble {
     double getEnsembleElapsedTime() const { return ensemble_elapsed_time; }
     /**
      * Return the list of logs collected from the last call to simulate()
+     * @note If EnsembleConfig::evict_exported_logs is enabled, logs which were exported to disk are not included
      */
     const std::map<unsigned int, RunLog> &getLogs();
+    /**
+     * Return metrics describing the export of logs to disk during the last call to simulate()
+     * This can be used to choose an appropriate value for EnsembleConfig::log_export_threads
+     * @note All values will be 0 if EnsembleConfig::out_directory was not set
+     */
+    const LogExportMetrics &getLogExportMetrics() const { return log_export_metrics; }
+    /**
+     * Return the work performed by each runner during the last call to simulate(), ordered by device then runner
+     * Low utilisation of some runners indicates that the ensemble's runtime was dominated by a small number of long runs,
+     * which may be improved by EnsembleConfig::scheduling
+     * @note In MPI ensembles, this only contains the runners of the local rank
+     */
+    const std::vector<RunnerMetrics> &getRunnerMetrics() const { return runner_metrics; }
 
  private:
     /**
@@ -201,6 +326,14 @@ class CUDAEnsemble {
      * Runtime of previous call to simulate() in seconds, initially 0.
      */
     double ensemble_elapsed_time = 0.;
+    /**
+     * Log export metrics of previous call to simulate()
+     */
+    LogExportMetrics log_export_metrics;
+    /**
+     * Runner metrics of previous call to simulate()
+     */
+    std::vector<RunnerMetrics> runner_metrics;
     /**
      * If true, the model is using SWIG Python interface
      **/
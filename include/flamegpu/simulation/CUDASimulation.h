@@ -12,6 +12,7 @@
 #include <set>
 
 #include "flamegpu/exception/FLAMEGPUDeviceException.cuh"
+#include "flamegpu/detail/JitifyCache.h"
 #include "flamegpu/simulation/Simulation.h"
 #include "flamegpu/runtime/detail/curve/HostCurve.cuh"
 #include "flamegpu/simulation/detail/CUDAScatter.cuh"
@@ -40,8 +41,12 @@ namespace detail {
 class AbstractSimRunner;
 class CUDAAgent;
 class CUDAMessage;
+class DataflowGraph;
+class StepLogger;
+class ThreadPool;
 }  // namespace detail
 
+struct AgentFunctionData;
 class AgentVector;
 class LoggingConfig;
 class StepLoggingConfig;
@@ -111,6 +116,26 @@ class CUDASimulation : public Simulation {
          * Defaults to enabled.
          */
         bool inLayerConcurrency = true;
+        /**
+         * Path of a RTC kernel bundle to preload, prior to RTC initialisation
+         * RTC agent functions found within the bundle are neither compiled nor loaded from the on-disk cache
+         * Defaults to "" (no bundle)
+         * @see CUDASimulation::exportRTCBundle()
+         */
+        std::string rtc_bundle;
+        /**
+         * If set, the model's RTC agent functions are exported to a bundle at this path by applyConfig(), once they have been compiled
+         * Defaults to "" (no export)
+         * @see CUDASimulation::exportRTCBundle()
+         */
+        std::string rtc_bundle_export;
+        /**
+         * If true, agent functions, host functions and message list builds are executed as soon as their dependencies have completed, rather than layer by layer
+         * Independent agent functions are launched from a pool of host threads, each into its own stream (if inLayerConcurrency is enabled)
+         * This requires the model's layers to have been generated from its dependency graph, via ModelDescription::generateLayers()
+         * Defaults to false
+         */
+        bool dataflow = false;
 
      private:
         /**
@@ -323,8 +348,9 @@ class CUDASimulation : public Simulation {
     void setExitLog(const LoggingConfig &exitConfig);
     /**
      * Returns a reference to the current exit log
+     * Blocks until any step logs still being captured have been appended to the log
      */
-    const RunLog &getRunLog() const override;
+    const RunLog &getRunLog() override;
 #ifdef FLAMEGPU_VISUALISATION
     /**
      * Creates (on first call) and returns the visualisation configuration options for this model instance
@@ -373,14 +399,27 @@ class CUDASimulation : public Simulation {
      * @note This value is used internally for environment property storage
      */
     using Simulation::getInstanceID;
+    /**
+     * Compiles (or loads from cache) the model's RTC agent functions and agent function conditions, including those of submodels,
+     * and exports them to a single bundle file
+     * Simulations (CUDASimulation::Config::rtc_bundle) and ensembles (CUDAEnsemble::EnsembleConfig::rtc_bundle) of the same model
+     * can preload the bundle, so that they start without compiling or accessing the on-disk cache
+     * @param filepath Path of the bundle to write
+     * @throws exception::InvalidFilePath If the bundle cannot be written
+     * @note This initialises the simulation, if it has not already been initialised
+     * @note Kernels are specialised to the device's compute capability and the CUDA and FLAMEGPU versions, the bundle is only used where these match
+     * @see detail::JitifyCache::exportBundle()
+     */
+    void exportRTCBundle(const std::string &filepath);
 
  protected:
     /**
      * Returns the model to a clean state
-     * This clears all agents and message lists, resets environment properties and reseeds random generation.
+     * This clears all agents and message lists, resets environment properties, zeros macro environment properties, empties directed graphs and reseeds random generation.
      * Also calls resetStepCounter();
      * @param submodelReset This should only be set to true when called automatically when a submodel reaches it's exit condition during execution. This performs a subset of the regular reset procedure.
      * @note If triggered on a submodel, agent states and environment properties mapped to a parent agent, and random generation are not affected.
+     * @note Directed graphs are not emptied by a submodel reset, nor are those a submodel maps from its parent.
      * @note If random was manually seeded, it will return to it's original state. If random was seeded from time, it will return to a new random state.
      */
     void reset(bool submodelReset) override;
@@ -416,6 +455,12 @@ class CUDASimulation : public Simulation {
      * @param seed New random seed (this updates stored seed in config)
      */
     void reseed(uint64_t seed);
+    /**
+     * Applies the RunPlan's environment property overrides to the initialised environment
+     * @param plan The RunPlan whose overrides should be applied
+     * @note This performs no validation, the RunPlan must belong to this simulation's model
+     */
+    void applyPropertyOverrides(const RunPlan& plan);
     /**
      * Number of times step() has been called since sim was last reset/init
      */
@@ -473,13 +518,18 @@ class CUDASimulation : public Simulation {
      * Collection of currently logged data
      */
     std::unique_ptr<RunLog> run_log;
+    /**
+     * Captures step logs in the background, created by the first call to processStepLog()
+     * Captured frames are collected into run_log by getRunLog()
+     */
+    std::unique_ptr<detail::StepLogger> step_logger;
     /**
      * Clear and reinitialise the current run_log
      */
     void resetLog();
     /**
      * Check if step_count is a divisible by step_log_config.frequency
-     * If true, add the current simulation state to the step log
+     * If true, capture the current simulation state to be added to the step log in the background
      * @param step_time_seconds Duration of the step to be logged in seconds
      */
     void processStepLog(const double step_time_seconds);
@@ -528,6 +578,28 @@ class CUDASimulation : public Simulation {
      */
     void stepLayer(const std::shared_ptr<LayerData>& layer, const unsigned int layerIndex);
     void layerHostFunctions(const std::shared_ptr<LayerData>& layer, const unsigned int layerIndex);
+    /**
+     * Execute a set of agent functions concurrently, each in its own stream
+     * Streams are synchronised by the caller
+     * @param functions The agent functions to execute
+     * @param layerIndex Index of the layer the agent functions belong to, used to decorrelate random streams
+     * @param streamOffset Index of the stream used by the first agent function, subsequent agent functions use the following streams
+     */
+    void stepAgentFunctions(const std::vector<std::shared_ptr<AgentFunctionData>>& functions, const unsigned int layerIndex, const unsigned int streamOffset);
+    /**
+     * Execute the layers of a step, with each agent function, host function layer, submodel and message list build executing once its dependencies have completed
+     * This is used in place of stepLayer() if Config::dataflow is enabled
+     * @throws exception::InvalidOperation If the model's layers were not generated from a dependency graph
+     */
+    void stepDataflow();
+    /**
+     * Graph of the model's layers, built on first use by stepDataflow()
+     */
+    std::unique_ptr<detail::DataflowGraph> dataflow_graph;
+    /**
+     * Host threads used by stepDataflow() to launch independent agent functions, the thread calling step() also launches agent functions
+     */
+    std::unique_ptr<detail::ThreadPool> dataflow_pool;
 
     /**
      * Execute the step functions of the model. 
@@ -616,13 +688,19 @@ class CUDASimulation : public Simulation {
      * This must be done at the start of step to ensure that any device selection has taken place and to preserve the context between runtime and RTC.
      */
     void initialiseRTC();
+    /**
+     * Appends the sources of the RTC agent functions of this model and its submodels to sources
+     * @param sources The vector to append to
+     * @note initialiseRTC() must have been called
+     */
+    void getRTCKernelSources(std::vector<detail::JitifyCache::KernelSource> &sources) const;
     /**
      * One instance of host api is used for entire model
      */
     std::unique_ptr<HostAPI> host_api;
     /**
-     * Adds any agents stored in agentData to the device
-     * Clears agent storage in agentData
+     * Adds any agents stored in agentData and agentBatches to the device
+     * Clears agent storage in agentData and agentBatches
      * @param streamId Stream index to perform scatter on
      * @note called at the end of step() and after all init/hostLayer functions and exit conditions have finished
      */
@@ -633,6 +711,8 @@ class CUDASimulation : public Simulation {
     typedef std::unordered_map<std::string, AgentDataBuffer> AgentDataBufferStateMap;
     typedef std::unordered_map<std::string, VarOffsetStruct> AgentOffsetMap;
     typedef std::unordered_map<std::string, AgentDataBufferStateMap> AgentDataMap;
+    typedef std::unordered_map<std::string, NewAgentBatchBuffer> AgentBatchBufferStateMap;
+    typedef std::unordered_map<std::string, AgentBatchBufferStateMap> AgentBatchMap;
 
  private:
     std::shared_ptr<detail::EnvironmentManager> getEnvironment() const override;
@@ -652,6 +732,17 @@ class CUDASimulation : public Simulation {
      * Storage used by host agent creation before copying data to device at end of each step()
      */
     AgentDataMap agentData;
+    /**
+     * Storage used by batched host agent creation before copying data to device at end of each step()
+     */
+    AgentBatchMap agentBatches;
+    /**
+     * Staging buffers used to copy agents created by newAgent() to the device
+     * These persist between steps, and only grow, so that host agent creation does not allocate every step
+     */
+    std::vector<char> hostAgentCreationBuffer;
+    char *d_hostAgentCreationBuffer = nullptr;
+    size_t d_hostAgentCreationBufferLen = 0;
     void initOffsetsAndMap();
 #ifdef FLAMEGPU_VISUALISATION
     /**
@@ -14,6 +14,9 @@
 #include "flamegpu/exception/FLAMEGPUException.h"
 
 namespace flamegpu {
+namespace detail {
+class StepLogger;
+}  // namespace detail
 
 struct AgentLogFrame;
 struct StepLogFrame;
@@ -83,6 +86,7 @@ struct LogFrame {
  */
 struct StepLogFrame : public LogFrame {
     friend class CUDASimulation;
+    friend class detail::StepLogger;
     /**
      * Default constructor, creates an empty log
      */
@@ -197,6 +201,7 @@ struct RunLog {
         std::string flamegpu_version;
     };
     friend class CUDASimulation;
+    friend class CPUSimulation;
     /**
      * Constructs an empty RunLog
      */
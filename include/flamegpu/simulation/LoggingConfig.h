@@ -13,6 +13,10 @@
 #include "flamegpu/simulation/CUDAEnsemble.h"
 
 namespace flamegpu {
+namespace detail {
+struct LogStatisticsFns;
+class StepLogger;
+}  // namespace detail
 
 class AgentLoggingConfig;
 
@@ -35,6 +39,10 @@ class LoggingConfig {
      * CUDASimulation::processStepLog() Requires access for reading the config
      */
     friend class CUDASimulation;
+    /**
+     * StepLogger requires access for building the layout of its frames
+     */
+    friend class detail::StepLogger;
     /**
      * Requires access to log_timing
      */
@@ -58,12 +66,6 @@ class LoggingConfig {
         default: return "unknown";
         }
     }
-    /**
-     * ReductionFn is a prototype for reduction functions
-     * Typedef'ing function prototypes like this allows for cleaner function pointers
-     * @note - this leads to a swig warning 504 which is suppressed.
-     */
-    typedef detail::Any (ReductionFn)(HostAgentAPI &ai, const std::string &variable_name);
     /**
      * A user configured reduction to be logged
      */
@@ -77,10 +79,10 @@ class LoggingConfig {
          */
         Reduction reduction;
         /**
-         * Pointer to instantiated reduction function
-         * (Reduction functions are templated so much be instantiated)
+         * Pointer to the instantiated statistics of the variable's type
+         * All reductions of a variable are computed together from these, in a single pass
          */
-        ReductionFn *function;
+        const detail::LogStatisticsFns *statistics;
         /**
          * Generic ordering function, to allow instances of this type to be stored in ordered collections
          * The defined order is not important
@@ -24,6 +24,7 @@ class CUDASimulation;
 namespace io {
 class JSONLogger;
 class XMLLogger;
+class BinaryLogger;
 }  // namespace io
 
 /**
@@ -35,6 +36,7 @@ class RunPlan {
     friend class CUDASimulation;
     friend class io::JSONLogger;
     friend class io::XMLLogger;
+    friend class io::BinaryLogger;
 
  public:
     /**
@@ -62,6 +64,13 @@ class RunPlan {
      * @param subdir The subdirectory to output logfiles for this run to
      */
     void setOutputSubdirectory(const std::string &subdir);
+    /**
+     * Set the estimated cost of this run, relative to the other runs of the RunPlanVector
+     * This is used to order runs when CUDAEnsemble::EnsembleConfig::scheduling is set to LongestFirst, e.g. steps x expected population
+     * @param cost The estimated cost of the run, 0 (the default) denotes that the run's steps should be used as it's cost
+     * @throws exception::InvalidArgument If cost is negative
+     */
+    void setCost(double cost);
     /**
      * Set the environment property override for this run of the model
      * @param name Environment property name
@@ -126,6 +135,11 @@ class RunPlan {
      * Empty string means output for this run will not be placed into a subdirectory
      */
     std::string getOutputSubdirectory() const;
+    /**
+     * Returns the estimated cost of this run
+     * 0 means the cost has not been set, in which case the run's steps are used when scheduling
+     */
+    double getCost() const;
 
     /**
      * Gets the currently configured environment property value
@@ -185,6 +199,7 @@ class RunPlan {
     uint64_t random_seed;
     unsigned int steps;
     std::string output_subdirectory;
+    double cost;
     std::unordered_map<std::string, detail::Any> property_overrides;
     /**
      * Reference to model environment data, for validation
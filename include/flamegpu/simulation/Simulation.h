@@ -124,7 +124,11 @@ class Simulation {
     virtual void setPopulationData(AgentVector& population, const std::string& state_name = ModelData::DEFAULT_STATE) = 0;
     virtual void getPopulationData(AgentVector& population, const std::string& state_name = ModelData::DEFAULT_STATE) = 0;
 
-    virtual const RunLog &getRunLog() const = 0;
+    /**
+     * Returns the run log
+     * This is not const, as implementations may first need to collect logs which are still being captured
+     */
+    virtual const RunLog &getRunLog() = 0;
 
     Config &SimulationConfig();
     const Config &getSimulationConfig() const;
@@ -22,6 +22,7 @@ class LoggingConfig;
 class StepLoggingConfig;
 class RunPlanVector;
 class CUDAEnsemble;
+class CUDASimulation;
 namespace detail {
 /**
 * Common interface and implementation shared between SimRunner and MPISimRunner
@@ -74,9 +75,11 @@ class AbstractSimRunner {
      * @param run_logs Reference to the vector to store generate run logs
      * @param log_export_queue The queue of logs to exported to disk
      * @param log_export_queue_mutex This mutex must be locked to access log_export_queue
-     * @param log_export_queue_cdn The condition is notified every time a log has been added to the queue
+     * @param log_export_queue_cdn The condition is notified every time a log has been added to or removed from the queue
+     * @param max_log_export_backlog The maximum number of logs which may be awaiting export in log_export_queue, 0 denotes no limit
      * @param err_detail Structure to store error details on fast failure for main thread rethrow
      * @param _total_runners Total number of runners executing
+     * @param _reuse_simulation If true, a single CUDASimulation is reset and reused for each run, rather than creating a new instance per run
      * @param _isSWIG Flag denoting whether it's a Python build of FLAMEGPU
      */
     AbstractSimRunner(const std::shared_ptr<const ModelData> _model,
@@ -92,13 +95,15 @@ class AbstractSimRunner {
         std::queue<unsigned int> &log_export_queue,
         std::mutex &log_export_queue_mutex,
         std::condition_variable &log_export_queue_cdn,
+        unsigned int max_log_export_backlog,
         std::vector<ErrorDetail> &err_detail,
         unsigned int _total_runners,
+        bool _reuse_simulation,
         bool _isSWIG);
     /**
      * Virtual class requires polymorphic destructor
      */
-    virtual ~AbstractSimRunner() {}
+    virtual ~AbstractSimRunner();
     /**
      * Subclass implementation of SimRunner
      */
@@ -107,10 +112,20 @@ class AbstractSimRunner {
      * Blocking call which if thread->joinable() triggers thread->join() 
      */
     void join();
+    /**
+     * Returns the number of runs executed by the runner, including those which failed
+     * @note This should not be called until the runner has been joined
+     */
+    unsigned int getRunCount() const { return run_count; }
+    /**
+     * Returns the total time spent executing runs in seconds
+     * @note This should not be called until the runner has been joined
+     */
+    double getBusyTime() const { return busy_time; }
 
  protected:
     /**
-     * Create and execute the simulation for the RunPlan within plans of given index
+     * Create (or reset) and execute the simulation for the RunPlan within plans of given index
      * @throws Exceptions during sim execution may be raised, these should be caught and handled by the caller
      */
     void runSimulation(int plan_id);
@@ -119,7 +134,7 @@ class AbstractSimRunner {
     */
     std::thread thread;
     /**
-    * Each sim runner takes it's own clone of model description hierarchy, so it can manipulate environment without conflict
+    * Each sim runner takes it's own clone of model description hierarchy, from which its CUDASimulation instances are created
     */
     const std::shared_ptr<const ModelData> model;
     /**
@@ -174,17 +189,39 @@ class AbstractSimRunner {
      */
     std::mutex &log_export_queue_mutex;
     /**
-     * The condition is notified every time a log has been added to the queue
+     * The condition is notified every time a log has been added to or removed from the queue
      */
     std::condition_variable &log_export_queue_cdn;
+    /**
+     * The maximum number of logs which may be awaiting export in log_export_queue, 0 denotes no limit
+     * When reached, runSimulation() blocks until the logger has removed a log from the queue
+     */
+    const unsigned int max_log_export_backlog;
     /**
      * Error details will be stored here
      */
     std::vector<ErrorDetail>& err_detail;
+    /**
+     * If true, simulation is reset and reused by subsequent runs
+     */
+    const bool reuse_simulation;
     /**
      * If true, the model is using SWIG Python interface
      **/
     const bool isSWIG;
+    /**
+     * The simulation instance executed by the most recent run
+     * This is only retained between runs if reuse_simulation is set, and is released if a run fails
+     */
+    std::unique_ptr<CUDASimulation> simulation;
+    /**
+     * Number of runs executed by the runner, updated by runSimulation()
+     */
+    unsigned int run_count = 0;
+    /**
+     * Time spent executing runs in seconds, updated by runSimulation()
+     */
+    double busy_time = 0;
 };
 
 }  // namespace detail
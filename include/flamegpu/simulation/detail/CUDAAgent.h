@@ -1,6 +1,7 @@
 #ifndef INCLUDE_FLAMEGPU_SIMULATION_DETAIL_CUDAAGENT_H_
 #define INCLUDE_FLAMEGPU_SIMULATION_DETAIL_CUDAAGENT_H_
 
+#include <future>
 #include <memory>
 #include <map>
 #include <utility>
@@ -8,6 +9,7 @@
 #include <mutex>
 #include <unordered_map>
 #include <list>
+#include <vector>
 
 // include sub classes
 #include "flamegpu/detail/JitifyCache.h"
@@ -159,6 +161,17 @@ class CUDAAgent : public AgentInterface {
      * @param stream CUDA stream to be used for async CUDA operations
      */
     void scatterHostCreation(const std::string &state_name, unsigned int newSize, char *const d_inBuff, const VarOffsetStruct &offsets, detail::CUDAScatter &scatter, unsigned int streamId, cudaStream_t stream);
+    /**
+     * Copies agents from the provided columnar host buffer, this is used for batched host agent creation
+     * @param state_name The state agents are copied into
+     * @param newSize The number of new agents
+     * @param h_columns The host buffer containing the new agents, each variable's column begins at its offset * newSize
+     * @param offsets This defines how the memory is laid out within h_columns
+     * @param scatter Scatter instance and scan arrays to be used (CUDASimulation::singletons->scatter)
+     * @param streamId The stream index to use for accessing stream specific resources such as scan compaction arrays and buffers
+     * @param stream CUDA stream to be used for async CUDA operations
+     */
+    void copyHostCreationColumns(const std::string &state_name, unsigned int newSize, const char *h_columns, const VarOffsetStruct &offsets, detail::CUDAScatter &scatter, unsigned int streamId, cudaStream_t stream);
     /**
      * Sorts all agent variables according to the positions stored inside Message Output scan buffer
      * @param state_name The state agents are scattered into
@@ -204,16 +217,26 @@ class CUDAAgent : public AgentInterface {
     /**
      * Instantiates a RTC Agent function (or agent function condition) from agent function data description containing the source.
      * 
-     * Uses Jitify to create an instantiation of the program. Any compilation errors in the user provided agent function will be reported here.
+     * Uses Jitify to create an instantiation of the program, compilation is performed asynchronously.
+     * finaliseRTCFunctions() must be called before the instantiation can be used, any compilation errors in the user provided agent function will be reported there.
      * @param func The Agent function data structure containing the src for the function
      * @param env Object containing environment properties for the simulation instance
      * @param macro_env Object containing environment macro properties for the simulation instance
      * @param directed_graphs Map of directed graphs for the simulation instance
      * @param function_condition If true then this function will instantiate a function condition rather than an agent function
-     * @throw exception::InvalidAgentFunc thrown if the user supplied agent function has compilation errors
      */
     void addInstantitateRTCFunction(const AgentFunctionData& func, const std::shared_ptr<EnvironmentManager>& env, std::shared_ptr<const detail::CUDAMacroEnvironment> macro_env,
         const std::unordered_map<std::string, std::shared_ptr<CUDAEnvironmentDirectedGraphBuffers>>& directed_graphs, bool function_condition = false);
+    /**
+     * Waits for all RTC agent functions (and agent function conditions) added by addInstantitateRTCFunction() to finish compiling
+     * @throw exception::InvalidAgentFunc thrown if the user supplied agent function has compilation errors
+     */
+    void finaliseRTCFunctions();
+    /**
+     * Returns the sources of every RTC agent function (and agent function condition) added by addInstantitateRTCFunction()
+     * These are suitable for passing to JitifyCache::exportBundle()
+     */
+    const std::vector<JitifyCache::KernelSource> &getRTCKernelSources() const { return rtc_kernel_sources; }
     /**
      * Instantiates the curve instance for an (non-RTC) Agent function (or agent function condition) from agent function data description containing the source.
      *
@@ -376,6 +399,14 @@ class CUDAAgent : public AgentInterface {
      * map between function_name (or function_name_condition) and the jitify instance
      */
     CUDARTCFuncMap rtc_func_map;
+    /**
+     * map between function_name (or function_name_condition) and the jitify instance which is still being compiled
+     */
+    std::map<std::string, std::future<std::unique_ptr<jitify::experimental::KernelInstantiation>>> rtc_func_pending;
+    /**
+     * The sources passed to JitifyCache for each RTC agent function (and agent function condition)
+     */
+    std::vector<JitifyCache::KernelSource> rtc_kernel_sources;
     /**
      * map between function name (or function_name_condition) and the rtc header
      * This allows access to the header data cache, for updating curve
@@ -96,6 +96,20 @@ class CUDAAgentStateList {
      * @param stream CUDA stream to be used for async CUDA operations
      */
     void scatterHostCreation(unsigned int newSize, char *const d_inBuff, const VarOffsetStruct &offsets, detail::CUDAScatter &scatter, unsigned int streamId, cudaStream_t stream);
+    /**
+     * Initialises the specified number of new agents based on columnar agent data from a host buffer
+     * Each variable is copied directly to the device, so no scatter is required
+     * Variables in mapped agents are also initialised to their default values
+     * Also updates the count of alive agents to accommodate the new agents
+     * @param newSize The number of new agents to initialise
+     * @param h_columns host pointer to buffer of agent init data, each variable's column begins at its offset * newSize
+     * @param offsets Offset data explaining the layout of h_columns
+     * @param scatter Scatter instance and scan arrays to be used
+     * @param streamId The stream index to use for accessing stream specific resources such as scan compaction arrays and buffers
+     * @param stream CUDA stream to be used for async CUDA operations
+     * @note h_columns may be modified as soon as this returns, as copies from pageable host memory are staged before returning
+     */
+    void copyHostCreationColumns(unsigned int newSize, const char *h_columns, const VarOffsetStruct &offsets, detail::CUDAScatter &scatter, unsigned int streamId, cudaStream_t stream);
     /**
      * Sorts all agent variables according to the positions stored inside Message Output scan buffer
      * @param scatter Scatter instance and scan arrays to be used (CUDASimulation::singletons->scatter)
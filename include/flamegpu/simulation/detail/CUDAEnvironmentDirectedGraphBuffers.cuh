@@ -4,6 +4,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <set>
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -31,6 +32,9 @@ class CurveRTCHost;
  * This represents the equivalent of CUDAAgent, CUDAMessage for EnvironmentDirectedGraph
  * As the graph cannot be modified on the device, the host buffers can be assumed to always holds the truth
  * It is only necessary to ensure device buffers are updated to match if the host buffers have changed
+ *
+ * The CSR/CSC is only updated incrementally when the source/dest of existing edges are rewritten (see syncDevice_async()).
+ * Inserting or removing edges requires setEdgeCount(), which reallocates the edge buffers and forces a full rebuild.
  */
 class CUDAEnvironmentDirectedGraphBuffers {
     struct Buffer {
@@ -86,14 +90,66 @@ class CUDAEnvironmentDirectedGraphBuffers {
     unsigned int *d_ipbm = nullptr;
     // Copy of the vals list from constructing ipbm, required to lookup edges
     unsigned int *d_ipbm_edges = nullptr;
-    // Vertex ID -> index map, ?? has been reserved, otherwise any ID is valid
-    // However, the ID->index map does not utilise any compression, so non-contiguous ID ranges may lead to out of memory errors.
+    // Vertex ID -> index map, ID_NOT_SET has been reserved, otherwise any ID is valid
+    // If vertex IDs are sparse, the map is instead a hash table, so that it is not sized to the ID range (see detail::VertexIndexMap)
     unsigned int *d_vertex_index_map = nullptr;
+    // Length of d_vertex_index_map, excluding the packed header
+    unsigned int vertex_index_map_length = 0;
+    /**
+     * True if the device edge buffers are sorted from a previous rebuild, and the device source/dest buffer holds vertex indices
+     * Whilst true, edges modified via the setEdge methods are tracked in dirty_edges, so the CSR/CSC can be updated incrementally
+     */
+    bool csr_valid = false;
+    /**
+     * Indices of edges whose source/dest have changed since the last rebuild
+     */
+    std::set<unsigned int> dirty_edges;
+    /**
+     * Device staging buffer for the dirty edges during an incremental rebuild, and its length in bytes
+     */
+    char *d_dirty_edges = nullptr;
+    size_t d_dirty_edges_length = 0;
+    /**
+     * Per edge scratch buffers used during an incremental rebuild
+     * d_edge_flags marks stale positions in the previous sort, d_edge_flags_scan holds its exclusive scan
+     */
+    unsigned int *d_edge_flags = nullptr, *d_edge_flags_scan = nullptr;
 
     void allocateVertexBuffers(size_type count, cudaStream_t stream);
     void allocateEdgeBuffers(size_type count);
     void deallocateVertexBuffers();
     void deallocateEdgeBuffers();
+    /**
+     * (Re)build the device vertex ID -> index map from the device vertex ID buffer
+     * A hash table is built if vertex IDs are sparse, otherwise a direct lookup table
+     * @throws exception::IDNotSet If any vertices have not been assigned an ID
+     * @throws exception::IDCollision If any vertices share an ID
+     */
+    void buildVertexIndexMap(cudaStream_t stream);
+    /**
+     * Full rebuild of the CSR and CSC, every edge is validated and sorted
+     */
+    void rebuildFull(detail::CUDAScatter& scatter, unsigned int streamID, cudaStream_t stream);
+    /**
+     * Incremental rebuild of the CSR and CSC, only the edges in dirty_edges are validated and sorted
+     * They are then merged with the remaining edges which are already sorted from the previous rebuild
+     * This requires csr_valid, and must be called before the device source/dest buffer is updated from the host
+     */
+    void rebuildIncremental(detail::CUDAScatter& scatter, unsigned int streamID, cudaStream_t stream);
+    /**
+     * Build a PBM from a sorted list of edge keys, where the upper 32 bits of the key is the bin
+     * @param d_pbm_target The PBM to build, this is swapped with d_pbm_swap
+     * @param d_sorted_keys The sorted edge keys
+     */
+    void buildPBM(unsigned int *&d_pbm_target, const uint64_t *d_sorted_keys, detail::CUDAScatter& scatter, unsigned int streamID, cudaStream_t stream);
+    /**
+     * Point all curve instances at the current edge property buffers, PBM, inverted PBM and inverted PBM edge list
+     */
+    void updateCurveEdgeBuffers();
+    /**
+     * Record that the source/dest of an edge has changed, and that the graph requires a rebuild
+     */
+    void markEdgeDirty(unsigned int edge_index);
     /*
      * Reset the internal vertex ID range tracking variables as though no vertices have been assigned IDs
      */
@@ -103,8 +159,8 @@ class CUDAEnvironmentDirectedGraphBuffers {
     /**
      * Host ID map, this allows HostAPI methods to operate using vertex id
      */
-    std::map<id_t, unsigned int> h_vertex_index_map;
-    util::PairMap<id_t, id_t, unsigned int> h_edge_index_map;
+    std::unordered_map<id_t, unsigned int> h_vertex_index_map;
+    util::PairUnorderedMap<id_t, id_t, unsigned int> h_edge_index_map;
 
  public:
     /**
@@ -134,10 +190,16 @@ class CUDAEnvironmentDirectedGraphBuffers {
      */
     void setVertexCount(size_type count, cudaStream_t stream);
     /**
-     * Allocates and initialises the vertex buffers
+     * Allocates and initialises the edge buffers
+     * Existing edges are discarded, so the next syncDevice_async() performs a full rebuild
      * @param count The number of edges to allocate each buffer for
      */
     void setEdgeCount(size_type count);
+    /**
+     * Releases all vertex and edge buffers, returning the graph to its empty initial state
+     * Curve instances are updated to no longer reference the released buffers
+     */
+    void reset();
     /**
      * Returns the number of vertices the graph is currently allocated to hold
      */
@@ -236,10 +298,19 @@ class CUDAEnvironmentDirectedGraphBuffers {
     template<typename T>
     std::vector<T> getEdgePropertyArray(const std::string& property_name, const unsigned int edge_index, cudaStream_t stream) const;
 #endif
-    void markForRebuild() { requires_rebuild = true; }
+    /**
+     * Mark the graph to be fully rebuilt before it is next used on the device
+     * This must be called if edge source/dest pairs have been updated directly via getEdgePropertyBuffer()
+     */
+    void markForRebuild() {
+        requires_rebuild = true;
+        csr_valid = false;
+    }
     /**
      * Update any device buffers which don't currently match the host
      * Rebuild the internal graph CSR, sort edge buffers
+     * If only the source/dest of a small fraction of edges have changed since the last rebuild, they are merged into the existing CSR
+     * The edge count must be unchanged for this, there is no incremental path for inserting or removing edges
      * @param scatter CUDAScatter singleton instance
      * @param streamID Stream index corresponding to stream resources to use
      * @param stream The cuda stream to perform CUDA operations on
@@ -375,6 +446,10 @@ T* CUDAEnvironmentDirectedGraphBuffers::getVertexPropertyBuffer(const std::strin
     auto &vb = vertex_buffers.at(property_name);
     vb.updateHostBuffer(vertex_count, stream);
     vb.ready = Buffer::Host;
+    if (property_name == ID_VARIABLE_NAME) {
+        // Vertex IDs may be changed directly, so the previous CSR can not be updated incrementally
+        csr_valid = false;
+    }
     return static_cast<T*>(vb.h_ptr);
 }
 template<typename T>
@@ -418,6 +493,10 @@ T* CUDAEnvironmentDirectedGraphBuffers::getEdgePropertyBuffer(const std::string&
     auto &eb = edge_buffers.at(property_name);
     eb.updateHostBuffer(edge_count, stream);
     eb.ready = Buffer::Host;
+    if (property_name == GRAPH_SOURCE_DEST_VARIABLE_NAME) {
+        // Edge source/dest may be changed directly, so the previous CSR can not be updated incrementally
+        csr_valid = false;
+    }
     return static_cast<T*>(eb.h_ptr);
 }
 #ifdef SWIG
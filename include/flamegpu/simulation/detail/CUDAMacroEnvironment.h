@@ -97,6 +97,12 @@ class CUDAMacroEnvironment {
      * Release all CUDA allocations, and unregisters CURVE variables
      */
     void free();
+    /**
+     * Zero all owned macro properties, returning them to their state following init()
+     * Properties mapped from a master model are not affected
+     * @param stream The CUDAStream to use for CUDA operations
+     */
+    void resetProperties(cudaStream_t stream);
     /**
      * Register the properties to the provided RTC header
      * @param curve_header The RTC header to act upon
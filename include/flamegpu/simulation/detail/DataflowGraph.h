@@ -0,0 +1,145 @@
+#ifndef INCLUDE_FLAMEGPU_SIMULATION_DETAIL_DATAFLOWGRAPH_H_
+#define INCLUDE_FLAMEGPU_SIMULATION_DETAIL_DATAFLOWGRAPH_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace flamegpu {
+struct AgentFunctionData;
+struct LayerData;
+struct ModelData;
+namespace detail {
+class ThreadPool;
+
+/**
+ * Graph of the work performed by a single step of a model's layers, used by dataflow execution
+ * Rather than executing layer by layer, each node is executed as soon as the nodes it depends upon have completed
+ *
+ * Edges are taken from the dependencies recorded within layers generated by DependencyGraph::generateLayers().
+ * Additionally, nodes which access the same agent or message data (where either writes) retain the order of layered execution.
+ * These edges are built in a single pass over the layers, by tracking the last node to write each resource and the nodes which have read it since.
+ * Host function and submodel layers may access any data, so they act as barriers between the nodes before and after them.
+ */
+class DataflowGraph {
+ public:
+    /**
+     * Granularity at which accesses to agent data are tracked
+     */
+    enum class AgentGranularity {
+        /**
+         * Agent functions conflict if they access the same agent state list, or birth agents of the same type
+         */
+        State,
+        /**
+         * Agent functions conflict if they access (or birth) the same type of agent
+         */
+        Agent
+    };
+    /**
+     * Options which control how the graph is built
+     */
+    struct Options {
+        AgentGranularity granularity = AgentGranularity::State;
+        /**
+         * If true, a MessageBuild node is placed between the output of a message list and the agent functions which next read it
+         * Otherwise, agent functions which read a message list are assumed to not modify it
+         */
+        bool message_builds = false;
+        /**
+         * If true, every agent function conflicts with every other, so they execute in layered order
+         */
+        bool serialise_agent_functions = false;
+    };
+    /**
+     * A unit of work within the graph
+     */
+    struct Node {
+        enum Type {
+            /**
+             * Execute a single agent function (and its condition)
+             */
+            AgentFunction,
+            /**
+             * Execute the host functions of a layer
+             */
+            HostFunctions,
+            /**
+             * Execute the submodel of a layer
+             */
+            SubModel,
+            /**
+             * Prepare a message list to be read, e.g. construct its spatial index
+             */
+            MessageBuild
+        };
+        Type type;
+        /**
+         * The layer which the node belongs to
+         * For MessageBuild nodes, this is the layer of the first agent function which reads the message list
+         */
+        std::shared_ptr<LayerData> layer;
+        /**
+         * Index of the layer within the model
+         */
+        unsigned int layer_index;
+        /**
+         * The agent function to execute, only set for AgentFunction nodes
+         */
+        std::shared_ptr<AgentFunctionData> function;
+        /**
+         * Index of the agent function within layered execution, only set for AgentFunction nodes
+         */
+        unsigned int function_index;
+        /**
+         * Name of the message list to prepare, only set for MessageBuild nodes
+         */
+        std::string message;
+        /**
+         * If true, the node is executed by the thread which called execute(), rather than a worker of the thread pool
+         */
+        bool main_thread;
+        /**
+         * Number of nodes which must complete before this node may begin
+         */
+        unsigned int dependency_count;
+        /**
+         * Indices of the nodes which depend on this node
+         */
+        std::vector<unsigned int> dependents;
+    };
+    /**
+     * Builds the graph from the layers of the model
+     * @param model The model to build the graph of
+     * @param options Options which control how the graph is built
+     * @throws exception::InvalidOperation If the model's layers were not generated from a dependency graph
+     */
+    DataflowGraph(const ModelData &model, const Options &options);
+    /**
+     * Returns the nodes of the graph, in layered execution order
+     */
+    const std::vector<Node> &getNodes() const { return nodes; }
+    /**
+     * Execute body for every node, each once all of the node's dependencies have completed
+     * Nodes are submitted to the pool as they become ready, and the calling thread also executes nodes until all have completed.
+     * As bodies execute on the pool's workers, they may make nested use of the pool (see ThreadPool).
+     * If an execution of body throws, the remaining nodes are skipped and the first exception is rethrown once in-flight nodes have completed.
+     * @param pool The thread pool to execute nodes with, if nullptr nodes are executed in order by the calling thread
+     * @param body Callable of the form void(const Node &node)
+     */
+    void execute(ThreadPool *pool, const std::function<void(const Node&)> &body) const;
+    /**
+     * Returns the agent functions of the layer, in the order they are executed
+     * Layers are a set ordered by pointer, so these are sorted by name to make execution order (and random streams) reproducible
+     */
+    static std::vector<std::shared_ptr<AgentFunctionData>> getLayerFunctions(const LayerData &layer);
+
+ private:
+    std::vector<Node> nodes;
+};
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_SIMULATION_DETAIL_DATAFLOWGRAPH_H_
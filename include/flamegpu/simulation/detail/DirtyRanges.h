@@ -0,0 +1,91 @@
+#ifndef INCLUDE_FLAMEGPU_SIMULATION_DETAIL_DIRTYRANGES_H_
+#define INCLUDE_FLAMEGPU_SIMULATION_DETAIL_DIRTYRANGES_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace flamegpu {
+namespace detail {
+
+/**
+ * Tracks the byte ranges of a host buffer which have changed since it was last copied to the device
+ * Ranges are stored disjoint and sorted, overlapping and adjacent ranges are merged as they are marked
+ */
+class DirtyRanges {
+ public:
+    /**
+     * Marks the range [offset, offset + length) as dirty
+     * @param offset Offset of the first modified byte
+     * @param length Number of modified bytes
+     */
+    void markDirty(size_t offset, size_t length) {
+        if (!length)
+            return;
+        size_t end = offset + length;
+        // Find the first range which could overlap or touch the new range
+        auto it = ranges.upper_bound(offset);
+        if (it != ranges.begin() && std::prev(it)->second >= offset) {
+            --it;
+        }
+        // Absorb every range which overlaps or touches the new range
+        while (it != ranges.end() && it->first <= end) {
+            offset = std::min(offset, it->first);
+            end = std::max(end, it->second);
+            it = ranges.erase(it);
+        }
+        ranges.emplace(offset, end);
+    }
+    /**
+     * Marks the whole buffer as dirty
+     * @param buffer_length Length of the buffer
+     */
+    void markAll(const size_t buffer_length) {
+        ranges.clear();
+        markDirty(0, buffer_length);
+    }
+    /**
+     * Returns true if no ranges are dirty
+     */
+    bool empty() const { return ranges.empty(); }
+    /**
+     * Returns the total number of dirty bytes
+     */
+    size_t dirtyBytes() const {
+        size_t rtn = 0;
+        for (const auto &r : ranges)
+            rtn += r.second - r.first;
+        return rtn;
+    }
+    /**
+     * Returns the dirty ranges as (offset, length) pairs in ascending order, and marks the buffer clean
+     * Ranges separated by a gap of max_gap bytes or fewer are coalesced, as copying the clean gap is cheaper than issuing another copy
+     * @param max_gap The largest gap of clean bytes to coalesce over
+     */
+    std::vector<std::pair<size_t, size_t>> take(const size_t max_gap) {
+        std::vector<std::pair<size_t, size_t>> rtn;
+        for (const auto &r : ranges) {
+            if (!rtn.empty() && r.first - (rtn.back().first + rtn.back().second) <= max_gap) {
+                rtn.back().second = r.second - rtn.back().first;
+            } else {
+                rtn.emplace_back(r.first, r.second - r.first);
+            }
+        }
+        ranges.clear();
+        return rtn;
+    }
+
+ private:
+    /**
+     * Map of range begin to range end (exclusive)
+     */
+    std::map<size_t, size_t> ranges;
+};
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_SIMULATION_DETAIL_DIRTYRANGES_H_
@@ -17,11 +17,13 @@
 #include "flamegpu/runtime/detail/curve/HostCurve.cuh"
 #include "flamegpu/detail/type_decode.h"
 #include "flamegpu/detail/Any.h"
+#include "flamegpu/simulation/detail/DirtyRanges.h"
 
 namespace flamegpu {
 struct SubEnvironmentData;
 struct EnvironmentData;
 class CUDASimulation;
+class CPUSimulation;
 namespace detail {
 
 /**
@@ -38,6 +40,10 @@ class EnvironmentManager : public std::enable_shared_from_this<EnvironmentManage
      * The latter could probably be moved into EnvironmentManager (behind a private method)
      */
     friend class flamegpu::CUDASimulation;
+    /**
+     * CPUSimulation::applyConfig_derived() requires access to EnvironmentManager::setPropertyDirect()
+     */
+    friend class flamegpu::CPUSimulation;
 
  private:
     /**
@@ -249,10 +255,11 @@ class EnvironmentManager : public std::enable_shared_from_this<EnvironmentManage
      */
     void resetModel(const EnvironmentData& desc);
     /**
-     * Copies the environment property cache to a device buffer
+     * Copies the properties which have changed since the previous call to a device buffer
+     * The device buffer is allocated by the first call, so the environment can be used by host-only simulations
      * @param stream Cuda stream to perform memcpys on
      */
-    void updateDevice_async(cudaStream_t stream) const;
+    void updateDevice_async(cudaStream_t stream);
     /**
      * Returns the minimum buffer size required to call updateDevice_async()
      *
@@ -267,6 +274,7 @@ class EnvironmentManager : public std::enable_shared_from_this<EnvironmentManage
     }
     /**
      * Used by agent functions to access the environment
+     * @note Returns nullptr until updateDevice_async() has been called
      */
     const void* getDeviceBuffer() const {
         return d_buffer;
@@ -335,9 +343,13 @@ class EnvironmentManager : public std::enable_shared_from_this<EnvironmentManage
     char *h_buffer = nullptr;
     char *d_buffer = nullptr;
     /**
-     * True when the contents of d_buffer matches h_buffer, this is used to skip unnecessary cudaMemcpys
+     * Ranges of h_buffer which differ from d_buffer, only these are copied by updateDevice_async()
+     */
+    DirtyRanges d_buffer_dirty;
+    /**
+     * Dirty ranges separated by this many clean bytes or fewer are copied with a single cudaMemcpy
      */
-    mutable bool d_buffer_ready = false;
+    static constexpr size_t DEVICE_COPY_MAX_GAP = 4096;
     /**
      * Length of h_buffer
      */
@@ -382,9 +394,7 @@ const EnvironmentManager::EnvProp& EnvironmentManager::findProperty(const std::s
                 "in EnvironmentManager::setProperty().",
                 property_name.c_str());
         }
-        // Check this here, rather than in 4 separate methods
-        if (setter)
-            d_buffer_ready = false;
+        // Setters mark the property dirty via propagateMappedPropertyValue()
         return a->second;
     }
     THROW exception::InvalidEnvProperty("Environmental property with name '%s' does not exist, "
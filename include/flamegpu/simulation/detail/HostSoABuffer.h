@@ -0,0 +1,162 @@
+#ifndef INCLUDE_FLAMEGPU_SIMULATION_DETAIL_HOSTSOABUFFER_H_
+#define INCLUDE_FLAMEGPU_SIMULATION_DETAIL_HOSTSOABUFFER_H_
+
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "flamegpu/model/Variable.h"
+#include "flamegpu/exception/FLAMEGPUException.h"
+
+namespace flamegpu {
+namespace detail {
+
+/**
+ * Host resident structure of arrays storage for the variables of an agent state list or message list
+ *
+ * Each variable is stored in a contiguous column, with array variables stored with their elements interleaved.
+ * This is used by CPUSimulation in place of the device buffers managed by CUDAAgentStateList/CUDAMessageList.
+ */
+class HostSoABuffer {
+ public:
+    /**
+     * Storage for a single variable
+     */
+    struct Column {
+        /**
+         * @param variable The variable definition the column is built from
+         */
+        explicit Column(const Variable &variable);
+        /**
+         * Type of the variable, as returned by typeid()
+         */
+        std::type_index type;
+        /**
+         * Size of the variable's base type in bytes
+         */
+        size_t type_size;
+        /**
+         * The number of elements, this will be 1 unless the variable is an array
+         */
+        unsigned int elements;
+        /**
+         * Value assigned to new items, all elements of the variable
+         * If the variable has no default value, this will be zero initialised
+         */
+        std::vector<char> default_value;
+        /**
+         * The raw column, of length type_size * elements * HostSoABuffer::size()
+         */
+        std::vector<char> data;
+        /**
+         * Returns the address of the first element of the variable for the item at index
+         * @param index Index of the item within the buffer
+         */
+        char *item(unsigned int index) { return data.data() + index * type_size * elements; }
+        const char *item(unsigned int index) const { return data.data() + index * type_size * elements; }
+    };
+    typedef std::unordered_map<std::string, Column> ColumnMap;
+    /**
+     * Creates an empty buffer, with a column for each variable
+     * @param variables The variables to be stored by the buffer
+     */
+    explicit HostSoABuffer(const VariableMap &variables);
+    /**
+     * Returns the number of items stored in the buffer
+     */
+    unsigned int size() const { return count; }
+    /**
+     * Resize the buffer, new items are initialised to the variables' default values
+     * @param new_size The new number of items
+     */
+    void resize(unsigned int new_size);
+    /**
+     * Remove all items from the buffer
+     * Allocated memory is retained
+     */
+    void clear() { resize(0); }
+    /**
+     * Stable compaction, removes all items which do not have a non-zero flag
+     * @param keep A flag for each item in the buffer, non-zero items are retained
+     */
+    void compact(const std::vector<char> &keep);
+    /**
+     * Append the items of other which have a non-zero flag to the end of this buffer
+     * The two buffers must have been built from the same variable definitions
+     * @param other The buffer to copy items from
+     * @param flags A flag for each item in other, if nullptr all items are copied
+     */
+    void append(const HostSoABuffer &other, const std::vector<char> *flags = nullptr);
+    /**
+     * Returns the named column, or nullptr if the variable does not exist
+     * @param name Name of the variable
+     */
+    Column *findColumn(const std::string &name);
+    const Column *findColumn(const std::string &name) const;
+    /**
+     * Returns the full map of columns
+     */
+    ColumnMap &getColumns() { return columns; }
+    const ColumnMap &getColumns() const { return columns; }
+    /**
+     * Returns a pointer to the element of a variable for the item at index
+     * @param name Name of the variable
+     * @param index Index of the item within the buffer
+     * @param array_index Index of the element within the variable
+     * @tparam T Type of the variable
+     * @tparam N Length of the variable, 0 if the length should not be checked
+     * @throws exception::InvalidAgentVar If the named variable does not exist
+     * @throws exception::InvalidVarType If T does not match the type of the variable
+     * @throws exception::InvalidVarArrayLen If N is non-zero and does not match the length of the variable
+     * @throws exception::OutOfRangeVarArray If array_index is out of range of the variable's elements
+     */
+    template<typename T, unsigned int N = 0>
+    T *getElement(const std::string &name, unsigned int index, unsigned int array_index = 0);
+    template<typename T, unsigned int N = 0>
+    const T *getElement(const std::string &name, unsigned int index, unsigned int array_index = 0) const;
+
+ private:
+    /**
+     * Number of items stored in each column
+     */
+    unsigned int count;
+    ColumnMap columns;
+};
+
+template<typename T, unsigned int N>
+T *HostSoABuffer::getElement(const std::string &name, const unsigned int index, const unsigned int array_index) {
+    return const_cast<T*>(static_cast<const HostSoABuffer*>(this)->getElement<T, N>(name, index, array_index));
+}
+template<typename T, unsigned int N>
+const T *HostSoABuffer::getElement(const std::string &name, const unsigned int index, const unsigned int array_index) const {
+    const auto it = columns.find(name);
+    if (it == columns.end()) {
+        THROW exception::InvalidAgentVar("Variable with name '%s' was not found, "
+            "in HostSoABuffer::getElement().",
+            name.c_str());
+    }
+    const Column &c = it->second;
+    if (c.type != std::type_index(typeid(T))) {
+        THROW exception::InvalidVarType("Variable '%s' is of a different type. "
+            "'%s' was expected, but '%s' was requested, "
+            "in HostSoABuffer::getElement().",
+            name.c_str(), c.type.name(), typeid(T).name());
+    }
+    if (N && N != c.elements) {
+        THROW exception::InvalidVarArrayLen("Variable '%s' is an array with %u elements, incorrect array of length %u was specified, "
+            "in HostSoABuffer::getElement().",
+            name.c_str(), c.elements, N);
+    }
+    if (array_index >= c.elements) {
+        THROW exception::OutOfRangeVarArray("Index %u is out of bounds of variable '%s' which has %u elements, "
+            "in HostSoABuffer::getElement().",
+            array_index, name.c_str(), c.elements);
+    }
+    return reinterpret_cast<const T*>(c.item(index)) + array_index;
+}
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_SIMULATION_DETAIL_HOSTSOABUFFER_H_
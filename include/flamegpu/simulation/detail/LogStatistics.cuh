@@ -0,0 +1,186 @@
+#ifndef INCLUDE_FLAMEGPU_SIMULATION_DETAIL_LOGSTATISTICS_CUH_
+#define INCLUDE_FLAMEGPU_SIMULATION_DETAIL_LOGSTATISTICS_CUH_
+
+#include <cub/cub.cuh>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "flamegpu/detail/Any.h"
+#include "flamegpu/simulation/AgentLoggingConfig_SumReturn.h"
+#include "flamegpu/simulation/LoggingConfig.h"
+#include "flamegpu/simulation/detail/CUDAErrorChecking.cuh"
+
+namespace flamegpu {
+namespace detail {
+
+/**
+ * Every statistic which can be logged for an agent variable, computed together in a single reduction
+ * The variance is accumulated with the parallel form of Welford's algorithm (Chan et al.), so no second pass over the data is required
+ * @tparam T Type of the agent variable
+ */
+template<typename T>
+struct LogStatistics {
+    typedef typename sum_input_t<T>::result_t sum_t;
+    sum_t sum;
+    T min;
+    T max;
+    /**
+     * Running mean and sum of squared differences from the mean, used to calculate the standard deviation
+     */
+    double mean;
+    double m2;
+    unsigned int count;
+    /**
+     * Returns the statistics of an empty set of values
+     */
+    static __host__ __device__ LogStatistics empty() {
+        return LogStatistics{0, T(), T(), 0.0, 0.0, 0};
+    }
+    /**
+     * Returns the statistics of a single value
+     */
+    static __host__ __device__ LogStatistics of(const T &value) {
+        return LogStatistics{static_cast<sum_t>(value), value, value, static_cast<double>(value), 0.0, 1};
+    }
+    /**
+     * Returns the statistics of the union of the values represented by a and b
+     */
+    static __host__ __device__ LogStatistics combine(const LogStatistics &a, const LogStatistics &b) {
+        if (!a.count)
+            return b;
+        if (!b.count)
+            return a;
+        const unsigned int count = a.count + b.count;
+        const double delta = b.mean - a.mean;
+        const double b_fraction = static_cast<double>(b.count) / count;
+        return LogStatistics{
+            a.sum + b.sum,
+            b.min < a.min ? b.min : a.min,
+            a.max < b.max ? b.max : a.max,
+            a.mean + delta * b_fraction,
+            a.m2 + b.m2 + delta * delta * a.count * b_fraction,
+            count};
+    }
+    /**
+     * Returns the value of the requested reduction, matching the results of the equivalent HostAgentAPI reductions
+     * @param reduction The reduction to be returned
+     */
+    detail::Any result(LoggingConfig::Reduction reduction) const;
+};
+/**
+ * Transform and reduction operators, for passing LogStatistics to CUB
+ */
+template<typename T>
+struct LogStatisticsOf {
+    __host__ __device__ LogStatistics<T> operator()(const T &value) const { return LogStatistics<T>::of(value); }
+};
+template<typename T>
+struct LogStatisticsCombine {
+    __host__ __device__ LogStatistics<T> operator()(const LogStatistics<T> &a, const LogStatistics<T> &b) const { return LogStatistics<T>::combine(a, b); }
+};
+
+/**
+ * Host reference implementation, computes the statistics of a column of values
+ * This is not used during simulation, but allows the fused reduction to be validated against host data (e.g. AgentVector::data())
+ * @param data Pointer to the first value
+ * @param count Number of values
+ */
+template<typename T>
+LogStatistics<T> computeLogStatistics(const T *data, const unsigned int count) {
+    LogStatistics<T> rtn = LogStatistics<T>::empty();
+    for (unsigned int i = 0; i < count; ++i) {
+        rtn = LogStatistics<T>::combine(rtn, LogStatistics<T>::of(data[i]));
+    }
+    return rtn;
+}
+
+/**
+ * Type erased interface to LogStatistics<T>, so that the reductions of all variables within an agent state can be
+ * enqueued together and retrieved with a single copy and synchronisation
+ * An instance for each type is returned by getLogStatisticsFns<T>()
+ */
+struct LogStatisticsFns {
+    /**
+     * Size of LogStatistics<T> in bytes, this is always a multiple of 8 so packed results remain aligned
+     */
+    size_t size;
+    /**
+     * Returns the temporary storage required by reduce()
+     * @param count Number of agents to be reduced
+     */
+    size_t (*tempStorageBytes)(unsigned int count);
+    /**
+     * Enqueues the reduction of a device column into d_out
+     * @param d_in Device pointer to the agent variable
+     * @param count Number of agents
+     * @param d_out Device pointer to storage for LogStatistics<T>
+     * @param d_temp Device temporary storage, of at least tempStorageBytes(count)
+     * @param temp_bytes Size of d_temp
+     * @param stream The CUDA stream to enqueue the reduction within
+     */
+    void (*reduce)(const void *d_in, unsigned int count, void *d_out, void *d_temp, size_t temp_bytes, cudaStream_t stream);
+    /**
+     * Returns a logged reduction from host copy of the reduction's output
+     * @param h_statistics Host pointer to LogStatistics<T>
+     * @param reduction The reduction to be returned
+     */
+    detail::Any (*result)(const void *h_statistics, LoggingConfig::Reduction reduction);
+    /**
+     * Returns a logged reduction of an empty agent state, which requires no reduction to be performed
+     * @param reduction The reduction to be returned
+     */
+    detail::Any (*emptyResult)(LoggingConfig::Reduction reduction);
+};
+
+template<typename T>
+detail::Any LogStatistics<T>::result(const LoggingConfig::Reduction reduction) const {
+    switch (reduction) {
+    case LoggingConfig::Mean:
+        return detail::Any(count ? sum / static_cast<double>(count) : 0.0);
+    case LoggingConfig::StandardDev:
+        return detail::Any(count ? sqrt(m2 / count) : 0.0);
+    case LoggingConfig::Min:
+        // Matches cub::DeviceReduce::Min() of an empty range
+        return detail::Any(count ? min : std::numeric_limits<T>::max());
+    case LoggingConfig::Max:
+        return detail::Any(count ? max : std::numeric_limits<T>::lowest());
+    case LoggingConfig::Sum:
+    default:
+        return detail::Any(sum);
+    }
+}
+
+template<typename T>
+const LogStatisticsFns *getLogStatisticsFns() {
+    static_assert(sizeof(LogStatistics<T>) % 8 == 0, "LogStatistics must be a multiple of 8 bytes");
+    static const LogStatisticsFns fns = {
+        sizeof(LogStatistics<T>),
+        [](const unsigned int count) {
+            size_t bytes = 0;
+            cub::TransformInputIterator<LogStatistics<T>, LogStatisticsOf<T>, const T*> in(nullptr, LogStatisticsOf<T>());
+            gpuErrchk(cub::DeviceReduce::Reduce(nullptr, bytes, in, static_cast<LogStatistics<T>*>(nullptr), static_cast<int>(count),
+                LogStatisticsCombine<T>(), LogStatistics<T>::empty()));
+            return bytes;
+        },
+        [](const void *d_in, const unsigned int count, void *d_out, void *d_temp, size_t temp_bytes, const cudaStream_t stream) {
+            cub::TransformInputIterator<LogStatistics<T>, LogStatisticsOf<T>, const T*> in(static_cast<const T*>(d_in), LogStatisticsOf<T>());
+            gpuErrchk(cub::DeviceReduce::Reduce(d_temp, temp_bytes, in, static_cast<LogStatistics<T>*>(d_out), static_cast<int>(count),
+                LogStatisticsCombine<T>(), LogStatistics<T>::empty(), stream));
+            gpuErrchkLaunch();
+        },
+        [](const void *h_statistics, const LoggingConfig::Reduction reduction) {
+            return static_cast<const LogStatistics<T>*>(h_statistics)->result(reduction);
+        },
+        [](const LoggingConfig::Reduction reduction) {
+            return LogStatistics<T>::empty().result(reduction);
+        }
+    };
+    return &fns;
+}
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_SIMULATION_DETAIL_LOGSTATISTICS_CUH_
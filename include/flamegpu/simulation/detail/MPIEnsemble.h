@@ -3,6 +3,7 @@
 
 #include <mpi.h>
 
+#include <chrono>
 #include <map>
 #include <set>
 #include <string>
@@ -19,9 +20,10 @@ class MPIEnsemble {
     const CUDAEnsemble::EnsembleConfig &config;
     // Tags to different the MPI messages used in protocol
     enum EnvelopeTag : int {
-        // Sent from worker to manager to request a job index to process
+        // Sent from worker to manager to request up to the contained number of jobs to process
         RequestJob = 0,
-        // Sent from manager to worker to assign a job index to process in response to AssignJob
+        // Sent from manager to worker in response to RequestJob, assigning a contiguous range of job indices {first, count}
+        // A count of 0 denotes that no jobs remain, if first is UINT_MAX remaining jobs have been cancelled due to an error
         AssignJob = 1,
         // Sent from worker to manager to report an error during job execution
         // If fail fast is enabled, following RequestJob will receive an exit job id (>=plans.size())
@@ -51,6 +53,11 @@ class MPIEnsemble {
      * The total number of runs to be executed (only used for printing error warnings)
      */
     const unsigned int total_runs;
+    /**
+     * The maximum time the manager thread of a rank sleeps before checking for MPI messages
+     * The manager is otherwise woken by local runners, so this only bounds the latency of responding to other ranks
+     */
+    static constexpr std::chrono::milliseconds POLL_INTERVAL = std::chrono::milliseconds(1);
     /**
      * Construct the object for managing MPI comms during an ensemble
      *
@@ -68,20 +75,32 @@ class MPIEnsemble {
     int receiveErrors(std::multimap<int, AbstractSimRunner::ErrorDetail> &err_detail);
     /**
      * If world_rank==0, receive and process any waiting job requests
+     * Each request is assigned a contiguous chunk of jobs, which shrinks as the remaining jobs are depleted (guided self-scheduling),
+     * so that ranks which complete runs faster are assigned more runs whilst all ranks finish close together
      * @param next_run A reference to the int which tracks the progress through the run plan vector
-     * @return The number of runners that have been told to exit (if next_run>total_runs)
+     * @param cancelled If true, remaining jobs have been cancelled due to an error, so requesting ranks are told to discard their queued jobs
+     * @return The number of ranks that have been told to exit (if next_run>=total_runs)
      */
-    int receiveJobRequests(unsigned int &next_run);
+    int receiveJobRequests(unsigned int &next_run, bool cancelled);
     /**
      * If world_rank!=0, send the provided error detail to world_rank==0
      * @param e_detail The error detail to be sent
      */
     void sendErrorDetail(AbstractSimRunner::ErrorDetail &e_detail);
     /**
-     * If world_rank!=0, request a job from world_rank==0 and return the response
-     * @return The index of the assigned job
+     * If world_rank!=0, request up to count jobs from world_rank==0
+     * This does not wait for a response, receiveJobs() must be called to collect the assignment before further jobs are requested
+     * @param count The maximum number of jobs to be assigned
+     */
+    void requestJobs(unsigned int count);
+    /**
+     * If world_rank!=0, collect the response to the outstanding requestJobs()
+     * @param first Returns the index of the first assigned job
+     * @param count Returns the number of assigned jobs, 0 if no jobs remain
+     * @param block If true, wait for the response to arrive
+     * @return True if the response has been received, in which case first and count are set
      */
-    int requestJob();
+    bool receiveJobs(unsigned int &first, unsigned int &count, bool block);
     /**
      * Wait for all MPI ranks to reach a barrier
      */
@@ -166,6 +185,12 @@ class MPIEnsemble {
      * MPI representation of AbstractSimRunner::ErrorDetail type
      */
     const MPI_Datatype MPI_ERROR_DETAIL;
+    /**
+     * Buffers and requests of the outstanding non-blocking job request, these must persist until it completes
+     */
+    unsigned int job_request_count;
+    unsigned int job_assignment[2];
+    MPI_Request job_requests[2];
     /**
      * flag indicating if the current MPI rank is a participating rank (i.e. it has atleast one GPU it can use).
      * This is not a const public member, as it can only be computed after world and local rank / sizes and local gpu count are known.
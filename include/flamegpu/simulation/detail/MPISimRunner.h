@@ -48,9 +48,13 @@ class MPISimRunner : public AbstractSimRunner {
      * @param run_logs Reference to the vector to store generate run logs
      * @param log_export_queue The queue of logs to exported to disk
      * @param log_export_queue_mutex This mutex must be locked to access log_export_queue
-     * @param log_export_queue_cdn The condition is notified every time a log has been added to the queue
+     * @param log_export_queue_cdn The condition is notified every time a log has been added to or removed from the queue
+     * @param max_log_export_backlog The maximum number of logs which may be awaiting export in log_export_queue, 0 denotes no limit
      * @param err_detail_local Structure to store error details on failure for main thread to handle
+     * @param _runner_mutex This mutex must be locked whilst updating _next_run
+     * @param _runner_cdn The condition is notified every time _next_run is updated, by either the runner or the manager
      * @param _total_runners Total number of runners executing
+     * @param _reuse_simulation If true, a single CUDASimulation is reset and reused for each run, rather than creating a new instance per run
      * @param _isSWIG Flag denoting whether it's a Python build of FLAMEGPU
      */
     MPISimRunner(const std::shared_ptr<const ModelData> _model,
@@ -66,13 +70,28 @@ class MPISimRunner : public AbstractSimRunner {
         std::queue<unsigned int> &log_export_queue,
         std::mutex &log_export_queue_mutex,
         std::condition_variable &log_export_queue_cdn,
+        unsigned int max_log_export_backlog,
         std::vector<ErrorDetail> &err_detail_local,
+        std::mutex &_runner_mutex,
+        std::condition_variable &_runner_cdn,
         unsigned int _total_runners,
+        bool _reuse_simulation,
         bool _isSWIG);
     /**
      * SimRunner loop with MPI comm with local manager
+     * The runner sleeps whilst waiting for the manager to assign it a job
      */
     void main() override;
+
+ private:
+    /**
+     * This mutex must be locked whilst updating next_run
+     */
+    std::mutex &runner_mutex;
+    /**
+     * The condition is notified every time next_run is updated, by either the runner or the manager
+     */
+    std::condition_variable &runner_cdn;
 };
 
 }  // namespace detail
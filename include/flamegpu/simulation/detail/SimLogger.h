@@ -7,16 +7,18 @@
 #include <string>
 #include <condition_variable>
 #include <map>
+#include <vector>
 
 #include "flamegpu/simulation/LogFrame.h"
+#include "flamegpu/simulation/CUDAEnsemble.h"
 
 namespace flamegpu {
 class RunPlanVector;
-class CUDAEnsemble;
 namespace detail {
 
 /**
  * This class is used by CUDAEnsemble::simulate() to collect logs generated by each of the SimRunner instances executing in different threads and write them to disk
+ * Logs are exported by a pool of threads, so that the logs of different runs can be written concurrently
  */
 class SimLogger {
     friend class flamegpu::CUDAEnsemble;
@@ -28,13 +30,15 @@ class SimLogger {
      * @param out_format The format to write logs to disk.
      * @param log_export_queue The queue of logs to exported to disk
      * @param log_export_queue_mutex This mutex must be locked to access log_export_queue
-     * @param log_export_queue_cdn The condition is notified every time a log has been added to the queue
+     * @param log_export_queue_cdn The condition is notified every time a log has been added to or removed from the queue
      * @param _export_step If true step logs will be exported
      * @param _export_exit If true exit logs will be exported
      * @param _export_step_time If true step log time will be exported
      * @param _export_exit_time If true exit log time will be exported
+     * @param _evict_exported_logs If true logs will be removed from run_logs once they have been exported
+     * @param export_threads The number of threads to export logs with, 0 is treated as 1
      */
-    SimLogger(const std::map<unsigned int, RunLog> &run_logs,
+    SimLogger(std::map<unsigned int, RunLog> &run_logs,
         const RunPlanVector &run_plans,
         const std::string &out_directory,
         const std::string &out_format,
@@ -44,20 +48,39 @@ class SimLogger {
         bool _export_step,
         bool _export_exit,
         bool _export_step_time,
-        bool _export_exit_time);
+        bool _export_exit_time,
+        bool _evict_exported_logs,
+        unsigned int export_threads);
     /**
-     * The thread which the logger is executing on, created by the constructor
+     * Blocking call which joins all of the logger's threads
+     * A UINT_MAX must have been added to log_export_queue, to signal the threads to exit
      */
-    std::thread thread;
+    void join();
     /**
-     * Starts the SimLogger running in thread
+     * Returns the metrics collected so far
+     * @note Should only be called after join()
+     */
+    const CUDAEnsemble::LogExportMetrics &getMetrics() const { return metrics; }
+    /**
+     * The threads which the logger is executing on, created by the constructor
+     */
+    std::vector<std::thread> threads;
+    /**
+     * Body of each of the logger's threads, exports logs until UINT_MAX is found in log_export_queue
      */
     void start();
+    /**
+     * Returns the mutex which must be held whilst writing to the named exit log file
+     * Exit logs of all runs within an output subdirectory are appended to the same file
+     * @param path Path to the exit log file
+     */
+    std::mutex &getExitFileMutex(const std::string &path);
     // External references
     /**
      * Reference to the map to store generate run logs
+     * This must only be accessed whilst log_export_queue_mutex is locked
      */
-    const std::map<unsigned int, RunLog> &run_logs;
+    std::map<unsigned int, RunLog> &run_logs;
     /**
      * Reference to the vector of run configurations to be executed
      */
@@ -79,7 +102,7 @@ class SimLogger {
      */
     std::mutex &log_export_queue_mutex;
     /**
-     * The condition is notified every time a log has been added to the queue
+     * The condition is notified every time a log has been added to or removed from the queue
      */
     std::condition_variable &log_export_queue_cdn;
     /**
@@ -98,6 +121,22 @@ class SimLogger {
      * If true exit time will be included in the exit log file
      */
     bool export_exit_time;
+    /**
+     * If true logs are removed from run_logs once they have been exported, to bound memory usage
+     */
+    bool evict_exported_logs;
+    /**
+     * Metrics collected by the logger's threads, must only be accessed whilst log_export_queue_mutex is locked
+     */
+    CUDAEnsemble::LogExportMetrics metrics;
+    /**
+     * Mutex for each exit log file which has been written to
+     */
+    std::map<std::string, std::mutex> exit_file_mutexes;
+    /**
+     * This mutex must be locked to access exit_file_mutexes
+     */
+    std::mutex exit_file_mutexes_mutex;
 };
 
 }  // namespace detail
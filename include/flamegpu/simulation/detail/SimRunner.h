@@ -32,6 +32,10 @@ class SimRunner : public AbstractSimRunner {
     * Flag for whether the ensemble should throw an exception if it errors out
     */
     const bool fail_fast;
+    /**
+     * The order in which runs are to be executed, next_run indexes this vector
+     */
+    const std::vector<unsigned int> &run_order;
 
  public:
     /**
@@ -40,6 +44,7 @@ class SimRunner : public AbstractSimRunner {
      * @param _err_ct Reference to an atomic integer for tracking how many errors have occurred
      * @param _next_run Atomic counter for safely selecting the next run plan to execute across multiple threads
      * @param _plans The vector of run plans to be executed by the ensemble
+     * @param _run_order The indices of plans, in the order they should be executed
      * @param _step_log_config The config of which data should be logged each step
      * @param _exit_log_config The config of which data should be logged at run exit
      * @param _device_id The GPU that all runs should execute on
@@ -49,15 +54,18 @@ class SimRunner : public AbstractSimRunner {
      * @param run_logs Reference to the vector to store generate run logs
      * @param log_export_queue The queue of logs to exported to disk
      * @param log_export_queue_mutex This mutex must be locked to access log_export_queue
-     * @param log_export_queue_cdn The condition is notified every time a log has been added to the queue
+     * @param log_export_queue_cdn The condition is notified every time a log has been added to or removed from the queue
+     * @param max_log_export_backlog The maximum number of logs which may be awaiting export in log_export_queue, 0 denotes no limit
      * @param err_detail Structure to store error details on fast failure for main thread rethrow
      * @param _total_runners Total number of runners executing
+     * @param _reuse_simulation If true, a single CUDASimulation is reset and reused for each run, rather than creating a new instance per run
      * @param _isSWIG Flag denoting whether it's a Python build of FLAMEGPU
      */
     SimRunner(const std::shared_ptr<const ModelData> _model,
         std::atomic<unsigned int> &_err_ct,
         std::atomic<unsigned int> &_next_run,
         const RunPlanVector &_plans,
+        const std::vector<unsigned int> &_run_order,
         std::shared_ptr<const StepLoggingConfig> _step_log_config,
         std::shared_ptr<const LoggingConfig> _exit_log_config,
         int _device_id,
@@ -68,11 +76,13 @@ class SimRunner : public AbstractSimRunner {
         std::queue<unsigned int> &log_export_queue,
         std::mutex &log_export_queue_mutex,
         std::condition_variable &log_export_queue_cdn,
+        unsigned int max_log_export_backlog,
         std::vector<ErrorDetail> &err_detail,
         unsigned int _total_runners,
+        bool _reuse_simulation,
         bool _isSWIG);
     /**
-     * SimRunner loop with shared next_run atomic
+     * SimRunner loop with shared next_run atomic, which selects the next run from run_order
      */
     void main() override;
 };
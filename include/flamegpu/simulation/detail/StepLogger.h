@@ -0,0 +1,171 @@
+#ifndef INCLUDE_FLAMEGPU_SIMULATION_DETAIL_STEPLOGGER_H_
+#define INCLUDE_FLAMEGPU_SIMULATION_DETAIL_STEPLOGGER_H_
+
+#include <cuda_runtime.h>
+
+#include <condition_variable>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "flamegpu/simulation/LogFrame.h"
+
+namespace flamegpu {
+namespace detail {
+class CUDAAgent;
+class CUDAScatter;
+class EnvironmentManager;
+struct LogStatisticsFns;
+
+/**
+ * This class is used by CUDASimulation to capture step logs without stalling the simulation loop
+ *
+ * The layout of a step log is fixed by its StepLoggingConfig, so a ring of frames is preallocated from it.
+ * capture() copies the logged environment properties and agent counts into the next free frame, and enqueues the
+ * agent reductions to be copied into the frame's pinned host buffer. A background thread waits for each frame's
+ * reductions to complete, assembles the StepLogFrame and releases the frame, whilst the following steps execute.
+ * If every frame is awaiting assembly, capture() blocks until one is released, so the backlog is bounded.
+ */
+class StepLogger {
+ public:
+    typedef std::unordered_map<std::string, std::unique_ptr<CUDAAgent>> CUDAAgentMap;
+    /**
+     * Preallocates the frames and starts the background thread
+     * @param config The step logging config, this defines the layout of each frame
+     * @param environment The simulation's environment
+     * @param agent_map The simulation's agents
+     * @param device_id The device the simulation is executing on
+     * @param frame_count The number of frames in the ring, 0 is treated as 1
+     */
+    StepLogger(const StepLoggingConfig &config, const EnvironmentManager &environment, const CUDAAgentMap &agent_map, int device_id, unsigned int frame_count = 2);
+    /**
+     * Waits for all captured frames to be assembled, then stops the background thread and releases the frames
+     * Assembled frames which have not been collected are discarded
+     */
+    ~StepLogger();
+    /**
+     * Captures the current state of the simulation into the next free frame
+     * Blocks whilst all frames are awaiting assembly
+     * @param step_count The step being logged
+     * @param step_time_seconds Duration of the step to be logged in seconds
+     * @param scatter Scatter singleton, provides the cub temporary storage
+     * @param streams The simulation's CUDA streams, the reductions are performed within the first
+     *        The remaining streams wait for the reductions to complete, so that later steps cannot modify agent data whilst it is being reduced
+     */
+    void capture(unsigned int step_count, double step_time_seconds, CUDAScatter &scatter, const std::vector<cudaStream_t> &streams);
+    /**
+     * Waits for all captured frames to be assembled, and moves them to the back of step_log
+     * @param step_log The list to append assembled frames to
+     * @throws The first exception raised by the background thread, if any
+     */
+    void collect(std::list<StepLogFrame> &step_log);
+
+ private:
+    /**
+     * A logged environment property, copied from the environment's host buffer
+     */
+    struct EnvironmentProperty {
+        std::string name;
+        ptrdiff_t source_offset;
+        size_t offset;
+        size_t length;
+        std::type_index type;
+        unsigned int elements;
+    };
+    /**
+     * A logged agent variable, all of its reductions are computed together
+     */
+    struct AgentVariable {
+        std::string name;
+        const LogStatisticsFns *statistics;
+        /**
+         * Offset of the variable's statistics within each frame's statistics buffer
+         */
+        size_t offset;
+    };
+    /**
+     * A logged agent state
+     */
+    struct AgentState {
+        util::StringPair name;
+        std::vector<AgentVariable> variables;
+        std::shared_ptr<const std::set<LoggingConfig::NameReductionFn>> reductions;
+        bool log_count;
+    };
+    /**
+     * Preallocated storage for a single step log
+     */
+    struct Frame {
+        unsigned int step_count = 0;
+        double step_time = 0;
+        std::vector<char> environment;
+        /**
+         * The number of agents in each logged state
+         */
+        std::vector<unsigned int> counts;
+        /**
+         * Pinned host buffer which the reductions are copied into
+         */
+        char *h_statistics = nullptr;
+        /**
+         * Recorded after the copy into h_statistics has been enqueued
+         */
+        cudaEvent_t event = nullptr;
+    };
+    /**
+     * Body of the background thread, assembles frames in the order they were captured
+     */
+    void start();
+    /**
+     * Converts a captured frame into a StepLogFrame
+     */
+    StepLogFrame assemble(const Frame &frame) const;
+    const EnvironmentManager &environment;
+    const CUDAAgentMap &agent_map;
+    const int device_id;
+    std::vector<EnvironmentProperty> environment_properties;
+    std::vector<AgentState> agent_states;
+    size_t environment_bytes = 0;
+    size_t statistics_bytes = 0;
+    /**
+     * Device buffer which the reductions are performed into, before being copied to a frame
+     * This is shared by all frames, as the copy is ordered within the stream before the next capture's reductions
+     */
+    char *d_statistics = nullptr;
+    std::vector<Frame> frames;
+    /**
+     * Index of the next frame to capture into, and the number of captured frames awaiting assembly
+     * The frame awaiting assembly the longest is at (next_capture + frames.size() - pending) % frames.size()
+     */
+    unsigned int next_capture = 0;
+    unsigned int pending = 0;
+    bool stop = false;
+    /**
+     * Frames which have been assembled and not yet collected
+     */
+    std::list<StepLogFrame> assembled;
+    /**
+     * The first exception raised by the background thread
+     */
+    std::exception_ptr error;
+    /**
+     * This mutex must be locked to access next_capture, pending, stop, assembled and error
+     */
+    std::mutex mutex;
+    /**
+     * Notified every time a frame is captured or assembled
+     */
+    std::condition_variable cdn;
+    std::thread thread;
+};
+
+}  // namespace detail
+}  // namespace flamegpu
+
+#endif  // INCLUDE_FLAMEGPU_SIMULATION_DETAIL_STEPLOGGER_H_
@@ -0,0 +1,488 @@
+#include "flamegpu/detail/DiskCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace flamegpu {
+namespace detail {
+
+namespace {
+/**
+ * Identifies store files
+ */
+constexpr char MAGIC[8] = { 'F', 'G', 'P', 'U', 'R', 'T', 'C', '\0' };
+/**
+ * Format version, incremented whenever the layout changes
+ * Stores of a differing version are discarded
+ */
+constexpr uint32_t VERSION = 1;
+/**
+ * The smallest number of slots a store's table is created with
+ */
+constexpr uint64_t MIN_SLOT_COUNT = 1024;
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    /**
+     * Number of slots in the table, always a power of 2
+     */
+    uint64_t slot_count;
+    /**
+     * Incremented every time an entry is used, slots record the value when they were last used
+     */
+    uint64_t clock;
+    /**
+     * Total length of the records referenced by the table
+     */
+    uint64_t live_bytes;
+    uint64_t entry_count;
+    /**
+     * End of the data region, new records are appended here
+     */
+    uint64_t data_end;
+    uint64_t reserved2;
+};
+struct Slot {
+    /**
+     * Hash of the entry's key, 0 if the slot is unoccupied
+     */
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t length;
+    uint64_t last_used;
+};
+/**
+ * Each record is followed by its key, reference and value
+ */
+struct RecordHeader {
+    uint64_t hash;
+    uint64_t key_length;
+    uint64_t reference_length;
+    uint64_t value_length;
+    /**
+     * Checksum of the value, detects records which were not completely written
+     */
+    uint64_t checksum;
+};
+static_assert(sizeof(Header) == 64, "DiskCache Header has unexpected padding");
+static_assert(sizeof(Slot) == 32, "DiskCache Slot has unexpected padding");
+static_assert(sizeof(RecordHeader) == 40, "DiskCache RecordHeader has unexpected padding");
+
+/**
+ * 64 bit FNV-1a, this is stable across platforms and builds
+ */
+uint64_t fnv1a(const char *data, const size_t length, uint64_t hash = 14695981039346656037ull) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+uint64_t hashKey(const std::string &key) {
+    const uint64_t hash = fnv1a(key.data(), key.size());
+    // 0 denotes an unoccupied slot
+    return hash ? hash : 1;
+}
+uint64_t dataStart(const Header &header) {
+    return sizeof(Header) + header.slot_count * sizeof(Slot);
+}
+bool readAt(std::fstream &f, const uint64_t offset, void *data, const uint64_t length) {
+    f.seekg(offset);
+    f.read(static_cast<char*>(data), length);
+    return static_cast<bool>(f);
+}
+bool writeAt(std::fstream &f, const uint64_t offset, const void *data, const uint64_t length) {
+    f.seekp(offset);
+    f.write(static_cast<const char*>(data), length);
+    return static_cast<bool>(f);
+}
+/**
+ * Reads and validates the header of a store
+ */
+bool readHeader(std::fstream &f, Header &header) {
+    if (!f.is_open() || !readAt(f, 0, &header, sizeof(Header))) {
+        return false;
+    }
+    return std::equal(MAGIC, MAGIC + sizeof(MAGIC), header.magic)
+        && header.version == VERSION
+        && header.slot_count >= MIN_SLOT_COUNT
+        && (header.slot_count & (header.slot_count - 1)) == 0
+        && header.data_end >= dataStart(header);
+}
+/**
+ * Locates the slot which holds hash, or the unoccupied slot where it would be inserted
+ * @return true if the slot holding hash was found
+ */
+bool findSlot(std::fstream &f, const Header &header, const uint64_t hash, uint64_t &slot_index, Slot &slot) {
+    const uint64_t mask = header.slot_count - 1;
+    for (uint64_t i = 0; i < header.slot_count; ++i) {
+        slot_index = (hash + i) & mask;
+        if (!readAt(f, sizeof(Header) + slot_index * sizeof(Slot), &slot, sizeof(Slot))) {
+            return false;
+        }
+        if (slot.hash == hash) {
+            return true;
+        } else if (slot.hash == 0) {
+            return false;
+        }
+    }
+    // Table is full, this should be prevented by compaction
+    f.setstate(std::ios::failbit);
+    return false;
+}
+/**
+ * Writes a new store to a temporary file, containing the listed records copied from source, then renames it over path
+ */
+bool writeStore(const std::string &path, const uint64_t slot_count, const uint64_t clock, std::fstream *source, const std::vector<Slot> &records) {
+    const std::string tmp_path = path + ".tmp";
+    Header header = {};
+    std::copy(MAGIC, MAGIC + sizeof(MAGIC), header.magic);
+    header.version = VERSION;
+    header.slot_count = slot_count;
+    header.clock = clock;
+    header.data_end = dataStart(header);
+    std::vector<Slot> slots(slot_count, Slot{0, 0, 0, 0});
+    {
+        std::fstream out(tmp_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        std::vector<char> buffer;
+        for (const Slot &record : records) {
+            buffer.resize(record.length);
+            if (!readAt(*source, record.offset, buffer.data(), record.length) || !writeAt(out, header.data_end, buffer.data(), record.length)) {
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(tmp_path, ec);
+                return false;
+            }
+            uint64_t i = record.hash & (slot_count - 1);
+            while (slots[i].hash) {
+                i = (i + 1) & (slot_count - 1);
+            }
+            slots[i] = Slot{record.hash, header.data_end, record.length, record.last_used};
+            header.data_end += record.length;
+            header.live_bytes += record.length;
+            ++header.entry_count;
+        }
+        if (!writeAt(out, sizeof(Header), slots.data(), slot_count * sizeof(Slot)) || !writeAt(out, 0, &header, sizeof(Header))) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+/**
+ * Warns the first time a lock file cannot be locked, subsequent failures are silent as they behave as a miss
+ */
+void warnLockFailure(const std::string &path) {
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true)) {
+        fprintf(stderr, "Warning: Unable to lock '%s', the RTC disk cache will not be used whilst this persists.\n", path.c_str());
+    }
+}
+/**
+ * Holds a lock on a file for its lifetime, this excludes other processes (and other instances within this process)
+ */
+class FileLock {
+ public:
+    enum class Mode {
+        /**
+         * Blocks until no exclusive lock is held, other shared locks may be held concurrently
+         */
+        Shared,
+        /**
+         * Blocks until no other lock is held
+         */
+        Exclusive,
+        /**
+         * As Exclusive, but fails rather than blocks if another lock is held
+         */
+        TryExclusive
+    };
+    explicit FileLock(const std::string &path, const Mode mode = Mode::Exclusive) {
+        bool contended = false;
+#ifdef _MSC_VER
+        handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (handle != INVALID_HANDLE_VALUE) {
+            OVERLAPPED overlapped = {};
+            const DWORD flags = mode == Mode::Shared ? 0 : mode == Mode::Exclusive ? LOCKFILE_EXCLUSIVE_LOCK : LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY;
+            locked = LockFileEx(handle, flags, 0, MAXDWORD, MAXDWORD, &overlapped);
+            contended = !locked && GetLastError() == ERROR_LOCK_VIOLATION;
+        }
+#else
+        fd = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+        if (fd != -1) {
+            const int operation = mode == Mode::Shared ? LOCK_SH : mode == Mode::Exclusive ? LOCK_EX : LOCK_EX | LOCK_NB;
+            int rtn;
+            do {
+                rtn = flock(fd, operation);
+            } while (rtn == -1 && errno == EINTR);
+            locked = rtn == 0;
+            contended = !locked && errno == EWOULDBLOCK;
+        }
+#endif
+        // Contention is expected when trying to lock, any other failure is not
+        if (!locked && !(mode == Mode::TryExclusive && contended)) {
+            warnLockFailure(path);
+        }
+    }
+    ~FileLock() {
+#ifdef _MSC_VER
+        if (handle != INVALID_HANDLE_VALUE) {
+            if (locked) {
+                OVERLAPPED overlapped = {};
+                UnlockFileEx(handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+            }
+            CloseHandle(handle);
+        }
+#else
+        if (fd != -1) {
+            if (locked) {
+                flock(fd, LOCK_UN);
+            }
+            close(fd);
+        }
+#endif
+    }
+    FileLock(const FileLock &) = delete;
+    FileLock &operator=(const FileLock &) = delete;
+    bool isLocked() const { return locked; }
+
+ private:
+#ifdef _MSC_VER
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+    bool locked = false;
+};
+}  // namespace
+
+DiskCache::DiskCache(const std::string &directory, const uint64_t _size_limit)
+    : store_path((std::filesystem::path(directory) / STORE_FILE).string())
+    , lock_path((std::filesystem::path(directory) / LOCK_FILE).string())
+    , size_limit(_size_limit) { }
+
+bool DiskCache::load(const std::string &key, const std::string &reference, std::string &value) {
+    const uint64_t hash = hashKey(key);
+    uint64_t slot_index;
+    Slot slot;
+    try {
+        // Lookups only read the store, so may proceed concurrently
+        std::shared_lock<std::shared_mutex> guard(mutex);
+        FileLock lock(lock_path, FileLock::Mode::Shared);
+        if (!lock.isLocked()) {
+            return false;
+        }
+        std::fstream f(store_path, std::ios::in | std::ios::binary);
+        Header header;
+        if (!readHeader(f, header)) {
+            return false;
+        }
+        if (!findSlot(f, header, hash, slot_index, slot)) {
+            return false;
+        }
+        // Validate the record, it may have been partially written by a process which terminated
+        RecordHeader record;
+        if (slot.offset < dataStart(header) || slot.offset > header.data_end || slot.length > header.data_end - slot.offset ||
+            slot.length < sizeof(RecordHeader) || !readAt(f, slot.offset, &record, sizeof(RecordHeader))) {
+            return false;
+        }
+        if (record.hash != hash || record.key_length != key.size() || record.reference_length != reference.size() ||
+            record.value_length != slot.length - sizeof(RecordHeader) - key.size() - reference.size()) {
+            return false;
+        }
+        std::string buffer(key.size() + reference.size(), '\0');
+        if (!readAt(f, slot.offset + sizeof(RecordHeader), &buffer[0], buffer.size()) ||
+            buffer.compare(0, key.size(), key) != 0 || buffer.compare(key.size(), reference.size(), reference) != 0) {
+            return false;
+        }
+        std::string rtn(record.value_length, '\0');
+        if (!readAt(f, slot.offset + sizeof(RecordHeader) + buffer.size(), &rtn[0], rtn.size()) ||
+            fnv1a(rtn.data(), rtn.size()) != record.checksum) {
+            return false;
+        }
+        value = std::move(rtn);
+    } catch (...) {
+        return false;
+    }
+    try {
+        // Marking the entry as most recently used is best effort, it is skipped rather than wait for other accesses
+        std::unique_lock<std::shared_mutex> guard(mutex, std::try_to_lock);
+        if (!guard.owns_lock()) {
+            return true;
+        }
+        FileLock lock(lock_path, FileLock::Mode::TryExclusive);
+        if (!lock.isLocked()) {
+            return true;
+        }
+        // The store may have been replaced since the lookup, so the slot must still hold the same record
+        std::fstream f(store_path, std::ios::in | std::ios::out | std::ios::binary);
+        Header header;
+        Slot current;
+        if (readHeader(f, header) && slot_index < header.slot_count &&
+            readAt(f, sizeof(Header) + slot_index * sizeof(Slot), &current, sizeof(Slot)) &&
+            current.hash == slot.hash && current.offset == slot.offset) {
+            current.last_used = ++header.clock;
+            writeAt(f, sizeof(Header) + slot_index * sizeof(Slot), &current, sizeof(Slot));
+            writeAt(f, 0, &header, sizeof(Header));
+        }
+    } catch (...) { }
+    return true;
+}
+void DiskCache::store(const std::string &key, const std::string &reference, const std::string &value) {
+    const uint64_t record_length = sizeof(RecordHeader) + key.size() + reference.size() + value.size();
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    if (record_length > size_limit) {
+        return;
+    }
+    try {
+        FileLock lock(lock_path);
+        if (!lock.isLocked()) {
+            return;
+        }
+        const uint64_t hash = hashKey(key);
+        std::fstream f(store_path, std::ios::in | std::ios::out | std::ios::binary);
+        Header header;
+        if (!readHeader(f, header)) {
+            // Store does not exist, or is not valid
+            f.close();
+            if (!writeStore(store_path, MIN_SLOT_COUNT, 0, nullptr, {})) {
+                return;
+            }
+            f.open(store_path, std::ios::in | std::ios::out | std::ios::binary);
+            if (!readHeader(f, header)) {
+                return;
+            }
+        }
+        uint64_t slot_index;
+        Slot slot;
+        bool found = findSlot(f, header, hash, slot_index, slot);
+        const uint64_t live_bytes = header.live_bytes - (found ? slot.length : 0) + record_length;
+        const uint64_t entry_count = header.entry_count + (found ? 0 : 1);
+        const uint64_t dead_bytes = header.data_end - dataStart(header) - header.live_bytes;
+        if (!f || live_bytes > size_limit || entry_count * 2 > header.slot_count || dead_bytes > size_limit) {
+            // Evict the least recently used entries (and any replaced by this one), so the store is left with 3/4 of the limit
+            f.close();
+            const uint64_t target = size_limit - size_limit / 4;
+            compact(target > record_length ? target - record_length : 0, hash);
+            f.open(store_path, std::ios::in | std::ios::out | std::ios::binary);
+            if (!readHeader(f, header)) {
+                return;
+            }
+            found = findSlot(f, header, hash, slot_index, slot);
+            if (!f) {
+                return;
+            }
+        }
+        // Append the record, then publish it to the table
+        const RecordHeader record = {hash, key.size(), reference.size(), value.size(), fnv1a(value.data(), value.size())};
+        const uint64_t offset = header.data_end;
+        if (!writeAt(f, offset, &record, sizeof(RecordHeader)) ||
+            !writeAt(f, offset + sizeof(RecordHeader), key.data(), key.size()) ||
+            !writeAt(f, offset + sizeof(RecordHeader) + key.size(), reference.data(), reference.size()) ||
+            !writeAt(f, offset + sizeof(RecordHeader) + key.size() + reference.size(), value.data(), value.size()) ||
+            !f.flush()) {
+            return;
+        }
+        if (found) {
+            header.live_bytes -= slot.length;
+        } else {
+            ++header.entry_count;
+        }
+        slot = Slot{hash, offset, record_length, ++header.clock};
+        header.live_bytes += record_length;
+        header.data_end = offset + record_length;
+        writeAt(f, sizeof(Header) + slot_index * sizeof(Slot), &slot, sizeof(Slot));
+        writeAt(f, 0, &header, sizeof(Header));
+    } catch (...) { }
+}
+void DiskCache::compact(const uint64_t target, const uint64_t exclude_hash) {
+    std::fstream f(store_path, std::ios::in | std::ios::binary);
+    Header header;
+    if (!readHeader(f, header)) {
+        f.close();
+        writeStore(store_path, MIN_SLOT_COUNT, 0, nullptr, {});
+        return;
+    }
+    std::vector<Slot> slots(header.slot_count);
+    if (!readAt(f, sizeof(Header), slots.data(), header.slot_count * sizeof(Slot))) {
+        f.close();
+        writeStore(store_path, MIN_SLOT_COUNT, 0, nullptr, {});
+        return;
+    }
+    // Retain the most recently used records which fit within the target
+    slots.erase(std::remove_if(slots.begin(), slots.end(), [&header, exclude_hash](const Slot &s) {
+        return s.hash == 0 || s.hash == exclude_hash || s.offset < dataStart(header) || s.offset > header.data_end || s.length > header.data_end - s.offset;
+    }), slots.end());
+    std::sort(slots.begin(), slots.end(), [](const Slot &a, const Slot &b) { return a.last_used > b.last_used; });
+    uint64_t total = 0;
+    size_t kept = 0;
+    while (kept < slots.size() && total + slots[kept].length <= target) {
+        total += slots[kept++].length;
+    }
+    slots.resize(kept);
+    // Leave the table at most 1/4 full, so that it does not immediately require compacting again
+    uint64_t slot_count = MIN_SLOT_COUNT;
+    while (slot_count < 4 * (kept + 1)) {
+        slot_count <<= 1;
+    }
+    writeStore(store_path, slot_count, header.clock, &f, slots);
+}
+void DiskCache::clear() {
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    FileLock lock(lock_path);
+    std::error_code ec;
+    std::filesystem::remove(store_path, ec);
+}
+void DiskCache::setSizeLimit(const uint64_t _size_limit) {
+    std::lock_guard<std::shared_mutex> guard(mutex);
+    size_limit = _size_limit;
+}
+uint64_t DiskCache::getSizeLimit() const {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+    return size_limit;
+}
+uint64_t DiskCache::getSize() {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+    FileLock lock(lock_path, FileLock::Mode::Shared);
+    std::fstream f(store_path, std::ios::in | std::ios::binary);
+    Header header;
+    return lock.isLocked() && readHeader(f, header) ? header.live_bytes : 0;
+}
+uint64_t DiskCache::getEntryCount() {
+    std::shared_lock<std::shared_mutex> guard(mutex);
+    FileLock lock(lock_path, FileLock::Mode::Shared);
+    std::fstream f(store_path, std::ios::in | std::ios::binary);
+    Header header;
+    return lock.isLocked() && readHeader(f, header) ? header.entry_count : 0;
+}
+
+}  // namespace detail
+}  // namespace flamegpu
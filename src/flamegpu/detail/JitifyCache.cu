@@ -3,16 +3,24 @@
 #include <nvrtc.h>
 
 #include <cassert>
+#include <cstring>
+#include <fstream>
 #include <regex>
 #include <array>
 #include <filesystem>
 #include <vector>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <utility>
 
 #include "flamegpu/version.h"
 #include "flamegpu/exception/FLAMEGPUException.h"
 #include "flamegpu/detail/compute_capability.cuh"
+#include "flamegpu/detail/philox.cuh"
+#include "flamegpu/detail/DiskCache.h"
+#include "flamegpu/detail/ThreadPool.h"
 #include "flamegpu/util/nvtx.h"
 
 using jitify::detail::hash_combine;
@@ -27,6 +35,9 @@ namespace {
  * Defined here to avoid filesystem includes being in header
  */
 std::filesystem::path getTMP() {
+    // Kernels may be loaded from multiple compile threads concurrently
+    static std::mutex tmp_mutex;
+    std::lock_guard<std::mutex> lock(tmp_mutex);
     static std::filesystem::path result;
     if (result.empty()) {
         std::filesystem::path tmp =  std::getenv("FLAMEGPU_TMP_DIR") ? std::getenv("FLAMEGPU_TMP_DIR") : std::filesystem::temp_directory_path();
@@ -58,6 +69,8 @@ std::filesystem::path getTMP() {
  * Returns the user-defined include directories
  */
 std::vector<std::filesystem::path> getIncludeDirs() {
+    static std::mutex include_dirs_mutex;
+    std::lock_guard<std::mutex> lock(include_dirs_mutex);
     static std::vector<std::filesystem::path> rtn;
     if (rtn.empty()) {
         if (std::getenv("FLAMEGPU_RTC_INCLUDE_DIRS")) {
@@ -83,22 +96,6 @@ std::vector<std::filesystem::path> getIncludeDirs() {
     }
     return rtn;
 }
-std::string loadFile(const std::filesystem::path &filepath) {
-    std::ifstream ifs;
-    ifs.open(filepath, std::ifstream::binary);
-    if (!ifs)
-    return "";
-    // get length of file
-    ifs.seekg(0, ifs.end);
-    const std::streamoff length = ifs.tellg();
-    ifs.seekg(0, ifs.beg);
-    std::string rtn;
-    rtn.resize(length);
-    char *buffer = &rtn[0];
-    ifs.read(buffer, length);
-    ifs.close();
-    return rtn;
-}
 
 /**
  * Find the cuda include directory.
@@ -260,6 +257,8 @@ std::string getGLMIncludeDir() {
  * @return boolean indicator of success.
  */
 bool confirmFLAMEGPUHeaderVersion(const std::string &flamegpuIncludeDir, const std::string &envVariable) {
+    static std::mutex header_version_mutex;
+    std::lock_guard<std::mutex> lock(header_version_mutex);
     static bool header_version_confirmed = false;
 
     if (!header_version_confirmed) {
@@ -306,11 +305,36 @@ bool confirmFLAMEGPUHeaderVersion(const std::string &flamegpuIncludeDir, const s
     }
     return header_version_confirmed;
 }
+/**
+ * Identifies RTC kernel bundle files
+ */
+constexpr char BUNDLE_MAGIC[8] = { 'F', 'G', 'P', 'U', 'R', 'T', 'C', 'B' };
+/**
+ * Bundle format version, incremented whenever the layout changes
+ */
+constexpr uint32_t BUNDLE_VERSION = 1;
+/**
+ * Written in native byte order, so that bundles from a machine of differing endianness can be detected
+ */
+constexpr uint32_t BUNDLE_BYTE_ORDER_MARK = 0x01020304;
+void writeBundleString(std::ofstream &out, const std::string &str) {
+    const uint64_t length = str.size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(uint64_t));
+    out.write(str.data(), str.size());
+}
+bool readBundleString(std::ifstream &in, const uint64_t remaining, std::string &str) {
+    uint64_t length = 0;
+    if (!in.read(reinterpret_cast<char*>(&length), sizeof(uint64_t)) || length > remaining) {
+        return false;
+    }
+    str.resize(length);
+    return static_cast<bool>(in.read(&str[0], length));
+}
 
 }  // namespace
 
 std::mutex JitifyCache::instance_mutex;
-std::unique_ptr<jitify::experimental::KernelInstantiation> JitifyCache::compileKernel(const std::string &func_name, const std::vector<std::string> &template_args, const std::string &kernel_src, const std::string &dynamic_header) {
+std::unique_ptr<jitify::experimental::KernelInstantiation> JitifyCache::compileKernel(const std::string &func_name, const std::vector<std::string> &template_args, const std::string &kernel_src, const std::string &dynamic_header, const int device_arch) {
     flamegpu::util::nvtx::Range range{"JitifyCache::compileKernel"};
     // find and validate the cuda include directory via CUDA_PATH or CUDA_HOME.
     static const std::string cuda_include_dir = getCUDAIncludeDir();
@@ -343,22 +367,11 @@ std::unique_ptr<jitify::experimental::KernelInstantiation> JitifyCache::compileK
     }
 #endif
 
-    // Forward the curand Engine request
-#if defined(FLAMEGPU_CURAND_MRG32k3a)
-    options.push_back(std::string("-DFLAMEGPU_CURAND_MRG32k3a"));
-#elif defined(FLAMEGPU_CURAND_Philox4_32_10)
-    options.push_back(std::string("-DFLAMEGPU_CURAND_Philox4_32_10"));
-#elif defined(FLAMEGPU_CURAND_XORWOW)
-    options.push_back(std::string("-DFLAMEGPU_CURAND_XORWOW"));
-#endif
-
     // Set the cuda compuate capability architecture to optimize / generate for, based on the values supported by the current dynamiclaly linked nvrtc and the device in question.
     std::vector<int> nvrtcArchitectures = detail::compute_capability::getNVRTCSupportedComputeCapabilties();
     if (nvrtcArchitectures.size()) {
-        int currentDeviceIdx = 0;
-        if (cudaSuccess == cudaGetDevice(&currentDeviceIdx)) {
-            int arch = compute_capability::getComputeCapability(currentDeviceIdx);
-            int maxSupportedArch = compute_capability::selectAppropraiteComputeCapability(arch, nvrtcArchitectures);
+        if (device_arch) {
+            int maxSupportedArch = compute_capability::selectAppropraiteComputeCapability(device_arch, nvrtcArchitectures);
             // only set a nvrtc compilation flag if a usable value was found
             if (maxSupportedArch != 0) {
                 options.push_back(std::string("--gpu-architecture=compute_" + std::to_string(maxSupportedArch)));
@@ -439,21 +452,6 @@ void JitifyCache::getKnownHeaders(std::vector<std::string>& headers) {
     headers.push_back("cstdint");
     headers.push_back("cstring");
     headers.push_back("cuda_runtime.h");
-    headers.push_back("curand.h");
-    headers.push_back("curand_discrete.h");
-    headers.push_back("curand_discrete2.h");
-    headers.push_back("curand_globals.h");
-    headers.push_back("curand_kernel.h");
-    headers.push_back("curand_lognormal.h");
-    headers.push_back("curand_mrg32k3a.h");
-    headers.push_back("curand_mtgp32.h");
-    headers.push_back("curand_mtgp32_kernel.h");
-    headers.push_back("curand_normal.h");
-    headers.push_back("curand_normal_static.h");
-    headers.push_back("curand_philox4x32_x.h");
-    headers.push_back("curand_poisson.h");
-    headers.push_back("curand_precalc.h");
-    headers.push_back("curand_uniform.h");
     headers.push_back("device_launch_parameters.h");
     // headers.push_back("dynamic/curve_rtc_dynamic.h");  // This is already included with source, having this makes a vague compile err
     headers.push_back("flamegpu/defines.h");
@@ -483,6 +481,7 @@ void JitifyCache::getKnownHeaders(std::vector<std::string>& headers) {
     headers.push_back("flamegpu/runtime/random/AgentRandom.cuh");
     headers.push_back("flamegpu/runtime/environment/DeviceEnvironment.cuh");
     headers.push_back("flamegpu/runtime/environment/DeviceMacroProperty.cuh");
+    headers.push_back("flamegpu/detail/philox.cuh");
     headers.push_back("flamegpu/detail/StaticAssert.h");
     headers.push_back("flamegpu/detail/type_decode.h");
     // headers.push_back("jitify_preinclude.h");  // I think Jitify adds this itself
@@ -502,19 +501,33 @@ void JitifyCache::getKnownHeaders(std::vector<std::string>& headers) {
 
 std::unique_ptr<jitify::experimental::KernelInstantiation> JitifyCache::loadKernel(const std::string &func_name, const std::vector<std::string> &template_args, const std::string &kernel_src, const std::string &dynamic_header) {
     flamegpu::util::nvtx::Range range{"JitifyCache::loadKernel"};
-    std::lock_guard<std::mutex> lock(cache_mutex);
+    return loadKernelAsync(func_name, template_args, kernel_src, dynamic_header).get();
+}
+std::future<std::unique_ptr<jitify::experimental::KernelInstantiation>> JitifyCache::loadKernelAsync(const std::string &func_name, const std::vector<std::string> &template_args, const std::string &kernel_src, const std::string &dynamic_header) {
+    flamegpu::util::nvtx::Range range{"JitifyCache::loadKernelAsync"};
+    std::string short_reference, long_reference;
+    std::shared_future<std::string> serialised_kernelinst = loadSerialisedKernelAsync(func_name, template_args, kernel_src, dynamic_header, short_reference, long_reference);
+    // Each caller receives their own instance, deserialised when the future is waited on
+    return std::async(std::launch::deferred, [serialised_kernelinst]() {
+        return std::make_unique<jitify::experimental::KernelInstantiation>(jitify::experimental::KernelInstantiation::deserialize(serialised_kernelinst.get()));
+    });
+}
+std::shared_future<std::string> JitifyCache::loadSerialisedKernelAsync(const std::string &func_name, const std::vector<std::string> &template_args, const std::string &kernel_src, const std::string &dynamic_header,
+    std::string &short_reference, std::string &long_reference) {
     // Detect current compute capability=
     int currentDeviceIdx = 0;
     cudaError_t status = cudaGetDevice(&currentDeviceIdx);
-    const std::string arch = std::to_string((status == cudaSuccess) ? compute_capability::getComputeCapability(currentDeviceIdx) : 0);
+    // Compilation occurs on a worker thread, so the compute capability must be detected on the calling thread
+    const int device_arch = (status == cudaSuccess) ? compute_capability::getComputeCapability(currentDeviceIdx) : 0;
+    const std::string arch = std::to_string(device_arch);
     status = cudaRuntimeGetVersion(&currentDeviceIdx);
     const std::string cuda_version = std::to_string((status == cudaSuccess) ? currentDeviceIdx : 0);
     const std::string seatbelts = std::to_string(FLAMEGPU_SEATBELTS);
     // Cat kernel, dynamic header, header version
-    const std::string long_reference = kernel_src + dynamic_header;  // Don't need to include rest, they are explicit in short reference/filename
+    long_reference = kernel_src + dynamic_header;  // Don't need to include rest, they are explicit in short reference/filename
     // Generate short reference string
     // Would prefer to use a proper hash, e.g. md5(reference_string), but that requires extra dependencies
-    const std::string short_reference =
+    short_reference =
         cuda_version + "_" +
         arch + "_" +
         seatbelts + "_" +
@@ -522,66 +535,179 @@ std::unique_ptr<jitify::experimental::KernelInstantiation> JitifyCache::loadKern
 #ifdef FLAMEGPU_USE_GLM
         "glm_" +
 #endif
-#if defined(FLAMEGPU_CURAND_MRG32k3a)
-        "MRG_" +
-#elif defined(FLAMEGPU_CURAND_Philox4_32_10)
-        "PHILOX_" +
-#elif defined(FLAMEGPU_CURAND_XORWOW)
-        "XORWOW_" +
-#endif
+        // Kernels embed the random number generator, so must be recompiled if its output changes
+        "philox" + std::to_string(detail::Philox::VERSION) + "_" +
         // Use jitify hash methods for consistent hashing between OSs
         std::to_string(hash_combine(hash_larson64(kernel_src.c_str()), hash_larson64(dynamic_header.c_str())));
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    // Has a copy with the right reference been preloaded from a bundle?
+    {
+        const auto it = bundle.find(short_reference);
+        if (it != bundle.end() && it->second.long_reference == long_reference) {
+            std::promise<std::string> p;
+            p.set_value(it->second.serialised_kernelinst);
+            return p.get_future().share();
+        }
+    }
     // Does a copy with the right reference exist in memory?
     if (use_memory_cache) {
         const auto it = cache.find(short_reference);
         if (it != cache.end()) {
             // Check long reference
             if (it->second.long_reference == long_reference) {
-                return std::make_unique<jitify::experimental::KernelInstantiation>(jitify::experimental::KernelInstantiation::deserialize(it->second.serialised_kernelinst));
+                std::promise<std::string> p;
+                p.set_value(it->second.serialised_kernelinst);
+                return p.get_future().share();
             }
         }
     }
-    // Does a copy with the right reference exist on disk?
-    const std::filesystem::path cache_file = getTMP() / short_reference;
-    const std::filesystem::path reference_file = cache_file.parent_path() / std::filesystem::path(cache_file.filename().string() + ".ref");
-    if (use_disk_cache && std::filesystem::exists(cache_file)) {
-        // Load the long reference for the cache file
-        const std::string file_long_reference = loadFile(reference_file);
-        if (file_long_reference == long_reference) {
-            // Load the cache file
-            const std::string serialised_kernelinst = loadFile(cache_file);
-            if (!serialised_kernelinst.empty()) {
-                // Add it to cache for later loads
-                cache.emplace(short_reference, CachedProgram{long_reference, serialised_kernelinst});
-                // Deserialize and return program
-                return std::make_unique<jitify::experimental::KernelInstantiation>(jitify::experimental::KernelInstantiation::deserialize(serialised_kernelinst));
+    // Is an identical kernel already being loaded?
+    const auto it = in_flight.find(short_reference);
+    if (it != in_flight.end() && it->second.long_reference == long_reference) {
+        return it->second.serialised_kernelinst;
+    }
+    // Kernel has not yet been cached, so load it from disk or build it on the compile pool
+    const bool memory_cache = use_memory_cache;
+    DiskCache *const disk_cache = use_disk_cache ? &getDiskCache() : nullptr;
+    // Only one request per short reference is tracked, in the unlikely case of a hash collision the second will not be shared
+    const bool track = it == in_flight.end();
+    std::shared_future<std::string> serialised_kernelinst = getCompilePool().submit([this, func_name, template_args, kernel_src, dynamic_header, device_arch, long_reference = long_reference, short_reference = short_reference, memory_cache, disk_cache, track]() {
+        std::string rtn;
+        try {
+            // Does a copy with the right reference exist on disk?
+            if (!disk_cache || !disk_cache->load(short_reference, long_reference, rtn)) {
+                // Build kernel
+                rtn = compileKernel(func_name, template_args, kernel_src, dynamic_header, device_arch)->serialize();
+                ++compile_count;
+                // Save it to disk
+                if (disk_cache) {
+                    disk_cache->store(short_reference, long_reference, rtn);
+                }
+            }
+        } catch (...) {
+            // Failed requests are not retained, so that the kernel can be requested again
+            if (track) {
+                std::lock_guard<std::mutex> lock(cache_mutex);
+                in_flight.erase(short_reference);
             }
+            throw;
         }
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        // Add it to cache for later loads
+        if (memory_cache) {
+            cache.emplace(short_reference, CachedProgram{long_reference, rtn});
+        }
+        if (track) {
+            in_flight.erase(short_reference);
+        }
+        return rtn;
+    }).share();
+    if (track) {
+        in_flight.emplace(short_reference, InFlightProgram{long_reference, serialised_kernelinst});
+    }
+    return serialised_kernelinst;
+}
+void JitifyCache::exportBundle(const std::string &filepath, const std::vector<KernelSource> &kernels) {
+    flamegpu::util::nvtx::Range range{"JitifyCache::exportBundle"};
+    // Kernels are loaded concurrently, then written in the order they were listed
+    struct Entry {
+        std::string short_reference;
+        std::string long_reference;
+        std::shared_future<std::string> serialised_kernelinst;
+    };
+    std::vector<Entry> entries;
+    std::set<std::pair<std::string, std::string>> written;
+    for (const auto &k : kernels) {
+        Entry e;
+        e.serialised_kernelinst = loadSerialisedKernelAsync(k.func_name, k.template_args, k.kernel_src, k.dynamic_header, e.short_reference, e.long_reference);
+        if (written.emplace(e.short_reference, e.long_reference).second) {
+            entries.push_back(std::move(e));
+        }
+    }
+    // Rethrows any compilation errors, before the file is created
+    for (auto &e : entries) {
+        e.serialised_kernelinst.get();
+    }
+    std::ofstream out(filepath, std::ofstream::binary | std::ofstream::trunc);
+    if (!out.is_open()) {
+        THROW exception::InvalidFilePath("Unable to open file '%s' for writing, in JitifyCache::exportBundle().", filepath.c_str());
     }
-    // Kernel has not yet been cached
+    const uint64_t entry_count = entries.size();
+    out.write(BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    out.write(reinterpret_cast<const char*>(&BUNDLE_VERSION), sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(&BUNDLE_BYTE_ORDER_MARK), sizeof(uint32_t));
+    writeBundleString(out, flamegpu::VERSION_FULL);
+    out.write(reinterpret_cast<const char*>(&entry_count), sizeof(uint64_t));
+    for (const auto &e : entries) {
+        writeBundleString(out, e.short_reference);
+        writeBundleString(out, e.long_reference);
+        writeBundleString(out, e.serialised_kernelinst.get());
+    }
+    if (!out) {
+        THROW exception::InvalidFilePath("Failed whilst writing to file '%s', in JitifyCache::exportBundle().", filepath.c_str());
+    }
+}
+unsigned int JitifyCache::loadBundle(const std::string &filepath) {
+    flamegpu::util::nvtx::Range range{"JitifyCache::loadBundle"};
+    const std::string canonical_path = std::filesystem::weakly_canonical(filepath).string();
     {
-        // Build kernel
-        auto kernelinst = compileKernel(func_name, template_args, kernel_src, dynamic_header);
-        // Add it to cache for later loads
-        const std::string serialised_kernelinst = use_memory_cache || use_disk_cache ? kernelinst->serialize() : "";
-        if (use_memory_cache) {
-            cache.emplace(short_reference, CachedProgram{long_reference, serialised_kernelinst});
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (loaded_bundles.find(canonical_path) != loaded_bundles.end()) {
+            return 0;
         }
-        // Save it to disk
-        if (use_disk_cache) {
-            std::ofstream ofs(cache_file, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
-            if (ofs) {
-                ofs << serialised_kernelinst;
-                ofs.close();
-            }
-            ofs = std::ofstream(reference_file, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
-            if (ofs) {
-                ofs << long_reference;
-                ofs.close();
-            }
+    }
+    std::ifstream in(filepath, std::ifstream::binary);
+    if (!in.is_open()) {
+        THROW exception::InvalidFilePath("Unable to open file '%s' for reading, in JitifyCache::loadBundle().", filepath.c_str());
+    }
+    in.seekg(0, std::ifstream::end);
+    const uint64_t file_length = static_cast<uint64_t>(in.tellg());
+    in.seekg(0, std::ifstream::beg);
+    char magic[sizeof(BUNDLE_MAGIC)] = {};
+    uint32_t version = 0, byte_order_mark = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+    in.read(reinterpret_cast<char*>(&byte_order_mark), sizeof(uint32_t));
+    if (!in || memcmp(magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0) {
+        THROW exception::InvalidInputFile("File '%s' is not a RTC kernel bundle, in JitifyCache::loadBundle().", filepath.c_str());
+    } else if (version != BUNDLE_VERSION) {
+        THROW exception::InvalidInputFile("RTC kernel bundle '%s' has version %u, only version %u is supported, in JitifyCache::loadBundle().", filepath.c_str(), version, BUNDLE_VERSION);
+    } else if (byte_order_mark != BUNDLE_BYTE_ORDER_MARK) {
+        THROW exception::InvalidInputFile("RTC kernel bundle '%s' was created on a machine of differing endianness, in JitifyCache::loadBundle().", filepath.c_str());
+    }
+    std::string bundle_version;
+    uint64_t entry_count = 0;
+    if (!readBundleString(in, file_length, bundle_version) || !in.read(reinterpret_cast<char*>(&entry_count), sizeof(uint64_t))) {
+        THROW exception::InvalidInputFile("RTC kernel bundle '%s' is truncated, in JitifyCache::loadBundle().", filepath.c_str());
+    } else if (bundle_version != flamegpu::VERSION_FULL) {
+        THROW exception::InvalidInputFile("RTC kernel bundle '%s' was created by FLAMEGPU %s, which does not match this version (%s), in JitifyCache::loadBundle().",
+            filepath.c_str(), bundle_version.c_str(), flamegpu::VERSION_FULL);
+    }
+    std::map<std::string, CachedProgram> entries;
+    for (uint64_t i = 0; i < entry_count; ++i) {
+        std::string short_reference;
+        CachedProgram program;
+        if (!readBundleString(in, file_length, short_reference) ||
+            !readBundleString(in, file_length, program.long_reference) ||
+            !readBundleString(in, file_length, program.serialised_kernelinst)) {
+            THROW exception::InvalidInputFile("RTC kernel bundle '%s' is truncated, in JitifyCache::loadBundle().", filepath.c_str());
         }
-        return kernelinst;
+        entries[short_reference] = std::move(program);
+    }
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    for (auto &e : entries) {
+        bundle[e.first] = std::move(e.second);
     }
+    loaded_bundles.insert(canonical_path);
+    return static_cast<unsigned int>(entries.size());
+}
+void JitifyCache::clearBundles() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    bundle.clear();
+    loaded_bundles.clear();
+}
+uint64_t JitifyCache::getCompileCount() const {
+    return compile_count;
 }
 void JitifyCache::useMemoryCache(bool yesno) {
     std::lock_guard<std::mutex> lock(cache_mutex);
@@ -599,25 +725,76 @@ bool JitifyCache::useDiskCache() const {
     std::lock_guard<std::mutex> lock(cache_mutex);
     return use_disk_cache;
 }
+void JitifyCache::setCompileThreadCount(const unsigned int count) {
+    std::unique_ptr<ThreadPool> old_pool;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (count == compile_thread_count)
+            return;
+        compile_thread_count = count;
+        old_pool = std::move(compile_pool);
+    }
+    // The old pool completes its queued kernels as it is destroyed, these require cache_mutex
+}
+unsigned int JitifyCache::getCompileThreadCount() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return compile_thread_count;
+}
+ThreadPool &JitifyCache::getCompilePool() {
+    if (!compile_pool) {
+        compile_pool = std::make_unique<ThreadPool>(compile_thread_count);
+    }
+    return *compile_pool;
+}
+DiskCache &JitifyCache::getDiskCache() {
+    if (!disk_cache_store) {
+        disk_cache_store = std::make_unique<DiskCache>(getTMP().string(), disk_cache_size_limit);
+    }
+    return *disk_cache_store;
+}
+void JitifyCache::setDiskCacheSizeLimit(const uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    disk_cache_size_limit = bytes;
+    if (disk_cache_store) {
+        disk_cache_store->setSizeLimit(bytes);
+    }
+}
+uint64_t JitifyCache::getDiskCacheSizeLimit() const {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return disk_cache_size_limit;
+}
 void JitifyCache::clearMemoryCache() {
     std::lock_guard<std::mutex> lock(cache_mutex);
     cache.clear();
 }
 void JitifyCache::clearDiskCache() {
     const std::filesystem::path tmp_dir = getTMP();
+    // Remove any cache files written by older versions, the lock file must remain as other processes may hold it
     for (const auto & entry : std::filesystem::directory_iterator(tmp_dir)) {
-        if (std::filesystem::is_regular_file(entry.path())) {
+        const std::string filename = entry.path().filename().string();
+        if (std::filesystem::is_regular_file(entry.path()) && filename != DiskCache::STORE_FILE && filename != DiskCache::LOCK_FILE) {
             remove(entry.path());
         }
     }
+    DiskCache(tmp_dir.string()).clear();
 }
 JitifyCache::JitifyCache()
     : use_memory_cache(true)
 #ifndef FLAMEGPU_DISABLE_RTC_DISK_CACHE
-    , use_disk_cache(true) { }
+    , use_disk_cache(true)
 #else
-    , use_disk_cache(false) { }
+    , use_disk_cache(false)
 #endif
+    , compile_thread_count(0)
+    , disk_cache_size_limit(DiskCache::DEFAULT_SIZE_LIMIT) { }
+JitifyCache::~JitifyCache() {
+    // Destroy the pool before the caches, as queued kernels may still add themselves to them
+    std::unique_ptr<ThreadPool> old_pool;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        old_pool = std::move(compile_pool);
+    }
+}
 JitifyCache& JitifyCache::getInstance() {
     auto lock = std::unique_lock<std::mutex>(instance_mutex);  // Mutex to protect from two threads triggering the static instantiation concurrently
     static JitifyCache instance;  // Instantiated on first use.
@@ -0,0 +1,172 @@
+#include "flamegpu/detail/ThreadPool.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace flamegpu {
+namespace detail {
+
+namespace {
+// Identify which pool (if any) the calling thread is a worker of, so tasks submitted by a worker are placed on its own queue
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local unsigned int current_worker = UINT_MAX;
+}  // anonymous namespace
+
+ThreadPool::ThreadPool(const unsigned int thread_count)
+    : pending_tasks(0)
+    , next_queue(0)
+    , stopping(false) {
+    const unsigned int t_count = thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    queues.reserve(t_count);
+    for (unsigned int i = 0; i < t_count; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers.reserve(t_count);
+    for (unsigned int i = 0; i < t_count; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    sleep_cv.notify_all();
+    for (auto &w : workers) {
+        if (w.joinable())
+            w.join();
+    }
+}
+
+unsigned int ThreadPool::currentWorkerIndex() const {
+    return current_pool == this ? current_worker : UINT_MAX;
+}
+
+void ThreadPool::enqueue(Task &&task) {
+    unsigned int index = currentWorkerIndex();
+    if (index == UINT_MAX) {
+        index = next_queue++ % static_cast<unsigned int>(queues.size());
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        // Counter is modified under the queue lock, so it never under-runs
+        ++pending_tasks;
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    // Acquire the sleep mutex, so the notification cannot arrive between a worker checking pending_tasks and sleeping
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    sleep_cv.notify_one();
+}
+
+bool ThreadPool::dequeue(const unsigned int home, Task &out) {
+    if (!pending_tasks.load())
+        return false;
+    const unsigned int queue_count = static_cast<unsigned int>(queues.size());
+    // Check our own queue first, taking the most recently queued task
+    {
+        WorkerQueue &q = *queues[home % queue_count];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            out = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            --pending_tasks;
+            return true;
+        }
+    }
+    // Otherwise steal the oldest task from another queue
+    for (unsigned int i = 1; i < queue_count; ++i) {
+        WorkerQueue &q = *queues[(home + i) % queue_count];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            out = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            --pending_tasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    if (queues.empty())
+        return false;
+    unsigned int home = currentWorkerIndex();
+    if (home == UINT_MAX)
+        home = next_queue.load();
+    Task t;
+    if (dequeue(home, t)) {
+        t();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(const unsigned int index) {
+    current_pool = this;
+    current_worker = index;
+    Task t;
+    while (true) {
+        if (dequeue(index, t)) {
+            t();
+            t = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_cv.wait(lock, [this]() { return stopping || pending_tasks.load() > 0; });
+        // Only exit once all outstanding work has been completed
+        if (stopping && !pending_tasks.load())
+            return;
+    }
+}
+
+void ThreadPool::parallelFor(const size_t begin, const size_t end, size_t grain, const std::function<void(size_t, size_t)> &body) {
+    if (end <= begin)
+        return;
+    const size_t len = end - begin;
+    if (!grain) {
+        // Default to ~4 chunks per thread (including the caller), to give room for load balancing
+        grain = std::max<size_t>(1, len / (4 * (workers.size() + 1)));
+    }
+    const size_t chunk_count = (len + grain - 1) / grain;
+    if (workers.empty() || chunk_count == 1) {
+        body(begin, end);
+        return;
+    }
+    struct State {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining = chunk_count;
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain) {
+        const size_t chunk_end = std::min(end, chunk_begin + grain);
+        // body is captured by reference, this method does not return until all chunks have completed
+        enqueue([state, &body, chunk_begin, chunk_end]() {
+            try {
+                body(chunk_begin, chunk_end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error)
+                    state->error = std::current_exception();
+            }
+            if (--state->remaining == 0) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        });
+    }
+    // Contribute to the work, until there is nothing left to steal
+    while (state->remaining.load() && runPendingTask()) { }
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [&state]() { return state->remaining.load() == 0; });
+    }
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+}  // namespace detail
+}  // namespace flamegpu
@@ -0,0 +1,276 @@
+#include "flamegpu/io/BinaryGraphReader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include "flamegpu/exception/FLAMEGPUException.h"
+#include "flamegpu/io/BinaryGraphWriter.h"
+#include "flamegpu/io/BinaryLogger.h"
+#include "flamegpu/simulation/detail/CUDAEnvironmentDirectedGraphBuffers.cuh"
+
+namespace flamegpu {
+namespace io {
+
+namespace {
+/**
+ * Provides random access to the bytes of a binary graph, regardless of whether it is held in a file or a buffer
+ */
+class GraphSource {
+ public:
+    virtual ~GraphSource() = default;
+    /**
+     * Copies length bytes starting at offset into dest
+     * @throws exception::InvalidInputFile If the requested range exceeds the bounds of the source
+     */
+    void read(const uint64_t offset, void *dest, const uint64_t length) {
+        if (offset > size || length > size - offset) {
+            THROW exception::InvalidInputFile("Binary graph '%s' is truncated, in BinaryGraphReader::loadCSR()\n", name.c_str());
+        }
+        if (length) {
+            readImpl(offset, static_cast<char*>(dest), length);
+        }
+    }
+    const std::string name;
+    const uint64_t size;
+
+ protected:
+    GraphSource(const std::string &_name, const uint64_t _size)
+        : name(_name)
+        , size(_size) { }
+    virtual void readImpl(uint64_t offset, char *dest, uint64_t length) = 0;
+};
+class FileSource : public GraphSource {
+ public:
+    FileSource(const std::string &path, std::ifstream &&_in, const uint64_t _size)
+        : GraphSource(path, _size)
+        , in(std::move(_in)) { }
+
+ protected:
+    void readImpl(const uint64_t offset, char *dest, const uint64_t length) override {
+        in.seekg(offset);
+        if (!in.read(dest, length)) {
+            THROW exception::InvalidFilePath("Unable to read file '%s', in BinaryGraphReader::loadCSR()\n", name.c_str());
+        }
+    }
+
+ private:
+    std::ifstream in;
+};
+class BufferSource : public GraphSource {
+ public:
+    BufferSource(const void *_data, const uint64_t _size)
+        : GraphSource("buffer", _size)
+        , data(static_cast<const char*>(_data)) { }
+
+ protected:
+    void readImpl(const uint64_t offset, char *dest, const uint64_t length) override {
+        memcpy(dest, data + offset, length);
+    }
+
+ private:
+    const char *data;
+};
+/**
+ * Reads sequential values from a region of memory, with bounds checking
+ */
+class Cursor {
+ public:
+    Cursor(const std::string &_name, const std::vector<char> &_data, const size_t _offset)
+        : name(_name)
+        , data(_data)
+        , offset(_offset) { }
+    template<typename T>
+    T read() {
+        T rtn;
+        memcpy(&rtn, take(sizeof(T)), sizeof(T));
+        return rtn;
+    }
+    std::string readString() {
+        const uint32_t length = read<uint32_t>();
+        return std::string(take(length), length);
+    }
+
+ private:
+    const char *take(const size_t length) {
+        if (length > data.size() - offset) {
+            THROW exception::InvalidInputFile("Binary graph '%s' has a corrupt property table, in BinaryGraphReader::loadCSR()\n", name.c_str());
+        }
+        const char *rtn = data.data() + offset;
+        offset += length;
+        return rtn;
+    }
+    const std::string &name;
+    const std::vector<char> &data;
+    size_t offset;
+};
+/**
+ * A property column stored within a binary graph
+ */
+struct Column {
+    std::string name;
+    BinaryLogger::ColumnType type;
+    uint32_t elements;
+    uint64_t offset;
+};
+template<typename T>
+char *getPropertyBuffer(detail::CUDAEnvironmentDirectedGraphBuffers &directed_graph, const bool is_vertex, const std::string &property_name, cudaStream_t stream) {
+    size_type N = 0;
+    return reinterpret_cast<char*>(is_vertex
+        ? directed_graph.getVertexPropertyBuffer<T>(property_name, N, stream)
+        : directed_graph.getEdgePropertyBuffer<T>(property_name, N, stream));
+}
+/**
+ * Returns the host buffer of the named vertex or edge property as raw bytes, the buffer is marked as changed on the host
+ */
+char *getPropertyBuffer(detail::CUDAEnvironmentDirectedGraphBuffers &directed_graph, const bool is_vertex, const std::string &property_name, const BinaryLogger::ColumnType type, cudaStream_t stream) {
+    switch (type) {
+    case BinaryLogger::Float: return getPropertyBuffer<float>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::Double: return getPropertyBuffer<double>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::Int64: return getPropertyBuffer<int64_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::UInt64: return getPropertyBuffer<uint64_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::Int32: return getPropertyBuffer<int32_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::UInt32: return getPropertyBuffer<uint32_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::Int16: return getPropertyBuffer<int16_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::UInt16: return getPropertyBuffer<uint16_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::Int8: return getPropertyBuffer<int8_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::UInt8: return getPropertyBuffer<uint8_t>(directed_graph, is_vertex, property_name, stream);
+    case BinaryLogger::Char: return getPropertyBuffer<char>(directed_graph, is_vertex, property_name, stream);
+    }
+    THROW exception::UnsupportedVarType("Unknown column type %u, in BinaryGraphReader::loadCSR()\n", static_cast<unsigned int>(type));
+}
+/**
+ * Copies each property column which matches a property of the graph directly into the graph's host buffer
+ */
+void readProperties(GraphSource &source, const std::vector<Column> &columns, const bool is_vertex, const unsigned int count,
+    const std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream) {
+    const EnvironmentDirectedGraphData &metagraph = directed_graph->getDescription();
+    const auto &properties = is_vertex ? metagraph.vertexProperties : metagraph.edgeProperties;
+    for (const auto &c : columns) {
+        const auto f = properties.find(c.name);
+        if (f == properties.end()) {
+            fprintf(stderr, "Input file '%s' contains unexpected %s property '%s', skipped during parse.\n", source.name.c_str(), is_vertex ? "vertex" : "edge", c.name.c_str());
+            continue;
+        } else if (BinaryLogger::toColumnType(f->second.type) != c.type || f->second.elements != c.elements) {
+            THROW exception::InvalidInputFile("Input file '%s' contains %s property '%s' of a differing type or length to the graph's description, in BinaryGraphReader::loadCSR()\n",
+                source.name.c_str(), is_vertex ? "vertex" : "edge", c.name.c_str());
+        }
+        if (count) {
+            source.read(c.offset, getPropertyBuffer(*directed_graph, is_vertex, c.name, c.type, stream), static_cast<uint64_t>(count) * f->second.type_size * f->second.elements);
+        }
+    }
+}
+void parseCSR(GraphSource &source, const std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream) {
+    // Header
+    char magic[sizeof(BinaryGraphWriter::MAGIC)];
+    uint32_t header[6];  // {version, byte_order_mark, vertex_count, edge_count, vertex_property_count, edge_property_count}
+    uint64_t csr_offsets[2];  // {row_offsets, column_indices}
+    source.read(0, magic, sizeof(magic));
+    if (memcmp(magic, BinaryGraphWriter::MAGIC, sizeof(magic)) != 0) {
+        THROW exception::InvalidInputFile("Input file '%s' is not a binary graph, in BinaryGraphReader::loadCSR()\n", source.name.c_str());
+    }
+    source.read(sizeof(magic), header, sizeof(header));
+    if (header[0] != BinaryGraphWriter::VERSION) {
+        THROW exception::InvalidInputFile("Binary graph '%s' has version %u, but only version %u is supported, in BinaryGraphReader::loadCSR()\n",
+            source.name.c_str(), header[0], BinaryGraphWriter::VERSION);
+    } else if (header[1] != BinaryGraphWriter::BYTE_ORDER_MARK) {
+        THROW exception::InvalidInputFile("Binary graph '%s' was written by a host of differing byte order, in BinaryGraphReader::loadCSR()\n", source.name.c_str());
+    }
+    source.read(sizeof(magic) + sizeof(header), csr_offsets, sizeof(csr_offsets));
+    const unsigned int vertex_count = header[2];
+    const unsigned int edge_count = header[3];
+    // Property table, this lies between the header and the first column
+    const uint64_t HEADER_LENGTH = sizeof(magic) + sizeof(header) + sizeof(csr_offsets);
+    if (csr_offsets[0] < HEADER_LENGTH || csr_offsets[0] > source.size) {
+        THROW exception::InvalidInputFile("Binary graph '%s' has a corrupt header, in BinaryGraphReader::loadCSR()\n", source.name.c_str());
+    }
+    std::vector<char> table(static_cast<size_t>(csr_offsets[0]));
+    source.read(0, table.data(), table.size());
+    Cursor cursor(source.name, table, HEADER_LENGTH);
+    std::vector<Column> vertex_columns, edge_columns;
+    for (uint32_t i = 0; i < header[4] + header[5]; ++i) {
+        Column c;
+        c.name = cursor.readString();
+        c.type = static_cast<BinaryLogger::ColumnType>(cursor.read<uint8_t>());
+        c.elements = cursor.read<uint32_t>();
+        c.offset = cursor.read<uint64_t>();
+        (i < header[4] ? vertex_columns : edge_columns).push_back(std::move(c));
+    }
+    // CSR
+    // The counts are untrusted, so the arrays must be known to lie within the source before they are allocated
+    const uint64_t row_offsets_length = (static_cast<uint64_t>(vertex_count) + 1) * sizeof(uint32_t);
+    const uint64_t column_indices_length = static_cast<uint64_t>(edge_count) * sizeof(uint32_t);
+    if (csr_offsets[1] > source.size || row_offsets_length > source.size - csr_offsets[0] || column_indices_length > source.size - csr_offsets[1]) {
+        THROW exception::InvalidInputFile("Binary graph '%s' is truncated, in BinaryGraphReader::loadCSR()\n", source.name.c_str());
+    }
+    std::vector<uint32_t> row_offsets(static_cast<size_t>(vertex_count) + 1);
+    std::vector<uint32_t> column_indices(edge_count);
+    source.read(csr_offsets[0], row_offsets.data(), row_offsets_length);
+    source.read(csr_offsets[1], column_indices.data(), column_indices_length);
+    // Row offsets index column_indices, so they must all be validated before any are used
+    bool valid_offsets = row_offsets[0] == 0 && row_offsets[vertex_count] == edge_count;
+    for (unsigned int v = 0; valid_offsets && v < vertex_count; ++v) {
+        valid_offsets = row_offsets[v] <= row_offsets[v + 1] && row_offsets[v + 1] <= edge_count;
+    }
+    if (!valid_offsets) {
+        THROW exception::InvalidInputFile("Binary graph '%s' has corrupt row offsets, in BinaryGraphReader::loadCSR()\n", source.name.c_str());
+    }
+    // (Pre)allocate the graph's buffers
+    directed_graph->setVertexCount(vertex_count, stream);
+    directed_graph->setEdgeCount(edge_count);
+    // Vertex IDs are read separately, as they must be registered with the graph
+    std::vector<id_t> vertex_ids(vertex_count);
+    bool has_ids = false;
+    for (auto c = vertex_columns.begin(); c != vertex_columns.end(); ++c) {
+        if (c->name == ID_VARIABLE_NAME) {
+            if (c->type != BinaryLogger::toColumnType(std::type_index(typeid(id_t))) || c->elements != 1) {
+                THROW exception::InvalidInputFile("Binary graph '%s' contains vertex IDs of an unexpected type, in BinaryGraphReader::loadCSR()\n", source.name.c_str());
+            }
+            source.read(c->offset, vertex_ids.data(), vertex_ids.size() * sizeof(id_t));
+            vertex_columns.erase(c);
+            has_ids = true;
+            break;
+        }
+    }
+    if (vertex_count && !has_ids) {
+        THROW exception::InvalidInputFile("Binary graph '%s' does not contain vertex IDs, in BinaryGraphReader::loadCSR()\n", source.name.c_str());
+    }
+    for (unsigned int i = 0; i < vertex_count; ++i) {
+        directed_graph->setVertexID(i, vertex_ids[i], stream);
+    }
+    readProperties(source, vertex_columns, true, vertex_count, directed_graph, stream);
+    // Edges are stored in CSR order
+    for (unsigned int v = 0; v < vertex_count; ++v) {
+        for (uint32_t e = row_offsets[v]; e < row_offsets[v + 1]; ++e) {
+            if (column_indices[e] >= vertex_count) {
+                THROW exception::InvalidInputFile("Binary graph '%s' contains an edge to vertex index %u, which exceeds the vertex count %u, in BinaryGraphReader::loadCSR()\n",
+                    source.name.c_str(), column_indices[e], vertex_count);
+            }
+            directed_graph->setEdgeSourceDestination(e, vertex_ids[v], vertex_ids[column_indices[e]]);
+        }
+    }
+    readProperties(source, edge_columns, false, edge_count, directed_graph, stream);
+}
+}  // namespace
+
+void BinaryGraphReader::loadCSR(const std::string &filepath, const std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream) {
+    std::ifstream in(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in) {
+        THROW exception::InvalidFilePath("Unable to open file '%s' for reading.\n", filepath.c_str());
+    }
+    const uint64_t size = static_cast<uint64_t>(in.tellg());
+    FileSource source(filepath, std::move(in), size);
+    parseCSR(source, directed_graph, stream);
+}
+void BinaryGraphReader::loadCSR(const void *data, const size_t length, const std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream) {
+    BufferSource source(data, length);
+    parseCSR(source, directed_graph, stream);
+}
+
+}  // namespace io
+}  // namespace flamegpu
@@ -0,0 +1,187 @@
+#include "flamegpu/io/BinaryGraphWriter.h"
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flamegpu/exception/FLAMEGPUException.h"
+#include "flamegpu/io/BinaryLogger.h"
+#include "flamegpu/simulation/detail/CUDAEnvironmentDirectedGraphBuffers.cuh"
+
+namespace flamegpu {
+namespace io {
+
+namespace {
+template<typename T>
+const char *getPropertyBuffer(const detail::CUDAEnvironmentDirectedGraphBuffers &directed_graph, const bool is_vertex, const std::string &property_name, cudaStream_t stream) {
+    size_type N = 0;
+    return reinterpret_cast<const char*>(is_vertex
+        ? directed_graph.getVertexPropertyBuffer<T>(property_name, N, stream)
+        : directed_graph.getEdgePropertyBuffer<T>(property_name, N, stream));
+}
+/**
+ * Returns the host buffer of the named vertex or edge property, as raw bytes
+ */
+const char *getPropertyBuffer(const detail::CUDAEnvironmentDirectedGraphBuffers &directed_graph, const bool is_vertex, const std::pair<const std::string, Variable> &property, cudaStream_t stream) {
+    switch (BinaryLogger::toColumnType(property.second.type)) {
+    case BinaryLogger::Float: return getPropertyBuffer<float>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::Double: return getPropertyBuffer<double>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::Int64: return getPropertyBuffer<int64_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::UInt64: return getPropertyBuffer<uint64_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::Int32: return getPropertyBuffer<int32_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::UInt32: return getPropertyBuffer<uint32_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::Int16: return getPropertyBuffer<int16_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::UInt16: return getPropertyBuffer<uint16_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::Int8: return getPropertyBuffer<int8_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::UInt8: return getPropertyBuffer<uint8_t>(directed_graph, is_vertex, property.first, stream);
+    case BinaryLogger::Char: return getPropertyBuffer<char>(directed_graph, is_vertex, property.first, stream);
+    }
+    THROW exception::UnsupportedVarType("Graph property '%s' has unsupported type '%s', in BinaryGraphWriter::saveCSR()\n",
+        property.first.c_str(), property.second.type.name());
+}
+uint64_t align8(const uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+template<typename T>
+void write(std::ofstream &out, const T &value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+void writeString(std::ofstream &out, const std::string &str) {
+    write(out, static_cast<uint32_t>(str.size()));
+    out.write(str.data(), str.size());
+}
+/**
+ * Pads the file with zeros until the write position is aligned to 8 bytes
+ */
+void pad(std::ofstream &out, uint64_t &offset) {
+    static const char zeros[8] = {};
+    const uint64_t aligned = align8(offset);
+    out.write(zeros, aligned - offset);
+    offset = aligned;
+}
+}  // namespace
+
+void BinaryGraphWriter::saveCSR(const std::string &filepath, const std::shared_ptr<const detail::CUDAEnvironmentDirectedGraphBuffers> &directed_graph, cudaStream_t stream) {
+    const EnvironmentDirectedGraphData &data = directed_graph->getDescription();
+    const unsigned int vertex_count = directed_graph->getVertexCount();
+    const unsigned int edge_count = directed_graph->getEdgeCount();
+    if (edge_count != directed_graph->getReadyEdgeCount()) {
+        THROW exception::IDNotSet("Unable to export graph, only %u/%u edges have been assigned both a source and destination, in BinaryGraphWriter::saveCSR()\n",
+            directed_graph->getReadyEdgeCount(), edge_count);
+    } else if (vertex_count != directed_graph->getReadyVertexCount()) {
+        THROW exception::IDNotSet("Unable to export graph, only %u/%u vertices have been assigned an ID, in BinaryGraphWriter::saveCSR()\n",
+            directed_graph->getReadyVertexCount(), vertex_count);
+    }
+    // Build the CSR, with a counting sort of edges by source vertex index
+    // csr_edges maps each position within the CSR to the edge index it was taken from
+    std::vector<uint32_t> row_offsets(vertex_count + 1, 0);
+    std::vector<uint32_t> column_indices(edge_count);
+    std::vector<unsigned int> csr_edges(edge_count);
+    bool csr_is_identity = true;
+    if (edge_count) {
+        size_type foo = 0;
+        const id_t *src_dest_buffer = directed_graph->getEdgePropertyBuffer<id_t>(GRAPH_SOURCE_DEST_VARIABLE_NAME, foo, stream);
+        std::vector<uint32_t> sources(edge_count);
+        for (unsigned int i = 0; i < edge_count; ++i) {
+            sources[i] = directed_graph->getVertexIndex(src_dest_buffer[i * 2 + 1]);
+            ++row_offsets[sources[i] + 1];
+        }
+        for (unsigned int i = 0; i < vertex_count; ++i) {
+            row_offsets[i + 1] += row_offsets[i];
+        }
+        std::vector<uint32_t> row_cursor(row_offsets.begin(), row_offsets.end() - 1);
+        for (unsigned int i = 0; i < edge_count; ++i) {
+            const uint32_t pos = row_cursor[sources[i]]++;
+            csr_edges[pos] = i;
+            column_indices[pos] = directed_graph->getVertexIndex(src_dest_buffer[i * 2 + 0]);
+            csr_is_identity &= pos == i;
+        }
+    }
+    // Select the columns to be written, and calculate the layout of the file
+    struct Column {
+        const std::pair<const std::string, Variable> *property;
+        bool is_vertex;
+        uint64_t offset;
+    };
+    std::vector<Column> columns;
+    uint64_t table_length = 0;
+    for (const auto &p : data.vertexProperties) {
+        columns.push_back({&p, true, 0});
+        table_length += sizeof(uint32_t) + p.first.size() + sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t);
+    }
+    const uint32_t vertex_property_count = static_cast<uint32_t>(columns.size());
+    for (const auto &p : data.edgeProperties) {
+        // Source/dest is implied by the CSR
+        if (p.first != GRAPH_SOURCE_DEST_VARIABLE_NAME) {
+            columns.push_back({&p, false, 0});
+            table_length += sizeof(uint32_t) + p.first.size() + sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t);
+        }
+    }
+    const uint32_t edge_property_count = static_cast<uint32_t>(columns.size()) - vertex_property_count;
+    constexpr uint64_t HEADER_LENGTH = sizeof(MAGIC) + 6 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+    const uint64_t row_offsets_offset = align8(HEADER_LENGTH + table_length);
+    const uint64_t column_indices_offset = align8(row_offsets_offset + row_offsets.size() * sizeof(uint32_t));
+    uint64_t data_end = align8(column_indices_offset + column_indices.size() * sizeof(uint32_t));
+    for (auto &c : columns) {
+        c.offset = data_end;
+        data_end = align8(data_end + static_cast<uint64_t>(c.is_vertex ? vertex_count : edge_count) * c.property->second.type_size * c.property->second.elements);
+    }
+    // Perform output
+    std::ofstream out(filepath, std::ofstream::binary | std::ofstream::trunc);
+    if (!out.is_open()) {
+        THROW exception::InvalidFilePath("Unable to open file '%s' for writing\n", filepath.c_str());
+    }
+    out.write(MAGIC, sizeof(MAGIC));
+    write(out, VERSION);
+    write(out, BYTE_ORDER_MARK);
+    write(out, static_cast<uint32_t>(vertex_count));
+    write(out, static_cast<uint32_t>(edge_count));
+    write(out, vertex_property_count);
+    write(out, edge_property_count);
+    write(out, row_offsets_offset);
+    write(out, column_indices_offset);
+    for (const auto &c : columns) {
+        writeString(out, c.property->first);
+        write(out, static_cast<uint8_t>(BinaryLogger::toColumnType(c.property->second.type)));
+        write(out, static_cast<uint32_t>(c.property->second.elements));
+        write(out, c.offset);
+    }
+    uint64_t offset = HEADER_LENGTH + table_length;
+    pad(out, offset);
+    out.write(reinterpret_cast<const char*>(row_offsets.data()), row_offsets.size() * sizeof(uint32_t));
+    offset += row_offsets.size() * sizeof(uint32_t);
+    pad(out, offset);
+    out.write(reinterpret_cast<const char*>(column_indices.data()), column_indices.size() * sizeof(uint32_t));
+    offset += column_indices.size() * sizeof(uint32_t);
+    pad(out, offset);
+    std::vector<char> reordered;
+    for (const auto &c : columns) {
+        const unsigned int count = c.is_vertex ? vertex_count : edge_count;
+        if (!count) {
+            continue;
+        }
+        const size_t element_length = c.property->second.type_size * c.property->second.elements;
+        const char *buffer = getPropertyBuffer(*directed_graph, c.is_vertex, *c.property, stream);
+        if (!c.is_vertex && !csr_is_identity) {
+            // Edges must be reordered to match the CSR
+            reordered.resize(edge_count * element_length);
+            for (unsigned int i = 0; i < edge_count; ++i) {
+                memcpy(reordered.data() + i * element_length, buffer + csr_edges[i] * element_length, element_length);
+            }
+            buffer = reordered.data();
+        }
+        out.write(buffer, count * element_length);
+        offset += count * element_length;
+        pad(out, offset);
+    }
+    if (!out) {
+        THROW exception::InvalidFilePath("Failed whilst writing to file '%s'\n", filepath.c_str());
+    }
+    out.close();
+}
+
+}  // namespace io
+}  // namespace flamegpu
@@ -0,0 +1,197 @@
+#include "flamegpu/io/BinaryLogReader.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace flamegpu {
+namespace io {
+
+namespace {
+/**
+ * Bounds checked sequential reader over a buffer
+ */
+class Cursor {
+ public:
+    Cursor(const char *_data, size_t _length, size_t _offset = 0)
+        : data(_data)
+        , length(_length)
+        , offset(_offset) { }
+    const char *take(size_t bytes) {
+        if (bytes > length || offset > length - bytes) {
+            THROW exception::InvalidInputFile("Binary log ends unexpectedly, in BinaryLogReader::BinaryLogReader()\n");
+        }
+        const char *rtn = data + offset;
+        offset += bytes;
+        return rtn;
+    }
+    template<typename T>
+    T read() {
+        T rtn;
+        memcpy(&rtn, take(sizeof(T)), sizeof(T));
+        return rtn;
+    }
+    std::string readString() {
+        const uint32_t len = read<uint32_t>();
+        return std::string(take(len), len);
+    }
+    void pad() { offset = (offset + 7) & ~static_cast<size_t>(7); }
+    size_t getOffset() const { return offset; }
+
+ private:
+    const char *data;
+    size_t length;
+    size_t offset;
+};
+BinaryLogger::ColumnType readColumnType(Cursor &cursor) {
+    const uint8_t type = cursor.read<uint8_t>();
+    if (type > BinaryLogger::Char) {
+        THROW exception::InvalidInputFile("Binary log contains unknown column type %u, in BinaryLogReader::BinaryLogReader()\n", static_cast<unsigned int>(type));
+    }
+    return static_cast<BinaryLogger::ColumnType>(type);
+}
+}  // namespace
+
+std::vector<std::string> BinaryLogReader::Table::getColumnNames() const {
+    std::vector<std::string> rtn;
+    rtn.reserve(columns.size());
+    for (const auto &c : columns) {
+        rtn.push_back(c.first);
+    }
+    return rtn;
+}
+BinaryLogger::ColumnType BinaryLogReader::Table::getColumnType(const std::string &name) const {
+    return getColumnData(name, "getColumnType").type;
+}
+unsigned int BinaryLogReader::Table::getColumnElements(const std::string &name) const {
+    return getColumnData(name, "getColumnElements").elements;
+}
+const BinaryLogReader::Table::ColumnData &BinaryLogReader::Table::getColumnData(const std::string &name, const char *caller) const {
+    const auto it = columns.find(name);
+    if (it == columns.end()) {
+        THROW exception::InvalidArgument("Column '%s' was not found in the log, "
+            "in BinaryLogReader::Table::%s()\n", name.c_str(), caller);
+    }
+    return it->second;
+}
+
+BinaryLogReader::BinaryLogReader(const std::string &path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        THROW exception::InvalidFilePath("Unable to open file '%s' for reading, in BinaryLogReader::BinaryLogReader()\n", path.c_str());
+    }
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(buffer.data(), buffer.size())) {
+        THROW exception::InvalidFilePath("Unable to read file '%s', in BinaryLogReader::BinaryLogReader()\n", path.c_str());
+    }
+    parse(buffer.data(), buffer.size());
+}
+BinaryLogReader::BinaryLogReader(const void *data, const size_t length) {
+    if (reinterpret_cast<uintptr_t>(data) % 8 != 0) {
+        THROW exception::InvalidArgument("Binary log buffer must be aligned to 8 bytes, in BinaryLogReader::BinaryLogReader()\n");
+    }
+    parse(static_cast<const char*>(data), length);
+}
+const BinaryLogReader::Run &BinaryLogReader::getRun(const unsigned int index) const {
+    if (index >= runs.size()) {
+        THROW exception::OutOfBoundsException("Run index %u is out of bounds, the log contains %u runs, in BinaryLogReader::getRun()\n",
+            index, static_cast<unsigned int>(runs.size()));
+    }
+    return runs[index];
+}
+std::type_index BinaryLogReader::toTypeIndex(const BinaryLogger::ColumnType type) {
+    switch (type) {
+    case BinaryLogger::Float: return std::type_index(typeid(float));
+    case BinaryLogger::Double: return std::type_index(typeid(double));
+    case BinaryLogger::Int64: return std::type_index(typeid(int64_t));
+    case BinaryLogger::UInt64: return std::type_index(typeid(uint64_t));
+    case BinaryLogger::Int32: return std::type_index(typeid(int32_t));
+    case BinaryLogger::UInt32: return std::type_index(typeid(uint32_t));
+    case BinaryLogger::Int16: return std::type_index(typeid(int16_t));
+    case BinaryLogger::UInt16: return std::type_index(typeid(uint16_t));
+    case BinaryLogger::Int8: return std::type_index(typeid(int8_t));
+    case BinaryLogger::UInt8: return std::type_index(typeid(uint8_t));
+    case BinaryLogger::Char: return std::type_index(typeid(char));
+    }
+    THROW exception::UnsupportedVarType("Unknown column type %u, in BinaryLogReader::toTypeIndex()\n", static_cast<unsigned int>(type));
+}
+
+void BinaryLogReader::parse(const char *data, const size_t length) {
+    Cursor header(data, length);
+    if (memcmp(header.take(sizeof(BinaryLogger::MAGIC)), BinaryLogger::MAGIC, sizeof(BinaryLogger::MAGIC)) != 0) {
+        THROW exception::InvalidInputFile("Buffer is not a binary log, in BinaryLogReader::BinaryLogReader()\n");
+    }
+    const uint32_t version = header.read<uint32_t>();
+    if (version != BinaryLogger::VERSION) {
+        THROW exception::InvalidInputFile("Binary log has version %u, but only version %u is supported, in BinaryLogReader::BinaryLogReader()\n",
+            version, BinaryLogger::VERSION);
+    }
+    if (header.read<uint32_t>() != BinaryLogger::BYTE_ORDER_MARK) {
+        THROW exception::InvalidInputFile("Binary log was written by a host of differing byte order, in BinaryLogReader::BinaryLogReader()\n");
+    }
+    size_t block_start = header.getOffset();
+    while (block_start < length) {
+        Cursor block(data + block_start, length - block_start);
+        const uint64_t block_length = block.read<uint64_t>();
+        if (block_length < sizeof(uint64_t) || block_length > length - block_start) {
+            THROW exception::InvalidInputFile("Binary log contains a run block of invalid length, in BinaryLogReader::BinaryLogReader()\n");
+        }
+        block = Cursor(data + block_start, static_cast<size_t>(block_length), sizeof(uint64_t));
+        Run run;
+        run.flags = block.read<uint32_t>();
+        run.steps = block.read<uint32_t>();
+        run.random_seed = block.read<uint64_t>();
+        if (run.flags & BinaryLogger::PerformanceSpecs) {
+            run.performance_specs.device_name = block.readString();
+            run.performance_specs.device_cc_major = block.read<int32_t>();
+            run.performance_specs.device_cc_minor = block.read<int32_t>();
+            run.performance_specs.cuda_version = block.read<int32_t>();
+            run.performance_specs.seatbelts = block.read<uint32_t>() != 0;
+            run.performance_specs.flamegpu_version = block.readString();
+        }
+        if (run.flags & BinaryLogger::PlanOverrides) {
+            const uint32_t count = block.read<uint32_t>();
+            for (uint32_t i = 0; i < count; ++i) {
+                const std::string name = block.readString();
+                const BinaryLogger::ColumnType type = readColumnType(block);
+                const uint32_t elements = block.read<uint32_t>();
+                const size_t bytes = BinaryLogger::columnTypeSize(type) * elements;
+                run.property_overrides.emplace(name, detail::Any(block.take(bytes), bytes, toTypeIndex(type), elements));
+            }
+        }
+        // Tables are parsed in the same order they are written
+        for (Table *table : {&run.step_log, &run.exit_log}) {
+            if (!(run.flags & (table == &run.step_log ? BinaryLogger::Steps : BinaryLogger::Exit)))
+                continue;
+            block.pad();
+            table->rows = block.read<uint32_t>();
+            const uint32_t column_count = block.read<uint32_t>();
+            for (uint32_t i = 0; i < column_count; ++i) {
+                const std::string name = block.readString();
+                const BinaryLogger::ColumnType type = readColumnType(block);
+                const uint32_t elements = block.read<uint32_t>();
+                const uint64_t offset = block.read<uint64_t>();
+                // Validate the column's data lies within the block
+                Cursor column_cursor(data + block_start, static_cast<size_t>(block_length), static_cast<size_t>(offset));
+                const char *column_data = column_cursor.take(BinaryLogger::columnTypeSize(type) * elements * table->rows);
+                table->columns.emplace(name, Table::ColumnData{type, elements, column_data});
+            }
+            // Skip column data, the next table follows the final column
+            for (const auto &c : table->columns) {
+                const size_t column_end = static_cast<size_t>(c.second.data - (data + block_start)) + BinaryLogger::columnTypeSize(c.second.type) * c.second.elements * table->rows;
+                if (column_end > block.getOffset()) {
+                    block = Cursor(data + block_start, static_cast<size_t>(block_length), column_end);
+                }
+            }
+        }
+        runs.push_back(std::move(run));
+        block_start += static_cast<size_t>(block_length);
+    }
+}
+
+}  // namespace io
+}  // namespace flamegpu
@@ -0,0 +1,340 @@
+#include "flamegpu/io/BinaryLogger.h"
+
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flamegpu/simulation/RunPlan.h"
+#include "flamegpu/simulation/LogFrame.h"
+
+namespace flamegpu {
+namespace io {
+
+namespace {
+/**
+ * Byte buffer used to assemble a complete run block, so that it can be written to file with a single call
+ */
+class BlockBuffer {
+ public:
+    size_t size() const { return data.size(); }
+    char *at(size_t offset) { return data.data() + offset; }
+    void appendBytes(const void *ptr, size_t length) {
+        const size_t offset = data.size();
+        data.resize(offset + length);
+        if (length)
+            memcpy(data.data() + offset, ptr, length);
+    }
+    template<typename T>
+    void append(const T &value) { appendBytes(&value, sizeof(T)); }
+    void appendString(const std::string &value) {
+        append<uint32_t>(static_cast<uint32_t>(value.size()));
+        appendBytes(value.data(), value.size());
+    }
+    /**
+     * Zero fill, until the buffer is a multiple of 8 bytes
+     */
+    void pad() { data.resize((data.size() + 7) & ~static_cast<size_t>(7), 0); }
+    /**
+     * Grow the buffer by length zero bytes, returning the offset of the first new byte
+     */
+    size_t reserve(size_t length) {
+        const size_t offset = data.size();
+        data.resize(offset + length, 0);
+        return offset;
+    }
+    const std::vector<char> &get() const { return data; }
+
+ private:
+    std::vector<char> data;
+};
+/**
+ * Schema of a single column within a table
+ */
+struct Column {
+    std::string name;
+    BinaryLogger::ColumnType type;
+    unsigned int elements;
+    /**
+     * Bytes per row
+     */
+    size_t width;
+    /**
+     * Offset of the column's data within the block buffer
+     */
+    size_t data_offset;
+};
+/**
+ * Named double column, used for timing data which is not part of the common LogFrame
+ */
+typedef std::pair<std::string, std::vector<double>> TimingColumn;
+
+void addColumn(std::vector<Column> &columns, const std::string &name, BinaryLogger::ColumnType type, unsigned int elements) {
+    columns.push_back(Column{name, type, elements, BinaryLogger::columnTypeSize(type) * elements, 0});
+}
+/**
+ * Copies a value into its column, checking that it matches the column's schema
+ */
+void writeCell(BlockBuffer &buffer, const Column &column, size_t row, const detail::Any &value) {
+    if (value.length != column.width || BinaryLogger::toColumnType(value.type) != column.type) {
+        THROW exception::InvalidOperation("Log value '%s' of step frame %u does not match the type or length of the first frame, "
+            "in BinaryLogger::log()\n", column.name.c_str(), static_cast<unsigned int>(row));
+    }
+    memcpy(buffer.at(column.data_offset + row * column.width), value.ptr, column.width);
+}
+/**
+ * Writes a table of log frames to the buffer
+ * The column schema is derived from the first frame, all frames are expected to match as the logging config is fixed for a run
+ */
+void writeTable(BlockBuffer &buffer, const std::vector<const LogFrame*> &frames, const std::vector<TimingColumn> &timing) {
+    // Build schema
+    std::vector<Column> columns;
+    if (!frames.empty()) {
+        const LogFrame &first = *frames[0];
+        addColumn(columns, "step_index", BinaryLogger::UInt32, 1);
+        for (const auto &t : timing) {
+            addColumn(columns, t.first, BinaryLogger::Double, 1);
+        }
+        for (const auto &prop : first.getEnvironment()) {
+            addColumn(columns, BinaryLogger::environmentColumn(prop.first), BinaryLogger::toColumnType(prop.second.type), prop.second.elements);
+        }
+        for (const auto &agent : first.getAgents()) {
+            if (agent.second.second != UINT_MAX) {
+                addColumn(columns, BinaryLogger::agentCountColumn(agent.first.first, agent.first.second), BinaryLogger::UInt32, 1);
+            }
+            for (const auto &var : agent.second.first) {
+                addColumn(columns, BinaryLogger::agentColumn(agent.first.first, agent.first.second, var.first.name, var.first.reduction), BinaryLogger::toColumnType(var.second.type), 1);
+            }
+        }
+    }
+    const size_t rows = frames.size();
+    buffer.append<uint32_t>(static_cast<uint32_t>(rows));
+    buffer.append<uint32_t>(static_cast<uint32_t>(columns.size()));
+    // Write column headers, recording where each offset must be filled in
+    std::vector<size_t> offset_fields;
+    for (const auto &c : columns) {
+        buffer.appendString(c.name);
+        buffer.append<uint8_t>(c.type);
+        buffer.append<uint32_t>(c.elements);
+        offset_fields.push_back(buffer.reserve(sizeof(uint64_t)));
+    }
+    buffer.pad();
+    // Reserve aligned storage for each column
+    for (size_t i = 0; i < columns.size(); ++i) {
+        columns[i].data_offset = buffer.reserve(columns[i].width * rows);
+        buffer.pad();
+        const uint64_t offset = columns[i].data_offset;
+        memcpy(buffer.at(offset_fields[i]), &offset, sizeof(uint64_t));
+    }
+    // Fill columns, each frame's maps are walked in the same order as the schema was built
+    for (size_t row = 0; row < rows; ++row) {
+        const LogFrame &frame = *frames[row];
+        if (frame.getEnvironment().size() != frames[0]->getEnvironment().size() || frame.getAgents().size() != frames[0]->getAgents().size()) {
+            THROW exception::InvalidOperation("Step frame %u does not contain the same log items as the first frame, "
+                "in BinaryLogger::log()\n", static_cast<unsigned int>(row));
+        }
+        auto column = columns.begin();
+        const uint32_t step_index = frame.getStepCount();
+        memcpy(buffer.at(column->data_offset + row * column->width), &step_index, sizeof(uint32_t));
+        ++column;
+        for (const auto &t : timing) {
+            memcpy(buffer.at(column->data_offset + row * column->width), &t.second[row], sizeof(double));
+            ++column;
+        }
+        for (const auto &prop : frame.getEnvironment()) {
+            writeCell(buffer, *column, row, prop.second);
+            ++column;
+        }
+        for (const auto &agent : frame.getAgents()) {
+            if (agent.second.second != UINT_MAX) {
+                if (column == columns.end() || column->type != BinaryLogger::UInt32) {
+                    THROW exception::InvalidOperation("Step frame %u does not contain the same log items as the first frame, "
+                        "in BinaryLogger::log()\n", static_cast<unsigned int>(row));
+                }
+                const uint32_t count = agent.second.second;
+                memcpy(buffer.at(column->data_offset + row * column->width), &count, sizeof(uint32_t));
+                ++column;
+            }
+            for (const auto &var : agent.second.first) {
+                if (column == columns.end()) {
+                    THROW exception::InvalidOperation("Step frame %u does not contain the same log items as the first frame, "
+                        "in BinaryLogger::log()\n", static_cast<unsigned int>(row));
+                }
+                writeCell(buffer, *column, row, var.second);
+                ++column;
+            }
+        }
+        if (column != columns.end()) {
+            THROW exception::InvalidOperation("Step frame %u does not contain the same log items as the first frame, "
+                "in BinaryLogger::log()\n", static_cast<unsigned int>(row));
+        }
+    }
+}
+}  // namespace
+
+BinaryLogger::BinaryLogger(const std::string &outPath, bool, bool _truncateFile)
+    : out_path(outPath)
+    , truncateFile(_truncateFile) { }
+
+void BinaryLogger::log(const RunLog &log, const RunPlan &plan, bool logSteps, bool logExit, bool logStepTime, bool logExitTime) const {
+    logCommon(log, &plan, false, logSteps, logExit, logStepTime, logExitTime);
+}
+void BinaryLogger::log(const RunLog &log, bool logConfig, bool logSteps, bool logExit, bool logStepTime, bool logExitTime) const {
+    logCommon(log, nullptr, logConfig, logSteps, logExit, logStepTime, logExitTime);
+}
+
+BinaryLogger::ColumnType BinaryLogger::toColumnType(const std::type_index &type) {
+    if (type == std::type_index(typeid(float))) {
+        return Float;
+    } else if (type == std::type_index(typeid(double))) {
+        return Double;
+    } else if (type == std::type_index(typeid(int64_t))) {
+        return Int64;
+    } else if (type == std::type_index(typeid(uint64_t))) {
+        return UInt64;
+    } else if (type == std::type_index(typeid(int32_t))) {
+        return Int32;
+    } else if (type == std::type_index(typeid(uint32_t))) {
+        return UInt32;
+    } else if (type == std::type_index(typeid(int16_t))) {
+        return Int16;
+    } else if (type == std::type_index(typeid(uint16_t))) {
+        return UInt16;
+    } else if (type == std::type_index(typeid(int8_t))) {
+        return Int8;
+    } else if (type == std::type_index(typeid(uint8_t))) {
+        return UInt8;
+    } else if (type == std::type_index(typeid(char))) {
+        return Char;
+    }
+    THROW exception::UnsupportedVarType("Attempting to export value of unsupported type '%s', "
+        "in BinaryLogger::toColumnType()\n", type.name());
+}
+size_t BinaryLogger::columnTypeSize(const ColumnType type) {
+    switch (type) {
+    case Double:
+    case Int64:
+    case UInt64:
+        return 8;
+    case Float:
+    case Int32:
+    case UInt32:
+        return 4;
+    case Int16:
+    case UInt16:
+        return 2;
+    case Int8:
+    case UInt8:
+    case Char:
+        return 1;
+    }
+    THROW exception::UnsupportedVarType("Unknown column type %u, in BinaryLogger::columnTypeSize()\n", static_cast<unsigned int>(type));
+}
+std::string BinaryLogger::environmentColumn(const std::string &property_name) {
+    return "environment/" + property_name;
+}
+std::string BinaryLogger::agentCountColumn(const std::string &agent_name, const std::string &state_name) {
+    return "agents/" + agent_name + "/" + state_name + "/count";
+}
+std::string BinaryLogger::agentColumn(const std::string &agent_name, const std::string &state_name, const std::string &variable_name, const LoggingConfig::Reduction reduction) {
+    return "agents/" + agent_name + "/" + state_name + "/" + variable_name + "/" + LoggingConfig::toString(reduction);
+}
+
+void BinaryLogger::logCommon(const RunLog &log, const RunPlan *plan, bool doLogConfig, bool doLogSteps, bool doLogExit, bool doLogStepTime, bool doLogExitTime) const {
+    uint32_t flags = 0;
+    if (plan || doLogConfig) flags |= Config;
+    if (plan) flags |= PlanOverrides;
+    if (doLogStepTime || doLogExitTime) flags |= PerformanceSpecs;
+    if (doLogSteps) flags |= Steps;
+    if (doLogExit) flags |= Exit;
+    if (doLogSteps && doLogStepTime) flags |= StepTime;
+    if (doLogExit && doLogExitTime) flags |= ExitTime;
+    // Assemble the run block
+    BlockBuffer buffer;
+    buffer.reserve(sizeof(uint64_t));  // Block length, filled in once known
+    buffer.append<uint32_t>(flags);
+    buffer.append<uint32_t>(plan ? plan->getSteps() : 0);
+    buffer.append<uint64_t>(plan ? plan->getRandomSimulationSeed() : (doLogConfig ? log.getRandomSeed() : 0));
+    if (flags & PerformanceSpecs) {
+        const RunLog::PerformanceSpecs specs = log.getPerformanceSpecs();
+        buffer.appendString(specs.device_name);
+        buffer.append<int32_t>(specs.device_cc_major);
+        buffer.append<int32_t>(specs.device_cc_minor);
+        buffer.append<int32_t>(specs.cuda_version);
+        buffer.append<uint32_t>(specs.seatbelts ? 1 : 0);
+        buffer.appendString(specs.flamegpu_version);
+    }
+    if (flags & PlanOverrides) {
+        buffer.append<uint32_t>(static_cast<uint32_t>(plan->property_overrides.size()));
+        for (const auto &prop : plan->property_overrides) {
+            const EnvironmentData::PropData &env_prop = plan->environment->at(prop.first);
+            buffer.appendString(prop.first);
+            buffer.append<uint8_t>(toColumnType(prop.second.type));
+            buffer.append<uint32_t>(env_prop.data.elements);
+            buffer.appendBytes(prop.second.ptr, prop.second.length);
+        }
+    }
+    if (flags & Steps) {
+        buffer.pad();
+        const std::list<StepLogFrame> &step_log = log.getStepLog();
+        std::vector<const LogFrame*> frames;
+        frames.reserve(step_log.size());
+        std::vector<TimingColumn> timing;
+        if (flags & StepTime) {
+            timing.emplace_back("step_time", std::vector<double>());
+            timing[0].second.reserve(step_log.size());
+        }
+        for (const auto &step : step_log) {
+            frames.push_back(&step);
+            if (flags & StepTime)
+                timing[0].second.push_back(step.getStepTime());
+        }
+        writeTable(buffer, frames, timing);
+    }
+    if (flags & Exit) {
+        buffer.pad();
+        const ExitLogFrame &exit_frame = log.getExitLog();
+        std::vector<TimingColumn> timing;
+        if (flags & ExitTime) {
+            timing.emplace_back("rtc_time", std::vector<double>{exit_frame.getRTCTime()});
+            timing.emplace_back("init_time", std::vector<double>{exit_frame.getInitTime()});
+            timing.emplace_back("exit_time", std::vector<double>{exit_frame.getExitTime()});
+            timing.emplace_back("total_time", std::vector<double>{exit_frame.getTotalTime()});
+        }
+        writeTable(buffer, {&exit_frame}, timing);
+    }
+    buffer.pad();
+    const uint64_t block_length = buffer.size();
+    memcpy(buffer.at(0), &block_length, sizeof(uint64_t));
+    // Perform output, a file header is only required if the file is new or empty
+    const bool needs_header = truncateFile || !std::filesystem::exists(out_path) || std::filesystem::file_size(out_path) == 0;
+    if (!needs_header) {
+        std::ifstream in(out_path, std::ios::binary);
+        char magic[sizeof(MAGIC)] = {};
+        uint32_t version = 0;
+        in.read(magic, sizeof(MAGIC));
+        in.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+        if (!in || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+            THROW exception::UnsupportedFileType("File '%s' already exists and is not a compatible binary log, it cannot be appended to, "
+                "in BinaryLogger::log()\n", out_path.c_str());
+        }
+    }
+    std::ofstream out(out_path, std::ofstream::binary | (truncateFile ? std::ofstream::trunc : std::ofstream::app));
+    if (!out.is_open()) {
+        THROW exception::InvalidFilePath("Unable to open file '%s' for writing, in BinaryLogger::log()\n", out_path.c_str());
+    }
+    if (needs_header) {
+        out.write(MAGIC, sizeof(MAGIC));
+        out.write(reinterpret_cast<const char*>(&VERSION), sizeof(uint32_t));
+        out.write(reinterpret_cast<const char*>(&BYTE_ORDER_MARK), sizeof(uint32_t));
+    }
+    out.write(buffer.get().data(), buffer.get().size());
+    out.close();
+}
+
+}  // namespace io
+}  // namespace flamegpu
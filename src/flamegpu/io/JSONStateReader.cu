@@ -1,10 +1,10 @@
 #include "flamegpu/io/JSONStateReader.h"
 
-#include <rapidjson/stream.h>
+#include <rapidjson/filereadstream.h>
 #include <rapidjson/reader.h>
 #include <rapidjson/error/en.h>
+#include <any>
 #include <stack>
-#include <fstream>
 #include <string>
 #include <unordered_map>
 #include <cerrno>
@@ -27,6 +27,9 @@ namespace io {
 /**
  * This is the main sax style parser for the json state
  * It stores it's current position within the hierarchy with mode, lastKey and current_variable_array_index
+ *
+ * The file is parsed in two passes. The first pass parses everything except agent variables, and passes the location of each agent to index_agent.
+ * The second pass parses chunks of agents in parallel, each chunk is parsed by a separate instance, initialised by beginChunk().
  */
 class JSONStateReader_impl : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JSONStateReader_impl>  {
     enum Mode{ Nop, Root, Config, Stats, SimCfg, CUDACfg, Environment, MacroEnvironment, Agents, Agent, State, AgentInstance, VariableArray };
@@ -34,6 +37,8 @@ class JSONStateReader_impl : public rapidjson::BaseReaderHandler<rapidjson::UTF8
     std::string lastKey;
     std::string filename;
     const std::shared_ptr<const ModelData>& model;
+    std::unordered_map<std::string, std::any> &simulation_config;
+    std::unordered_map<std::string, std::any> &cuda_config;
     std::unordered_map<std::string, detail::Any> &env_init;
     std::unordered_map<std::string, std::vector<char>> &macro_env_init;
     util::StringPairUnorderedMap<std::shared_ptr<AgentVector>> &agents_map;
@@ -50,20 +55,62 @@ class JSONStateReader_impl : public rapidjson::BaseReaderHandler<rapidjson::UTF8
      * Set when we enter a state
      */
     std::string current_state;
+    /**
+     * Population of the current agent state, set when the state's first agent is encountered
+     */
+    AgentVector *current_population = nullptr;
+    /**
+     * Index of the current agent within current_population, and of the next agent
+     */
+    unsigned int current_agent_index = 0;
+    unsigned int next_agent_index = 0;
+    /**
+     * During the first pass, receives the file offset and population of each agent, and whether it begins a new state array
+     */
+    const std::function<void(uint64_t, AgentVector*, bool)> *index_agent = nullptr;
+    /**
+     * The stream being parsed, required by the first pass to locate agents
+     */
+    rapidjson::FileReadStream *stream = nullptr;
 
  public:
     JSONStateReader_impl(const std::string &_filename,
         const std::shared_ptr<const ModelData> &_model,
+        std::unordered_map<std::string, std::any> &_simulation_config,
+        std::unordered_map<std::string, std::any> &_cuda_config,
         std::unordered_map<std::string, detail::Any> &_env_init,
         std::unordered_map<std::string, std::vector<char>> & _macro_env_init,
         util::StringPairUnorderedMap<std::shared_ptr<AgentVector>> &_agents_map,
         Verbosity _verbosity)
         : filename(_filename)
         , model(_model)
+        , simulation_config(_simulation_config)
+        , cuda_config(_cuda_config)
         , env_init(_env_init)
         , macro_env_init(_macro_env_init)
         , agents_map(_agents_map)
         , verbosity(_verbosity) { }
+    /**
+     * Configure the handler to perform the first pass over the file
+     * @param _stream The stream which will be parsed
+     * @param _index_agent Receives the file offset and population of each agent, and whether it begins a new state array
+     */
+    void beginIndex(rapidjson::FileReadStream *_stream, const std::function<void(uint64_t, AgentVector*, bool)> *_index_agent) {
+        stream = _stream;
+        index_agent = _index_agent;
+    }
+    /**
+     * Configure the handler to parse a chunk of agent objects, which all belong to the same state array
+     * @param population The population which the agents belong to
+     * @param first_index Index within the population of the chunk's first agent
+     */
+    void beginChunk(AgentVector *population, const unsigned int first_index) {
+        mode = std::stack<Mode>();
+        mode.push(State);
+        current_agent = population->getAgentName();
+        current_population = population;
+        next_agent_index = first_index;
+    }
 
     template<typename T>
     bool processValue(const T val) {
@@ -159,206 +206,59 @@ class JSONStateReader_impl : public rapidjson::BaseReaderHandler<rapidjson::UTF8
                 THROW exception::RapidJSONError("Model contains macro environment property '%s' of unsupported type '%s', "
                     "in JSONStateReader::parse()\n", lastKey.c_str(), val_type.name());
             }
+        } else if (mode.top() == AgentInstance && index_agent) {
+            // Agent variables are parsed by the second pass
         } else if (mode.top() == AgentInstance) {
-            const std::shared_ptr<AgentVector> &pop = agents_map.at({current_agent, current_state});
-            AgentVector::Agent instance = pop->back();
-            char *data = static_cast<char*>(const_cast<void*>(static_cast<std::shared_ptr<const AgentVector>>(pop)->data(lastKey)));
-            const VariableMap& agentVariables = pop->getVariableMetaData();
-            const auto var_data = agentVariables.at(lastKey);
+            const AgentVector &pop = *current_population;
+            const VariableMap& agentVariables = pop.getVariableMetaData();
+            const auto var_it = agentVariables.find(lastKey);
+            if (var_it == agentVariables.end()) {
+                THROW exception::RapidJSONError("Input file contains unrecognised agent variable '%s:%s', "
+                    "in JSONStateReader::parse()\n", current_agent.c_str(), lastKey.c_str());
+            }
+            const auto &var_data = var_it->second;
+            if (current_variable_array_index >= var_data.elements) {
+                THROW exception::RapidJSONError("Input file contains agent variable '%s:%s' with more than the expected %u elements, "
+                    "in JSONStateReader::parse()\n", current_agent.c_str(), lastKey.c_str(), var_data.elements);
+            }
+            char *data = static_cast<char*>(const_cast<void*>(pop.data(lastKey)));
             const size_t v_size = var_data.type_size * var_data.elements;
             const std::type_index val_type = var_data.type;
             if (val_type == std::type_index(typeid(float))) {
                 const float t = static_cast<float>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(double))) {
                 const double t = static_cast<double>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(int64_t))) {
                 const int64_t t = static_cast<int64_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(uint64_t))) {
                 const uint64_t t = static_cast<uint64_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(int32_t))) {
                 const int32_t t = static_cast<int32_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(uint32_t))) {
                 const uint32_t t = static_cast<uint32_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(int16_t))) {
                 const int16_t t = static_cast<int16_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(uint16_t))) {
                 const uint16_t t = static_cast<uint16_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(int8_t))) {
                 const int8_t t = static_cast<int8_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else if (val_type == std::type_index(typeid(uint8_t))) {
                 const uint8_t t = static_cast<uint8_t>(val);
-                memcpy(data + ((pop->size() - 1) * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
+                memcpy(data + (current_agent_index * v_size) + (var_data.type_size * current_variable_array_index++), &t, var_data.type_size);
             } else {
                 THROW exception::RapidJSONError("Model contains agent variable '%s:%s' of unsupported type '%s', "
                     "in JSONStateReader::parse()\n", current_agent.c_str(), lastKey.c_str(), val_type.name());
             }
-        }  else if (mode.top() == CUDACfg || mode.top() == SimCfg || mode.top() == Stats) {
-            // Not useful
-            // Cfg are loaded by counter
-        } else {
-            THROW exception::RapidJSONError("Unexpected value whilst parsing input file '%s'.\n", filename.c_str());
-        }
-        if (isArray == VariableArray) {
-            mode.push(isArray);
-        } else {
-            current_variable_array_index = 0;  // Didn't actually want to increment it above, because not in an array
-        }
-        return true;
-    }
-    bool Null() { return true; }
-    bool Bool(bool b) { return processValue<bool>(b); }
-    bool Int(int i) { return processValue<int32_t>(i); }
-    bool Uint(unsigned u) { return processValue<uint32_t>(u); }
-    bool Int64(int64_t i) { return processValue<int64_t>(i); }
-    bool Uint64(uint64_t u) { return processValue<uint64_t>(u); }
-    bool Double(double d) { return processValue<double>(d); }
-    bool String(const char*, rapidjson::SizeType, bool) {
-        // String is only possible in config, and config is not processed by this handler
-        if (mode.top() == SimCfg || mode.top() == CUDACfg) {
-            return true;
-        }
-        THROW exception::RapidJSONError("Unexpected string whilst parsing input file '%s'.\n", filename.c_str());
-    }
-    bool StartObject() {
-        if (mode.empty()) {
-            mode.push(Root);
-        } else if (mode.top() == Root) {
-            if (lastKey == "config") {
-                mode.push(Config);
-            } else if (lastKey == "stats") {
-                mode.push(Stats);
-            } else if (lastKey == "environment") {
-                mode.push(Environment);
-            } else if (lastKey == "macro_environment") {
-                mode.push(MacroEnvironment);
-            } else if (lastKey == "agents") {
-                mode.push(Agents);
-            } else {
-                THROW exception::RapidJSONError("Unexpected object start whilst parsing input file '%s'.\n", filename.c_str());
-            }
-        } else if (mode.top() == Config) {
-            if (lastKey == "simulation") {
-                mode.push(SimCfg);
-            } else if (lastKey == "cuda") {
-                mode.push(CUDACfg);
-            } else {
-                THROW exception::RapidJSONError("Unexpected object start whilst parsing input file '%s'.\n", filename.c_str());
-            }
-        } else if (mode.top() == Agents) {
-            current_agent = lastKey;
-            mode.push(Agent);
-        } else if (mode.top() == State) {
-            mode.push(AgentInstance);
-            auto f = agents_map.find({ current_agent, current_state });
-            if (f == agents_map.end()) {
-                THROW exception::RapidJSONError("Input file '%s' contains data for agent:state combination '%s:%s' not found in model description hierarchy.\n", filename.c_str(), current_agent.c_str(), current_state.c_str());
-            }
-            f->second->push_back();
-        } else {
-            THROW exception::RapidJSONError("Unexpected object start whilst parsing input file '%s'.\n", filename.c_str());
-        }
-        return true;
-    }
-    bool Key(const char* str, rapidjson::SizeType, bool) {
-        lastKey = str;
-        return true;
-    }
-    bool EndObject(rapidjson::SizeType) {
-        mode.pop();
-        return true;
-    }
-    bool StartArray() {
-        if (current_variable_array_index != 0) {
-            THROW exception::RapidJSONError("Array start when current_variable_array_index !=0, in file '%s'. This should never happen.\n", filename.c_str());
-        }
-        if (mode.top() == AgentInstance) {
-            mode.push(VariableArray);
-        } else if (mode.top() == Environment) {
-            mode.push(VariableArray);
-        } else if (mode.top() == MacroEnvironment) {
-            mode.push(VariableArray);
-        } else if (mode.top() == Agent) {
-            current_state = lastKey;
-            mode.push(State);
-        } else {
-            THROW exception::RapidJSONError("Unexpected array start whilst parsing input file '%s'.\n", filename.c_str());
-        }
-        return true;
-    }
-    bool EndArray(rapidjson::SizeType) {
-        if (mode.top() == VariableArray) {
-            mode.pop();
-            if (mode.top() == Environment) {
-                // Confirm env array had correct number of elements
-                const auto prop = model->environment->properties.at(lastKey);
-                if (current_variable_array_index != prop.data.elements) {
-                    THROW exception::RapidJSONError("Input file contains environment property '%s' with %u elements expected %u,"
-                        "in JSONStateReader::parse()\n", lastKey.c_str(), current_variable_array_index, prop.data.elements);
-                }
-            } else if (mode.top() == MacroEnvironment) {
-                // Confirm macro env array had correct number of elements
-                const auto macro_prop = model->environment->macro_properties.at(lastKey);
-                const unsigned int macro_prop_elements = std::accumulate(macro_prop.elements.begin(), macro_prop.elements.end(), 1, std::multiplies<unsigned int>());
-                if (current_variable_array_index != macro_prop_elements) {
-                    THROW exception::RapidJSONError("Input file contains environment macro property '%s' with %u elements expected %u,"
-                        "in JSONStateReader::parse()\n", lastKey.c_str(), current_variable_array_index, macro_prop_elements);
-                }
-            }
-            current_variable_array_index = 0;
-        } else {
-            mode.pop();
-        }
-        return true;
-    }
-};
-/**
- * This is a trivial parser, it builds a map of the number of agents in each state
- * This allows the agent statelists to be preallocated
- * It also reads the config blocks, so that device can be init before we do environment
- */
-class JSONStateReader_agentsize_counter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JSONStateReader_agentsize_counter>  {
-    enum Mode{ Nop, Root, Config, Stats, SimCfg, CUDACfg, Environment, MacroEnvironment, Agents, Agent, State, AgentInstance, VariableArray };
-    std::stack<Mode> mode;
-    std::string lastKey;
-    unsigned int currentIndex = 0;
-    std::string filename;
-    std::string current_agent = "";
-    std::string current_state = "";
-    util::StringPairUnorderedMap<unsigned int> agentstate_counts;
-    std::unordered_map<std::string, std::any> &simulation_config;
-    std::unordered_map<std::string, std::any> &cuda_config;
-    Verbosity verbosity;
-
- public:
-     util::StringPairUnorderedMap<unsigned int> getAgentCounts() const {
-        return agentstate_counts;
-    }
-    explicit JSONStateReader_agentsize_counter(const std::string &_filename,
-        std::unordered_map<std::string, std::any> &_simulation_config,
-        std::unordered_map<std::string, std::any> &_cuda_config,
-        Verbosity _verbosity)
-        : filename(_filename)
-        , simulation_config(_simulation_config)
-        , cuda_config(_cuda_config)
-        , verbosity(_verbosity) { }
-
-    template<typename T>
-    bool processValue(const T val) {
-        Mode isArray = Nop;
-        if (mode.top() == VariableArray) {
-            isArray = mode.top();
-            mode.pop();
-        }
-        if (mode.top() == SimCfg) {
+        } else if (mode.top() == SimCfg) {
             if (lastKey == "truncate_log_files") {
                 simulation_config.emplace(lastKey, static_cast<bool>(val));
             } else if (lastKey == "random_seed") {
@@ -386,12 +286,15 @@ class JSONStateReader_agentsize_counter : public rapidjson::BaseReaderHandler<ra
             } else {
                 THROW exception::RapidJSONError("Unexpected CUDA config item '%s' in input file '%s'.\n", lastKey.c_str(), filename.c_str());
             }
-        }  else {
+        } else if (mode.top() == Stats) {
             // Not useful
-            // Everything else is loaded by main handler
+        } else {
+            THROW exception::RapidJSONError("Unexpected value whilst parsing input file '%s'.\n", filename.c_str());
         }
         if (isArray == VariableArray) {
             mode.push(isArray);
+        } else {
+            current_variable_array_index = 0;  // Didn't actually want to increment it above, because not in an array
         }
         return true;
     }
@@ -402,20 +305,23 @@ class JSONStateReader_agentsize_counter : public rapidjson::BaseReaderHandler<ra
     bool Int64(int64_t i) { return processValue<int64_t>(i); }
     bool Uint64(uint64_t u) { return processValue<uint64_t>(u); }
     bool Double(double d) { return processValue<double>(d); }
-    bool String(const char*str, rapidjson::SizeType, bool) {
+    bool String(const char *str, rapidjson::SizeType, bool) {
+        // String is only possible in config
         if (mode.top() == SimCfg) {
             if (lastKey == "input_file") {
                 if (filename != str && str[0] != '\0')
                     if (verbosity > Verbosity::Quiet)
                         fprintf(stderr, "Warning: Input file '%s' refers to second input file '%s', this will not be loaded.\n", filename.c_str(), str);
-                // sim_instance->SimulationConfig().input_file = str;
             } else if (lastKey == "step_log_file" ||
                        lastKey == "exit_log_file" ||
                        lastKey == "common_log_file") {
                 simulation_config.emplace(lastKey, std::string(str));
             }
+            return true;
+        } else if (mode.top() == CUDACfg) {
+            return true;
         }
-        return true;
+        THROW exception::RapidJSONError("Unexpected string whilst parsing input file '%s'.\n", filename.c_str());
     }
     bool StartObject() {
         if (mode.empty()) {
@@ -442,19 +348,38 @@ class JSONStateReader_agentsize_counter : public rapidjson::BaseReaderHandler<ra
             } else {
                 THROW exception::RapidJSONError("Unexpected object start whilst parsing input file '%s'.\n", filename.c_str());
             }
-        }  else if (mode.top() == Agents) {
+        } else if (mode.top() == Agents) {
             current_agent = lastKey;
             mode.push(Agent);
         } else if (mode.top() == State) {
-            agentstate_counts[{current_agent, current_state}]++;
             mode.push(AgentInstance);
+            const bool new_run = !current_population;
+            if (!current_population) {
+                // First agent of the state, find or create it's population
+                auto f = agents_map.find({ current_agent, current_state });
+                if (f == agents_map.end()) {
+                    const auto& agent = model->agents.find(current_agent);
+                    if (agent == model->agents.end() || agent->second->states.find(current_state) == agent->second->states.end()) {
+                        THROW exception::InvalidAgentState("Agent '%s' with state '%s', found in input file '%s', is not part of the model description hierarchy, "
+                            "in JSONStateReader::parse()\n Ensure the input file is for the correct model.\n", current_agent.c_str(), current_state.c_str(), filename.c_str());
+                    }
+                    f = agents_map.emplace(util::StringPair{ current_agent, current_state }, std::make_shared<AgentVector>(*agent->second)).first;
+                }
+                current_population = f->second.get();
+            }
+            if (index_agent) {
+                // The object's opening brace has been consumed
+                (*index_agent)(stream->Tell() - 1, current_population, new_run);
+            } else {
+                current_agent_index = next_agent_index++;
+            }
         } else {
             THROW exception::RapidJSONError("Unexpected object start whilst parsing input file '%s'.\n", filename.c_str());
         }
         return true;
     }
-    bool Key(const char* str, rapidjson::SizeType, bool) {
-        lastKey = str;
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        lastKey.assign(str, length);
         return true;
     }
     bool EndObject(rapidjson::SizeType) {
@@ -462,7 +387,7 @@ class JSONStateReader_agentsize_counter : public rapidjson::BaseReaderHandler<ra
         return true;
     }
     bool StartArray() {
-        if (currentIndex != 0) {
+        if (current_variable_array_index != 0) {
             THROW exception::RapidJSONError("Array start when current_variable_array_index !=0, in file '%s'. This should never happen.\n", filename.c_str());
         }
         if (mode.top() == AgentInstance) {
@@ -473,6 +398,7 @@ class JSONStateReader_agentsize_counter : public rapidjson::BaseReaderHandler<ra
             mode.push(VariableArray);
         } else if (mode.top() == Agent) {
             current_state = lastKey;
+            current_population = nullptr;
             mode.push(State);
         } else {
             THROW exception::RapidJSONError("Unexpected array start whilst parsing input file '%s'.\n", filename.c_str());
@@ -481,48 +407,70 @@ class JSONStateReader_agentsize_counter : public rapidjson::BaseReaderHandler<ra
     }
     bool EndArray(rapidjson::SizeType) {
         if (mode.top() == VariableArray) {
-            currentIndex = 0;
+            mode.pop();
+            if (mode.top() == Environment) {
+                // Confirm env array had correct number of elements
+                const auto prop = model->environment->properties.at(lastKey);
+                if (current_variable_array_index != prop.data.elements) {
+                    THROW exception::RapidJSONError("Input file contains environment property '%s' with %u elements expected %u,"
+                        "in JSONStateReader::parse()\n", lastKey.c_str(), current_variable_array_index, prop.data.elements);
+                }
+            } else if (mode.top() == MacroEnvironment) {
+                // Confirm macro env array had correct number of elements
+                const auto macro_prop = model->environment->macro_properties.at(lastKey);
+                const unsigned int macro_prop_elements = std::accumulate(macro_prop.elements.begin(), macro_prop.elements.end(), 1, std::multiplies<unsigned int>());
+                if (current_variable_array_index != macro_prop_elements) {
+                    THROW exception::RapidJSONError("Input file contains environment macro property '%s' with %u elements expected %u,"
+                        "in JSONStateReader::parse()\n", lastKey.c_str(), current_variable_array_index, macro_prop_elements);
+                }
+            }
+            current_variable_array_index = 0;
+        } else {
+            mode.pop();
         }
-        mode.pop();
         return true;
     }
 };
-
 void JSONStateReader::parse(const std::string &input_file, const std::shared_ptr<const ModelData> &model, Verbosity verbosity) {
     resetCache();
 
-    std::ifstream in(input_file, std::ios::in | std::ios::binary);
-    if (!in) {
-        THROW exception::RapidJSONError("Unable to open file '%s' for reading, in JSONStateReader::parse().", input_file.c_str());
-    }
-    JSONStateReader_agentsize_counter agentcounter(input_file, simulation_config, cuda_config, verbosity);
-    JSONStateReader_impl handler(input_file, model, env_init, macro_env_init, agents_map, verbosity);
-    std::string filestring = std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-    rapidjson::StringStream filess(filestring.c_str());
-    rapidjson::Reader reader;
-    // First parse the file and simply count the size of agent list
-    rapidjson::ParseResult pr1 = reader.Parse<rapidjson::kParseNanAndInfFlag, rapidjson::StringStream, flamegpu::io::JSONStateReader_agentsize_counter>(filess, agentcounter);
-    if (pr1.Code() != rapidjson::ParseErrorCode::kParseErrorNone) {
-        THROW exception::RapidJSONError("Whilst parsing input file '%s', RapidJSON returned error: %s\n", input_file.c_str(), rapidjson::GetParseError_En(pr1.Code()));
-    }
-    const util::StringPairUnorderedMap<unsigned int> agentCounts = agentcounter.getAgentCounts();
-    // Use this to preallocate the agent statelists
-    for (auto &it : agentCounts) {
-        const auto& agent = model->agents.find(it.first.first);
-        if (agent == model->agents.end() || agent->second->states.find(it.first.second) == agent->second->states.end()) {
-            THROW exception::InvalidAgentState("Agent '%s' with state '%s', found in input file '%s', is not part of the model description hierarchy, "
-                "in JSONStateReader::parse()\n Ensure the input file is for the correct model.\n", it.first.first.c_str(), it.first.second.c_str(), input_file.c_str());
+    // First pass, parse everything except agent variables, and build an index of chunks of agents
+    std::vector<AgentChunk> chunks;
+    {
+        std::unique_ptr<FILE, int(*)(FILE*)> in = openFile(input_file);
+        JSONStateReader_impl handler(input_file, model, simulation_config, cuda_config, env_init, macro_env_init, agents_map, verbosity);
+        // Stream the file through a fixed size buffer, rather than loading the whole file into memory
+        std::vector<char> read_buffer(1 << 16);
+        rapidjson::FileReadStream filess(in.get(), read_buffer.data(), read_buffer.size());
+        const std::function<void(uint64_t, AgentVector*, bool)> index_agent = [&chunks](uint64_t file_offset, AgentVector *population, bool new_run) {
+            addAgentToChunks(chunks, file_offset, population, new_run);
+        };
+        handler.beginIndex(&filess, &index_agent);
+        rapidjson::Reader reader;
+        rapidjson::ParseResult pr = reader.Parse<rapidjson::kParseNanAndInfFlag, rapidjson::FileReadStream, flamegpu::io::JSONStateReader_impl>(filess, handler);
+        if (pr.Code() != rapidjson::ParseErrorCode::kParseErrorNone) {
+            THROW exception::RapidJSONError("Whilst parsing input file '%s', RapidJSON returned error: %s\n", input_file.c_str(), rapidjson::GetParseError_En(pr.Code()));
         }
-        auto [_it, _] = agents_map.emplace(it.first, std::make_shared<AgentVector>(*agent->second));
-        _it->second->reserve(it.second);
-    }
-    // Reset the string stream
-    filess = rapidjson::StringStream(filestring.c_str());
-    // Read in the file data
-    rapidjson::ParseResult pr2 = reader.Parse<rapidjson::kParseNanAndInfFlag, rapidjson::StringStream, flamegpu::io::JSONStateReader_impl>(filess, handler);
-    if (pr2.Code() != rapidjson::ParseErrorCode::kParseErrorNone) {
-        THROW exception::RapidJSONError("Whilst parsing input file '%s', RapidJSON returned error: %s\n", input_file.c_str(), rapidjson::GetParseError_En(pr1.Code()));
     }
+    // Second pass, parse the agent objects of each chunk in parallel
+    // Chunks never span multiple state arrays, so consist of a single population's agents, separated by commas
+    parseChunks(chunks, [&](const AgentChunk &chunk) {
+        std::unique_ptr<FILE, int(*)(FILE*)> in = openFile(input_file, chunk.file_offset);
+        JSONStateReader_impl handler(input_file, model, simulation_config, cuda_config, env_init, macro_env_init, agents_map, verbosity);
+        handler.beginChunk(chunk.populations[0].first, chunk.populations[0].second);
+        std::vector<char> read_buffer(1 << 16);
+        rapidjson::FileReadStream filess(in.get(), read_buffer.data(), read_buffer.size());
+        rapidjson::Reader reader;
+        for (unsigned int i = 0; i < chunk.agent_count; ++i) {
+            while (filess.Peek() == ',' || filess.Peek() == ' ' || filess.Peek() == '\n' || filess.Peek() == '\r' || filess.Peek() == '\t') {
+                filess.Take();
+            }
+            rapidjson::ParseResult pr = reader.Parse<rapidjson::kParseNanAndInfFlag | rapidjson::kParseStopWhenDoneFlag, rapidjson::FileReadStream, flamegpu::io::JSONStateReader_impl>(filess, handler);
+            if (pr.Code() != rapidjson::ParseErrorCode::kParseErrorNone) {
+                THROW exception::RapidJSONError("Whilst parsing input file '%s', RapidJSON returned error: %s\n", input_file.c_str(), rapidjson::GetParseError_En(pr.Code()));
+            }
+        }
+    });
     // Mark input as loaded
     this->input_filepath = input_file;
 }
@@ -1,12 +1,82 @@
 #include "flamegpu/io/StateReader.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include <string>
 
+#include "flamegpu/detail/ThreadPool.h"
+#include "flamegpu/exception/FLAMEGPUException.h"
+#include "flamegpu/simulation/AgentVector.h"
+
 namespace flamegpu {
 namespace io {
 
+void StateReader::setThreadCount(const unsigned int _thread_count) {
+    thread_count = _thread_count;
+}
+void StateReader::addAgentToChunks(std::vector<AgentChunk> &chunks, const uint64_t file_offset, AgentVector *population, const bool new_run) {
+    if (new_run || chunks.empty() || chunks.back().agent_count == AGENTS_PER_CHUNK) {
+        chunks.push_back({file_offset, 0, {}});
+    }
+    AgentChunk &chunk = chunks.back();
+    ++chunk.agent_count;
+    for (auto &p : chunk.populations) {
+        if (p.first == population) {
+            ++p.second;
+            return;
+        }
+    }
+    chunk.populations.emplace_back(population, 1);
+}
+void StateReader::parseChunks(std::vector<AgentChunk> &chunks, const std::function<void(const AgentChunk&)> &parse_chunk) {
+    // Assign each chunk the next range of indices within each of its populations
+    std::unordered_map<AgentVector*, unsigned int> population_sizes;
+    for (auto &chunk : chunks) {
+        for (auto &p : chunk.populations) {
+            unsigned int &size = population_sizes[p.first];
+            const unsigned int count = p.second;
+            p.second = size;
+            size += count;
+        }
+    }
+    // Populations are resized once, which also initialises agents to their default values
+    for (const auto &p : population_sizes) {
+        p.first->resize(p.second);
+    }
+    unsigned int threads = thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned int>(std::min<size_t>(threads, chunks.size()));
+    if (threads <= 1) {
+        for (const auto &chunk : chunks) {
+            parse_chunk(chunk);
+        }
+        return;
+    }
+    // The calling thread also parses chunks
+    detail::ThreadPool pool(threads - 1);
+    pool.parallelFor(0, chunks.size(), 1, [&chunks, &parse_chunk](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            parse_chunk(chunks[i]);
+        }
+    });
+}
+std::unique_ptr<FILE, int(*)(FILE*)> StateReader::openFile(const std::string &input_file, const uint64_t offset) {
+    std::unique_ptr<FILE, int(*)(FILE*)> in(fopen(input_file.c_str(), "rb"), fclose);
+    if (!in) {
+        THROW exception::InvalidInputFile("Unable to open file '%s' for reading, in StateReader::openFile().", input_file.c_str());
+    }
+#ifdef _MSC_VER
+    const int seek_result = _fseeki64(in.get(), static_cast<__int64>(offset), SEEK_SET);
+#else
+    const int seek_result = fseeko(in.get(), static_cast<off_t>(offset), SEEK_SET);
+#endif
+    if (seek_result != 0) {
+        THROW exception::InvalidInputFile("Unable to seek to offset %llu of file '%s', in StateReader::openFile().", static_cast<unsigned long long>(offset), input_file.c_str());  // NOLINT(runtime/int)
+    }
+    return in;
+}
 void StateReader::resetCache() {
     simulation_config.clear();
     cuda_config.clear();
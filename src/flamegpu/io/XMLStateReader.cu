@@ -1,15 +1,20 @@
 #include "flamegpu/io/XMLStateReader.h"
-#include <sstream>
 #include <algorithm>
+#include <any>
+#include <atomic>
 #include <numeric>
-#include <tuple>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <functional>
 #include <memory>
 #include <string>
+#include <typeindex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 
-#include "tinyxml2/tinyxml2.h"              // downloaded from https:// github.com/leethomason/tinyxml2, the list of xml parsers : http:// lars.ruoff.free.fr/xmlcpp/
 #include "flamegpu/exception/FLAMEGPUException.h"
 #include "flamegpu/simulation/AgentVector.h"
 #include "flamegpu/model/AgentDescription.h"
@@ -19,371 +24,724 @@
 namespace flamegpu {
 namespace io {
 
-#ifndef XMLCheckResult
+namespace {
 /**
- * Macro function for converting a tinyxml2 return code to an exception
- * @param a_eResult The tinyxml2 return code
+ * Parses a single value of type T from the start of str
+ * Leading whitespace is skipped, as with std::stof() etc
+ * @param str The string to parse
+ * @param end Set to the first character following the value, or str if no value could be parsed
  */
-#define XMLCheckResult(a_eResult) if (a_eResult != tinyxml2::XML_SUCCESS) { exception::FLAMEGPUException::setLocation(__FILE__, __LINE__);\
-    switch (a_eResult) { \
-    case tinyxml2::XML_ERROR_FILE_NOT_FOUND : \
-    case tinyxml2::XML_ERROR_FILE_COULD_NOT_BE_OPENED : \
-        THROW exception::InvalidInputFile("TinyXML error: File could not be opened.\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_ERROR_FILE_READ_ERROR : \
-        THROW exception::InvalidInputFile("TinyXML error: File could not be read.\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_ERROR_PARSING_ELEMENT : \
-    case tinyxml2::XML_ERROR_PARSING_ATTRIBUTE : \
-    case tinyxml2::XML_ERROR_PARSING_TEXT : \
-    case tinyxml2::XML_ERROR_PARSING_CDATA : \
-    case tinyxml2::XML_ERROR_PARSING_COMMENT : \
-    case tinyxml2::XML_ERROR_PARSING_DECLARATION : \
-    case tinyxml2::XML_ERROR_PARSING_UNKNOWN : \
-    case tinyxml2::XML_ERROR_PARSING : \
-        THROW exception::TinyXMLError("TinyXML error: Error parsing file.\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_ERROR_EMPTY_DOCUMENT : \
-        THROW exception::TinyXMLError("TinyXML error: XML_ERROR_EMPTY_DOCUMENT\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_ERROR_MISMATCHED_ELEMENT : \
-        THROW exception::TinyXMLError("TinyXML error: XML_ERROR_MISMATCHED_ELEMENT\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_CAN_NOT_CONVERT_TEXT : \
-        THROW exception::TinyXMLError("TinyXML error: XML_CAN_NOT_CONVERT_TEXT\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_NO_TEXT_NODE : \
-        THROW exception::TinyXMLError("TinyXML error: XML_NO_TEXT_NODE\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_ELEMENT_DEPTH_EXCEEDED : \
-        THROW exception::TinyXMLError("TinyXML error: XML_ELEMENT_DEPTH_EXCEEDED\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_ERROR_COUNT : \
-        THROW exception::TinyXMLError("TinyXML error: XML_ERROR_COUNT\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_NO_ATTRIBUTE: \
-        THROW exception::TinyXMLError("TinyXML error: XML_NO_ATTRIBUTE\n Error code: %d", a_eResult); \
-    case tinyxml2::XML_WRONG_ATTRIBUTE_TYPE : \
-        THROW exception::TinyXMLError("TinyXML error: XML_WRONG_ATTRIBUTE_TYPE\n Error code: %d", a_eResult); \
-    default: \
-        THROW exception::TinyXMLError("TinyXML error: Unrecognised error code\n Error code: %d", a_eResult); \
-    } \
+template<typename T>
+T parseValue(const char *str, char **end) {
+    if constexpr (std::is_same<T, float>::value) {
+        return strtof(str, end);
+    } else if constexpr (std::is_same<T, double>::value) {
+        return strtod(str, end);
+    } else if constexpr (std::is_signed<T>::value) {
+        return static_cast<T>(strtoll(str, end, 10));
+    } else {
+        return static_cast<T>(strtoull(str, end, 10));
+    }
 }
-#endif
-
-void XMLStateReader::parse(const std::string &inputFile, const std::shared_ptr<const ModelData> &model, Verbosity verbosity) {
-    tinyxml2::XMLDocument doc;
+/**
+ * Parses a comma separated list of values of type T from text into dest
+ * @param text The text to parse
+ * @param dest The buffer to write values to
+ * @param max_elements The number of values that dest can hold, values beyond this are counted but not written
+ * @return The number of values within text
+ * @throws exception::TinyXMLError If a value could not be parsed
+ */
+template<typename T>
+unsigned int parseValues(const std::string &text, void *dest, const unsigned int max_elements) {
+    unsigned int el = 0;
+    const char *str = text.c_str();
+    while (*str != '\0') {
+        char *end = nullptr;
+        const T t = parseValue<T>(str, &end);
+        if (end == str) {
+            THROW exception::TinyXMLError("Unable to parse value '%s', in XMLStateReader::parse()\n", text.c_str());
+        }
+        if (el < max_elements) {
+            memcpy(static_cast<char*>(dest) + el * sizeof(T), &t, sizeof(T));
+        }
+        ++el;
+        // Trailing characters within a value are ignored, as with std::stof() etc
+        str = strchr(end, ',');
+        if (!str) {
+            break;
+        }
+        ++str;
+    }
+    return el;
+}
+/**
+ * Parses a comma separated list of values of type val_type from text into dest
+ * @param text The text to parse
+ * @param val_type The type of the values
+ * @param dest The buffer to write values to
+ * @param max_elements The number of values that dest can hold, values beyond this are counted but not written
+ * @param kind Description of the item being parsed, for use in exception messages
+ * @param name Name of the item being parsed, for use in exception messages
+ * @return The number of values within text
+ * @throws exception::TinyXMLError If val_type is not supported, or a value could not be parsed
+ */
+unsigned int parseValues(const std::string &text, const std::type_index &val_type, void *dest, const unsigned int max_elements, const char *kind, const std::string &name) {
+    if (val_type == std::type_index(typeid(float))) {
+        return parseValues<float>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(double))) {
+        return parseValues<double>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(int64_t))) {
+        return parseValues<int64_t>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(uint64_t))) {
+        return parseValues<uint64_t>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(int32_t))) {
+        return parseValues<int32_t>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(uint32_t))) {
+        return parseValues<uint32_t>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(int16_t))) {
+        return parseValues<int16_t>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(uint16_t))) {
+        return parseValues<uint16_t>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(int8_t))) {
+        return parseValues<int8_t>(text, dest, max_elements);
+    } else if (val_type == std::type_index(typeid(uint8_t))) {
+        return parseValues<uint8_t>(text, dest, max_elements);
+    }
+    THROW exception::TinyXMLError("Model contains %s '%s' of unsupported type '%s', "
+        "in XMLStateReader::parse()\n", kind, name.c_str(), val_type.name());
+}
+/**
+ * Parses a boolean config value, which may be 'true', 'false' or an integer
+ */
+bool parseBool(std::string val) {
+    for (auto& c : val)
+        c = static_cast<char>(::tolower(c));
+    if (val == "true") {
+        return true;
+    } else if (val == "false") {
+        return false;
+    }
+    return static_cast<bool>(stoll(val));
+}
+}  // namespace
 
-    tinyxml2::XMLError errorId = doc.LoadFile(inputFile.c_str());
-    XMLCheckResult(errorId);
+/**
+ * Minimal streaming (pull) XML parser
+ * The file is read through a fixed size buffer, and elements are passed to the handler as they are encountered
+ * so memory use is independent of the size of the file
+ *
+ * The handler receives startElement(name, depth, offset) and endElement(name, text, depth), where text holds the character data
+ * since the preceding tag, with entities decoded, so it is only meaningful for leaf elements
+ * Attributes, comments, processing instructions and the DOCTYPE are skipped, CDATA sections are treated as text
+ */
+class XMLStreamParser {
+    FILE *in;
+    const std::string &filename;
+    std::vector<char> buffer;
+    /**
+     * Offset of buffer[0] within the file
+     */
+    uint64_t buffer_offset;
+    size_t pos = 0;
+    size_t len = 0;
 
-    tinyxml2::XMLNode* pRoot = doc.FirstChild();
-    if (pRoot == nullptr) {
-        THROW exception::TinyXMLError("TinyXML error: Error parsing doc %s.", inputFile.c_str());
+    int get() {
+        if (pos == len) {
+            buffer_offset += len;
+            len = fread(buffer.data(), 1, buffer.size(), in);
+            pos = 0;
+            if (len == 0) {
+                return EOF;
+            }
+        }
+        return static_cast<unsigned char>(buffer[pos++]);
     }
-
-    // Read config data
-    tinyxml2::XMLElement* pElement = pRoot->FirstChildElement("config");
-    if (pElement) {
-        // Sim config
-        tinyxml2::XMLElement *pSimCfgBlock = pElement->FirstChildElement("simulation");
-        if (pSimCfgBlock) {
-            for (auto simCfgElement = pSimCfgBlock->FirstChildElement(); simCfgElement; simCfgElement = simCfgElement->NextSiblingElement()) {
-                std::string key = simCfgElement->Value();
-                std::string val = simCfgElement->GetText() ? simCfgElement->GetText() : "";
-                if (key == "input_file") {
-                    if (inputFile != val && !val.empty())
-                        if (verbosity > Verbosity::Quiet)
-                            fprintf(stderr, "Warning: Input file '%s' refers to second input file '%s', this will not be loaded.\n", inputFile.c_str(), val.c_str());
-                    // sim_instance->SimulationConfig().input_file = val;
-                } else if (key == "step_log_file" ||
-                           key == "exit_log_file" ||
-                           key == "common_log_file") {
-                    simulation_config.emplace(key, val);
-                } else if (key == "truncate_log_files" ||
-#ifdef FLAMEGPU_VISUALISATION
-                           key == "console_mode" ||
-#endif
-                           key == "timing") {
-                    for (auto& c : val)
-                        c = static_cast<char>(::tolower(c));
-                    if (val == "true") {
-                        simulation_config.emplace(key, true);
-                    } else if (val == "false") {
-                        simulation_config.emplace(key, false);
-                    } else {
-                        simulation_config.emplace(key, static_cast<bool>(stoll(val)));
-                    }
-                } else if (key == "random_seed") {
-                    simulation_config.emplace(key, static_cast<uint64_t>(stoull(val)));
-                } else if (key == "steps") {
-                    simulation_config.emplace(key, static_cast<unsigned int>(stoull(val)));
-                } else if (key == "verbosity") {
-                    simulation_config.emplace(key, static_cast<flamegpu::Verbosity>(stoull(val)));
-                }  else if (verbosity > Verbosity::Quiet) {
-                    fprintf(stderr, "Warning: Input file '%s' contains unexpected simulation config property '%s'.\n", inputFile.c_str(), key.c_str());
-                }
-#ifndef FLAMEGPU_VISUALISATION
-                if (key == "console_mode") {
-                    if (verbosity > Verbosity::Quiet)
-                        fprintf(stderr, "Warning: Cannot configure 'console_mode' with input file '%s', FLAMEGPU2 library has not been built with visualisation support enabled.\n", inputFile.c_str());
-                }
-#endif
+    int getRequired() {
+        const int c = get();
+        if (c == EOF) {
+            THROW exception::TinyXMLError("Unexpected end of file whilst parsing input file '%s', in XMLStateReader::parse()\n", filename.c_str());
+        }
+        return c;
+    }
+    static bool isSpace(const int c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    static bool isNameChar(const int c) {
+        return c != EOF && !isSpace(c) && c != '>' && c != '/' && c != '=' && c != '<';
+    }
+    /**
+     * Skips input until terminator has been consumed
+     */
+    void skipUntil(const char *terminator) {
+        const size_t t_len = strlen(terminator);
+        std::string tail;
+        while (tail.size() < t_len || tail.compare(tail.size() - t_len, t_len, terminator) != 0) {
+            tail.push_back(static_cast<char>(getRequired()));
+            if (tail.size() > t_len) {
+                tail.erase(0, 1);
             }
         }
-        // CUDA config
-        tinyxml2::XMLElement *pCUDACfgBlock = pElement->FirstChildElement("cuda");
-        if (pCUDACfgBlock) {
-            for (auto cudaCfgElement = pCUDACfgBlock->FirstChildElement(); cudaCfgElement; cudaCfgElement = cudaCfgElement->NextSiblingElement()) {
-                std::string key = cudaCfgElement->Value();
-                std::string val = cudaCfgElement->GetText();
-                if (key == "device_id") {
-                    cuda_config.emplace(key, static_cast<int>(stoull(val)));
-                } else if (key == "inLayerConcurrency") {
-                    for (auto& c : val)
-                        c = static_cast<char>(::tolower(c));
-                    if (val == "true") {
-                        cuda_config.emplace(key, true);
-                    } else if (val == "false") {
-                        cuda_config.emplace(key, false);
-                    } else {
-                        cuda_config.emplace(key, static_cast<bool>(stoll(val)));
-                    }
-                } else if (verbosity > Verbosity::Quiet) {
-                    fprintf(stderr, "Warning: Input file '%s' contains unexpected cuda config property '%s'.\n", inputFile.c_str(), key.c_str());
-                }
+    }
+    /**
+     * Reads an element name, beginning with c, returns the first character following the name
+     */
+    int readName(int c, std::string &name) {
+        name.clear();
+        while (isNameChar(c)) {
+            name.push_back(static_cast<char>(c));
+            c = get();
+        }
+        if (name.empty()) {
+            THROW exception::TinyXMLError("Malformed element whilst parsing input file '%s', in XMLStateReader::parse()\n", filename.c_str());
+        }
+        return c;
+    }
+    /**
+     * Decodes a character or entity reference, the leading '&' has already been consumed
+     */
+    void readEntity(std::string &text) {
+        std::string entity;
+        int c = getRequired();
+        while (c != ';') {
+            if (entity.size() > 10) {
+                THROW exception::TinyXMLError("Malformed entity whilst parsing input file '%s', in XMLStateReader::parse()\n", filename.c_str());
             }
+            entity.push_back(static_cast<char>(c));
+            c = getRequired();
+        }
+        if (entity == "lt") {
+            text.push_back('<');
+        } else if (entity == "gt") {
+            text.push_back('>');
+        } else if (entity == "amp") {
+            text.push_back('&');
+        } else if (entity == "quot") {
+            text.push_back('"');
+        } else if (entity == "apos") {
+            text.push_back('\'');
+        } else if (entity.size() > 1 && entity[0] == '#') {
+            const unsigned long code = entity[1] == 'x' ? strtoul(entity.c_str() + 2, nullptr, 16) : strtoul(entity.c_str() + 1, nullptr, 10);  // NOLINT(runtime/int)
+            // Values are numeric, so only ASCII character references are meaningful
+            text.push_back(code < 128 ? static_cast<char>(code) : '?');
+        } else {
+            THROW exception::TinyXMLError("Unrecognised entity '&%s;' whilst parsing input file '%s', in XMLStateReader::parse()\n", entity.c_str(), filename.c_str());
         }
-    } else {
-        // No warning, environment node is not mandatory
     }
 
-    // Read environment data
-    pElement = pRoot->FirstChildElement("environment");
-    if (pElement) {
-        auto& env_props = model->environment->properties;
-        for (auto envElement = pElement->FirstChildElement(); envElement; envElement = envElement->NextSiblingElement()) {
-            const char *key = envElement->Value();
-            std::stringstream ss(envElement->GetText());
-            std::string token;
-            const auto it = env_props.find(std::string(key));
-            if (it == env_props.end()) {
-                THROW exception::TinyXMLError("Input file contains unrecognised environment property '%s',"
-                    "in XMLStateReader::parse()\n", key);
+ public:
+    /**
+     * @param _in The file to parse, positioned at offset
+     * @param _filename Path of the file, for use in exception messages
+     * @param offset The current position within the file
+     */
+    XMLStreamParser(FILE *_in, const std::string &_filename, const uint64_t offset = 0)
+        : in(_in)
+        , filename(_filename)
+        , buffer(1 << 16)
+        , buffer_offset(offset) { }
+    /**
+     * Parse the file, passing elements to handler
+     * @param handler The handler to receive elements
+     * @param fragment If true, parsing begins within the root element and ends once handler.isComplete() returns true
+     */
+    template<typename Handler>
+    void parse(Handler &handler, const bool fragment = false) {
+        std::vector<std::string> open_elements;
+        size_t depth = 0;
+        bool has_root = false;
+        if (fragment) {
+            // The name of the root element is not known
+            open_elements.emplace_back();
+            depth = 1;
+            has_root = true;
+        }
+        std::string name;
+        std::string text;
+        int c = get();
+        while (c != EOF && !(fragment && handler.isComplete())) {
+            if (c == '&') {
+                readEntity(text);
+                c = get();
+                continue;
+            } else if (c != '<') {
+                text.push_back(static_cast<char>(c));
+                // Append the remainder of the text within the buffer in bulk
+                const char *begin = buffer.data() + pos;
+                const char *end = buffer.data() + len;
+                const char *stop = begin;
+                while (stop != end && *stop != '<' && *stop != '&') {
+                    ++stop;
+                }
+                text.append(begin, stop);
+                pos += stop - begin;
+                c = get();
+                continue;
             }
-            const std::type_index val_type = it->second.data.type;
-            const auto elements = it->second.data.elements;
-            unsigned int el = 0;
-            while (getline(ss, token, ',')) {
-                if (el == 0) {
-                    if (!env_init.emplace(std::string(key), detail::Any(it->second.data)).second) {
-                        THROW exception::TinyXMLError("Input file contains environment property '%s' multiple times, "
-                            "in XMLStateReader::parse()\n", key);
+            const uint64_t tag_offset = buffer_offset + pos - 1;
+            c = getRequired();
+            if (c == '?') {
+                // Declaration or processing instruction
+                skipUntil("?>");
+            } else if (c == '!') {
+                c = getRequired();
+                if (c == '-') {
+                    if (getRequired() != '-') {
+                        THROW exception::TinyXMLError("Malformed comment whilst parsing input file '%s', in XMLStateReader::parse()\n", filename.c_str());
+                    }
+                    skipUntil("-->");
+                } else if (c == '[') {
+                    // CDATA, the remainder of "[CDATA[" is not validated
+                    skipUntil("[");
+                    size_t matched = 0;
+                    while (matched < 3) {
+                        c = getRequired();
+                        text.push_back(static_cast<char>(c));
+                        matched = c == '>' && matched == 2 ? 3 : c == ']' ? std::min<size_t>(matched + 1, 2) : 0;
+                    }
+                    text.resize(text.size() - 3);
+                } else {
+                    // DOCTYPE, which may contain an internal subset
+                    int brackets = 0;
+                    while (c != '>' || brackets) {
+                        brackets += c == '[' ? 1 : c == ']' ? -1 : 0;
+                        c = getRequired();
                     }
-                } else if (el >= it->second.data.elements) {
-                    THROW exception::RapidJSONError("Input file contains environment property '%s' too many elements, expected %u,"
-                        "in XMLStateReader::parse()\n", key, it->second.data.elements);
                 }
-                const auto ei_it = env_init.find(key);
-                if (val_type == std::type_index(typeid(float))) {
-                    static_cast<float*>(const_cast<void*>(ei_it->second.ptr))[el++] = stof(token);
-                } else if (val_type == std::type_index(typeid(double))) {
-                    static_cast<double*>(const_cast<void*>(ei_it->second.ptr))[el++] = stod(token);
-                } else if (val_type == std::type_index(typeid(int64_t))) {
-                    static_cast<int64_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = stoll(token);
-                } else if (val_type == std::type_index(typeid(uint64_t))) {
-                    static_cast<uint64_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = stoull(token);
-                } else if (val_type == std::type_index(typeid(int32_t))) {
-                    static_cast<int32_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = static_cast<int32_t>(stoll(token));
-                } else if (val_type == std::type_index(typeid(uint32_t))) {
-                    static_cast<uint32_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = static_cast<uint32_t>(stoull(token));
-                } else if (val_type == std::type_index(typeid(int16_t))) {
-                    static_cast<int16_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = static_cast<int16_t>(stoll(token));
-                } else if (val_type == std::type_index(typeid(uint16_t))) {
-                    static_cast<uint16_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = static_cast<uint16_t>(stoull(token));
-                } else if (val_type == std::type_index(typeid(int8_t))) {
-                    static_cast<int8_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = static_cast<int8_t>(stoll(token));
-                } else if (val_type == std::type_index(typeid(uint8_t))) {
-                    static_cast<uint8_t*>(const_cast<void*>(ei_it->second.ptr))[el++] = static_cast<uint8_t>(stoull(token));
+            } else if (c == '/') {
+                c = readName(getRequired(), name);
+                while (isSpace(c)) {
+                    c = getRequired();
+                }
+                if (c != '>') {
+                    THROW exception::TinyXMLError("Malformed closing tag '%s' whilst parsing input file '%s', in XMLStateReader::parse()\n", name.c_str(), filename.c_str());
+                } else if (!depth || open_elements[depth - 1] != name) {
+                    THROW exception::TinyXMLError("Mismatched closing tag '%s' whilst parsing input file '%s', in XMLStateReader::parse()\n", name.c_str(), filename.c_str());
+                }
+                handler.endElement(name, text, --depth);
+                text.clear();
+            } else {
+                if (depth == 0 && has_root) {
+                    THROW exception::TinyXMLError("Input file '%s' contains multiple root elements, in XMLStateReader::parse()\n", filename.c_str());
+                }
+                c = readName(c, name);
+                // Skip attributes, respecting quoted values which may contain '>'
+                bool self_closing = false;
+                while (c != '>') {
+                    if (c == '"' || c == '\'') {
+                        const int quote = c;
+                        do {
+                            c = getRequired();
+                        } while (c != quote);
+                    }
+                    self_closing = c == '/';
+                    c = getRequired();
+                }
+                text.clear();
+                has_root = true;
+                handler.startElement(name, depth, tag_offset);
+                if (self_closing) {
+                    handler.endElement(name, text, depth);
                 } else {
-                    THROW exception::TinyXMLError("Model contains environment property '%s' of unsupported type '%s', "
-                        "in XMLStateReader::parse()\n", key, val_type.name());
+                    if (open_elements.size() == depth) {
+                        open_elements.emplace_back();
+                    }
+                    open_elements[depth++] = name;
                 }
             }
-            if (el != elements && verbosity > Verbosity::Quiet) {
-                fprintf(stderr, "Warning: Environment array property '%s' expects '%u' elements, input file '%s' contains '%u' elements.\n",
-                    key, elements, inputFile.c_str(), el);
+            c = get();
+        }
+        if (fragment) {
+            if (!handler.isComplete()) {
+                THROW exception::TinyXMLError("Unexpected end of file whilst parsing input file '%s', in XMLStateReader::parse()\n", filename.c_str());
             }
+        } else if (depth) {
+            THROW exception::TinyXMLError("Unexpected end of file whilst parsing input file '%s', element '%s' was not closed, in XMLStateReader::parse()\n",
+                filename.c_str(), open_elements[depth - 1].c_str());
+        } else if (!has_root) {
+            THROW exception::TinyXMLError("Input file '%s' does not contain a root element, in XMLStateReader::parse()\n", filename.c_str());
         }
-    } else if (verbosity > Verbosity::Quiet) {
-        fprintf(stderr, "Warning: Input file '%s' does not contain environment node.\n", inputFile.c_str());
     }
+};
 
-    // Read macro environment data
-    pElement = pRoot->FirstChildElement("macro_environment");
-    if (pElement) {
-        auto& env_macro_props = model->environment->macro_properties;
-        for (auto envElement = pElement->FirstChildElement(); envElement; envElement = envElement->NextSiblingElement()) {
-            const char *key = envElement->Value();
-            std::stringstream ss(envElement->GetText());
-            std::string token;
-            const auto it = env_macro_props.find(std::string(key));
-            if (it == env_macro_props.end()) {
-                THROW exception::TinyXMLError("Input file contains unrecognised macro environment property '%s',"
-                    "in XMLStateReader::parse()\n", key);
+/**
+ * This is the main sax style handler for the xml state
+ * It stores it's current position within the hierarchy with mode
+ *
+ * The file is parsed in two passes. The first pass parses everything except agent variables, and passes the location of each xagent to index_agent.
+ * The second pass parses chunks of xagents in parallel, each chunk is parsed by a separate instance, initialised by beginChunk().
+ * The variables of each xagent are buffered until the xagent closes, as the name and state elements are not required to precede them
+ */
+class XMLStateReader_impl {
+    enum Mode{ Nop, Root, Config, SimCfg, CUDACfg, Environment, MacroEnvironment, Agent };
+    std::vector<Mode> mode;
+    const std::string &filename;
+    const std::shared_ptr<const ModelData> &model;
+    std::unordered_map<std::string, std::any> &simulation_config;
+    std::unordered_map<std::string, std::any> &cuda_config;
+    std::unordered_map<std::string, detail::Any> &env_init;
+    std::unordered_map<std::string, std::vector<char>> &macro_env_init;
+    util::StringPairUnorderedMap<std::shared_ptr<AgentVector>> &agents_map;
+    Verbosity verbosity;
+    /**
+     * Name and state of the current xagent
+     */
+    std::string current_agent;
+    std::string current_state;
+    bool has_state = false;
+    /**
+     * The variable name/value pairs of the current xagent
+     * These are reused between agents to avoid reallocation, so only the first current_variable_count are valid
+     */
+    std::vector<std::pair<std::string, std::string>> current_variables;
+    size_t current_variable_count = 0;
+    /**
+     * Population which the previous xagent was added to, and it's name and state
+     */
+    AgentVector *current_population = nullptr;
+    util::StringPair current_population_name;
+    /**
+     * Offset of the current xagent within the file
+     */
+    uint64_t current_agent_offset = 0;
+    /**
+     * During the first pass, receives the file offset and population of each xagent
+     */
+    const std::function<void(uint64_t, AgentVector*, bool)> *index_agent = nullptr;
+    /**
+     * During the second pass, the populations of the chunk being parsed, and the index of the next agent within each
+     */
+    std::vector<std::pair<AgentVector*, unsigned int>> chunk_populations;
+    /**
+     * During the second pass, the number of the chunk's xagents which have not yet been parsed
+     */
+    unsigned int chunk_remaining = 0;
+    bool is_chunk = false;
+    /**
+     * Ensures each warning is only emitted once, these are shared by the instances parsing chunks
+     */
+    std::atomic<bool> &hasWarnedElements;
+    std::atomic<bool> &hasWarnedMissingVar;
+
+    /**
+     * Returns the population of the named agent state, creating it if required
+     */
+    AgentVector &getPopulation(const std::string &agent_name, const std::string &agent_state) {
+        if (current_population && current_population_name.first == agent_name && current_population_name.second == agent_state) {
+            return *current_population;
+        }
+        auto f = agents_map.find({ agent_name, agent_state });
+        if (f == agents_map.end()) {
+            const auto& agent = model->agents.find(agent_name);
+            if (agent == model->agents.end() || agent->second->states.find(agent_state) == agent->second->states.end()) {
+                THROW exception::InvalidAgentState("Agent '%s' with state '%s', found in input file '%s', is not part of the model description hierarchy, "
+                    "in XMLStateReader::parse()\n Ensure the input file is for the correct model.\n", agent_name.c_str(), agent_state.c_str(), filename.c_str());
+            }
+            f = agents_map.emplace(util::StringPair{ agent_name, agent_state }, std::make_shared<AgentVector>(*agent->second)).first;
+        }
+        current_population = f->second.get();
+        current_population_name = { agent_name, agent_state };
+        return *current_population;
+    }
+    void processSimCfg(const std::string &key, const std::string &val) {
+        if (key == "input_file") {
+            if (filename != val && !val.empty())
+                if (verbosity > Verbosity::Quiet)
+                    fprintf(stderr, "Warning: Input file '%s' refers to second input file '%s', this will not be loaded.\n", filename.c_str(), val.c_str());
+        } else if (key == "step_log_file" ||
+                   key == "exit_log_file" ||
+                   key == "common_log_file") {
+            simulation_config.emplace(key, val);
+        } else if (key == "truncate_log_files" ||
+#ifdef FLAMEGPU_VISUALISATION
+                   key == "console_mode" ||
+#endif
+                   key == "timing") {
+            simulation_config.emplace(key, parseBool(val));
+        } else if (key == "random_seed") {
+            simulation_config.emplace(key, static_cast<uint64_t>(stoull(val)));
+        } else if (key == "steps") {
+            simulation_config.emplace(key, static_cast<unsigned int>(stoull(val)));
+        } else if (key == "verbosity") {
+            simulation_config.emplace(key, static_cast<flamegpu::Verbosity>(stoull(val)));
+        }  else if (verbosity > Verbosity::Quiet) {
+            fprintf(stderr, "Warning: Input file '%s' contains unexpected simulation config property '%s'.\n", filename.c_str(), key.c_str());
+        }
+#ifndef FLAMEGPU_VISUALISATION
+        if (key == "console_mode") {
+            if (verbosity > Verbosity::Quiet)
+                fprintf(stderr, "Warning: Cannot configure 'console_mode' with input file '%s', FLAMEGPU2 library has not been built with visualisation support enabled.\n", filename.c_str());
+        }
+#endif
+    }
+    void processCUDACfg(const std::string &key, const std::string &val) {
+        if (key == "device_id") {
+            cuda_config.emplace(key, static_cast<int>(stoull(val)));
+        } else if (key == "inLayerConcurrency") {
+            cuda_config.emplace(key, parseBool(val));
+        } else if (verbosity > Verbosity::Quiet) {
+            fprintf(stderr, "Warning: Input file '%s' contains unexpected cuda config property '%s'.\n", filename.c_str(), key.c_str());
+        }
+    }
+    void processEnvironment(const std::string &key, const std::string &val) {
+        const auto it = model->environment->properties.find(key);
+        if (it == model->environment->properties.end()) {
+            THROW exception::TinyXMLError("Input file contains unrecognised environment property '%s',"
+                "in XMLStateReader::parse()\n", key.c_str());
+        }
+        const auto ei_it = env_init.emplace(key, detail::Any(it->second.data));
+        if (!ei_it.second) {
+            THROW exception::TinyXMLError("Input file contains environment property '%s' multiple times, "
+                "in XMLStateReader::parse()\n", key.c_str());
+        }
+        const unsigned int elements = it->second.data.elements;
+        const unsigned int el = parseValues(val, it->second.data.type, const_cast<void*>(ei_it.first->second.ptr), elements, "environment property", key);
+        if (el > elements) {
+            THROW exception::TinyXMLError("Input file contains environment property '%s' too many elements, expected %u,"
+                "in XMLStateReader::parse()\n", key.c_str(), elements);
+        } else if (el != elements && verbosity > Verbosity::Quiet) {
+            fprintf(stderr, "Warning: Environment array property '%s' expects '%u' elements, input file '%s' contains '%u' elements.\n",
+                key.c_str(), elements, filename.c_str(), el);
+        }
+    }
+    void processMacroEnvironment(const std::string &key, const std::string &val) {
+        const auto it = model->environment->macro_properties.find(key);
+        if (it == model->environment->macro_properties.end()) {
+            THROW exception::TinyXMLError("Input file contains unrecognised macro environment property '%s',"
+                "in XMLStateReader::parse()\n", key.c_str());
+        }
+        const unsigned int elements = std::accumulate(it->second.elements.begin(), it->second.elements.end(), 1, std::multiplies<unsigned int>());
+        const auto mei_it = macro_env_init.emplace(key, std::vector<char>(elements * it->second.type_size));
+        if (!mei_it.second) {
+            THROW exception::TinyXMLError("Input file contains macro environment property '%s' multiple times, "
+                "in XMLStateReader::parse()\n", key.c_str());
+        }
+        const unsigned int el = parseValues(val, it->second.type, mei_it.first->second.data(), elements, "macro environment property", key);
+        if (el > elements) {
+            THROW exception::TinyXMLError("Input file contains macro environment property '%s' too many elements, expected %u,"
+                "in XMLStateReader::parse()\n", key.c_str(), elements);
+        } else if (el != elements && verbosity > Verbosity::Quiet) {
+            fprintf(stderr, "Warning: Macro environment property '%s' expects '%u' elements, input file '%s' contains '%u' elements.\n",
+                key.c_str(), elements, filename.c_str(), el);
+        }
+    }
+    /**
+     * Adds the buffered xagent to it's population
+     */
+    void processAgent() {
+        if (current_agent.empty()) {
+            THROW exception::TinyXMLError("Input file '%s' contains an xagent without a name, in XMLStateReader::parse()\n", filename.c_str());
+        }
+        // Find agent state, use initial state if not set (means its old flame gpu 1 input file)
+        if (!has_state) {
+            const auto& it = model->agents.find(current_agent);
+            current_state = it != model->agents.end() ? it->second->initial_state : ModelData::DEFAULT_STATE;
+        }
+        AgentVector &pop = getPopulation(current_agent, current_state);
+        if (index_agent) {
+            (*index_agent)(current_agent_offset, &pop, false);
+            return;
+        }
+        unsigned int agent_index = 0;
+        for (auto &p : chunk_populations) {
+            if (p.first == &pop) {
+                agent_index = p.second++;
+                break;
             }
-            const std::type_index val_type = it->second.type;
-            const unsigned int elements = std::accumulate(it->second.elements.begin(), it->second.elements.end(), 1, std::multiplies<unsigned int>());
-            unsigned int el = 0;
-            while (getline(ss, token, ',')) {
-                if (el == 0) {
-                    if (!macro_env_init.emplace(std::string(key), std::vector<char>(elements * it->second.type_size)).second) {
-                        THROW exception::TinyXMLError("Input file contains macro environment property '%s' multiple times, "
-                            "in XMLStateReader::parse()\n", key);
+        }
+        --chunk_remaining;
+        const AgentVector &c_pop = pop;
+        const VariableMap& agentVariables = pop.getVariableMetaData();
+        size_t found_variables = 0;
+        for (size_t i = 0; i < current_variable_count; ++i) {
+            const std::string &variable_name = current_variables[i].first;
+            const auto var_it = agentVariables.find(variable_name);
+            if (var_it == agentVariables.end()) {
+                // Unrecognised elements are ignored
+                continue;
+            }
+            ++found_variables;
+            const auto &var_data = var_it->second;
+            const size_t v_size = var_data.type_size * var_data.elements;
+            // Const accessor, to avoid the overhead of change tracking
+            char *data = static_cast<char*>(const_cast<void*>(c_pop.data(variable_name))) + agent_index * v_size;
+            const unsigned int el = parseValues(current_variables[i].second, var_data.type, data, var_data.elements, "agent variable", variable_name);
+            if (el > var_data.elements) {
+                THROW exception::TinyXMLError("Input file contains agent variable '%s:%s' with more than the expected %u elements, "
+                    "in XMLStateReader::parse()\n", current_agent.c_str(), variable_name.c_str(), var_data.elements);
+            } else if (el != var_data.elements && verbosity > Verbosity::Quiet && !hasWarnedElements.exchange(true)) {
+                // Warn if var is wrong length
+                fprintf(stderr, "Warning: Agent '%s' variable '%s' expects '%u' elements, input file '%s' contains '%u' elements.\n",
+                    current_agent.c_str(), variable_name.c_str(), var_data.elements, filename.c_str(), el);
+            }
+        }
+        if (found_variables < agentVariables.size() && !hasWarnedMissingVar && verbosity > Verbosity::Quiet) {
+            for (const auto &var : agentVariables) {
+                const auto begin = current_variables.begin();
+                const auto end = begin + current_variable_count;
+                if (var.first.find('_', 0) != 0 &&
+                    std::find_if(begin, end, [&var](const std::pair<std::string, std::string> &v) { return v.first == var.first; }) == end) {
+                    if (!hasWarnedMissingVar.exchange(true)) {
+                        fprintf(stderr, "Warning: Agent '%s' variable '%s' is missing from, input file '%s'.\n",
+                            current_agent.c_str(), var.first.c_str(), filename.c_str());
                     }
-                } else if (el >= elements) {
-                    THROW exception::RapidJSONError("Input file contains macro environment property '%s' too many elements, expected %u,"
-                        "in XMLStateReader::parse()\n", key, elements);
-                }
-                auto &mei = macro_env_init.at(key);
-                if (val_type == std::type_index(typeid(float))) {
-                    static_cast<float*>(static_cast<void*>(mei.data()))[el++] = stof(token);
-                } else if (val_type == std::type_index(typeid(double))) {
-                    static_cast<double*>(static_cast<void*>(mei.data()))[el++] = stod(token);
-                } else if (val_type == std::type_index(typeid(int64_t))) {
-                    static_cast<int64_t*>(static_cast<void*>(mei.data()))[el++] = stoll(token);
-                } else if (val_type == std::type_index(typeid(uint64_t))) {
-                    static_cast<uint64_t*>(static_cast<void*>(mei.data()))[el++] = stoull(token);
-                } else if (val_type == std::type_index(typeid(int32_t))) {
-                    static_cast<int32_t*>(static_cast<void*>(mei.data()))[el++] = static_cast<int32_t>(stoll(token));
-                } else if (val_type == std::type_index(typeid(uint32_t))) {
-                    static_cast<uint32_t*>(static_cast<void*>(mei.data()))[el++] = static_cast<uint32_t>(stoull(token));
-                } else if (val_type == std::type_index(typeid(int16_t))) {
-                    static_cast<int16_t*>(static_cast<void*>(mei.data()))[el++] = static_cast<int16_t>(stoll(token));
-                } else if (val_type == std::type_index(typeid(uint16_t))) {
-                    static_cast<uint16_t*>(static_cast<void*>(mei.data()))[el++] = static_cast<uint16_t>(stoull(token));
-                } else if (val_type == std::type_index(typeid(int8_t))) {
-                    static_cast<int8_t*>(static_cast<void*>(mei.data()))[el++] = static_cast<int8_t>(stoll(token));
-                } else if (val_type == std::type_index(typeid(uint8_t))) {
-                    static_cast<uint8_t*>(static_cast<void*>(mei.data()))[el++] = static_cast<uint8_t>(stoull(token));
-                } else {
-                    THROW exception::TinyXMLError("Model contains macro environment property '%s' of unsupported type '%s', "
-                        "in XMLStateReader::parse()\n", key, val_type.name());
+                    break;
                 }
             }
-            if (el != elements && verbosity > Verbosity::Quiet) {
-                fprintf(stderr, "Warning: Macro environment property '%s' expects '%u' elements, input file '%s' contains '%u' elements.\n",
-                    key, elements, inputFile.c_str(), el);
-            }
         }
-    } else if (verbosity > Verbosity::Quiet) {
-        fprintf(stderr, "Warning: Input file '%s' does not contain macro environment node.\n", inputFile.c_str());
     }
 
-    // Count how many of each agent are in the file and resize state lists
-    util::StringPairUnorderedMap<unsigned int> cts;
-    for (pElement = pRoot->FirstChildElement("xagent"); pElement != nullptr; pElement = pElement->NextSiblingElement("xagent")) {
-        std::string agent_name = pElement->FirstChildElement("name")->GetText();
-        tinyxml2::XMLElement *state_element = pElement->FirstChildElement("state");
-        std::string state_name = state_element ? state_element->GetText() : getInitialState(model, agent_name);
-        cts[{agent_name, state_name}]++;
-    }
+ public:
+    bool hasEnvironment = false;
+    bool hasMacroEnvironment = false;
 
-    // Init state lists to correct size
-    for (const auto& it : cts) {
-        const auto& agent = model->agents.find(it.first.first);
-        if (agent == model->agents.end() || agent->second->states.find(it.first.second) == agent->second->states.end()) {
-            THROW exception::InvalidAgentState("Agent '%s' with state '%s', found in input file '%s', is not part of the model description hierarchy, "
-                "in XMLStateReader::parse()\n Ensure the input file is for the correct model.\n", it.first.first.c_str(), it.first.second.c_str(), inputFile.c_str());
-        }
-        auto [_it, _] = agents_map.emplace(it.first, std::make_shared<AgentVector>(*agent->second));
-        _it->second->reserve(it.second);
+    XMLStateReader_impl(const std::string &_filename,
+        const std::shared_ptr<const ModelData> &_model,
+        std::unordered_map<std::string, std::any> &_simulation_config,
+        std::unordered_map<std::string, std::any> &_cuda_config,
+        std::unordered_map<std::string, detail::Any> &_env_init,
+        std::unordered_map<std::string, std::vector<char>> & _macro_env_init,
+        util::StringPairUnorderedMap<std::shared_ptr<AgentVector>> &_agents_map,
+        Verbosity _verbosity,
+        std::atomic<bool> &_hasWarnedElements,
+        std::atomic<bool> &_hasWarnedMissingVar)
+        : filename(_filename)
+        , model(_model)
+        , simulation_config(_simulation_config)
+        , cuda_config(_cuda_config)
+        , env_init(_env_init)
+        , macro_env_init(_macro_env_init)
+        , agents_map(_agents_map)
+        , verbosity(_verbosity)
+        , hasWarnedElements(_hasWarnedElements)
+        , hasWarnedMissingVar(_hasWarnedMissingVar) { }
+    /**
+     * Configure the handler to perform the first pass over the file
+     * @param _index_agent Receives the file offset and population of each xagent
+     */
+    void beginIndex(const std::function<void(uint64_t, AgentVector*, bool)> *_index_agent) {
+        index_agent = _index_agent;
     }
-
-    bool hasWarnedElements = false;
-    bool hasWarnedMissingVar = false;
-    // Read in agent data
-    for (pElement = pRoot->FirstChildElement("xagent"); pElement != nullptr; pElement = pElement->NextSiblingElement("xagent")) {
-        // Find agent name
-        tinyxml2::XMLElement* pNameElement = pElement->FirstChildElement("name");
-        const char* agentName = pNameElement->GetText();
-        // Find agent state, use initial state if not set (means its old flame gpu 1 input file)
-        tinyxml2::XMLElement* pStateElement = pElement->FirstChildElement("state");
-        const std::string agentState = pStateElement ? std::string(pStateElement->GetText()) : getInitialState(model, agentName);
-        const auto agentIt = agents_map.find({ agentName, agentState });
-        if (agentIt == agents_map.end()) {
-            THROW exception::InvalidAgentState("Agent '%s' with state '%s', found in input file '%s', is not part of the model description hierarchy, "
-                "in XMLStateReader::parse()\n Ensure the input file is for the correct model.\n", agentName, agentState.c_str(), inputFile.c_str());
-        }
-        std::shared_ptr<AgentVector> &agentVec = agentIt->second;
-        const VariableMap& agentVariables = agentVec->getVariableMetaData();
-        // Create instance to store variable data in
-        agentVec->push_back();
-        AgentVector::Agent instance = agentVec->back();
-        // Iterate agent variables
-        for (auto iter = agentVariables.begin(); iter != agentVariables.end(); ++iter) {
-            const std::string variable_name = iter->first;
-            const auto &var_data = iter->second;
-            tinyxml2::XMLElement* pVarElement = pElement->FirstChildElement(variable_name.c_str());
-            if (pVarElement) {
-                // Put string for the variable into a string stream
-                std::stringstream ss(pVarElement->GetText());
-                std::string token;
-                const size_t v_size = var_data.type_size * var_data.elements;
-                char* data = static_cast<char*>(const_cast<void*>(static_cast<std::shared_ptr<const AgentVector>>(agentVec)->data(variable_name)));
-                // Iterate elements of the stringstream
-                unsigned int el = 0;
-                while (getline(ss, token, ',')) {
-                    if (var_data.type == std::type_index(typeid(float))) {
-                        const float t = stof(token);
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(double))) {
-                        const double t = stod(token);
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(int64_t))) {
-                        const int64_t t = stoll(token);
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(uint64_t))) {
-                        const uint64_t t = stoull(token);
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(int32_t))) {
-                        const int32_t t = static_cast<int32_t>(stoll(token));
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(uint32_t))) {
-                        const uint32_t t = static_cast<uint32_t>(stoull(token));
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(int16_t))) {
-                        const int16_t t = static_cast<int16_t>(stoll(token));
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(uint16_t))) {
-                        const uint16_t t = static_cast<uint16_t>(stoull(token));
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(int8_t))) {
-                        const int8_t t = static_cast<int8_t>(stoll(token));
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else if (var_data.type == std::type_index(typeid(uint8_t))) {
-                        const uint8_t t = static_cast<uint8_t>(stoull(token));
-                        memcpy(data + ((agentVec->size() - 1) * v_size) + (var_data.type_size * el++), &t, var_data.type_size);
-                    } else {
-                        THROW exception::TinyXMLError("Agent '%s' contains variable '%s' of unsupported type '%s', "
-                            "in XMLStateReader::parse()\n", agentName, variable_name.c_str(), var_data.type.name());
-                    }
-                }
-                // Warn if var is wrong length
-                if (el != var_data.elements && !hasWarnedElements && verbosity > Verbosity::Quiet) {
-                    fprintf(stderr, "Warning: Agent '%s' variable '%s' expects '%u' elements, input file '%s' contains '%u' elements.\n",
-                        agentName, variable_name.c_str(), var_data.elements, inputFile.c_str(), el);
-                    hasWarnedElements = true;
+    /**
+     * Configure the handler to parse a chunk of xagents, the parser must be positioned at the chunk's first xagent
+     * Elements other than xagent, which are encountered between the chunk's xagents, are skipped as they were parsed by the first pass
+     * @param populations The populations of the chunk's xagents, and the index of the chunk's first agent within each
+     * @param agent_count The number of xagents within the chunk
+     */
+    void beginChunk(const std::vector<std::pair<AgentVector*, unsigned int>> &populations, const unsigned int agent_count) {
+        mode.assign(1, Root);
+        chunk_populations = populations;
+        chunk_remaining = agent_count;
+        is_chunk = true;
+    }
+    /**
+     * Returns true once all of the chunk's xagents have been parsed
+     */
+    bool isComplete() const {
+        return is_chunk && chunk_remaining == 0;
+    }
+    void startElement(const std::string &name, const size_t depth, const uint64_t offset) {
+        const Mode parent = depth ? mode[depth - 1] : Nop;
+        Mode m = Nop;
+        if (depth == 0) {
+            m = Root;
+        } else if (parent == Root && is_chunk) {
+            if (name == "xagent") {
+                m = Agent;
+                current_agent.clear();
+                has_state = false;
+                current_variable_count = 0;
+            }
+        } else if (parent == Root) {
+            if (name == "config") {
+                m = Config;
+            } else if (name == "environment") {
+                m = Environment;
+                hasEnvironment = true;
+            } else if (name == "macro_environment") {
+                m = MacroEnvironment;
+                hasMacroEnvironment = true;
+            } else if (name == "xagent") {
+                m = Agent;
+                current_agent.clear();
+                has_state = false;
+                current_variable_count = 0;
+                current_agent_offset = offset;
+            }
+        } else if (parent == Config) {
+            if (name == "simulation") {
+                m = SimCfg;
+            } else if (name == "cuda") {
+                m = CUDACfg;
+            }
+        }
+        mode.resize(depth);
+        mode.push_back(m);
+    }
+    void endElement(const std::string &name, const std::string &text, const size_t depth) {
+        const Mode m = mode[depth];
+        const Mode parent = depth ? mode[depth - 1] : Nop;
+        if (m == Agent) {
+            processAgent();
+        } else if (parent == SimCfg) {
+            processSimCfg(name, text);
+        } else if (parent == CUDACfg) {
+            processCUDACfg(name, text);
+        } else if (parent == Environment) {
+            processEnvironment(name, text);
+        } else if (parent == MacroEnvironment) {
+            processMacroEnvironment(name, text);
+        } else if (parent == Agent) {
+            if (name == "name") {
+                current_agent = text;
+            } else if (name == "state") {
+                current_state = text;
+                has_state = true;
+            } else if (!index_agent) {
+                if (current_variables.size() == current_variable_count) {
+                    current_variables.emplace_back();
                 }
-            } else if (!hasWarnedMissingVar && variable_name.find('_', 0) != 0 && verbosity > Verbosity::Quiet) {
-                fprintf(stderr, "Warning: Agent '%s' variable '%s' is missing from, input file '%s'.\n",
-                    agentName, variable_name.c_str(), inputFile.c_str());
-                hasWarnedMissingVar = true;
+                current_variables[current_variable_count].first = name;
+                current_variables[current_variable_count++].second = text;
             }
         }
     }
+};
 
+void XMLStateReader::parse(const std::string &inputFile, const std::shared_ptr<const ModelData> &model, Verbosity verbosity) {
+    resetCache();
+
+    std::atomic<bool> hasWarnedElements = false;
+    std::atomic<bool> hasWarnedMissingVar = false;
+    // First pass, parse everything except agent variables, and build an index of chunks of xagents
+    std::vector<AgentChunk> chunks;
+    {
+        std::unique_ptr<FILE, int(*)(FILE*)> in = openFile(inputFile);
+        XMLStateReader_impl handler(inputFile, model, simulation_config, cuda_config, env_init, macro_env_init, agents_map, verbosity, hasWarnedElements, hasWarnedMissingVar);
+        const std::function<void(uint64_t, AgentVector*, bool)> index_agent = [&chunks](uint64_t file_offset, AgentVector *population, bool new_run) {
+            addAgentToChunks(chunks, file_offset, population, new_run);
+        };
+        handler.beginIndex(&index_agent);
+        // Stream the file through a fixed size buffer, rather than loading the whole file into memory
+        XMLStreamParser parser(in.get(), inputFile);
+        parser.parse(handler);
+        if (!handler.hasEnvironment && verbosity > Verbosity::Quiet) {
+            fprintf(stderr, "Warning: Input file '%s' does not contain environment node.\n", inputFile.c_str());
+        }
+        if (!handler.hasMacroEnvironment && verbosity > Verbosity::Quiet) {
+            fprintf(stderr, "Warning: Input file '%s' does not contain macro environment node.\n", inputFile.c_str());
+        }
+    }
+    // Second pass, parse the xagents of each chunk in parallel
+    parseChunks(chunks, [&](const AgentChunk &chunk) {
+        std::unique_ptr<FILE, int(*)(FILE*)> in = openFile(inputFile, chunk.file_offset);
+        XMLStateReader_impl handler(inputFile, model, simulation_config, cuda_config, env_init, macro_env_init, agents_map, verbosity, hasWarnedElements, hasWarnedMissingVar);
+        handler.beginChunk(chunk.populations, chunk.agent_count);
+        XMLStreamParser parser(in.get(), inputFile, chunk.file_offset);
+        parser.parse(handler, true);
+    });
     // Mark input as loaded
     this->input_filepath = inputFile;
 }
 
-std::string XMLStateReader::getInitialState(const std::shared_ptr<const ModelData> &model, const std::string &agent_name) {
-    const auto& it = model->agents.find(agent_name);
-    if (it != model->agents.end()) {
-        return it->second->initial_state;
-    }
-    return ModelData::DEFAULT_STATE;
-}
 }  // namespace io
 }  // namespace flamegpu
@@ -1,10 +1,12 @@
 #include "flamegpu/model/DependencyGraph.h"
 
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <set>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 
 namespace flamegpu {
 
@@ -63,20 +65,54 @@ void DependencyGraph::addRoot(DependencyNode& root) {
 }
 
 bool DependencyGraph::validateDependencyGraph() const {
-    std::vector<DependencyNode*> functionStack;
+    topologicalSort();
+    return true;
+}
 
+std::vector<DependencyNode*> DependencyGraph::topologicalSort() const {
     if (roots.size() == 0) {
-            THROW exception::InvalidDependencyGraph("Warning! Agent function dependency graph is empty!");
+        THROW exception::InvalidDependencyGraph("Warning! Agent function dependency graph is empty!");
     }
+    // Discover all nodes reachable from the roots, counting the number of dependencies of each
+    std::unordered_map<DependencyNode*, unsigned int> dependencyCount;
+    std::vector<DependencyNode*> frontier;
+    std::vector<DependencyNode*> order;
     for (const auto& root : roots) {
-        if (root->getDependencies().size() != 0) {
+        if (root->dependencies.size() != 0) {
             THROW exception::InvalidDependencyGraph("Warning! Root agent function has dependencies!");
         }
-        if (!validateSubTree(root, functionStack)) {
-            THROW exception::InvalidDependencyGraph("Warning! Dependency graph validation failed! Does the graph have a cycle?");
+        if (dependencyCount.emplace(root, 0).second) {
+            frontier.push_back(root);
+            order.push_back(root);
         }
     }
-    return true;
+    while (!frontier.empty()) {
+        DependencyNode* node = frontier.back();
+        frontier.pop_back();
+        for (const auto& child : node->dependents) {
+            auto it = dependencyCount.find(child);
+            if (it == dependencyCount.end()) {
+                dependencyCount.emplace(child, 1);
+                frontier.push_back(child);
+            } else {
+                ++it->second;
+            }
+        }
+    }
+    // Kahn's algorithm, beginning from the roots a node is visited once all of its dependencies have been visited
+    order.reserve(dependencyCount.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (const auto& child : order[i]->dependents) {
+            if (--dependencyCount.at(child) == 0) {
+                order.push_back(child);
+            }
+        }
+    }
+    // Nodes within a cycle never have all of their dependencies visited
+    if (order.size() != dependencyCount.size()) {
+        THROW exception::InvalidDependencyGraph("Warning! Dependency graph validation failed! Does the graph have a cycle?");
+    }
+    return order;
 }
 
 LayerDescription DependencyGraph::newModelLayer() {
@@ -93,170 +129,152 @@ void DependencyGraph::generateLayers() {
     }
 
     // Check dependency graph is valid before we attempt to build layers
-    validateDependencyGraph();
-    checkForUnattachedFunctions();
-
-    // Lambda to walk the graph and set minimum layer depths of nodes
-    std::function<void(DependencyNode*, int)> setMinLayerDepths;
-    setMinLayerDepths = [&setMinLayerDepths] (DependencyNode* node, int depth) {
-        if (depth >= node->getMinimumLayerDepth()) {
-            node->setMinimumLayerDepth(depth);
-        }
-        for (auto child : node->getDependents()) {
-            setMinLayerDepths(child, depth + 1);
-        }
-    };
+    const std::vector<DependencyNode*> order = topologicalSort();
+    checkForUnattachedFunctions(order);
 
-    // Set minimum layer depths
-    for (auto root : roots) {
-        setMinLayerDepths(root, 0);
+    // Index nodes by their position in the topological order
+    std::unordered_map<DependencyNode*, size_t> nodeIndex;
+    for (size_t i = 0; i < order.size(); ++i) {
+        nodeIndex.emplace(order[i], i);
     }
-
-    // Build list of functions in their respective ideal layers assuming no conflicts
-    std::vector<std::vector<DependencyNode*>> idealLayers;
-    std::function<void(DependencyNode*)> buildIdealLayers;
-    buildIdealLayers = [&buildIdealLayers, &idealLayers] (DependencyNode* node) {
-        // New layers required
-        std::vector<std::vector<DependencyNode*>>::size_type nodeDepth = node->getMinimumLayerDepth();
-        while (nodeDepth >= idealLayers.size()) {
-            idealLayers.push_back(std::vector<DependencyNode*>());
+    // Walk the order forwards to find each node's minimum layer depth and number of dependencies
+    std::vector<int> minDepth(order.size(), 0);
+    std::vector<unsigned int> pendingDependencies(order.size(), 0);
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i]->setMinimumLayerDepth(minDepth[i]);
+        for (const auto& child : order[i]->dependents) {
+            const size_t c = nodeIndex.at(child);
+            minDepth[c] = std::max(minDepth[c], minDepth[i] + 1);
+            ++pendingDependencies[c];
         }
-
-        // Add node to relevant layer if node hasn't already been added
-        bool alreadyAdded = false;
-        for (auto& includedNode : idealLayers[nodeDepth]) {
-            if (node == includedNode) {
-                alreadyAdded = true;
-            }
-        }
-        if (!alreadyAdded) {
-            idealLayers[nodeDepth].push_back(node);
+    }
+    // Walk the order backwards to find the length of the longest chain starting at each node
+    std::vector<unsigned int> chainLength(order.size(), 1);
+    for (size_t i = order.size(); i-- > 0;) {
+        for (const auto& child : order[i]->dependents) {
+            chainLength[i] = std::max(chainLength[i], chainLength[nodeIndex.at(child)] + 1);
         }
+    }
 
-        // Repeat for children
-        for (auto child : node->getDependents()) {
-            buildIdealLayers(child);
-        }
+    // List scheduling, nodes whose dependencies have all been placed are ready
+    // Ready nodes which begin the longest remaining chain are placed first, as delaying them would delay the whole chain
+    // Ties are placed in topological order, so that layers are deterministic
+    auto priority = [&chainLength](const size_t lhs, const size_t rhs) {
+        return chainLength[lhs] != chainLength[rhs] ? chainLength[lhs] > chainLength[rhs] : lhs < rhs;
     };
-
-    for (auto root : roots) {
-        buildIdealLayers(root);
+    std::set<size_t, decltype(priority)> ready(priority);
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (pendingDependencies[i] == 0) {
+            ready.insert(i);
+        }
     }
-
-    // idealLayers now contains DependencyNode pointers in their ideal layers, i.e. assuming no conflicts.
-    // Now iterate structure attempting to add functions to layers.
-    // If we encounter conflicts, introduce additional layers as necessary
     constructedLayers.clear();
-    for (auto idealLayer : idealLayers) {
-        // Request a new layer from the model
-        LayerDescription layer = newModelLayer();
-        constructedLayers.emplace_back();
-        // Attempt to add each node in the idealLayer to the layer
-        for (auto node : idealLayer) {
-            // Add node based on its concrete type
-            // Agent function
-            if (AgentFunctionDescription* afd = dynamic_cast<AgentFunctionDescription*>(node)) {
-                try {
-                    layer.addAgentFunction(*afd);
-                    constructedLayers.back().emplace_back(DependencyGraph::getNodeName(afd));
-                } catch (const exception::InvalidAgentFunc&) {
-                    // Conflict, create new layer and add to that instead
-                    LayerDescription newLayer = newModelLayer();
-                    newLayer.addAgentFunction(*afd);
-                    constructedLayers.emplace_back();
-                    constructedLayers.back().emplace_back(DependencyGraph::getNodeName(afd));
-                    // printf("New function execution layer created - exception::InvalidAgentFunc exception\n");
-                } catch (const exception::InvalidLayerMember&) {
-                    LayerDescription newLayer = newModelLayer();
-                    newLayer.addAgentFunction(*afd);
-                    constructedLayers.emplace_back();
-                    constructedLayers.back().emplace_back(DependencyGraph::getNodeName(afd));
-                    // printf("New function execution layer created - exception::InvalidLayerMember exception\n");
+    std::vector<flamegpu::size_type> nodeLayer(order.size(), 0);
+    std::vector<size_t> layerNodes;
+    std::vector<const AgentFunctionData*> layerFunctions;
+    while (!ready.empty()) {
+        layerNodes.clear();
+        layerFunctions.clear();
+        // Host functions and submodels must execute alone within their layer
+        // Otherwise fill the layer with all ready agent functions which do not conflict with those already in the layer
+        if (dynamic_cast<CAgentFunctionDescription*>(order[*ready.begin()])) {
+            for (const size_t i : ready) {
+                if (const CAgentFunctionDescription* afd = dynamic_cast<CAgentFunctionDescription*>(order[i])) {
+                    bool conflict = false;
+                    for (const auto& f : layerFunctions) {
+                        if (agentFunctionsConflict(*afd->function, *f)) {
+                            conflict = true;
+                            break;
+                        }
+                    }
+                    if (!conflict) {
+                        layerNodes.push_back(i);
+                        layerFunctions.push_back(afd->function.get());
+                    }
                 }
             }
-
-            // Submodel
-            if (SubModelDescription* smd = dynamic_cast<SubModelDescription*>(node)) {
-                try {
-                    layer.addSubModel(*smd);
-                    constructedLayers.back().emplace_back(DependencyGraph::getNodeName(smd));
-                } catch (const exception::InvalidLayerMember&) {
-                    LayerDescription newLayer = newModelLayer();
-                    newLayer.addSubModel(*smd);
-                    constructedLayers.emplace_back();
-                    constructedLayers.back().emplace_back(DependencyGraph::getNodeName(smd));
-                    // printf("New submodel layer created - exception::InvalidLayerMember exception\n");
-                } catch (const exception::InvalidSubModel&) {
-                    LayerDescription newLayer = newModelLayer();
-                    newLayer.addSubModel(*smd);
-                    constructedLayers.emplace_back();
-                    constructedLayers.back().emplace_back(DependencyGraph::getNodeName(smd));
-                    // printf("New submodel layer created - exception::InvalidSubModel exception\n");
+        } else {
+            layerNodes.push_back(*ready.begin());
+        }
+        // Request a new layer from the model, and add the selected nodes
+        LayerDescription layer = newModelLayer();
+        LayerData& layerData = *model->layers.back();
+        constructedLayers.emplace_back();
+        for (const size_t i : layerNodes) {
+            addNodeToLayer(layer, order[i]);
+            constructedLayers.back().emplace_back(DependencyGraph::getNodeName(order[i]));
+            ready.erase(i);
+            // Record the node's dependencies, so that they are available to the simulation
+            nodeLayer[i] = layerData.index;
+            std::vector<LayerData::MemberID>& dependencies = layerData.dependencies[getNodeMemberName(order[i])];
+            for (const auto& dependency : order[i]->dependencies) {
+                const auto it = nodeIndex.find(dependency);
+                if (it != nodeIndex.end()) {
+                    dependencies.emplace_back(nodeLayer[it->second], getNodeMemberName(dependency));
                 }
             }
-
-            // Host function
-            if (HostFunctionDescription* hdf = dynamic_cast<HostFunctionDescription*>(node)) {
-                // function ptr, callback object should be mutually exclusive. Callback only used for SWIG, ptr only for non-SWIG.
-                // If ptr is available, use that
-                if (hdf->getFunctionPtr() != nullptr) {
-                    try {
-                        layer.addHostFunction(hdf->getFunctionPtr());
-                        constructedLayers.back().emplace_back(DependencyGraph::getNodeName(hdf));
-                    } catch (const exception::InvalidLayerMember&) {
-                        LayerDescription newLayer = newModelLayer();
-                        newLayer.addHostFunction(hdf->getFunctionPtr());
-                        constructedLayers.emplace_back();
-                        constructedLayers.back().emplace_back(DependencyGraph::getNodeName(hdf));
-                        // printf("New host function layer created - exception::InvalidLayerMember exception\n");
-                    }
-                } else {
-                    try {
-                        layer._addHostFunction(hdf->getCallbackObject());
-                        constructedLayers.back().emplace_back(DependencyGraph::getNodeName(hdf));
-                    } catch (const exception::InvalidLayerMember&) {
-                        LayerDescription newLayer = newModelLayer();
-                        newLayer._addHostFunction(hdf->getCallbackObject());
-                        constructedLayers.emplace_back();
-                        constructedLayers.back().emplace_back(DependencyGraph::getNodeName(hdf));
-                        // printf("New host function layer created - exception::InvalidLayerMember exception\n");
-                    }
+        }
+        // Dependents become ready once all of their dependencies have been placed
+        for (const size_t i : layerNodes) {
+            for (const auto& child : order[i]->dependents) {
+                const size_t c = nodeIndex.at(child);
+                if (--pendingDependencies[c] == 0) {
+                    ready.insert(c);
                 }
             }
         }
     }
 }
 
-bool DependencyGraph::validateSubTree(DependencyNode* node, std::vector<DependencyNode*>& functionStack) const {
-    // Check if the function we are looking at already exists on the stack - if so we have a cycle
-    if (doesFunctionExistInStack(node, functionStack)) {
-        return false;
-    }
-
-    // No cycle detected, check if all child nodes form valid subtrees
-    functionStack.push_back(node);
-    for (auto child : node->getDependents()) {
-        if (!validateSubTree(child, functionStack))
-            return false;
+void DependencyGraph::addNodeToLayer(LayerDescription& layer, DependencyNode* node) {
+    // Add node based on its concrete type
+    if (CAgentFunctionDescription* afd = dynamic_cast<CAgentFunctionDescription*>(node)) {
+        layer.addAgentFunction(*afd);
+    } else if (CSubModelDescription* smd = dynamic_cast<CSubModelDescription*>(node)) {
+        layer.addSubModel(*smd);
+    } else if (HostFunctionDescription* hdf = dynamic_cast<HostFunctionDescription*>(node)) {
+        // function ptr, callback object should be mutually exclusive. Callback only used for SWIG, ptr only for non-SWIG.
+        // If ptr is available, use that
+        if (hdf->getFunctionPtr() != nullptr) {
+            layer.addHostFunction(hdf->getFunctionPtr());
+        } else {
+            layer._addHostFunction(hdf->getCallbackObject());
+        }
     }
-
-    // No problems, tree formed by this node and its children is valid
-    // Pop this function from the stack and return
-    functionStack.pop_back();
-    return true;
 }
 
-bool DependencyGraph::doesFunctionExistInStack(DependencyNode* function, std::vector<DependencyNode*>& functionStack) const {
-    // Iterating vector probably faster than using constant lookup structure for likely number of elements
-    for (const auto fn : functionStack) {
-        if (fn == function) {
+bool DependencyGraph::agentFunctionsConflict(const AgentFunctionData& a, const AgentFunctionData& b) {
+    const auto a_parent = a.parent.lock();
+    const auto b_parent = b.parent.lock();
+    // Functions of the same agent may not share an input or output state
+    if (a_parent && b_parent && a_parent->name == b_parent->name) {
+        if (a.initial_state == b.initial_state ||
+            a.initial_state == b.end_state ||
+            a.end_state == b.initial_state ||
+            a.end_state == b.end_state) {
             return true;
         }
     }
-    return false;
+    // A function may not birth agents into the state which another function requires as an input
+    const auto a_agent_out = a.agent_output.lock();
+    if (a_agent_out && b_parent && a_agent_out->name == b_parent->name && a.agent_output_state == b.initial_state) {
+        return true;
+    }
+    const auto b_agent_out = b.agent_output.lock();
+    if (b_agent_out && a_parent && b_agent_out->name == a_parent->name && b.agent_output_state == a.initial_state) {
+        return true;
+    }
+    // Functions may not both access a message list, unless both only input from it
+    const auto a_message_out = a.message_output.lock();
+    const auto a_message_in = a.message_input.lock();
+    const auto b_message_out = b.message_output.lock();
+    const auto b_message_in = b.message_input.lock();
+    return (a_message_out && b_message_out && a_message_out == b_message_out) ||
+        (a_message_out && b_message_in && a_message_out == b_message_in) ||
+        (a_message_in && b_message_out && a_message_in == b_message_out);
 }
 
-void DependencyGraph::checkForUnattachedFunctions() {
+void DependencyGraph::checkForUnattachedFunctions(const std::vector<DependencyNode*>& nodes) {
     // Build set of model's agent functions
     std::set<AgentFunctionData*> modelFunctions;
     for (const auto& agent : model->agents) {
@@ -267,18 +285,10 @@ void DependencyGraph::checkForUnattachedFunctions() {
 
     // Build set of functions present in the dependency graph
     std::set<AgentFunctionData*> graphFunctions;
-    std::function<void(DependencyNode*)> captureFunctions;
-    captureFunctions = [&captureFunctions, &graphFunctions] (DependencyNode* node) {
+    for (const auto& node : nodes) {
         if (CAgentFunctionDescription* afd = dynamic_cast<CAgentFunctionDescription*>(node)) {
             graphFunctions.insert(afd->function.get());
         }
-        for (const auto& child : node->getDependents()) {
-            captureFunctions(child);
-        }
-    };
-
-    for (auto& root : roots) {
-        captureFunctions(root);
     }
 
     // Compare sets
@@ -299,6 +309,13 @@ std::string DependencyGraph::getNodeName(DependencyNode* node) {
     }
 }
 
+util::StringPair DependencyGraph::getNodeMemberName(DependencyNode* node) {
+    if (CAgentFunctionDescription* afd = dynamic_cast<CAgentFunctionDescription*>(node)) {
+        return {afd->function->parent.lock()->name, afd->function->name};
+    }
+    return {};
+}
+
 void DependencyGraph::generateDOTDiagram(std::string outputFileName) const {
     validateDependencyGraph();
     std::ofstream DOTFile(outputFileName);
@@ -18,7 +18,8 @@ LayerData::LayerData(const std::shared_ptr<const ModelData> &_model, const Layer
     , host_functions(other.host_functions)
     , host_functions_callbacks(other.host_functions_callbacks)
     , name(other.name)
-    , index(other.index) {
+    , index(other.index)
+    , dependencies(other.dependencies) {
     // Manually perform lookup copies
     for (auto &_f : other.agent_functions) {
         for (auto &a : _model->agents) {
@@ -46,6 +47,7 @@ bool LayerData::operator==(const LayerData &rhs) const {
     if (name == rhs.name
     //  && model.lock() == rhs.model.lock()  // Don't check weak pointers
     && index == rhs.index
+    && dependencies == rhs.dependencies
     && agent_functions.size() == rhs.agent_functions.size()
     && host_functions.size() == rhs.host_functions.size()
     && host_functions_callbacks.size() == rhs.host_functions_callbacks.size()
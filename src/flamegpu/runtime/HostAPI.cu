@@ -18,6 +18,7 @@ HostAPI::HostAPI(CUDASimulation &_agentModel,
     detail::CUDAScatter &_scatter,
     const AgentOffsetMap &_agentOffsets,
     AgentDataMap &_agentData,
+    AgentBatchMap &_agentBatches,
     const std::shared_ptr<detail::EnvironmentManager>& env,
     const std::shared_ptr<detail::CUDAMacroEnvironment>& macro_env,
     CUDADirectedGraphMap &directed_graph_map,
@@ -30,6 +31,7 @@ HostAPI::HostAPI(CUDASimulation &_agentModel,
     , d_output_space_size(0)
     , agentOffsets(_agentOffsets)
     , agentData(_agentData)
+    , agentBatches(_agentBatches)
     , scatter(_scatter)
     , streamId(_streamId)
     , stream(_stream) { }
@@ -51,7 +53,7 @@ HostAgentAPI HostAPI::agent(const std::string &agent_name, const std::string &st
     if (state == agt->second.end()) {
         THROW exception::InvalidAgentState("Agent '%s' in model description hierarchy does not contain state '%s'.\n", agent_name.c_str(), state_name.c_str());
     }
-    return HostAgentAPI(*this, agentModel.getCUDAAgent(agent_name), state_name, agentOffsets.at(agent_name), state->second);
+    return HostAgentAPI(*this, agentModel.getCUDAAgent(agent_name), state_name, agentOffsets.at(agent_name), state->second, agentBatches.at(agent_name).at(state_name));
 }
 
 unsigned int HostAPI::getStepCounter() const {
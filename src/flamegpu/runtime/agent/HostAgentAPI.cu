@@ -12,6 +12,18 @@ HostNewAgentAPI HostAgentAPI::newAgent() {
     // Point the returned object to the created agent
     return HostNewAgentAPI(newAgentData.back());
 }
+HostNewAgentBatch HostAgentAPI::newAgents(const unsigned int count) {
+    // Reuse storage released by a previous step's batch, if available
+    std::vector<char> buffer;
+    if (!newAgentBatches.released.empty()) {
+        buffer = std::move(newAgentBatches.released.back());
+        newAgentBatches.released.pop_back();
+    }
+    // Create the batch in our backing data structure, reserving a contiguous block of IDs
+    newAgentBatches.batches.emplace_back(agentOffsets, count, agent.nextID(count), std::move(buffer));
+    // Point the returned object to the created batch
+    return HostNewAgentBatch(newAgentBatches.batches.back());
+}
 
 unsigned HostAgentAPI::count() {
     std::shared_ptr<DeviceAgentVector_impl> d_vec = agent.getPopulationVec(stateName);
@@ -1,3 +1,4 @@
+#include <map>
 #include <sstream>
 #include <set>
 #include <string>
@@ -66,6 +67,18 @@ namespace curve {
  * EnvData size must be a multiple of 8 bytes
  */
 $DYNAMIC_VARIABLES
+/**
+ * Description of a variable within the dynamic curve buffer, returned by the variable lookups below
+ * The lookups are inlined and constant folded, as variable names are string literals
+ */
+struct RTCVariable {
+    bool read;
+    bool write;
+    unsigned int type_size;
+    unsigned int elements;
+    unsigned int offset;
+};
+$DYNAMIC_VARIABLE_LOOKUPS
 
 class DeviceCurve {
     public:
@@ -136,11 +149,43 @@ class DeviceCurve {
 
 template <typename T, unsigned int N>
 __device__ __forceinline__ T DeviceCurve::getAgentVariable(const char (&name)[N], unsigned int index) {
-$DYNAMIC_GETAGENTVARIABLE_IMPL
+    const RTCVariable v = agentVariable(name);
+    if (v.read) {
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Agent variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        } else if (detail::type_decode<T>::len_t != v.elements) {
+            DTHROW("Agent variable '%s' length mismatch during getVariable().\n", name);
+            return {};
+        }
+#endif
+        return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[index];
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Agent variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
 template <typename T, unsigned int N>
 __device__ __forceinline__ T DeviceCurve::getMessageVariable(const char (&name)[N], unsigned int index) {
-$DYNAMIC_GETMESSAGEVARIABLE_IMPL
+    const RTCVariable v = messageInVariable(name);
+    if (v.read) {
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Message variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        } else if (detail::type_decode<T>::len_t != v.elements) {
+            DTHROW("Message variable '%s' length mismatch during getVariable().\n", name);
+            return {};
+        }
+#endif
+        return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[index];
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Message variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
 
 template <typename T, unsigned int N>
@@ -154,20 +199,88 @@ $DYNAMIC_GETDIRECTEDGRAPHEDGEPROPERTY_IMPL
 
 template <typename T, unsigned int N>
 __device__ __forceinline__ T DeviceCurve::getAgentVariable_ldg(const char (&name)[N], unsigned int index) {
-$DYNAMIC_GETAGENTVARIABLE_LDG_IMPL
+    const RTCVariable v = agentVariable(name);
+    if (v.read && v.elements == 1) {  // GLM does not support __ldg() so should not use this
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(T) != v.type_size) {
+            DTHROW("Agent variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        }
+#endif
+        return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset))) + index);
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Agent variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
 template <typename T, unsigned int N>
 __device__ __forceinline__ T DeviceCurve::getMessageVariable_ldg(const char (&name)[N], unsigned int index) {
-$DYNAMIC_GETMESSAGEVARIABLE_LDG_IMPL
+    const RTCVariable v = messageInVariable(name);
+    if (v.read && v.elements == 1) {  // GLM does not support __ldg() so should not use this
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(T) != v.type_size) {
+            DTHROW("Message variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        }
+#endif
+        return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset))) + index);
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Message variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
 
 template <typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ T DeviceCurve::getAgentArrayVariable(const char(&name)[M], unsigned int index, unsigned int array_index) {
-$DYNAMIC_GETAGENTARRAYVARIABLE_IMPL
+    const RTCVariable v = agentVariable(name);
+    if (v.read && v.elements > 1) {
+        const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Agent array variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        } else if (detail::type_decode<T>::len_t * N != v.elements) {
+            DTHROW("Agent array variable '%s' length mismatch during getVariable().\n", name);
+            return {};
+        } else if (t_index > v.elements || t_index < array_index) {
+            DTHROW("Agent array variable '%s', index %d is out of bounds during getVariable().\n", name, array_index);
+            return {};
+        }
+#endif
+        return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[i];
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Agent array variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
 template <typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ T DeviceCurve::getMessageArrayVariable(const char(&name)[M], unsigned int index, unsigned int array_index) {
-$DYNAMIC_GETMESSAGEARRAYVARIABLE_IMPL
+    const RTCVariable v = messageInVariable(name);
+    if (v.read && v.elements > 1) {
+        const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Message array variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        } else if (detail::type_decode<T>::len_t * N != v.elements) {
+            DTHROW("Message array variable '%s' length mismatch during getVariable().\n", name);
+            return {};
+        } else if (t_index > v.elements || t_index < array_index) {
+            DTHROW("Message array variable '%s', index %d is out of bounds during getVariable().\n", name, array_index);
+            return {};
+        }
+#endif
+        return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[i];
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Message array variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
     
 
@@ -191,37 +304,188 @@ $DYNAMIC_GETDIRECTEDGRAPHEDGEARRAYPROPERTY_IMPL
 
 template <typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ T DeviceCurve::getAgentArrayVariable_ldg(const char(&name)[M], unsigned int index, unsigned int array_index) {
-$DYNAMIC_GETAGENTARRAYVARIABLE_LDG_IMPL
+    const RTCVariable v = agentVariable(name);
+    if (v.read && v.elements > 1) {  // GLM does not support __ldg() so should not use this
+        const size_t i = (index * N) + array_index;
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(T) != v.type_size) {
+            DTHROW("Agent array variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        } else if (N != v.elements) {
+            DTHROW("Agent array variable '%s' length mismatch during getVariable().\n", name);
+            return {};
+        } else if (array_index >= v.elements) {
+            DTHROW("Agent array variable '%s', index %d is out of bounds during getVariable().\n", name, array_index);
+            return {};
+        }
+#endif
+        return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset))) + i);
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Agent array variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
 template <typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ T DeviceCurve::getMessageArrayVariable_ldg(const char(&name)[M], unsigned int index, unsigned int array_index) {
-$DYNAMIC_GETMESSAGEARRAYVARIABLE_LDG_IMPL
+    const RTCVariable v = messageInVariable(name);
+    if (v.read && v.elements > 1) {  // GLM does not support __ldg() so should not use this
+        const size_t i = (index * N) + array_index;
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(T) != v.type_size) {
+            DTHROW("Message array variable '%s' type mismatch during getVariable().\n", name);
+            return {};
+        } else if (N != v.elements) {
+            DTHROW("Message array variable '%s' length mismatch during getVariable().\n", name);
+            return {};
+        } else if (array_index >= v.elements) {
+            DTHROW("Message array variable '%s', index %d is out of bounds during getVariable().\n", name, array_index);
+            return {};
+        }
+#endif
+        return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset))) + i);
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Message array variable '%s' was not found during getVariable().\n", name);
+#endif
+    return {};
 }
 
 template <typename T, unsigned int N>
 __device__ __forceinline__ void DeviceCurve::setAgentVariable(const char(&name)[N], T variable, unsigned int index) {
-$DYNAMIC_SETAGENTVARIABLE_IMPL
+    const RTCVariable v = agentVariable(name);
+    if (v.write) {
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Agent variable '%s' type mismatch during setVariable().\n", name);
+            return;
+        } else if (detail::type_decode<T>::len_t != v.elements) {
+            DTHROW("Agent variable '%s' length mismatch during setVariable().\n", name);
+            return;
+        }
+#endif
+        (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[index] = (T) variable;
+        return;
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Agent variable '%s' was not found during setVariable().\n", name);
+#endif
 }
 template <typename T, unsigned int N>
 __device__ __forceinline__ void DeviceCurve::setMessageVariable(const char(&name)[N], T variable, unsigned int index) {
-$DYNAMIC_SETMESSAGEVARIABLE_IMPL
+    const RTCVariable v = messageOutVariable(name);
+    if (v.write) {
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Message variable '%s' type mismatch during setVariable().\n", name);
+            return;
+        } else if (detail::type_decode<T>::len_t != v.elements) {
+            DTHROW("Message variable '%s' length mismatch during setVariable().\n", name);
+            return;
+        }
+#endif
+        (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[index] = (T) variable;
+        return;
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Message variable '%s' was not found during setVariable().\n", name);
+#endif
 }
 template <typename T, unsigned int N>
 __device__ __forceinline__ void DeviceCurve::setNewAgentVariable(const char(&name)[N], T variable, unsigned int index) {
-$DYNAMIC_SETNEWAGENTVARIABLE_IMPL
+    const RTCVariable v = newAgentVariable(name);
+    if (v.write) {
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("New agent variable '%s' type mismatch during setVariable().\n", name);
+            return;
+        } else if (detail::type_decode<T>::len_t != v.elements) {
+            DTHROW("New agent variable '%s' length mismatch during setVariable().\n", name);
+            return;
+        }
+#endif
+        (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[index] = (T) variable;
+        return;
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("New agent variable '%s' was not found during setVariable().\n", name);
+#endif
 }
 
 template <typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ void DeviceCurve::setAgentArrayVariable(const char(&name)[M], T variable, unsigned int index, unsigned int array_index) {
-$DYNAMIC_SETAGENTARRAYVARIABLE_IMPL    
+    const RTCVariable v = agentVariable(name);
+    if (v.write && v.elements > 1) {
+        const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Agent array variable '%s' type mismatch during setVariable().\n", name);
+            return;
+        } else if (detail::type_decode<T>::len_t * N != v.elements) {
+            DTHROW("Agent array variable '%s' length mismatch during setVariable().\n", name);
+            return;
+        } else if (t_index > v.elements || t_index < array_index) {
+            DTHROW("Agent array variable '%s', index %d is out of bounds during setVariable().\n", name, array_index);
+            return;
+        }
+#endif
+        (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[i] = (T) variable;
+        return;
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Agent array variable '%s' was not found during setVariable().\n", name);
+#endif
 }
 template <typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ void DeviceCurve::setMessageArrayVariable(const char(&name)[M], T variable, unsigned int index, unsigned int array_index) {
-$DYNAMIC_SETMESSAGEARRAYVARIABLE_IMPL    
+    const RTCVariable v = messageOutVariable(name);
+    if (v.write && v.elements > 1) {
+        const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Message array variable '%s' type mismatch during setVariable().\n", name);
+            return;
+        } else if (detail::type_decode<T>::len_t * N != v.elements) {
+            DTHROW("Message array variable '%s' length mismatch during setVariable().\n", name);
+            return;
+        } else if (t_index > v.elements || t_index < array_index) {
+            DTHROW("Message array variable '%s', index %d is out of bounds during setVariable().\n", name, array_index);
+            return;
+        }
+#endif
+        (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[i] = (T) variable;
+        return;
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Message array variable '%s' was not found during setVariable().\n", name);
+#endif
 }
 template <typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ void DeviceCurve::setNewAgentArrayVariable(const char(&name)[M], T variable, unsigned int index, unsigned int array_index) {
-$DYNAMIC_SETNEWAGENTARRAYVARIABLE_IMPL    
+    const RTCVariable v = newAgentVariable(name);
+    if (v.write && v.elements > 1) {
+        const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("New agent array variable '%s' type mismatch during setVariable().\n", name);
+            return;
+        } else if (detail::type_decode<T>::len_t * N != v.elements) {
+            DTHROW("New agent array variable '%s' length mismatch during setVariable().\n", name);
+            return;
+        } else if (t_index > v.elements || t_index < array_index) {
+            DTHROW("New agent array variable '%s', index %d is out of bounds during setVariable().\n", name, array_index);
+            return;
+        }
+#endif
+        (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset)))[i] = (T) variable;
+        return;
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("New agent array variable '%s' was not found during setVariable().\n", name);
+#endif
 }
 
 template <unsigned int M>
@@ -253,12 +517,48 @@ namespace flamegpu {
 
 template<typename T, unsigned int M>
 __device__ __forceinline__ T ReadOnlyDeviceEnvironment::getProperty(const char(&name)[M]) const {
-$DYNAMIC_ENV_GETVARIABLE_IMPL
+    const detail::curve::RTCVariable v = detail::curve::environmentProperty(name);
+    if (v.read) {
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Environment property '%s' type mismatch.\n", name);
+            return {};
+        } else if (detail::type_decode<T>::len_t != v.elements) {
+            DTHROW("Environment property '%s' length mismatch.\n", name);
+            return {};
+        }
+#endif
+        return *reinterpret_cast<T*>(reinterpret_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset));
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Environment property '%s' was not found.\n", name);
+#endif
+    return {};
 }
 
 template<typename T, unsigned int N, unsigned int M>
 __device__ __forceinline__ T ReadOnlyDeviceEnvironment::getProperty(const char(&name)[M], const unsigned int index) const {
-$DYNAMIC_ENV_GETARRAYVARIABLE_IMPL
+    const detail::curve::RTCVariable v = detail::curve::environmentProperty(name);
+    if (v.read && v.elements > 1) {
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+        const unsigned int t_index = detail::type_decode<T>::len_t * index + detail::type_decode<T>::len_t;
+        if (sizeof(detail::type_decode<T>::type_t) != v.type_size) {
+            DTHROW("Environment array property '%s' type mismatch.\n", name);
+            return {};
+        } else if (detail::type_decode<T>::len_t * N != v.elements && N != 0) {  // Special case, env array specifying length is optional as it's not actually required
+            DTHROW("Environment array property '%s' length mismatch.\n", name);
+            return {};
+        } else if (t_index > v.elements || t_index < index) {
+            DTHROW("Environment array property '%s', index %d is out of bounds.\n", name, index);
+            return {};
+        }
+#endif
+        return reinterpret_cast<T*>(reinterpret_cast<void*>(flamegpu::detail::curve::rtc_env_data_curve + v.offset))[index];
+    }
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    DTHROW("Environment array property '%s' was not found.\n", name);
+#endif
+    return {};
 }
 
 
@@ -586,62 +886,6 @@ void CurveRTCHost::initHeaderEnvironment(const size_t env_buffer_len) {
     count_data_offset = data_buffer_size;  data_buffer_size += count_buffer.size() * sizeof(unsigned int);
     variables << "__constant__  char " << getVariableSymbolName() << "[" << data_buffer_size << "];\n";
     setHeaderPlaceholder("$DYNAMIC_VARIABLES", variables.str());
-    // generate Environment::get func implementation ($DYNAMIC_ENV_GETVARIABLE_IMPL)
-    {
-        std::stringstream getEnvVariableImpl;
-        for (std::pair<std::string, RTCEnvVariableProperties> element : RTCEnvVariables) {
-            RTCEnvVariableProperties props = element.second;
-            {
-                getEnvVariableImpl <<   "    if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getEnvVariableImpl <<   "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getEnvVariableImpl <<   "        if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                getEnvVariableImpl <<   "            DTHROW(\"Environment property '%s' type mismatch.\\n\", name);\n";
-                getEnvVariableImpl <<   "            return {};\n";
-                getEnvVariableImpl <<   "        } else if(detail::type_decode<T>::len_t != " << element.second.elements << ") {\n";
-                getEnvVariableImpl <<   "            DTHROW(\"Environment property '%s' length mismatch.\\n\", name);\n";
-                getEnvVariableImpl <<   "            return {};\n";
-                getEnvVariableImpl <<   "        }\n";
-                getEnvVariableImpl <<   "#endif\n";
-                getEnvVariableImpl <<   "        return *reinterpret_cast<T*>(reinterpret_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() <<" + " << props.offset << "));\n";
-                getEnvVariableImpl <<   "    };\n";
-            }
-        }
-        getEnvVariableImpl <<           "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getEnvVariableImpl <<           "    DTHROW(\"Environment property '%s' was not found.\\n\", name);\n";
-        getEnvVariableImpl <<           "#endif\n";
-        getEnvVariableImpl <<           "    return  {};\n";
-        setHeaderPlaceholder("$DYNAMIC_ENV_GETVARIABLE_IMPL", getEnvVariableImpl.str());
-    }
-    // generate Environment::get func implementation for array variables ($DYNAMIC_ENV_GETARRAYVARIABLE_IMPL)
-    {
-        std::stringstream getEnvArrayVariableImpl;
-        for (std::pair<std::string, RTCEnvVariableProperties> element : RTCEnvVariables) {
-            RTCEnvVariableProperties props = element.second;
-            if (props.elements > 1) {
-                getEnvArrayVariableImpl << "    if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getEnvArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getEnvArrayVariableImpl << "        const unsigned int t_index = detail::type_decode<T>::len_t * index + detail::type_decode<T>::len_t;\n";
-                getEnvArrayVariableImpl << "        if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                getEnvArrayVariableImpl << "            DTHROW(\"Environment array property '%s' type mismatch.\\n\", name);\n";
-                getEnvArrayVariableImpl << "            return {};\n";
-                getEnvArrayVariableImpl << "        } else if (detail::type_decode<T>::len_t * N != " << element.second.elements << " && N != 0) {\n";  // Special case, env array specifying length is optional as it's not actually required
-                getEnvArrayVariableImpl << "            DTHROW(\"Environment array property '%s' length mismatch.\\n\", name);\n";
-                getEnvArrayVariableImpl << "            return {};\n";
-                getEnvArrayVariableImpl << "        } else if (t_index > " << element.second.elements << " || t_index < index) {\n";
-                getEnvArrayVariableImpl << "            DTHROW(\"Environment array property '%s', index %d is out of bounds.\\n\", name, index);\n";
-                getEnvArrayVariableImpl << "            return {};\n";
-                getEnvArrayVariableImpl << "        }\n";
-                getEnvArrayVariableImpl << "#endif\n";
-                getEnvArrayVariableImpl << "        return reinterpret_cast<T*>(reinterpret_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() <<" + " << props.offset << "))[index];\n";
-                getEnvArrayVariableImpl << "    };\n";
-            }
-        }
-        getEnvArrayVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getEnvArrayVariableImpl <<         "    DTHROW(\"Environment array property '%s' was not found.\\n\", name);\n";
-        getEnvArrayVariableImpl <<         "#endif\n";
-        getEnvArrayVariableImpl <<         "    return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_ENV_GETARRAYVARIABLE_IMPL", getEnvArrayVariableImpl.str());
-    }
     // generate Environment::getMacroProperty func implementation ($DYNAMIC_ENV_GETREADONLYMACROPROPERTY_IMPL)
     {
         size_t ct = 0;
@@ -713,259 +957,49 @@ void CurveRTCHost::initHeaderEnvironment(const size_t env_buffer_len) {
         setHeaderPlaceholder("$DYNAMIC_ENV_GETMACROPROPERTY_IMPL", getMacroPropertyImpl.str());
     }
 }
-void CurveRTCHost::initHeaderSetters() {
-    // generate setAgentVariable func implementation ($DYNAMIC_SETAGENTVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream setAgentVariableImpl;
-        for (const auto &element : agent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.write) {
-                setAgentVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                setAgentVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                setAgentVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                setAgentVariableImpl << "                  DTHROW(\"Agent variable '%s' type mismatch during setVariable().\\n\", name);\n";
-                setAgentVariableImpl << "                  return;\n";
-                setAgentVariableImpl << "              } else if(detail::type_decode<T>::len_t != " << element.second.elements << ") {\n";
-                setAgentVariableImpl << "                  DTHROW(\"Agent variable '%s' length mismatch during setVariable().\\n\", name);\n";
-                setAgentVariableImpl << "                  return;\n";
-                setAgentVariableImpl << "              }\n";
-                setAgentVariableImpl << "#endif\n";
-                setAgentVariableImpl << "              (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << agent_data_offset + (ct++ * sizeof(void*)) << ")))[index] = (T) variable;\n";
-                setAgentVariableImpl << "              return;\n";
-                setAgentVariableImpl << "          }\n";
-            } else {
-                ++ct;
-            }
-        }
-        setAgentVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        setAgentVariableImpl <<         "          DTHROW(\"Agent variable '%s' was not found during setVariable().\\n\", name);\n";
-        setAgentVariableImpl <<         "#endif\n";
-        setHeaderPlaceholder("$DYNAMIC_SETAGENTVARIABLE_IMPL", setAgentVariableImpl.str());
-    }
-    // generate setMessageVariable func implementation ($DYNAMIC_SETMESSAGEVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream setMessageVariableImpl;
-        for (const auto &element : messageOut_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.write) {
-                setMessageVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                setMessageVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                setMessageVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                setMessageVariableImpl << "                  DTHROW(\"Message variable '%s' type mismatch during setVariable().\\n\", name);\n";
-                setMessageVariableImpl << "                  return;\n";
-                setMessageVariableImpl << "              } else if(detail::type_decode<T>::len_t != " << element.second.elements << ") {\n";
-                setMessageVariableImpl << "                  DTHROW(\"Message variable '%s' length mismatch during setVariable().\\n\", name);\n";
-                setMessageVariableImpl << "                  return;\n";
-                setMessageVariableImpl << "              }\n";
-                setMessageVariableImpl << "#endif\n";
-                setMessageVariableImpl << "              (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << messageOut_data_offset + (ct++ * sizeof(void*)) << ")))[index] = (T) variable;\n";
-                setMessageVariableImpl << "              return;\n";
-                setMessageVariableImpl << "          }\n";
-            } else {
-                ++ct;
-            }
-        }
-        setMessageVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        setMessageVariableImpl <<         "          DTHROW(\"Message variable '%s' was not found during setVariable().\\n\", name);\n";
-        setMessageVariableImpl <<         "#endif\n";
-        setHeaderPlaceholder("$DYNAMIC_SETMESSAGEVARIABLE_IMPL", setMessageVariableImpl.str());
-    }
-    // generate setNewAgentVariable func implementation ($DYNAMIC_SETNEWAGENTVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream setNewAgentVariableImpl;
-        for (const auto &element : newAgent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.write) {
-                setNewAgentVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                setNewAgentVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                setNewAgentVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                setNewAgentVariableImpl << "                  DTHROW(\"New agent variable '%s' type mismatch during setVariable().\\n\", name);\n";
-                setNewAgentVariableImpl << "                  return;\n";
-                setNewAgentVariableImpl << "              } else if(detail::type_decode<T>::len_t != " << element.second.elements << ") {\n";
-                setNewAgentVariableImpl << "                  DTHROW(\"New agent variable '%s' length mismatch during setVariable().\\n\", name);\n";
-                setNewAgentVariableImpl << "                  return;\n";
-                setNewAgentVariableImpl << "              }\n";
-                setNewAgentVariableImpl << "#endif\n";
-                setNewAgentVariableImpl << "              (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << newAgent_data_offset + (ct++ * sizeof(void*)) << ")))[index] = (T) variable;\n";
-                setNewAgentVariableImpl << "              return;\n";
-                setNewAgentVariableImpl << "          }\n";
-            } else {
-                ++ct;
-            }
-        }
-        setNewAgentVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        setNewAgentVariableImpl <<         "          DTHROW(\"New agent variable '%s' was not found during setVariable().\\n\", name);\n";
-        setNewAgentVariableImpl <<         "#endif\n";
-        setHeaderPlaceholder("$DYNAMIC_SETNEWAGENTVARIABLE_IMPL", setNewAgentVariableImpl.str());
-    }
-    // generate setAgentArrayVariable func implementation ($DYNAMIC_SETAGENTARRAYVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream setAgentArrayVariableImpl;
-        if (!agent_variables.empty())
-            setAgentArrayVariableImpl <<             "    const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;\n";
-        for (const auto &element : agent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.write && props.elements > 1) {
-                setAgentArrayVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                setAgentArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                setAgentArrayVariableImpl << "              const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;\n";
-                setAgentArrayVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                setAgentArrayVariableImpl << "                  DTHROW(\"Agent array variable '%s' type mismatch during setVariable().\\n\", name);\n";
-                setAgentArrayVariableImpl << "                  return;\n";
-                setAgentArrayVariableImpl << "              } else if (detail::type_decode<T>::len_t * N != " << element.second.elements << ") {\n";
-                setAgentArrayVariableImpl << "                  DTHROW(\"Agent array variable '%s' length mismatch during setVariable().\\n\", name);\n";
-                setAgentArrayVariableImpl << "                  return;\n";
-                setAgentArrayVariableImpl << "              } else if (t_index > " << element.second.elements << " || t_index < array_index) {\n";
-                setAgentArrayVariableImpl << "                  DTHROW(\"Agent array variable '%s', index %d is out of bounds during setVariable().\\n\", name, array_index);\n";
-                setAgentArrayVariableImpl << "                  return;\n";
-                setAgentArrayVariableImpl << "              }\n";
-                setAgentArrayVariableImpl << "#endif\n";
-                setAgentArrayVariableImpl << "              (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << agent_data_offset + (ct++ * sizeof(void*)) << ")))[i] = (T) variable;\n";
-                setAgentArrayVariableImpl << "              return;\n";
-                setAgentArrayVariableImpl << "          }\n";
-            } else {
-                ++ct;
-            }
-        }
-        setAgentArrayVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        setAgentArrayVariableImpl <<         "          DTHROW(\"Agent array variable '%s' was not found during setVariable().\\n\", name);\n";
-        setAgentArrayVariableImpl <<         "#endif\n";
-        setHeaderPlaceholder("$DYNAMIC_SETAGENTARRAYVARIABLE_IMPL", setAgentArrayVariableImpl.str());
+void CurveRTCHost::initHeaderLookups() {
+    std::stringstream lookups;
+    writeVariableLookup(lookups, "agentVariable", agent_variables, agent_data_offset);
+    writeVariableLookup(lookups, "messageInVariable", messageIn_variables, messageIn_data_offset);
+    writeVariableLookup(lookups, "messageOutVariable", messageOut_variables, messageOut_data_offset);
+    writeVariableLookup(lookups, "newAgentVariable", newAgent_variables, newAgent_data_offset);
+    // Environment properties are stored inline within the buffer, rather than as a pointer
+    std::map<size_t, std::stringstream> buckets;
+    for (const auto &element : RTCEnvVariables) {
+        buckets[element.first.length()] << "        if (strings_equal(name, \"" << element.first << "\")) return {true, false, "
+            << element.second.type_size << ", " << element.second.elements << ", " << element.second.offset << "};\n";
+    }
+    writeLookupFunction(lookups, "environmentProperty", buckets);
+    setHeaderPlaceholder("$DYNAMIC_VARIABLE_LOOKUPS", lookups.str());
+}
+void CurveRTCHost::writeVariableLookup(std::stringstream &out, const char *function_name, const std::map<std::string, RTCVariableProperties> &variables, const size_t data_offset) {
+    // Offsets follow map order, matching initDataBuffer()
+    std::map<size_t, std::stringstream> buckets;
+    size_t ct = 0;
+    for (const auto &element : variables) {
+        buckets[element.first.length()] << "        if (strings_equal(name, \"" << element.first << "\")) return {"
+            << (element.second.read ? "true" : "false") << ", " << (element.second.write ? "true" : "false") << ", "
+            << element.second.type_size << ", " << element.second.elements << ", " << data_offset + (ct++ * sizeof(void*)) << "};\n";
     }
-    // generate setMessageArrayVariable func implementation ($DYNAMIC_SETMESSAGEARRAYVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream setMessageArrayVariableImpl;
-        if (!messageOut_variables.empty())
-            setMessageArrayVariableImpl << "    const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;\n";
-        for (const auto& element : messageOut_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.write && props.elements > 1) {
-                setMessageArrayVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                setMessageArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                setMessageArrayVariableImpl << "              const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;\n";
-                setMessageArrayVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                setMessageArrayVariableImpl << "                  DTHROW(\"Message array variable '%s' type mismatch during setVariable().\\n\", name);\n";
-                setMessageArrayVariableImpl << "                  return;\n";
-                setMessageArrayVariableImpl << "              } else if (detail::type_decode<T>::len_t * N != " << element.second.elements << ") {\n";
-                setMessageArrayVariableImpl << "                  DTHROW(\"Message array variable '%s' length mismatch during setVariable().\\n\", name);\n";
-                setMessageArrayVariableImpl << "                  return;\n";
-                setMessageArrayVariableImpl << "              } else if (t_index > " << element.second.elements << " || t_index < array_index) {\n";
-                setMessageArrayVariableImpl << "                  DTHROW(\"Message array variable '%s', index %d is out of bounds during setVariable().\\n\", name, array_index);\n";
-                setMessageArrayVariableImpl << "                  return;\n";
-                setMessageArrayVariableImpl << "              }\n";
-                setMessageArrayVariableImpl << "#endif\n";
-                setMessageArrayVariableImpl << "              (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << messageOut_data_offset + (ct++ * sizeof(void*)) << ")))[i] = (T) variable;\n";
-                setMessageArrayVariableImpl << "              return;\n";
-                setMessageArrayVariableImpl << "          }\n";
-            } else {
-                ++ct;
-            }
-        }
-        setMessageArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        setMessageArrayVariableImpl << "          DTHROW(\"Message array variable '%s' was not found during setVariable().\\n\", name);\n";
-        setMessageArrayVariableImpl << "#endif\n";
-        setHeaderPlaceholder("$DYNAMIC_SETMESSAGEARRAYVARIABLE_IMPL", setMessageArrayVariableImpl.str());
+    writeLookupFunction(out, function_name, buckets);
+}
+void CurveRTCHost::writeLookupFunction(std::stringstream &out, const char *function_name, const std::map<size_t, std::stringstream> &buckets) {
+    // Names are bucketed by length, so each instantiation only compares against names of the same length as the literal
+    out << "template <unsigned int N>\n";
+    out << "__device__ __forceinline__ RTCVariable " << function_name << "(const char(&name)[N]) {\n";
+    bool first = true;
+    for (const auto &bucket : buckets) {
+        out << (first ? "    if" : "    } else if") << " constexpr (N == " << bucket.first + 1 << ") {\n";
+        out << bucket.second.str();
+        first = false;
     }
-    // generate setNewAgentArrayVariable func implementation ($DYNAMIC_SETNEWAGENTARRAYVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream setNewAgentArrayVariableImpl;
-        if (!newAgent_variables.empty())
-            setNewAgentArrayVariableImpl << "    const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;\n";
-        for (const auto &element : newAgent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.write && props.elements > 1) {
-                setNewAgentArrayVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                setNewAgentArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                setNewAgentArrayVariableImpl << "              const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;\n";
-                setNewAgentArrayVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                setNewAgentArrayVariableImpl << "                  DTHROW(\"New agent array variable '%s' type mismatch during setVariable().\\n\", name);\n";
-                setNewAgentArrayVariableImpl << "                  return;\n";
-                setNewAgentArrayVariableImpl << "              } else if (detail::type_decode<T>::len_t * N != " << element.second.elements << ") {\n";
-                setNewAgentArrayVariableImpl << "                  DTHROW(\"New agent array variable '%s' length mismatch during setVariable().\\n\", name);\n";
-                setNewAgentArrayVariableImpl << "                  return;\n";
-                setNewAgentArrayVariableImpl << "              } else if (t_index > " << element.second.elements << " || t_index < array_index) {\n";
-                setNewAgentArrayVariableImpl << "                  DTHROW(\"New agent array variable '%s', index %d is out of bounds during setVariable().\\n\", name, array_index);\n";
-                setNewAgentArrayVariableImpl << "                  return;\n";
-                setNewAgentArrayVariableImpl << "              }\n";
-                setNewAgentArrayVariableImpl << "#endif\n";
-                setNewAgentArrayVariableImpl << "              (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << newAgent_data_offset + (ct++ * sizeof(void*)) << ")))[i] = (T) variable;\n";
-                setNewAgentArrayVariableImpl << "              return;\n";
-                setNewAgentArrayVariableImpl << "          }\n";
-            } else {
-                ++ct;
-            }
-        }
-        setNewAgentArrayVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        setNewAgentArrayVariableImpl <<         "          DTHROW(\"New agent array variable '%s' was not found during setVariable().\\n\", name);\n";
-        setNewAgentArrayVariableImpl <<         "#endif\n";
-        setHeaderPlaceholder("$DYNAMIC_SETNEWAGENTARRAYVARIABLE_IMPL", setNewAgentArrayVariableImpl.str());
+    if (!first) {
+        out << "    }\n";
     }
+    out << "    return {false, false, 0, 0, 0};\n";
+    out << "}\n";
 }
 void CurveRTCHost::initHeaderGetters() {
-    // generate getAgentVariable func implementation ($DYNAMIC_GETAGENTVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getAgentVariableImpl;
-        for (const auto &element : agent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read) {
-                getAgentVariableImpl << "            if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getAgentVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getAgentVariableImpl << "                if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                getAgentVariableImpl << "                    DTHROW(\"Agent variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getAgentVariableImpl << "                    return {};\n";
-                getAgentVariableImpl << "                } else if(detail::type_decode<T>::len_t != " << element.second.elements << ") {\n";
-                getAgentVariableImpl << "                    DTHROW(\"Agent variable '%s' length mismatch during getVariable().\\n\", name);\n";
-                getAgentVariableImpl << "                    return {};\n";
-                getAgentVariableImpl << "                }\n";
-                getAgentVariableImpl << "#endif\n";
-                getAgentVariableImpl << "                return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << agent_data_offset + (ct++ * sizeof(void*)) << ")))[index];\n";
-                getAgentVariableImpl << "            }\n";
-            } else {
-                ++ct;
-            }
-        }
-        getAgentVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getAgentVariableImpl <<         "            DTHROW(\"Agent variable '%s' was not found during getVariable().\\n\", name);\n";
-        getAgentVariableImpl <<         "#endif\n";
-        getAgentVariableImpl <<         "            return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETAGENTVARIABLE_IMPL", getAgentVariableImpl.str());
-    }
-    // generate getMessageVariable func implementation ($DYNAMIC_GETMESSAGEVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getMessageVariableImpl;
-        for (const auto &element : messageIn_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read) {
-                getMessageVariableImpl << "            if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getMessageVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getMessageVariableImpl << "                if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                getMessageVariableImpl << "                    DTHROW(\"Message variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getMessageVariableImpl << "                    return {};\n";
-                getMessageVariableImpl << "                } else if(detail::type_decode<T>::len_t != " << element.second.elements << ") {\n";
-                getMessageVariableImpl << "                    DTHROW(\"Message variable '%s' length mismatch during getVariable().\\n\", name);\n";
-                getMessageVariableImpl << "                    return {};\n";
-                getMessageVariableImpl << "                }\n";
-                getMessageVariableImpl << "#endif\n";
-                getMessageVariableImpl << "                return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << messageIn_data_offset + (ct++ * sizeof(void*)) << ")))[index];\n";
-                getMessageVariableImpl << "            }\n";
-            } else {
-                ++ct;
-            }
-        }
-        getMessageVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getMessageVariableImpl <<         "            DTHROW(\"Message variable '%s' was not found during getVariable().\\n\", name);\n";
-        getMessageVariableImpl <<         "#endif\n";
-        getMessageVariableImpl <<         "            return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETMESSAGEVARIABLE_IMPL", getMessageVariableImpl.str());
-    }
     // getEnvironmentDirectedGraphPBM
     {
         size_t ct = 0;
@@ -1084,130 +1118,6 @@ void CurveRTCHost::initHeaderGetters() {
         getGraphEdgePropertyImpl << "            return {};\n";
         setHeaderPlaceholder("$DYNAMIC_GETDIRECTEDGRAPHEDGEPROPERTY_IMPL", getGraphEdgePropertyImpl.str());
     }
-    // generate getAgentVariable_ldg func implementation ($DYNAMIC_GETAGENTVARIABLE_LDG_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getAgentVariableLDGImpl;
-        for (const auto &element : agent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read && props.elements == 1) {  // GLM does not support __ldg() so should not use this
-                getAgentVariableLDGImpl << "            if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getAgentVariableLDGImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getAgentVariableLDGImpl << "                if(sizeof(T) != " << element.second.type_size * element.second.elements << ") {\n";
-                getAgentVariableLDGImpl << "                    DTHROW(\"Agent variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getAgentVariableLDGImpl << "                    return {};\n";
-                getAgentVariableLDGImpl << "                }\n";
-                getAgentVariableLDGImpl << "#endif\n";
-                getAgentVariableLDGImpl << "                return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << agent_data_offset + (ct * sizeof(void*)) << "))) + index);\n";
-                getAgentVariableLDGImpl << "            }\n";
-                ++ct;  // Prev was part of the return line, but don't want confusion
-            } else {
-                ++ct;
-            }
-        }
-        getAgentVariableLDGImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getAgentVariableLDGImpl <<         "            DTHROW(\"Agent variable '%s' was not found during getVariable().\\n\", name);\n";
-        getAgentVariableLDGImpl <<         "#endif\n";
-        getAgentVariableLDGImpl <<         "            return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETAGENTVARIABLE_LDG_IMPL", getAgentVariableLDGImpl.str());
-    }
-    // generate getMessageVariable_ldg func implementation ($DYNAMIC_GETMESSAGEVARIABLE_LDG_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getMessageVariableLDGImpl;
-        for (const auto &element : messageIn_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read && props.elements == 1) {  // GLM does not support __ldg() so should not use this
-                getMessageVariableLDGImpl << "            if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getMessageVariableLDGImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getMessageVariableLDGImpl << "                if(sizeof(T) != " << element.second.type_size << ") {\n";
-                getMessageVariableLDGImpl << "                    DTHROW(\"Message variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getMessageVariableLDGImpl << "                    return {};\n";
-                getMessageVariableLDGImpl << "                }\n";
-                getMessageVariableLDGImpl << "#endif\n";
-                getMessageVariableLDGImpl << "                return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << messageIn_data_offset + (ct * sizeof(void*)) << "))) + index);\n";
-                getMessageVariableLDGImpl << "            }\n";
-                ++ct;  // Prev was part of the return line, but don't want confusion
-            } else {
-                ++ct;
-            }
-        }
-        getMessageVariableLDGImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getMessageVariableLDGImpl <<         "            DTHROW(\"Message variable '%s' was not found during getVariable().\\n\", name);\n";
-        getMessageVariableLDGImpl <<         "#endif\n";
-        getMessageVariableLDGImpl <<         "            return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETMESSAGEVARIABLE_LDG_IMPL", getMessageVariableLDGImpl.str());
-    }
-    // generate getAgentArrayVariable func implementation ($DYNAMIC_GETAGENTARRAYVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getAgentArrayVariableImpl;
-        if (!agent_variables.empty())
-            getAgentArrayVariableImpl << "    const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;\n";
-        for (const auto &element : agent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read && props.elements > 1) {
-                getAgentArrayVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getAgentArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getAgentArrayVariableImpl << "              const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;\n";
-                getAgentArrayVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                getAgentArrayVariableImpl << "                  DTHROW(\"Agent array variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getAgentArrayVariableImpl << "                  return {};\n";
-                getAgentArrayVariableImpl << "              } else if (detail::type_decode<T>::len_t * N != " << element.second.elements << ") {\n";
-                getAgentArrayVariableImpl << "                  DTHROW(\"Agent array variable '%s' length mismatch during getVariable().\\n\", name);\n";
-                getAgentArrayVariableImpl << "                  return {};\n";
-                getAgentArrayVariableImpl << "              } else if (t_index > " << element.second.elements << " || t_index < array_index) {\n";
-                getAgentArrayVariableImpl << "                  DTHROW(\"Agent array variable '%s', index %d is out of bounds during getVariable().\\n\", name, array_index);\n";
-                getAgentArrayVariableImpl << "                  return {};\n";
-                getAgentArrayVariableImpl << "              }\n";
-                getAgentArrayVariableImpl << "#endif\n";
-                getAgentArrayVariableImpl << "              return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << agent_data_offset + (ct++ * sizeof(void*)) << ")))[i];\n";
-                getAgentArrayVariableImpl << "           };\n";
-            } else {
-                ++ct;
-            }
-        }
-        getAgentArrayVariableImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getAgentArrayVariableImpl <<         "           DTHROW(\"Agent array variable '%s' was not found during getVariable().\\n\", name);\n";
-        getAgentArrayVariableImpl <<         "#endif\n";
-        getAgentArrayVariableImpl <<         "           return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETAGENTARRAYVARIABLE_IMPL", getAgentArrayVariableImpl.str());
-    }
-    // generate getMessageArrayVariable func implementation ($DYNAMIC_GETMESSAGEARRAYVARIABLE_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getMessageArrayVariableImpl;
-        if (!messageIn_variables.empty())
-            getMessageArrayVariableImpl << "    const size_t i = (index * detail::type_decode<T>::len_t * N) + detail::type_decode<T>::len_t * array_index;\n";
-        for (const auto& element : messageIn_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read && props.elements > 1) {
-                getMessageArrayVariableImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getMessageArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getMessageArrayVariableImpl << "              const unsigned int t_index = detail::type_decode<T>::len_t * array_index + detail::type_decode<T>::len_t;\n";
-                getMessageArrayVariableImpl << "              if(sizeof(detail::type_decode<T>::type_t) != " << element.second.type_size << ") {\n";
-                getMessageArrayVariableImpl << "                  DTHROW(\"Message array variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getMessageArrayVariableImpl << "                  return {};\n";
-                getMessageArrayVariableImpl << "              } else if (detail::type_decode<T>::len_t * N != " << element.second.elements << ") {\n";
-                getMessageArrayVariableImpl << "                  DTHROW(\"Message array variable '%s' length mismatch during getVariable().\\n\", name);\n";
-                getMessageArrayVariableImpl << "                  return {};\n";
-                getMessageArrayVariableImpl << "              } else if (t_index > " << element.second.elements << " || t_index < array_index) {\n";
-                getMessageArrayVariableImpl << "                  DTHROW(\"Message array variable '%s', index %d is out of bounds during getVariable().\\n\", name, array_index);\n";
-                getMessageArrayVariableImpl << "                  return {};\n";
-                getMessageArrayVariableImpl << "              }\n";
-                getMessageArrayVariableImpl << "#endif\n";
-                getMessageArrayVariableImpl << "              return (*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << messageIn_data_offset + (ct++ * sizeof(void*)) << ")))[i];\n";
-                getMessageArrayVariableImpl << "           };\n";
-            } else {
-                ++ct;
-            }
-        }
-        getMessageArrayVariableImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getMessageArrayVariableImpl << "           DTHROW(\"Message array variable '%s' was not found during getVariable().\\n\", name);\n";
-        getMessageArrayVariableImpl << "#endif\n";
-        getMessageArrayVariableImpl << "           return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETMESSAGEARRAYVARIABLE_IMPL", getMessageArrayVariableImpl.str());
-    }
     // generate getEnvironmentDirectedGraphVertexArrayProperty func implementation ($DYNAMIC_GETDIRECTEDGRAPHVERTEXARRAYPROPERTY_IMPL)
     {
         size_t ct = 0;
@@ -1278,76 +1188,6 @@ void CurveRTCHost::initHeaderGetters() {
         getGraphEdgeArrayPropertyImpl << "           return {};\n";
         setHeaderPlaceholder("$DYNAMIC_GETDIRECTEDGRAPHEDGEARRAYPROPERTY_IMPL", getGraphEdgeArrayPropertyImpl.str());
     }
-    // generate getAgentArrayVariable_ldg func implementation ($DYNAMIC_GETAGENTARRAYVARIABLE_LDG_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getAgentArrayVariableLDGImpl;
-        if (!agent_variables.empty())
-            getAgentArrayVariableLDGImpl <<             "    const size_t i = (index * N) + array_index;\n";
-        for (std::pair<std::string, RTCVariableProperties> element : agent_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read && props.elements > 1) {  // GLM does not support __ldg() so should not use this
-                getAgentArrayVariableLDGImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getAgentArrayVariableLDGImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getAgentArrayVariableLDGImpl << "              if(sizeof(T) != " << element.second.type_size << ") {\n";
-                getAgentArrayVariableLDGImpl << "                  DTHROW(\"Agent array variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getAgentArrayVariableLDGImpl << "                  return {};\n";
-                getAgentArrayVariableLDGImpl << "              } else if (N != " << element.second.elements << ") {\n";
-                getAgentArrayVariableLDGImpl << "                  DTHROW(\"Agent array variable '%s' length mismatch during getVariable().\\n\", name);\n";
-                getAgentArrayVariableLDGImpl << "                  return {};\n";
-                getAgentArrayVariableLDGImpl << "              } else if (array_index >= " << element.second.elements << ") {\n";
-                getAgentArrayVariableLDGImpl << "                  DTHROW(\"Agent array variable '%s', index %d is out of bounds during getVariable().\\n\", name, array_index);\n";
-                getAgentArrayVariableLDGImpl << "                  return {};\n";
-                getAgentArrayVariableLDGImpl << "              }\n";
-                getAgentArrayVariableLDGImpl << "#endif\n";
-                getAgentArrayVariableLDGImpl << "                return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << agent_data_offset + (ct * sizeof(void*)) << "))) + i);\n";
-                getAgentArrayVariableLDGImpl << "           };\n";
-                ++ct;  // Prev was part of the return line, but don't want confusion
-            } else {
-                ++ct;
-            }
-        }
-        getAgentArrayVariableLDGImpl <<         "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getAgentArrayVariableLDGImpl <<         "           DTHROW(\"Agent array variable '%s' was not found during getVariable().\\n\", name);\n";
-        getAgentArrayVariableLDGImpl <<         "#endif\n";
-        getAgentArrayVariableLDGImpl <<         "           return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETAGENTARRAYVARIABLE_LDG_IMPL", getAgentArrayVariableLDGImpl.str());
-    }
-    // generate getMessageArrayVariable func implementation ($DYNAMIC_GETMESSAGEARRAYVARIABLE_LDG_IMPL)
-    {
-        size_t ct = 0;
-        std::stringstream getMessageArrayVariableLDGImpl;
-        if (!messageIn_variables.empty())
-            getMessageArrayVariableLDGImpl << "    const size_t i = (index * N) + array_index;\n";
-        for (const auto& element : messageIn_variables) {
-            RTCVariableProperties props = element.second;
-            if (props.read && props.elements > 1) {  // GLM does not support __ldg() so should not use this
-                getMessageArrayVariableLDGImpl << "          if (strings_equal(name, \"" << element.first << "\")) {\n";
-                getMessageArrayVariableLDGImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-                getMessageArrayVariableLDGImpl << "              if(sizeof(T) != " << element.second.type_size << ") {\n";
-                getMessageArrayVariableLDGImpl << "                  DTHROW(\"Message array variable '%s' type mismatch during getVariable().\\n\", name);\n";
-                getMessageArrayVariableLDGImpl << "                  return {};\n";
-                getMessageArrayVariableLDGImpl << "              } else if (N != " << element.second.elements << ") {\n";
-                getMessageArrayVariableLDGImpl << "                  DTHROW(\"Message array variable '%s' length mismatch during getVariable().\\n\", name);\n";
-                getMessageArrayVariableLDGImpl << "                  return {};\n";
-                getMessageArrayVariableLDGImpl << "              } else if (array_index >= " << element.second.elements << ") {\n";
-                getMessageArrayVariableLDGImpl << "                  DTHROW(\"Message array variable '%s', index %d is out of bounds during getVariable().\\n\", name, array_index);\n";
-                getMessageArrayVariableLDGImpl << "                  return {};\n";
-                getMessageArrayVariableLDGImpl << "              }\n";
-                getMessageArrayVariableLDGImpl << "#endif\n";
-                getMessageArrayVariableLDGImpl << "                return (T) __ldg((*static_cast<T**>(static_cast<void*>(flamegpu::detail::curve::" << getVariableSymbolName() << " + " << messageIn_data_offset + (ct * sizeof(void*)) << "))) + i);\n";
-                getMessageArrayVariableLDGImpl << "           };\n";
-                ++ct;  // Prev was part of the return line, but don't want confusion
-            } else {
-                ++ct;
-            }
-        }
-        getMessageArrayVariableLDGImpl << "#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS\n";
-        getMessageArrayVariableLDGImpl << "           DTHROW(\"Message array variable '%s' was not found during getVariable().\\n\", name);\n";
-        getMessageArrayVariableLDGImpl << "#endif\n";
-        getMessageArrayVariableLDGImpl << "           return {};\n";
-        setHeaderPlaceholder("$DYNAMIC_GETMESSAGEARRAYVARIABLE_LDG_IMPL", getMessageArrayVariableLDGImpl.str());
-    }
 
     // generate getGraphHash func implementation ($DYNAMIC_GETGRAPHHASH_IMPL)
     // This is bespoke to RTC Curve, as in place of getVariableIndex()
@@ -1448,7 +1288,7 @@ void CurveRTCHost::setFileName(const std::string &filename) {
 
 std::string CurveRTCHost::getDynamicHeader(const size_t env_buffer_len) {
     initHeaderEnvironment(env_buffer_len);
-    initHeaderSetters();
+    initHeaderLookups();
     initHeaderGetters();
     initDataBuffer();
     return header;
@@ -6,10 +6,20 @@
 #include <string>
 #include <memory>
 
+#include "flamegpu/io/BinaryGraphReader.h"
+#include "flamegpu/io/BinaryGraphWriter.h"
 #include "flamegpu/io/JSONGraphReader.h"
 #include "flamegpu/io/JSONGraphWriter.h"
 
 namespace flamegpu {
+namespace {
+/**
+ * Case sensitive ends_with()
+ */
+bool endsWith(const std::string &str, const std::string &suffix) {
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}  // namespace
 HostEnvironmentDirectedGraph::HostEnvironmentDirectedGraph(std::shared_ptr<detail::CUDAEnvironmentDirectedGraphBuffers>& _directed_graph, const cudaStream_t _stream,
     detail::CUDAScatter& _scatter, const unsigned int _streamID)
     : directed_graph(_directed_graph)
@@ -20,37 +30,33 @@ HostEnvironmentDirectedGraph::HostEnvironmentDirectedGraph(std::shared_ptr<detai
 #endif
 { }
 void HostEnvironmentDirectedGraph::importGraph(const std::string& in_file) {
-    // Case insensitive ends_with()
-    const std::string json_type = ".json";
-    bool is_json = true;
-    for (unsigned int i = 1; i <= in_file.size() && i <= json_type.size(); ++i) {
-        if (in_file[in_file.size() - i] != json_type[json_type.size() - i])
-            is_json =  false;
-    }
-    if (in_file.size() < json_type.size() || !is_json) {
-        THROW exception::UnsupportedFileType("Input file '%s' does not correspond to a supported format (e.g. .json)\n", in_file.c_str());
+    const bool is_json = endsWith(in_file, ".json");
+    if (!is_json && !endsWith(in_file, ".bin")) {
+        THROW exception::UnsupportedFileType("Input file '%s' does not correspond to a supported format (e.g. .json, .bin)\n", in_file.c_str());
     }
     if (const auto dg = directed_graph.lock()) {
-        io::JSONGraphReader::loadAdjacencyLike(in_file, dg, stream);
+        if (is_json) {
+            io::JSONGraphReader::loadAdjacencyLike(in_file, dg, stream);
+        } else {
+            io::BinaryGraphReader::loadCSR(in_file, dg, stream);
+        }
         dg->markForRebuild();
     } else {
         THROW exception::ExpiredWeakPtr("Graph nolonger exists, weak pointer could not be locked, in HostEnvironmentDirectedGraph::importGraph()\n");
     }
 }
 void HostEnvironmentDirectedGraph::exportGraph(const std::string& out_file) {
-    // Case insensitive ends_with()
-    const std::string json_type = ".json";
-    bool is_json = true;
-    for (unsigned int i = 1; i <= out_file.size() && i <= json_type.size(); ++i) {
-        if (out_file[out_file.size() - i] != json_type[json_type.size() - i])
-            is_json =  false;
-    }
-    if (out_file.size() < json_type.size() || !is_json) {
-        THROW exception::UnsupportedFileType("Output file '%s' does not correspond to a supported format (e.g. .json)\n", out_file.c_str());
+    const bool is_json = endsWith(out_file, ".json");
+    if (!is_json && !endsWith(out_file, ".bin")) {
+        THROW exception::UnsupportedFileType("Output file '%s' does not correspond to a supported format (e.g. .json, .bin)\n", out_file.c_str());
     }
     if (const auto dg = directed_graph.lock()) {
         std::shared_ptr<const detail::CUDAEnvironmentDirectedGraphBuffers> const_dg = std::const_pointer_cast<detail::CUDAEnvironmentDirectedGraphBuffers>(dg);
-        io::JSONGraphWriter::saveAdjacencyLike(out_file, const_dg, stream, true);
+        if (is_json) {
+            io::JSONGraphWriter::saveAdjacencyLike(out_file, const_dg, stream, true);
+        } else {
+            io::BinaryGraphWriter::saveCSR(out_file, const_dg, stream);
+        }
     } else {
         THROW exception::ExpiredWeakPtr("Graph nolonger exists, weak pointer could not be locked, in HostEnvironmentDirectedGraph::exportGraph()\n");
     }
@@ -0,0 +1,536 @@
+#include "flamegpu/simulation/CPUSimulation.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "flamegpu/detail/SteadyClockTimer.h"
+#include "flamegpu/detail/ThreadPool.h"
+#include "flamegpu/model/AgentData.h"
+#include "flamegpu/model/AgentFunctionData.cuh"
+#include "flamegpu/model/EnvironmentData.h"
+#include "flamegpu/model/LayerData.h"
+#include "flamegpu/model/ModelDescription.h"
+#include "flamegpu/runtime/messaging/MessageBruteForce.h"
+#include "flamegpu/simulation/AgentVector.h"
+#include "flamegpu/simulation/LogFrame.h"
+#include "flamegpu/simulation/detail/DataflowGraph.h"
+#include "flamegpu/util/nvtx.h"
+#include "flamegpu/version.h"
+
+namespace flamegpu {
+
+namespace {
+    /**
+     * splitmix64 finaliser, used to derive independent random streams from the simulation seed
+     */
+    uint64_t mixSeed(uint64_t z) {
+        z += 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}  // anonymous namespace
+
+CPUSimulation::CPUSimulation(const ModelDescription& _model, int argc, const char** argv)
+    : Simulation(_model.model)
+    , step_count(0)
+    , run_log(std::make_unique<RunLog>())
+    , elapsedSecondsSimulation(0.) {
+    validateModel();
+    // Build the agent state lists
+    for (const auto &agent : model->agents) {
+        for (const auto &state : agent.second->states) {
+            agent_states.emplace(util::StringPair{ agent.first, state }, std::make_unique<detail::HostSoABuffer>(agent.second->variables));
+        }
+        next_agent_id.emplace(agent.first, ID_NOT_SET + 1);
+    }
+    // Build the message lists
+    for (const auto &message : model->messages) {
+        message_lists.emplace(message.first, std::make_unique<detail::HostSoABuffer>(message.second->variables));
+        message_truncate.emplace(message.first, true);
+    }
+    environment = detail::EnvironmentManager::create(*model->environment);
+    if (argc && argv) {
+        initialise(argc, argv);
+    }
+}
+CPUSimulation::~CPUSimulation() = default;
+
+void CPUSimulation::validateModel() const {
+    if (!model->submodels.empty()) {
+        THROW exception::InvalidOperation("Model '%s' contains submodels, these are not supported by the host backend, "
+            "in CPUSimulation::validateModel().", model->name.c_str());
+    }
+    if (!model->initFunctions.empty() || !model->initFunctionCallbacks.empty() ||
+        !model->stepFunctions.empty() || !model->stepFunctionCallbacks.empty() ||
+        !model->exitFunctions.empty() || !model->exitFunctionCallbacks.empty() ||
+        !model->exitConditions.empty() || !model->exitConditionCallbacks.empty()) {
+        THROW exception::InvalidOperation("Model '%s' contains host functions or exit conditions, these are not supported by the host backend, "
+            "in CPUSimulation::validateModel().", model->name.c_str());
+    }
+    for (const auto &layer : model->layers) {
+        if (!layer->host_functions.empty() || !layer->host_functions_callbacks.empty() || layer->sub_model) {
+            THROW exception::InvalidOperation("Layer '%s' contains host functions or a submodel, these are not supported by the host backend, "
+                "in CPUSimulation::validateModel().", layer->name.c_str());
+        }
+    }
+    for (const auto &message : model->messages) {
+        if (message.second->getType() != std::type_index(typeid(MessageBruteForce))) {
+            THROW exception::InvalidMessageType("Message '%s' is not a brute force message, only brute force messaging is supported by the host backend, "
+                "in CPUSimulation::validateModel().", message.first.c_str());
+        }
+    }
+}
+
+void CPUSimulation::setAgentFunction(const std::string &agent_name, const std::string &function_name, AgentFunction func) {
+    const auto agent_it = model->agents.find(agent_name);
+    if (agent_it == model->agents.end() || agent_it->second->functions.find(function_name) == agent_it->second->functions.end()) {
+        THROW exception::InvalidAgentFunc("Agent function '%s' of agent '%s' was not found, "
+            "in CPUSimulation::setAgentFunction().", function_name.c_str(), agent_name.c_str());
+    }
+    agent_functions[{agent_name, function_name}] = std::move(func);
+}
+void CPUSimulation::setAgentFunctionCondition(const std::string &agent_name, const std::string &function_name, AgentFunctionCondition condition) {
+    const auto agent_it = model->agents.find(agent_name);
+    if (agent_it == model->agents.end()) {
+        THROW exception::InvalidAgentFunc("Agent function '%s' of agent '%s' was not found, "
+            "in CPUSimulation::setAgentFunctionCondition().", function_name.c_str(), agent_name.c_str());
+    }
+    const auto func_it = agent_it->second->functions.find(function_name);
+    if (func_it == agent_it->second->functions.end()) {
+        THROW exception::InvalidAgentFunc("Agent function '%s' of agent '%s' was not found, "
+            "in CPUSimulation::setAgentFunctionCondition().", function_name.c_str(), agent_name.c_str());
+    }
+    if (!func_it->second->condition && func_it->second->rtc_func_condition_name.empty()) {
+        THROW exception::InvalidAgentFunc("Agent function '%s' of agent '%s' does not have a condition, "
+            "in CPUSimulation::setAgentFunctionCondition().", function_name.c_str(), agent_name.c_str());
+    }
+    agent_function_conditions[{agent_name, function_name}] = std::move(condition);
+}
+
+bool CPUSimulation::step() {
+    flamegpu::util::nvtx::Range range{std::string("CPUSimulation::step " + std::to_string(step_count)).c_str()};
+    detail::SteadyClockTimer stepTimer;
+    stepTimer.start();
+
+    // If verbose, print the step number.
+    if (getSimulationConfig().verbosity == Verbosity::Verbose) {
+        fprintf(stdout, "Processing Simulation Step %u\n", step_count);
+    }
+
+    if (cpu_config.dataflow) {
+        stepDataflow();
+    } else {
+        // Execute each layer of the simulation.
+        unsigned int function_index = 0;
+        for (const auto &layer : model->layers) {
+            for (const auto &f : detail::DataflowGraph::getLayerFunctions(*layer)) {
+                executeAgentFunction(*f, function_index++);
+            }
+        }
+    }
+
+    // Empty non-persistent message lists, and set the flag so that the next output to any list replaces it
+    for (const auto &m : model->messages) {
+        if (!m.second->persistent) {
+            message_lists.at(m.first)->clear();
+        }
+        message_truncate.at(m.first) = true;
+    }
+
+    // Record, store and output the elapsed time of the step.
+    stepTimer.stop();
+    const double stepSeconds = stepTimer.getElapsedSeconds();
+    this->elapsedSecondsPerStep.push_back(stepSeconds);
+    if (getSimulationConfig().timing || getSimulationConfig().verbosity >= Verbosity::Verbose) {
+        // Resolution is 0.5 microseconds, so print to 1 us.
+        fprintf(stdout, "Step %d Processing time: %.6f s\n", this->step_count, stepSeconds);
+    }
+    ++step_count;
+    return true;
+}
+
+void CPUSimulation::stepDataflow() {
+    if (!dataflow_graph) {
+        // Host agent functions only access the state lists they name, and brute force message lists require no index
+        dataflow_graph = std::make_unique<detail::DataflowGraph>(*model, detail::DataflowGraph::Options());
+    }
+    updateThreadPool();
+    // Nodes execute on the pool's workers and make nested use of the pool via parallelFor(), see detail::ThreadPool
+    dataflow_graph->execute(thread_pool.get(), [this](const detail::DataflowGraph::Node &node) {
+        executeAgentFunction(*node.function, node.function_index);
+    });
+}
+
+void CPUSimulation::executeAgentFunction(const AgentFunctionData &func, const unsigned int function_index) {
+    const auto agent = func.parent.lock();
+    flamegpu::util::nvtx::Range range{std::string(agent->name + "::" + func.name).c_str()};
+    const auto func_it = agent_functions.find({agent->name, func.name});
+    if (func_it == agent_functions.end()) {
+        THROW exception::InvalidAgentFunc("Agent function '%s' of agent '%s' does not have a host implementation, use CPUSimulation::setAgentFunction(), "
+            "in CPUSimulation::executeAgentFunction().", func.name.c_str(), agent->name.c_str());
+    }
+    const AgentFunctionCondition *condition = nullptr;
+    if (func.condition || !func.rtc_func_condition_name.empty()) {
+        const auto cond_it = agent_function_conditions.find({agent->name, func.name});
+        if (cond_it == agent_function_conditions.end()) {
+            THROW exception::InvalidAgentFunc("Agent function condition of '%s' of agent '%s' does not have a host implementation, use CPUSimulation::setAgentFunctionCondition(), "
+                "in CPUSimulation::executeAgentFunction().", func.name.c_str(), agent->name.c_str());
+        }
+        condition = &cond_it->second;
+    }
+    std::unique_ptr<detail::HostSoABuffer> &input_list = agent_states.at({agent->name, func.initial_state});
+    if (!input_list->size())
+        return;
+    // Each agent function receives a distinct stream per step, each agent's stream is offset from it by the agent's index
+    const uint64_t seed_base = mixSeed(getSimulationConfig().random_seed ^ mixSeed((static_cast<uint64_t>(step_count) << 32) | function_index));
+
+    // Split off the agents which pass the condition, those which fail remain in the initial state untouched
+    std::unique_ptr<detail::HostSoABuffer> working;
+    if (condition) {
+        const unsigned int input_count = input_list->size();
+        std::vector<char> pass(input_count, 0);
+        parallelFor(input_count, [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                CPUAgentAPI api(*input_list, static_cast<unsigned int>(i), step_count, *environment, mixSeed(~seed_base + i),
+                    nullptr, nullptr, nullptr, nullptr, nullptr);
+                pass[i] = (*condition)(api) ? 1 : 0;
+            }
+        });
+        working = std::make_unique<detail::HostSoABuffer>(agent->variables);
+        working->append(*input_list, &pass);
+        for (auto &p : pass)
+            p = !p;
+        input_list->compact(pass);
+    } else {
+        working = std::move(input_list);
+        input_list = std::make_unique<detail::HostSoABuffer>(agent->variables);
+    }
+    const unsigned int agent_count = working->size();
+    if (!agent_count)
+        return;
+
+    // Prepare inputs and outputs
+    const detail::HostSoABuffer *message_in = nullptr;
+    if (const auto mi = func.message_input.lock()) {
+        message_in = message_lists.at(mi->name).get();
+    }
+    const auto message_out_data = func.message_output.lock();
+    std::unique_ptr<detail::HostSoABuffer> message_out;
+    std::vector<char> message_out_flags;
+    if (message_out_data) {
+        message_out = std::make_unique<detail::HostSoABuffer>(message_out_data->variables);
+        message_out->resize(agent_count);
+        // Non-optional message output, every agent outputs a message
+        message_out_flags.assign(agent_count, func.message_output_optional ? 0 : 1);
+    }
+    const auto agent_out_data = func.agent_output.lock();
+    std::unique_ptr<detail::HostSoABuffer> agent_out;
+    std::vector<char> agent_out_flags;
+    if (agent_out_data) {
+        agent_out = std::make_unique<detail::HostSoABuffer>(agent_out_data->variables);
+        agent_out->resize(agent_count);
+        agent_out_flags.assign(agent_count, 0);
+    }
+    std::vector<char> alive(agent_count, 1);
+
+    // Execute the agent function
+    const AgentFunction &agent_function = func_it->second;
+    parallelFor(agent_count, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            CPUAgentAPI api(*working, static_cast<unsigned int>(i), step_count, *environment, mixSeed(seed_base + i),
+                message_in,
+                message_out.get(), message_out ? &message_out_flags : nullptr,
+                agent_out.get(), agent_out ? &agent_out_flags : nullptr);
+            if (agent_function(api) == DEAD) {
+                if (!func.has_agent_death) {
+                    THROW exception::InvalidOperation("Agent function '%s' of agent '%s' returned DEAD, but agent death is not enabled, "
+                        "in CPUSimulation::executeAgentFunction().", func.name.c_str(), agent->name.c_str());
+                }
+                alive[i] = 0;
+            }
+        }
+    });
+
+    // Resolve outputs in agent order, so that results do not depend on scheduling
+    if (func.has_agent_death) {
+        working->compact(alive);
+    }
+    agent_states.at({agent->name, func.end_state})->append(*working);
+    if (message_out_data) {
+        auto &message_list = message_lists.at(message_out_data->name);
+        bool &truncate = message_truncate.at(message_out_data->name);
+        if (truncate) {
+            message_list->clear();
+            truncate = false;
+        }
+        message_list->append(*message_out, &message_out_flags);
+    }
+    if (agent_out_data) {
+        auto &agent_out_list = agent_states.at({agent_out_data->name, func.agent_output_state});
+        agent_out_list->append(*agent_out, &agent_out_flags);
+        assignAgentIDs(agent_out_data->name, *agent_out_list);
+    }
+}
+
+void CPUSimulation::assignAgentIDs(const std::string &agent_name, detail::HostSoABuffer &buffer) {
+    id_t &next_id = next_agent_id.at(agent_name);
+    id_t *ids = reinterpret_cast<id_t*>(buffer.findColumn(ID_VARIABLE_NAME)->data.data());
+    for (unsigned int i = 0; i < buffer.size(); ++i) {
+        if (ids[i] == ID_NOT_SET) {
+            ids[i] = next_id++;
+        }
+    }
+}
+
+unsigned int CPUSimulation::updateThreadPool() {
+    const unsigned int thread_count = cpu_config.thread_count ? cpu_config.thread_count : std::max(1u, std::thread::hardware_concurrency());
+    if (thread_count == 1) {
+        thread_pool.reset();
+    } else if (!thread_pool || thread_pool->getThreadCount() + 1 != thread_count) {
+        // The calling thread also executes work, so the pool requires one fewer worker than the requested thread count
+        thread_pool.reset();
+        thread_pool = std::make_unique<detail::ThreadPool>(thread_count - 1);
+    }
+    return thread_count;
+}
+
+void CPUSimulation::parallelFor(const unsigned int count, const std::function<void(size_t, size_t)> &body) {
+    if (updateThreadPool() == 1) {
+        body(0, count);
+        return;
+    }
+    thread_pool->parallelFor(0, count, 0, body);
+}
+
+void CPUSimulation::simulate() {
+    if (getSimulationConfig().steps == 0) {
+        THROW exception::InvalidArgument("The host backend does not support exit conditions, so the number of steps must be non-zero, "
+            "in CPUSimulation::simulate().");
+    }
+    flamegpu::util::nvtx::Range range{"CPUSimulation::simulate"};
+    detail::SteadyClockTimer simulationTimer;
+    simulationTimer.start();
+
+    // Reset the class' elapsed time value.
+    this->elapsedSecondsSimulation = 0.;
+    this->elapsedSecondsPerStep.clear();
+    this->elapsedSecondsPerStep.reserve(getSimulationConfig().steps);
+    run_log->random_seed = getSimulationConfig().random_seed;
+    run_log->performance_specs.flamegpu_version = VERSION_FULL;
+
+    // Run the required number of simulation steps.
+    for (unsigned int i = 0; i < getSimulationConfig().steps; ++i) {
+        if (!step()) {
+            break;
+        }
+    }
+
+    // Record, store and output the elapsed simulation time
+    simulationTimer.stop();
+    elapsedSecondsSimulation = simulationTimer.getElapsedSeconds();
+    if (getSimulationConfig().timing || getSimulationConfig().verbosity >= Verbosity::Verbose) {
+        // Resolution is 0.5 microseconds, so print to 1 us.
+        fprintf(stdout, "Total Processing time: %.6f s\n", elapsedSecondsSimulation);
+    }
+}
+
+void CPUSimulation::setPopulationData(AgentVector& population, const std::string& state_name) {
+    flamegpu::util::nvtx::Range range{"CPUSimulation::setPopulationData()"};
+    const auto agent_it = model->agents.find(population.getAgentName());
+    if (agent_it == model->agents.end()) {
+        THROW exception::InvalidAgent("Agent '%s' was not found, "
+            "in CPUSimulation::setPopulationData()",
+            population.getAgentName().c_str());
+    }
+    if (!population.matchesAgentType(*agent_it->second)) {
+        THROW exception::InvalidCudaAgentDesc("Agent description for agent '%s' does not match that of AgentVector, "
+            "in CPUSimulation::setPopulationData()",
+            population.getAgentName().c_str());
+    }
+    const auto state_it = agent_states.find({ population.getAgentName(), state_name });
+    if (state_it == agent_states.end()) {
+        if (state_name == ModelData::DEFAULT_STATE) {
+            THROW exception::InvalidAgentState("Agent '%s' does not use the default state, so the state must be passed explicitly, "
+                "in CPUSimulation::setPopulationData()",
+                population.getAgentName().c_str());
+        } else {
+            THROW exception::InvalidAgentState("State '%s' was not found in agent '%s', "
+                "in CPUSimulation::setPopulationData()",
+                state_name.c_str(), population.getAgentName().c_str());
+        }
+    }
+    // Copy population data into a new buffer, so the existing population is retained if validation fails
+    auto buffer = std::make_unique<detail::HostSoABuffer>(agent_it->second->variables);
+    const AgentVector &c_population = population;
+    const unsigned int data_count = population.size();
+    buffer->resize(data_count);
+    if (data_count) {
+        for (auto &col : buffer->getColumns()) {
+            memcpy(col.second.data.data(), c_population.data(col.first), col.second.data.size());
+        }
+    }
+    // Validate that there are no ID collisions between any of the agent's states, with the new population in place of the replaced state
+    std::unordered_set<id_t> ids;
+    id_t max_id = ID_NOT_SET;
+    for (const auto &state : agent_it->second->states) {
+        const detail::HostSoABuffer &s = state == state_name ? *buffer : *agent_states.at({ population.getAgentName(), state });
+        const id_t *s_ids = reinterpret_cast<const id_t*>(s.findColumn(ID_VARIABLE_NAME)->data.data());
+        for (unsigned int i = 0; i < s.size(); ++i) {
+            if (s_ids[i] != ID_NOT_SET && !ids.insert(s_ids[i]).second) {
+                THROW exception::AgentIDCollision("Multiple agents of type '%s' share the ID %u, "
+                    "in CPUSimulation::setPopulationData()",
+                    population.getAgentName().c_str(), s_ids[i]);
+            }
+            max_id = std::max(max_id, s_ids[i]);
+        }
+    }
+    id_t &next_id = next_agent_id.at(population.getAgentName());
+    next_id = std::max(next_id, max_id + 1);
+    assignAgentIDs(population.getAgentName(), *buffer);
+    state_it->second = std::move(buffer);
+}
+void CPUSimulation::getPopulationData(AgentVector& population, const std::string& state_name) {
+    flamegpu::util::nvtx::Range range{"CPUSimulation::getPopulationData()"};
+    const auto agent_it = model->agents.find(population.getAgentName());
+    if (agent_it == model->agents.end()) {
+        THROW exception::InvalidAgent("Agent '%s' was not found, "
+            "in CPUSimulation::getPopulationData()",
+            population.getAgentName().c_str());
+    }
+    if (!population.matchesAgentType(*agent_it->second)) {
+        THROW exception::InvalidCudaAgentDesc("Agent description for agent '%s' does not match that of AgentVector, "
+            "in CPUSimulation::getPopulationData()",
+            population.getAgentName().c_str());
+    }
+    const auto state_it = agent_states.find({ population.getAgentName(), state_name });
+    if (state_it == agent_states.end()) {
+        if (state_name == ModelData::DEFAULT_STATE) {
+            THROW exception::InvalidAgentState("Agent '%s' does not use the default state, so the state must be passed explicitly, "
+                "in CPUSimulation::getPopulationData()",
+                population.getAgentName().c_str());
+        } else {
+            THROW exception::InvalidAgentState("State '%s' was not found in agent '%s', "
+                "in CPUSimulation::getPopulationData()",
+                state_name.c_str(), population.getAgentName().c_str());
+        }
+    }
+    // Copy population data
+    const detail::HostSoABuffer &buffer = *state_it->second;
+    const unsigned int data_count = buffer.size();
+    if (data_count) {
+        population.internal_resize(data_count, false);
+        for (const auto &col : buffer.getColumns()) {
+            // Use the const method, but const cast away the const to avoid the reserved var check
+            void *v_data = const_cast<void*>(static_cast<const AgentVector&>(population).data(col.first));
+            memcpy(v_data, col.second.data.data(), col.second.data.size());
+        }
+    }
+    population._size = data_count;  // Private AgentVector::resize() does not update size
+}
+
+unsigned int CPUSimulation::getStepCounter() {
+    return step_count;
+}
+void CPUSimulation::resetStepCounter() {
+    step_count = 0;
+}
+CPUSimulation::Config &CPUSimulation::CPUConfig() {
+    return cpu_config;
+}
+const CPUSimulation::Config &CPUSimulation::getCPUConfig() const {
+    return cpu_config;
+}
+const RunLog &CPUSimulation::getRunLog() {
+    return *run_log;
+}
+double CPUSimulation::getElapsedTimeSimulation() const {
+    return this->elapsedSecondsSimulation;
+}
+std::vector<double> CPUSimulation::getElapsedTimeSteps() const {
+    return this->elapsedSecondsPerStep;
+}
+
+void CPUSimulation::reset(bool) {
+    resetStepCounter();
+    // Reset environment properties
+    environment->resetModel(*model->environment);
+    // Cull agents
+    for (auto &a : agent_states) {
+        a.second->clear();
+    }
+    for (auto &n : next_agent_id) {
+        n.second = ID_NOT_SET + 1;
+    }
+    // Cull messagelists
+    for (auto &m : message_lists) {
+        m.second->clear();
+        message_truncate.at(m.first) = true;
+    }
+    // Reset any timing data.
+    this->elapsedSecondsSimulation = 0.;
+    this->elapsedSecondsPerStep.clear();
+}
+
+void CPUSimulation::applyConfig_derived() {
+    // Set any properties loaded from file during arg parse stage
+    for (const auto &prop : env_init) {
+        const auto &properties = environment->getPropertiesMap();
+        const auto it = properties.find(prop.first);
+        if (it == properties.end()) {
+            THROW exception::InvalidEnvProperty("Environment init data contains unexpected environment property '%s', "
+                "in CPUSimulation::applyConfig_derived()\n", prop.first.c_str());
+        }
+        if (prop.second.type != it->second.type || prop.second.elements != it->second.elements) {
+            THROW exception::InvalidEnvProperty("Environment init data contains environment property '%s' with type or length mismatch, "
+                "this should have been caught during file parsing, "
+                "in CPUSimulation::applyConfig_derived()\n", prop.first.c_str());
+        }
+        environment->setPropertyDirect(prop.first, static_cast<char*>(prop.second.ptr));
+    }
+    // Clear init
+    env_init.clear();
+    macro_env_init.clear();
+}
+
+bool CPUSimulation::checkArgs_derived(int argc, const char** argv, int &i) {
+    // Get arg as lowercase
+    std::string arg(argv[i]);
+    std::transform(arg.begin(), arg.end(), arg.begin(), [](unsigned char c) { return static_cast<char>(::tolower(c)); });
+    // --threads <uint>, Number of threads used to execute agent functions, defaults to hardware concurrency
+    if ((arg.compare("--threads") == 0 || arg.compare("-j") == 0) && argc > i+1) {
+        cpu_config.thread_count = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 0));
+        return true;
+    }
+    // --dataflow, Execute agent functions as soon as their dependencies complete, rather than by layer
+    if (arg.compare("--dataflow") == 0) {
+        cpu_config.dataflow = true;
+        return true;
+    }
+    return false;
+}
+
+void CPUSimulation::printHelp_derived() {
+    const char *line_fmt = "%-18s %s\n";
+    printf("CPU Model Optional Arguments:\n");
+    printf(line_fmt, "-j, --threads", "Number of threads used to execute agent functions");
+    printf(line_fmt, "--dataflow", "Execute agent functions as their dependencies complete, rather than by layer");
+}
+
+std::shared_ptr<detail::EnvironmentManager> CPUSimulation::getEnvironment() const {
+    return environment;
+}
+std::shared_ptr<const detail::CUDAMacroEnvironment> CPUSimulation::getMacroEnvironment() const {
+    return nullptr;
+}
+
+}  // namespace flamegpu
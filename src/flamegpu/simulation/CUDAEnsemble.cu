@@ -8,7 +8,9 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <limits>
 #include <map>
 #include <cstdio>
 #include <vector>
@@ -23,9 +25,10 @@
 #include "flamegpu/model/ModelDescription.h"
 #include "flamegpu/simulation/RunPlanVector.h"
 #include "flamegpu/detail/compute_capability.cuh"
+#include "flamegpu/detail/JitifyCache.h"
 #include "flamegpu/detail/SteadyClockTimer.h"
 #include "flamegpu/simulation/CUDASimulation.h"
-#include "flamegpu/io/StateWriterFactory.h"
+#include "flamegpu/io/LoggerFactory.h"
 #include "flamegpu/simulation/LoggingConfig.h"
 #include "flamegpu/simulation/detail/SimRunner.h"
 #include "flamegpu/simulation/LogFrame.h"
@@ -69,6 +72,11 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
     std::unique_ptr<detail::MPIEnsemble> mpi = std::make_unique<detail::MPIEnsemble>(config, static_cast<unsigned int>(plans.size()));
 #endif
 
+    // Preload RTC kernels, so that runners do not each compile or load them from the on-disk cache
+    if (!config.rtc_bundle.empty()) {
+        detail::JitifyCache::getInstance().loadBundle(config.rtc_bundle);
+    }
+
     // Validate/init output directories
     if (!config.out_directory.empty()
 #ifdef FLAMEGPU_ENABLE_MPI
@@ -76,9 +84,9 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
 #endif
     ) {
         // Validate out format is right
-        config.out_format = io::StateWriterFactory::detectSupportedFileExt(config.out_format);
+        config.out_format = io::LoggerFactory::detectSupportedFileExt(config.out_format);
         if (config.out_format.empty()) {
-            THROW exception::InvalidArgument("The out_directory config option also requires the out_format options to be set to a suitable type (e.g. 'json', 'xml'), in CUDAEnsemble::simulate()");
+            THROW exception::InvalidArgument("The out_directory config option also requires the out_format options to be set to a suitable type (e.g. 'json', 'xml', 'bin'), in CUDAEnsemble::simulate()");
         }
         // Check that output files don't already exist
         if (std::filesystem::exists(config.out_directory)) {
@@ -206,6 +214,11 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
         fprintf(stderr, "Warning: MPI Ensemble launched with %d MPI ranks, but only %d ranks have GPUs assigned. %d ranks are unneccesary.\n", mpi->world_size, mpi->getParticipatingCommSize(), mpi->world_size - mpi->getParticipatingCommSize());
         fflush(stderr);
     }
+    // MPI ensembles distribute runs in RunPlanVector order, so scheduling is not applied
+    if (config.mpi && mpi->world_rank == 0 && config.scheduling != EnsembleConfig::Sequential && config.verbosity >= Verbosity::Default) {
+        fprintf(stderr, "Warning: MPI Ensemble ignores EnsembleConfig::scheduling, runs will be started in sequential order.\n");
+        fflush(stderr);
+    }
 #endif
 
     const unsigned int TOTAL_RUNNERS = static_cast<unsigned int>(devices.size()) * config.concurrent_runs;
@@ -215,6 +228,8 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
     ensemble_timer.start();
     // Reset the elapsed time.
     ensemble_elapsed_time = 0.;
+    log_export_metrics = LogExportMetrics();
+    runner_metrics.clear();
 
     // Logging thread-safety items
     std::queue<unsigned int> log_export_queue;
@@ -230,8 +245,11 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
     detail::SimLogger *log_worker = nullptr;
     if (!config.out_directory.empty()) {
         log_worker = new detail::SimLogger(run_logs, plans, config.out_directory, config.out_format, log_export_queue, log_export_queue_mutex, log_export_queue_cdn,
-        step_log_config.get(), exit_log_config.get(), step_log_config && step_log_config->log_timing, exit_log_config && exit_log_config->log_timing);
+        step_log_config.get(), exit_log_config.get(), step_log_config && step_log_config->log_timing, exit_log_config && exit_log_config->log_timing,
+        config.evict_exported_logs, config.log_export_threads);
     }
+    // Runners can only wait for the backlog to clear if there is a logger to clear it
+    const unsigned int max_log_export_backlog = log_worker ? config.max_log_export_backlog : 0;
 
     // In MPI mode, only Rank 0 increments the error counter
     unsigned int err_count = 0;
@@ -241,6 +259,9 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
         detail::MPISimRunner** runners = static_cast<detail::MPISimRunner**>(malloc(sizeof(detail::MPISimRunner*) * TOTAL_RUNNERS));
         std::vector<std::atomic<unsigned int>> err_cts(TOTAL_RUNNERS);
         std::vector<std::atomic<unsigned int>> next_runs(TOTAL_RUNNERS);
+        // Runners and the manager (this thread) sleep on runner_cdn until next_runs changes, rather than spinning
+        std::mutex runner_mutex;
+        std::condition_variable runner_cdn;
         for (unsigned int i = 0; i < TOTAL_RUNNERS; ++i) {
             err_cts[i] = UINT_MAX;
             next_runs[i] = detail::MPISimRunner::Signal::RequestJob;
@@ -253,7 +274,8 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
                         step_log_config, exit_log_config,
                         d, j,
                         config.verbosity,
-                        run_logs, log_export_queue, log_export_queue_mutex, log_export_queue_cdn, err_detail_local, TOTAL_RUNNERS, isSWIG);
+                        run_logs, log_export_queue, log_export_queue_mutex, log_export_queue_cdn, max_log_export_backlog, err_detail_local,
+                        runner_mutex, runner_cdn, TOTAL_RUNNERS, config.reuse_simulations, isSWIG);
                     runners[i]->start();
                     ++i;
                 }
@@ -263,8 +285,7 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
         // If work_rank == 0, also perform the assignments
         if (mpi->world_rank == 0) {
             unsigned int next_run = 0;
-            MPI_Status status;
-            int flag;
+            bool cancelled = false;
             int mpi_runners_fin = 1;  // Start at 1 because we have always already finished
             // Wait for all runs to have been assigned, and all MPI runners to have been notified of fin
             while (next_run < plans.size() || mpi_runners_fin < mpi->getParticipatingCommSize()) {
@@ -274,8 +295,10 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
                 if (t_err_count && config.error_level == EnsembleConfig::Fast) {
                     // Skip to end to kill workers
                     next_run = plans.size();
+                    cancelled = true;
                 }
                 // Check whether local runners require a job assignment
+                bool assigned = false;
                 for (unsigned int i = 0; i < next_runs.size(); ++i) {
                     auto &r = next_runs[i];
                     unsigned int run_id = r.load();
@@ -286,11 +309,16 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
                         if (config.error_level == EnsembleConfig::Fast) {
                             // Skip to end to kill workers
                             next_run = plans.size();
+                            cancelled = true;
                         }
                         run_id = detail::MPISimRunner::Signal::RequestJob;
                     }
                     if (run_id == detail::MPISimRunner::Signal::RequestJob) {
-                        r.store(next_run++);
+                        {
+                            std::lock_guard<std::mutex> lck(runner_mutex);
+                            r.store(next_run++);
+                        }
+                        assigned = true;
                         // Print progress to console
                         if (config.verbosity >= Verbosity::Default && next_run <= plans.size()) {
                             fprintf(stdout, "MPI ensemble assigned run %d/%u to rank 0\n", next_run, static_cast<unsigned int>(plans.size()));
@@ -298,17 +326,33 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
                         }
                     }
                 }
+                if (assigned) {
+                    runner_cdn.notify_all();
+                }
                 // Check whether MPI runners require a job assignment
-                mpi_runners_fin += mpi->receiveJobRequests(next_run);
-                // Yield, rather than hammering the processor
-                std::this_thread::yield();
+                mpi_runners_fin += mpi->receiveJobRequests(next_run, cancelled);
+                // Sleep until a local runner requires attention, waking periodically to receive MPI messages
+                std::unique_lock<std::mutex> lck(runner_mutex);
+                runner_cdn.wait_for(lck, detail::MPIEnsemble::POLL_INTERVAL, [&next_runs]() {
+                    for (const auto &r : next_runs) {
+                        const unsigned int t = r.load();
+                        if (t == detail::MPISimRunner::Signal::RequestJob || t == detail::MPISimRunner::Signal::RunFailed)
+                            return true;
+                    }
+                    return false;
+                });
             }
         } else if (mpi->getRankIsParticipating()) {
-            // Wait for all runs to have been assigned, and all MPI runners to have been notified of fin. ranks without GPU(s) do not request jobs.
-            unsigned int next_run = 0;
-            MPI_Status status;
-            while (next_run < plans.size()) {
+            // Jobs are requested from rank 0 in chunks, the next chunk is requested as soon as the current chunk has been handed to runners
+            // so that it arrives before runners become idle. Ranks without GPU(s) do not request jobs.
+            const unsigned int chunk_size = config.mpi_chunk_size ? config.mpi_chunk_size : TOTAL_RUNNERS;
+            std::deque<unsigned int> local_jobs;
+            bool requested = false;  // A job request is awaiting a response from rank 0
+            bool finished = false;  // Rank 0 has no further jobs to assign
+            while (!finished || !local_jobs.empty()) {
                 // Check whether local runners require a job assignment
+                bool assigned = false;
+                unsigned int idle_runners = 0;
                 for (unsigned int i = 0; i < TOTAL_RUNNERS; ++i) {
                     unsigned int runner_status = next_runs[i].load();
                     if (runner_status == detail::MPISimRunner::Signal::RunFailed) {
@@ -317,34 +361,92 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
                         ++err_count;
                         // Retrieve and handle local error detail
                         mpi->retrieveLocalErrorDetail(log_export_queue_mutex, err_detail, err_detail_local, i, devices);
+                        if (config.error_level == EnsembleConfig::Fast) {
+                            // Don't start any further jobs
+                            local_jobs.clear();
+                        }
+                        std::lock_guard<std::mutex> lck(runner_mutex);
+                        next_runs[i].store(detail::MPISimRunner::Signal::RequestJob);
                         runner_status = detail::MPISimRunner::Signal::RequestJob;
                     }
                     if (runner_status == detail::MPISimRunner::Signal::RequestJob) {
-                        next_run = mpi->requestJob();
-                        // Pass the job to runner that requested it
-                        next_runs[i].store(next_run);
-                        // Break if assigned job is out of range, work is finished
-                        if (next_run >= plans.size()) {
-                            break;
+                        if (!local_jobs.empty()) {
+                            // Pass the job to runner that requested it
+                            {
+                                std::lock_guard<std::mutex> lck(runner_mutex);
+                                next_runs[i].store(local_jobs.front());
+                            }
+                            local_jobs.pop_front();
+                            assigned = true;
+                        } else {
+                            ++idle_runners;
+                        }
+                    }
+                }
+                if (assigned) {
+                    runner_cdn.notify_all();
+                }
+                // Request the next chunk whilst runners are busy with the current chunk
+                if (!finished && !requested && local_jobs.empty()) {
+                    mpi->requestJobs(chunk_size);
+                    requested = true;
+                }
+                if (requested) {
+                    unsigned int first = 0, count = 0;
+                    // If every runner is idle nothing else can progress, so block until the response arrives
+                    if (mpi->receiveJobs(first, count, idle_runners == TOTAL_RUNNERS)) {
+                        requested = false;
+                        if (count == 0) {
+                            finished = true;
+                            if (first == UINT_MAX) {
+                                // Remaining jobs were cancelled, due to an error on another rank
+                                local_jobs.clear();
+                            }
+                        }
+                        for (unsigned int j = 0; j < count; ++j) {
+                            local_jobs.push_back(first + j);
                         }
+                        // Assign the received jobs immediately
+                        continue;
                     }
                 }
-                std::this_thread::yield();
+                // Sleep until a local runner requires attention, waking periodically if awaiting a response from rank 0
+                std::unique_lock<std::mutex> lck(runner_mutex);
+                const auto runner_waiting = [&next_runs, &local_jobs]() {
+                    for (const auto &r : next_runs) {
+                        const unsigned int t = r.load();
+                        if (t == detail::MPISimRunner::Signal::RunFailed || (t == detail::MPISimRunner::Signal::RequestJob && !local_jobs.empty()))
+                            return true;
+                    }
+                    return false;
+                };
+                if (requested) {
+                    runner_cdn.wait_for(lck, detail::MPIEnsemble::POLL_INTERVAL, runner_waiting);
+                } else if (!finished || !local_jobs.empty()) {
+                    runner_cdn.wait(lck, runner_waiting);
+                }
             }
         }
 
         // Notify all local runners to exit
         for (unsigned int i = 0; i < TOTAL_RUNNERS; ++i) {
             auto &r = next_runs[i];
-            if (r.exchange(plans.size()) == detail::MPISimRunner::Signal::RunFailed) {
+            unsigned int previous;
+            {
+                std::lock_guard<std::mutex> lck(runner_mutex);
+                previous = r.exchange(plans.size());
+            }
+            if (previous == detail::MPISimRunner::Signal::RunFailed) {
                 ++err_count;
                 // Retrieve and handle local error detail
                 mpi->retrieveLocalErrorDetail(log_export_queue_mutex, err_detail, err_detail_local, i, devices);
             }
         }
+        runner_cdn.notify_all();
         // Wait for all runners to exit
         for (unsigned int i = 0; i < TOTAL_RUNNERS; ++i) {
             runners[i]->join();
+            runner_metrics.push_back(RunnerMetrics{runners[i]->device_id, runners[i]->runner_id, runners[i]->getRunCount(), runners[i]->getBusyTime()});
             delete runners[i];
             if (next_runs[i].load() == detail::MPISimRunner::Signal::RunFailed) {
                 ++err_count;
@@ -357,16 +459,30 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
         detail::SimRunner** runners = static_cast<detail::SimRunner**>(malloc(sizeof(detail::SimRunner*) * TOTAL_RUNNERS));
         std::atomic<unsigned int> err_ct = { 0u };
         std::atomic<unsigned int> next_runs = { 0u };
+        // Decide the order in which runs are claimed by runners
+        std::vector<unsigned int> run_order(plans.size());
+        for (unsigned int i = 0; i < run_order.size(); ++i) {
+            run_order[i] = i;
+        }
+        if (config.scheduling == EnsembleConfig::LongestFirst) {
+            // Runs with neither cost nor steps are bound by an exit condition, so assume they are the longest
+            std::vector<double> run_cost(plans.size());
+            for (unsigned int i = 0; i < run_cost.size(); ++i) {
+                const RunPlan &p = plans[i];
+                run_cost[i] = p.getCost() > 0 ? p.getCost() : p.getSteps() > 0 ? static_cast<double>(p.getSteps()) : std::numeric_limits<double>::infinity();
+            }
+            std::stable_sort(run_order.begin(), run_order.end(), [&run_cost](unsigned int a, unsigned int b) { return run_cost[a] > run_cost[b]; });
+        }
         // Setup SimRunners
         {
             unsigned int i = 0;
             for (auto& d : devices) {
                 for (unsigned int j = 0; j < config.concurrent_runs; ++j) {
-                    runners[i] = new detail::SimRunner(model, err_ct, next_runs, plans,
+                    runners[i] = new detail::SimRunner(model, err_ct, next_runs, plans, run_order,
                         step_log_config, exit_log_config,
                         d, j,
                         config.verbosity, config.error_level == EnsembleConfig::Fast,
-                        run_logs, log_export_queue, log_export_queue_mutex, log_export_queue_cdn, err_detail_local, TOTAL_RUNNERS, isSWIG);
+                        run_logs, log_export_queue, log_export_queue_mutex, log_export_queue_cdn, max_log_export_backlog, err_detail_local, TOTAL_RUNNERS, config.reuse_simulations, isSWIG);
                     runners[i++]->start();
                 }
             }
@@ -374,6 +490,7 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
         // Wait for all runners to exit
         for (unsigned int i = 0; i < TOTAL_RUNNERS; ++i) {
             runners[i]->join();
+            runner_metrics.push_back(RunnerMetrics{runners[i]->device_id, runners[i]->runner_id, runners[i]->getRunCount(), runners[i]->getBusyTime()});
             delete runners[i];
         }
         err_count = err_ct;
@@ -385,8 +502,9 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
             std::lock_guard<std::mutex> lck(log_export_queue_mutex);
             log_export_queue.push(UINT_MAX);
         }
-        log_export_queue_cdn.notify_one();
-        log_worker->thread.join();
+        log_export_queue_cdn.notify_all();
+        log_worker->join();
+        log_export_metrics = log_worker->getMetrics();
         delete log_worker;
         log_worker = nullptr;
     }
@@ -407,6 +525,9 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
     // Record and store the elapsed time
     ensemble_timer.stop();
     ensemble_elapsed_time = ensemble_timer.getElapsedSeconds();
+    for (auto &r : runner_metrics) {
+        r.utilisation = ensemble_elapsed_time > 0 ? std::min(r.busy_time / ensemble_elapsed_time, 1.0) : 0;
+    }
 
     // Ensemble has finished, print summary
     if (config.verbosity > Verbosity::Quiet &&
@@ -424,6 +545,18 @@ unsigned int CUDAEnsemble::simulate(const RunPlanVector& plans) {
 #endif
        (config.error_level != EnsembleConfig::Fast || err_count == 0)) {
         printf("Ensemble time elapsed: %fs\n", ensemble_elapsed_time);
+        if (log_export_metrics.exported_logs) {
+            printf("Ensemble log export: %u runs exported by %u threads, mean queue depth %.2f (max %u), mean export time %fs (max %fs)\n",
+                log_export_metrics.exported_logs, log_export_metrics.export_threads,
+                static_cast<double>(log_export_metrics.total_queue_depth) / log_export_metrics.exported_logs, log_export_metrics.max_queue_depth,
+                log_export_metrics.total_export_time / log_export_metrics.exported_logs, log_export_metrics.max_export_time);
+        }
+        if (config.verbosity >= Verbosity::Verbose) {
+            for (const auto &r : runner_metrics) {
+                printf("Ensemble runner D%dT%u: %u runs, busy %fs (%.1f%% utilisation)\n",
+                    r.device_id, r.runner_id, r.runs, r.busy_time, r.utilisation * 100);
+            }
+        }
     }
 
     // Send Telemetry
@@ -585,7 +718,7 @@ int CUDAEnsemble::checkArgs(int argc, const char** argv) {
                 return false;
             }
             // Validate output format is available in io module
-            config.out_format = io::StateWriterFactory::detectSupportedFileExt(argv[++i]);
+            config.out_format = io::LoggerFactory::detectSupportedFileExt(argv[++i]);
             if (config.out_format.empty()) {
                 fprintf(stderr, "'%s' is not a supported output file type.\n", argv[i]);
                 return false;
@@ -633,6 +766,43 @@ int CUDAEnsemble::checkArgs(int argc, const char** argv) {
             }
             continue;
         }
+        // --schedule <scheduling>, Specify the order in which runs are executed
+        if (arg.compare("--schedule") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "%s requires a trailing argument\n", arg.c_str());
+                return false;
+            }
+            std::string scheduling_string = argv[++i];
+            // Shift the trailing arg to lower
+            std::transform(scheduling_string.begin(), scheduling_string.end(), scheduling_string.begin(), [](unsigned char c) { return std::use_facet< std::ctype<char>>(std::locale()).tolower(c); });
+            if (scheduling_string.compare("sequential") == 0 || scheduling_string.compare(std::to_string(EnsembleConfig::Sequential)) == 0) {
+                config.scheduling = EnsembleConfig::Sequential;
+            } else if (scheduling_string.compare("longest") == 0 || scheduling_string.compare(std::to_string(EnsembleConfig::LongestFirst)) == 0) {
+                config.scheduling = EnsembleConfig::LongestFirst;
+            } else {
+                fprintf(stderr, "%s is not an appropriate argument for %s\n", scheduling_string.c_str(), arg.c_str());
+                return false;
+            }
+            continue;
+        }
+        // --log-threads <threads>, Number of threads used to export logs
+        if (arg.compare("--log-threads") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "%s requires a trailing argument\n", arg.c_str());
+                return false;
+            }
+            config.log_export_threads = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 0));
+            continue;
+        }
+        // --rtc-bundle <file>, Preload RTC kernels from a bundle
+        if (arg.compare("--rtc-bundle") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "%s requires a trailing argument\n", arg.c_str());
+                return false;
+            }
+            config.rtc_bundle = argv[++i];
+            continue;
+        }
         // --truncate, Truncate output files
         if (arg.compare("--truncate") == 0) {
             config.truncate_log_files = true;
@@ -662,11 +832,16 @@ void CUDAEnsemble::printHelp(const char *executable) {
     printf(line_fmt, "-c, --concurrent <runs>", "Number of concurrent simulations to run per device");
     printf(line_fmt, "", "By default, 4 will be used.");
     printf(line_fmt, "-o, --out <directory> <filetype>", "Directory and filetype for ensemble outputs");
+    printf(line_fmt, "    --log-threads <threads>", "Number of threads used to export ensemble outputs");
+    printf(line_fmt, "", "By default, 1 will be used.");
     printf(line_fmt, "-q, --quiet", "Do not print progress information to console");
     printf(line_fmt, "-v, --verbose", "Print config, progress and timing (-t) information to console");
     printf(line_fmt, "-t, --timing", "Output timing information to stdout");
     printf(line_fmt, "-e, --error <error level>", "The error level 0, 1, 2, off, slow or fast");
     printf(line_fmt, "", "By default, \"slow\" will be used.");
+    printf(line_fmt, "    --schedule <scheduling>", "The order runs are executed 0, 1, sequential or longest");
+    printf(line_fmt, "", "By default, \"sequential\" will be used.");
+    printf(line_fmt, "    --rtc-bundle <file>", "Preload RTC kernels from a bundle, see CUDASimulation --rtc-bundle-export");
     printf(line_fmt, "-u, --silence-unknown-args", "Silence warnings for unknown arguments passed after this flag.");
 #ifdef _MSC_VER
     printf(line_fmt, "    --standby", "Allow the machine to enter standby during execution");
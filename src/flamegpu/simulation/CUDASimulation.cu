@@ -10,8 +10,8 @@
 #include <utility>
 #include <functional>
 #include <memory>
+#include <mutex>
 
-#include "flamegpu/detail/curand.cuh"
 #include "flamegpu/model/AgentFunctionData.cuh"
 #include "flamegpu/model/LayerData.h"
 #include "flamegpu/model/AgentDescription.h"
@@ -20,11 +20,13 @@
 #include "flamegpu/runtime/HostAPI.h"
 #include "flamegpu/simulation/detail/CUDAEnvironmentDirectedGraphBuffers.cuh"
 #include "flamegpu/simulation/detail/CUDAScanCompaction.h"
+#include "flamegpu/simulation/detail/DataflowGraph.h"
 #include "flamegpu/util/nvtx.h"
 #include "flamegpu/detail/compute_capability.cuh"
 #include "flamegpu/detail/SignalHandlers.h"
 #include "flamegpu/detail/wddm.cuh"
 #include "flamegpu/detail/SteadyClockTimer.h"
+#include "flamegpu/detail/ThreadPool.h"
 #include "flamegpu/detail/CUDAEventTimer.cuh"
 #include "flamegpu/runtime/detail/curve/curve_rtc.cuh"
 #include "flamegpu/runtime/HostFunctionCallback.h"
@@ -32,6 +34,9 @@
 #include "flamegpu/simulation/detail/CUDAAgent.h"
 #include "flamegpu/simulation/detail/CUDAMessage.h"
 #include "flamegpu/simulation/LoggingConfig.h"
+#include "flamegpu/simulation/detail/LogStatistics.cuh"
+#include "flamegpu/simulation/detail/StepLogger.h"
+#include "flamegpu/runtime/agent/DeviceAgentVector_impl.h"
 #include "flamegpu/simulation/LogFrame.h"
 #include "flamegpu/simulation/RunPlan.h"
 #include "flamegpu/version.h"
@@ -200,6 +205,8 @@ CUDASimulation::~CUDASimulation() {
         gpuErrchk(cudaSetDevice(deviceInitialised));
     }
 
+    // The step logger references the environment and scatter singletons
+    step_logger.reset();
     submodel_map.clear();  // Test
     // De-initialise, freeing singletons?
     // @todo - this is unsafe in a destructor as it may invoke cuda commands.
@@ -214,6 +221,11 @@ CUDASimulation::~CUDASimulation() {
     submodel_map.clear();
     directed_graph_map.clear();
     host_api.reset();
+    if (d_hostAgentCreationBuffer) {
+        gpuErrchk(flamegpu::detail::cuda::cudaFree(d_hostAgentCreationBuffer));
+        d_hostAgentCreationBuffer = nullptr;
+        d_hostAgentCreationBufferLen = 0;
+    }
     macro_env->free();
 #ifdef FLAMEGPU_VISUALISATION
     visualisation.reset();  // Might want to force destruct this, as user could hold a ModelVis that has shared ptr
@@ -567,13 +579,17 @@ bool CUDASimulation::step() {
         m->second->setTruncateMessageListFlag();
     }
 
-    // Execute each layer of the simulation.
-    unsigned int layerIndex = 0;
-    for (auto& layer : model->layers) {
-        // Execute the individual layer
-        stepLayer(layer, layerIndex);
-        // Increment counter
-        ++layerIndex;
+    if (getCUDAConfig().dataflow) {
+        stepDataflow();
+    } else {
+        // Execute each layer of the simulation.
+        unsigned int layerIndex = 0;
+        for (auto& layer : model->layers) {
+            // Execute the individual layer
+            stepLayer(layer, layerIndex);
+            // Increment counter
+            ++layerIndex;
+        }
     }
 
     // Run the step functions (including pyhton.)
@@ -626,16 +642,131 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
         return;
     }
 
+    // Sync the environment once per layer (incase Host Fns, or submodel have changed it)
+    singletons->environment->updateDevice_async(getStream(0));
+
+    // Execute the agent functions, each in its own stream
+    stepAgentFunctions(std::vector<std::shared_ptr<AgentFunctionData>>(layer->agent_functions.begin(), layer->agent_functions.end()), layerIndex, 0);
+
+    // Synchronise to ensure that device memory is in a goood state prior to host layer functions? This can potentially be removed
+    this->synchronizeAllStreams();
+
+    // Execute the host functions.
+    layerHostFunctions(layer, layerIndex);
+
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+    // Reset macro-environment read-write flags
+    // Note this does not synchronise threads, it relies on synchronizeAllStreams() post host fns
+    macro_env->resetFlagsAsync(streams);
+#endif
+
+    // Synchronise  after the host layer functions to ensure that the device is up to date? This can potentially be removed.
+    this->synchronizeAllStreams();
+}
+
+void CUDASimulation::stepDataflow() {
+    flamegpu::util::nvtx::Range range{"CUDASimulation::stepDataflow"};
+    if (!dataflow_graph) {
+        detail::DataflowGraph::Options options;
+        // CUDAAgent and CUDAMessage are not safe for use by multiple host threads, so agent functions which touch the same agent type are serialised
+        options.granularity = detail::DataflowGraph::AgentGranularity::Agent;
+        // Concurrent readers of a message list would otherwise race to build its index
+        options.message_builds = true;
+        // Macro properties are not tracked by the graph, and seatbelts validates their accesses per layer
+        options.serialise_agent_functions = !model->environment->macro_properties.empty();
+        dataflow_graph = std::make_unique<detail::DataflowGraph>(*model, options);
+        // Device strings are registered on first use, which is not thread safe, so register them up front
+        for (const auto &node : dataflow_graph->getNodes()) {
+            if (node.type == detail::DataflowGraph::Node::AgentFunction) {
+                singletons->strings.getDeviceString(node.function->parent.lock()->name);
+                singletons->strings.getDeviceString(node.function->initial_state);
+            }
+        }
+    }
+    // Each host thread launching agent functions requires its own stream (and stream index)
+    // Streams are created prior to execution, as getStream() creates streams on demand which is not thread safe
+    const unsigned int thread_count = getCUDAConfig().inLayerConcurrency ? std::max(getMaximumLayerWidth(), 1u) : 1u;
+    this->createStreams(thread_count);
+    if (thread_count == 1) {
+        dataflow_pool.reset();
+    } else if (!dataflow_pool || dataflow_pool->getThreadCount() + 1 != thread_count) {
+        // The calling thread also executes nodes, so the pool requires one fewer worker than the number of streams
+        dataflow_pool.reset();
+        dataflow_pool = std::make_unique<detail::ThreadPool>(thread_count - 1);
+    }
+    std::mutex stream_mutex;
+    std::vector<unsigned int> free_streams(thread_count);
+    std::iota(free_streams.rbegin(), free_streams.rend(), 0u);
+    const bool macro_properties = !model->environment->macro_properties.empty();
+
+    // Sync the environment, it is only modified by host functions and submodels which act as barriers within the graph
+    singletons->environment->updateDevice_async(getStream(0));
+    gpuErrchk(cudaStreamSynchronize(getStream(0)));
+
+    dataflow_graph->execute(dataflow_pool.get(), [this, &stream_mutex, &free_streams, macro_properties](const detail::DataflowGraph::Node &node) {
+        typedef detail::DataflowGraph::Node Node;
+        if (node.type == Node::SubModel) {
+            // Executed by the thread calling step(), once all earlier nodes have completed
+            this->synchronizeAllStreams();
+            auto &sm = submodel_map.at(node.layer->sub_model->name);
+            sm->resetStepCounter();
+            sm->simulate();
+            sm->reset(true);
+            this->synchronizeAllStreams();
+            return;
+        } else if (node.type == Node::HostFunctions) {
+            // Executed by the thread calling step(), once all earlier nodes have completed
+            this->synchronizeAllStreams();
+            layerHostFunctions(node.layer, node.layer_index);
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+            macro_env->resetFlagsAsync(streams);
+#endif
+            // Host functions may have changed the environment
+            singletons->environment->updateDevice_async(getStream(0));
+            this->synchronizeAllStreams();
+            return;
+        }
+        // Worker threads do not inherit the simulation's device
+        gpuErrchk(cudaSetDevice(deviceInitialised));
+        unsigned int streamIdx = 0;
+        {
+            std::lock_guard<std::mutex> lock(stream_mutex);
+            streamIdx = free_streams.back();
+            free_streams.pop_back();
+        }
+        try {
+            if (node.type == Node::MessageBuild) {
+                flamegpu::util::nvtx::Range build_range{std::string("build " + node.message).c_str()};
+                getCUDAMessage(node.message).buildIndex(this->singletons->scatter, streamIdx, this->getStream(streamIdx));
+            } else {
+                stepAgentFunctions({ node.function }, node.layer_index, streamIdx);
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+                if (macro_properties) {
+                    // Agent functions are serialised, so each is treated as its own layer
+                    macro_env->resetFlagsAsync({ this->getStream(streamIdx) });
+                }
+#endif
+            }
+            // Dependents may launch into other streams
+            gpuErrchk(cudaStreamSynchronize(this->getStream(streamIdx)));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(stream_mutex);
+            free_streams.push_back(streamIdx);
+            throw;
+        }
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        free_streams.push_back(streamIdx);
+    });
+}
+
+void CUDASimulation::stepAgentFunctions(const std::vector<std::shared_ptr<AgentFunctionData>>& functions, const unsigned int layerIndex, const unsigned int streamOffset) {
     // Track stream index
-    int streamIdx = 0;
+    unsigned int streamIdx = streamOffset;
     // Sum the total number of threads being launched in the layer
     unsigned int totalThreads = 0;
 
-    // Sync the environment once per layer (incase Host Fns, or submodel have changed it)
-    singletons->environment->updateDevice_async(getStream(0));
-
     // Spatially sort the agents
-    for (const auto &func_des : layer->agent_functions) {
+    for (const auto &func_des : functions) {
         auto func_agent = func_des->parent.lock();
         if ((func_agent->sortPeriod != 0) && (step_count % func_agent->sortPeriod == 0)) {
             if (sortTriggers3D.find(func_des->name) != sortTriggers3D.end()) {
@@ -647,10 +778,10 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
         ++streamIdx;
     }
     // No explicit sync, sorts should be in same stream as eventual kernel launch (digging deep, the underlying scatter method does have a sync though)
-    streamIdx = 0;
+    streamIdx = streamOffset;
 
     // Map agent memory
-    for (const auto &func_des : layer->agent_functions) {
+    for (const auto &func_des : functions) {
         if ((func_des->condition) || (!func_des->rtc_func_condition_name.empty())) {
             auto func_agent = func_des->parent.lock();
             flamegpu::util::nvtx::Range condition_range{std::string("condition map " + func_agent->name + "::" + func_des->name).c_str()};
@@ -690,14 +821,10 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
 
     // If any condition kernel needs to be executed, do so, by checking the number of threads from before.
     if (totalThreads > 0) {
-        // Ensure RandomManager is the correct size to accommodate all threads to be launched
-        detail::curandState *d_rng = singletons->rng.resize(totalThreads, getStream(0));
         // Track which stream to use for concurrency
-        streamIdx = 0;
-        // Sum the total number of threads being launched in the layer, for rng offsetting.
-        totalThreads = 0;
+        streamIdx = streamOffset;
         // Launch function condition kernels
-        for (const auto &func_des : layer->agent_functions) {
+        for (const auto &func_des : functions) {
             if ((func_des->condition) || (!func_des->rtc_func_condition_name.empty())) {
                 auto func_agent = func_des->parent.lock();
                 flamegpu::util::nvtx::Range condition_range{std::string("condition " + func_agent->name + "::" + func_des->name).c_str()};
@@ -720,7 +847,7 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
                 int gridSize = 0;  // The actual grid size needed, based on input size
 
                 //  Agent function condition kernel wrapper args
-                detail::curandState *t_rng = d_rng + totalThreads;
+                detail::PhiloxKey rng_key = singletons->rng.agentFunctionKey(step_count, agent_name, func_name, layerIndex, true);
                 unsigned int *scanFlag_agentDeath = this->singletons->scatter.Scan().Config(detail::CUDAScanCompaction::Type::AGENT_DEATH, streamIdx).d_ptrs.scan_flag;
 #if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
                 auto *error_buffer = this->singletons->exception.getDevicePtr(streamIdx, this->getStream(streamIdx));
@@ -741,7 +868,7 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
                     this->singletons->strings.getDeviceString(func_des->initial_state),
                     static_cast<const char *>(this->singletons->environment->getDeviceBuffer()),
                     state_list_size,
-                    t_rng,
+                    rng_key,
                     scanFlag_agentDeath);
                     gpuErrchkLaunch();
                 } else {  // RTC function
@@ -759,7 +886,7 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
                         reinterpret_cast<void*>(&error_buffer),
 #endif
                         const_cast<void *>(reinterpret_cast<const void*>(&state_list_size)),
-                        reinterpret_cast<void*>(&t_rng),
+                        reinterpret_cast<void*>(&rng_key),
                         reinterpret_cast<void*>(&scanFlag_agentDeath) });
                     if (a != CUresult::CUDA_SUCCESS) {
                         const char* err_str = nullptr;
@@ -768,17 +895,15 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
                     }
                     gpuErrchkLaunch();
                 }
-
-                totalThreads += state_list_size;
             }
             ++streamIdx;
         }
     }
 
     // Track stream index
-    streamIdx = 0;
+    streamIdx = streamOffset;
     // Unmap agent memory, apply condition.
-    for (const auto &func_des : layer->agent_functions) {
+    for (const auto &func_des : functions) {
         if ((func_des->condition) || (!func_des->rtc_func_condition_name.empty())) {
             auto func_agent = func_des->parent.lock();
             if (!func_agent) {
@@ -805,11 +930,11 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
         ++streamIdx;
     }
 
-    streamIdx = 0;
+    streamIdx = streamOffset;
     // Sum the total number of threads being launched in the layer
     totalThreads = 0;
     // for each func function - Loop through to do all mapping of agent and message variables
-    for (const auto &func_des : layer->agent_functions) {
+    for (const auto &func_des : functions) {
         auto func_agent = func_des->parent.lock();
         if (!func_agent) {
             THROW exception::InvalidAgentFunc("Agent function refers to expired agent.");
@@ -890,14 +1015,10 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
 
     // If any kernel needs to be executed, do so, by checking the number of threads from before.
     if (totalThreads > 0) {
-        // Ensure RandomManager is the correct size to accommodate all threads to be launched
-        detail::curandState *d_rng = singletons->rng.resize(totalThreads, getStream(0));
-        // Total threads is now used to provide kernel launches an offset to thread-safe thread-index
-        totalThreads = 0;
-        streamIdx = 0;
+        streamIdx = streamOffset;
 
         // for each func function - Loop through to launch all agent functions
-        for (const auto &func_des : layer->agent_functions) {
+        for (const auto &func_des : functions) {
             auto func_agent = func_des->parent.lock();
             if (!func_agent) {
                 THROW exception::InvalidAgentFunc("Agent function refers to expired agent.");
@@ -944,7 +1065,7 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
             int gridSize = 0;  // The actual grid size needed, based on input size
 
             // Agent function kernel wrapper args
-            detail::curandState *t_rng = d_rng + totalThreads;
+            detail::PhiloxKey rng_key = singletons->rng.agentFunctionKey(step_count, agent_name, func_name, layerIndex, false);
             unsigned int *scanFlag_agentDeath = func_des->has_agent_death ? this->singletons->scatter.Scan().Config(detail::CUDAScanCompaction::Type::AGENT_DEATH, streamIdx).d_ptrs.scan_flag : nullptr;
             unsigned int *scanFlag_messageOutput = this->singletons->scatter.Scan().Config(detail::CUDAScanCompaction::Type::MESSAGE_OUTPUT, streamIdx).d_ptrs.scan_flag;
             unsigned int *scanFlag_agentOutput = this->singletons->scatter.Scan().Config(detail::CUDAScanCompaction::Type::AGENT_OUTPUT, streamIdx).d_ptrs.scan_flag;
@@ -970,7 +1091,7 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
                     state_list_size,
                     d_in_messagelist_metadata,
                     d_out_messagelist_metadata,
-                    t_rng,
+                    rng_key,
                     scanFlag_agentDeath,
                     scanFlag_messageOutput,
                     scanFlag_agentOutput);
@@ -992,7 +1113,7 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
                     const_cast<void*>(reinterpret_cast<const void*>(&state_list_size)),
                     const_cast<void*>(reinterpret_cast<const void*>(&d_in_messagelist_metadata)),
                     const_cast<void*>(reinterpret_cast<const void*>(&d_out_messagelist_metadata)),
-                    const_cast<void*>(reinterpret_cast<const void*>(&t_rng)),
+                    reinterpret_cast<void*>(&rng_key),
                     reinterpret_cast<void*>(&scanFlag_agentDeath),
                     reinterpret_cast<void*>(&scanFlag_messageOutput),
                     reinterpret_cast<void*>(&scanFlag_agentOutput)});
@@ -1003,14 +1124,13 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
                 }
                 gpuErrchkLaunch();
             }
-            totalThreads += state_list_size;
             ++streamIdx;
         }
     }
 
-    streamIdx = 0;
+    streamIdx = streamOffset;
     // for each func function - Loop through to un-map all agent and message variables
-    for (const auto &func_des : layer->agent_functions) {
+    for (const auto &func_des : functions) {
         auto func_agent = func_des->parent.lock();
         if (!func_agent) {
             THROW exception::InvalidAgentFunc("Agent function refers to expired agent.");
@@ -1062,21 +1182,6 @@ void CUDASimulation::stepLayer(const std::shared_ptr<LayerData>& layer, const un
 
         ++streamIdx;
     }
-
-    // Synchronise to ensure that device memory is in a goood state prior to host layer functions? This can potentially be removed
-    this->synchronizeAllStreams();
-
-    // Execute the host functions.
-    layerHostFunctions(layer, layerIndex);
-
-#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
-    // Reset macro-environment read-write flags
-    // Note this does not synchronise threads, it relies on synchronizeAllStreams() post host fns
-    macro_env->resetFlagsAsync(streams);
-#endif
-
-    // Synchronise  after the host layer functions to ensure that the device is up to date? This can potentially be removed.
-    this->synchronizeAllStreams();
 }
 
 void CUDASimulation::layerHostFunctions(const std::shared_ptr<LayerData>& layer, const unsigned int layerIndex) {
@@ -1330,9 +1435,7 @@ void CUDASimulation::simulate(const RunPlan& plan) {
     // Ensure singletons have been initialised (so env actually exists in mgr)
     initialiseSingletons();
     // Override environment properties
-    for (auto& ovrd : plan.property_overrides) {
-        singletons->environment->setPropertyDirect(ovrd.first, static_cast<char *>(ovrd.second.ptr));
-    }
+    applyPropertyOverrides(plan);
     // Call regular simulate
     simulate();
     // Reset config
@@ -1340,6 +1443,12 @@ void CUDASimulation::simulate(const RunPlan& plan) {
     SimulationConfig().steps = t_steps;
 }
 
+void CUDASimulation::applyPropertyOverrides(const RunPlan& plan) {
+    for (auto& ovrd : plan.property_overrides) {
+        singletons->environment->setPropertyDirect(ovrd.first, static_cast<char *>(ovrd.second.ptr));
+    }
+}
+
 void CUDASimulation::reset(bool submodelReset) {
     // Reset step counter
     resetStepCounter();
@@ -1348,9 +1457,10 @@ void CUDASimulation::reset(bool submodelReset) {
         // Reset environment properties
         singletons->environment->resetModel(*model->environment);
 
-        // Reseed random, unless performing submodel reset
+        // Reseed random and zero macro properties, unless performing submodel reset
         if (!submodelReset) {
             singletons->rng.reseed(getSimulationConfig().random_seed);
+            macro_env->resetProperties(getStream(0));
         }
     }
 
@@ -1374,6 +1484,16 @@ void CUDASimulation::reset(bool submodelReset) {
     }
 
 
+    // Empty directed graphs, unless performing submodel reset
+    // Graphs mapped from the master model belong to it, so are reset by the master model
+    if (!submodelReset) {
+        for (auto &[name, graph] : directed_graph_map) {
+            if (!submodel || submodel->subenvironment->directed_graphs.find(name) == submodel->subenvironment->directed_graphs.end()) {
+                graph->reset();
+            }
+        }
+    }
+
     // Trigger reset in all submodels, propagation is not necessary when performing submodel reset
     if (!submodelReset) {
         for (auto &s : submodel_map) {
@@ -1449,6 +1569,11 @@ void CUDASimulation::setStepLog(const StepLoggingConfig &stepConfig) {
     if (*stepConfig.model != *model) {
         THROW exception::InvalidArgument("Model descriptions attached to LoggingConfig and CUDASimulation do not match, in CUDASimulation::setStepLog()\n");
     }
+    // Collect logs captured with the previous config, a new logger is required for the new layout
+    if (step_logger) {
+        step_logger->collect(run_log->step);
+        step_logger.reset();
+    }
     // Set internal config
     step_log_config = std::make_shared<StepLoggingConfig>(stepConfig);
 }
@@ -1470,6 +1595,21 @@ bool CUDASimulation::checkArgs_derived(int argc, const char** argv, int &i) {
         config.device_id = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 0));
         return true;
     }
+    // --rtc-bundle <file>, Preloads the RTC kernel bundle
+    if (arg.compare("--rtc-bundle") == 0 && argc > i+1) {
+        config.rtc_bundle = argv[++i];
+        return true;
+    }
+    // --rtc-bundle-export <file>, Exports the model's RTC kernels to a bundle
+    if (arg.compare("--rtc-bundle-export") == 0 && argc > i+1) {
+        config.rtc_bundle_export = argv[++i];
+        return true;
+    }
+    // --dataflow, Execute the model's layers as their dependencies complete, rather than by layer
+    if (arg.compare("--dataflow") == 0) {
+        config.dataflow = true;
+        return true;
+    }
     return false;
 }
 
@@ -1477,6 +1617,9 @@ void CUDASimulation::printHelp_derived() {
     const char *line_fmt = "%-18s %s\n";
     printf("CUDA Model Optional Arguments:\n");
     printf(line_fmt, "-d, --device", "GPU index");
+    printf(line_fmt, "    --rtc-bundle <file>", "Preload RTC kernels from a bundle");
+    printf(line_fmt, "    --rtc-bundle-export <file>", "Export the model's RTC kernels to a bundle");
+    printf(line_fmt, "    --dataflow", "Execute agent and host functions as their dependencies complete, rather than by layer");
 }
 
 void CUDASimulation::applyConfig_derived() {
@@ -1547,6 +1690,10 @@ void CUDASimulation::applyConfig_derived() {
 
     // We init Random through submodel hierarchy after singletons
     reseed(getSimulationConfig().random_seed);
+
+    if (!config.rtc_bundle_export.empty()) {
+        exportRTCBundle(config.rtc_bundle_export);
+    }
 }
 
 void CUDASimulation::reseed(const uint64_t seed) {
@@ -1566,6 +1713,10 @@ void CUDASimulation::reseed(const uint64_t seed) {
 void CUDASimulation::initialiseSingletons() {
     // Only do this once.
     if (!singletonsInitialised) {
+        // Preload RTC kernels before any (sub)model begins compiling them
+        if (!config.rtc_bundle.empty()) {
+            detail::JitifyCache::getInstance().loadBundle(config.rtc_bundle);
+        }
         // If the device has not been specified, also check the compute capability is OK
         // Check the compute capability of the device, throw an exception if not valid for the executable.
         if (!detail::compute_capability::checkComputeCapability(static_cast<int>(config.device_id))) {
@@ -1585,7 +1736,7 @@ void CUDASimulation::initialiseSingletons() {
         cudaStream_t stream_0 = getStream(0);
 
         // Pass created RandomManager to host api
-        host_api = std::make_unique<HostAPI>(*this, singletons->rng, singletons->scatter, agentOffsets, agentData, singletons->environment, macro_env, directed_graph_map, 0, stream_0);  // Host fns are currently all serial
+        host_api = std::make_unique<HostAPI>(*this, singletons->rng, singletons->scatter, agentOffsets, agentData, agentBatches, singletons->environment, macro_env, directed_graph_map, 0, stream_0);  // Host fns are currently all serial
 
         for (auto &cm : message_map) {
             cm.second->init(singletons->scatter, 0, stream_0);
@@ -1700,6 +1851,10 @@ void CUDASimulation::initialiseRTC() {
                 }
             }
         }
+        // RTC functions are compiled concurrently, wait for them all to complete
+        for (auto &a : agent_map) {
+            a.second->finaliseRTCFunctions();
+        }
 
         rtcInitialised = true;
 
@@ -1712,6 +1867,23 @@ void CUDASimulation::initialiseRTC() {
     }
 }
 
+void CUDASimulation::getRTCKernelSources(std::vector<detail::JitifyCache::KernelSource> &sources) const {
+    for (const auto &a : agent_map) {
+        const auto &a_sources = a.second->getRTCKernelSources();
+        sources.insert(sources.end(), a_sources.begin(), a_sources.end());
+    }
+    for (const auto &sm : submodel_map) {
+        sm.second->getRTCKernelSources(sources);
+    }
+}
+void CUDASimulation::exportRTCBundle(const std::string &filepath) {
+    flamegpu::util::nvtx::Range range{"CUDASimulation::exportRTCBundle"};
+    initialiseSingletons();
+    std::vector<detail::JitifyCache::KernelSource> sources;
+    getRTCKernelSources(sources);
+    detail::JitifyCache::getInstance().exportBundle(filepath, sources);
+}
+
 CUDASimulation::Config &CUDASimulation::CUDAConfig() {
     return config;
 }
@@ -1753,12 +1925,17 @@ void CUDASimulation::initOffsetsAndMap() {
             agent_states.emplace(state, AgentDataBuffer());
         agentData.emplace(agent.first, std::move(agent_states));
     }
+    agentBatches.clear();
+    for (const auto &agent : md.agents) {
+        AgentBatchBufferStateMap agent_states;
+        for (const auto&state : agent.second->states)
+            agent_states.emplace(state, NewAgentBatchBuffer());
+        agentBatches.emplace(agent.first, std::move(agent_states));
+    }
 }
 
 void CUDASimulation::processHostAgentCreation(const unsigned int streamId) {
-    size_t t_bufflen = 0;
-    char *t_buff = nullptr;
-    char *dt_buff = nullptr;
+    bool copied = false;
     // For each agent type
     for (auto &agent : agentData) {
         // We need size of agent
@@ -1769,34 +1946,53 @@ void CUDASimulation::processHostAgentCreation(const unsigned int streamId) {
             if (state.second.size()) {
                 size_t size_req = offsets.totalSize * state.second.size();
                 {  // Ensure we have enough temp memory
-                    if (size_req > t_bufflen) {
-                        if (t_buff) {
-                            free(t_buff);
-                            gpuErrchk(flamegpu::detail::cuda::cudaFree(dt_buff));
+                    if (size_req > hostAgentCreationBuffer.size()) {
+                        hostAgentCreationBuffer.resize(size_req);
+                    }
+                    if (size_req > d_hostAgentCreationBufferLen) {
+                        if (d_hostAgentCreationBuffer) {
+                            gpuErrchk(flamegpu::detail::cuda::cudaFree(d_hostAgentCreationBuffer));
                         }
-                        t_buff = reinterpret_cast<char*>(malloc(size_req));
-                        gpuErrchk(cudaMalloc(&dt_buff, size_req));
-                        t_bufflen = size_req;
+                        gpuErrchk(cudaMalloc(&d_hostAgentCreationBuffer, size_req));
+                        d_hostAgentCreationBufferLen = size_req;
                     }
                 }
                 // Copy buffer memory into a single block
+                char *t_buff = hostAgentCreationBuffer.data();
                 for (unsigned int i = 0; i < state.second.size(); ++i) {
                     memcpy(t_buff + (i*offsets.totalSize), state.second[i].data, offsets.totalSize);
                 }
                 // Copy t_buff to device
-                gpuErrchk(cudaMemcpyAsync(dt_buff, t_buff, size_req, cudaMemcpyHostToDevice, this->getStream(streamId)));
+                gpuErrchk(cudaMemcpyAsync(d_hostAgentCreationBuffer, t_buff, size_req, cudaMemcpyHostToDevice, this->getStream(streamId)));
                 // Scatter to device
                 auto &cudaagent = agent_map.at(agent.first);
-                cudaagent->scatterHostCreation(state.first, static_cast<unsigned int>(state.second.size()), dt_buff, offsets, this->singletons->scatter, streamId, this->getStream(streamId));
+                cudaagent->scatterHostCreation(state.first, static_cast<unsigned int>(state.second.size()), d_hostAgentCreationBuffer, offsets, this->singletons->scatter, streamId, this->getStream(streamId));
                 // Clear buffer
                 state.second.clear();
+                copied = true;
             }
         }
     }
-    // Release temp memory
-    if (t_buff) {
-        free(t_buff);
-        gpuErrchk(flamegpu::detail::cuda::cudaFree(dt_buff));
+    // For each agent type, copy batches created by newAgents()
+    for (auto &agent : agentBatches) {
+        const VarOffsetStruct &offsets = agentOffsets.at(agent.first);
+        auto &cudaagent = agent_map.at(agent.first);
+        for (auto &state : agent.second) {
+            for (auto &batch : state.second.batches) {
+                if (batch.count) {
+                    // Batches are already columnar, so copy directly from their storage
+                    cudaagent->copyHostCreationColumns(state.first, batch.count, batch.data.data(), offsets, this->singletons->scatter, streamId, this->getStream(streamId));
+                    copied = true;
+                }
+                // Release the batch's storage for reuse by the next batch
+                state.second.released.push_back(std::move(batch.data));
+            }
+            state.second.batches.clear();
+        }
+    }
+    // Staging buffers are reused by the next call, so ensure the copies have completed
+    if (copied) {
+        gpuErrchk(cudaStreamSynchronize(this->getStream(streamId)));
     }
 }
 
@@ -1895,6 +2091,8 @@ void CUDASimulation::initMacroEnvironment() {
 void CUDASimulation::resetLog() {
     // Track previous device id, so we can avoid costly request for device properties if not required
     static int previous_device_id = -1;
+    // Discard any step logs still being captured
+    step_logger.reset();
     run_log->step.clear();
     run_log->exit = ExitLogFrame();
     run_log->random_seed = SimulationConfig().random_seed;
@@ -1915,40 +2113,93 @@ void CUDASimulation::resetLog() {
 #endif
     run_log->performance_specs.flamegpu_version = VERSION_FULL;
 }
-void CUDASimulation::processStepLog(const double step_time_seconds) {
-    if (!step_log_config)
-        return;
-    if (step_count % step_log_config->frequency != 0)
-        return;
-    // Iterate members of step log to build the step log frame
-    std::map<std::string, detail::Any> environment_log;
-    for (const auto &prop_name : step_log_config->environment) {
-        // Fetch the named environment prop
-        environment_log.emplace(prop_name, singletons->environment->getPropertyAny(prop_name));
-    }
+namespace {
+/**
+ * Computes the agent variable reductions and agent counts requested by a logging config
+ * Each variable's reductions are computed together in a single pass, and each agent state is returned with one copy and synchronisation
+ * @param agents The agent states and reductions to be logged, from LoggingConfig::agents
+ * @param agent_map The simulation's agents
+ * @param scatter Scatter singleton, provides the cub temporary storage
+ * @param stream The CUDA stream to perform the reductions within
+ */
+std::map<util::StringPair, std::pair<std::map<LoggingConfig::NameReductionFn, detail::Any>, unsigned int>> processAgentLog(const std::map<util::StringPair, std::pair<std::shared_ptr<std::set<LoggingConfig::NameReductionFn>>, bool>> &agents,
+    const std::unordered_map<std::string, std::unique_ptr<detail::CUDAAgent>> &agent_map,
+    detail::CUDAScatter &scatter, const cudaStream_t stream) {
     std::map<util::StringPair, std::pair<std::map<LoggingConfig::NameReductionFn, detail::Any>, unsigned int>> agents_log;
-    for (const auto &name_state : step_log_config->agents) {
+    std::vector<char> h_statistics;
+    for (const auto &name_state : agents) {
         // Create the named sub map
         const std::string &agent_name = name_state.first.first;
         const std::string &agent_state = name_state.first.second;
-        HostAgentAPI host_agent = host_api->agent(agent_name, agent_state);
         auto &agent_state_log = agents_log.emplace(name_state.first, std::make_pair(std::map<LoggingConfig::NameReductionFn, detail::Any>(), UINT_MAX)).first->second;
-        // Log individual variable reductions
-        for (const auto &name_reduction : *name_state.second.first) {
-            // Perform the corresponding reduction
-            auto result = name_reduction.function(host_agent, name_reduction.name);
-            // Store the result
-            agent_state_log.first.emplace(name_reduction, std::move(result));
+        detail::CUDAAgent &cuda_agent = *agent_map.at(agent_name);
+        // If the user has a DeviceAgentVector out, sync changes
+        std::shared_ptr<DeviceAgentVector_impl> population = cuda_agent.getPopulationVec(agent_state);
+        if (population) {
+            population->syncChanges();
         }
+        const unsigned int agent_count = cuda_agent.getStateSize(agent_state);
         // Log count of agents in state
         if (name_state.second.second) {
-            agent_state_log.second = host_api->agent(agent_name, agent_state).count();
+            agent_state_log.second = agent_count;
+        }
+        // The set is ordered by variable name, so each variable's reductions are adjacent and share a single LogStatistics
+        // Pack the statistics of each variable into one output buffer, followed by the cub temporary storage they share
+        std::vector<std::pair<const LoggingConfig::NameReductionFn*, size_t>> variables;
+        size_t statistics_bytes = 0;
+        size_t temp_bytes = 0;
+        for (const auto &name_reduction : *name_state.second.first) {
+            if (variables.empty() || variables.back().first->name != name_reduction.name) {
+                variables.emplace_back(&name_reduction, statistics_bytes);
+                statistics_bytes += name_reduction.statistics->size;
+                if (agent_count) {
+                    temp_bytes = std::max(temp_bytes, name_reduction.statistics->tempStorageBytes(agent_count));
+                }
+            }
+        }
+        if (variables.empty()) {
+            continue;
+        }
+        h_statistics.resize(statistics_bytes);
+        if (agent_count) {
+            // Align the temporary storage as cub would
+            const size_t temp_offset = (statistics_bytes + 255) / 256 * 256;
+            auto &cub_temp = scatter.CubTemp(0);
+            cub_temp.resize(temp_offset + temp_bytes);
+            char *d_statistics = static_cast<char*>(cub_temp.getPtr());
+            for (const auto &variable : variables) {
+                variable.first->statistics->reduce(cuda_agent.getStateVariablePtr(agent_state, variable.first->name), agent_count,
+                    d_statistics + variable.second, d_statistics + temp_offset, temp_bytes, stream);
+            }
+            gpuErrchk(cudaMemcpyAsync(h_statistics.data(), d_statistics, statistics_bytes, cudaMemcpyDeviceToHost, stream));
+            gpuErrchk(cudaStreamSynchronize(stream));
+        }
+        // Log individual variable reductions
+        auto variable = variables.begin();
+        for (const auto &name_reduction : *name_state.second.first) {
+            if (variable + 1 != variables.end() && (variable + 1)->first->name == name_reduction.name) {
+                ++variable;
+            }
+            const void *h_variable_statistics = h_statistics.data() + variable->second;
+            agent_state_log.first.emplace(name_reduction, agent_count
+                ? name_reduction.statistics->result(h_variable_statistics, name_reduction.reduction)
+                : name_reduction.statistics->emptyResult(name_reduction.reduction));
         }
     }
+    return agents_log;
+}
+}  // anonymous namespace
 
-    // Append to step log
-    run_log->step.push_back(StepLogFrame(std::move(environment_log), std::move(agents_log), step_count));
-    run_log->step.back().step_time = step_time_seconds;
+void CUDASimulation::processStepLog(const double step_time_seconds) {
+    if (!step_log_config)
+        return;
+    if (step_count % step_log_config->frequency != 0)
+        return;
+    if (!step_logger) {
+        step_logger = std::make_unique<detail::StepLogger>(*step_log_config, *singletons->environment, agent_map, deviceInitialised);
+    }
+    // Frames are assembled in the background, and appended to the step log by getRunLog()
+    step_logger->capture(step_count, step_time_seconds, singletons->scatter, streams);
 }
 
 void CUDASimulation::processExitLog() {
@@ -1960,25 +2211,7 @@ void CUDASimulation::processExitLog() {
         // Fetch the named environment prop
         environment_log.emplace(prop_name, singletons->environment->getPropertyAny(prop_name));
     }
-    std::map<util::StringPair, std::pair<std::map<LoggingConfig::NameReductionFn, detail::Any>, unsigned int>> agents_log;
-    for (const auto &name_state : exit_log_config->agents) {
-        // Create the named sub map
-        const std::string &agent_name = name_state.first.first;
-        const std::string &agent_state = name_state.first.second;
-        HostAgentAPI host_agent = host_api->agent(agent_name, agent_state);
-        auto &agent_state_log = agents_log.emplace(name_state.first, std::make_pair(std::map<LoggingConfig::NameReductionFn, detail::Any>(), UINT_MAX)).first->second;
-        // Log individual variable reductions
-        for (const auto &name_reduction : *name_state.second.first) {
-            // Perform the corresponding reduction
-            auto result = name_reduction.function(host_agent, name_reduction.name);
-            // Store the result
-            agent_state_log.first.emplace(name_reduction, std::move(result));
-        }
-        // Log count of agents in state
-        if (name_state.second.second) {
-            agent_state_log.second = host_api->agent(agent_name, agent_state).count();
-        }
-    }
+    auto agents_log = processAgentLog(exit_log_config->agents, agent_map, singletons->scatter, getStream(0));
 
     // Set Log
     run_log->exit = ExitLogFrame(std::move(environment_log), std::move(agents_log), step_count);
@@ -1988,7 +2221,11 @@ void CUDASimulation::processExitLog() {
     run_log->exit.exit_time = getElapsedTimeExitFunctions();
     run_log->exit.total_time = getElapsedTimeSimulation();
 }
-const RunLog &CUDASimulation::getRunLog() const {
+const RunLog &CUDASimulation::getRunLog() {
+    // Wait for any step logs still being assembled
+    if (step_logger) {
+        step_logger->collect(run_log->step);
+    }
     return *run_log;
 }
 
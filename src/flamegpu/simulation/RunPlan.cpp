@@ -16,6 +16,7 @@ RunPlan::RunPlan(const ModelDescription &model)
 RunPlan::RunPlan(const std::shared_ptr<const std::unordered_map<std::string, EnvironmentData::PropData>>  &environment, const bool allow_0)
     : random_seed(0)
     , steps(1)
+    , cost(0)
     , environment(environment)
     , allow_0_steps(allow_0) { }
 
@@ -25,6 +26,7 @@ RunPlan& RunPlan::operator=(const RunPlan& other) {
     this->environment = other.environment;
     this->allow_0_steps = other.allow_0_steps;
     this->output_subdirectory = other.output_subdirectory;
+    this->cost = other.cost;
     this->allow_0_steps = other.allow_0_steps;
     for (auto &i : other.property_overrides)
         this->property_overrides.emplace(i.first, detail::Any(i.second));
@@ -43,6 +45,13 @@ void RunPlan::setSteps(const unsigned int _steps) {
 void RunPlan::setOutputSubdirectory(const std::string &subdir) {
     output_subdirectory = subdir;
 }
+void RunPlan::setCost(const double _cost) {
+    if (!(_cost >= 0)) {
+        THROW exception::InvalidArgument("RunPlan cost must be a non-negative value, "
+            "in RunPlan::setCost()");
+    }
+    cost = _cost;
+}
 
 uint64_t RunPlan::getRandomSimulationSeed() const {
     return random_seed;
@@ -53,6 +62,9 @@ unsigned int RunPlan::getSteps() const {
 std::string RunPlan::getOutputSubdirectory() const {
     return output_subdirectory;
 }
+double RunPlan::getCost() const {
+    return cost;
+}
 
 RunPlanVector RunPlan::operator+(const RunPlan& rhs) const {
     // Validation
@@ -95,7 +107,8 @@ bool RunPlan::operator==(const RunPlan& rhs) const {
         this->property_overrides == rhs.property_overrides &&
         this->environment == rhs.environment &&  // Could check the pointed to map matches instead
         this->allow_0_steps == rhs.allow_0_steps &&
-        this->output_subdirectory == rhs.output_subdirectory) {
+        this->output_subdirectory == rhs.output_subdirectory &&
+        this->cost == rhs.cost) {
         return true;
     }
     return false;
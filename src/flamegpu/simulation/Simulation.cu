@@ -279,7 +279,7 @@ int Simulation::checkArgs(int argc, const char** argv) {
             config.silence_unknown_args = true;
             continue;
         }
-        // --out-step <file.xml/file.json>, Step log file path
+        // --out-step <file.xml/file.json/file.bin>, Step log file path
         if (arg.compare("--out-step") == 0) {
             if (i + 1 >= argc) {
                 fprintf(stderr, "%s requires a trailing argument\n", arg.c_str());
@@ -288,7 +288,7 @@ int Simulation::checkArgs(int argc, const char** argv) {
             config.step_log_file = argv[++i];
             continue;
         }
-        // --out-exit <file.xml/file.json>, Exit log file path
+        // --out-exit <file.xml/file.json/file.bin>, Exit log file path
         if (arg.compare("--out-exit") == 0) {
             if (i + 1 >= argc) {
                 fprintf(stderr, "%s requires a trailing argument\n", arg.c_str());
@@ -297,7 +297,7 @@ int Simulation::checkArgs(int argc, const char** argv) {
             config.exit_log_file = argv[++i];
             continue;
         }
-        // --out-log <file.xml/file.json>, Common log file path
+        // --out-log <file.xml/file.json/file.bin>, Common log file path
         if (arg.compare("--out-log") == 0) {
             if (i + 1 >= argc) {
                 fprintf(stderr, "%s requires a trailing argument\n", arg.c_str());
@@ -336,9 +336,9 @@ void Simulation::printHelp(const char* executable) {
     const char *line_fmt = "%-18s %s\n";
     printf(line_fmt, "-h, --help", "show this help message and exit");
     printf(line_fmt, "-i, --in <file.xml/file.json>", "Initial state file (XML or JSON)");
-    printf(line_fmt, "    --out-step <file.xml/file.json>", "Step log file (XML or JSON)");
-    printf(line_fmt, "    --out-exit <file.xml/file.json>", "Exit log file (XML or JSON)");
-    printf(line_fmt, "    --out-log <file.xml/file.json>", "Common log file (XML or JSON)");
+    printf(line_fmt, "    --out-step <file.xml/file.json/file.bin>", "Step log file (XML, JSON or binary)");
+    printf(line_fmt, "    --out-exit <file.xml/file.json/file.bin>", "Exit log file (XML, JSON or binary)");
+    printf(line_fmt, "    --out-log <file.xml/file.json/file.bin>", "Common log file (XML, JSON or binary)");
     printf(line_fmt, "-s, --steps <steps>", "Number of simulation iterations");
     printf(line_fmt, "-r, --random <seed>", "RandomManager seed");
     printf(line_fmt, "-q, --quiet", "Do not print progress information to console");
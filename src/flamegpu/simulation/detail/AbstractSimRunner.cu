@@ -1,5 +1,6 @@
 #include "flamegpu/simulation/detail/AbstractSimRunner.h"
 
+#include <climits>
 #include <utility>
 #include <vector>
 #include <queue>
@@ -13,6 +14,7 @@
 #endif
 
 #include "flamegpu/model/ModelData.h"
+#include "flamegpu/detail/SteadyClockTimer.h"
 #include "flamegpu/simulation/CUDASimulation.h"
 #include "flamegpu/simulation/RunPlanVector.h"
 
@@ -32,8 +34,10 @@ AbstractSimRunner::AbstractSimRunner(const std::shared_ptr<const ModelData> _mod
     std::queue<unsigned int> &_log_export_queue,
     std::mutex &_log_export_queue_mutex,
     std::condition_variable &_log_export_queue_cdn,
+    const unsigned int _max_log_export_backlog,
     std::vector<ErrorDetail> &_err_detail,
     const unsigned int _total_runners,
+    const bool _reuse_simulation,
     bool _isSWIG)
       : model(_model->clone())
       , device_id(_device_id)
@@ -49,11 +53,18 @@ AbstractSimRunner::AbstractSimRunner(const std::shared_ptr<const ModelData> _mod
       , log_export_queue(_log_export_queue)
       , log_export_queue_mutex(_log_export_queue_mutex)
       , log_export_queue_cdn(_log_export_queue_cdn)
+      , max_log_export_backlog(_max_log_export_backlog)
       , err_detail(_err_detail)
+      , reuse_simulation(_reuse_simulation)
       , isSWIG(_isSWIG) {
 }
+AbstractSimRunner::~AbstractSimRunner() = default;
 void AbstractSimRunner::start() {
-    this->thread = std::thread(&AbstractSimRunner::main, this);
+    this->thread = std::thread([this]() {
+        main();
+        // Release the reused simulation from the runner's thread, rather than when the runner is destroyed
+        simulation.reset();
+    });
     // Attempt to name the thread
 #ifdef _MSC_VER
     std::wstringstream thread_name;
@@ -80,40 +91,65 @@ void AbstractSimRunner::join() {
 }
 
 void AbstractSimRunner::runSimulation(int plan_id) {
-    // Update environment (this might be worth moving into CUDASimulation)
-    auto &prop_map = model->environment->properties;
-    for (auto &ovrd : plans[plan_id].property_overrides) {
-        auto &prop = prop_map.at(ovrd.first);
-        memcpy(prop.data.ptr, ovrd.second.ptr, prop.data.length);
+    // Time spent waiting for the logger is not considered busy
+    SteadyClockTimer run_timer;
+    run_timer.start();
+    ++run_count;
+    if (!simulation) {
+        // Set simulation device
+        simulation = std::unique_ptr<CUDASimulation>(new CUDASimulation(model, isSWIG));
+        simulation->SimulationConfig().verbosity = Verbosity::Default;
+        if (verbosity == Verbosity::Quiet)  // Use quiet verbosity for sims if set in ensemble but never verbose
+            simulation->SimulationConfig().verbosity = Verbosity::Quiet;
+        simulation->SimulationConfig().telemetry = false;   // Never any telemtry for individual runs inside an ensemble
+        simulation->SimulationConfig().timing = false;
+        simulation->CUDAConfig().device_id = this->device_id;
+        simulation->CUDAConfig().is_ensemble = true;
+        simulation->applyConfig();
+        // Set the step config directly, to bypass validation
+        simulation->step_log_config = step_log_config;
+        simulation->exit_log_config = exit_log_config;
+    } else {
+        // Return the previous run's simulation to a clean state, resetting environment properties to the model's defaults
+        simulation->reset(false);
     }
-    // Set simulation device
-    std::unique_ptr<CUDASimulation> simulation = std::unique_ptr<CUDASimulation>(new CUDASimulation(model, isSWIG));
     // Copy steps and seed from runplan
     simulation->SimulationConfig().steps = plans[plan_id].getSteps();
-    simulation->SimulationConfig().random_seed = plans[plan_id].getRandomSimulationSeed();
-    simulation->SimulationConfig().verbosity = Verbosity::Default;
-    if (verbosity == Verbosity::Quiet)  // Use quiet verbosity for sims if set in ensemble but never verbose
-        simulation->SimulationConfig().verbosity = Verbosity::Quiet;
-    simulation->SimulationConfig().telemetry = false;   // Never any telemtry for individual runs inside an ensemble
-    simulation->SimulationConfig().timing = false;
-    simulation->CUDAConfig().device_id = this->device_id;
-    simulation->CUDAConfig().is_ensemble = true;
     simulation->CUDAConfig().ensemble_run_id = plan_id;
-    simulation->applyConfig();
-    // Set the step config directly, to bypass validation
-    simulation->step_log_config = step_log_config;
-    simulation->exit_log_config = exit_log_config;
+    // Reseed through the submodel hierarchy, as performed by applyConfig()
+    simulation->reseed(plans[plan_id].getRandomSimulationSeed());
+    // Update environment
+    simulation->applyPropertyOverrides(plans[plan_id]);
     // Don't need to set pop, this must be done via init function within ensembles
     // Execute simulation
-    simulation->simulate();
+    try {
+        simulation->simulate();
+    } catch (...) {
+        // The simulation may have been left in an unknown state, so the next run begins with a new instance
+        simulation.reset();
+        run_timer.stop();
+        busy_time += run_timer.getElapsedSeconds();
+        throw;
+    }
+    run_timer.stop();
+    busy_time += run_timer.getElapsedSeconds();
     {
-        std::lock_guard<std::mutex> lck(log_export_queue_mutex);
+        std::unique_lock<std::mutex> lck(log_export_queue_mutex);
+        // If the logger has fallen behind, wait for it to catch up rather than growing the backlog
+        // Don't wait once the logger has reached the exit marker (UINT_MAX, pushed when fail fast triggers), as it will not export any further logs
+        if (max_log_export_backlog) {
+            log_export_queue_cdn.wait(lck, [this]() { return log_export_queue.size() < max_log_export_backlog || log_export_queue.front() == UINT_MAX; });
+        }
         // Store results in run_log
         run_logs.emplace(plan_id, simulation->getRunLog());
         // Notify logger
         log_export_queue.push(plan_id);
     }
-    log_export_queue_cdn.notify_one();
+    if (!reuse_simulation) {
+        simulation.reset();
+    }
+    // Runners may also be waiting on this condition, so all must be notified
+    log_export_queue_cdn.notify_all();
 }
 
 }  // namespace detail
@@ -11,6 +11,7 @@
 #include <utility>
 #include <list>
 #include <memory>
+#include <exception>
 
 #ifdef _MSC_VER
 #pragma warning(push, 1)
@@ -334,6 +335,15 @@ void CUDAAgent::scatterHostCreation(const std::string &state_name, const unsigne
     }
     sm->second->scatterHostCreation(newSize, d_inBuff, offsets, scatter, streamId, stream);
 }
+void CUDAAgent::copyHostCreationColumns(const std::string &state_name, const unsigned int newSize, const char *h_columns, const VarOffsetStruct &offsets, detail::CUDAScatter &scatter, const unsigned int streamId, const cudaStream_t stream) {
+    auto sm = state_map.find(state_name);
+    if (sm == state_map.end()) {
+        THROW exception::InvalidCudaAgentState("Error: Agent ('%s') state ('%s') was not found "
+            "in CUDAAgent::copyHostCreationColumns()",
+            agent_description.name.c_str(), state_name.c_str());
+    }
+    sm->second->copyHostCreationColumns(newSize, h_columns, offsets, scatter, streamId, stream);
+}
 void CUDAAgent::scatterSort_async(const std::string &state_name, detail::CUDAScatter &scatter, unsigned int streamId, cudaStream_t stream) {
     auto sm = state_map.find(state_name);
     if (sm == state_map.end()) {
@@ -575,15 +585,31 @@ void CUDAAgent::addInstantitateRTCFunction(const AgentFunctionData& func, const
     if (!function_condition) {
         const std::string t_func_impl = std::string(func.rtc_func_name).append("_impl");
         const std::vector<std::string> template_args = { t_func_impl.c_str(), func.message_in_type.c_str(), func.message_out_type.c_str() };
-        auto kernel_inst = jitify.loadKernel(func.rtc_func_name, template_args, func.rtc_source, curve_dynamic_header);
-        // add kernel instance to map
-        rtc_func_map.insert(CUDARTCFuncMap::value_type(func.name, std::move(kernel_inst)));
+        // compilation is asynchronous, the kernel instance is added to the map by finaliseRTCFunctions()
+        rtc_func_pending.emplace(func.name, jitify.loadKernelAsync(func.rtc_func_name, template_args, func.rtc_source, curve_dynamic_header));
+        rtc_kernel_sources.push_back({func.rtc_func_name, template_args, func.rtc_source, curve_dynamic_header});
     } else {
         const std::string t_func_impl = std::string(func.rtc_func_condition_name).append("_cdn_impl");
         const std::vector<std::string> template_args = { t_func_impl.c_str() };
-        auto kernel_inst = jitify.loadKernel(func.rtc_func_name + "_condition", template_args, func.rtc_condition_source, curve_dynamic_header);
-        // add kernel instance to map
-        rtc_func_map.insert(CUDARTCFuncMap::value_type(func.name + "_condition", std::move(kernel_inst)));
+        rtc_func_pending.emplace(func.name + "_condition", jitify.loadKernelAsync(func.rtc_func_name + "_condition", template_args, func.rtc_condition_source, curve_dynamic_header));
+        rtc_kernel_sources.push_back({func.rtc_func_name + "_condition", template_args, func.rtc_condition_source, curve_dynamic_header});
+    }
+}
+
+void CUDAAgent::finaliseRTCFunctions() {
+    // Wait for every kernel before rethrowing, so that compilation errors are reported in a consistent order
+    std::exception_ptr error;
+    for (auto &f : rtc_func_pending) {
+        try {
+            rtc_func_map.insert(CUDARTCFuncMap::value_type(f.first, f.second.get()));
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    rtc_func_pending.clear();
+    if (error) {
+        std::rethrow_exception(error);
     }
 }
 
@@ -183,6 +183,24 @@ void CUDAAgentStateList::scatterHostCreation(unsigned int newSize, char* const d
     // Update number of alive agents
     parent_list->setAgentCount(parent_list->getSize() + newSize);
 }
+void CUDAAgentStateList::copyHostCreationColumns(const unsigned int newSize, const char *h_columns, const VarOffsetStruct &offsets, detail::CUDAScatter &scatter, const unsigned int streamId, const cudaStream_t stream) {
+    // Resize agent list if required
+    parent_list->resize(parent_list->getSizeWithDisabled() + newSize, true, stream);
+    // Each column is contiguous on both host and device, so copy it directly
+    for (const auto &v : variables) {
+        const size_t var_size = v.second->type_size * v.second->elements;
+        const char *in_p = h_columns + offsets.vars.at(v.first).offset * newSize;
+        char *out_p = reinterpret_cast<char*>(v.second->data) + parent_list->getSize() * var_size;
+        gpuErrchk(cudaMemcpyAsync(out_p, in_p, var_size * newSize, cudaMemcpyHostToDevice, stream));
+    }
+    // Initialise any buffers in the fat_agent which aren't part of the current agent description
+    std::set<std::shared_ptr<VariableBuffer>> exclusionSet;
+    for (auto &a : variables)
+        exclusionSet.insert(a.second);
+    parent_list->initVariables(exclusionSet, newSize, parent_list->getSize(), scatter, streamId, stream);
+    // Update number of alive agents
+    parent_list->setAgentCount(parent_list->getSize() + newSize);
+}
 void CUDAAgentStateList::scatterSort_async(detail::CUDAScatter &scatter, unsigned int streamId, cudaStream_t stream) {
     parent_list->scatterSort_async(scatter, streamId, stream);
 }
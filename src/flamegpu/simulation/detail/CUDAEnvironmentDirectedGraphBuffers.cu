@@ -8,6 +8,7 @@
 #include <limits>
 
 #include "flamegpu/simulation/detail/CUDAAgent.h"
+#include "flamegpu/runtime/detail/VertexIndexMap.cuh"
 #include "flamegpu/simulation/detail/CUDAErrorChecking.cuh"
 #include "flamegpu/simulation/detail/CUDAScatter.cuh"
 #include "flamegpu/runtime/detail/curve/HostCurve.cuh"
@@ -100,7 +101,7 @@ void CUDAEnvironmentDirectedGraphBuffers::allocateVertexBuffers(const size_type
             curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_PBM_VARIABLE_NAME, d_pbm, 1);
             curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_IPBM_VARIABLE_NAME, d_ipbm, 1);
             curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME, d_ipbm, 1);  // IPBM needs to point somewhere
-            curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, d_vertex_index_map, 1);  // ID map needs to point somewhere
+            curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, d_ipbm, VertexIndexMap::HEADER_LENGTH);  // ID map needs to point somewhere, zeroed IPBM reads as an empty map
         }
     }
     for (const auto& _curve : rtc_curve_instances) {
@@ -108,8 +109,8 @@ void CUDAEnvironmentDirectedGraphBuffers::allocateVertexBuffers(const size_type
             memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_PBM_VARIABLE_NAME), &d_pbm, sizeof(void*));
             memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_IPBM_VARIABLE_NAME), &d_ipbm, sizeof(void*));
             memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME), &d_ipbm, sizeof(void*));  // IPBM needs to point somewhere
-            memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME), &d_ipbm, sizeof(void*));  // ID map needs to point somewhere
-            curve->setEnvironmentDirectedGraphVertexPropertyCount(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, 1);  // 1 because offset is packed at the end
+            memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME), &d_ipbm, sizeof(void*));  // ID map needs to point somewhere, zeroed IPBM reads as an empty map
+            curve->setEnvironmentDirectedGraphVertexPropertyCount(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, VertexIndexMap::HEADER_LENGTH);  // mask and offset are packed at the end
         }
     }
     vertex_count = count;
@@ -153,7 +154,6 @@ void CUDAEnvironmentDirectedGraphBuffers::allocateEdgeBuffers(const size_type co
     for (const auto& _curve : rtc_curve_instances) {
         if (const auto curve = _curve.lock()) {
             memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME), &d_ipbm_edges, sizeof(void*));
-            curve->setEnvironmentDirectedGraphVertexPropertyCount(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, 1);  // 1 because offset is packed at the end
         }
     }
     edge_count = count;
@@ -186,8 +186,11 @@ void CUDAEnvironmentDirectedGraphBuffers::deallocateVertexBuffers() {
         gpuErrchk(flamegpu::detail::cuda::cudaFree(d_vertex_index_map));
         d_vertex_index_map = nullptr;
     }
+    vertex_index_map_length = 0;
     vertex_count = 0;
     h_vertex_index_map.clear();
+    csr_valid = false;
+    dirty_edges.clear();
 }
 void CUDAEnvironmentDirectedGraphBuffers::deallocateEdgeBuffers() {
     for (auto& e : edge_buffers) {
@@ -221,8 +224,21 @@ void CUDAEnvironmentDirectedGraphBuffers::deallocateEdgeBuffers() {
         gpuErrchk(flamegpu::detail::cuda::cudaFree(d_ipbm_edges));
         d_ipbm_edges = nullptr;
     }
+    if (d_dirty_edges) {
+        gpuErrchk(flamegpu::detail::cuda::cudaFree(d_dirty_edges));
+        d_dirty_edges = nullptr;
+        d_dirty_edges_length = 0;
+    }
+    if (d_edge_flags) {
+        gpuErrchk(flamegpu::detail::cuda::cudaFree(d_edge_flags));
+        gpuErrchk(flamegpu::detail::cuda::cudaFree(d_edge_flags_scan));
+        d_edge_flags = nullptr;
+        d_edge_flags_scan = nullptr;
+    }
     edge_count = 0;
     h_edge_index_map.clear();
+    csr_valid = false;
+    dirty_edges.clear();
 }
 
 void CUDAEnvironmentDirectedGraphBuffers::setVertexCount(const size_type count, const cudaStream_t stream) {
@@ -263,31 +279,73 @@ void CUDAEnvironmentDirectedGraphBuffers::setEdgeCount(const size_type count) {
         }
     }
 }
+void CUDAEnvironmentDirectedGraphBuffers::reset() {
+    deallocateVertexBuffers();
+    deallocateEdgeBuffers();
+    resetVertexIDBounds();
+    requires_rebuild = false;
+    // Clear curve's references to the released buffers, as though they had never been allocated
+    const std::vector<std::string> internal_vertex_variables = { GRAPH_VERTEX_PBM_VARIABLE_NAME, GRAPH_VERTEX_IPBM_VARIABLE_NAME, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME };
+    void *const null_ptr = nullptr;
+    for (const auto& _curve : curve_instances) {
+        if (const auto curve = _curve.lock()) {
+            for (const auto& v : graph_description.vertexProperties)
+                curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, v.first, nullptr, 0);
+            for (const auto& name : internal_vertex_variables)
+                curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, name, nullptr, 0);
+            for (const auto& e : graph_description.edgeProperties)
+                curve->setEnvironmentDirectedGraphEdgeProperty(graph_description.name, e.first, nullptr, 0);
+        }
+    }
+    for (const auto& _curve : rtc_curve_instances) {
+        if (const auto curve = _curve.lock()) {
+            for (const auto& v : graph_description.vertexProperties) {
+                memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, v.first), &null_ptr, sizeof(void*));
+                curve->setEnvironmentDirectedGraphVertexPropertyCount(graph_description.name, v.first, 0);
+            }
+            for (const auto& name : internal_vertex_variables) {
+                memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, name), &null_ptr, sizeof(void*));
+                curve->setEnvironmentDirectedGraphVertexPropertyCount(graph_description.name, name, 0);
+            }
+            for (const auto& e : graph_description.edgeProperties) {
+                memcpy(curve->getEnvironmentDirectedGraphEdgePropertyCachePtr(graph_description.name, e.first), &null_ptr, sizeof(void*));
+                curve->setEnvironmentDirectedGraphEdgePropertyCount(graph_description.name, e.first, 0);
+            }
+        }
+    }
+}
 id_t* CUDAEnvironmentDirectedGraphBuffers::getVertexIDBuffer(const cudaStream_t stream) {
     size_type element_ct = 1;
     return getVertexPropertyBuffer<id_t>(ID_VARIABLE_NAME, element_ct, stream);
 }
 
-__global__ void fillKVPairs(uint32_t *keys, uint32_t *vals, const unsigned int *srcdest, unsigned int count, const unsigned int *idMap, const unsigned int id_offset) {
+/**
+ * Returns the index of the vertex with the provided ID, or VertexIndexMap::NOT_FOUND
+ * The map's mask and offset are packed at the end of the map
+ */
+__device__ __forceinline__ unsigned int lookupVertexIndex(const unsigned int *idMap, const unsigned int map_length, const id_t vertex_id) {
+    return VertexIndexMap::find([idMap](const unsigned int i) { return idMap[i]; }, map_length, idMap[map_length], idMap[map_length + 1], vertex_id);
+}
+__global__ void fillKVPairs(uint32_t *keys, uint32_t *vals, const unsigned int *srcdest, unsigned int count, const unsigned int *idMap, const unsigned int map_length) {
     unsigned int index = (blockIdx.x * blockDim.x) + threadIdx.x;
     if (index < count) {
         // To subsort by destination too, we treat the pair of uint32 as a uint64
-        keys[index * 2 + 0] = idMap[srcdest[index * 2 + 0] - id_offset];
-        keys[index * 2 + 1] = idMap[srcdest[index * 2 + 1] - id_offset];
+        keys[index * 2 + 0] = lookupVertexIndex(idMap, map_length, srcdest[index * 2 + 0]);
+        keys[index * 2 + 1] = lookupVertexIndex(idMap, map_length, srcdest[index * 2 + 1]);
         vals[index] = index;
     }
 }
-__global__ void fillKVPairs_inverted(uint32_t* keys, uint32_t* vals, const unsigned int* srcdest, unsigned int count, const unsigned int *idMap, const unsigned int id_offset) {
+__global__ void fillKVPairs_inverted(uint32_t* keys, uint32_t* vals, const unsigned int* srcdest, unsigned int count, const unsigned int *idMap, const unsigned int map_length) {
     unsigned int index = (blockIdx.x * blockDim.x) + threadIdx.x;
     if (index < count) {
         // To subsort by destination too, we treat the pair of uint32 as a uint64
         // To invert we must switch the order of the contained uint32's
-        keys[index * 2 + 0] = idMap[srcdest[index * 2 + 1] - id_offset];
-        keys[index * 2 + 1] = idMap[srcdest[index * 2 + 0] - id_offset];
+        keys[index * 2 + 0] = lookupVertexIndex(idMap, map_length, srcdest[index * 2 + 1]);
+        keys[index * 2 + 1] = lookupVertexIndex(idMap, map_length, srcdest[index * 2 + 0]);
         vals[index] = index;
     }
 }
-__global__ void findBinStart(unsigned int *pbm, uint64_t* keys, unsigned int edge_count, unsigned int vertex_count) {
+__global__ void findBinStart(unsigned int *pbm, const uint64_t* keys, unsigned int edge_count, unsigned int vertex_count) {
     unsigned int index = (blockIdx.x * blockDim.x) + threadIdx.x;
     if (index < edge_count) {
         // Bins correspond to the first uint32 of the pair
@@ -351,44 +409,151 @@ __global__ void buildIDMap(const id_t *IDsIn, unsigned int *indexOut, const unsi
         }
     }
 }
-__global__ void validateSrcDest(id_t *edgeSrcDest, unsigned int *idMap, const unsigned int edge_count, unsigned int *errors, unsigned int vertex_id_min, unsigned int vertex_id_max) {
+__global__ void buildIDHashMap(const id_t *IDsIn, unsigned int *mapOut, const unsigned int count, unsigned int *error_count, const unsigned int mask) {
+    const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
+    if (thread_index < count) {
+        id_t my_thread_id = IDsIn[thread_index];
+        // Skip IDs that weren't set
+        if (my_thread_id == ID_NOT_SET) {
+            atomicInc(error_count + 2, UINT_MAX);
+            return;
+        }
+        // Linear probe for an empty slot, ID_NOT_SET marks an empty slot
+        unsigned int slot = VertexIndexMap::hash(my_thread_id, mask);
+        for (unsigned int i = 0; i <= mask; ++i) {
+            const unsigned int rtn = atomicCAS(mapOut + slot * 2, ID_NOT_SET, my_thread_id);
+            if (rtn == ID_NOT_SET) {
+                mapOut[slot * 2 + 1] = thread_index;
+                return;
+            } else if (rtn == my_thread_id) {
+                // Report ID collision
+                atomicInc(error_count + 0, UINT_MAX);
+                return;
+            }
+            slot = (slot + 1) & mask;
+        }
+        // Report full hash table (this should not happen, it's an internal error if it does)
+        atomicInc(error_count + 3, UINT_MAX);
+    }
+}
+__global__ void validateSrcDest(id_t *edgeSrcDest, unsigned int *idMap, const unsigned int map_length, const unsigned int edge_count, unsigned int *errors) {
     const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
     if (thread_index < edge_count) {
         const id_t my_src_id = edgeSrcDest[thread_index * 2 + 1];
         const id_t my_dest_id = edgeSrcDest[thread_index * 2 + 0];
         if (my_src_id == ID_NOT_SET) {
             atomicInc(errors + 0, UINT_MAX);
-        } else if (vertex_id_min <= my_src_id && my_src_id <= vertex_id_max) {
-            if (idMap[my_src_id - vertex_id_min] == 0xffffffff) {
-                atomicInc(errors + 2, UINT_MAX);
-            }
-        } else {
+        } else if (lookupVertexIndex(idMap, map_length, my_src_id) == VertexIndexMap::NOT_FOUND) {
             atomicInc(errors + 2, UINT_MAX);
         }
         if (my_dest_id == ID_NOT_SET) {
             atomicInc(errors + 1, UINT_MAX);
-        } else if (vertex_id_min <= my_dest_id && my_dest_id <= vertex_id_max) {
-            if (idMap[my_dest_id - vertex_id_min] == 0xffffffff) {
-                atomicInc(errors + 3, UINT_MAX);
-            }
-        } else {
+        } else if (lookupVertexIndex(idMap, map_length, my_dest_id) == VertexIndexMap::NOT_FOUND) {
             atomicInc(errors + 3, UINT_MAX);
         }
     }
 }
-__global__ void translateSrcDest(id_t *edgeSrcDest, unsigned int *idMap, const unsigned int edge_count, unsigned int *errors, unsigned int vertex_id_min, unsigned int vertex_id_max) {
+__global__ void translateSrcDest(id_t *edgeSrcDest, unsigned int *idMap, const unsigned int map_length, const unsigned int edge_count) {
     const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
     if (thread_index < edge_count) {
         const id_t my_src_id = edgeSrcDest[thread_index * 2 + 1];
         const id_t my_dest_id = edgeSrcDest[thread_index * 2 + 0];
-        const unsigned int src_id = idMap[my_src_id - vertex_id_min];
-        const unsigned int dest_id = idMap[my_dest_id - vertex_id_min];
-        edgeSrcDest[thread_index * 2 + 1] = src_id;
-        edgeSrcDest[thread_index * 2 + 0] = dest_id;
+        edgeSrcDest[thread_index * 2 + 1] = lookupVertexIndex(idMap, map_length, my_src_id);
+        edgeSrcDest[thread_index * 2 + 0] = lookupVertexIndex(idMap, map_length, my_dest_id);
     }
 }
+/**
+ * Returns the number of elements of the sorted array data which are less than value
+ */
+__device__ __forceinline__ unsigned int lowerBound(const uint64_t *data, const unsigned int count, const uint64_t value) {
+    unsigned int lo = 0, hi = count;
+    while (lo < hi) {
+        const unsigned int mid = lo + (hi - lo) / 2;
+        if (data[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+/**
+ * Returns the number of elements of the sorted array data which are less than or equal to value
+ */
+__device__ __forceinline__ unsigned int upperBound(const uint64_t *data, const unsigned int count, const uint64_t value) {
+    unsigned int lo = 0, hi = count;
+    while (lo < hi) {
+        const unsigned int mid = lo + (hi - lo) / 2;
+        if (data[mid] <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+__global__ void flagEdges(unsigned int *flags, const unsigned int *edge_indices, const unsigned int count) {
+    const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
+    if (thread_index < count) {
+        flags[edge_indices[thread_index]] = 1;
+    }
+}
+__global__ void flagEdgesInverted(unsigned int *flags_out, const unsigned int *edge_flags, const unsigned int *ipbm_edges, const unsigned int edge_count) {
+    const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
+    if (thread_index < edge_count) {
+        flags_out[thread_index] = edge_flags[ipbm_edges[thread_index]];
+    }
+}
+__global__ void invertPermutation(unsigned int *inverse, const unsigned int *permutation, const unsigned int count) {
+    const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
+    if (thread_index < count) {
+        inverse[permutation[thread_index]] = thread_index;
+    }
+}
+/**
+ * Moves the edges of a previous sort which are not stale to their position within the merged sort
+ * An edge is stale if stale_scan[i + 1] != stale_scan[i], stale_scan being the exclusive scan of the stale flags
+ * If old_vals is nullptr, an edge's value is its index. If remap is not nullptr, values are passed through remap.
+ */
+__global__ void mergeSortedClean(const uint64_t *old_keys, const unsigned int *old_vals, const unsigned int *stale_scan, const unsigned int count,
+    const uint64_t *new_keys, const unsigned int new_count, const unsigned int *remap, uint64_t *out_keys, unsigned int *out_vals) {
+    const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
+    if (thread_index < count && stale_scan[thread_index + 1] == stale_scan[thread_index]) {
+        const uint64_t key = old_keys[thread_index];
+        const unsigned int val = old_vals ? old_vals[thread_index] : thread_index;
+        const unsigned int pos = thread_index - stale_scan[thread_index] + lowerBound(new_keys, new_count, key);
+        out_keys[pos] = key;
+        out_vals[pos] = remap ? remap[val] : val;
+    }
+}
+/**
+ * Moves the sorted new edges to their position within the merged sort
+ * The stale edges of the previous sort are ignored when counting the edges which precede each new edge
+ * New edges are placed after any previous edges with an equal key, so that both kernels agree on the position of ties
+ */
+__global__ void mergeSortedDirty(const uint64_t *new_keys, const unsigned int *new_vals, const unsigned int new_count,
+    const uint64_t *old_keys, const unsigned int *stale_scan, const unsigned int count, const unsigned int *remap, uint64_t *out_keys, unsigned int *out_vals) {
+    const unsigned int thread_index = blockIdx.x * blockDim.x + threadIdx.x;
+    if (thread_index < new_count) {
+        const uint64_t key = new_keys[thread_index];
+        const unsigned int val = new_vals[thread_index];
+        const unsigned int preceding = upperBound(old_keys, count, key);
+        const unsigned int pos = thread_index + preceding - stale_scan[preceding];
+        out_keys[pos] = key;
+        out_vals[pos] = remap ? remap[val] : val;
+    }
+}
+/**
+ * If more than 1/INCREMENTAL_REBUILD_RATIO edges have changed since the last rebuild, a full rebuild is performed instead
+ * The incremental merge performs a binary search per edge, so its advantage over a full radix sort diminishes as more edges change
+ */
+constexpr unsigned int INCREMENTAL_REBUILD_RATIO = 8;
+
 void CUDAEnvironmentDirectedGraphBuffers::syncDevice_async(detail::CUDAScatter& scatter, const unsigned int streamID, const cudaStream_t stream) {
     bool has_changed = false;
+    // If only source/dest of a handful of edges have changed, the previous CSR/CSC can be updated in place
+    // The device source/dest buffer holds vertex indices from the previous rebuild, so it must not be overwritten by the host's IDs
+    const bool incremental = requires_rebuild && csr_valid && vertex_count && edge_count && !dirty_edges.empty();
     // Copy variable buffers to device
     if (vertex_count) {
         for (auto& v : graph_description.vertexProperties) {
@@ -403,7 +568,7 @@ void CUDAEnvironmentDirectedGraphBuffers::syncDevice_async(detail::CUDAScatter&
     if (edge_count) {
         for (auto& e : graph_description.edgeProperties) {
             auto& eb = edge_buffers.at(e.first);
-            if (eb.ready == Buffer::Host) {
+            if (eb.ready == Buffer::Host && !(incremental && e.first == GRAPH_SOURCE_DEST_VARIABLE_NAME)) {
                 gpuErrchk(cudaMemcpyAsync(eb.d_ptr, eb.h_ptr, edge_count * e.second.type_size * e.second.elements, cudaMemcpyHostToDevice, stream));
                 eb.ready = Buffer::Both;
                 has_changed = true;
@@ -416,175 +581,14 @@ void CUDAEnvironmentDirectedGraphBuffers::syncDevice_async(detail::CUDAScatter&
         } else if (vertex_count != h_vertex_index_map.size()) {
             THROW exception::IDNotSet("Unable to build graph, only %u/%u vertices have been assigned an ID, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", vertex_count, static_cast<unsigned int>(h_vertex_index_map.size()));
         }
-        // Construct the vertex ID : index map
-        {
-            if (vertex_id_min == std::numeric_limits<unsigned int>::max() || vertex_id_max == std::numeric_limits<unsigned int>::min()) {
-                THROW flamegpu::exception::IDOutOfBounds("No IDs have been set, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()");
-            }
-            const unsigned int ID_RANGE = 1 + vertex_id_max - vertex_id_min;
-            if (d_vertex_index_map) {
-                gpuErrchk(flamegpu::detail::cuda::cudaFree(d_vertex_index_map));
-            }
-            if (cudaMalloc(&d_vertex_index_map, sizeof(unsigned int) * (ID_RANGE + 1)) != cudaSuccess) {
-                THROW flamegpu::exception::OutOfMemory("Out of memory when allocating ID->index map, Vertex IDs cover too wide a range (%u) consider contiguous IDs, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", ID_RANGE);
-            }
-            // Copy the offset to the end of the map
-            gpuErrchk(cudaMemcpyAsync(d_vertex_index_map + ID_RANGE, &vertex_id_min, sizeof(unsigned int), cudaMemcpyHostToDevice, stream));
-            // Add the ID->index map var to curve
-            for (const auto& _curve : curve_instances) {
-                if (const auto curve = _curve.lock())
-                    curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, d_vertex_index_map, ID_RANGE + 1);  // +1 because offset is packed at the end
-            }
-            for (const auto& _curve : rtc_curve_instances) {
-                if (const auto curve = _curve.lock()) {
-                    memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME), &d_vertex_index_map, sizeof(void*));
-                    curve->setEnvironmentDirectedGraphVertexPropertyCount(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, ID_RANGE + 1);  // +1 because offset is packed at the end
-                }
-            }
-            {  // Build the map
-                const auto& v_id_b = vertex_buffers.at(ID_VARIABLE_NAME);
-                gpuErrchk(cudaMemsetAsync(d_vertex_index_map, 0xffffffff, ID_RANGE * sizeof(unsigned int), stream));
-                gpuErrchk(cudaMemsetAsync(d_pbm_swap, 0, 3 * sizeof(unsigned int), stream));  // We will use spare pbm_swap to count errors, save allocating more memory
-                const unsigned int BLOCK_SZ = 512;
-                const unsigned int BLOCK_CT = static_cast<unsigned int>(ceil(vertex_count / static_cast<float>(BLOCK_SZ)));
-                buildIDMap << <BLOCK_CT, BLOCK_SZ, 0, stream >> > (static_cast<id_t*>(v_id_b.d_ptr), d_vertex_index_map, vertex_count, d_pbm_swap, vertex_id_min, vertex_id_max);
-                gpuErrchkLaunch();
-                unsigned int err_collision_range[3];
-                gpuErrchk(cudaMemcpyAsync(err_collision_range, d_pbm_swap, 3 * sizeof(unsigned int), cudaMemcpyDeviceToHost, stream));
-                gpuErrchk(cudaStreamSynchronize(stream));
-                if (err_collision_range[2] > 0) {
-                    THROW flamegpu::exception::IDNotSet("Graph contains %u vertices which have not had their ID set, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[2]);
-                } else if (err_collision_range[0] > 0) {
-                    THROW flamegpu::exception::IDCollision("Graph contains invalid vertex IDs, %u vertices reported ID collisions, vertex IDs must be unique or unset, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[0]);
-                } else if (err_collision_range[1] > 0) {
-                    THROW flamegpu::exception::UnknownInternalError("Graph contains invalid vertex IDs, %u vertices reported an ID that does not satisfy %u < ID < %u, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[1], vertex_id_min, vertex_id_max);
-                }
-            }
-            {  // Validate that edge source/dest pairs correspond to valid IDs
-                const auto& e_srcdest_b = edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME);
-                gpuErrchk(cudaMemsetAsync(d_pbm_swap, 0, 4 * sizeof(unsigned int), stream));  // We will use spare pbm_swap to count errors, save allocating more memory
-                const unsigned int BLOCK_SZ = 512;
-                const unsigned int BLOCK_CT = static_cast<unsigned int>(ceil(edge_count / static_cast<float>(BLOCK_SZ)));
-                validateSrcDest << <BLOCK_CT, BLOCK_SZ, 0, stream >> > (static_cast<id_t*>(e_srcdest_b.d_ptr), d_vertex_index_map, edge_count, d_pbm_swap, vertex_id_min, vertex_id_max);
-                gpuErrchkLaunch();
-                unsigned int err_collision_range[4];  // {src_notset, dest_notset, src_invalid, dest_invalid}
-                gpuErrchk(cudaMemcpyAsync(err_collision_range, d_pbm_swap, 4 * sizeof(unsigned int), cudaMemcpyDeviceToHost, stream));
-                gpuErrchk(cudaStreamSynchronize(stream));
-                if (err_collision_range[0] > 0 || err_collision_range[1] > 0) {
-                    THROW flamegpu::exception::IDNotSet("Graph contains %u and %u edges which have not had their source and destinations set respectively, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[0], err_collision_range[1]);
-                } else if (err_collision_range[2] > 0 || err_collision_range[3] > 0) {
-                    THROW flamegpu::exception::InvalidID("Graph contains %u and %u edges which have invalid source and destinations set respectively, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[2], err_collision_range[3]);
-                }
-            }
-        }
-        // Rebuild the CSR/VBM (edgesLeaving())
-        {
-            // Fill Key/Val Pairs
-            int blockSize;  // The launch configurator returned block size
-            gpuErrchk(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blockSize, fillKVPairs, 32, 0));  // Randomly 32
-            int gridSize = (edge_count + blockSize - 1) / blockSize;  // Round up according to array size
-            fillKVPairs << <gridSize, blockSize, 0, stream >> > (reinterpret_cast<uint32_t*>(d_keys), d_vals, static_cast<unsigned int*>(edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME).d_ptr), edge_count, d_vertex_index_map, vertex_id_min);
-            gpuErrchkLaunch();
-            // Sort Key/Val Pairs according to src->dest
-            auto& cub_temp = scatter.CubTemp(streamID);
-            size_t temp_req = 0;
-            gpuErrchk(cub::DeviceRadixSort::SortPairs(nullptr, temp_req, d_keys, d_keys_swap, d_vals, d_vals_swap, edge_count, 0, sizeof(uint64_t) * 8, stream));
-            cub_temp.resize(temp_req);
-            gpuErrchk(cub::DeviceRadixSort::SortPairs(cub_temp.getPtr(), cub_temp.getSize(), d_keys, d_keys_swap, d_vals, d_vals_swap, edge_count, 0, sizeof(uint64_t) * 8, stream));
-            // Build PBM (For vertices with edges)
-            gpuErrchk(cudaMemset(d_pbm, 0xffffffff, (vertex_count + 1) * sizeof(unsigned int)));
-            gpuErrchk(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blockSize, findBinStart, 32, 0));  // Randomly 32
-            gridSize = (edge_count + blockSize - 1) / blockSize;  // Round up according to array size
-            findBinStart << <gridSize, blockSize, 0, stream >> > (d_pbm, d_keys_swap, edge_count, vertex_count);
-            gpuErrchkLaunch();
-            // Build PBM (Fill vertices with no edges)
-            temp_req = 0;
-            gpuErrchk(cub::DeviceScan::InclusiveScan(nullptr, temp_req, ReverseIterator(d_pbm + vertex_count), ReverseIterator(d_pbm_swap + vertex_count), CustomMin(), vertex_count + 1, stream));
-            cub_temp.resize(temp_req);
-            gpuErrchk(cub::DeviceScan::InclusiveScan(cub_temp.getPtr(), cub_temp.getSize(), ReverseIterator(d_pbm + vertex_count), ReverseIterator(d_pbm_swap + vertex_count), CustomMin(), vertex_count + 1, stream));
-            // Sort edge variables
-            std::vector<detail::CUDAScatter::ScatterData> sd;
-            for (auto& edge : edge_buffers) {
-                edge.second.swap();
-                sd.push_back(detail::CUDAScatter::ScatterData{edge.second.element_size, reinterpret_cast<char*>(edge.second.d_ptr_swap), reinterpret_cast<char*>(edge.second.d_ptr)});
-            }
-            scatter.scatterPosition_async(streamID, stream, d_vals_swap, sd, edge_count);
-            // Swap all the swap pointers, so the junk data is in swap
-            std::swap(d_keys, d_keys_swap);
-            std::swap(d_vals, d_vals_swap);
-            std::swap(d_pbm, d_pbm_swap);
-            // Update which buffers curve points to
-            for (auto& e : graph_description.edgeProperties) {
-                auto& eb = edge_buffers.at(e.first);
-                for (const auto& _curve : curve_instances) {
-                    if (const auto curve = _curve.lock())
-                        curve->setEnvironmentDirectedGraphEdgeProperty(graph_description.name, e.first, eb.d_ptr, edge_count);
-                }
-                for (const auto& _curve : rtc_curve_instances) {
-                    if (const auto curve = _curve.lock())
-                        memcpy(curve->getEnvironmentDirectedGraphEdgePropertyCachePtr(graph_description.name, e.first), &eb.d_ptr, sizeof(void*));
-                }
-                eb.ready = Buffer::Device;
-            }
-            for (const auto& _curve : curve_instances) {
-                if (const auto curve = _curve.lock())
-                    curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_PBM_VARIABLE_NAME, d_pbm, 1);
-            }
-            for (const auto& _curve : rtc_curve_instances) {
-                if (const auto curve = _curve.lock())
-                    memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_PBM_VARIABLE_NAME), &d_pbm, sizeof(void*));
-            }
-        }
-        {  // Rebuild the CSC/Inverted VBM (edgesJoining())
-            int blockSize;  // The launch configurator returned block size
-            gpuErrchk(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blockSize, fillKVPairs, 32, 0));  // Randomly 32
-            int gridSize = (edge_count + blockSize - 1) / blockSize;  // Round up according to array size
-            fillKVPairs_inverted << <gridSize, blockSize, 0, stream >> > (reinterpret_cast<uint32_t*>(d_keys), d_vals, static_cast<unsigned int*>(edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME).d_ptr), edge_count, d_vertex_index_map, vertex_id_min);
-            gpuErrchkLaunch();
-            // Sort Key/Val Pairs according to dest->src
-            // Cub temp has already been resized above
-            auto& cub_temp = scatter.CubTemp(streamID);
-            gpuErrchk(cub::DeviceRadixSort::SortPairs(cub_temp.getPtr(), cub_temp.getSize(), d_keys, d_keys_swap, d_vals, d_vals_swap, edge_count, 0, sizeof(uint64_t) * 8, stream));
-            // Build inverted PBM (For vertices with edges)
-            gpuErrchk(cudaMemset(d_ipbm, 0xffffffff, (vertex_count + 1) * sizeof(unsigned int)));
-            gpuErrchk(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blockSize, findBinStart, 32, 0));  // Randomly 32
-            gridSize = (edge_count + blockSize - 1) / blockSize;  // Round up according to array size
-            findBinStart << <gridSize, blockSize, 0, stream >> > (d_ipbm, d_keys_swap, edge_count, vertex_count);
-            gpuErrchkLaunch();
-            // Build inverted PBM (Fill vertices with no edges)
-            gpuErrchk(cub::DeviceScan::InclusiveScan(cub_temp.getPtr(), cub_temp.getSize(), ReverseIterator(d_ipbm + vertex_count), ReverseIterator(d_pbm_swap + vertex_count), CustomMin(), vertex_count + 1, stream));
-            // Swap all the swap pointers, so the junk data is in swap
-            std::swap(d_keys, d_keys_swap);
-            std::swap(d_ipbm_edges, d_vals_swap);
-            std::swap(d_ipbm, d_pbm_swap);
-            // Update which buffers curve points to
-            for (const auto& _curve : curve_instances) {
-                if (const auto curve = _curve.lock()) {
-                    curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_IPBM_VARIABLE_NAME, d_ipbm, 1);
-                    curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME, d_ipbm_edges, 1);
-                }
-            }
-            for (const auto& _curve : rtc_curve_instances) {
-                if (const auto curve = _curve.lock()) {
-                    memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_IPBM_VARIABLE_NAME), &d_ipbm, sizeof(void*));
-                    memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME), &d_ipbm_edges, sizeof(void*));
-                }
-            }
-        }
-        {  // Translate edge source/dest pairs and validate that they correspond to valid IDs
-            const auto& e_srcdest_b = edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME);
-            e_srcdest_b.updateHostBuffer(edge_count, stream);  // Copy back to host, before we translate device IDs
-            const unsigned int BLOCK_SZ = 512;
-            const unsigned int BLOCK_CT = static_cast<unsigned int>(ceil(edge_count / static_cast<float>(BLOCK_SZ)));
-            translateSrcDest << <BLOCK_CT, BLOCK_SZ, 0, stream >> > (static_cast<id_t*>(e_srcdest_b.d_ptr), d_vertex_index_map, edge_count, d_pbm_swap, vertex_id_min, vertex_id_max);
-            gpuErrchkLaunch()
-            // Rebuild the edge index map
-            h_edge_index_map.clear();
-            for (unsigned int i = 0; i < edge_count; ++i) {
-                h_edge_index_map.emplace(std::pair{static_cast<id_t*>(e_srcdest_b.h_ptr)[i * 2 + 1], static_cast<id_t*>(e_srcdest_b.h_ptr)[i * 2 + 0]}, i);
-            }
+        if (incremental) {
+            rebuildIncremental(scatter, streamID, stream);
+        } else {
+            rebuildFull(scatter, streamID, stream);
         }
         requires_rebuild = false;
+        csr_valid = true;
+        dirty_edges.clear();
         has_changed = true;
     }
     if (has_changed) {
@@ -600,6 +604,347 @@ void CUDAEnvironmentDirectedGraphBuffers::syncDevice_async(detail::CUDAScatter&
 #endif
     }
 }
+void CUDAEnvironmentDirectedGraphBuffers::buildVertexIndexMap(const cudaStream_t stream) {
+    if (vertex_id_min == std::numeric_limits<unsigned int>::max() || vertex_id_max == std::numeric_limits<unsigned int>::min()) {
+        THROW flamegpu::exception::IDOutOfBounds("No IDs have been set, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()");
+    }
+    // A direct lookup table is sized to the ID range, a hash table to the vertex count (with load factor <= 0.5)
+    // Use whichever is smaller
+    const uint64_t ID_RANGE = 1ull + vertex_id_max - vertex_id_min;
+    unsigned int hash_capacity = 2;
+    while (hash_capacity < 2 * vertex_count) {
+        hash_capacity <<= 1;
+    }
+    const bool use_hash = ID_RANGE > 2ull * hash_capacity;
+    const unsigned int map_length = use_hash ? 2 * hash_capacity : static_cast<unsigned int>(ID_RANGE);
+    const unsigned int map_header[VertexIndexMap::HEADER_LENGTH] = {use_hash ? hash_capacity - 1 : 0, vertex_id_min};
+    // The map is only reallocated if its length has changed
+    if (!d_vertex_index_map || map_length != vertex_index_map_length) {
+        if (d_vertex_index_map) {
+            gpuErrchk(flamegpu::detail::cuda::cudaFree(d_vertex_index_map));
+            d_vertex_index_map = nullptr;
+        }
+        if (cudaMalloc(&d_vertex_index_map, sizeof(unsigned int) * (map_length + VertexIndexMap::HEADER_LENGTH)) != cudaSuccess) {
+            d_vertex_index_map = nullptr;
+            vertex_index_map_length = 0;
+            THROW flamegpu::exception::OutOfMemory("Out of memory when allocating ID->index map, Vertex IDs cover too wide a range (%u) consider contiguous IDs, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", map_length);
+        }
+        vertex_index_map_length = map_length;
+    }
+    // Copy the mask and offset to the end of the map
+    gpuErrchk(cudaMemcpyAsync(d_vertex_index_map + map_length, map_header, sizeof(map_header), cudaMemcpyHostToDevice, stream));
+    // Add the ID->index map var to curve
+    for (const auto& _curve : curve_instances) {
+        if (const auto curve = _curve.lock())
+            curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, d_vertex_index_map, map_length + VertexIndexMap::HEADER_LENGTH);  // mask and offset are packed at the end
+    }
+    for (const auto& _curve : rtc_curve_instances) {
+        if (const auto curve = _curve.lock()) {
+            memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME), &d_vertex_index_map, sizeof(void*));
+            curve->setEnvironmentDirectedGraphVertexPropertyCount(graph_description.name, GRAPH_VERTEX_INDEX_MAP_VARIABLE_NAME, map_length + VertexIndexMap::HEADER_LENGTH);  // mask and offset are packed at the end
+        }
+    }
+    {  // Build the map
+        const auto& v_id_b = vertex_buffers.at(ID_VARIABLE_NAME);
+        gpuErrchk(cudaMemsetAsync(d_vertex_index_map, use_hash ? 0 : 0xffffffff, map_length * sizeof(unsigned int), stream));
+        gpuErrchk(cudaMemsetAsync(d_pbm_swap, 0, 4 * sizeof(unsigned int), stream));  // We will use spare pbm_swap to count errors, save allocating more memory
+        const unsigned int BLOCK_SZ = 512;
+        const unsigned int BLOCK_CT = static_cast<unsigned int>(ceil(vertex_count / static_cast<float>(BLOCK_SZ)));
+        if (use_hash) {
+            buildIDHashMap << <BLOCK_CT, BLOCK_SZ, 0, stream >> > (static_cast<id_t*>(v_id_b.d_ptr), d_vertex_index_map, vertex_count, d_pbm_swap, hash_capacity - 1);
+        } else {
+            buildIDMap << <BLOCK_CT, BLOCK_SZ, 0, stream >> > (static_cast<id_t*>(v_id_b.d_ptr), d_vertex_index_map, vertex_count, d_pbm_swap, vertex_id_min, vertex_id_max);
+        }
+        gpuErrchkLaunch();
+        unsigned int err_collision_range[4];
+        gpuErrchk(cudaMemcpyAsync(err_collision_range, d_pbm_swap, 4 * sizeof(unsigned int), cudaMemcpyDeviceToHost, stream));
+        gpuErrchk(cudaStreamSynchronize(stream));
+        if (err_collision_range[2] > 0) {
+            THROW flamegpu::exception::IDNotSet("Graph contains %u vertices which have not had their ID set, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[2]);
+        } else if (err_collision_range[0] > 0) {
+            THROW flamegpu::exception::IDCollision("Graph contains invalid vertex IDs, %u vertices reported ID collisions, vertex IDs must be unique or unset, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[0]);
+        } else if (err_collision_range[1] > 0) {
+            THROW flamegpu::exception::UnknownInternalError("Graph contains invalid vertex IDs, %u vertices reported an ID that does not satisfy %u < ID < %u, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[1], vertex_id_min, vertex_id_max);
+        } else if (err_collision_range[3] > 0) {
+            THROW flamegpu::exception::UnknownInternalError("Vertex ID hash table of capacity %u is full, %u vertices could not be inserted, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", hash_capacity, err_collision_range[3]);
+        }
+    }
+}
+void CUDAEnvironmentDirectedGraphBuffers::buildPBM(unsigned int *&d_pbm_target, const uint64_t *d_sorted_keys, detail::CUDAScatter& scatter, const unsigned int streamID, const cudaStream_t stream) {
+    // Build PBM (For vertices with edges)
+    gpuErrchk(cudaMemsetAsync(d_pbm_target, 0xffffffff, (vertex_count + 1) * sizeof(unsigned int), stream));
+    int blockSize;  // The launch configurator returned block size
+    gpuErrchk(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blockSize, findBinStart, 32, 0));  // Randomly 32
+    int gridSize = (edge_count + blockSize - 1) / blockSize;  // Round up according to array size
+    findBinStart << <gridSize, blockSize, 0, stream >> > (d_pbm_target, d_sorted_keys, edge_count, vertex_count);
+    gpuErrchkLaunch();
+    // Build PBM (Fill vertices with no edges)
+    auto& cub_temp = scatter.CubTemp(streamID);
+    size_t temp_req = 0;
+    gpuErrchk(cub::DeviceScan::InclusiveScan(nullptr, temp_req, ReverseIterator(d_pbm_target + vertex_count), ReverseIterator(d_pbm_swap + vertex_count), CustomMin(), vertex_count + 1, stream));
+    cub_temp.resize(temp_req);
+    gpuErrchk(cub::DeviceScan::InclusiveScan(cub_temp.getPtr(), cub_temp.getSize(), ReverseIterator(d_pbm_target + vertex_count), ReverseIterator(d_pbm_swap + vertex_count), CustomMin(), vertex_count + 1, stream));
+    // Swap the pointers, so the junk data is in swap
+    std::swap(d_pbm_target, d_pbm_swap);
+}
+void CUDAEnvironmentDirectedGraphBuffers::updateCurveEdgeBuffers() {
+    for (auto& e : graph_description.edgeProperties) {
+        auto& eb = edge_buffers.at(e.first);
+        for (const auto& _curve : curve_instances) {
+            if (const auto curve = _curve.lock())
+                curve->setEnvironmentDirectedGraphEdgeProperty(graph_description.name, e.first, eb.d_ptr, edge_count);
+        }
+        for (const auto& _curve : rtc_curve_instances) {
+            if (const auto curve = _curve.lock())
+                memcpy(curve->getEnvironmentDirectedGraphEdgePropertyCachePtr(graph_description.name, e.first), &eb.d_ptr, sizeof(void*));
+        }
+    }
+    for (const auto& _curve : curve_instances) {
+        if (const auto curve = _curve.lock()) {
+            curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_PBM_VARIABLE_NAME, d_pbm, 1);
+            curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_IPBM_VARIABLE_NAME, d_ipbm, 1);
+            curve->setEnvironmentDirectedGraphVertexProperty(graph_description.name, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME, d_ipbm_edges, 1);
+        }
+    }
+    for (const auto& _curve : rtc_curve_instances) {
+        if (const auto curve = _curve.lock()) {
+            memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_PBM_VARIABLE_NAME), &d_pbm, sizeof(void*));
+            memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_IPBM_VARIABLE_NAME), &d_ipbm, sizeof(void*));
+            memcpy(curve->getEnvironmentDirectedGraphVertexPropertyCachePtr(graph_description.name, GRAPH_VERTEX_IPBM_EDGES_VARIABLE_NAME), &d_ipbm_edges, sizeof(void*));
+        }
+    }
+}
+void CUDAEnvironmentDirectedGraphBuffers::rebuildFull(detail::CUDAScatter& scatter, const unsigned int streamID, const cudaStream_t stream) {
+    // Construct the vertex ID : index map
+    buildVertexIndexMap(stream);
+    {  // Validate that edge source/dest pairs correspond to valid IDs
+        const auto& e_srcdest_b = edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME);
+        gpuErrchk(cudaMemsetAsync(d_pbm_swap, 0, 4 * sizeof(unsigned int), stream));  // We will use spare pbm_swap to count errors, save allocating more memory
+        const unsigned int BLOCK_SZ = 512;
+        const unsigned int BLOCK_CT = static_cast<unsigned int>(ceil(edge_count / static_cast<float>(BLOCK_SZ)));
+        validateSrcDest << <BLOCK_CT, BLOCK_SZ, 0, stream >> > (static_cast<id_t*>(e_srcdest_b.d_ptr), d_vertex_index_map, vertex_index_map_length, edge_count, d_pbm_swap);
+        gpuErrchkLaunch();
+        unsigned int err_collision_range[4];  // {src_notset, dest_notset, src_invalid, dest_invalid}
+        gpuErrchk(cudaMemcpyAsync(err_collision_range, d_pbm_swap, 4 * sizeof(unsigned int), cudaMemcpyDeviceToHost, stream));
+        gpuErrchk(cudaStreamSynchronize(stream));
+        if (err_collision_range[0] > 0 || err_collision_range[1] > 0) {
+            THROW flamegpu::exception::IDNotSet("Graph contains %u and %u edges which have not had their source and destinations set respectively, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[0], err_collision_range[1]);
+        } else if (err_collision_range[2] > 0 || err_collision_range[3] > 0) {
+            THROW flamegpu::exception::InvalidID("Graph contains %u and %u edges which have invalid source and destinations set respectively, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[2], err_collision_range[3]);
+        }
+    }
+    // Rebuild the CSR/VBM (edgesLeaving())
+    {
+        // Fill Key/Val Pairs
+        int blockSize;  // The launch configurator returned block size
+        gpuErrchk(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blockSize, fillKVPairs, 32, 0));  // Randomly 32
+        int gridSize = (edge_count + blockSize - 1) / blockSize;  // Round up according to array size
+        fillKVPairs << <gridSize, blockSize, 0, stream >> > (reinterpret_cast<uint32_t*>(d_keys), d_vals, static_cast<unsigned int*>(edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME).d_ptr), edge_count, d_vertex_index_map, vertex_index_map_length);
+        gpuErrchkLaunch();
+        // Sort Key/Val Pairs according to src->dest
+        auto& cub_temp = scatter.CubTemp(streamID);
+        size_t temp_req = 0;
+        gpuErrchk(cub::DeviceRadixSort::SortPairs(nullptr, temp_req, d_keys, d_keys_swap, d_vals, d_vals_swap, edge_count, 0, sizeof(uint64_t) * 8, stream));
+        cub_temp.resize(temp_req);
+        gpuErrchk(cub::DeviceRadixSort::SortPairs(cub_temp.getPtr(), cub_temp.getSize(), d_keys, d_keys_swap, d_vals, d_vals_swap, edge_count, 0, sizeof(uint64_t) * 8, stream));
+        // Build PBM
+        buildPBM(d_pbm, d_keys_swap, scatter, streamID, stream);
+        // Sort edge variables
+        std::vector<detail::CUDAScatter::ScatterData> sd;
+        for (auto& edge : edge_buffers) {
+            edge.second.swap();
+            sd.push_back(detail::CUDAScatter::ScatterData{edge.second.element_size, reinterpret_cast<char*>(edge.second.d_ptr_swap), reinterpret_cast<char*>(edge.second.d_ptr)});
+        }
+        scatter.scatterPosition_async(streamID, stream, d_vals_swap, sd, edge_count);
+        // Swap all the swap pointers, so the junk data is in swap
+        std::swap(d_keys, d_keys_swap);
+        std::swap(d_vals, d_vals_swap);
+        for (auto& edge : edge_buffers) {
+            edge.second.ready = Buffer::Device;
+        }
+    }
+    {  // Rebuild the CSC/Inverted VBM (edgesJoining())
+        int blockSize;  // The launch configurator returned block size
+        gpuErrchk(cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blockSize, fillKVPairs, 32, 0));  // Randomly 32
+        int gridSize = (edge_count + blockSize - 1) / blockSize;  // Round up according to array size
+        fillKVPairs_inverted << <gridSize, blockSize, 0, stream >> > (reinterpret_cast<uint32_t*>(d_keys), d_vals, static_cast<unsigned int*>(edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME).d_ptr), edge_count, d_vertex_index_map, vertex_index_map_length);
+        gpuErrchkLaunch();
+        // Sort Key/Val Pairs according to dest->src
+        // Cub temp has already been resized above
+        auto& cub_temp = scatter.CubTemp(streamID);
+        size_t temp_req = 0;
+        gpuErrchk(cub::DeviceRadixSort::SortPairs(nullptr, temp_req, d_keys, d_keys_swap, d_vals, d_vals_swap, edge_count, 0, sizeof(uint64_t) * 8, stream));
+        cub_temp.resize(temp_req);
+        gpuErrchk(cub::DeviceRadixSort::SortPairs(cub_temp.getPtr(), cub_temp.getSize(), d_keys, d_keys_swap, d_vals, d_vals_swap, edge_count, 0, sizeof(uint64_t) * 8, stream));
+        // Build inverted PBM
+        buildPBM(d_ipbm, d_keys_swap, scatter, streamID, stream);
+        // Swap all the swap pointers, so the junk data is in swap
+        // The sorted inverted keys are retained in d_keys, for use by incremental rebuilds
+        std::swap(d_keys, d_keys_swap);
+        std::swap(d_ipbm_edges, d_vals_swap);
+    }
+    // Update which buffers curve points to
+    updateCurveEdgeBuffers();
+    {  // Translate edge source/dest pairs to vertex indices
+        const auto& e_srcdest_b = edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME);
+        e_srcdest_b.updateHostBuffer(edge_count, stream);  // Copy back to host, before we translate device IDs
+        const unsigned int BLOCK_SZ = 512;
+        const unsigned int BLOCK_CT = static_cast<unsigned int>(ceil(edge_count / static_cast<float>(BLOCK_SZ)));
+        translateSrcDest << <BLOCK_CT, BLOCK_SZ, 0, stream >> > (static_cast<id_t*>(e_srcdest_b.d_ptr), d_vertex_index_map, vertex_index_map_length, edge_count);
+        gpuErrchkLaunch()
+        // Rebuild the edge index map
+        h_edge_index_map.clear();
+        h_edge_index_map.reserve(edge_count);
+        for (unsigned int i = 0; i < edge_count; ++i) {
+            h_edge_index_map.emplace(std::pair{static_cast<id_t*>(e_srcdest_b.h_ptr)[i * 2 + 1], static_cast<id_t*>(e_srcdest_b.h_ptr)[i * 2 + 0]}, i);
+        }
+    }
+}
+void CUDAEnvironmentDirectedGraphBuffers::rebuildIncremental(detail::CUDAScatter& scatter, const unsigned int streamID, const cudaStream_t stream) {
+    auto& e_srcdest_b = edge_buffers.at(GRAPH_SOURCE_DEST_VARIABLE_NAME);
+    id_t *const h_srcdest = static_cast<id_t*>(e_srcdest_b.h_ptr);
+    const unsigned int dirty_count = static_cast<unsigned int>(dirty_edges.size());
+    // Validate the dirty edges against the host ID map, and build their CSR and CSC keys
+    // The device ID map does not need rebuilding, as vertex IDs have not changed since the last rebuild
+    std::vector<std::pair<uint64_t, unsigned int>> csr(dirty_count), csc(dirty_count);
+    {
+        unsigned int err_collision_range[4] = {0, 0, 0, 0};  // {src_notset, dest_notset, src_invalid, dest_invalid}
+        unsigned int i = 0;
+        for (const unsigned int edge_index : dirty_edges) {
+            const id_t src_id = h_srcdest[edge_index * 2 + 1];
+            const id_t dest_id = h_srcdest[edge_index * 2 + 0];
+            const auto src = h_vertex_index_map.find(src_id);
+            const auto dest = h_vertex_index_map.find(dest_id);
+            if (src_id == ID_NOT_SET) {
+                ++err_collision_range[0];
+            } else if (src == h_vertex_index_map.end()) {
+                ++err_collision_range[2];
+            }
+            if (dest_id == ID_NOT_SET) {
+                ++err_collision_range[1];
+            } else if (dest == h_vertex_index_map.end()) {
+                ++err_collision_range[3];
+            }
+            if (src != h_vertex_index_map.end() && dest != h_vertex_index_map.end()) {
+                csr[i] = {(static_cast<uint64_t>(src->second) << 32) | dest->second, edge_index};
+                csc[i] = {(static_cast<uint64_t>(dest->second) << 32) | src->second, edge_index};
+            }
+            ++i;
+        }
+        if (err_collision_range[0] > 0 || err_collision_range[1] > 0) {
+            THROW flamegpu::exception::IDNotSet("Graph contains %u and %u edges which have not had their source and destinations set respectively, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[0], err_collision_range[1]);
+        } else if (err_collision_range[2] > 0 || err_collision_range[3] > 0) {
+            THROW flamegpu::exception::InvalidID("Graph contains %u and %u edges which have invalid source and destinations set respectively, in CUDAEnvironmentDirectedGraphBuffers::syncDevice_async()", err_collision_range[2], err_collision_range[3]);
+        }
+        std::sort(csr.begin(), csr.end());
+        std::sort(csc.begin(), csc.end());
+    }
+    // Stage the dirty edges on the device
+    // Layout: {csr_keys, csc_keys, csr_vals, csc_vals, dirty_indices}, 64 bit keys first to maintain alignment
+    const size_t staging_length = dirty_count * (2 * sizeof(uint64_t) + 3 * sizeof(unsigned int));
+    if (staging_length > d_dirty_edges_length) {
+        if (d_dirty_edges) {
+            gpuErrchk(flamegpu::detail::cuda::cudaFree(d_dirty_edges));
+        }
+        gpuErrchk(cudaMalloc(&d_dirty_edges, staging_length));
+        d_dirty_edges_length = staging_length;
+    }
+    if (!d_edge_flags) {
+        gpuErrchk(cudaMalloc(&d_edge_flags, (edge_count + 1) * sizeof(unsigned int)));
+        gpuErrchk(cudaMalloc(&d_edge_flags_scan, (edge_count + 1) * sizeof(unsigned int)));
+    }
+    std::vector<char> h_staging(staging_length);
+    uint64_t *const h_csr_keys = reinterpret_cast<uint64_t*>(h_staging.data());
+    uint64_t *const h_csc_keys = h_csr_keys + dirty_count;
+    unsigned int *const h_csr_vals = reinterpret_cast<unsigned int*>(h_csc_keys + dirty_count);
+    unsigned int *const h_csc_vals = h_csr_vals + dirty_count;
+    unsigned int *const h_dirty_indices = h_csc_vals + dirty_count;
+    {
+        unsigned int i = 0;
+        for (const unsigned int edge_index : dirty_edges) {
+            h_csr_keys[i] = csr[i].first;
+            h_csc_keys[i] = csc[i].first;
+            h_csr_vals[i] = csr[i].second;
+            h_csc_vals[i] = csc[i].second;
+            h_dirty_indices[i++] = edge_index;
+        }
+    }
+    gpuErrchk(cudaMemcpyAsync(d_dirty_edges, h_staging.data(), staging_length, cudaMemcpyHostToDevice, stream));
+    const uint64_t *const d_csr_keys = reinterpret_cast<const uint64_t*>(d_dirty_edges);
+    const uint64_t *const d_csc_keys = d_csr_keys + dirty_count;
+    const unsigned int *const d_csr_vals = reinterpret_cast<const unsigned int*>(d_csc_keys + dirty_count);
+    const unsigned int *const d_csc_vals = d_csr_vals + dirty_count;
+    const unsigned int *const d_dirty_indices = d_csc_vals + dirty_count;
+    const unsigned int BLOCK_SZ = 512;
+    const unsigned int EDGE_BLOCK_CT = static_cast<unsigned int>(ceil(edge_count / static_cast<float>(BLOCK_SZ)));
+    const unsigned int DIRTY_BLOCK_CT = static_cast<unsigned int>(ceil(dirty_count / static_cast<float>(BLOCK_SZ)));
+    auto& cub_temp = scatter.CubTemp(streamID);
+    size_t temp_req = 0;
+    gpuErrchk(cub::DeviceScan::ExclusiveSum(nullptr, temp_req, d_edge_flags, d_edge_flags_scan, edge_count + 1, stream));
+    cub_temp.resize(temp_req);
+    std::vector<unsigned int> h_permutation(edge_count);
+    // Merge the CSR/VBM (edgesLeaving())
+    // The device source/dest buffer holds the sorted CSR keys from the previous rebuild, edge indices match their position
+    {
+        gpuErrchk(cudaMemsetAsync(d_edge_flags, 0, (edge_count + 1) * sizeof(unsigned int), stream));
+        flagEdges << <DIRTY_BLOCK_CT, BLOCK_SZ, 0, stream >> > (d_edge_flags, d_dirty_indices, dirty_count);
+        gpuErrchkLaunch();
+        gpuErrchk(cub::DeviceScan::ExclusiveSum(cub_temp.getPtr(), cub_temp.getSize(), d_edge_flags, d_edge_flags_scan, edge_count + 1, stream));
+        // The merged keys are written directly to the source/dest swap buffer, the merged vals are the position map of the edge variables
+        const uint64_t *d_old_keys = static_cast<const uint64_t*>(e_srcdest_b.d_ptr);
+        uint64_t *d_new_keys = static_cast<uint64_t*>(e_srcdest_b.d_ptr_swap);
+        mergeSortedClean << <EDGE_BLOCK_CT, BLOCK_SZ, 0, stream >> > (d_old_keys, nullptr, d_edge_flags_scan, edge_count, d_csr_keys, dirty_count, nullptr, d_new_keys, d_vals_swap);
+        gpuErrchkLaunch();
+        mergeSortedDirty << <DIRTY_BLOCK_CT, BLOCK_SZ, 0, stream >> > (d_csr_keys, d_csr_vals, dirty_count, d_old_keys, d_edge_flags_scan, edge_count, nullptr, d_new_keys, d_vals_swap);
+        gpuErrchkLaunch();
+        // Sort the remaining edge variables
+        std::vector<detail::CUDAScatter::ScatterData> sd;
+        for (auto& edge : edge_buffers) {
+            edge.second.swap();
+            if (edge.first != GRAPH_SOURCE_DEST_VARIABLE_NAME) {
+                sd.push_back(detail::CUDAScatter::ScatterData{edge.second.element_size, reinterpret_cast<char*>(edge.second.d_ptr_swap), reinterpret_cast<char*>(edge.second.d_ptr)});
+                edge.second.ready = Buffer::Device;
+            }
+        }
+        if (!sd.empty()) {
+            scatter.scatterPosition_async(streamID, stream, d_vals_swap, sd, edge_count);
+        }
+        // The host needs the position map to reorder its copy of the source/dest buffer
+        gpuErrchk(cudaMemcpyAsync(h_permutation.data(), d_vals_swap, edge_count * sizeof(unsigned int), cudaMemcpyDeviceToHost, stream));
+        // Old edge index -> new edge index, required to update the CSC's edge list
+        invertPermutation << <EDGE_BLOCK_CT, BLOCK_SZ, 0, stream >> > (d_vals, d_vals_swap, edge_count);
+        gpuErrchkLaunch();
+        buildPBM(d_pbm, d_new_keys, scatter, streamID, stream);
+    }
+    // Merge the CSC/Inverted VBM (edgesJoining())
+    // d_keys holds the sorted inverted keys from the previous rebuild, d_ipbm_edges the corresponding (old) edge indices
+    {
+        gpuErrchk(cudaMemsetAsync(d_vals_swap + edge_count, 0, sizeof(unsigned int), stream));
+        flagEdgesInverted << <EDGE_BLOCK_CT, BLOCK_SZ, 0, stream >> > (d_vals_swap, d_edge_flags, d_ipbm_edges, edge_count);
+        gpuErrchkLaunch();
+        gpuErrchk(cub::DeviceScan::ExclusiveSum(cub_temp.getPtr(), cub_temp.getSize(), d_vals_swap, d_edge_flags_scan, edge_count + 1, stream));
+        mergeSortedClean << <EDGE_BLOCK_CT, BLOCK_SZ, 0, stream >> > (d_keys, d_ipbm_edges, d_edge_flags_scan, edge_count, d_csc_keys, dirty_count, d_vals, d_keys_swap, d_vals_swap);
+        gpuErrchkLaunch();
+        mergeSortedDirty << <DIRTY_BLOCK_CT, BLOCK_SZ, 0, stream >> > (d_csc_keys, d_csc_vals, dirty_count, d_keys, d_edge_flags_scan, edge_count, d_vals, d_keys_swap, d_vals_swap);
+        gpuErrchkLaunch();
+        std::swap(d_keys, d_keys_swap);
+        std::swap(d_ipbm_edges, d_vals_swap);
+        buildPBM(d_ipbm, d_keys, scatter, streamID, stream);
+    }
+    // Update which buffers curve points to
+    updateCurveEdgeBuffers();
+    // Reorder the host's copy of the source/dest buffer to match the device, and rebuild the edge index map
+    gpuErrchk(cudaStreamSynchronize(stream));
+    std::vector<id_t> old_srcdest(h_srcdest, h_srcdest + edge_count * 2);
+    h_edge_index_map.clear();
+    h_edge_index_map.reserve(edge_count);
+    for (unsigned int i = 0; i < edge_count; ++i) {
+        h_srcdest[i * 2 + 0] = old_srcdest[h_permutation[i] * 2 + 0];
+        h_srcdest[i * 2 + 1] = old_srcdest[h_permutation[i] * 2 + 1];
+        h_edge_index_map.emplace(std::pair{h_srcdest[i * 2 + 1], h_srcdest[i * 2 + 0]}, i);
+    }
+    e_srcdest_b.ready = Buffer::Both;
+}
 
 void CUDAEnvironmentDirectedGraphBuffers::Buffer::updateHostBuffer(size_type edge_count, cudaStream_t stream) const {
     if (ready == Device) {
@@ -608,6 +953,17 @@ void CUDAEnvironmentDirectedGraphBuffers::Buffer::updateHostBuffer(size_type edg
         ready = Both;
     }
 }
+void CUDAEnvironmentDirectedGraphBuffers::markEdgeDirty(const unsigned int edge_index) {
+    requires_rebuild = true;
+    if (csr_valid) {
+        dirty_edges.insert(edge_index);
+        // Beyond this, a full rebuild is cheaper so stop tracking
+        if (dirty_edges.size() * INCREMENTAL_REBUILD_RATIO > edge_count) {
+            csr_valid = false;
+            dirty_edges.clear();
+        }
+    }
+}
 void CUDAEnvironmentDirectedGraphBuffers::resetVertexIDBounds() {
     vertex_id_min = std::numeric_limits<unsigned int>::max();
     vertex_id_max = std::numeric_limits<unsigned int>::min();
@@ -638,6 +994,8 @@ void CUDAEnvironmentDirectedGraphBuffers::setVertexID(unsigned int vertex_index,
     // Update vertex's ID in buffer
     static_cast<id_t*>(vb.h_ptr)[vertex_index] = vertex_id;
     vb.ready = Buffer::Host;
+    // Edges may refer to the changed ID, so the previous CSR can not be updated incrementally
+    csr_valid = false;
 
     // Update range calc (naive, can be wrong if IDs are changed)
     vertex_id_min = std::min(vertex_id_min, vertex_id);
@@ -688,7 +1046,7 @@ void CUDAEnvironmentDirectedGraphBuffers::setEdgeSourceDestination(unsigned int
     eb.ready = Buffer::Host;
 
     // Require rebuild before use
-    markForRebuild();
+    markEdgeDirty(edge_index);
 }
 void CUDAEnvironmentDirectedGraphBuffers::setEdgeSource(unsigned int edge_index, id_t src_vertex_id) {
     if (edge_index >= edge_count) {
@@ -725,7 +1083,7 @@ void CUDAEnvironmentDirectedGraphBuffers::setEdgeSource(unsigned int edge_index,
     }
 
     // Require rebuild before use
-    markForRebuild();
+    markEdgeDirty(edge_index);
 }
 void CUDAEnvironmentDirectedGraphBuffers::setEdgeDestination(unsigned int edge_index, id_t dest_vertex_id) {
     if (edge_index >= edge_count) {
@@ -762,7 +1120,7 @@ void CUDAEnvironmentDirectedGraphBuffers::setEdgeDestination(unsigned int edge_i
     }
 
     // Require rebuild before use
-    markForRebuild();
+    markEdgeDirty(edge_index);
 }
 unsigned int CUDAEnvironmentDirectedGraphBuffers::getEdgeIndex(id_t src_vertex_id, id_t dest_vertex_id) const {
     const auto find = h_edge_index_map.find({src_vertex_id, dest_vertex_id});
@@ -820,6 +1178,7 @@ unsigned int CUDAEnvironmentDirectedGraphBuffers::createIfNotExistVertex(id_t ve
         vb.updateHostBuffer(vertex_count, stream);
         static_cast<id_t*>(vb.h_ptr)[vertex_index] = vertex_id;
         vb.ready = Buffer::Host;
+        csr_valid = false;
         // Update range calc
         vertex_id_min = std::min(vertex_id_min, vertex_id);
         vertex_id_max = std::max(vertex_id_max, vertex_id);
@@ -846,7 +1205,7 @@ unsigned int CUDAEnvironmentDirectedGraphBuffers::createIfNotExistEdge(id_t sour
         static_cast<id_t*>(eb.h_ptr)[edge_index * 2 + 1] = source_vertex_id;
         eb.ready = Buffer::Host;
         // Require rebuild before use
-        markForRebuild();
+        markEdgeDirty(edge_index);
         return edge_index;
     }
     THROW exception::OutOfBoundsException("Creating edge with src %u dest %u would exceed available edges (%u), "
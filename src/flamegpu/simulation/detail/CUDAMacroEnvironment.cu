@@ -88,6 +88,22 @@ void CUDAMacroEnvironment::free() {
         }
     }
 }
+void CUDAMacroEnvironment::resetProperties(const cudaStream_t _stream) {
+    for (auto& prop : properties) {
+        if (prop.second.d_ptr && !prop.second.is_sub) {
+            size_t buffer_size = prop.second.type_size
+                                     * prop.second.elements[0]
+                                     * prop.second.elements[1]
+                                     * prop.second.elements[2]
+                                     * prop.second.elements[3];
+#if !defined(FLAMEGPU_SEATBELTS) || FLAMEGPU_SEATBELTS
+            buffer_size += sizeof(unsigned int);  // Extra uint is used as read-write flag by seatbelts
+#endif
+            gpuErrchk(cudaMemsetAsync(prop.second.d_ptr, 0, buffer_size, _stream));
+        }
+    }
+    gpuErrchk(cudaStreamSynchronize(_stream));
+}
 void CUDAMacroEnvironment::registerCurveVariables(detail::curve::HostCurve& curve) const {
     for (const auto& p : properties) {
         const unsigned int total_elements = p.second.elements[0] * p.second.elements[1] * p.second.elements[2] * p.second.elements[3];
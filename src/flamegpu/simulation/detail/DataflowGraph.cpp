@@ -0,0 +1,242 @@
+#include "flamegpu/simulation/detail/DataflowGraph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "flamegpu/detail/ThreadPool.h"
+#include "flamegpu/exception/FLAMEGPUException.h"
+#include "flamegpu/model/AgentData.h"
+#include "flamegpu/model/AgentFunctionData.cuh"
+#include "flamegpu/model/LayerData.h"
+#include "flamegpu/model/ModelData.h"
+#include "flamegpu/model/SubModelData.h"
+#include "flamegpu/runtime/messaging/MessageBruteForce.h"
+
+namespace flamegpu {
+namespace detail {
+
+DataflowGraph::DataflowGraph(const ModelData &model, const Options &options) {
+    /**
+     * Tracks the accesses to a single agent state list, agent type or message list
+     */
+    struct Resource {
+        unsigned int last_writer = UINT_MAX;
+        /**
+         * Nodes which have read the resource since last_writer
+         */
+        std::vector<unsigned int> readers;
+        /**
+         * Message lists only, whether a MessageBuild node has followed the last output to the list
+         */
+        bool built = false;
+    };
+    std::unordered_map<std::string, Resource> resources;
+    std::vector<std::vector<unsigned int>> dependencies;
+    std::map<LayerData::MemberID, unsigned int> member_nodes;
+    // Appends a node, with the resources it accesses mapped to whether they are written
+    auto add_node = [&](Node &&node, const std::map<std::string, bool> &accesses) {
+        const unsigned int id = static_cast<unsigned int>(nodes.size());
+        nodes.push_back(std::move(node));
+        dependencies.emplace_back();
+        std::vector<unsigned int> &d = dependencies.back();
+        for (const auto &[key, write] : accesses) {
+            Resource &r = resources[key];
+            if (r.last_writer != UINT_MAX)
+                d.push_back(r.last_writer);
+            if (write) {
+                d.insert(d.end(), r.readers.begin(), r.readers.end());
+                r.readers.clear();
+                r.last_writer = id;
+                r.built = false;
+            } else {
+                r.readers.push_back(id);
+            }
+        }
+        return id;
+    };
+    // Every node accesses the global resource, host function and submodel layers write it so they act as barriers
+    const std::string GLOBAL = "global";
+    auto agent_key = [&options](const std::string &agent_name, const std::string &state_name) {
+        return options.granularity == AgentGranularity::Agent ? "agent:" + agent_name : "state:" + agent_name + ":" + state_name;
+    };
+    unsigned int layer_index = 0;
+    unsigned int function_index = 0;
+    for (const auto &layer : model.layers) {
+        if (layer->dependencies.empty()) {
+            THROW exception::InvalidOperation("Layer %u was not generated from the model's dependency graph, dataflow execution requires layers generated by ModelDescription::generateLayers(), "
+                "in DataflowGraph::DataflowGraph().", layer_index);
+        }
+        for (const auto &f : getLayerFunctions(*layer)) {
+            const std::string &agent_name = f->parent.lock()->name;
+            std::map<std::string, bool> accesses;
+            accesses[GLOBAL] = options.serialise_agent_functions;
+            // The input state is consumed, and the end state appended to
+            accesses[agent_key(agent_name, f->initial_state)] = true;
+            accesses[agent_key(agent_name, f->end_state)] = true;
+            if (const auto mi = f->message_input.lock()) {
+                const std::string key = "message:" + mi->name;
+                if (options.message_builds && !resources[key].built) {
+                    // Build the message list once, prior to its first reader
+                    Node build{ Node::MessageBuild, layer, layer_index, nullptr, 0, mi->name, false, 0, {} };
+                    add_node(std::move(build), { { GLOBAL, false }, { key, true } });
+                    resources[key].built = true;
+                }
+                accesses.emplace(key, false);
+            }
+            if (const auto mo = f->message_output.lock()) {
+                accesses["message:" + mo->name] = true;
+            }
+            if (const auto ao = f->agent_output.lock()) {
+                accesses[agent_key(ao->name, f->agent_output_state)] = true;
+                accesses["id:" + ao->name] = true;
+            }
+            Node node{ Node::AgentFunction, layer, layer_index, f, function_index++, "", false, 0, {} };
+            member_nodes.emplace(LayerData::MemberID{layer->index, {agent_name, f->name}}, add_node(std::move(node), accesses));
+        }
+        if (layer->sub_model || !layer->host_functions.empty() || !layer->host_functions_callbacks.empty()) {
+            // Host functions (and submodels) may not be thread safe, so they are executed by the thread which executes the step
+            Node node{ layer->sub_model ? Node::SubModel : Node::HostFunctions, layer, layer_index, nullptr, 0, "", true, 0, {} };
+            member_nodes.emplace(LayerData::MemberID{layer->index, {"", ""}}, add_node(std::move(node), { { GLOBAL, true } }));
+        }
+        ++layer_index;
+    }
+    // Dependencies specified by the model's dependency graph
+    for (const auto &layer : model.layers) {
+        for (const auto &member : layer->dependencies) {
+            const auto node = member_nodes.find({layer->index, member.first});
+            if (node == member_nodes.end())
+                continue;
+            for (const auto &d : member.second) {
+                const auto dependency = member_nodes.find(d);
+                if (dependency != member_nodes.end()) {
+                    dependencies[node->second].push_back(dependency->second);
+                }
+            }
+        }
+    }
+    for (unsigned int j = 0; j < nodes.size(); ++j) {
+        std::vector<unsigned int> &d = dependencies[j];
+        std::sort(d.begin(), d.end());
+        d.erase(std::unique(d.begin(), d.end()), d.end());
+        nodes[j].dependency_count = static_cast<unsigned int>(d.size());
+        for (const unsigned int i : d) {
+            nodes[i].dependents.push_back(j);
+        }
+    }
+}
+
+void DataflowGraph::execute(ThreadPool *pool, const std::function<void(const Node&)> &body) const {
+    if (!pool) {
+        // Nodes are stored in layered execution order, which satisfies all dependencies
+        for (const auto &node : nodes) {
+            body(node);
+        }
+        return;
+    }
+    struct State {
+        explicit State(const std::vector<Node> &nodes)
+            : pending(nodes.size())
+            , remaining(nodes.size()) {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                pending[i] = nodes[i].dependency_count;
+            }
+        }
+        /**
+         * Number of incomplete dependencies of each node
+         */
+        std::vector<std::atomic<unsigned int>> pending;
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable cv;
+        /**
+         * Number of nodes yet to complete, the number which have been launched and the ready nodes which must be executed by the calling thread,
+         * protected by mutex
+         */
+        size_t remaining;
+        size_t launched = 0;
+        std::deque<unsigned int> main_thread_nodes;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>(nodes);
+    // run and launch are captured by reference, this method does not return until all nodes have completed
+    std::function<void(unsigned int)> launch;
+    std::function<void(unsigned int)> run = [this, state, &body, &launch](const unsigned int i) {
+        // Once a node has failed, the remaining nodes are skipped
+        if (!state->failed.load()) {
+            try {
+                body(nodes[i]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error)
+                    state->error = std::current_exception();
+                state->failed = true;
+            }
+        }
+        // Dependents are still released after a failure, so that every node completes
+        for (const unsigned int d : nodes[i].dependents) {
+            if (--state->pending[d] == 0) {
+                launch(d);
+            }
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        --state->remaining;
+        state->cv.notify_all();
+    };
+    launch = [this, state, pool, &run](const unsigned int i) {
+        if (!nodes[i].main_thread) {
+            pool->submit([&run, i]() { run(i); });
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (nodes[i].main_thread) {
+            state->main_thread_nodes.push_back(i);
+        }
+        ++state->launched;
+        state->cv.notify_all();
+    };
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].dependency_count == 0) {
+            launch(i);
+        }
+    }
+    // Contribute to the work whilst waiting, only sleeping when there is nothing left to steal
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->remaining) {
+        if (!state->main_thread_nodes.empty()) {
+            const unsigned int i = state->main_thread_nodes.front();
+            state->main_thread_nodes.pop_front();
+            lock.unlock();
+            run(i);
+            lock.lock();
+            continue;
+        }
+        const size_t launched = state->launched;
+        lock.unlock();
+        while (pool->runPendingTask()) { }
+        lock.lock();
+        state->cv.wait(lock, [&state, launched]() { return !state->remaining || state->launched != launched; });
+    }
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+std::vector<std::shared_ptr<AgentFunctionData>> DataflowGraph::getLayerFunctions(const LayerData &layer) {
+    std::vector<std::shared_ptr<AgentFunctionData>> layer_functions(layer.agent_functions.begin(), layer.agent_functions.end());
+    std::sort(layer_functions.begin(), layer_functions.end(), [](const std::shared_ptr<AgentFunctionData> &a, const std::shared_ptr<AgentFunctionData> &b) {
+        const std::string &a_agent = a->parent.lock()->name;
+        const std::string &b_agent = b->parent.lock()->name;
+        return a_agent != b_agent ? a_agent < b_agent : a->name < b->name;
+    });
+    return layer_functions;
+}
+
+}  // namespace detail
+}  // namespace flamegpu
@@ -52,7 +52,7 @@ void EnvironmentManager::init(const EnvironmentData& desc) {
         memcpy(h_buffer + i.offset, i.data, i.length);
         properties.emplace(name, EnvProp(i.offset, i.length, i.isConst, i.elements, i.type));
     }
-    gpuErrchk(cudaMalloc(&d_buffer, newSize));
+    // d_buffer is allocated by the first call to updateDevice_async(), so the environment can be used by host-only simulations
 }
 void EnvironmentManager::init(const EnvironmentData& desc, const std::shared_ptr<EnvironmentManager>& parent_environment, const SubEnvironmentData& mapping) {
     init(desc);
@@ -134,7 +134,7 @@ void EnvironmentManager::setPropertyDirect(const std::string& property_name, con
     if (it != properties.end()) {
         if (h_buffer + it->second.offset != src_ptr)  // Skip self copies
             memcpy(h_buffer + it->second.offset, src_ptr, it->second.length);
-        d_buffer_ready = false;
+        d_buffer_dirty.markDirty(it->second.offset, it->second.length);
     } else {
         THROW exception::InvalidEnvProperty("Environment property '%s' was not found, "
             "in EnvironmentManager::setProperty().", property_name.c_str());
@@ -169,10 +169,13 @@ void EnvironmentManager::resetModel(const EnvironmentData& desc) {
         }
     }
 }
-void EnvironmentManager::updateDevice_async(const cudaStream_t stream) const {
-    if (!d_buffer_ready) {
-        gpuErrchk(cudaMemcpyAsync(d_buffer, h_buffer, h_buffer_len, cudaMemcpyHostToDevice, stream));
-        d_buffer_ready = true;
+void EnvironmentManager::updateDevice_async(const cudaStream_t stream) {
+    if (!d_buffer && h_buffer_len) {
+        gpuErrchk(cudaMalloc(&d_buffer, h_buffer_len));
+        d_buffer_dirty.markAll(h_buffer_len);
+    }
+    for (const auto &range : d_buffer_dirty.take(DEVICE_COPY_MAX_GAP)) {
+        gpuErrchk(cudaMemcpyAsync(d_buffer + range.first, h_buffer + range.first, range.second, cudaMemcpyHostToDevice, stream));
     }
 }
 }  // namespace detail
@@ -0,0 +1,98 @@
+#include "flamegpu/simulation/detail/HostSoABuffer.h"
+
+#include <cstring>
+
+namespace flamegpu {
+namespace detail {
+
+HostSoABuffer::Column::Column(const Variable &variable)
+    : type(variable.type)
+    , type_size(variable.type_size)
+    , elements(variable.elements)
+    , default_value(variable.type_size * variable.elements, 0) {
+    if (variable.default_value) {
+        memcpy(default_value.data(), variable.default_value, default_value.size());
+    }
+}
+
+HostSoABuffer::HostSoABuffer(const VariableMap &variables)
+    : count(0) {
+    for (const auto &v : variables) {
+        columns.emplace(v.first, Column(v.second));
+    }
+}
+
+void HostSoABuffer::resize(const unsigned int new_size) {
+    if (new_size == count)
+        return;
+    for (auto &c : columns) {
+        Column &col = c.second;
+        const size_t var_size = col.type_size * col.elements;
+        col.data.resize(var_size * new_size);
+        // Default init new items
+        for (unsigned int i = count; i < new_size; ++i) {
+            memcpy(col.data.data() + i * var_size, col.default_value.data(), var_size);
+        }
+    }
+    count = new_size;
+}
+
+void HostSoABuffer::compact(const std::vector<char> &keep) {
+    unsigned int new_count = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        if (keep[i]) {
+            if (i != new_count) {
+                for (auto &c : columns) {
+                    const size_t var_size = c.second.type_size * c.second.elements;
+                    memcpy(c.second.item(new_count), c.second.item(i), var_size);
+                }
+            }
+            ++new_count;
+        }
+    }
+    for (auto &c : columns) {
+        c.second.data.resize(c.second.type_size * c.second.elements * new_count);
+    }
+    count = new_count;
+}
+
+void HostSoABuffer::append(const HostSoABuffer &other, const std::vector<char> *flags) {
+    unsigned int append_count = other.count;
+    if (flags) {
+        append_count = 0;
+        for (unsigned int i = 0; i < other.count; ++i)
+            append_count += (*flags)[i] ? 1 : 0;
+    }
+    if (!append_count)
+        return;
+    const unsigned int old_count = count;
+    for (auto &c : columns) {
+        Column &col = c.second;
+        const Column &other_col = other.columns.at(c.first);
+        const size_t var_size = col.type_size * col.elements;
+        col.data.resize(var_size * (old_count + append_count));
+        if (!flags) {
+            memcpy(col.item(old_count), other_col.data.data(), var_size * append_count);
+        } else {
+            unsigned int j = old_count;
+            for (unsigned int i = 0; i < other.count; ++i) {
+                if ((*flags)[i]) {
+                    memcpy(col.item(j++), other_col.item(i), var_size);
+                }
+            }
+        }
+    }
+    count = old_count + append_count;
+}
+
+HostSoABuffer::Column *HostSoABuffer::findColumn(const std::string &name) {
+    const auto it = columns.find(name);
+    return it == columns.end() ? nullptr : &it->second;
+}
+const HostSoABuffer::Column *HostSoABuffer::findColumn(const std::string &name) const {
+    const auto it = columns.find(name);
+    return it == columns.end() ? nullptr : &it->second;
+}
+
+}  // namespace detail
+}  // namespace flamegpu
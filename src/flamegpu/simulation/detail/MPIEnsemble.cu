@@ -1,4 +1,5 @@
 #ifdef FLAMEGPU_ENABLE_MPI
+#include <climits>
 #include <cstdio>
 #include <string>
 #include <map>
@@ -21,6 +22,9 @@ MPIEnsemble::MPIEnsemble(const CUDAEnsemble::EnsembleConfig &_config, const unsi
     , local_size(queryMPISharedGroupSize())
     , total_runs(_total_runs)
     , MPI_ERROR_DETAIL(AbstractSimRunner::createErrorDetailMPIDatatype())
+    , job_request_count(0)
+    , job_assignment{0, 0}
+    , job_requests{MPI_REQUEST_NULL, MPI_REQUEST_NULL}
     , rank_is_participating(false)
     , comm_participating(MPI_COMM_NULL)
     , participating_size(0)
@@ -65,7 +69,7 @@ int MPIEnsemble::receiveErrors(std::multimap<int, AbstractSimRunner::ErrorDetail
     }
     return errCount;
 }
-int MPIEnsemble::receiveJobRequests(unsigned int &next_run) {
+int MPIEnsemble::receiveJobRequests(unsigned int &next_run, const bool cancelled) {
     int mpi_runners_fin = 0;
     if (world_rank == 0) {
         MPI_Status status;
@@ -77,29 +81,42 @@ int MPIEnsemble::receiveJobRequests(unsigned int &next_run) {
             &flag,                    // int flag
             &status);                 // MPI_Status*
         while (flag) {
-            // Receive the message (kind of redundant as we already have the status and it carrys no data)
+            // Receive the message, this contains the maximum number of jobs the sender wants
+            unsigned int requested = 0;
             memset(&status, 0, sizeof(MPI_Status));
             MPI_Recv(
-                nullptr,                  // void* data
-                0,                        // int count
-                MPI_CHAR,                 // MPI_Datatype datatype (can't use MPI_DATATYPE_NULL)
+                &requested,               // void* data
+                1,                        // int count
+                MPI_UNSIGNED,             // MPI_Datatype datatype
                 MPI_ANY_SOURCE,           // int source
                 EnvelopeTag::RequestJob,  // int tag
                 MPI_COMM_WORLD,           // MPI_Comm communicator
                 &status);                 // MPI_Status*
+            // Chunks shrink as jobs are depleted, so that the final jobs are spread across all ranks
+            unsigned int assignment[2] = {next_run, 0};
+            if (next_run < total_runs) {
+                const unsigned int remaining = total_runs - next_run;
+                const unsigned int guided = (remaining + 2 * participating_size - 1) / (2 * participating_size);
+                assignment[1] = std::max(1u, std::min(std::max(1u, requested), guided));
+                next_run += assignment[1];
+            } else {
+                if (cancelled) assignment[0] = UINT_MAX;
+                ++mpi_runners_fin;
+            }
             // Respond to the sender with a job assignment
             MPI_Send(
-                &next_run,               // void* data
-                1,                       // int count
+                assignment,              // void* data
+                2,                       // int count
                 MPI_UNSIGNED,            // MPI_Datatype datatype
                 status.MPI_SOURCE,       // int destination
                 EnvelopeTag::AssignJob,  // int tag
                 MPI_COMM_WORLD);         // MPI_Comm communicator
-            if (next_run >= total_runs) ++mpi_runners_fin;
-            ++next_run;
             // Print progress to console
-            if (config.verbosity >= Verbosity::Default && next_run <= total_runs) {
-                fprintf(stdout, "MPI ensemble assigned run %d/%u to rank %d\n", next_run, total_runs, status.MPI_SOURCE);
+            if (config.verbosity >= Verbosity::Default && assignment[1] == 1) {
+                fprintf(stdout, "MPI ensemble assigned run %u/%u to rank %d\n", next_run, total_runs, status.MPI_SOURCE);
+                fflush(stdout);
+            } else if (config.verbosity >= Verbosity::Default && assignment[1] > 1) {
+                fprintf(stdout, "MPI ensemble assigned run %u-%u/%u to rank %d\n", assignment[0] + 1, next_run, total_runs, status.MPI_SOURCE);
                 fflush(stdout);
             }
             // Check again
@@ -119,30 +136,44 @@ void MPIEnsemble::sendErrorDetail(AbstractSimRunner::ErrorDetail &e_detail) {
           MPI_COMM_WORLD);           // MPI_Comm communicator
     }
 }
-int MPIEnsemble::requestJob() {
-    unsigned int next_run = UINT_MAX;
+void MPIEnsemble::requestJobs(const unsigned int count) {
     if (world_rank != 0) {
-        // Send a job request to 0, these have no data
-        MPI_Send(
-            nullptr,                  // void* data
-            0,                        // int count
-            MPI_CHAR,                 // MPI_Datatype datatype (can't use MPI_DATATYPE_NULL)
-            0,                        // int destination
-            EnvelopeTag::RequestJob,  // int tag
-            MPI_COMM_WORLD);          // MPI_Comm communicator
-        // Wait for a job assignment from 0
-        MPI_Status status;
-        memset(&status, 0, sizeof(MPI_Status));
-        MPI_Recv(
-            &next_run,               // void* data
-            1,                       // int count
+        job_request_count = count;
+        // Post the receive for the assignment first, so it is ready when 0 responds
+        MPI_Irecv(
+            job_assignment,          // void* data
+            2,                       // int count
             MPI_UNSIGNED,            // MPI_Datatype datatype
             0,                       // int source
             EnvelopeTag::AssignJob,  // int tag
             MPI_COMM_WORLD,          // MPI_Comm communicator
-            &status);                // MPI_Status* status
+            &job_requests[1]);       // MPI_Request* request
+        // Send a job request to 0, containing the maximum number of jobs wanted
+        MPI_Isend(
+            &job_request_count,       // void* data
+            1,                        // int count
+            MPI_UNSIGNED,             // MPI_Datatype datatype
+            0,                        // int destination
+            EnvelopeTag::RequestJob,  // int tag
+            MPI_COMM_WORLD,           // MPI_Comm communicator
+            &job_requests[0]);        // MPI_Request* request
+    }
+}
+bool MPIEnsemble::receiveJobs(unsigned int &first, unsigned int &count, const bool block) {
+    if (world_rank == 0) {
+        return false;
+    }
+    int flag = 1;
+    if (block) {
+        MPI_Waitall(2, job_requests, MPI_STATUSES_IGNORE);
+    } else {
+        MPI_Testall(2, job_requests, &flag, MPI_STATUSES_IGNORE);
+    }
+    if (flag) {
+        first = job_assignment[0];
+        count = job_assignment[1];
     }
-    return next_run;
+    return flag;
 }
 void MPIEnsemble::worldBarrier() {
     MPI_Barrier(MPI_COMM_WORLD);
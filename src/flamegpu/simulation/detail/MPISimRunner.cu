@@ -32,8 +32,12 @@ MPISimRunner::MPISimRunner(const std::shared_ptr<const ModelData> _model,
     std::queue<unsigned int>& _log_export_queue,
     std::mutex& _log_export_queue_mutex,
     std::condition_variable& _log_export_queue_cdn,
+    const unsigned int _max_log_export_backlog,
     std::vector<ErrorDetail>& _err_detail_local,
+    std::mutex &_runner_mutex,
+    std::condition_variable &_runner_cdn,
     const unsigned int _total_runners,
+    const bool _reuse_simulation,
     bool _isSWIG)
     : AbstractSimRunner(
         _model,
@@ -49,40 +53,55 @@ MPISimRunner::MPISimRunner(const std::shared_ptr<const ModelData> _model,
         _log_export_queue,
         _log_export_queue_mutex,
         _log_export_queue_cdn,
+        _max_log_export_backlog,
         _err_detail_local,
         _total_runners,
+        _reuse_simulation,
         _isSWIG)
-    { }
+    , runner_mutex(_runner_mutex)
+    , runner_cdn(_runner_cdn) { }
 
 void MPISimRunner::main() {
     // While there are still plans to process
     while (true) {
-        const unsigned int run_id = next_run.load();
-        if (run_id < plans.size()) {
-            // Process the assigned job
-            try {
-                runSimulation(run_id);
-                if (next_run.exchange(Signal::RequestJob) >= plans.size()) {
-                    break;
-                }
-                // MPI Worker's don't print progress
-            } catch(std::exception &e) {
-                // log_export_mutex is treated as our protection for race conditions on err_detail
-                std::lock_guard<std::mutex> lck(log_export_queue_mutex);
-                // Build the error detail (fixed len char array for string)
-                // fprintf(stderr, "Fail: run: %u device: %u, runner: %u\n", run_id, device_id, runner_id);  // useful debug, breaks tests
-                err_detail.push_back(ErrorDetail{run_id, static_cast<unsigned int>(device_id), runner_id, });
-                strncpy(err_detail.back().exception_string, e.what(), sizeof(ErrorDetail::exception_string)-1);
-                err_detail.back().exception_string[sizeof(ErrorDetail::exception_string) - 1] = '\0';
-                err_ct.store(static_cast<int>(err_detail.size()));
-                // Need to notify manager that run failed
-                if (next_run.exchange(Signal::RunFailed) >= plans.size()) {
-                    break;
-                }
-            }
-        } else if (run_id == Signal::RequestJob || run_id == Signal::RunFailed) {
-            std::this_thread::yield();
-        } else {
+        unsigned int run_id;
+        {
+            // Wait for the manager to assign a job
+            std::unique_lock<std::mutex> lck(runner_mutex);
+            runner_cdn.wait(lck, [this]() {
+                const unsigned int t = next_run.load();
+                return t != Signal::RequestJob && t != Signal::RunFailed;
+            });
+            run_id = next_run.load();
+        }
+        if (run_id >= plans.size()) {
+            break;
+        }
+        // Process the assigned job
+        Signal result = Signal::RequestJob;
+        try {
+            runSimulation(run_id);
+            // MPI Worker's don't print progress
+        } catch(std::exception &e) {
+            // log_export_mutex is treated as our protection for race conditions on err_detail
+            std::lock_guard<std::mutex> lck(log_export_queue_mutex);
+            // Build the error detail (fixed len char array for string)
+            // fprintf(stderr, "Fail: run: %u device: %u, runner: %u\n", run_id, device_id, runner_id);  // useful debug, breaks tests
+            err_detail.push_back(ErrorDetail{run_id, static_cast<unsigned int>(device_id), runner_id, });
+            strncpy(err_detail.back().exception_string, e.what(), sizeof(ErrorDetail::exception_string)-1);
+            err_detail.back().exception_string[sizeof(ErrorDetail::exception_string) - 1] = '\0';
+            err_ct.store(static_cast<int>(err_detail.size()));
+            // Need to notify manager that run failed
+            result = Signal::RunFailed;
+        }
+        unsigned int previous;
+        {
+            std::lock_guard<std::mutex> lck(runner_mutex);
+            previous = next_run.exchange(result);
+        }
+        runner_cdn.notify_all();
+        // The manager has already told the runner to exit
+        if (previous >= plans.size()) {
             break;
         }
     }
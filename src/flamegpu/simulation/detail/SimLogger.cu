@@ -1,12 +1,16 @@
 #include "flamegpu/simulation/detail/SimLogger.h"
 
+#include <algorithm>
+#include <climits>
 #include <filesystem>
 #include <string>
 #include <map>
 #include <queue>
 #include <memory>
+#include <sstream>
 
 #include "flamegpu/io/LoggerFactory.h"
+#include "flamegpu/detail/SteadyClockTimer.h"
 #include "flamegpu/simulation/RunPlanVector.h"
 
 #ifdef _MSC_VER
@@ -18,7 +22,7 @@
 namespace flamegpu {
 namespace detail {
 
-SimLogger::SimLogger(const std::map<unsigned int, RunLog> &_run_logs,
+SimLogger::SimLogger(std::map<unsigned int, RunLog> &_run_logs,
         const RunPlanVector &_run_plans,
         const std::string &_out_directory,
         const std::string &_out_format,
@@ -28,7 +32,9 @@ SimLogger::SimLogger(const std::map<unsigned int, RunLog> &_run_logs,
         bool _export_step,
         bool _export_exit,
         bool _export_step_time,
-        bool _export_exit_time)
+        bool _export_exit_time,
+        bool _evict_exported_logs,
+        unsigned int export_threads)
     : run_logs(_run_logs)
     , run_plans(_run_plans)
     , out_directory(_out_directory)
@@ -39,59 +45,89 @@ SimLogger::SimLogger(const std::map<unsigned int, RunLog> &_run_logs,
     , export_step(_export_step)
     , export_exit(_export_exit)
     , export_step_time(_export_step_time)
-    , export_exit_time(_export_exit_time) {
-    this->thread = std::thread(&SimLogger::start, this);
-    // Attempt to name the thread
+    , export_exit_time(_export_exit_time)
+    , evict_exported_logs(_evict_exported_logs) {
+    export_threads = export_threads ? export_threads : 1;
+    metrics.export_threads = export_threads;
+    for (unsigned int i = 0; i < export_threads; ++i) {
+        this->threads.emplace_back(&SimLogger::start, this);
+        // Attempt to name the thread
 #ifdef _MSC_VER
-    std::wstringstream thread_name;
-    thread_name << L"SimLogger";
-    // HRESULT hr =
-    SetThreadDescription(this->thread.native_handle(), thread_name.str().c_str());
-    // if (FAILED(hr)) {
-    //     fprintf(stderr, "Failed to name thread 'SimLogger'\n");
-    // }
+        std::wstringstream thread_name;
+        thread_name << L"SimLogger" << i;
+        // HRESULT hr =
+        SetThreadDescription(this->threads.back().native_handle(), thread_name.str().c_str());
+        // if (FAILED(hr)) {
+        //     fprintf(stderr, "Failed to name thread 'SimLogger'\n");
+        // }
 #else
-    std::stringstream thread_name;
-    thread_name << "SimLogger";
-    // int hr =
-    pthread_setname_np(this->thread.native_handle(), thread_name.str().c_str());
-    // if (hr) {
-    //     fprintf(stderr, "Failed to name thread 'SimLogger'\n");
-    // }
+        std::stringstream thread_name;
+        thread_name << "SimLogger" << i;
+        // int hr =
+        pthread_setname_np(this->threads.back().native_handle(), thread_name.str().c_str());
+        // if (hr) {
+        //     fprintf(stderr, "Failed to name thread 'SimLogger'\n");
+        // }
 #endif
+    }
+}
+void SimLogger::join() {
+    for (auto &t : threads) {
+        if (t.joinable())
+            t.join();
+    }
+}
+std::mutex &SimLogger::getExitFileMutex(const std::string &path) {
+    std::lock_guard<std::mutex> lock(exit_file_mutexes_mutex);
+    // Map nodes are stable, so the returned reference remains valid as further files are added
+    return exit_file_mutexes[path];
 }
 void SimLogger::start() {
     const std::filesystem::path p_out_directory = out_directory;
-    unsigned int logs_processed = 0;
-    while (logs_processed < run_plans.size()) {
-        std::unique_lock<std::mutex> lock(log_export_queue_mutex);
+    std::unique_lock<std::mutex> lock(log_export_queue_mutex);
+    while (true) {
         log_export_queue_cdn.wait(lock, [this]{ return !log_export_queue.empty(); });
-        do {
-            // Pop item to be logged from queue
-            const unsigned int target_log = log_export_queue.front();
-            log_export_queue.pop();
+        const unsigned int target_log = log_export_queue.front();
+        // Check item isn't telling us to exit, it is left in the queue so that the other threads also exit
+        if (target_log == UINT_MAX) {
             lock.unlock();
-
-            // Check item isn't telling us to exit early
-            if (target_log == UINT_MAX) {
-                logs_processed = UINT_MAX;
-                break;
-            }
-            // Log items
-            if (export_exit) {
-                const std::filesystem::path exit_path = p_out_directory / std::filesystem::path(run_plans[target_log].getOutputSubdirectory()) / std::filesystem::path("exit." + out_format);
-                const auto exit_logger = io::LoggerFactory::createLogger(exit_path.generic_string(), false, false);
-                exit_logger->log(run_logs.at(target_log), run_plans[target_log], false, true, false, export_exit_time);
-            }
-            if (export_step) {
-                const std::filesystem::path step_path = p_out_directory/std::filesystem::path(run_plans[target_log].getOutputSubdirectory())/std::filesystem::path(std::to_string(target_log)+"."+out_format);
-                const auto step_logger = io::LoggerFactory::createLogger(step_path.generic_string(), false, true);
-                step_logger->log(run_logs.at(target_log), run_plans[target_log], true, false, export_step_time, false);
-            }
-            // Continue
-            ++logs_processed;
-            lock.lock();
-        } while (!log_export_queue.empty());
+            log_export_queue_cdn.notify_all();
+            return;
+        }
+        // Pop item to be logged from queue
+        metrics.total_queue_depth += log_export_queue.size();
+        metrics.max_queue_depth = std::max(metrics.max_queue_depth, static_cast<unsigned int>(log_export_queue.size()));
+        log_export_queue.pop();
+        // Map nodes are stable, so the log can be safely read after unlocking whilst runners add further logs
+        const RunLog &run_log = run_logs.at(target_log);
+        lock.unlock();
+        // Runners may be waiting for space in the queue
+        log_export_queue_cdn.notify_all();
+        SteadyClockTimer export_timer;
+        export_timer.start();
+        // Log items
+        if (export_exit) {
+            const std::filesystem::path exit_path = p_out_directory / std::filesystem::path(run_plans[target_log].getOutputSubdirectory()) / std::filesystem::path("exit." + out_format);
+            const auto exit_logger = io::LoggerFactory::createLogger(exit_path.generic_string(), false, false);
+            // Runs sharing an output subdirectory append to the same exit file
+            std::lock_guard<std::mutex> exit_lock(getExitFileMutex(exit_path.generic_string()));
+            exit_logger->log(run_log, run_plans[target_log], false, true, false, export_exit_time);
+        }
+        if (export_step) {
+            const std::filesystem::path step_path = p_out_directory/std::filesystem::path(run_plans[target_log].getOutputSubdirectory())/std::filesystem::path(std::to_string(target_log)+"."+out_format);
+            const auto step_logger = io::LoggerFactory::createLogger(step_path.generic_string(), false, true);
+            step_logger->log(run_log, run_plans[target_log], true, false, export_step_time, false);
+        }
+        export_timer.stop();
+        const double export_time = export_timer.getElapsedSeconds();
+        lock.lock();
+        ++metrics.exported_logs;
+        metrics.total_export_time += export_time;
+        metrics.max_export_time = std::max(metrics.max_export_time, export_time);
+        // Release the exported log, so memory is bounded by the backlog rather than the number of runs
+        if (evict_exported_logs) {
+            run_logs.erase(target_log);
+        }
     }
 }
 
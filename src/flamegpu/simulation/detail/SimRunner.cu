@@ -15,6 +15,7 @@ SimRunner::SimRunner(const std::shared_ptr<const ModelData> _model,
     std::atomic<unsigned int> &_err_ct,
     std::atomic<unsigned int> &_next_run,
     const RunPlanVector &_plans,
+    const std::vector<unsigned int> &_run_order,
     std::shared_ptr<const StepLoggingConfig> _step_log_config,
     std::shared_ptr<const LoggingConfig> _exit_log_config,
     int _device_id,
@@ -25,8 +26,10 @@ SimRunner::SimRunner(const std::shared_ptr<const ModelData> _model,
     std::queue<unsigned int> &_log_export_queue,
     std::mutex &_log_export_queue_mutex,
     std::condition_variable &_log_export_queue_cdn,
+    const unsigned int _max_log_export_backlog,
     std::vector<ErrorDetail> &_err_detail,
     const unsigned int _total_runners,
+    const bool _reuse_simulation,
     bool _isSWIG)
     : AbstractSimRunner(
         _model,
@@ -42,16 +45,20 @@ SimRunner::SimRunner(const std::shared_ptr<const ModelData> _model,
         _log_export_queue,
         _log_export_queue_mutex,
         _log_export_queue_cdn,
+        _max_log_export_backlog,
         _err_detail,
         _total_runners,
+        _reuse_simulation,
         _isSWIG)
-    , fail_fast(_fail_fast) { }
+    , fail_fast(_fail_fast)
+    , run_order(_run_order) { }
 
 
 void SimRunner::main() {
-    unsigned int run_id = 0;
+    unsigned int run_index = 0;
     // While there are still plans to process
-    while ((run_id = next_run++) < plans.size()) {
+    while ((run_index = next_run++) < plans.size()) {
+        const unsigned int run_id = run_order[run_index];
         try {
             runSimulation(run_id);
             // Print progress to console
@@ -74,6 +81,7 @@ void SimRunner::main() {
                     strncpy(err_detail.back().exception_string, e.what(), sizeof(ErrorDetail::exception_string)-1);
                     err_detail.back().exception_string[sizeof(ErrorDetail::exception_string) - 1] = '\0';
                 }
+                log_export_queue_cdn.notify_all();
                 return;
             } else {
                 // Progress flush
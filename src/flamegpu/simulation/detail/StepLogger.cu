@@ -0,0 +1,218 @@
+#include "flamegpu/simulation/detail/StepLogger.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "flamegpu/detail/cuda.cuh"
+#include "flamegpu/runtime/agent/DeviceAgentVector_impl.h"
+#include "flamegpu/simulation/detail/CUDAAgent.h"
+#include "flamegpu/simulation/detail/CUDAErrorChecking.cuh"
+#include "flamegpu/simulation/detail/CUDAScatter.cuh"
+#include "flamegpu/simulation/detail/EnvironmentManager.cuh"
+#include "flamegpu/simulation/detail/LogStatistics.cuh"
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace flamegpu {
+namespace detail {
+
+StepLogger::StepLogger(const StepLoggingConfig &config, const EnvironmentManager &_environment, const CUDAAgentMap &_agent_map, const int _device_id, const unsigned int frame_count)
+    : environment(_environment)
+    , agent_map(_agent_map)
+    , device_id(_device_id) {
+    // Build the layout of each frame
+    const auto &properties = environment.getPropertiesMap();
+    for (const auto &prop_name : config.environment) {
+        const auto &prop = properties.at(prop_name);
+        environment_properties.push_back({prop_name, prop.offset, environment_bytes, prop.length, prop.type, prop.elements});
+        environment_bytes += prop.length;
+    }
+    for (const auto &name_state : config.agents) {
+        AgentState state{name_state.first, {}, name_state.second.first, name_state.second.second};
+        // The set is ordered by variable name, so each variable's reductions are adjacent and share a single LogStatistics
+        for (const auto &name_reduction : *name_state.second.first) {
+            if (state.variables.empty() || state.variables.back().name != name_reduction.name) {
+                state.variables.push_back({name_reduction.name, name_reduction.statistics, statistics_bytes});
+                statistics_bytes += name_reduction.statistics->size;
+            }
+        }
+        agent_states.push_back(std::move(state));
+    }
+    // Allocate the frames
+    if (statistics_bytes) {
+        gpuErrchk(cudaMalloc(&d_statistics, statistics_bytes));
+    }
+    frames.resize(frame_count ? frame_count : 1);
+    for (auto &frame : frames) {
+        frame.environment.resize(environment_bytes);
+        frame.counts.resize(agent_states.size());
+        if (statistics_bytes) {
+            gpuErrchk(cudaMallocHost(&frame.h_statistics, statistics_bytes));
+        }
+        gpuErrchk(cudaEventCreateWithFlags(&frame.event, cudaEventDisableTiming));
+    }
+    thread = std::thread(&StepLogger::start, this);
+    // Attempt to name the thread
+#ifdef _MSC_VER
+    SetThreadDescription(thread.native_handle(), L"StepLogger");
+#else
+    pthread_setname_np(thread.native_handle(), "StepLogger");
+#endif
+}
+StepLogger::~StepLogger() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cdn.wait(lock, [this]{ return pending == 0; });
+        stop = true;
+    }
+    cdn.notify_all();
+    if (thread.joinable())
+        thread.join();
+    for (auto &frame : frames) {
+        if (frame.h_statistics) {
+            gpuErrchk(flamegpu::detail::cuda::cudaFreeHost(frame.h_statistics));
+        }
+        if (frame.event) {
+            gpuErrchk(cudaEventDestroy(frame.event));
+        }
+    }
+    if (d_statistics) {
+        gpuErrchk(flamegpu::detail::cuda::cudaFree(d_statistics));
+    }
+}
+void StepLogger::capture(const unsigned int step_count, const double step_time_seconds, CUDAScatter &scatter, const std::vector<cudaStream_t> &streams) {
+    const cudaStream_t stream = streams.at(0);
+    unsigned int frame_index;
+    {
+        // Wait for a free frame, if the background thread has fallen behind
+        std::unique_lock<std::mutex> lock(mutex);
+        cdn.wait(lock, [this]{ return pending < frames.size(); });
+        frame_index = next_capture;
+    }
+    Frame &frame = frames[frame_index];
+    frame.step_count = step_count;
+    frame.step_time = step_time_seconds;
+    // Environment properties are held on the host, so are copied immediately
+    const char *h_environment = static_cast<const char*>(environment.getHostBuffer());
+    for (const auto &prop : environment_properties) {
+        memcpy(frame.environment.data() + prop.offset, h_environment + prop.source_offset, prop.length);
+    }
+    // Enqueue the reductions of every agent state, followed by a single copy to the frame
+    for (size_t i = 0; i < agent_states.size(); ++i) {
+        const AgentState &state = agent_states[i];
+        CUDAAgent &cuda_agent = *agent_map.at(state.name.first);
+        // If the user has a DeviceAgentVector out, sync changes
+        std::shared_ptr<DeviceAgentVector_impl> population = cuda_agent.getPopulationVec(state.name.second);
+        if (population) {
+            population->syncChanges();
+        }
+        const unsigned int agent_count = cuda_agent.getStateSize(state.name.second);
+        frame.counts[i] = agent_count;
+        if (!agent_count || state.variables.empty()) {
+            continue;
+        }
+        size_t temp_bytes = 0;
+        for (const auto &variable : state.variables) {
+            temp_bytes = std::max(temp_bytes, variable.statistics->tempStorageBytes(agent_count));
+        }
+        auto &cub_temp = scatter.CubTemp(0);
+        cub_temp.resize(temp_bytes);
+        for (const auto &variable : state.variables) {
+            variable.statistics->reduce(cuda_agent.getStateVariablePtr(state.name.second, variable.name), agent_count,
+                d_statistics + variable.offset, cub_temp.getPtr(), temp_bytes, stream);
+        }
+    }
+    if (statistics_bytes) {
+        gpuErrchk(cudaMemcpyAsync(frame.h_statistics, d_statistics, statistics_bytes, cudaMemcpyDeviceToHost, stream));
+    }
+    gpuErrchk(cudaEventRecord(frame.event, stream));
+    // The reductions read agent data asynchronously, so work subsequently launched into any stream must not begin until they complete
+    for (size_t i = 1; i < streams.size(); ++i) {
+        gpuErrchk(cudaStreamWaitEvent(streams[i], frame.event, 0));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        next_capture = (next_capture + 1) % frames.size();
+        ++pending;
+    }
+    cdn.notify_all();
+}
+void StepLogger::collect(std::list<StepLogFrame> &step_log) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cdn.wait(lock, [this]{ return pending == 0; });
+    step_log.splice(step_log.end(), assembled);
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+void StepLogger::start() {
+    try {
+        gpuErrchk(cudaSetDevice(device_id));
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::current_exception();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cdn.wait(lock, [this]{ return pending || stop; });
+        if (!pending) {
+            return;
+        }
+        const Frame &frame = frames[(next_capture + frames.size() - pending) % frames.size()];
+        lock.unlock();
+        // The frame cannot be captured into again until pending is decremented, so it can be read without the lock
+        std::list<StepLogFrame> step_frame;
+        std::exception_ptr frame_error;
+        try {
+            gpuErrchk(cudaEventSynchronize(frame.event));
+            step_frame.push_back(assemble(frame));
+        } catch (...) {
+            frame_error = std::current_exception();
+        }
+        lock.lock();
+        assembled.splice(assembled.end(), step_frame);
+        if (frame_error && !error) {
+            error = frame_error;
+        }
+        --pending;
+        // Capture may be waiting for a free frame, or collect for the backlog to clear
+        cdn.notify_all();
+    }
+}
+StepLogFrame StepLogger::assemble(const Frame &frame) const {
+    std::map<std::string, detail::Any> environment_log;
+    for (const auto &prop : environment_properties) {
+        environment_log.emplace(prop.name, detail::Any(frame.environment.data() + prop.offset, prop.length, prop.type, prop.elements));
+    }
+    std::map<util::StringPair, std::pair<std::map<LoggingConfig::NameReductionFn, detail::Any>, unsigned int>> agents_log;
+    for (size_t i = 0; i < agent_states.size(); ++i) {
+        const AgentState &state = agent_states[i];
+        const unsigned int agent_count = frame.counts[i];
+        auto &agent_state_log = agents_log.emplace(state.name, std::make_pair(std::map<LoggingConfig::NameReductionFn, detail::Any>(), state.log_count ? agent_count : UINT_MAX)).first->second;
+        auto variable = state.variables.begin();
+        for (const auto &name_reduction : *state.reductions) {
+            if (variable->name != name_reduction.name) {
+                ++variable;
+            }
+            agent_state_log.first.emplace(name_reduction, agent_count
+                ? name_reduction.statistics->result(frame.h_statistics + variable->offset, name_reduction.reduction)
+                : name_reduction.statistics->emptyResult(name_reduction.reduction));
+        }
+    }
+    StepLogFrame rtn(std::move(environment_log), std::move(agents_log), frame.step_count);
+    rtn.step_time = frame.step_time;
+    return rtn;
+}
+
+}  // namespace detail
+}  // namespace flamegpu
@@ -16,7 +16,7 @@
 #pragma SWIG nowarn=384
 // Warning 451 Setting a const char * variable may leak memory. Fix is to use a std::string instead?
 #pragma SWIG nowarn=451
-// LoggingConfig.h:65: Function flamegpu::LoggingConfig::Any(ReductionFn) must have a return type. Ignored. This actually a typedef function pointer?
+// Function must have a return type. Ignored. Raised when SWIG parses a function pointer typedef as a function declaration
 #pragma SWIG nowarn=504
 
 
@@ -434,6 +434,8 @@ class FLAMEGPURuntimeException : public std::exception {
 %ignore flamegpu::AgentVector::getVariableType;
 %ignore flamegpu::AgentVector::getVariableMetaData;
 %ignore flamegpu::AgentVector::data;
+%ignore flamegpu::AgentVector::column;
+%ignore flamegpu::AgentVector::Column;
 
 %ignore flamegpu::VarOffsetStruct; // not required but defined in HostNewAgentAPI
 
@@ -521,6 +523,8 @@ class FLAMEGPURuntimeException : public std::exception {
     %rename (MessageBucket_CDescription) flamegpu::MessageBucket::CDescription;
 
     %rename (CUDAEnsembleConfig) flamegpu::CUDAEnsemble::EnsembleConfig;
+    %rename (CUDAEnsembleLogExportMetrics) flamegpu::CUDAEnsemble::LogExportMetrics;
+    %rename (CUDAEnsembleRunnerMetrics) flamegpu::CUDAEnsemble::RunnerMetrics;
 %feature("flatnested", ""); // flat nested off
 
 // Renames required for nvtx as it is a namespace not a class.
@@ -741,6 +745,9 @@ class ModelVis;
 %include "flamegpu/detail/TestSuiteTelemetry.h"
 // Expose jitifycache for override cache settings
 %ignore flamegpu::detail::JitifyCache::loadKernel;
+%ignore flamegpu::detail::JitifyCache::loadKernelAsync;
+%ignore flamegpu::detail::JitifyCache::exportBundle;
+%ignore flamegpu::detail::JitifyCache::KernelSource;
 %rename(JitifyCache) flamegpu::detail::JitifyCache;
 %include "flamegpu/detail/JitifyCache.h"
 // Ignore detail agian? 
@@ -897,6 +904,7 @@ class FLAMEGPUGraphMapIterator(object):
 
 %template(StepLogFrameList) std::list<flamegpu::StepLogFrame>;
 %template(RunLogMap) std::map<unsigned int, flamegpu::RunLog>;
+%template(CUDAEnsembleRunnerMetricsVector) std::vector<flamegpu::CUDAEnsemble::RunnerMetrics>;
  
 // Instantiate template versions of agent functions from the API
 TEMPLATE_VARIABLE_INSTANTIATE_ID(newVariable, flamegpu::AgentDescription::newVariable)
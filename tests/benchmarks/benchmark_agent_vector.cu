@@ -0,0 +1,118 @@
+/**
+ * Benchmarks of AgentVector, the host-side agent population container
+ *
+ * Benchmarks cover:
+ * > Setting and getting variables by index
+ * > Iterating the population
+ * > Growing the population with push_back()
+ */
+#include <array>
+
+#include "flamegpu/flamegpu.h"
+
+#include "benchmark/benchmark.h"
+
+namespace flamegpu {
+namespace benchmark_agent_vector {
+
+/**
+ * Returns an agent with a mix of scalar and array variables
+ */
+AgentDescription defineAgent(ModelDescription &model) {
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<float>("x");
+    agent.newVariable<float>("y");
+    agent.newVariable<float>("z");
+    agent.newVariable<int>("state", 1);
+    agent.newVariable<float, 3>("velocity", {1.0f, 2.0f, 3.0f});
+    return agent;
+}
+
+void BM_AgentVector_SetVariable(benchmark::State& state) {
+    ModelDescription model("model");
+    AgentDescription agent = defineAgent(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    AgentVector population(agent, count);
+    for (auto _ : state) {
+        for (unsigned int i = 0; i < count; ++i) {
+            AgentVector::Agent instance = population[i];
+            instance.setVariable<float>("x", static_cast<float>(i));
+            instance.setVariable<float>("y", static_cast<float>(i));
+            instance.setVariable<float>("z", static_cast<float>(i));
+            instance.setVariable<int>("state", static_cast<int>(i));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count * 4);
+}
+BENCHMARK(BM_AgentVector_SetVariable)->RangeMultiplier(10)->Range(1000, 100000);
+
+void BM_AgentVector_GetVariable(benchmark::State& state) {
+    ModelDescription model("model");
+    AgentDescription agent = defineAgent(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    const AgentVector population(agent, count);
+    for (auto _ : state) {
+        float sum = 0;
+        for (unsigned int i = 0; i < count; ++i) {
+            AgentVector::CAgent instance = population[i];
+            sum += instance.getVariable<float>("x") + instance.getVariable<float>("y") + instance.getVariable<float>("z");
+            sum += static_cast<float>(instance.getVariable<int>("state"));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count * 4);
+}
+BENCHMARK(BM_AgentVector_GetVariable)->RangeMultiplier(10)->Range(1000, 100000);
+
+void BM_AgentVector_GetArrayVariable(benchmark::State& state) {
+    ModelDescription model("model");
+    AgentDescription agent = defineAgent(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    const AgentVector population(agent, count);
+    for (auto _ : state) {
+        float sum = 0;
+        for (unsigned int i = 0; i < count; ++i) {
+            const std::array<float, 3> velocity = population[i].getVariable<float, 3>("velocity");
+            sum += velocity[0] + velocity[1] + velocity[2];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AgentVector_GetArrayVariable)->RangeMultiplier(10)->Range(1000, 100000);
+
+void BM_AgentVector_Iterate(benchmark::State& state) {
+    ModelDescription model("model");
+    AgentDescription agent = defineAgent(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    AgentVector population(agent, count);
+    for (auto _ : state) {
+        float sum = 0;
+        for (AgentVector::Agent instance : population) {
+            sum += instance.getVariable<float>("x");
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AgentVector_Iterate)->RangeMultiplier(10)->Range(1000, 100000);
+
+void BM_AgentVector_PushBack(benchmark::State& state) {
+    ModelDescription model("model");
+    AgentDescription agent = defineAgent(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        AgentVector population(agent);
+        for (unsigned int i = 0; i < count; ++i) {
+            population.push_back();
+            population.back().setVariable<float>("x", static_cast<float>(i));
+        }
+        benchmark::DoNotOptimize(population.data("x"));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AgentVector_PushBack)->RangeMultiplier(10)->Range(1000, 100000);
+
+}  // namespace benchmark_agent_vector
+}  // namespace flamegpu
@@ -0,0 +1,55 @@
+/**
+ * Benchmarks of CurveRTCHost, which generates the dynamic curve header for each runtime compiled agent function
+ *
+ * Benchmarks cover:
+ * > Dynamic header generation, for increasing numbers of agent variables and environment properties
+ *   The size of the generated header is reported, as it dominates the runtime compilation cost of each agent function
+ *
+ * @note CurveRTCHost allocates its data buffer in pinned host memory, so these benchmarks are skipped if no CUDA device is available
+ */
+#include <cuda_runtime.h>
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "flamegpu/runtime/detail/curve/curve_rtc.cuh"
+
+#include "benchmark/benchmark.h"
+
+namespace flamegpu {
+namespace benchmark_curve_rtc {
+
+void BM_CurveRTCHost_GetDynamicHeader(benchmark::State& state) {
+    int device_count = 0;
+    if (cudaGetDeviceCount(&device_count) != cudaSuccess || device_count == 0) {
+        cudaGetLastError();
+        state.SkipWithError("No CUDA device available");
+        return;
+    }
+    const int count = static_cast<int>(state.range(0));
+    std::vector<std::string> names;
+    for (int i = 0; i < count; ++i) {
+        names.push_back("variable" + std::to_string(i));
+    }
+    size_t header_bytes = 0;
+    for (auto _ : state) {
+        // The header's placeholders are replaced during generation, so a new instance is required each iteration
+        detail::curve::CurveRTCHost curve;
+        curve.registerAgent("agent", "default");
+        for (int i = 0; i < count; ++i) {
+            curve.registerAgentVariable(names[i].c_str(), typeid(float).name(), sizeof(float));
+            curve.registerMessageInVariable(names[i].c_str(), typeid(int).name(), sizeof(int));
+            curve.registerEnvVariable(names[i].c_str(), i * sizeof(double), typeid(double).name(), sizeof(double));
+        }
+        const std::string header = curve.getDynamicHeader(count * sizeof(double));
+        header_bytes = header.size();
+        benchmark::DoNotOptimize(header.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count * 3);
+    state.counters["header_bytes"] = static_cast<double>(header_bytes);
+}
+BENCHMARK(BM_CurveRTCHost_GetDynamicHeader)->RangeMultiplier(4)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmark_curve_rtc
+}  // namespace flamegpu
@@ -0,0 +1,86 @@
+/**
+ * Benchmarks of DependencyGraph, which generates a model's layers from the dependencies between its agent functions
+ *
+ * Benchmarks cover:
+ * > generateLayers() on synthetic DAGs of independent chains
+ * > generateLayers() on synthetic layered DAGs with dense dependencies
+ */
+#include <string>
+#include <vector>
+
+#include "flamegpu/flamegpu.h"
+
+#include "benchmark/benchmark.h"
+
+namespace flamegpu {
+namespace benchmark_dependency_graph {
+
+FLAMEGPU_AGENT_FUNCTION(agent_fn, MessageNone, MessageNone) {
+    return ALIVE;
+}
+
+/**
+ * Builds a DAG of chains independent chains, each of length agent functions, and generates its layers
+ * Each chain belongs to a distinct agent, so functions of different chains do not conflict
+ */
+void BM_DependencyGraph_Chains(benchmark::State& state) {
+    const int chains = static_cast<int>(state.range(0));
+    const int length = static_cast<int>(state.range(1));
+    for (auto _ : state) {
+        state.PauseTiming();
+        ModelDescription model("model");
+        for (int c = 0; c < chains; ++c) {
+            AgentDescription agent = model.newAgent("agent" + std::to_string(c));
+            AgentFunctionDescription previous = agent.newFunction("fn0", agent_fn);
+            model.addExecutionRoot(previous);
+            for (int i = 1; i < length; ++i) {
+                AgentFunctionDescription fn = agent.newFunction("fn" + std::to_string(i), agent_fn);
+                fn.dependsOn(previous);
+                previous = fn;
+            }
+        }
+        state.ResumeTiming();
+        model.generateLayers();
+    }
+    state.SetItemsProcessed(state.iterations() * chains * length);
+}
+BENCHMARK(BM_DependencyGraph_Chains)->Args({1, 100})->Args({10, 10})->Args({10, 100})->Args({100, 10})->Unit(benchmark::kMicrosecond);
+
+/**
+ * Builds a DAG of depth ranks, each of width agent functions, where every function depends on every function of the previous rank, and generates its layers
+ * Each function within a rank belongs to a distinct agent, so each rank may be placed within a single layer
+ */
+void BM_DependencyGraph_Dense(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int depth = static_cast<int>(state.range(1));
+    for (auto _ : state) {
+        state.PauseTiming();
+        ModelDescription model("model");
+        std::vector<AgentDescription> agents;
+        for (int w = 0; w < width; ++w) {
+            agents.push_back(model.newAgent("agent" + std::to_string(w)));
+        }
+        std::vector<AgentFunctionDescription> previous;
+        for (int d = 0; d < depth; ++d) {
+            std::vector<AgentFunctionDescription> rank;
+            for (int w = 0; w < width; ++w) {
+                AgentFunctionDescription fn = agents[w].newFunction("fn" + std::to_string(d), agent_fn);
+                if (d == 0) {
+                    model.addExecutionRoot(fn);
+                }
+                for (auto &dependency : previous) {
+                    fn.dependsOn(dependency);
+                }
+                rank.push_back(fn);
+            }
+            previous = rank;
+        }
+        state.ResumeTiming();
+        model.generateLayers();
+    }
+    state.SetItemsProcessed(state.iterations() * width * depth);
+}
+BENCHMARK(BM_DependencyGraph_Dense)->Args({4, 10})->Args({16, 10})->Args({16, 50})->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmark_dependency_graph
+}  // namespace flamegpu
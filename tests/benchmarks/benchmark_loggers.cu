@@ -0,0 +1,74 @@
+/**
+ * Benchmarks of the simulation log writers
+ *
+ * Benchmarks cover:
+ * > JSONLogger write throughput
+ * > XMLLogger write throughput
+ */
+#include <filesystem>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "flamegpu/flamegpu.h"
+#include "flamegpu/io/JSONLogger.h"
+#include "flamegpu/io/XMLLogger.h"
+
+#include "benchmark/benchmark.h"
+
+namespace flamegpu {
+namespace benchmark_loggers {
+
+/**
+ * Builds a synthetic RunLog of the requested number of steps
+ * Each step logs 3 environment properties and every reduction of 2 agent variables
+ * The log is constructed directly, so no simulation (or GPU) is required
+ */
+RunLog buildRunLog(const unsigned int steps) {
+    const LoggingConfig::Reduction reductions[] = {LoggingConfig::Mean, LoggingConfig::StandardDev, LoggingConfig::Min, LoggingConfig::Max, LoggingConfig::Sum};
+    std::list<StepLogFrame> step_log;
+    for (unsigned int i = 0; i < steps; ++i) {
+        std::map<std::string, detail::Any> environment;
+        environment.emplace("float_property", detail::Any(i * 0.5f));
+        environment.emplace("int_property", detail::Any(static_cast<int>(i)));
+        environment.emplace("double_property", detail::Any(i * 0.125));
+        std::map<LoggingConfig::NameReductionFn, detail::Any> reduced;
+        for (const auto &reduction : reductions) {
+            reduced.emplace(LoggingConfig::NameReductionFn{"x", reduction, nullptr}, detail::Any(i * 1.5));
+            reduced.emplace(LoggingConfig::NameReductionFn{"y", reduction, nullptr}, detail::Any(i * 2.5));
+        }
+        std::map<util::StringPair, std::pair<std::map<LoggingConfig::NameReductionFn, detail::Any>, unsigned int>> agents;
+        agents.emplace(util::StringPair{"agent", ModelData::DEFAULT_STATE}, std::make_pair(std::move(reduced), 1024u));
+        step_log.emplace_back(std::move(environment), std::move(agents), i);
+    }
+    return RunLog(ExitLogFrame(), step_log);
+}
+/**
+ * Writes a RunLog of state.range(0) steps to file, using LoggerT
+ */
+template<typename LoggerT>
+void writeRunLog(benchmark::State& state, const std::string &extension) {
+    const RunLog run_log = buildRunLog(static_cast<unsigned int>(state.range(0)));
+    const std::string path = (std::filesystem::temp_directory_path() / ("flamegpu_benchmark_log" + extension)).string();
+    for (auto _ : state) {
+        LoggerT logger(path, false, true);
+        logger.log(run_log, true, true, true, true, true);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(path)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(path);
+}
+
+void BM_JSONLogger_Write(benchmark::State& state) {
+    writeRunLog<io::JSONLogger>(state, ".json");
+}
+BENCHMARK(BM_JSONLogger_Write)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMillisecond);
+
+void BM_XMLLogger_Write(benchmark::State& state) {
+    writeRunLog<io::XMLLogger>(state, ".xml");
+}
+BENCHMARK(BM_XMLLogger_Write)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMillisecond);
+
+}  // namespace benchmark_loggers
+}  // namespace flamegpu
@@ -0,0 +1,60 @@
+/**
+ * Benchmarks of RunPlanVector, used to generate the runs of an ensemble
+ *
+ * Benchmarks cover:
+ * > Construction
+ * > Generating property values with each distribution
+ */
+#include "flamegpu/flamegpu.h"
+
+#include "benchmark/benchmark.h"
+
+namespace flamegpu {
+namespace benchmark_run_plan_vector {
+
+/**
+ * Defines a model with environment properties of several types
+ */
+void defineModel(ModelDescription &model) {
+    EnvironmentDescription env = model.Environment();
+    env.newProperty<float>("float_property", 0.0f);
+    env.newProperty<double>("double_property", 0.0);
+    env.newProperty<int>("int_property", 0);
+    env.newProperty<unsigned int>("uint_property", 0u);
+    env.newProperty<float, 4>("array_property", {0.0f, 0.0f, 0.0f, 0.0f});
+}
+
+void BM_RunPlanVector_Construct(benchmark::State& state) {
+    ModelDescription model("model");
+    defineModel(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        RunPlanVector plans(model, count);
+        benchmark::DoNotOptimize(plans.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RunPlanVector_Construct)->RangeMultiplier(10)->Range(100, 100000);
+
+void BM_RunPlanVector_Generate(benchmark::State& state) {
+    ModelDescription model("model");
+    defineModel(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        RunPlanVector plans(model, count);
+        plans.setRandomSimulationSeed(12, 1);
+        plans.setRandomPropertySeed(34);
+        plans.setSteps(100);
+        plans.setPropertyLerpRange<float>("float_property", 0.0f, 1.0f);
+        plans.setPropertyNormalRandom<double>("double_property", 0.0, 1.0);
+        plans.setPropertyUniformRandom<int>("int_property", -100, 100);
+        plans.setPropertyStep<unsigned int>("uint_property", 0u, 2u);
+        plans.setPropertyLogNormalRandom<float>("array_property", 2, 0.0f, 1.0f);
+        benchmark::DoNotOptimize(plans.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RunPlanVector_Generate)->RangeMultiplier(10)->Range(100, 100000);
+
+}  // namespace benchmark_run_plan_vector
+}  // namespace flamegpu
@@ -0,0 +1,100 @@
+/**
+ * Benchmarks of the agent population file readers
+ *
+ * Benchmarks cover:
+ * > JSONStateReader parse throughput
+ * > XMLStateReader parse throughput
+ * > tinyxml2 DOM load throughput, as a baseline for XMLStateReader (which previously loaded the full DOM prior to reading it)
+ */
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "flamegpu/flamegpu.h"
+#include "flamegpu/io/JSONStateReader.h"
+#include "flamegpu/io/XMLStateReader.h"
+#include "flamegpu/simulation/CPUSimulation.h"
+
+#include "tinyxml2/tinyxml2.h"
+#include "benchmark/benchmark.h"
+
+namespace flamegpu {
+namespace benchmark_state_readers {
+
+/**
+ * Defines a model with a single agent, with a mix of scalar and array variables
+ */
+void defineModel(ModelDescription &model) {
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<float>("x");
+    agent.newVariable<float>("y");
+    agent.newVariable<int>("state");
+    agent.newVariable<unsigned int, 3>("colour");
+}
+/**
+ * Exports a population file of state.range(0) agents, and times parse_file parsing it
+ * The file is exported once prior to timing, CPUSimulation is used so that no GPU is required
+ */
+template<typename ParseFn>
+void parsePopulation(benchmark::State& state, const std::string &extension, ParseFn parse_file) {
+    ModelDescription model("model");
+    defineModel(model);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    AgentVector population(model.Agent("agent"), count);
+    for (unsigned int i = 0; i < count; ++i) {
+        AgentVector::Agent instance = population[i];
+        instance.setVariable<float>("x", i * 0.5f);
+        instance.setVariable<float>("y", i * -0.25f);
+        instance.setVariable<int>("state", static_cast<int>(i % 7));
+        instance.setVariable<unsigned int, 3>("colour", {i, i + 1, i + 2});
+    }
+    CPUSimulation simulation(model);
+    simulation.SimulationConfig().truncate_log_files = true;
+    simulation.setPopulationData(population);
+    const std::string path = (std::filesystem::temp_directory_path() / ("flamegpu_benchmark_population" + extension)).string();
+    simulation.exportData(path, false);
+    const int64_t file_size = static_cast<int64_t>(std::filesystem::file_size(path));
+    // The readers require the model's internal representation
+    const std::shared_ptr<const ModelData> model_data = simulation.getModelDescription().clone();
+    for (auto _ : state) {
+        parse_file(path, model_data);
+    }
+    state.SetBytesProcessed(state.iterations() * file_size);
+    state.SetItemsProcessed(state.iterations() * count);
+    std::filesystem::remove(path);
+}
+/**
+ * Parses a population file of state.range(0) agents, using ReaderT
+ */
+template<typename ReaderT>
+void parsePopulation(benchmark::State& state, const std::string &extension) {
+    parsePopulation(state, extension, [](const std::string &path, const std::shared_ptr<const ModelData> &model_data) {
+        ReaderT reader;
+        reader.parse(path, model_data, Verbosity::Quiet);
+    });
+}
+
+void BM_JSONStateReader_Parse(benchmark::State& state) {
+    parsePopulation<io::JSONStateReader>(state, ".json");
+}
+BENCHMARK(BM_JSONStateReader_Parse)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+void BM_XMLStateReader_Parse(benchmark::State& state) {
+    parsePopulation<io::XMLStateReader>(state, ".xml");
+}
+BENCHMARK(BM_XMLStateReader_Parse)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+void BM_TinyXML2_LoadFile(benchmark::State& state) {
+    parsePopulation(state, ".xml", [](const std::string &path, const std::shared_ptr<const ModelData> &) {
+        tinyxml2::XMLDocument doc;
+        if (doc.LoadFile(path.c_str()) != tinyxml2::XML_SUCCESS) {
+            THROW exception::TinyXMLError("Failed to load '%s'\n", path.c_str());
+        }
+        benchmark::DoNotOptimize(doc.FirstChild());
+    });
+}
+BENCHMARK(BM_TinyXML2_LoadFile)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+}  // namespace benchmark_state_readers
+}  // namespace flamegpu
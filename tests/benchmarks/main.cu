@@ -0,0 +1,38 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "flamegpu/io/Telemetry.h"
+
+/**
+ * Runs the host-side benchmark suite
+ * Unless --benchmark_out is specified, results are additionally written as JSON to benchmark_results.json in the working directory,
+ * so that regressions can be detected by comparing the results of two runs (e.g. with google benchmark's tools/compare.py)
+ */
+int main(int argc, char **argv) {
+    // Disable telemetry for simulation objects in the benchmark suite.
+    flamegpu::io::Telemetry::disable();
+    // Suppress the notice about telemetry.
+    flamegpu::io::Telemetry::suppressNotice();
+    // Default to machine readable output, if the user has not requested an output file
+    std::vector<char*> args(argv, argv + argc);
+    std::string out_arg = "--benchmark_out=benchmark_results.json";
+    std::string out_format_arg = "--benchmark_out_format=json";
+    bool has_out = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--benchmark_out=", strlen("--benchmark_out=")) == 0)
+            has_out = true;
+    }
+    if (!has_out) {
+        args.push_back(&out_arg[0]);
+        args.push_back(&out_format_arg[0]);
+    }
+    int args_count = static_cast<int>(args.size());
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -413,32 +413,32 @@ class DependencyGraphTest(TestCase):
         expectedLayers = '''--------------------
 Layer 0
 --------------------
-Function1
+HostFn1
 
 --------------------
 Layer 1
 --------------------
-HostFn1
+Function1
 
 --------------------
 Layer 2
 --------------------
-Function2
+Function3
 
 --------------------
 Layer 3
 --------------------
-Function3
+Function2
 
 --------------------
 Layer 4
 --------------------
-Function4
+HostFn2
 
 --------------------
 Layer 5
 --------------------
-HostFn2
+Function4
 
 --------------------
 Layer 6
@@ -472,27 +472,23 @@ sub
         expectedLayers = '''--------------------
 Layer 0
 --------------------
-Function3
-
---------------------
-Layer 1
---------------------
 HostFn1
 
 --------------------
-Layer 2
+Layer 1
 --------------------
+Function3
 Function1
 Function2
 
 --------------------
-Layer 3
+Layer 2
 --------------------
 HostFn2
 
 '''
         assert expectedLayers == _m.getConstructedLayersString()
-        assert _m.getLayersCount() == 4
+        assert _m.getLayersCount() == 3
 
     def test_InterModelDependency(self):
         _m = pyflamegpu.ModelDescription(MODEL_NAME)
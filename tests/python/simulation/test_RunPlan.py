@@ -68,6 +68,18 @@ class TestRunPlan(TestCase):
         # By default this is an empty string
         assert updatedSubdir == newSubdir
 
+    def test_setCost(self):
+        model = pyflamegpu.ModelDescription("test")
+        plan = pyflamegpu.RunPlan(model)
+        # By default the cost is unset
+        assert plan.getCost() == 0.0
+        plan.setCost(12.5)
+        assert plan.getCost() == 12.5
+        # Negative costs are invalid
+        with pytest.raises(pyflamegpu.FLAMEGPURuntimeException) as e:
+            plan.setCost(-1.0)
+        assert e.value.type() == "InvalidArgument"
+
     def test_setProperty(self):
         # Create a model
         model = pyflamegpu.ModelDescription("test")
@@ -0,0 +1,157 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "flamegpu/detail/DiskCache.h"
+
+#include "gtest/gtest.h"
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+namespace flamegpu {
+namespace {
+/**
+ * Creates an empty directory for the duration of a test
+ */
+class TempDirectory {
+ public:
+    explicit TempDirectory(const std::string &name)
+        : path(std::filesystem::temp_directory_path() / name) {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~TempDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+    std::string str() const { return path.string(); }
+    const std::filesystem::path path;
+};
+}  // namespace
+
+TEST(TestDiskCache, StoreLoad) {
+    TempDirectory dir("flamegpu_test_DiskCache_StoreLoad");
+    detail::DiskCache cache(dir.str());
+    std::string value;
+    EXPECT_FALSE(cache.load("a", "ref_a", value));
+    cache.store("a", "ref_a", "value_a");
+    cache.store("b", "ref_b", std::string("value\0b", 7));
+    EXPECT_EQ(cache.getEntryCount(), 2u);
+    EXPECT_TRUE(cache.load("a", "ref_a", value));
+    EXPECT_EQ(value, "value_a");
+    EXPECT_TRUE(cache.load("b", "ref_b", value));
+    EXPECT_EQ(value, std::string("value\0b", 7));
+    // Replacing a value does not add an entry
+    cache.store("a", "ref_a", "value_a2");
+    EXPECT_EQ(cache.getEntryCount(), 2u);
+    EXPECT_TRUE(cache.load("a", "ref_a", value));
+    EXPECT_EQ(value, "value_a2");
+}
+TEST(TestDiskCache, ReferenceMismatch) {
+    TempDirectory dir("flamegpu_test_DiskCache_ReferenceMismatch");
+    detail::DiskCache cache(dir.str());
+    cache.store("a", "ref_a", "value_a");
+    std::string value = "unchanged";
+    EXPECT_FALSE(cache.load("a", "ref_b", value));
+    EXPECT_FALSE(cache.load("a", "ref_", value));
+    EXPECT_EQ(value, "unchanged");
+}
+TEST(TestDiskCache, Persistence) {
+    TempDirectory dir("flamegpu_test_DiskCache_Persistence");
+    {
+        detail::DiskCache cache(dir.str());
+        cache.store("a", "ref_a", "value_a");
+    }
+    detail::DiskCache cache(dir.str());
+    std::string value;
+    EXPECT_TRUE(cache.load("a", "ref_a", value));
+    EXPECT_EQ(value, "value_a");
+}
+TEST(TestDiskCache, Clear) {
+    TempDirectory dir("flamegpu_test_DiskCache_Clear");
+    detail::DiskCache cache(dir.str());
+    cache.store("a", "ref_a", "value_a");
+    cache.clear();
+    std::string value;
+    EXPECT_FALSE(cache.load("a", "ref_a", value));
+    EXPECT_EQ(cache.getEntryCount(), 0u);
+    EXPECT_EQ(cache.getSize(), 0u);
+}
+TEST(TestDiskCache, EvictLeastRecentlyUsed) {
+    TempDirectory dir("flamegpu_test_DiskCache_EvictLeastRecentlyUsed");
+    const std::string payload(1000, 'x');
+    // Room for 4 records, compaction retains 3/4 of the limit
+    detail::DiskCache cache(dir.str(), 4200);
+    cache.store("0", "", payload);
+    cache.store("1", "", payload);
+    cache.store("2", "", payload);
+    cache.store("3", "", payload);
+    EXPECT_EQ(cache.getEntryCount(), 4u);
+    std::string value;
+    // Use 0, so that 1 is the least recently used
+    EXPECT_TRUE(cache.load("0", "", value));
+    cache.store("4", "", payload);
+    EXPECT_LE(cache.getSize(), 4200u);
+    EXPECT_FALSE(cache.load("1", "", value));
+    EXPECT_TRUE(cache.load("0", "", value));
+    EXPECT_TRUE(cache.load("4", "", value));
+    EXPECT_EQ(value, payload);
+    // Values larger than the limit are not stored
+    cache.store("5", "", std::string(5000, 'y'));
+    EXPECT_FALSE(cache.load("5", "", value));
+    // Lowering the limit applies on the next store
+    cache.setSizeLimit(2100);
+    EXPECT_EQ(cache.getSizeLimit(), 2100u);
+    cache.store("6", "", payload);
+    EXPECT_LE(cache.getSize(), 2100u);
+    EXPECT_TRUE(cache.load("6", "", value));
+}
+TEST(TestDiskCache, ManyEntries) {
+    TempDirectory dir("flamegpu_test_DiskCache_ManyEntries");
+    detail::DiskCache cache(dir.str());
+    // Exceeds the initial table's capacity, so the table must grow
+    for (int i = 0; i < 2000; ++i) {
+        cache.store(std::to_string(i), "ref", std::to_string(i * 3));
+    }
+    EXPECT_EQ(cache.getEntryCount(), 2000u);
+    std::string value;
+    for (int i = 0; i < 2000; ++i) {
+        ASSERT_TRUE(cache.load(std::to_string(i), "ref", value));
+        EXPECT_EQ(value, std::to_string(i * 3));
+    }
+}
+TEST(TestDiskCache, CorruptStore) {
+    TempDirectory dir("flamegpu_test_DiskCache_CorruptStore");
+    {
+        std::ofstream out(dir.path / detail::DiskCache::STORE_FILE, std::ios::binary);
+        out << "not a valid store";
+    }
+    detail::DiskCache cache(dir.str());
+    std::string value;
+    EXPECT_FALSE(cache.load("a", "ref_a", value));
+    // Store is replaced
+    cache.store("a", "ref_a", "value_a");
+    EXPECT_TRUE(cache.load("a", "ref_a", value));
+    EXPECT_EQ(value, "value_a");
+}
+#ifndef _MSC_VER
+TEST(TestDiskCache, LoadWhilstSharedLocked) {
+    TempDirectory dir("flamegpu_test_DiskCache_LoadWhilstSharedLocked");
+    detail::DiskCache cache(dir.str());
+    cache.store("a", "ref_a", "value_a");
+    // Another process looking up a value holds the lock shared, this must not block lookups
+    const int fd = open((dir.path / detail::DiskCache::LOCK_FILE).string().c_str(), O_RDWR | O_CREAT, 0666);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(flock(fd, LOCK_SH), 0);
+    std::string value;
+    EXPECT_TRUE(cache.load("a", "ref_a", value));
+    EXPECT_EQ(value, "value_a");
+    EXPECT_EQ(cache.getEntryCount(), 1u);
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+#endif
+}  // namespace flamegpu
@@ -0,0 +1,132 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "flamegpu/detail/ThreadPool.h"
+
+#include "gtest/gtest.h"
+namespace flamegpu {
+
+TEST(TestThreadPool, ThreadCount) {
+    detail::ThreadPool pool(3);
+    EXPECT_EQ(pool.getThreadCount(), 3u);
+    detail::ThreadPool default_pool;
+    EXPECT_GE(default_pool.getThreadCount(), 1u);
+}
+TEST(TestThreadPool, Submit) {
+    detail::ThreadPool pool(2);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i]() { return i * 2; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(results[i].get(), i * 2);
+    }
+}
+TEST(TestThreadPool, SubmitException) {
+    detail::ThreadPool pool(2);
+    auto result = pool.submit([]() -> int { throw std::runtime_error("test"); });
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+TEST(TestThreadPool, ParallelFor) {
+    detail::ThreadPool pool(4);
+    const size_t LEN = 100000;
+    std::vector<unsigned int> visits(LEN, 0);
+    pool.parallelFor(0, LEN, 0, [&visits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            ++visits[i];
+    });
+    // Every index is visited exactly once
+    for (size_t i = 0; i < LEN; ++i) {
+        ASSERT_EQ(visits[i], 1u);
+    }
+    // Explicit grain, with a range which does not divide evenly
+    std::atomic<size_t> total = {0};
+    pool.parallelFor(5, 1000, 7, [&total](size_t begin, size_t end) {
+        EXPECT_LE(end - begin, 7u);
+        total += end - begin;
+    });
+    EXPECT_EQ(total.load(), 995u);
+    // Empty range does not call body
+    pool.parallelFor(10, 10, 0, [](size_t, size_t) { FAIL(); });
+}
+TEST(TestThreadPool, ParallelForNoWorkers) {
+    // A pool with 0 threads would use hardware concurrency, so instead check the inline path with a single chunk
+    detail::ThreadPool pool(1);
+    int calls = 0;
+    pool.parallelFor(0, 10, 10, [&calls](size_t begin, size_t end) {
+        ++calls;
+        EXPECT_EQ(begin, 0u);
+        EXPECT_EQ(end, 10u);
+    });
+    EXPECT_EQ(calls, 1);
+}
+TEST(TestThreadPool, ParallelForNested) {
+    detail::ThreadPool pool(2);
+    std::atomic<unsigned int> total = {0};
+    // Nested use from within a task must not deadlock, as waiting threads execute pending tasks
+    pool.parallelFor(0, 16, 1, [&](size_t, size_t) {
+        pool.parallelFor(0, 100, 10, [&](size_t begin, size_t end) {
+            total += static_cast<unsigned int>(end - begin);
+        });
+    });
+    EXPECT_EQ(total.load(), 1600u);
+}
+TEST(TestThreadPool, SubmitNestedParallelFor) {
+    // Tasks submitted to the pool may themselves use parallelFor(), as done by dataflow execution
+    // With a single worker, the worker must execute the chunks of its own parallelFor() and the caller contributes via runPendingTask()
+    detail::ThreadPool pool(1);
+    std::atomic<unsigned int> total = {0};
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < 8; ++i) {
+        results.push_back(pool.submit([&pool, &total]() {
+            pool.parallelFor(0, 100, 10, [&total](size_t begin, size_t end) {
+                total += static_cast<unsigned int>(end - begin);
+            });
+        }));
+    }
+    for (auto &r : results) {
+        while (r.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!pool.runPendingTask())
+                std::this_thread::yield();
+        }
+        r.get();
+    }
+    EXPECT_EQ(total.load(), 800u);
+}
+TEST(TestThreadPool, SubmitFromTask) {
+    detail::ThreadPool pool(2);
+    // A task may submit further tasks, and wait on them by executing pending tasks
+    auto result = pool.submit([&pool]() {
+        std::vector<std::future<int>> inner;
+        for (int i = 0; i < 16; ++i) {
+            inner.push_back(pool.submit([i]() { return i; }));
+        }
+        int sum = 0;
+        for (auto &f : inner) {
+            while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                if (!pool.runPendingTask())
+                    std::this_thread::yield();
+            }
+            sum += f.get();
+        }
+        return sum;
+    });
+    EXPECT_EQ(result.get(), 120);
+}
+TEST(TestThreadPool, ParallelForException) {
+    detail::ThreadPool pool(2);
+    std::atomic<unsigned int> completed = {0};
+    EXPECT_THROW(pool.parallelFor(0, 64, 1, [&completed](size_t begin, size_t) {
+        if (begin == 13)
+            throw std::runtime_error("test");
+        ++completed;
+    }), std::runtime_error);
+    // All other chunks still complete before the exception is rethrown
+    EXPECT_EQ(completed.load(), 63u);
+}
+}  // namespace flamegpu
@@ -0,0 +1,203 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flamegpu/flamegpu.h"
+#include "flamegpu/detail/DiskCache.h"
+#include "flamegpu/detail/JitifyCache.h"
+#include "gtest/gtest.h"
+
+namespace flamegpu {
+
+namespace test_jitify_cache {
+const char *MODEL_NAME = "Model";
+const char *AGENT_NAME = "Agent";
+const unsigned int AGENT_COUNT = 128;
+const unsigned int FUNCTION_COUNT = 6;
+/**
+ * Each generated function adds a unique constant, so that every kernel has a unique source
+ */
+std::string rtc_AddFn(unsigned int i) {
+    return "FLAMEGPU_AGENT_FUNCTION(AddFn" + std::to_string(i) + ", flamegpu::MessageNone, flamegpu::MessageNone) {\n"
+        "    FLAMEGPU->setVariable<unsigned int>(\"x\", FLAMEGPU->getVariable<unsigned int>(\"x\") + " + std::to_string(i + 1) + "u);\n"
+        "    return flamegpu::ALIVE;\n"
+        "}\n";
+}
+const char *rtc_BrokenFn = R"###(
+FLAMEGPU_AGENT_FUNCTION(BrokenFn, flamegpu::MessageNone, flamegpu::MessageNone) {
+    FLAMEGPU->setVariable<unsigned int>("x", not_declared);
+    return flamegpu::ALIVE;
+}
+)###";
+/**
+ * Disables both caches for the lifetime of the object, so that kernels must be compiled
+ */
+class ScopedNoCache {
+ public:
+    ScopedNoCache()
+        : jitify(detail::JitifyCache::getInstance())
+        , memory(jitify.useMemoryCache())
+        , disk(jitify.useDiskCache()) {
+        jitify.useMemoryCache(false);
+        jitify.useDiskCache(false);
+    }
+    ~ScopedNoCache() {
+        jitify.useMemoryCache(memory);
+        jitify.useDiskCache(disk);
+    }
+
+ private:
+    detail::JitifyCache &jitify;
+    const bool memory;
+    const bool disk;
+};
+void buildModel(ModelDescription &model, bool broken = false) {
+    AgentDescription agent = model.newAgent(AGENT_NAME);
+    agent.newVariable<unsigned int>("x", 0);
+    for (unsigned int i = 0; i < FUNCTION_COUNT; ++i) {
+        AgentFunctionDescription fn = agent.newRTCFunction("AddFn" + std::to_string(i), rtc_AddFn(i).c_str());
+        model.newLayer().addAgentFunction(fn);
+    }
+    if (broken) {
+        AgentFunctionDescription fn = agent.newRTCFunction("BrokenFn", rtc_BrokenFn);
+        model.newLayer().addAgentFunction(fn);
+    }
+}
+void runModel(ModelDescription &model) {
+    AgentVector pop(model.Agent(AGENT_NAME), AGENT_COUNT);
+    CUDASimulation sim(model);
+    sim.SimulationConfig().steps = 1;
+    sim.setPopulationData(pop);
+    sim.simulate();
+    sim.getPopulationData(pop);
+    // Sum of 1..FUNCTION_COUNT
+    const unsigned int expected = FUNCTION_COUNT * (FUNCTION_COUNT + 1) / 2;
+    for (const auto &a : pop) {
+        ASSERT_EQ(a.getVariable<unsigned int>("x"), expected);
+    }
+}
+}  // namespace test_jitify_cache
+
+TEST(TestJitifyCache, CompileThreadCount) {
+    detail::JitifyCache &jitify = detail::JitifyCache::getInstance();
+    const unsigned int original = jitify.getCompileThreadCount();
+    jitify.setCompileThreadCount(2);
+    EXPECT_EQ(jitify.getCompileThreadCount(), 2u);
+    jitify.setCompileThreadCount(original);
+    EXPECT_EQ(jitify.getCompileThreadCount(), original);
+}
+TEST(TestJitifyCache, DiskCacheSizeLimit) {
+    detail::JitifyCache &jitify = detail::JitifyCache::getInstance();
+    const uint64_t original = jitify.getDiskCacheSizeLimit();
+    EXPECT_EQ(original, detail::DiskCache::DEFAULT_SIZE_LIMIT);
+    jitify.setDiskCacheSizeLimit(1024 * 1024);
+    EXPECT_EQ(jitify.getDiskCacheSizeLimit(), 1024u * 1024u);
+    jitify.setDiskCacheSizeLimit(original);
+    EXPECT_EQ(jitify.getDiskCacheSizeLimit(), original);
+}
+TEST(TestJitifyCache, ParallelCompilation) {
+    test_jitify_cache::ScopedNoCache no_cache;
+    const uint64_t compile_count = detail::JitifyCache::getInstance().getCompileCount();
+    ModelDescription model(test_jitify_cache::MODEL_NAME);
+    test_jitify_cache::buildModel(model);
+    test_jitify_cache::runModel(model);
+    // With both caches disabled, every kernel is compiled
+    EXPECT_GE(detail::JitifyCache::getInstance().getCompileCount() - compile_count, test_jitify_cache::FUNCTION_COUNT);
+}
+TEST(TestJitifyCache, SerialCompilation) {
+    test_jitify_cache::ScopedNoCache no_cache;
+    detail::JitifyCache &jitify = detail::JitifyCache::getInstance();
+    const unsigned int original = jitify.getCompileThreadCount();
+    jitify.setCompileThreadCount(1);
+    ModelDescription model(test_jitify_cache::MODEL_NAME);
+    test_jitify_cache::buildModel(model);
+    test_jitify_cache::runModel(model);
+    jitify.setCompileThreadCount(original);
+}
+TEST(TestJitifyCache, ConcurrentIdenticalRequests) {
+    // Simulations of the same model request identical kernels, these are shared rather than compiled twice
+    // The memory cache remains enabled, so that requests which do not overlap are also not compiled again
+    detail::JitifyCache &jitify = detail::JitifyCache::getInstance();
+    const bool disk = jitify.useDiskCache();
+    jitify.useDiskCache(false);
+    jitify.clearMemoryCache();
+    const uint64_t compile_count = jitify.getCompileCount();
+    ModelDescription model(test_jitify_cache::MODEL_NAME);
+    test_jitify_cache::buildModel(model);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&model]() { test_jitify_cache::runModel(model); });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    jitify.useDiskCache(disk);
+    // Each distinct kernel is compiled exactly once, regardless of how many simulations requested it
+    EXPECT_EQ(jitify.getCompileCount() - compile_count, test_jitify_cache::FUNCTION_COUNT);
+}
+TEST(TestJitifyCache, CompilationError) {
+    test_jitify_cache::ScopedNoCache no_cache;
+    ModelDescription model(test_jitify_cache::MODEL_NAME);
+    test_jitify_cache::buildModel(model, true);
+    AgentVector pop(model.Agent(test_jitify_cache::AGENT_NAME), test_jitify_cache::AGENT_COUNT);
+    CUDASimulation sim(model);
+    sim.SimulationConfig().steps = 1;
+    sim.setPopulationData(pop);
+    EXPECT_THROW(sim.simulate(), exception::InvalidAgentFunc);
+    // Failed compilations are not retained, so the broken kernel is compiled (and fails) again
+    CUDASimulation sim2(model);
+    sim2.SimulationConfig().steps = 1;
+    sim2.setPopulationData(pop);
+    EXPECT_THROW(sim2.simulate(), exception::InvalidAgentFunc);
+}
+TEST(TestJitifyCache, RTCBundle) {
+    const char *BUNDLE_FILE = "test_jitify_cache_bundle.bin";
+    detail::JitifyCache &jitify = detail::JitifyCache::getInstance();
+    ModelDescription model(test_jitify_cache::MODEL_NAME);
+    test_jitify_cache::buildModel(model);
+    {
+        CUDASimulation sim(model);
+        sim.exportRTCBundle(BUNDLE_FILE);
+    }
+    ASSERT_TRUE(std::filesystem::exists(BUNDLE_FILE));
+    jitify.clearBundles();
+    EXPECT_EQ(jitify.loadBundle(BUNDLE_FILE), test_jitify_cache::FUNCTION_COUNT);
+    // A bundle is only loaded once
+    EXPECT_EQ(jitify.loadBundle(BUNDLE_FILE), 0u);
+    jitify.clearBundles();
+    {
+        // Kernels come from the bundle, even with both caches disabled
+        test_jitify_cache::ScopedNoCache no_cache;
+        const uint64_t compile_count = jitify.getCompileCount();
+        AgentVector pop(model.Agent(test_jitify_cache::AGENT_NAME), test_jitify_cache::AGENT_COUNT);
+        CUDASimulation sim(model);
+        sim.CUDAConfig().rtc_bundle = BUNDLE_FILE;
+        sim.SimulationConfig().steps = 1;
+        sim.setPopulationData(pop);
+        sim.simulate();
+        sim.getPopulationData(pop);
+        const unsigned int expected = test_jitify_cache::FUNCTION_COUNT * (test_jitify_cache::FUNCTION_COUNT + 1) / 2;
+        for (const auto &a : pop) {
+            ASSERT_EQ(a.getVariable<unsigned int>("x"), expected);
+        }
+        // No kernels were compiled
+        EXPECT_EQ(jitify.getCompileCount(), compile_count);
+    }
+    jitify.clearBundles();
+    std::filesystem::remove(BUNDLE_FILE);
+}
+TEST(TestJitifyCache, RTCBundleInvalid) {
+    const char *BUNDLE_FILE = "test_jitify_cache_bundle_invalid.bin";
+    detail::JitifyCache &jitify = detail::JitifyCache::getInstance();
+    EXPECT_THROW(jitify.loadBundle("does_not_exist.bin"), exception::InvalidFilePath);
+    {
+        std::ofstream out(BUNDLE_FILE, std::ofstream::binary);
+        out << "not a bundle";
+    }
+    EXPECT_THROW(jitify.loadBundle(BUNDLE_FILE), exception::InvalidInputFile);
+    std::filesystem::remove(BUNDLE_FILE);
+}
+
+}  // namespace flamegpu
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include "flamegpu/detail/philox.cuh"
+
+#include "gtest/gtest.h"
+namespace flamegpu {
+
+// Known answer tests from the Random123 distribution (kat_vectors), philox4x32 with 10 rounds
+TEST(TestPhilox, KnownAnswers) {
+    auto check = [](const detail::Philox::Block ctr, const uint64_t key, const detail::Philox::Block expected) {
+        const detail::Philox::Block result = detail::Philox::generate(ctr, key);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(result.v[i], expected.v[i]);
+        }
+    };
+    check({{0, 0, 0, 0}}, 0, {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}});
+    check({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}, 0xffffffffffffffffull, {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}});
+    check({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}, 0x299f31d0a4093822ull, {{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}});
+}
+TEST(TestPhilox, Stateless) {
+    // The same key and subject always produce the same sequence
+    const detail::PhiloxKey key = {12, 3, 4};
+    detail::Philox a(key, 7);
+    detail::Philox b(key, 7);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(a.next(), b.next());
+    }
+    // The sequence is the concatenation of the blocks of successive counters
+    detail::Philox c(key, 7);
+    for (uint32_t i = 0; i < 10; ++i) {
+        const detail::Philox::Block block = detail::Philox::generate({{i, 7, 3, 4}}, 12);
+        for (int j = 0; j < 4; ++j) {
+            EXPECT_EQ(c.next(), block.v[j]);
+        }
+    }
+}
+TEST(TestPhilox, SetSubject) {
+    // AgentRandom only sets the subject once the first number is drawn, this must match constructing with the subject
+    const detail::PhiloxKey key = {12, 3, 4};
+    detail::Philox a(key, 7);
+    detail::Philox b(key, 0);
+    b.setSubject(7);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(a.next(), b.next());
+    }
+}
+TEST(TestPhilox, IndependentStreams) {
+    // Changing any component of the key, or the subject, changes the sequence
+    const detail::PhiloxKey key = {12, 3, 4};
+    std::set<uint32_t> first_draws;
+    for (const detail::PhiloxKey k : {key, detail::PhiloxKey{13, 3, 4}, detail::PhiloxKey{12, 4, 4}, detail::PhiloxKey{12, 3, 5}}) {
+        for (uint32_t subject = 0; subject < 4; ++subject) {
+            detail::Philox p(k, subject);
+            first_draws.insert(p.next());
+        }
+    }
+    EXPECT_EQ(first_draws.size(), 16u);
+}
+TEST(TestPhilox, Distributions) {
+    detail::Philox p({1, 0, 0}, 0);
+    const unsigned int N = 100000;
+    double uniform_float = 0, uniform_double = 0, normal_float = 0, normal_double = 0, normal_sq = 0, poisson_small = 0, poisson_large = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+        const float uf = p.uniformFloat();
+        ASSERT_GE(uf, 0.0f);
+        ASSERT_LT(uf, 1.0f);
+        uniform_float += uf;
+        const double ud = p.uniformDouble();
+        ASSERT_GE(ud, 0.0);
+        ASSERT_LT(ud, 1.0);
+        uniform_double += ud;
+        const float nf = p.normalFloat();
+        ASSERT_TRUE(std::isfinite(nf));
+        normal_float += nf;
+        const double nd = p.normalDouble();
+        normal_double += nd;
+        normal_sq += nd * nd;
+        poisson_small += p.poisson(3.5);
+        poisson_large += p.poisson(40.0);
+    }
+    EXPECT_NEAR(uniform_float / N, 0.5, 0.01);
+    EXPECT_NEAR(uniform_double / N, 0.5, 0.01);
+    EXPECT_NEAR(normal_float / N, 0.0, 0.02);
+    EXPECT_NEAR(normal_double / N, 0.0, 0.02);
+    EXPECT_NEAR(normal_sq / N, 1.0, 0.02);
+    EXPECT_NEAR(poisson_small / N, 3.5, 0.05);
+    EXPECT_NEAR(poisson_large / N, 40.0, 0.2);
+    EXPECT_EQ(p.poisson(0), 0u);
+}
+
+}  // namespace flamegpu
@@ -703,6 +703,147 @@ TEST(IOTest2, AgentID_FileInput_IDCollision) {
     // Cleanup
     ASSERT_EQ(::remove(JSON_FILE_NAME), 0);
 }
+TEST(IOTest2, JSON_StreamLargePopulation) {
+    // The JSON reader streams the file and parses agents in chunks, check populations larger than it's read buffer and chunk size are loaded intact
+    const unsigned int AGENT_COUNT = 20000;
+    {
+        std::ofstream myfile(JSON_FILE_NAME, std::ofstream::out | std::ofstream::trunc);
+        myfile << "{\"config\":{\"simulation\":{\"steps\":7}},\"agents\":{\"agent\":{\"a\":[";
+        for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+            myfile << (i ? "," : "") << "{\"x\":" << i << ",\"y\":[" << i << "," << i + 1 << "]}";
+        }
+        myfile << "],\"b\":[{\"x\":12,\"y\":[1,2]}]}}}";
+    }
+    ModelDescription model("test_stream");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newState("a");
+    agent.newState("b");
+    agent.newVariable<unsigned int>("x", 0);
+    agent.newVariable<unsigned int, 2>("y", {0, 0});
+    model.newLayer().addHostFunction(DoNothing);
+    {
+        CUDASimulation sim(model);
+        sim.SimulationConfig().input_file = JSON_FILE_NAME;
+        EXPECT_NO_THROW(sim.applyConfig());
+        EXPECT_EQ(sim.getSimulationConfig().steps, 7u);
+        AgentVector pop_a(agent);
+        sim.getPopulationData(pop_a, "a");
+        ASSERT_EQ(pop_a.size(), AGENT_COUNT);
+        for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+            ASSERT_EQ(pop_a[i].getVariable<unsigned int>("x"), i);
+            ASSERT_EQ(pop_a[i].getVariable<unsigned int>("y", 0), i);
+            ASSERT_EQ(pop_a[i].getVariable<unsigned int>("y", 1), i + 1);
+        }
+        AgentVector pop_b(agent);
+        sim.getPopulationData(pop_b, "b");
+        ASSERT_EQ(pop_b.size(), 1u);
+        EXPECT_EQ(pop_b[0].getVariable<unsigned int>("x"), 12u);
+    }
+    // A state which is not part of the model is rejected
+    {
+        std::ofstream myfile(JSON_FILE_NAME, std::ofstream::out | std::ofstream::trunc);
+        myfile << "{\"agents\":{\"agent\":{\"c\":[{\"x\":1}]}}}";
+    }
+    {
+        CUDASimulation sim(model);
+        sim.SimulationConfig().input_file = JSON_FILE_NAME;
+        EXPECT_THROW(sim.applyConfig(), exception::InvalidAgentState);
+    }
+    // Cleanup
+    ASSERT_EQ(::remove(JSON_FILE_NAME), 0);
+}
+TEST(IOTest2, XML_StreamLargePopulation) {
+    // The XML reader streams the file and parses agents in chunks, check populations larger than it's read buffer and chunk size are loaded intact
+    // FLAME GPU 1 style files may omit state, and need not place name before the variables
+    const unsigned int AGENT_COUNT = 20000;
+    {
+        std::ofstream myfile(XML_FILE_NAME, std::ofstream::out | std::ofstream::trunc);
+        myfile << "<?xml version=\"1.0\"?>\n<states>\n<!-- comment -->\n<itno>0</itno>\n";
+        myfile << "<config><simulation><steps>7</steps></simulation></config>\n";
+        for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+            myfile << "<xagent><x>" << i << "</x><name>agent</name><y>" << i << ", " << i + 1 << "</y></xagent>\n";
+        }
+        myfile << "<xagent><name>agent</name><state>b</state><x>12</x><y>1,2</y></xagent>\n</states>\n";
+    }
+    ModelDescription model("test_stream");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newState("a");
+    agent.newState("b");
+    agent.setInitialState("a");
+    agent.newVariable<unsigned int>("x", 0);
+    agent.newVariable<unsigned int, 2>("y", {0, 0});
+    model.newLayer().addHostFunction(DoNothing);
+    {
+        CUDASimulation sim(model);
+        sim.SimulationConfig().input_file = XML_FILE_NAME;
+        EXPECT_NO_THROW(sim.applyConfig());
+        EXPECT_EQ(sim.getSimulationConfig().steps, 7u);
+        AgentVector pop_a(agent);
+        sim.getPopulationData(pop_a, "a");
+        ASSERT_EQ(pop_a.size(), AGENT_COUNT);
+        for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+            ASSERT_EQ(pop_a[i].getVariable<unsigned int>("x"), i);
+            ASSERT_EQ(pop_a[i].getVariable<unsigned int>("y", 0), i);
+            ASSERT_EQ(pop_a[i].getVariable<unsigned int>("y", 1), i + 1);
+        }
+        AgentVector pop_b(agent);
+        sim.getPopulationData(pop_b, "b");
+        ASSERT_EQ(pop_b.size(), 1u);
+        EXPECT_EQ(pop_b[0].getVariable<unsigned int>("x"), 12u);
+    }
+    // Malformed files are rejected
+    {
+        std::ofstream myfile(XML_FILE_NAME, std::ofstream::out | std::ofstream::trunc);
+        myfile << "<states><xagent><name>agent</name><x>1</y></xagent></states>";
+    }
+    {
+        CUDASimulation sim(model);
+        sim.SimulationConfig().input_file = XML_FILE_NAME;
+        EXPECT_THROW(sim.applyConfig(), exception::TinyXMLError);
+    }
+    // Cleanup
+    ASSERT_EQ(::remove(XML_FILE_NAME), 0);
+}
+TEST(IOTest2, XML_ChunksInterleavedStates) {
+    // Chunks of xagents are parsed in parallel, check agents of interleaved states keep their order
+    // and elements which follow the xagents are only parsed once
+    const unsigned int AGENT_COUNT = 10000;
+    {
+        std::ofstream myfile(XML_FILE_NAME, std::ofstream::out | std::ofstream::trunc);
+        myfile << "<states>\n";
+        for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+            myfile << "<xagent><name>agent</name><state>" << (i % 3 ? "a" : "b") << "</state><x>" << i << "</x></xagent>\n";
+        }
+        myfile << "<config><simulation><steps>7</steps></simulation></config>\n</states>\n";
+    }
+    ModelDescription model("test_chunks");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newState("a");
+    agent.newState("b");
+    agent.newVariable<unsigned int>("x", 0);
+    model.newLayer().addHostFunction(DoNothing);
+    {
+        CUDASimulation sim(model);
+        sim.SimulationConfig().input_file = XML_FILE_NAME;
+        EXPECT_NO_THROW(sim.applyConfig());
+        EXPECT_EQ(sim.getSimulationConfig().steps, 7u);
+        AgentVector pop_a(agent);
+        sim.getPopulationData(pop_a, "a");
+        AgentVector pop_b(agent);
+        sim.getPopulationData(pop_b, "b");
+        ASSERT_EQ(pop_a.size() + pop_b.size(), AGENT_COUNT);
+        unsigned int a = 0, b = 0;
+        for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+            if (i % 3) {
+                ASSERT_EQ(pop_a[a++].getVariable<unsigned int>("x"), i);
+            } else {
+                ASSERT_EQ(pop_b[b++].getVariable<unsigned int>("x"), i);
+            }
+        }
+    }
+    // Cleanup
+    ASSERT_EQ(::remove(XML_FILE_NAME), 0);
+}
 
 
 class MiniSim3 {
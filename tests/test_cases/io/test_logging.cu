@@ -1,11 +1,17 @@
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <filesystem>
+#include <set>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "flamegpu/flamegpu.h"
+#include "flamegpu/io/BinaryLogReader.h"
+#include "flamegpu/simulation/detail/LogStatistics.cuh"
 namespace flamegpu {
 
 
@@ -369,6 +375,127 @@ TEST(LoggingTest, EmptyMean) {
         EXPECT_EQ(step.getAgent(AGENT_NAME1).getMean("float_var"), 0.0);
     }
 }
+TEST(LoggingTest, FusedReductions) {
+    // All reductions of a variable are computed in a single pass, check they agree with a direct calculation
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME1);
+    a.newVariable<float>("float_var");
+    a.newVariable<int>("int_var");
+    a.newVariable<double>("double_var");
+
+    LoggingConfig lcfg(m);
+    AgentLoggingConfig alcfg = lcfg.agent(AGENT_NAME1);
+    logAllAgent<float>(alcfg, "float_var");
+    logAllAgent<int>(alcfg, "int_var");
+    logAllAgent<double>(alcfg, "double_var");
+
+    const unsigned int AGENT_COUNT = 12345;
+    AgentVector pop(a, AGENT_COUNT);
+    std::vector<float> float_vals;
+    std::vector<int> int_vals;
+    std::vector<double> double_vals;
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        float_vals.push_back(1000.0f + static_cast<float>((i * 7919) % 1000) / 10.0f);
+        int_vals.push_back(static_cast<int>((i * 104729) % 2001) - 1000);
+        double_vals.push_back(1e6 + static_cast<double>(i % 97) * 0.25);
+        pop[i].setVariable<float>("float_var", float_vals.back());
+        pop[i].setVariable<int>("int_var", int_vals.back());
+        pop[i].setVariable<double>("double_var", double_vals.back());
+    }
+
+    CUDASimulation sim(m);
+    sim.setExitLog(lcfg);
+    sim.setPopulationData(pop);
+    sim.SimulationConfig().steps = 1;
+    sim.simulate();
+    const AgentLogFrame agent_log = sim.getRunLog().getExitLog().getAgent(AGENT_NAME1);
+
+    // Compare against the host reference, and a naive two pass calculation
+    auto check = [&agent_log](const auto &vals, const std::string &var_name) {
+        typedef typename std::decay<decltype(vals)>::type::value_type T;
+        const detail::LogStatistics<T> reference = detail::computeLogStatistics(vals.data(), static_cast<unsigned int>(vals.size()));
+        double sum = 0;
+        for (const T &v : vals)
+            sum += static_cast<double>(v);
+        const double mean = sum / vals.size();
+        double sq = 0;
+        for (const T &v : vals)
+            sq += (static_cast<double>(v) - mean) * (static_cast<double>(v) - mean);
+        const double sd = sqrt(sq / vals.size());
+        EXPECT_EQ(agent_log.getMin<T>(var_name), *std::min_element(vals.begin(), vals.end()));
+        EXPECT_EQ(agent_log.getMax<T>(var_name), *std::max_element(vals.begin(), vals.end()));
+        EXPECT_EQ(reference.min, *std::min_element(vals.begin(), vals.end()));
+        EXPECT_EQ(reference.max, *std::max_element(vals.begin(), vals.end()));
+        EXPECT_NEAR(agent_log.getMean(var_name), mean, 1e-9 * std::abs(mean));
+        EXPECT_NEAR(reference.mean, mean, 1e-9 * std::abs(mean));
+        EXPECT_NEAR(agent_log.getStandardDev(var_name), sd, 1e-6 * sd);
+        EXPECT_NEAR(sqrt(reference.m2 / reference.count), sd, 1e-6 * sd);
+    };
+    check(float_vals, "float_var");
+    check(int_vals, "int_var");
+    check(double_vals, "double_var");
+    int64_t int_sum = 0;
+    for (const int &v : int_vals)
+        int_sum += v;
+    EXPECT_EQ(agent_log.getSum<int>("int_var"), int_sum);
+}
+TEST(LoggingTest, StepLogBacklog) {
+    // Step logs are assembled in the background, check frames are neither lost nor reordered when capture outpaces assembly
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME1);
+    a.newVariable<float>("float_var");
+    a.newVariable<int>("int_var");
+    a.newVariable<unsigned int>("uint_var");
+    AgentFunctionDescription f1 = a.newFunction(FUNCTION_NAME1, agent_fn1);
+    m.newLayer().addAgentFunction(f1);
+    m.addStepFunction(step_fn1);
+    m.Environment().newProperty<float>("float_prop", 1.0f);
+    m.Environment().newProperty<int>("int_prop", 1);
+    m.Environment().newProperty<unsigned int>("uint_prop", 1);
+    m.Environment().newProperty<float, 2>("float_prop_array", {1.0f, 2.0f});
+    m.Environment().newProperty<int, 3>("int_prop_array", {2, 3, 4});
+    m.Environment().newProperty<unsigned int, 4>("uint_prop_array", {3, 4, 5, 6});
+
+    LoggingConfig lcfg(m);
+    AgentLoggingConfig alcfg = lcfg.agent(AGENT_NAME1);
+    alcfg.logCount();
+    alcfg.logSum<int>("int_var");
+    alcfg.logMax<unsigned int>("uint_var");
+    lcfg.logEnvironment("int_prop");
+    lcfg.logEnvironment("uint_prop_array");
+    StepLoggingConfig slcfg(lcfg);
+    slcfg.setFrequency(1);
+
+    const unsigned int AGENT_COUNT = 101;
+    AgentVector pop(a, AGENT_COUNT);
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        pop[i].setVariable<int>("int_var", static_cast<int>(i));
+        pop[i].setVariable<unsigned int>("uint_var", i);
+    }
+
+    const unsigned int STEPS = 200;
+    CUDASimulation sim(m);
+    sim.SimulationConfig().steps = STEPS;
+    sim.setStepLog(slcfg);
+    sim.setPopulationData(pop);
+    sim.simulate();
+
+    const auto &steps = sim.getRunLog().getStepLog();
+    ASSERT_EQ(steps.size(), STEPS + 1);  // +1 for initial log
+    unsigned int step_index = 0;
+    for (const auto &step : steps) {
+        ASSERT_EQ(step.getStepCount(), step_index);
+        // Agents and the environment are both incremented once per step
+        EXPECT_EQ(step.getEnvironmentProperty<int>("int_prop"), static_cast<int>(1 + step_index));
+        const auto uint_prop_array = step.getEnvironmentProperty<unsigned int, 4>("uint_prop_array");
+        EXPECT_EQ(uint_prop_array[3], 6 + step_index);
+        const auto agent_log = step.getAgent(AGENT_NAME1);
+        EXPECT_EQ(agent_log.getCount(), AGENT_COUNT);
+        EXPECT_EQ(agent_log.getSum<int>("int_var"), static_cast<int64_t>(AGENT_COUNT * (AGENT_COUNT - 1) / 2 + AGENT_COUNT * step_index));
+        EXPECT_EQ(agent_log.getMax<unsigned int>("uint_var"), AGENT_COUNT - 1 + step_index);
+        ++step_index;
+    }
+}
 TEST(LoggingTest, CUDAEnsembleSimulate) {
     /**
      * Ensure the expected data is logged when CUDAEnsemble::simulate() is called
@@ -975,6 +1102,181 @@ TEST(TestLogging, Ensemble_ToFile_All) {
     std::filesystem::remove_all("out");
 }
 
+TEST(TestLogging, Simulation_ToFile_Binary) {
+    // Test that a common log written in the binary format can be read back, and matches the run log
+    const std::filesystem::path common_file = "common.bin";
+    ASSERT_FALSE(std::filesystem::exists(common_file));
+
+    // Define model
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME1);
+    a.newVariable<float>("float_var");
+    a.newVariable<int>("int_var");
+    a.newVariable<unsigned int>("uint_var");
+    AgentFunctionDescription f1 = a.newFunction(FUNCTION_NAME1, agent_fn1);
+    m.newLayer().addAgentFunction(f1);
+    m.addStepFunction(step_fn1);
+    m.Environment().newProperty<float>("float_prop", 1.0f);
+    m.Environment().newProperty<int>("int_prop", 1);
+    m.Environment().newProperty<unsigned int>("uint_prop", 1);
+    m.Environment().newProperty<float, 2>("float_prop_array", {1.0f, 2.0f});
+    m.Environment().newProperty<int, 3>("int_prop_array", {2, 3, 4});
+    m.Environment().newProperty<unsigned int, 4>("uint_prop_array", {3, 4, 5, 6});
+
+    // Define logging configs
+    LoggingConfig lcfg(m);
+    AgentLoggingConfig alcfg = lcfg.agent(AGENT_NAME1);
+    alcfg.logCount();
+    logAllAgent<float>(alcfg, "float_var");
+    logAllAgent<int>(alcfg, "int_var");
+    logAllAgent<unsigned int>(alcfg, "uint_var");
+    lcfg.logEnvironment("float_prop");
+    lcfg.logEnvironment("int_prop_array");
+    lcfg.logTiming(true);
+
+    StepLoggingConfig slcfg(lcfg);
+    slcfg.setFrequency(2);
+
+    // Create agent population
+    AgentVector pop(a, 101);
+    for (int i = 0; i < 101; ++i) {
+        auto instance = pop[i];
+        instance.setVariable<float>("float_var", static_cast<float>(i));
+        instance.setVariable<int>("int_var", static_cast<int>(i + 1));
+        instance.setVariable<unsigned int>("uint_var", static_cast<unsigned int>(i + 2));
+    }
+
+    // Run model
+    CUDASimulation sim(m);
+    sim.SimulationConfig().steps = 10;
+    sim.SimulationConfig().common_log_file = common_file.generic_string();
+    sim.setStepLog(slcfg);
+    sim.setExitLog(lcfg);
+    sim.setPopulationData(pop);
+    sim.simulate();
+    ASSERT_TRUE(std::filesystem::exists(common_file));
+    // Compare the file against the run log
+    {
+        io::BinaryLogReader reader(common_file.generic_string());
+        ASSERT_EQ(reader.getRunCount(), 1u);
+        const auto &run = reader.getRun(0);
+        const RunLog &log = sim.getRunLog();
+        EXPECT_TRUE(run.hasConfig());
+        EXPECT_EQ(run.getRandomSeed(), log.getRandomSeed());
+        EXPECT_TRUE(run.hasPerformanceSpecs());
+        EXPECT_EQ(run.getPerformanceSpecs().flamegpu_version, log.getPerformanceSpecs().flamegpu_version);
+        ASSERT_TRUE(run.hasStepLog());
+        const auto &steps = run.getStepLog();
+        ASSERT_EQ(steps.getRowCount(), log.getStepLog().size());
+        const unsigned int *step_index = steps.getColumn<unsigned int>("step_index");
+        const double *step_time = steps.getColumn<double>("step_time");
+        const float *float_prop = steps.getColumn<float>(io::BinaryLogger::environmentColumn("float_prop"));
+        const int *int_prop_array = steps.getColumn<int>(io::BinaryLogger::environmentColumn("int_prop_array"));
+        EXPECT_EQ(steps.getColumnElements(io::BinaryLogger::environmentColumn("int_prop_array")), 3u);
+        const unsigned int *count = steps.getColumn<unsigned int>(io::BinaryLogger::agentCountColumn(AGENT_NAME1, ModelData::DEFAULT_STATE));
+        const float *float_max = steps.getColumn<float>(io::BinaryLogger::agentColumn(AGENT_NAME1, ModelData::DEFAULT_STATE, "float_var", LoggingConfig::Max));
+        const int64_t *int_sum = steps.getColumn<int64_t>(io::BinaryLogger::agentColumn(AGENT_NAME1, ModelData::DEFAULT_STATE, "int_var", LoggingConfig::Sum));
+        const double *uint_mean = steps.getColumn<double>(io::BinaryLogger::agentColumn(AGENT_NAME1, ModelData::DEFAULT_STATE, "uint_var", LoggingConfig::Mean));
+        // Columns are type checked
+        EXPECT_THROW(steps.getColumn<double>(io::BinaryLogger::environmentColumn("float_prop")), exception::InvalidVarType);
+        EXPECT_THROW(steps.getColumn<float>("missing"), exception::InvalidArgument);
+        unsigned int row = 0;
+        for (const auto &step : log.getStepLog()) {
+            EXPECT_EQ(step_index[row], step.getStepCount());
+            EXPECT_EQ(step_time[row], step.getStepTime());
+            EXPECT_EQ(float_prop[row], step.getEnvironmentProperty<float>("float_prop"));
+            const auto i_a = step.getEnvironmentProperty<int, 3>("int_prop_array");
+            for (unsigned int j = 0; j < 3; ++j) {
+                EXPECT_EQ(int_prop_array[row * 3 + j], i_a[j]);
+            }
+            const auto agent_log = step.getAgent(AGENT_NAME1);
+            EXPECT_EQ(count[row], agent_log.getCount());
+            EXPECT_EQ(float_max[row], agent_log.getMax<float>("float_var"));
+            EXPECT_EQ(int_sum[row], agent_log.getSum<int>("int_var"));
+            EXPECT_EQ(uint_mean[row], agent_log.getMean("uint_var"));
+            ++row;
+        }
+        ASSERT_TRUE(run.hasExitLog());
+        const auto &exit = run.getExitLog();
+        ASSERT_EQ(exit.getRowCount(), 1u);
+        EXPECT_EQ(exit.getColumn<unsigned int>("step_index")[0], log.getExitLog().getStepCount());
+        EXPECT_EQ(exit.getColumn<double>("total_time")[0], log.getExitLog().getTotalTime());
+        EXPECT_EQ(exit.getColumn<float>(io::BinaryLogger::environmentColumn("float_prop"))[0], log.getExitLog().getEnvironmentProperty<float>("float_prop"));
+    }
+    // Cleanup
+    ASSERT_TRUE(std::filesystem::remove(common_file));
+}
+TEST(TestLogging, Ensemble_ToFile_Binary) {
+    // Test that the binary format can be selected via out_format, and that exit logs of runs sharing a subdirectory share a file
+    const std::filesystem::path step_file = "out/0.bin";
+    const std::filesystem::path exit_file = "out/exit.bin";
+    ASSERT_FALSE(std::filesystem::exists("out"));
+
+    // Define model
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME1);
+    a.newVariable<float>("float_var");
+    a.newVariable<int>("int_var");
+    a.newVariable<unsigned int>("uint_var");
+    AgentFunctionDescription f1 = a.newFunction(FUNCTION_NAME1, agent_fn1);
+    m.newLayer().addAgentFunction(f1);
+    m.addInitFunction(logging_ensemble_init);
+    m.Environment().newProperty<int>("instance_id", 0);
+
+    // Define logging configs
+    LoggingConfig lcfg(m);
+    AgentLoggingConfig alcfg = lcfg.agent(AGENT_NAME1);
+    alcfg.logCount();
+    logAllAgent<float>(alcfg, "float_var");
+    lcfg.logEnvironment("instance_id");
+
+    StepLoggingConfig slcfg(lcfg);
+
+    // Set up the runplan
+    const unsigned int RUNS = 4;
+    RunPlanVector plan(m, RUNS);
+    int i_id = 0;
+    for (auto& p : plan) {
+        p.setSteps(10);
+        p.setProperty<int>("instance_id", i_id++);
+    }
+
+    // Run model
+    CUDAEnsemble sim(m);
+    sim.Config().concurrent_runs = 2;
+    sim.Config().verbosity = Verbosity::Quiet;
+    sim.Config().timing = false;
+    sim.Config().out_directory = "out";
+    sim.Config().out_format = "bin";
+    sim.setStepLog(slcfg);
+    sim.setExitLog(lcfg);
+    sim.simulate(plan);
+
+    // Check
+    ASSERT_TRUE(std::filesystem::exists(step_file));
+    ASSERT_TRUE(std::filesystem::exists(exit_file));
+    {
+        io::BinaryLogReader step_reader(step_file.generic_string());
+        ASSERT_EQ(step_reader.getRunCount(), 1u);
+        EXPECT_EQ(step_reader.getRun(0).getSteps(), 10u);
+        EXPECT_EQ(step_reader.getRun(0).getStepLog().getRowCount(), 11u);  // init log, + 10 steps
+        EXPECT_FALSE(step_reader.getRun(0).hasExitLog());
+        io::BinaryLogReader exit_reader(exit_file.generic_string());
+        ASSERT_EQ(exit_reader.getRunCount(), RUNS);
+        // Runs may complete in any order, so check each instance_id is present once
+        std::set<int> instance_ids;
+        for (unsigned int i = 0; i < RUNS; ++i) {
+            const auto &run = exit_reader.getRun(i);
+            EXPECT_FALSE(run.hasStepLog());
+            ASSERT_TRUE(run.hasExitLog());
+            EXPECT_EQ(run.getPropertyOverrides().count("instance_id"), 1u);
+            instance_ids.insert(run.getExitLog().getColumn<int>(io::BinaryLogger::environmentColumn("instance_id"))[0]);
+        }
+        EXPECT_EQ(instance_ids.size(), RUNS);
+    }
+    // Cleanup
+    std::filesystem::remove_all("out");
+}
 
 }  // namespace test_logging
 }  // namespace flamegpu
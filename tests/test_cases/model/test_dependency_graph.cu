@@ -1,6 +1,7 @@
 #include <cstdio>
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "flamegpu/flamegpu.h"
 
@@ -433,32 +434,32 @@ TEST(DependencyGraphTest, CorrectLayersAllDependencies) {
     std::string expectedLayers = R"###(--------------------
 Layer 0
 --------------------
-Function1
+HostFn1
 
 --------------------
 Layer 1
 --------------------
-HostFn1
+Function1
 
 --------------------
 Layer 2
 --------------------
-Function2
+Function3
 
 --------------------
 Layer 3
 --------------------
-Function3
+Function2
 
 --------------------
 Layer 4
 --------------------
-Function4
+HostFn2
 
 --------------------
 Layer 5
 --------------------
-HostFn2
+Function4
 
 --------------------
 Layer 6
@@ -488,27 +489,50 @@ TEST(DependencyGraphTest, CorrectLayersConcurrent) {
     std::string expectedLayers = R"###(--------------------
 Layer 0
 --------------------
-Function3
-
---------------------
-Layer 1
---------------------
 HostFn1
 
 --------------------
-Layer 2
+Layer 1
 --------------------
+Function3
 Function1
 Function2
 
 --------------------
-Layer 3
+Layer 2
 --------------------
 HostFn2
 
 )###";
     EXPECT_EQ(expectedLayers, _m.getConstructedLayersString());
 }
+TEST(DependencyGraphTest, CorrectLayersManyDiamonds) {
+    // A chain of diamonds contains exponentially many paths, so layers must be generated without walking every path
+    constexpr unsigned int DIAMONDS = 64;
+    ModelDescription _m(MODEL_NAME);
+    AgentDescription a = _m.newAgent(AGENT_NAME);
+    AgentDescription a2 = _m.newAgent(AGENT_NAME2);
+    // The graph refers to the function descriptions, so they must not be reallocated
+    std::vector<AgentFunctionDescription> fns;
+    fns.reserve(3 * DIAMONDS + 1);
+    fns.push_back(a.newFunction("top", agent_fn2));
+    for (unsigned int i = 0; i < DIAMONDS; ++i) {
+        const size_t top = fns.size() - 1;
+        // The sides of each diamond belong to different agents, so can share a layer
+        fns.push_back(a.newFunction("left" + std::to_string(i), agent_fn2));
+        fns.back().dependsOn(fns[top]);
+        fns.push_back(a2.newFunction("right" + std::to_string(i), agent_fn2));
+        fns.back().dependsOn(fns[top]);
+        fns.push_back(a.newFunction("bottom" + std::to_string(i), agent_fn2));
+        fns.back().dependsOn(fns[top + 1], fns[top + 2]);
+    }
+    _m.addExecutionRoot(fns[0]);
+    _m.generateLayers();
+    ASSERT_EQ(_m.getLayersCount(), 2 * DIAMONDS + 1);
+    for (flamegpu::size_type i = 0; i < _m.getLayersCount(); ++i) {
+        EXPECT_EQ(_m.getLayer(i).getAgentFunctionsCount(), i % 2 ? 2u : 1u);
+    }
+}
 TEST(DependencyGraphTest, InterModelDependency) {
     ModelDescription _m(MODEL_NAME);
     AgentDescription a = _m.newAgent(AGENT_NAME);
@@ -40,6 +40,12 @@ FLAMEGPU_STEP_FUNCTION(SetGetArrayElement) {
         ai.setVariable<int, 3>("int", 1, ai.getVariable<int, 3>("int", 1) + 12);
     }
 }
+FLAMEGPU_STEP_FUNCTION(SetGetColumn) {
+    DeviceAgentVector av = FLAMEGPU->agent(AGENT_NAME).getPopulationData();
+    for (int &v : av.column<int>("int")) {
+        v += 12;
+    }
+}
 FLAMEGPU_STEP_FUNCTION(SetGetHalf) {
     HostAgentAPI agent = FLAMEGPU->agent(AGENT_NAME);
     DeviceAgentVector av = agent.getPopulationData();
@@ -174,6 +180,38 @@ TEST(DeviceAgentVectorTest, SetGetArrayElement) {
         ASSERT_EQ(t1, t2);
     }
 }
+TEST(DeviceAgentVectorTest, SetGetColumn) {
+    // As SetGet, but update all agents via a column handle
+    ModelDescription model(MODEL_NAME);
+    AgentDescription agent = model.newAgent(AGENT_NAME);
+    agent.newVariable<int>("int", 0);
+    model.addStepFunction(SetGetColumn);
+
+    // Init agent pop
+    AgentVector av(agent, AGENT_COUNT);
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i)
+      av[i].setVariable<int>("int", static_cast<int>(i));
+
+    // Create and step simulation
+    CUDASimulation sim(model);
+    sim.setPopulationData(av);
+    sim.step();
+
+    // Retrieve and validate agents match
+    sim.getPopulationData(av);
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        ASSERT_EQ(av[i].getVariable<int>("int"), static_cast<int>(i) + 12);
+    }
+
+    // Step again
+    sim.step();
+
+    // Retrieve and validate agents match
+    sim.getPopulationData(av);
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        ASSERT_EQ(av[i].getVariable<int>("int"), static_cast<int>(i) + 24);
+    }
+}
 TEST(DeviceAgentVectorTest, SetGetHalf) {
     // Initialise an agent population with values in a variable [0,1,2..N]
     // Inside a step function, retrieve the agent population as a DeviceAgentVector
@@ -7,7 +7,9 @@
 * > host function birthed agents have default values set
 * > Exception thrown if setting/getting wrong variable name/type
 * > getVariable() works
+* > batched agent creation via newAgents()
 */
+#include <array>
 #include <set>
 
 #include "flamegpu/flamegpu.h"
@@ -1064,5 +1066,102 @@ TEST(HostAgentCreationTest, DISABLED_HostAgentBirth_ArrayDefaultWorks2_glm) {}
 TEST(HostAgentCreationTest, DISABLED_HostAgentBirth_ArrayLenWrong_glm) {}
 TEST(HostAgentCreationTest, DISABLED_HostAgentBirth_ArrayOutOfBounds_glm) {}
 #endif
+FLAMEGPU_STEP_FUNCTION(BatchOutput) {
+    auto t = FLAMEGPU->agent("agent");
+    HostNewAgentBatch batch = t.newAgents(NEW_AGENT_COUNT);
+    EXPECT_EQ(batch.size(), NEW_AGENT_COUNT);
+    float *x = batch.getVariableData<float>("x");
+    int *a = batch.getVariableData<int, 3>("array");
+    for (unsigned int i = 0; i < NEW_AGENT_COUNT; ++i) {
+        x[i] = static_cast<float>(i);
+        a[i * 3 + 1] = static_cast<int>(i);
+        // IDs are consecutive
+        if (i)
+            EXPECT_EQ(batch.getID(i), batch.getID(i - 1) + 1);
+    }
+    // A second batch in the same state, interleaved with newAgent()
+    t.newAgent().setVariable<float>("x", -1.0f);
+    HostNewAgentBatch batch2 = t.newAgents(NEW_AGENT_COUNT);
+    batch2.setVariable<float>("x", -2.0f);
+    EXPECT_GT(batch2.getID(0), batch.getID(NEW_AGENT_COUNT - 1));
+    // Empty batches are permitted
+    EXPECT_EQ(t.newAgents(0).size(), 0u);
+    // Agents are not visible until the layer completes
+    EXPECT_EQ(t.count(), FLAMEGPU->getStepCounter() * (2 * NEW_AGENT_COUNT + 1));
+}
+TEST(HostAgentCreationTest, BatchFromStep) {
+    ModelDescription model("TestModel");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<float>("x");
+    agent.newVariable<float>("default", 15.0f);
+    agent.newVariable<int, 3>("array", {1, 2, 3});
+    model.addStepFunction(BatchOutput);
+    CUDASimulation cudaSimulation(model);
+    // Run several steps, so that the batch storage is reused
+    cudaSimulation.SimulationConfig().steps = 3;
+    cudaSimulation.applyConfig();
+    cudaSimulation.simulate();
+    AgentVector population(model.Agent("agent"));
+    cudaSimulation.getPopulationData(population);
+    EXPECT_EQ(population.size(), 3 * (2 * NEW_AGENT_COUNT + 1));
+    std::set<id_t> ids;
+    std::set<float> xs;
+    unsigned int is_minus_1 = 0;
+    unsigned int is_minus_2 = 0;
+    for (AgentVector::Agent ai : population) {
+        ids.insert(ai.getID());
+        EXPECT_EQ(ai.getVariable<float>("default"), 15.0f);
+        const float x = ai.getVariable<float>("x");
+        const std::array<int, 3> a = ai.getVariable<int, 3>("array");
+        EXPECT_EQ(a[0], 1);
+        EXPECT_EQ(a[2], 3);
+        if (x == -1.0f) {
+            ++is_minus_1;
+            EXPECT_EQ(a[1], 2);
+        } else if (x == -2.0f) {
+            ++is_minus_2;
+            EXPECT_EQ(a[1], 2);
+        } else {
+            xs.insert(x);
+            EXPECT_EQ(a[1], static_cast<int>(x));
+        }
+    }
+    EXPECT_EQ(ids.size(), population.size());
+    EXPECT_EQ(xs.size(), NEW_AGENT_COUNT);
+    EXPECT_EQ(is_minus_1, 3u);
+    EXPECT_EQ(is_minus_2, 3 * NEW_AGENT_COUNT);
+}
+FLAMEGPU_STEP_FUNCTION(BatchBadVarType) {
+    FLAMEGPU->agent("agent").newAgents(1).getVariableData<int>("x");
+}
+FLAMEGPU_STEP_FUNCTION(BatchBadArrayLen) {
+    FLAMEGPU->agent("agent").newAgents(1).getVariableData<int, 2>("array");
+}
+FLAMEGPU_STEP_FUNCTION(BatchReservedName) {
+    FLAMEGPU->agent("agent").newAgents(1).getVariableData<id_t>("_id");
+}
+TEST(HostAgentCreationTest, BatchBadVarType) {
+    ModelDescription model("TestModel");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<float>("x");
+    model.addStepFunction(BatchBadVarType);
+    CUDASimulation cudaSimulation(model);
+    EXPECT_THROW(cudaSimulation.step(), exception::InvalidVarType);
+}
+TEST(HostAgentCreationTest, BatchBadArrayLen) {
+    ModelDescription model("TestModel");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<int, 3>("array");
+    model.addStepFunction(BatchBadArrayLen);
+    CUDASimulation cudaSimulation(model);
+    EXPECT_THROW(cudaSimulation.step(), exception::InvalidVarArrayLen);
+}
+TEST(HostAgentCreationTest, BatchReservedName) {
+    ModelDescription model("TestModel");
+    model.newAgent("agent");
+    model.addStepFunction(BatchReservedName);
+    CUDASimulation cudaSimulation(model);
+    EXPECT_THROW(cudaSimulation.step(), exception::ReservedName);
+}
 }  // namespace test_host_agent_creation
 }  // namespace flamegpu
@@ -4,6 +4,8 @@
 * This could perhaps be split into multiple files, one per useful class (Description, Host, Device)
 */
 #include <filesystem>
+#include <fstream>
+#include <limits>
 
 #include "flamegpu/flamegpu.h"
 
@@ -896,11 +898,12 @@ FLAMEGPU_HOST_FUNCTION(SaveGraph) {
     // Save
     graph.exportGraph("graph.json");
 }
-FLAMEGPU_HOST_FUNCTION(LoadCheckGraph3) {
+FLAMEGPU_HOST_FUNCTION(SaveGraph_Binary) {
     HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
-    // Load
-    graph.importGraph("graph.json");
-    // Check
+    // Save
+    graph.exportGraph("graph.bin");
+}
+void CheckGraph3(HostEnvironmentDirectedGraph &graph) {
     auto vertices = graph.vertices();
     auto edges = graph.edges();
     for (unsigned int i = 1; i < 31; ++i) {
@@ -934,9 +937,25 @@ FLAMEGPU_HOST_FUNCTION(LoadCheckGraph3) {
             EXPECT_EQ((edge.getProperty<double, 2>)("edge_double2"), result2);
         }
     }
+}
+FLAMEGPU_HOST_FUNCTION(LoadCheckGraph3) {
+    HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    // Load
+    graph.importGraph("graph.json");
+    // Check
+    CheckGraph3(graph);
     // Cleanup
     std::filesystem::remove("graph.json");
 }
+FLAMEGPU_HOST_FUNCTION(LoadCheckGraph3_Binary) {
+    HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    // Load
+    graph.importGraph("graph.bin");
+    // Check
+    CheckGraph3(graph);
+    // Cleanup
+    std::filesystem::remove("graph.bin");
+}
 TEST(TestEnvironmentDirectedGraph, TestJSONSaveLoad) {
     ModelDescription model("GraphTest");
     EnvironmentDirectedGraphDescription graph = model.Environment().newDirectedGraph("graph");
@@ -967,6 +986,97 @@ TEST(TestEnvironmentDirectedGraph, TestJSONSaveLoad) {
 
     EXPECT_NO_THROW(sim.step());
 }
+TEST(TestEnvironmentDirectedGraph, TestBinarySaveLoad) {
+    ModelDescription model("GraphTest");
+    EnvironmentDirectedGraphDescription graph = model.Environment().newDirectedGraph("graph");
+
+    graph.newVertexProperty<float>("vertex_float");
+    graph.newVertexProperty<double, 2>("vertex_double2");
+    graph.newVertexProperty<int, 3>("vertex_int3");
+
+    graph.newEdgeProperty<int>("edge_int");
+    graph.newEdgeProperty<double, 2>("edge_double2");
+    graph.newEdgeProperty<float, 3>("edge_float3");
+
+    AgentDescription agent = model.newAgent("agent");
+
+    // Init graph with known data
+    model.newLayer().addHostFunction(InitGraph3);
+    // Export
+    model.newLayer().addHostFunction(SaveGraph_Binary);
+    // Reinit graph with different data
+    model.newLayer().addHostFunction(InitGraph);
+    // Import graph and check it matches first init
+    model.newLayer().addHostFunction(LoadCheckGraph3_Binary);
+
+    AgentVector pop(agent, 1);
+
+    CUDASimulation sim(model);
+    sim.setPopulationData(pop);
+
+    EXPECT_NO_THROW(sim.step());
+}
+FLAMEGPU_HOST_FUNCTION(LoadInvalidGraph_Binary) {
+    HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    {
+        std::ofstream out("invalid_graph.bin", std::ofstream::binary | std::ofstream::trunc);
+        out << "This is not a binary graph";
+    }
+    EXPECT_THROW(graph.importGraph("invalid_graph.bin"), exception::InvalidInputFile);
+    EXPECT_THROW(graph.importGraph("missing_graph.bin"), exception::InvalidFilePath);
+    // Export a valid graph, then corrupt copies of it
+    graph.setVertexCount(3);
+    auto vertices = graph.vertices();
+    for (unsigned int i = 1; i < 4; ++i) {
+        EXPECT_EQ(vertices[i].getID(), static_cast<id_t>(i));
+    }
+    graph.setEdgeCount(2);
+    auto edges = graph.edges();
+    EXPECT_EQ((edges[{1, 2}].getSourceVertexID()), static_cast<id_t>(1));
+    EXPECT_EQ((edges[{2, 3}].getSourceVertexID()), static_cast<id_t>(2));
+    graph.exportGraph("valid_graph.bin");
+    // The header is the 8 byte magic, 6 uint32 fields {version, byte_order_mark, vertex_count, edge_count, ...}, then the uint64 offsets of the row offsets and column indices
+    uint64_t csr_offsets[2] = {0, 0};
+    {
+        std::ifstream file("valid_graph.bin", std::ios::binary);
+        file.seekg(8 + 6 * sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(csr_offsets), sizeof(csr_offsets));
+    }
+    auto corrupt = [](const uint64_t offset, const void *data, const size_t length) {
+        std::filesystem::copy_file("valid_graph.bin", "invalid_graph.bin", std::filesystem::copy_options::overwrite_existing);
+        std::fstream file("invalid_graph.bin", std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(static_cast<const char*>(data), length);
+    };
+    // Non-monotonic row offsets (whilst still spanning every edge)
+    const uint32_t row_offsets[4] = {0, 2, 1, 2};
+    corrupt(csr_offsets[0], row_offsets, sizeof(row_offsets));
+    EXPECT_THROW(graph.importGraph("invalid_graph.bin"), exception::InvalidInputFile);
+    // Vertex count which overflows the length of the row offsets
+    const uint32_t vertex_count = std::numeric_limits<uint32_t>::max();
+    corrupt(8 + 2 * sizeof(uint32_t), &vertex_count, sizeof(uint32_t));
+    EXPECT_THROW(graph.importGraph("invalid_graph.bin"), exception::InvalidInputFile);
+    // Edge count far exceeding the length of the file
+    const uint32_t edge_count = std::numeric_limits<uint32_t>::max() / 2;
+    corrupt(8 + 3 * sizeof(uint32_t), &edge_count, sizeof(uint32_t));
+    EXPECT_THROW(graph.importGraph("invalid_graph.bin"), exception::InvalidInputFile);
+    // File truncated part way through the column indices
+    corrupt(0, nullptr, 0);
+    std::filesystem::resize_file("invalid_graph.bin", csr_offsets[1] + sizeof(uint32_t));
+    EXPECT_THROW(graph.importGraph("invalid_graph.bin"), exception::InvalidInputFile);
+    // Cleanup
+    std::filesystem::remove("valid_graph.bin");
+    std::filesystem::remove("invalid_graph.bin");
+}
+TEST(TestEnvironmentDirectedGraph, TestBinaryLoadInvalid) {
+    ModelDescription model("GraphTest");
+    model.Environment().newDirectedGraph("graph");
+    model.newAgent("agent");
+    model.newLayer().addHostFunction(LoadInvalidGraph_Binary);
+
+    CUDASimulation sim(model);
+    EXPECT_NO_THROW(sim.step());
+}
 TEST(TestEnvironmentDirectedGraph, TestEdgesOut) {
     ModelDescription model("GraphTest");
     EnvironmentDirectedGraphDescription graph = model.Environment().newDirectedGraph("graph");
@@ -1188,6 +1298,182 @@ TEST(TestEnvironmentDirectedGraph, TestVertexIDNonContiguous) {
         EXPECT_EQ(agt.getVariable<unsigned int>("result3"), 1u);
     }
 }
+const unsigned int ID_SPARSE_STRIDE = 100003;
+FLAMEGPU_HOST_FUNCTION(InitGraph_SparseIDs) {
+    HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    graph.setVertexCount(ID_AGENT_COUNT);
+    graph.setEdgeCount(ID_AGENT_COUNT);
+    auto vertices = graph.vertices();
+    auto edges = graph.edges();
+    for (unsigned int i = 0; i < ID_AGENT_COUNT; ++i) {
+        // IDs span a range far wider than the vertex count, so a hash map is used
+        const unsigned int my_id = ID_OFFSET + i * ID_SPARSE_STRIDE;
+        auto vertex = vertices[my_id];
+        vertex.setProperty<unsigned int>("vertex_index", i);
+        vertex.setProperty<unsigned int>("vertex_ID", my_id);
+        // Test does not care about edges, but add some so that it generates properly
+        edges[{my_id, ID_OFFSET + (((i + 5) * 3) % ID_AGENT_COUNT) * ID_SPARSE_STRIDE}];
+    }
+}
+FLAMEGPU_AGENT_FUNCTION(CheckGraph_SparseIDs, MessageNone, MessageNone) {
+    auto graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    unsigned int my_vertex_id = ID_OFFSET + FLAMEGPU->getIndex() * ID_SPARSE_STRIDE;
+    unsigned int my_vertex_index = graph.getVertexIndex(my_vertex_id);
+    unsigned int my_vertex_id2 = graph.getVertexID(my_vertex_index);
+    unsigned int my_vertex_id3 = graph.getVertexProperty<unsigned int>("vertex_ID", my_vertex_index);
+    unsigned int my_vertex_index2 = graph.getVertexProperty<unsigned int>("vertex_index", my_vertex_index);
+
+    if (my_vertex_id == my_vertex_id2) {
+        FLAMEGPU->setVariable<unsigned int>("result1", 1);
+    }
+    if (my_vertex_id == my_vertex_id3) {
+        FLAMEGPU->setVariable<unsigned int>("result2", 1);
+    }
+    if (my_vertex_index == my_vertex_index2) {
+        FLAMEGPU->setVariable<unsigned int>("result3", 1);
+    }
+    return flamegpu::ALIVE;
+}
+TEST(TestEnvironmentDirectedGraph, TestVertexIDSparse) {
+    // Assign vertices widely spaced IDs and check they are accessible correctly via map
+    ModelDescription model("GraphTest");
+    EnvironmentDirectedGraphDescription graph = model.Environment().newDirectedGraph("graph");
+
+    graph.newVertexProperty<unsigned int>("vertex_index");
+    graph.newVertexProperty<unsigned int>("vertex_ID");
+
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<unsigned int>("result1", 0);
+    agent.newVariable<unsigned int>("result2", 0);
+    agent.newVariable<unsigned int>("result3", 0);
+    agent.newFunction("check_graph", CheckGraph_SparseIDs);
+
+    // Init graph with known data
+    model.newLayer().addHostFunction(InitGraph_SparseIDs);
+    model.newLayer().addAgentFunction(CheckGraph_SparseIDs);
+
+    // Each agent checks 1 ID
+    AgentVector pop(agent, ID_AGENT_COUNT);
+
+    CUDASimulation sim(model);
+    sim.setPopulationData(pop);
+
+    EXPECT_NO_THROW(sim.step());
+
+    sim.getPopulationData(pop);
+    for (const auto& agt : pop) {
+        EXPECT_EQ(agt.getVariable<unsigned int>("result1"), 1u);
+        EXPECT_EQ(agt.getVariable<unsigned int>("result2"), 1u);
+        EXPECT_EQ(agt.getVariable<unsigned int>("result3"), 1u);
+    }
+}
+const unsigned int EDIT_VERTEX_COUNT = 64;
+FLAMEGPU_HOST_FUNCTION(InitGraph_EditEdges) {
+    HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    auto edges = graph.edges();
+    if (FLAMEGPU->getStepCounter() == 0) {
+        // Each vertex has an edge to the following 2 vertices
+        graph.setVertexCount(EDIT_VERTEX_COUNT);
+        graph.setEdgeCount(EDIT_VERTEX_COUNT * 2);
+        auto vertices = graph.vertices();
+        for (unsigned int i = 0; i < EDIT_VERTEX_COUNT; ++i) {
+            vertices[i + 1];
+        }
+        for (unsigned int i = 0; i < EDIT_VERTEX_COUNT; ++i) {
+            for (unsigned int j = 1; j <= 2; ++j) {
+                const id_t dest = (i + j) % EDIT_VERTEX_COUNT + 1;
+                auto edge = edges[{i + 1, dest}];
+                edge.setProperty<id_t>("src_copy", i + 1);
+                edge.setProperty<id_t>("dest_copy", dest);
+            }
+        }
+    } else if (FLAMEGPU->getStepCounter() == 1) {
+        // Change the destination of one edge, and the source of another
+        // Few enough edges change that the existing graph is updated, rather than rebuilt
+        auto edge1 = edges[{3, 4}];
+        edge1.setDestinationVertexID(10);
+        edge1.setProperty<id_t>("dest_copy", 10);
+        auto edge2 = edges[{20, 22}];
+        edge2.setSourceVertexID(5);
+        edge2.setProperty<id_t>("src_copy", 5);
+    }
+}
+FLAMEGPU_AGENT_FUNCTION(CheckGraph_EditEdges, MessageNone, MessageNone) {
+    auto graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    const unsigned int vertex = FLAMEGPU->getIndex();
+    bool all_correct = true;
+    unsigned int out_ct = 0;
+    for (auto &edge : graph.outEdges(vertex)) {
+        all_correct &= edge.getProperty<id_t>("src_copy") == graph.getVertexID(vertex);
+        all_correct &= edge.getProperty<id_t>("dest_copy") == graph.getVertexID(edge.getEdgeDestination());
+        all_correct &= edge.getIndex() == graph.getEdgeIndex(vertex, edge.getEdgeDestination());
+        ++out_ct;
+    }
+    unsigned int in_ct = 0;
+    for (auto &edge : graph.inEdges(vertex)) {
+        all_correct &= edge.getProperty<id_t>("src_copy") == graph.getVertexID(edge.getEdgeSource());
+        all_correct &= edge.getProperty<id_t>("dest_copy") == graph.getVertexID(vertex);
+        all_correct &= edge.getIndex() == graph.getEdgeIndex(edge.getEdgeSource(), vertex);
+        ++in_ct;
+    }
+    FLAMEGPU->setVariable<unsigned int>("out_count", out_ct);
+    FLAMEGPU->setVariable<unsigned int>("in_count", in_ct);
+    FLAMEGPU->setVariable<unsigned int>("all_correct", all_correct ? 1 : 0);
+    return flamegpu::ALIVE;
+}
+TEST(TestEnvironmentDirectedGraph, TestEditEdges) {
+    // Edit a handful of edges after the graph has been built, and check both edge iterators reflect the change
+    ModelDescription model("GraphTest");
+    EnvironmentDirectedGraphDescription graph = model.Environment().newDirectedGraph("graph");
+
+    graph.newEdgeProperty<id_t>("src_copy");
+    graph.newEdgeProperty<id_t>("dest_copy");
+
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<unsigned int>("out_count", 0);
+    agent.newVariable<unsigned int>("in_count", 0);
+    agent.newVariable<unsigned int>("all_correct", 0);
+    agent.newFunction("check_graph", CheckGraph_EditEdges);
+
+    model.newLayer().addHostFunction(InitGraph_EditEdges);
+    model.newLayer().addAgentFunction(CheckGraph_EditEdges);
+
+    // Each agent checks the vertex with the same index
+    AgentVector pop(agent, EDIT_VERTEX_COUNT);
+
+    CUDASimulation sim(model);
+    sim.setPopulationData(pop);
+
+    EXPECT_NO_THROW(sim.step());
+    sim.getPopulationData(pop);
+    for (const auto& agt : pop) {
+        EXPECT_EQ(agt.getVariable<unsigned int>("out_count"), 2u);
+        EXPECT_EQ(agt.getVariable<unsigned int>("in_count"), 2u);
+        EXPECT_EQ(agt.getVariable<unsigned int>("all_correct"), 1u);
+    }
+
+    EXPECT_NO_THROW(sim.step());
+    sim.getPopulationData(pop);
+    for (unsigned int i = 0; i < EDIT_VERTEX_COUNT; ++i) {
+        // Vertex ID is index + 1
+        const id_t vertex_id = i + 1;
+        unsigned int out_count = 2;
+        unsigned int in_count = 2;
+        if (vertex_id == 20) {
+            out_count = 1;
+        } else if (vertex_id == 5) {
+            out_count = 3;
+        }
+        if (vertex_id == 4) {
+            in_count = 1;
+        } else if (vertex_id == 10) {
+            in_count = 3;
+        }
+        EXPECT_EQ(pop[i].getVariable<unsigned int>("out_count"), out_count);
+        EXPECT_EQ(pop[i].getVariable<unsigned int>("in_count"), in_count);
+        EXPECT_EQ(pop[i].getVariable<unsigned int>("all_correct"), 1u);
+    }
+}
 FLAMEGPU_HOST_FUNCTION(InitGraph_MissingIDs1) {
     // ID range < vertex count
     HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
@@ -1,6 +1,7 @@
 #ifndef TESTS_TEST_CASES_RUNTIME_TEST_AGENT_RANDOM_H_
 #define TESTS_TEST_CASES_RUNTIME_TEST_AGENT_RANDOM_H_
 
+#include <map>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -232,14 +233,48 @@ TEST(AgentRandomTest, AgentRandomFunctionsNoExcept) {
     // Success if we get this far without an exception being thrown.
 }
 
-TEST(AgentRandomTest, AgentRandomArrayResizeNoExcept) {
-    GTEST_COUT << "Testing d_random scales up / down without breaking" << std::endl;
-
-    std::vector<int> AGENT_COUNTS = {1024, 512 * 1024, 1024, 1024 * 1024};
-
-    // TODO(Rob): Can't yet control agent population up/down
-
-    // Success if we get this far without an exception being thrown.
+FLAMEGPU_AGENT_FUNCTION(random_death_func, MessageNone, MessageNone) {
+    FLAMEGPU->setVariable<float>("a", FLAMEGPU->random.uniform<float>());
+    // Agents marked to die are removed during the first step, changing the index of all subsequent agents
+    if (FLAMEGPU->getStepCounter() == 0 && FLAMEGPU->getVariable<int>("die"))
+        return DEAD;
+    return ALIVE;
+}
+TEST(AgentRandomTest, AgentRandomIndependentOfIndex) {
+    // Random numbers are keyed by agent ID, so are unaffected by the death of preceding agents
+    const unsigned int AGENT_COUNT = 1024;
+    ModelDescription model("random_model");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<float>("a");
+    agent.newVariable<int>("die", 0);
+    AgentFunctionDescription af = agent.newFunction("random_death", random_death_func);
+    af.setAllowAgentDeath(true);
+    model.newLayer().addAgentFunction(af);
+    auto run = [&](const bool kill) {
+        AgentVector population(agent, AGENT_COUNT);
+        for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+            population[i].setVariable<int>("die", kill && i % 2 == 0 ? 1 : 0);
+        }
+        CUDASimulation cudaSimulation(model);
+        cudaSimulation.SimulationConfig().random_seed = 12;
+        cudaSimulation.SimulationConfig().steps = 2;
+        cudaSimulation.setPopulationData(population);
+        cudaSimulation.simulate();
+        cudaSimulation.getPopulationData(population);
+        std::map<id_t, float> results;
+        for (const auto &instance : population) {
+            results.emplace(instance.getID(), instance.getVariable<float>("a"));
+        }
+        return results;
+    };
+    const std::map<id_t, float> all = run(false);
+    const std::map<id_t, float> half = run(true);
+    ASSERT_EQ(all.size(), AGENT_COUNT);
+    ASSERT_EQ(half.size(), AGENT_COUNT / 2);
+    for (const auto &r : half) {
+        ASSERT_EQ(all.count(r.first), 1u);
+        EXPECT_EQ(all.at(r.first), r.second);
+    }
 }
 }  // namespace test_agent_random
 }  // namespace flamegpu
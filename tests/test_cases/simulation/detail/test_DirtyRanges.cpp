@@ -0,0 +1,94 @@
+#include <utility>
+#include <vector>
+
+#include "flamegpu/simulation/detail/DirtyRanges.h"
+
+#include "gtest/gtest.h"
+namespace flamegpu {
+
+typedef std::vector<std::pair<size_t, size_t>> RangeVec;
+
+TEST(TestDirtyRanges, Empty) {
+    detail::DirtyRanges d;
+    EXPECT_TRUE(d.empty());
+    EXPECT_EQ(d.dirtyBytes(), 0u);
+    // Zero length ranges are ignored
+    d.markDirty(10, 0);
+    EXPECT_TRUE(d.empty());
+    EXPECT_EQ(d.take(0), RangeVec());
+}
+TEST(TestDirtyRanges, Disjoint) {
+    detail::DirtyRanges d;
+    d.markDirty(100, 8);
+    d.markDirty(0, 4);
+    d.markDirty(50, 16);
+    EXPECT_FALSE(d.empty());
+    EXPECT_EQ(d.dirtyBytes(), 28u);
+    // Returned in ascending order
+    EXPECT_EQ(d.take(0), RangeVec({{0, 4}, {50, 16}, {100, 8}}));
+    // take() marks the buffer clean
+    EXPECT_TRUE(d.empty());
+    EXPECT_EQ(d.take(0), RangeVec());
+}
+TEST(TestDirtyRanges, MergeOverlapping) {
+    detail::DirtyRanges d;
+    d.markDirty(10, 10);  // [10, 20)
+    d.markDirty(15, 10);  // [15, 25)
+    d.markDirty(5, 6);    // [5, 11)
+    EXPECT_EQ(d.dirtyBytes(), 20u);
+    EXPECT_EQ(d.take(0), RangeVec({{5, 20}}));
+}
+TEST(TestDirtyRanges, MergeAdjacent) {
+    detail::DirtyRanges d;
+    d.markDirty(0, 4);
+    d.markDirty(8, 4);
+    d.markDirty(4, 4);
+    EXPECT_EQ(d.take(0), RangeVec({{0, 12}}));
+}
+TEST(TestDirtyRanges, MergeSpanning) {
+    // A range covering several existing ranges absorbs them all
+    detail::DirtyRanges d;
+    d.markDirty(10, 2);
+    d.markDirty(20, 2);
+    d.markDirty(30, 2);
+    d.markDirty(50, 2);
+    d.markDirty(5, 30);
+    EXPECT_EQ(d.take(0), RangeVec({{5, 30}, {50, 2}}));
+}
+TEST(TestDirtyRanges, Repeated) {
+    // Marking the same property repeatedly does not grow the dirty set
+    detail::DirtyRanges d;
+    for (int i = 0; i < 100; ++i) {
+        d.markDirty(64, 8);
+    }
+    EXPECT_EQ(d.dirtyBytes(), 8u);
+    EXPECT_EQ(d.take(0), RangeVec({{64, 8}}));
+}
+TEST(TestDirtyRanges, MarkAll) {
+    detail::DirtyRanges d;
+    d.markDirty(10, 2);
+    d.markAll(1024);
+    EXPECT_EQ(d.dirtyBytes(), 1024u);
+    EXPECT_EQ(d.take(0), RangeVec({{0, 1024}}));
+}
+TEST(TestDirtyRanges, Coalesce) {
+    detail::DirtyRanges d;
+    d.markDirty(0, 8);
+    d.markDirty(16, 8);     // Gap of 8
+    d.markDirty(100, 8);    // Gap of 76
+    d.markDirty(10000, 8);  // Gap of 9892
+    // Gaps no larger than max_gap are copied with their neighbours
+    EXPECT_EQ(d.take(8), RangeVec({{0, 24}, {100, 8}, {10000, 8}}));
+    d.markDirty(0, 8);
+    d.markDirty(16, 8);
+    d.markDirty(100, 8);
+    d.markDirty(10000, 8);
+    EXPECT_EQ(d.take(7), RangeVec({{0, 8}, {16, 8}, {100, 8}, {10000, 8}}));
+    d.markDirty(0, 8);
+    d.markDirty(16, 8);
+    d.markDirty(100, 8);
+    d.markDirty(10000, 8);
+    EXPECT_EQ(d.take(4096), RangeVec({{0, 108}, {10000, 8}}));
+}
+
+}  // namespace flamegpu
@@ -71,6 +71,25 @@ TEST(TestRunPlan, setOutputSubdirectory) {
     // By default this is an empty string
     EXPECT_EQ(updatedSubdir, newSubdir);
 }
+TEST(TestRunPlan, setCost) {
+    flamegpu::ModelDescription model("test");
+    flamegpu::RunPlan plan(model);
+    // By default the cost is unset
+    EXPECT_EQ(plan.getCost(), 0.0);
+    plan.setCost(12.5);
+    EXPECT_EQ(plan.getCost(), 12.5);
+    // Copies retain the cost, and it participates in equality
+    flamegpu::RunPlan plan2(plan);
+    EXPECT_EQ(plan2.getCost(), 12.5);
+    EXPECT_EQ(plan, plan2);
+    plan2.setCost(1.0);
+    EXPECT_NE(plan, plan2);
+    plan2 = plan;
+    EXPECT_EQ(plan2.getCost(), 12.5);
+    // Negative costs are invalid
+    EXPECT_THROW(plan.setCost(-1.0), flamegpu::exception::InvalidArgument);
+    EXPECT_EQ(plan.getCost(), 12.5);
+}
 TEST(TestRunPlan, setProperty) {
     // Create a model
     flamegpu::ModelDescription model("test");
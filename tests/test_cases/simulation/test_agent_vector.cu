@@ -345,6 +345,65 @@ TEST(AgentVectorTest, data) {
     EXPECT_THROW(pop.data<unsigned int>("int"), exception::InvalidVarType);
     EXPECT_THROW(pop.data<int64_t>("int"), exception::InvalidVarType);
 }
+TEST(AgentVectorTest, column) {
+    const unsigned int POP_SIZE = 10;
+    // Test correctness of AgentVector column()
+    ModelDescription model("model");
+    AgentDescription agent = model.newAgent("agent");
+    agent.newVariable<int>("int", 1);
+    agent.newVariable<float, 3>("float3", {1.0f, 2.0f, 3.0f});
+
+    AgentVector pop(agent, POP_SIZE);
+    const AgentVector &cpop = pop;
+    auto col = pop.column<int>("int");
+    ASSERT_EQ(col.size(), POP_SIZE);
+    ASSERT_EQ(col.elements(), 1u);
+    ASSERT_FALSE(col.empty());
+    ASSERT_EQ(col.data(), pop.data<int>("int"));
+    // Writes via the column are visible via the vector
+    for (unsigned int i = 0; i < col.size(); ++i) {
+        EXPECT_EQ(col[i], 1);
+        col[i] = static_cast<int>(i);
+    }
+    for (unsigned int i = 0; i < POP_SIZE; ++i) {
+        EXPECT_EQ(pop[i].getVariable<int>("int"), static_cast<int>(i));
+    }
+    // Iterators span the whole column
+    int expected = 0;
+    for (const int &v : cpop.column<int>("int")) {
+        EXPECT_EQ(v, expected++);
+    }
+    EXPECT_EQ(expected, static_cast<int>(POP_SIZE));
+
+    // Array variables are stored agent major
+    auto col3 = pop.column<float>("float3");
+    ASSERT_EQ(col3.size(), POP_SIZE);
+    ASSERT_EQ(col3.elements(), 3u);
+    ASSERT_EQ(col3.end() - col3.begin(), static_cast<std::ptrdiff_t>(POP_SIZE * 3));
+    col3.at(4, 2) = 12.0f;
+    EXPECT_EQ(col3[4 * 3 + 2], 12.0f);
+    EXPECT_EQ(col3.at(4, 1), 2.0f);
+    EXPECT_EQ((pop[4].getVariable<float, 3>("float3")), (std::array<float, 3>{1.0f, 2.0f, 12.0f}));
+    EXPECT_EQ(cpop.column<float>("float3").at(4, 2), 12.0f);
+    EXPECT_THROW(col3.at(POP_SIZE), exception::OutOfBoundsException);
+    EXPECT_THROW(col3.at(0, 3), exception::OutOfBoundsException);
+
+    // Empty vector returns an empty column
+    AgentVector empty_pop(agent);
+    EXPECT_TRUE(empty_pop.column<int>("int").empty());
+    EXPECT_EQ(empty_pop.column<int>("int").data(), nullptr);
+    EXPECT_EQ(static_cast<const AgentVector>(empty_pop).column<int>("int").size(), 0u);
+
+    // Invalid exception::InvalidAgentVar
+    EXPECT_THROW(pop.column<int>("float"), exception::InvalidAgentVar);
+    EXPECT_THROW(cpop.column<int>("int12"), exception::InvalidAgentVar);
+    // Invalid exception::InvalidVarType
+    EXPECT_THROW(pop.column<float>("int"), exception::InvalidVarType);
+    EXPECT_THROW(cpop.column<int64_t>("int"), exception::InvalidVarType);
+    // Reserved names can't be mutated
+    EXPECT_THROW(pop.column<id_t>("_id"), exception::ReservedName);
+    EXPECT_NO_THROW(cpop.column<id_t>("_id"));
+}
 TEST(AgentVectorTest, iterator) {
     const unsigned int POP_SIZE = 10;
     // Test correctness of AgentVector array iterator, and the member functions for creating them.
@@ -0,0 +1,458 @@
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "flamegpu/flamegpu.h"
+
+#include "gtest/gtest.h"
+
+namespace flamegpu {
+namespace tests {
+namespace test_cpu_simulation {
+    const char *MODEL_NAME = "Model";
+    const char *AGENT_NAME = "Agent";
+    const char *MESSAGE_NAME = "Message";
+    const char *FUNCTION_NAME = "Function";
+    const char *FUNCTION_NAME2 = "Function2";
+    const unsigned int AGENT_COUNT = 1024;
+// Device implementations are required to describe the model, CPUSimulation executes the registered host implementations instead
+FLAMEGPU_AGENT_FUNCTION(EmptyFunc, MessageNone, MessageNone) {
+    return ALIVE;
+}
+FLAMEGPU_AGENT_FUNCTION(OutputFunc, MessageNone, MessageBruteForce) {
+    return ALIVE;
+}
+FLAMEGPU_AGENT_FUNCTION(InputFunc, MessageBruteForce, MessageNone) {
+    return ALIVE;
+}
+FLAMEGPU_AGENT_FUNCTION_CONDITION(EmptyCondition) {
+    return true;
+}
+FLAMEGPU_STEP_FUNCTION(EmptyStep) { }
+
+TEST(TestCPUSimulation, SetGetPopulationData) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<int>("x");
+    a.newVariable<float, 2>("y", {1.0f, 2.0f});
+    CPUSimulation s(m);
+    AgentVector pop(a, AGENT_COUNT);
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        pop[i].setVariable<int>("x", static_cast<int>(i));
+    }
+    s.setPopulationData(pop);
+    AgentVector out(a);
+    s.getPopulationData(out);
+    ASSERT_EQ(out.size(), AGENT_COUNT);
+    std::set<id_t> ids;
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        EXPECT_EQ(out[i].getVariable<int>("x"), static_cast<int>(i));
+        EXPECT_EQ((out[i].getVariable<float, 2>("y")), (std::array<float, 2>{1.0f, 2.0f}));
+        // Agents were assigned unique IDs
+        EXPECT_NE(out[i].getID(), ID_NOT_SET);
+        ids.insert(out[i].getID());
+    }
+    EXPECT_EQ(ids.size(), AGENT_COUNT);
+    // Bad state/agent
+    EXPECT_THROW(s.getPopulationData(out, "missing"), exception::InvalidAgentState);
+    ModelDescription m2(MODEL_NAME);
+    AgentDescription a2 = m2.newAgent("other");
+    AgentVector pop2(a2, 1);
+    EXPECT_THROW(s.setPopulationData(pop2), exception::InvalidAgent);
+}
+TEST(TestCPUSimulation, SetPopulationDataIDCollision) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newState("a");
+    a.newState("b");
+    a.newVariable<int>("x");
+    CPUSimulation s(m);
+    AgentVector pop_a(a, 2);
+    s.setPopulationData(pop_a, "a");
+    AgentVector pop_b(a, 3);
+    s.setPopulationData(pop_b, "b");
+    // Agents copied from state a share their IDs with state a
+    AgentVector out(a);
+    s.getPopulationData(out, "a");
+    EXPECT_THROW(s.setPopulationData(out, "b"), exception::AgentIDCollision);
+    // The rejected population was not applied
+    s.getPopulationData(out, "b");
+    EXPECT_EQ(out.size(), 3u);
+    // Replacing a state with its own agents is not a collision
+    s.getPopulationData(out, "a");
+    EXPECT_NO_THROW(s.setPopulationData(out, "a"));
+}
+TEST(TestCPUSimulation, UnsupportedModel) {
+    ModelDescription m(MODEL_NAME);
+    m.newAgent(AGENT_NAME);
+    m.addStepFunction(EmptyStep);
+    EXPECT_THROW(CPUSimulation s(m), exception::InvalidOperation);
+    ModelDescription m2(MODEL_NAME);
+    m2.newAgent(AGENT_NAME);
+    m2.newMessage<MessageSpatial2D>(MESSAGE_NAME);
+    EXPECT_THROW(CPUSimulation s(m2), exception::InvalidMessageType);
+}
+TEST(TestCPUSimulation, MissingHostImplementation) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    CPUSimulation s(m);
+    AgentVector pop(a, 10);
+    s.setPopulationData(pop);
+    EXPECT_THROW(s.step(), exception::InvalidAgentFunc);
+    EXPECT_THROW(s.setAgentFunction(AGENT_NAME, "missing", [](CPUAgentAPI&) { return ALIVE; }), exception::InvalidAgentFunc);
+    EXPECT_THROW(s.setAgentFunctionCondition(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI&) { return true; }), exception::InvalidAgentFunc);
+}
+TEST(TestCPUSimulation, AgentFunctionEnvironment) {
+    ModelDescription m(MODEL_NAME);
+    m.Environment().newProperty<int>("inc", 3);
+    m.Environment().newProperty<int, 2>("arr", {5, 7});
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<int>("x", 0);
+    a.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    CPUSimulation s(m);
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+        api.setVariable<int>("x", api.getVariable<int>("x") + api.environment.getProperty<int>("inc") + api.environment.getProperty<int, 2>("arr", 1));
+        return ALIVE;
+    });
+    AgentVector pop(a, AGENT_COUNT);
+    s.setPopulationData(pop);
+    s.SimulationConfig().steps = 5;
+    s.simulate();
+    EXPECT_EQ(s.getStepCounter(), 5u);
+    EXPECT_EQ(s.getElapsedTimeSteps().size(), 5u);
+    s.getPopulationData(pop);
+    ASSERT_EQ(pop.size(), AGENT_COUNT);
+    for (const auto &agent : pop) {
+        EXPECT_EQ(agent.getVariable<int>("x"), 50);
+    }
+}
+TEST(TestCPUSimulation, AgentDeath) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<unsigned int>("x");
+    a.newFunction(FUNCTION_NAME, EmptyFunc).setAllowAgentDeath(true);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    CPUSimulation s(m);
+    // Agents with an even value for 'x' die
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+        return api.getVariable<unsigned int>("x") % 2 == 0 ? DEAD : ALIVE;
+    });
+    AgentVector pop(a, AGENT_COUNT);
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        pop[i].setVariable<unsigned int>("x", i);
+    }
+    s.setPopulationData(pop);
+    s.step();
+    s.getPopulationData(pop);
+    ASSERT_EQ(pop.size(), AGENT_COUNT / 2);
+    // Survivors retain their relative order
+    for (unsigned int i = 0; i < pop.size(); ++i) {
+        EXPECT_EQ(pop[i].getVariable<unsigned int>("x"), 2 * i + 1);
+    }
+}
+TEST(TestCPUSimulation, AgentDeathNotEnabled) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    CPUSimulation s(m);
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &) { return DEAD; });
+    AgentVector pop(a, 10);
+    s.setPopulationData(pop);
+    EXPECT_THROW(s.step(), exception::InvalidOperation);
+}
+TEST(TestCPUSimulation, BruteForceMessaging) {
+    ModelDescription m(MODEL_NAME);
+    MessageBruteForce::Description msg = m.newMessage(MESSAGE_NAME);
+    msg.newVariable<unsigned int>("x");
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<unsigned int>("x");
+    a.newVariable<unsigned int>("sum", 0);
+    a.newVariable<unsigned int>("count", 0);
+    a.newFunction(FUNCTION_NAME, OutputFunc).setMessageOutput(msg);
+    a.newFunction(FUNCTION_NAME2, InputFunc).setMessageInput(msg);
+    m.newLayer().addAgentFunction(OutputFunc);
+    m.newLayer().addAgentFunction(InputFunc);
+    CPUSimulation s(m);
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+        api.message_out.setVariable<unsigned int>("x", api.getVariable<unsigned int>("x"));
+        return ALIVE;
+    });
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME2, [](CPUAgentAPI &api) {
+        unsigned int sum = 0;
+        unsigned int count = 0;
+        for (const auto &message : api.message_in) {
+            sum += message.getVariable<unsigned int>("x");
+            ++count;
+        }
+        api.setVariable<unsigned int>("sum", sum);
+        api.setVariable<unsigned int>("count", count);
+        return ALIVE;
+    });
+    AgentVector pop(a, AGENT_COUNT);
+    unsigned int expected_sum = 0;
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        pop[i].setVariable<unsigned int>("x", i);
+        expected_sum += i;
+    }
+    s.setPopulationData(pop);
+    // Messages are not persistent, so each step reads only that step's messages
+    s.SimulationConfig().steps = 2;
+    s.simulate();
+    s.getPopulationData(pop);
+    for (const auto &agent : pop) {
+        EXPECT_EQ(agent.getVariable<unsigned int>("count"), AGENT_COUNT);
+        EXPECT_EQ(agent.getVariable<unsigned int>("sum"), expected_sum);
+    }
+}
+TEST(TestCPUSimulation, AgentOutput) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<unsigned int>("x");
+    a.newFunction(FUNCTION_NAME, EmptyFunc).setAgentOutput(a);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    CPUSimulation s(m);
+    // Odd agents create a new agent
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+        const unsigned int x = api.getVariable<unsigned int>("x");
+        if (x % 2)
+            api.agent_out.setVariable<unsigned int>("x", x + AGENT_COUNT);
+        return ALIVE;
+    });
+    AgentVector pop(a, AGENT_COUNT);
+    for (unsigned int i = 0; i < AGENT_COUNT; ++i) {
+        pop[i].setVariable<unsigned int>("x", i);
+    }
+    s.setPopulationData(pop);
+    s.step();
+    s.getPopulationData(pop);
+    ASSERT_EQ(pop.size(), AGENT_COUNT + AGENT_COUNT / 2);
+    std::set<id_t> ids;
+    for (unsigned int i = 0; i < pop.size(); ++i) {
+        ids.insert(pop[i].getID());
+        if (i >= AGENT_COUNT) {
+            // New agents are appended in the order of their parents
+            EXPECT_EQ(pop[i].getVariable<unsigned int>("x"), AGENT_COUNT + 2 * (i - AGENT_COUNT) + 1);
+        }
+    }
+    EXPECT_EQ(ids.size(), pop.size());
+    EXPECT_EQ(ids.count(ID_NOT_SET), 0u);
+}
+TEST(TestCPUSimulation, ConditionStateTransition) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newState("a");
+    a.newState("b");
+    a.newVariable<unsigned int>("x");
+    AgentFunctionDescription f = a.newFunction(FUNCTION_NAME, EmptyFunc);
+    f.setInitialState("a");
+    f.setEndState("b");
+    f.setFunctionCondition(EmptyCondition);
+    m.newLayer().addAgentFunction(f);
+    CPUSimulation s(m);
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+        api.setVariable<unsigned int>("x", api.getVariable<unsigned int>("x") * 10);
+        return ALIVE;
+    });
+    EXPECT_THROW(s.step(), exception::InvalidAgentFunc);  // Condition has no host implementation
+    s.setAgentFunctionCondition(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+        return api.getVariable<unsigned int>("x") < 10;
+    });
+    AgentVector pop(a, 20);
+    for (unsigned int i = 0; i < 20; ++i) {
+        pop[i].setVariable<unsigned int>("x", i);
+    }
+    s.setPopulationData(pop, "a");
+    s.step();
+    AgentVector pop_a(a), pop_b(a);
+    s.getPopulationData(pop_a, "a");
+    s.getPopulationData(pop_b, "b");
+    ASSERT_EQ(pop_a.size(), 10u);
+    ASSERT_EQ(pop_b.size(), 10u);
+    for (unsigned int i = 0; i < 10; ++i) {
+        EXPECT_EQ(pop_a[i].getVariable<unsigned int>("x"), i + 10);
+        EXPECT_EQ(pop_b[i].getVariable<unsigned int>("x"), i * 10);
+    }
+}
+TEST(TestCPUSimulation, RandomReproducible) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<float>("x");
+    a.newVariable<int>("y");
+    a.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    auto run = [&](const unsigned int thread_count, const uint64_t seed) {
+        CPUSimulation s(m);
+        s.CPUConfig().thread_count = thread_count;
+        s.SimulationConfig().random_seed = seed;
+        s.SimulationConfig().steps = 3;
+        s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+            api.setVariable<float>("x", api.getVariable<float>("x") + api.random.uniform<float>());
+            api.setVariable<int>("y", api.random.uniform<int>(-5, 5));
+            return ALIVE;
+        });
+        AgentVector pop(a, AGENT_COUNT);
+        s.setPopulationData(pop);
+        s.simulate();
+        s.getPopulationData(pop);
+        return pop;
+    };
+    const AgentVector pop_1 = run(1, 12);
+    const AgentVector pop_4 = run(4, 12);
+    const AgentVector pop_seed = run(4, 13);
+    // Same seed produces the same results, regardless of thread count
+    EXPECT_TRUE(pop_1 == pop_4);
+    EXPECT_FALSE(pop_1 == pop_seed);
+    for (const auto &agent : pop_1) {
+        EXPECT_GE(agent.getVariable<float>("x"), 0.0f);
+        EXPECT_LT(agent.getVariable<float>("x"), 3.0f);
+        EXPECT_GE(agent.getVariable<int>("y"), -5);
+        EXPECT_LE(agent.getVariable<int>("y"), 5);
+    }
+}
+TEST(TestCPUSimulation, Reset) {
+    ModelDescription m(MODEL_NAME);
+    m.Environment().newProperty<int>("p", 1);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    CPUSimulation s(m);
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &) { return ALIVE; });
+    AgentVector pop(a, 10);
+    s.setPopulationData(pop);
+    s.SimulationConfig().steps = 2;
+    s.simulate();
+    EXPECT_EQ(s.getStepCounter(), 2u);
+    // reset() is hidden by the protected overload, so call it via the base class
+    static_cast<Simulation&>(s).reset();
+    EXPECT_EQ(s.getStepCounter(), 0u);
+    s.getPopulationData(pop);
+    EXPECT_EQ(pop.size(), 0u);
+}
+TEST(TestCPUSimulation, DataflowMatchesLayered) {
+    ModelDescription m(MODEL_NAME);
+    MessageBruteForce::Description msg = m.newMessage(MESSAGE_NAME);
+    msg.newVariable<float>("x");
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<float>("x");
+    a.newVariable<float>("sum", 0);
+    AgentDescription b = m.newAgent("Agent2");
+    b.newVariable<float>("y");
+    AgentFunctionDescription output = a.newFunction(FUNCTION_NAME, OutputFunc);
+    output.setMessageOutput(msg);
+    AgentFunctionDescription input = a.newFunction(FUNCTION_NAME2, InputFunc);
+    input.setMessageInput(msg);
+    input.dependsOn(output);
+    AgentFunctionDescription birth = a.newFunction("birth", EmptyFunc);
+    birth.setAgentOutput(b);
+    birth.dependsOn(input);
+    AgentFunctionDescription update = b.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.addExecutionRoot(output);
+    m.addExecutionRoot(update);
+    m.generateLayers();
+    auto run = [&](const bool dataflow, const unsigned int thread_count) {
+        CPUSimulation s(m);
+        s.CPUConfig().dataflow = dataflow;
+        s.CPUConfig().thread_count = thread_count;
+        s.SimulationConfig().random_seed = 12;
+        s.SimulationConfig().steps = 3;
+        s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &api) {
+            api.message_out.setVariable<float>("x", api.getVariable<float>("x") + api.random.uniform<float>());
+            return ALIVE;
+        });
+        s.setAgentFunction(AGENT_NAME, FUNCTION_NAME2, [](CPUAgentAPI &api) {
+            float sum = 0;
+            for (const auto &message : api.message_in) {
+                sum += message.getVariable<float>("x");
+            }
+            api.setVariable<float>("sum", sum);
+            return ALIVE;
+        });
+        s.setAgentFunction(AGENT_NAME, "birth", [](CPUAgentAPI &api) {
+            if (api.random.uniform<float>() < 0.1f)
+                api.agent_out.setVariable<float>("y", api.getVariable<float>("sum"));
+            return ALIVE;
+        });
+        s.setAgentFunction("Agent2", FUNCTION_NAME, [](CPUAgentAPI &api) {
+            api.setVariable<float>("y", api.getVariable<float>("y") + api.random.uniform<float>());
+            return ALIVE;
+        });
+        AgentVector pop_a(a, 64);
+        for (unsigned int i = 0; i < pop_a.size(); ++i) {
+            pop_a[i].setVariable<float>("x", static_cast<float>(i));
+        }
+        s.setPopulationData(pop_a);
+        s.simulate();
+        AgentVector pop_b(b);
+        s.getPopulationData(pop_a);
+        s.getPopulationData(pop_b);
+        return std::make_pair(pop_a, pop_b);
+    };
+    const auto layered = run(false, 1);
+    const auto dataflow_serial = run(true, 1);
+    const auto dataflow = run(true, 4);
+    EXPECT_GT(layered.second.size(), 0u);
+    EXPECT_TRUE(layered.first == dataflow_serial.first);
+    EXPECT_TRUE(layered.second == dataflow_serial.second);
+    EXPECT_TRUE(layered.first == dataflow.first);
+    EXPECT_TRUE(layered.second == dataflow.second);
+}
+TEST(TestCPUSimulation, DataflowIndependentFunctionsOverlap) {
+    // B's function does not depend on A's second function, however generated layers place it in an earlier layer
+    // Dataflow execution allows B's function to wait for A's second function, which would never occur if executed by layer
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    AgentDescription b = m.newAgent("Agent2");
+    AgentFunctionDescription a1 = a.newFunction(FUNCTION_NAME, EmptyFunc);
+    AgentFunctionDescription a2 = a.newFunction(FUNCTION_NAME2, EmptyFunc);
+    a2.dependsOn(a1);
+    AgentFunctionDescription b1 = b.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.addExecutionRoot(a1);
+    m.addExecutionRoot(b1);
+    m.generateLayers();
+    ASSERT_EQ(m.getLayersCount(), 2u);
+    CPUSimulation s(m);
+    s.CPUConfig().dataflow = true;
+    s.CPUConfig().thread_count = 4;
+    std::atomic<bool> a2_complete{false};
+    std::atomic<bool> b1_observed{false};
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &) { return ALIVE; });
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME2, [&a2_complete](CPUAgentAPI &) {
+        a2_complete = true;
+        return ALIVE;
+    });
+    s.setAgentFunction("Agent2", FUNCTION_NAME, [&a2_complete, &b1_observed](CPUAgentAPI &) {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!a2_complete && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::yield();
+        }
+        b1_observed = a2_complete.load();
+        return ALIVE;
+    });
+    AgentVector pop_a(a, 1);
+    AgentVector pop_b(b, 1);
+    s.setPopulationData(pop_a);
+    s.setPopulationData(pop_b);
+    s.step();
+    EXPECT_TRUE(b1_observed);
+}
+TEST(TestCPUSimulation, DataflowRequiresGeneratedLayers) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newFunction(FUNCTION_NAME, EmptyFunc);
+    m.newLayer().addAgentFunction(EmptyFunc);
+    CPUSimulation s(m);
+    s.CPUConfig().dataflow = true;
+    s.setAgentFunction(AGENT_NAME, FUNCTION_NAME, [](CPUAgentAPI &) { return ALIVE; });
+    EXPECT_THROW(s.step(), exception::InvalidOperation);
+}
+}  // namespace test_cpu_simulation
+}  // namespace tests
+}  // namespace flamegpu
@@ -3,6 +3,8 @@
 #include <filesystem>
 #include <string>
 #include <set>
+#include <mutex>
+#include <vector>
 
 #include "flamegpu/flamegpu.h"
 
@@ -54,6 +56,12 @@ TEST(TestCUDAEnsemble, EnsembleConfig) {
     EXPECT_EQ(immutableConfig.verbosity, Verbosity::Default);
     EXPECT_EQ(immutableConfig.timing, false);
     EXPECT_EQ(immutableConfig.telemetry, false);
+    EXPECT_EQ(immutableConfig.evict_exported_logs, false);
+    EXPECT_EQ(immutableConfig.max_log_export_backlog, 0u);
+    EXPECT_EQ(immutableConfig.log_export_threads, 1u);
+    EXPECT_EQ(immutableConfig.scheduling, CUDAEnsemble::EnsembleConfig::Sequential);
+    EXPECT_EQ(immutableConfig.reuse_simulations, true);
+    EXPECT_EQ(immutableConfig.mpi_chunk_size, 0u);
     // Mutate the config. Note we cannot mutate the return from getConfig, and connot test this as it is a compialtion failure (requires ctest / standalone .cpp file)
     mutableConfig.out_directory = std::string("test");
     mutableConfig.out_format = std::string("xml");
@@ -105,6 +113,29 @@ TEST(TestCUDAEnsemble, initialise_concurrent_runs) {
     ensemble.initialise(sizeof(argv) / sizeof(char*), argv);
     EXPECT_EQ(ensemble.getConfig().concurrent_runs, 2u);
 }
+TEST(TestCUDAEnsemble, initialise_log_threads) {
+    flamegpu::ModelDescription model("test");
+    flamegpu::CUDAEnsemble ensemble(model);
+    EXPECT_EQ(ensemble.getConfig().log_export_threads, 1u);
+    const char *argv[3] = { "prog.exe", "--log-threads", "3" };
+    ensemble.initialise(sizeof(argv) / sizeof(char*), argv);
+    EXPECT_EQ(ensemble.getConfig().log_export_threads, 3u);
+}
+TEST(TestCUDAEnsemble, initialise_schedule) {
+    flamegpu::ModelDescription model("test");
+    flamegpu::CUDAEnsemble ensemble(model);
+    EXPECT_EQ(ensemble.getConfig().scheduling, CUDAEnsemble::EnsembleConfig::Sequential);
+    {
+        const char *argv[3] = { "prog.exe", "--schedule", "Longest" };
+        ensemble.initialise(sizeof(argv) / sizeof(char*), argv);
+        EXPECT_EQ(ensemble.getConfig().scheduling, CUDAEnsemble::EnsembleConfig::LongestFirst);
+    }
+    {
+        const char *argv[3] = { "prog.exe", "--schedule", "0" };
+        ensemble.initialise(sizeof(argv) / sizeof(char*), argv);
+        EXPECT_EQ(ensemble.getConfig().scheduling, CUDAEnsemble::EnsembleConfig::Sequential);
+    }
+}
 TEST(TestCUDAEnsemble, initialise_devices) {
     // Create a model
     flamegpu::ModelDescription model("test");
@@ -1035,6 +1066,225 @@ TEST(TestCUDAEnsemble, TruncationOff_Exit) {
     // Cleanup
     std::filesystem::remove_all("test_truncate");
 }
+TEST(TestCUDAEnsemble, EvictExportedLogs) {
+    ModelDescription m("test");
+    m.newAgent("agent");
+    StepLoggingConfig slc(m);
+    LoggingConfig elc(m);
+    CUDAEnsemble e(m);
+    e.Config().out_directory = "test_evict";
+    e.Config().out_format = "json";
+    e.Config().truncate_log_files = true;
+    e.Config().evict_exported_logs = true;
+    e.Config().verbosity = Verbosity::Quiet;
+    e.setStepLog(slc);
+    e.setExitLog(elc);
+    RunPlanVector rpv(m, 8);
+    rpv.setSteps(2);
+    EXPECT_NO_THROW(e.simulate(rpv));
+    // All logs were exported, so none remain in memory
+    EXPECT_EQ(e.getLogs().size(), 0u);
+    for (unsigned int i = 0; i < rpv.size(); ++i) {
+        EXPECT_TRUE(std::filesystem::exists("test_evict/" + std::to_string(i) + ".json"));
+    }
+    EXPECT_TRUE(std::filesystem::exists("test_evict/exit.json"));
+    // Cleanup
+    std::filesystem::remove_all("test_evict");
+}
+TEST(TestCUDAEnsemble, LogExportBacklog) {
+    ModelDescription m("test");
+    m.newAgent("agent");
+    StepLoggingConfig slc(m);
+    CUDAEnsemble e(m);
+    e.Config().out_directory = "test_backlog";
+    e.Config().out_format = "json";
+    e.Config().truncate_log_files = true;
+    e.Config().max_log_export_backlog = 1;
+    e.Config().verbosity = Verbosity::Quiet;
+    e.setStepLog(slc);
+    RunPlanVector rpv(m, 16);
+    rpv.setSteps(2);
+    EXPECT_NO_THROW(e.simulate(rpv));
+    // Logs are retained by default, the backlog only delays runners
+    EXPECT_EQ(e.getLogs().size(), rpv.size());
+    for (unsigned int i = 0; i < rpv.size(); ++i) {
+        EXPECT_TRUE(std::filesystem::exists("test_backlog/" + std::to_string(i) + ".json"));
+    }
+    // Cleanup
+    std::filesystem::remove_all("test_backlog");
+}
+TEST(TestCUDAEnsemble, LogExportThreads) {
+    ModelDescription m("test");
+    m.newAgent("agent");
+    StepLoggingConfig slc(m);
+    LoggingConfig elc(m);
+    CUDAEnsemble e(m);
+    e.Config().out_directory = "test_log_threads";
+    e.Config().out_format = "json";
+    e.Config().truncate_log_files = true;
+    e.Config().log_export_threads = 4;
+    e.Config().verbosity = Verbosity::Quiet;
+    e.setStepLog(slc);
+    e.setExitLog(elc);
+    RunPlanVector rpv(m, 32);
+    rpv.setSteps(2);
+    EXPECT_NO_THROW(e.simulate(rpv));
+    for (unsigned int i = 0; i < rpv.size(); ++i) {
+        EXPECT_TRUE(std::filesystem::exists("test_log_threads/" + std::to_string(i) + ".json"));
+    }
+    // Every run appends a single line to the shared exit file, concurrent exporters must not interleave them
+    {
+        std::ifstream is("test_log_threads/exit.json");
+        unsigned int lines = 0;
+        std::string line;
+        while (std::getline(is, line)) {
+            if (!line.empty())
+                ++lines;
+        }
+        EXPECT_EQ(lines, rpv.size());
+    }
+    const CUDAEnsemble::LogExportMetrics &metrics = e.getLogExportMetrics();
+    EXPECT_EQ(metrics.export_threads, 4u);
+    EXPECT_EQ(metrics.exported_logs, rpv.size());
+    EXPECT_GE(metrics.total_queue_depth, metrics.exported_logs);
+    EXPECT_GE(metrics.max_queue_depth, 1u);
+    EXPECT_GE(metrics.total_export_time, metrics.max_export_time);
+    // Cleanup
+    std::filesystem::remove_all("test_log_threads");
+}
+
+std::mutex scheduleOrderMutex;
+std::vector<unsigned int> scheduleOrder;
+FLAMEGPU_INIT_FUNCTION(scheduleInit) {
+    std::lock_guard<std::mutex> lck(scheduleOrderMutex);
+    scheduleOrder.push_back(FLAMEGPU->environment.getProperty<unsigned int>("run"));
+}
+TEST(TestCUDAEnsemble, ScheduleLongestFirst) {
+    ModelDescription m("test");
+    m.newAgent("agent");
+    m.Environment().newProperty<unsigned int>("run", 0);
+    m.addInitFunction(scheduleInit);
+    RunPlanVector rpv(m, 6);
+    for (unsigned int i = 0; i < rpv.size(); ++i) {
+        rpv[i].setProperty<unsigned int>("run", i);
+    }
+    rpv.setSteps(2);
+    // Plans 1 and 4 have an explicit cost, the remainder are costed by steps
+    rpv[1].setCost(10);
+    rpv[3].setSteps(4);
+    rpv[4].setCost(20);
+    CUDAEnsemble e(m);
+    // A single runner executes runs in the order they are claimed
+    e.Config().concurrent_runs = 1;
+    e.Config().devices = {0};
+    e.Config().verbosity = Verbosity::Quiet;
+    e.Config().scheduling = CUDAEnsemble::EnsembleConfig::LongestFirst;
+    scheduleOrder.clear();
+    EXPECT_EQ(e.simulate(rpv), 0u);
+    // Equal cost runs retain their relative order
+    EXPECT_EQ(scheduleOrder, (std::vector<unsigned int>{4, 1, 3, 0, 2, 5}));
+    // Logs are still indexed by plan
+    EXPECT_EQ(e.getLogs().size(), rpv.size());
+    const std::vector<CUDAEnsemble::RunnerMetrics> &metrics = e.getRunnerMetrics();
+    ASSERT_EQ(metrics.size(), 1u);
+    EXPECT_EQ(metrics[0].device_id, 0);
+    EXPECT_EQ(metrics[0].runner_id, 0u);
+    EXPECT_EQ(metrics[0].runs, rpv.size());
+    EXPECT_GT(metrics[0].busy_time, 0.0);
+    EXPECT_GT(metrics[0].utilisation, 0.0);
+    EXPECT_LE(metrics[0].utilisation, 1.0);
+    // Sequential scheduling executes runs in plan order
+    e.Config().scheduling = CUDAEnsemble::EnsembleConfig::Sequential;
+    scheduleOrder.clear();
+    EXPECT_EQ(e.simulate(rpv), 0u);
+    EXPECT_EQ(scheduleOrder, (std::vector<unsigned int>{0, 1, 2, 3, 4, 5}));
+}
+
+FLAMEGPU_INIT_FUNCTION(reuseInit) {
+    // Each run should begin with no agents and zeroed macro properties
+    FLAMEGPU->environment.setProperty<unsigned int>("init_count", FLAMEGPU->agent("agent").count());
+    FLAMEGPU->environment.setProperty<unsigned int>("init_macro", FLAMEGPU->environment.getMacroProperty<unsigned int>("macro"));
+    // and an empty directed graph
+    HostEnvironmentDirectedGraph graph = FLAMEGPU->environment.getDirectedGraph("graph");
+    FLAMEGPU->environment.setProperty<unsigned int>("init_vertices", graph.getVertexCount());
+    FLAMEGPU->environment.setProperty<unsigned int>("init_edges", graph.getEdgeCount());
+    const unsigned int pop = FLAMEGPU->environment.getProperty<unsigned int>("pop");
+    auto agent = FLAMEGPU->agent("agent");
+    for (unsigned int i = 0; i < pop; ++i) {
+        agent.newAgent();
+    }
+    // Populate the graph with a ring, so that a leaked graph would be visible to the next run
+    graph.setVertexCount(pop);
+    auto vertices = graph.vertices();
+    for (unsigned int i = 1; i <= pop; ++i) {
+        vertices[i].setProperty<float>("vertex_weight", static_cast<float>(i));
+    }
+    graph.setEdgeCount(pop);
+    auto edges = graph.edges();
+    for (unsigned int i = 1; i <= pop; ++i) {
+        edges[{i, (i % pop) + 1}].setProperty<float>("edge_weight", static_cast<float>(i));
+    }
+}
+FLAMEGPU_STEP_FUNCTION(reuseStep) {
+    FLAMEGPU->environment.getMacroProperty<unsigned int>("macro") += FLAMEGPU->environment.getProperty<unsigned int>("pop");
+}
+FLAMEGPU_EXIT_FUNCTION(reuseExit) {
+    FLAMEGPU->environment.setProperty<unsigned int>("exit_macro", FLAMEGPU->environment.getMacroProperty<unsigned int>("macro"));
+}
+TEST(TestCUDAEnsemble, ReuseSimulations) {
+    ModelDescription m("test");
+    m.newAgent("agent").newVariable<float>("x");
+    m.Environment().newProperty<unsigned int>("pop", 5);
+    m.Environment().newProperty<unsigned int>("init_count", 0);
+    m.Environment().newProperty<unsigned int>("init_macro", 0);
+    m.Environment().newProperty<unsigned int>("exit_macro", 0);
+    m.Environment().newProperty<unsigned int>("init_vertices", 0);
+    m.Environment().newProperty<unsigned int>("init_edges", 0);
+    m.Environment().newMacroProperty<unsigned int>("macro");
+    EnvironmentDirectedGraphDescription graph = m.Environment().newDirectedGraph("graph");
+    graph.newVertexProperty<float>("vertex_weight");
+    graph.newEdgeProperty<float>("edge_weight");
+    m.addInitFunction(reuseInit);
+    m.addStepFunction(reuseStep);
+    m.addExitFunction(reuseExit);
+    LoggingConfig lcfg(m);
+    lcfg.logEnvironment("pop");
+    lcfg.logEnvironment("init_count");
+    lcfg.logEnvironment("init_macro");
+    lcfg.logEnvironment("exit_macro");
+    lcfg.logEnvironment("init_vertices");
+    lcfg.logEnvironment("init_edges");
+    lcfg.agent("agent").logCount();
+    RunPlanVector rpv(m, 4);
+    rpv.setSteps(3);
+    // Alternate overridden and default properties, to check overrides do not persist between runs
+    rpv[0].setProperty<unsigned int>("pop", 10);
+    rpv[2].setProperty<unsigned int>("pop", 20);
+    for (const bool reuse : {true, false}) {
+        CUDAEnsemble e(m);
+        // A single runner executes every run
+        e.Config().concurrent_runs = 1;
+        e.Config().devices = {0};
+        e.Config().verbosity = Verbosity::Quiet;
+        e.Config().reuse_simulations = reuse;
+        e.setExitLog(lcfg);
+        EXPECT_EQ(e.simulate(rpv), 0u);
+        const std::map<unsigned int, RunLog> &logs = e.getLogs();
+        ASSERT_EQ(logs.size(), rpv.size());
+        for (const auto &[i, log] : logs) {
+            const unsigned int pop = i == 0 ? 10 : i == 2 ? 20 : 5;
+            const ExitLogFrame &exit_log = log.getExitLog();
+            EXPECT_EQ(exit_log.getEnvironmentProperty<unsigned int>("pop"), pop);
+            EXPECT_EQ(exit_log.getEnvironmentProperty<unsigned int>("init_count"), 0u);
+            EXPECT_EQ(exit_log.getEnvironmentProperty<unsigned int>("init_macro"), 0u);
+            EXPECT_EQ(exit_log.getEnvironmentProperty<unsigned int>("exit_macro"), 3 * pop);
+            EXPECT_EQ(exit_log.getEnvironmentProperty<unsigned int>("init_vertices"), 0u);
+            EXPECT_EQ(exit_log.getEnvironmentProperty<unsigned int>("init_edges"), 0u);
+            EXPECT_EQ(exit_log.getAgent("agent").getCount(), pop);
+            EXPECT_EQ(log.getRandomSeed(), rpv[i].getRandomSimulationSeed());
+        }
+    }
+}
 
 TEST(TestCUDAEnsemble, SimualteWithExistingCUDAMalloc_rtc) {
     // Allocate some arbitraty device memory.
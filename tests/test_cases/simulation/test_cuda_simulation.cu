@@ -4,6 +4,7 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <utility>
 
 #include "flamegpu/flamegpu.h"
 #include "flamegpu/detail/compute_capability.cuh"
@@ -1223,6 +1224,93 @@ TEST(TestCUDASimulation, simulationConfigTelemetry) {
     EXPECT_TRUE(c.SimulationConfig().telemetry);
 }
 
+FLAMEGPU_AGENT_FUNCTION(DataflowOutput, MessageNone, MessageBruteForce) {
+    FLAMEGPU->message_out.setVariable<float>("x", FLAMEGPU->getVariable<float>("x") + FLAMEGPU->random.uniform<float>());
+    return ALIVE;
+}
+FLAMEGPU_AGENT_FUNCTION(DataflowInput, MessageBruteForce, MessageNone) {
+    float sum = 0;
+    for (const auto &message : FLAMEGPU->message_in) {
+        sum += message.getVariable<float>("x");
+    }
+    FLAMEGPU->setVariable<float>("sum", sum * FLAMEGPU->environment.getProperty<float>("scale"));
+    return ALIVE;
+}
+FLAMEGPU_AGENT_FUNCTION(DataflowBirth, MessageNone, MessageNone) {
+    if (FLAMEGPU->random.uniform<float>() < 0.1f)
+        FLAMEGPU->agent_out.setVariable<float>("y", FLAMEGPU->getVariable<float>("sum"));
+    return ALIVE;
+}
+FLAMEGPU_AGENT_FUNCTION(DataflowUpdate, MessageNone, MessageNone) {
+    FLAMEGPU->setVariable<float>("y", FLAMEGPU->getVariable<float>("y") + FLAMEGPU->random.uniform<float>());
+    return ALIVE;
+}
+FLAMEGPU_HOST_FUNCTION(DataflowScale) {
+    FLAMEGPU->environment.setProperty<float>("scale", FLAMEGPU->environment.getProperty<float>("scale") * 0.5f);
+}
+TEST(TestCUDASimulation, DataflowMatchesLayered) {
+    ModelDescription m(MODEL_NAME);
+    m.Environment().newProperty<float>("scale", 1.0f);
+    MessageBruteForce::Description msg = m.newMessage("msg");
+    msg.newVariable<float>("x");
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newVariable<float>("x");
+    a.newVariable<float>("sum", 0);
+    AgentDescription b = m.newAgent(AGENT_NAME2);
+    b.newVariable<float>("y");
+    AgentFunctionDescription output = a.newFunction("output", DataflowOutput);
+    output.setMessageOutput(msg);
+    AgentFunctionDescription input = a.newFunction("input", DataflowInput);
+    input.setMessageInput(msg);
+    input.dependsOn(output);
+    HostFunctionDescription scale("scale", DataflowScale);
+    scale.dependsOn(input);
+    AgentFunctionDescription birth = a.newFunction("birth", DataflowBirth);
+    birth.setAgentOutput(b);
+    birth.dependsOn(scale);
+    AgentFunctionDescription update = b.newFunction("update", DataflowUpdate);
+    m.addExecutionRoot(output);
+    m.addExecutionRoot(update);
+    m.generateLayers();
+    auto run = [&](const bool dataflow) {
+        CUDASimulation s(m);
+        s.CUDAConfig().dataflow = dataflow;
+        s.SimulationConfig().random_seed = 12;
+        s.SimulationConfig().steps = 3;
+        AgentVector pop_a(a, 64);
+        for (unsigned int i = 0; i < pop_a.size(); ++i) {
+            pop_a[i].setVariable<float>("x", static_cast<float>(i));
+        }
+        s.setPopulationData(pop_a);
+        s.simulate();
+        AgentVector pop_b(b);
+        s.getPopulationData(pop_a);
+        s.getPopulationData(pop_b);
+        return std::make_pair(pop_a, pop_b);
+    };
+    const auto layered = run(false);
+    const auto dataflow = run(true);
+    ASSERT_EQ(layered.first.size(), dataflow.first.size());
+    for (unsigned int i = 0; i < layered.first.size(); ++i) {
+        EXPECT_EQ(layered.first[i].getVariable<float>("sum"), dataflow.first[i].getVariable<float>("sum"));
+    }
+    ASSERT_GT(layered.second.size(), 0u);
+    ASSERT_EQ(layered.second.size(), dataflow.second.size());
+    for (unsigned int i = 0; i < layered.second.size(); ++i) {
+        EXPECT_EQ(layered.second[i].getVariable<float>("y"), dataflow.second[i].getVariable<float>("y"));
+    }
+}
+TEST(TestCUDASimulation, DataflowRequiresGeneratedLayers) {
+    ModelDescription m(MODEL_NAME);
+    AgentDescription a = m.newAgent(AGENT_NAME);
+    a.newFunction(FUNCTION_NAME, DataflowUpdate);
+    a.newVariable<float>("y");
+    m.newLayer().addAgentFunction(DataflowUpdate);
+    CUDASimulation s(m);
+    s.CUDAConfig().dataflow = true;
+    EXPECT_THROW(s.step(), exception::InvalidOperation);
+}
+
 }  // namespace test_cuda_simulation
 }  // namespace tests
 }  // namespace flamegpu
@@ -192,6 +192,20 @@ TEST_F(TestMPIEnsemble, success_verbose) {
 
     validateLogs();
 }
+TEST_F(TestMPIEnsemble, success_chunked) {
+    initEnsemble();
+    // Ranks other than 0 are assigned multiple runs per request, which shrink as runs are depleted
+    ensemble->Config().mpi_chunk_size = 3;
+    ensemble->Config().verbosity = Verbosity::Quiet;
+    const unsigned int err_count = ensemble->simulate(*plans);
+    EXPECT_EQ(err_count, 0u);
+    validateLogs();
+    // Every run must have been executed by exactly one rank
+    unsigned int local_logs = static_cast<unsigned int>(ensemble->getLogs().size());
+    unsigned int total_logs = 0;
+    MPI_Allreduce(&local_logs, &total_logs, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
+    EXPECT_EQ(total_logs, plans->size());
+}
 
 TEST_F(TestMPIEnsemble, error_off_rank_0) {
     model->newLayer().addHostFunction(throw_exception_rank_0);
@@ -462,6 +476,7 @@ TEST(TestMPIEnsembleNoFixture, devicesForThisRank) {
 #else
 TEST(TestMPIEnsemble, DISABLED_success) { }
 TEST(TestMPIEnsemble, DISABLED_success_verbose) { }
+TEST(TestMPIEnsemble, DISABLED_success_chunked) { }
 TEST(TestMPIEnsemble, DISABLED_error_off_rank_0) { }
 TEST(TestMPIEnsemble, DISABLED_error_slow_rank_0) { }
 TEST(TestMPIEnsemble, DISABLED_error_fast_rank_0) { }